@@ -35,10 +35,16 @@
 /******************************************************************************/
 
 #include <iostream>
+#include <cstring>
 using namespace std;
 #include "../../src/cpp_wrapper/Dictionary.h"
 #include "../../src/cpp_wrapper/MasterTable.h"
 
+/* Values are stored as raw bytes, so they must have a fixed size. */
+struct line {
+	char text[40];
+};
+
 int
 main(
 	void
@@ -52,13 +58,12 @@ main(
 		.id = id, .type = key_type_numeric_signed, .key_size = sizeof(int), .value_size = 40, .dictionary_size = 20, .dictionary_type = dictionary_type_skip_list_t
 	};
 	int								type	= 0;
-	string							val		= "";
+	line							val		= line();
 
 	/* Traditional method of creating a dictionary */
-/*	Dictionary<int, string> *dictionary = new SkipList<int, string>(id, key_type_numeric_signed, sizeof(int), sizeof("abracadabra"), 7); */
+/*	Dictionary<int, line> *dictionary = new SkipList<int, line>(id, 7); */
 
-/*	Dictionary<int, string> *dictionary = SkipList<int, string>::open(config, type, val); */
-	SkipList<int, string> *dictionary = SkipList<int, string>::openDictionary(config, type, val);
+	SkipList<int, line> *dictionary = SkipList<int, line>::openDictionary(config, type, val);
 
 	if (err_ok != dictionary->last_status.error) {
 		printf("Oh no! Something went wrong opening my dictionary\n");
@@ -72,11 +77,12 @@ main(
 
 		printf("key: %i\n", key);
 		cout << input << "\n";
-		dictionary->insert(key, input);
+		strncpy(val.text, input.c_str(), sizeof(val.text) - 1);
+		dictionary->insert(key, val);
 
 		if (key > 0) {
 			printf("last key: %i", key - 1);
-			cout << "value: " << dictionary->get(key - 1) << "\n";
+			cout << "value: " << dictionary->get(key - 1).text << "\n";
 		}
 
 		if (err_ok != dictionary->last_status.error) {
@@ -85,16 +91,14 @@ main(
 
 		key = key + 1;
 
-		Cursor<int, string> *cur = dictionary->allRecords();
 		printf("\n<CURRENT DICTIONARY VALUES>\n");
 
-		while (cur->next()) {
-			printf("%i ", cur->getKey());
-			cout << cur->getValue() << "\n";
+		for (auto &record : dictionary->allRecords()) {
+			printf("%i ", record.key);
+			cout << record.value.text << "\n";
 		}
 
 		printf("</CURRENT DICTIONARY VALUES>\n\n");
-		delete cur;
 
 		count++;
 	}
@@ -0,0 +1,709 @@
+/******************************************************************************/
+/**
+@file		ion_bench.c
+@author		IonDB Project
+@brief		Native benchmark driving every dictionary implementation
+			through YCSB-style workloads.
+@details	Usage: ion_bench [options]
+				-h NAME		handler: bpp_tree, flat_file,
+							open_address_hash, open_address_file_hash,
+							skip_list, linear_hash, lsm,
+							concurrent_skip_list, sharded or all (default)
+				-w NAME		workload: a (50% read, 50% update),
+							b (95% read, 5% update), c (read only),
+							e (95% scan, 5% insert),
+							f (50% read, 50% read-modify-write) or
+							miss (reads of absent keys); default a
+				-d NAME		key distribution: uniform or zipfian
+				-n N		records loaded before the run
+				-o N		operations in the run
+				-k N		key size in bytes, at least 4
+				-v N		value size in bytes
+				-l N		maximum records per scan
+				-m PCT		share of reads aimed at absent keys
+				-s N		seed of the @ref lfsr_t generators
+				-f NAME		output format: csv or json (one object
+							per line)
+
+			Each handler runs in its own child process, so that the
+			reported peak memory belongs to that handler alone. Bytes read
+			and written are the process' read and write system call
+			totals from @c /proc/self/io.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "../../key_value/kv_system.h"
+#include "../../dictionary/dictionary.h"
+#include "../../dictionary/bpp_tree/bpp_tree_handler.h"
+#include "../../dictionary/flat_file/flat_file_dictionary_handler.h"
+#include "../../dictionary/open_address_hash/open_address_hash_dictionary_handler.h"
+#include "../../dictionary/open_address_file_hash/open_address_file_hash_dictionary_handler.h"
+#include "../../dictionary/skip_list/skip_list_handler.h"
+#include "../../dictionary/linear_hash/linear_hash_handler.h"
+#include "../../dictionary/lsm/lsm_handler.h"
+#include "../../dictionary/concurrent_skip_list/concurrent_skip_list_handler.h"
+#include "../../dictionary/sharded/sharded_handler.h"
+#include "../../util/lfsr/lfsr.h"
+
+/**
+@brief		Skew of the Zipfian key distribution, as used by YCSB.
+*/
+#define ION_BENCH_ZIPFIAN_THETA 0.99
+
+/**
+@brief		Identifier given to the dictionary under test.
+*/
+#define ION_BENCH_DICTIONARY_ID 90
+
+/**
+@brief		Operations a workload is made of.
+*/
+typedef enum {
+	ion_bench_read, ion_bench_update, ion_bench_insert, ion_bench_scan, ion_bench_read_modify_write
+} ion_bench_op_t;
+
+/**
+@brief		A YCSB-style mix of operations, in percent.
+*/
+typedef struct {
+	char	*name;			/**< Name given on the command line. */
+	int		read;			/**< Point reads. */
+	int		update;			/**< Blind updates. */
+	int		insert;			/**< Inserts of new keys. */
+	int		scan;			/**< Short range scans. */
+	int		read_modify_write;	/**< Read followed by an update. */
+	int		miss;			/**< Share of reads forced to miss. */
+} ion_bench_workload_t;
+
+/**
+@brief		A dictionary implementation under test.
+*/
+typedef struct {
+	char						*name;	/**< Name given on the command line. */
+	ion_handler_initializer_t	init;	/**< Handler initializer. */
+} ion_bench_handler_t;
+
+/**
+@brief		Settings of one benchmark run.
+*/
+typedef struct {
+	ion_bench_workload_t	workload;		/**< Operation mix. */
+	ion_boolean_t			zipfian;		/**< Zipfian rather than uniform keys. */
+	uint32_t				records;		/**< Records loaded up front. */
+	uint32_t				operations;		/**< Operations timed. */
+	ion_key_size_t			key_size;		/**< Key size in bytes. */
+	ion_value_size_t		value_size;		/**< Value size in bytes. */
+	uint32_t				scan_length;	/**< Records read per scan. */
+	int						miss;			/**< Overrides the workload's miss share when
+												 not negative. */
+	uint16_t				seed;			/**< Seed of the generators. */
+	ion_boolean_t			json;			/**< JSON rather than CSV output. */
+} ion_bench_config_t;
+
+/**
+@brief		Reproducible 32 bit random numbers built from two
+			@ref lfsr_t generators.
+@details	The high generator skips one step every time the low one
+			completes its period, so the pair only repeats after
+			65535 * 65535 draws.
+*/
+typedef struct {
+	lfsr_t	low;	/**< Generates the low 16 bits. */
+	lfsr_t	high;	/**< Generates the high 16 bits. */
+} ion_bench_random_t;
+
+/**
+@brief		Precomputed state of the YCSB Zipfian generator.
+*/
+typedef struct {
+	uint32_t	items;	/**< Number of distinct keys. */
+	double		zetan;	/**< zeta(items, theta). */
+	double		alpha;	/**< 1 / (1 - theta). */
+	double		eta;	/**< Correction term of the generator. */
+	double		half_pow_theta;	/**< 0.5 ^ theta. */
+} ion_bench_zipfian_t;
+
+static ion_bench_workload_t ion_bench_workloads[] = {
+	{ "a", 50, 50, 0, 0, 0, 0 }, { "b", 95, 5, 0, 0, 0, 0 }, { "c", 100, 0, 0, 0, 0, 0 }, { "e", 0, 0, 5, 95, 0, 0 }, { "f", 50, 0, 0, 0, 50, 0 }, { "miss", 100, 0, 0, 0, 0, 100 }
+};
+
+static ion_bench_handler_t ion_bench_handlers[] = {
+	{ "bpp_tree", bpptree_init }, { "flat_file", ffdict_init }, { "open_address_hash", oadict_init }, { "open_address_file_hash", oafdict_init }, { "skip_list", sldict_init }, { "linear_hash", linear_hash_dict_init }, { "lsm", lsmdict_init }, { "concurrent_skip_list", csldict_init }, { "sharded", sharddict_init }
+};
+
+#define ION_BENCH_NUM_WORKLOADS (sizeof(ion_bench_workloads) / sizeof(ion_bench_workloads[0]))
+#define ION_BENCH_NUM_HANDLERS	(sizeof(ion_bench_handlers) / sizeof(ion_bench_handlers[0]))
+
+static void
+ion_bench_random_init(
+	ion_bench_random_t	*random,
+	uint16_t			seed
+) {
+	/* Both generators need a nonzero start state. */
+	lfsr_init_start_state(0 == seed ? 1 : seed, &random->low);
+	lfsr_init_start_state((uint16_t) (seed * 31421u + 6927u) | 1u, &random->high);
+}
+
+static uint32_t
+ion_bench_random_next(
+	ion_bench_random_t *random
+) {
+	uint16_t low = lfsr_get_next(&random->low);
+
+	if (low == random->low.start_state) {
+		lfsr_get_next(&random->high);
+	}
+
+	return ((uint32_t) lfsr_get_next(&random->high) << 16) ^ low;
+}
+
+static double
+ion_bench_random_unit(
+	ion_bench_random_t *random
+) {
+	return ion_bench_random_next(random) / 4294967296.0;
+}
+
+static void
+ion_bench_zipfian_init(
+	ion_bench_zipfian_t *zipfian,
+	uint32_t			items
+) {
+	uint32_t	i;
+	double		zeta2;
+
+	zipfian->items			= items;
+	zipfian->zetan			= 0;
+
+	for (i = 1; i <= items; i++) {
+		zipfian->zetan += 1.0 / pow(i, ION_BENCH_ZIPFIAN_THETA);
+	}
+
+	zeta2					= 1.0 + pow(0.5, ION_BENCH_ZIPFIAN_THETA);
+	zipfian->alpha			= 1.0 / (1.0 - ION_BENCH_ZIPFIAN_THETA);
+	zipfian->eta			= (1.0 - pow(2.0 / items, 1.0 - ION_BENCH_ZIPFIAN_THETA)) / (1.0 - zeta2 / zipfian->zetan);
+	zipfian->half_pow_theta = pow(0.5, ION_BENCH_ZIPFIAN_THETA);
+}
+
+/**
+@brief		Draws a key following the Zipfian distribution, scrambled so
+			that the popular keys are spread over the key space as in
+			YCSB.
+*/
+static uint32_t
+ion_bench_zipfian_next(
+	ion_bench_zipfian_t *zipfian,
+	ion_bench_random_t	*random
+) {
+	double		u	= ion_bench_random_unit(random);
+	double		uz	= u * zipfian->zetan;
+	uint32_t	rank;
+
+	if (uz < 1.0) {
+		rank = 0;
+	}
+	else if (uz < 1.0 + zipfian->half_pow_theta) {
+		rank = 1;
+	}
+	else {
+		rank = (uint32_t) (zipfian->items * pow(zipfian->eta * u - zipfian->eta + 1, zipfian->alpha));
+	}
+
+	return (uint32_t) (((uint64_t) rank * 2654435761u) % zipfian->items);
+}
+
+/**
+@brief		Writes a key number into a key buffer.
+@details	Keys are unsigned and little-endian, zero-extended to the key
+			size, so that range scans follow the key numbers.
+*/
+static void
+ion_bench_make_key(
+	ion_byte_t		*key,
+	ion_key_size_t	key_size,
+	uint32_t		number
+) {
+	memset(key, 0, key_size);
+	key[0]	= (ion_byte_t) number;
+	key[1]	= (ion_byte_t) (number >> 8);
+	key[2]	= (ion_byte_t) (number >> 16);
+	key[3]	= (ion_byte_t) (number >> 24);
+}
+
+static void
+ion_bench_make_value(
+	ion_byte_t			*value,
+	ion_value_size_t	value_size,
+	ion_bench_random_t	*random
+) {
+	int i;
+
+	for (i = 0; i < value_size; i++) {
+		value[i] = (ion_byte_t) ion_bench_random_next(random);
+	}
+}
+
+static uint64_t
+ion_bench_now_ns(
+	void
+) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+/**
+@brief		Reads the read and write system call byte totals of this
+			process. Both are left at zero where @c /proc is unavailable.
+*/
+static void
+ion_bench_io_bytes(
+	uint64_t	*read_bytes,
+	uint64_t	*written_bytes
+) {
+	char				line[64];
+	unsigned long long	amount;
+	FILE				*io = fopen("/proc/self/io", "r");
+
+	*read_bytes		= 0;
+	*written_bytes	= 0;
+
+	if (NULL == io) {
+		return;
+	}
+
+	while (NULL != fgets(line, sizeof(line), io)) {
+		if (1 == sscanf(line, "rchar: %llu", &amount)) {
+			*read_bytes = amount;
+		}
+		else if (1 == sscanf(line, "wchar: %llu", &amount)) {
+			*written_bytes = amount;
+		}
+	}
+
+	fclose(io);
+}
+
+static int
+ion_bench_compare_latency(
+	const void	*first,
+	const void	*second
+) {
+	uint64_t	a	= *(const uint64_t *) first;
+	uint64_t	b	= *(const uint64_t *) second;
+
+	return (a > b) - (a < b);
+}
+
+static double
+ion_bench_percentile_us(
+	uint64_t	*sorted,
+	uint32_t	count,
+	double		percentile
+) {
+	uint32_t index;
+
+	if (0 == count) {
+		return 0;
+	}
+
+	index = (uint32_t) (percentile / 100.0 * (count - 1) + 0.5);
+
+	return sorted[index] / 1000.0;
+}
+
+/**
+@brief		Picks the dictionary size parameter suited to a handler.
+*/
+static ion_dictionary_size_t
+ion_bench_dictionary_size(
+	ion_bench_handler_t *handler,
+	ion_bench_config_t	*config
+) {
+	ion_dictionary_size_t	levels;
+	uint32_t				capacity;
+
+	if ((oadict_init == handler->init) || (oafdict_init == handler->init)) {
+		/* Fixed capacity tables; leave room for inserts and keep the load factor at one half. */
+		return 2 * (config->records + config->operations);
+	}
+
+	/* Shards are skip lists unless configured otherwise. */
+	if ((sldict_init == handler->init) || (csldict_init == handler->init) || (sharddict_init == handler->init)) {
+		for (levels = 1, capacity = 2; capacity < config->records + config->operations; levels++) {
+			capacity *= 2;
+		}
+
+		return levels < 7 ? 7 : levels;
+	}
+
+	if (bpptree_init == handler->init) {
+		return -1;
+	}
+
+	if (lsmdict_init == handler->init) {
+		/* Records held in the memtable before it is written out as a run. */
+		return 256;
+	}
+
+	/* Flat file and linear hash: records buffered per I/O. */
+	return 15;
+}
+
+/**
+@brief		Loads a dictionary, runs the workload against it and prints
+			one result line.
+@returns	Zero on success, nonzero if the dictionary could not be
+			created or loaded.
+*/
+static int
+ion_bench_run(
+	ion_bench_handler_t *handler,
+	ion_bench_config_t	*config
+) {
+	ion_dictionary_handler_t	dictionary_handler;
+	ion_dictionary_t			dictionary;
+	ion_bench_random_t			random;
+	ion_bench_zipfian_t			zipfian;
+	ion_dict_cursor_t			*cursor;
+	ion_predicate_t				predicate;
+	ion_record_t				record;
+	ion_status_t				status;
+	ion_byte_t					*key;
+	ion_byte_t					*upper_key;
+	ion_byte_t					*value;
+	uint64_t					*latencies;
+	uint64_t					load_start, run_start, run_end, start;
+	uint64_t					read_before, written_before, read_after, written_after;
+	uint32_t					next_key;
+	uint32_t					number;
+	uint32_t					i;
+	uint32_t					j;
+	uint32_t					errors;
+	ion_bench_op_t				op;
+	int							dice;
+	int							miss;
+	struct rusage				usage;
+
+	handler->init(&dictionary_handler);
+
+	if ((0 < config->workload.scan) && (NULL == dictionary_handler.find)) {
+		fprintf(stderr, "%s: skipped, no cursor support for scans\n", handler->name);
+		return 0;
+	}
+
+	if (err_ok != dictionary_create(&dictionary_handler, &dictionary, ION_BENCH_DICTIONARY_ID, key_type_numeric_unsigned, config->key_size, config->value_size, ion_bench_dictionary_size(handler, config))) {
+		fprintf(stderr, "%s: could not create dictionary\n", handler->name);
+		return 1;
+	}
+
+	key				= malloc(config->key_size);
+	upper_key		= malloc(config->key_size);
+	value			= malloc(config->value_size);
+	record.key		= malloc(config->key_size);
+	record.value	= malloc(config->value_size);
+	latencies		= malloc(sizeof(uint64_t) * (config->operations + 1));
+
+	if ((NULL == key) || (NULL == upper_key) || (NULL == value) || (NULL == record.key) || (NULL == record.value) || (NULL == latencies)) {
+		fprintf(stderr, "%s: out of memory\n", handler->name);
+		return 1;
+	}
+
+	ion_bench_random_init(&random, config->seed);
+
+	if (config->zipfian) {
+		ion_bench_zipfian_init(&zipfian, config->records);
+	}
+
+	miss		= config->miss >= 0 ? config->miss : config->workload.miss;
+	errors		= 0;
+	load_start	= ion_bench_now_ns();
+
+	for (i = 0; i < config->records; i++) {
+		ion_bench_make_key(key, config->key_size, i);
+		ion_bench_make_value(value, config->value_size, &random);
+
+		if (err_ok != dictionary_insert(&dictionary, key, value).error) {
+			fprintf(stderr, "%s: load failed at record %u\n", handler->name, (unsigned) i);
+			dictionary_delete_dictionary(&dictionary);
+			return 1;
+		}
+	}
+
+	ion_bench_io_bytes(&read_before, &written_before);
+	next_key	= config->records;
+	run_start	= ion_bench_now_ns();
+
+	for (i = 0; i < config->operations; i++) {
+		dice = (int) (ion_bench_random_next(&random) % 100);
+
+		if (dice < config->workload.read) {
+			op = ion_bench_read;
+		}
+		else if ((dice -= config->workload.read) < config->workload.update) {
+			op = ion_bench_update;
+		}
+		else if ((dice -= config->workload.update) < config->workload.insert) {
+			op = ion_bench_insert;
+		}
+		else if ((dice -= config->workload.insert) < config->workload.scan) {
+			op = ion_bench_scan;
+		}
+		else {
+			op = ion_bench_read_modify_write;
+		}
+
+		if (ion_bench_insert == op) {
+			number = next_key++;
+		}
+		else if (config->zipfian) {
+			number = ion_bench_zipfian_next(&zipfian, &random);
+		}
+		else {
+			number = ion_bench_random_next(&random) % config->records;
+		}
+
+		/* Absent keys lie just past everything that can ever be inserted. */
+		if ((ion_bench_read == op) && ((int) (ion_bench_random_next(&random) % 100) < miss)) {
+			number += config->records + config->operations;
+		}
+
+		ion_bench_make_key(key, config->key_size, number);
+
+		if ((ion_bench_update == op) || (ion_bench_insert == op) || (ion_bench_read_modify_write == op)) {
+			ion_bench_make_value(value, config->value_size, &random);
+		}
+
+		start = ion_bench_now_ns();
+
+		switch (op) {
+			case ion_bench_read:
+				status = dictionary_get(&dictionary, key, value);
+				errors += (err_ok != status.error) && (err_item_not_found != status.error);
+				break;
+
+			case ion_bench_update:
+				status	= dictionary_update(&dictionary, key, value);
+				errors	+= err_ok != status.error;
+				break;
+
+			case ion_bench_insert:
+				status	= dictionary_insert(&dictionary, key, value);
+				errors	+= err_ok != status.error;
+				break;
+
+			case ion_bench_read_modify_write:
+				status = dictionary_get(&dictionary, key, record.value);
+
+				if (err_ok == status.error) {
+					status = dictionary_update(&dictionary, key, value);
+				}
+
+				errors += err_ok != status.error;
+				break;
+
+			case ion_bench_scan:
+				ion_bench_make_key(upper_key, config->key_size, number + config->scan_length - 1);
+				cursor = NULL;
+
+				if ((err_ok != dictionary_build_predicate(&predicate, predicate_range, key, upper_key)) || (err_ok != dictionary_find(&dictionary, &predicate, &cursor))) {
+					errors++;
+					break;
+				}
+
+				for (j = 0; j < config->scan_length && cs_cursor_active == cursor->next(cursor, &record); j++) {}
+
+				cursor->destroy(&cursor);
+				break;
+		}
+
+		latencies[i] = ion_bench_now_ns() - start;
+	}
+
+	run_end = ion_bench_now_ns();
+	ion_bench_io_bytes(&read_after, &written_after);
+	getrusage(RUSAGE_SELF, &usage);
+
+	qsort(latencies, config->operations, sizeof(uint64_t), ion_bench_compare_latency);
+
+	{
+		double	load_seconds	= (run_start - load_start) / 1e9;
+		double	run_seconds		= (run_end - run_start) / 1e9;
+		double	ops_per_second	= run_seconds > 0 ? config->operations / run_seconds : 0;
+		double	max_us			= 0 < config->operations ? latencies[config->operations - 1] / 1000.0 : 0;
+
+		if (config->json) {
+			printf("{\"handler\":\"%s\",\"workload\":\"%s\",\"distribution\":\"%s\",\"records\":%u,\"operations\":%u,\"key_size\":%d,\"value_size\":%d,\"load_seconds\":%.6f,\"ops_per_second\":%.1f,\"p50_us\":%.3f,\"p95_us\":%.3f,\"p99_us\":%.3f,\"p999_us\":%.3f,\"max_us\":%.3f,\"bytes_read\":%llu,\"bytes_written\":%llu,\"peak_rss_kb\":%ld,\"errors\":%u}\n", handler->name, config->workload.name, config->zipfian ? "zipfian" : "uniform", (unsigned) config->records, (unsigned) config->operations, (int) config->key_size, (int) config->value_size, load_seconds, ops_per_second, ion_bench_percentile_us(latencies, config->operations, 50), ion_bench_percentile_us(latencies, config->operations, 95), ion_bench_percentile_us(latencies, config->operations, 99), ion_bench_percentile_us(latencies, config->operations, 99.9), max_us, (unsigned long long) (read_after - read_before), (unsigned long long) (written_after - written_before), (long) usage.ru_maxrss, (unsigned) errors);
+		}
+		else {
+			printf("%s,%s,%s,%u,%u,%d,%d,%.6f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu,%llu,%ld,%u\n", handler->name, config->workload.name, config->zipfian ? "zipfian" : "uniform", (unsigned) config->records, (unsigned) config->operations, (int) config->key_size, (int) config->value_size, load_seconds, ops_per_second, ion_bench_percentile_us(latencies, config->operations, 50), ion_bench_percentile_us(latencies, config->operations, 95), ion_bench_percentile_us(latencies, config->operations, 99), ion_bench_percentile_us(latencies, config->operations, 99.9), max_us, (unsigned long long) (read_after - read_before), (unsigned long long) (written_after - written_before), (long) usage.ru_maxrss, (unsigned) errors);
+		}
+	}
+
+	fflush(stdout);
+
+	free(key);
+	free(upper_key);
+	free(value);
+	free(record.key);
+	free(record.value);
+	free(latencies);
+
+	return err_ok == dictionary_delete_dictionary(&dictionary) ? 0 : 1;
+}
+
+static void
+ion_bench_usage(
+	char *program
+) {
+	fprintf(stderr, "usage: %s [-h handler|all] [-w a|b|c|e|f|miss] [-d uniform|zipfian] [-n records] [-o operations] [-k key_size] [-v value_size] [-l scan_length] [-m miss_percent] [-s seed] [-f csv|json]\n", program);
+}
+
+int
+main(
+	int		argc,
+	char	**argv
+) {
+	ion_bench_config_t	config		= { { 0 }, boolean_false, 1000, 10000, 4, 8, 10, -1, 0xACE1u, boolean_false };
+	char				*handler	= "all";
+	char				*workload	= "a";
+	pid_t				child;
+	size_t				i;
+	int					option;
+	int					status;
+	int					failures	= 0;
+	ion_boolean_t		found		= boolean_false;
+
+	while (-1 != (option = getopt(argc, argv, "h:w:d:n:o:k:v:l:m:s:f:"))) {
+		switch (option) {
+			case 'h':
+				handler = optarg;
+				break;
+
+			case 'w':
+				workload = optarg;
+				break;
+
+			case 'd':
+				config.zipfian = 0 == strcmp(optarg, "zipfian");
+				break;
+
+			case 'n':
+				config.records = (uint32_t) strtoul(optarg, NULL, 10);
+				break;
+
+			case 'o':
+				config.operations = (uint32_t) strtoul(optarg, NULL, 10);
+				break;
+
+			case 'k':
+				config.key_size = atoi(optarg);
+				break;
+
+			case 'v':
+				config.value_size = atoi(optarg);
+				break;
+
+			case 'l':
+				config.scan_length = (uint32_t) strtoul(optarg, NULL, 10);
+				break;
+
+			case 'm':
+				config.miss = atoi(optarg);
+				break;
+
+			case 's':
+				config.seed = (uint16_t) strtoul(optarg, NULL, 10);
+				break;
+
+			case 'f':
+				config.json = 0 == strcmp(optarg, "json");
+				break;
+
+			default:
+				ion_bench_usage(argv[0]);
+				return 2;
+		}
+	}
+
+	for (i = 0; i < ION_BENCH_NUM_WORKLOADS; i++) {
+		if (0 == strcmp(workload, ion_bench_workloads[i].name)) {
+			config.workload = ion_bench_workloads[i];
+		}
+	}
+
+	if ((NULL == config.workload.name) || (config.key_size < 4) || (config.value_size < 1) || (0 == config.records) || (0 == config.scan_length)) {
+		ion_bench_usage(argv[0]);
+		return 2;
+	}
+
+	if (!config.json) {
+		printf("handler,workload,distribution,records,operations,key_size,value_size,load_seconds,ops_per_second,p50_us,p95_us,p99_us,p999_us,max_us,bytes_read,bytes_written,peak_rss_kb,errors\n");
+	}
+
+	for (i = 0; i < ION_BENCH_NUM_HANDLERS; i++) {
+		if ((0 != strcmp(handler, "all")) && (0 != strcmp(handler, ion_bench_handlers[i].name))) {
+			continue;
+		}
+
+		found = boolean_true;
+		fflush(stdout);
+		child = fork();
+
+		if (0 == child) {
+			exit(ion_bench_run(&ion_bench_handlers[i], &config));
+		}
+
+		if ((child < 0) || (child != waitpid(child, &status, 0)) || !WIFEXITED(status) || (0 != WEXITSTATUS(status))) {
+			fprintf(stderr, "%s: run failed\n", ion_bench_handlers[i].name);
+			failures++;
+		}
+	}
+
+	if (!found) {
+		ion_bench_usage(argv[0]);
+		return 2;
+	}
+
+	return 0 == failures ? 0 : 1;
+}
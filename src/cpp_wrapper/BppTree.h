@@ -53,21 +53,16 @@ public:
 				the master table. If the dictionary is being created without
 				the master table, this identifier can be 0.
 @param		key_type
-				The type of keys to be stored in the dictionary.
-@param		key_size
-				The size of keys to be stored in the dictionary.
-@param		value_size
-				The size of the values to be stored in the dictionary.
+				The type of keys to be stored in the dictionary. Defaults to
+				the one derived from @p K.
 */
 BppTree(
 	ion_dictionary_id_t id,
-	ion_key_type_t		key_type,
-	int					key_size,
-	int					value_size
+	ion_key_type_t		key_type = KeyType<K>::value
 ) {
 	bpptree_init(&this->handler);
 
-	this->initializeDictionary(id, key_type, key_size, value_size, 0);
+	this->initializeDictionary(id, key_type, 0);
 }
 
 BppTree(
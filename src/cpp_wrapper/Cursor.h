@@ -38,57 +38,282 @@
 #if !defined(CURSOR_H)
 #define CURSOR_H
 
+#if !defined(ARDUINO)
+#include <iterator>
+#endif
+
+/** How many records a C++ cursor fetches from its dictionary at a time. */
+#if !defined(ION_CPP_CURSOR_BATCH_SIZE)
+#if defined(ARDUINO)
+#define ION_CPP_CURSOR_BATCH_SIZE 4
+#else
+#define ION_CPP_CURSOR_BATCH_SIZE 16
+#endif
+#endif
+
+/**
+@brief		A key and its value, as produced by iterating over a cursor.
+@details	With C++17 the members can be taken apart directly, as in
+			<tt>for (auto &[key, value] : dictionary->allRecords())</tt>.
+*/
+template<typename K, typename V>
+struct Record {
+	K	key;
+	V	value;
+};
+
 template<typename K, typename V>
 class Cursor {
 public:
+/**
+@brief		A single pass iterator over the records of a cursor.
+@details	All iterators of a cursor share its position, so advancing one
+			advances them all. A dereferenced record stays valid until the
+			cursor is advanced again.
+*/
+class iterator {
+public:
+#if !defined(ARDUINO)
+typedef std::input_iterator_tag	iterator_category;
+typedef Record<K, V>			value_type;
+typedef std::ptrdiff_t			difference_type;
+typedef Record<K, V>			*pointer;
+typedef Record<K, V>			&reference;
+#endif
+
+/** Holds on to the record an iterator was at before a postfix increment. */
+class postfix {
+public:
+Record<K, V> record;
+
+const Record<K, V> &
+operator*(
+) const {
+	return record;
+}
+};
+
+iterator(
+) : cursor(NULL) {}
+
+explicit iterator(
+	Cursor *source
+) : cursor(source) {}
+
+Record<K, V> &
+operator*(
+) const {
+	return cursor->buffer[cursor->position];
+}
+
+Record<K, V> *
+operator->(
+) const {
+	return &cursor->buffer[cursor->position];
+}
+
+iterator &
+operator++(
+) {
+	if (!cursor->next()) {
+		cursor = NULL;
+	}
+
+	return *this;
+}
+
+postfix
+operator++(
+	int
+) {
+	postfix previous = { **this };
+
+	++*this;
+	return previous;
+}
+
+bool
+operator==(
+	const iterator &other
+) const {
+	return cursor == other.cursor;
+}
+
+bool
+operator!=(
+	const iterator &other
+) const {
+	return cursor != other.cursor;
+}
+
+private:
+
+Cursor *cursor;
+};
+
+/**
+@brief		Starts a query on a dictionary.
+@details	Records are fetched @ref ION_CPP_CURSOR_BATCH_SIZE at a time into
+			storage held by the cursor itself, so a cursor is usually kept
+			on the stack. A query that could not be started yields no
+			records. The cursor has to be destroyed before @p dictionary is.
+@param		dictionary
+				The dictionary to query.
+@param		predicate
+				The predicate describing the records to return.
+*/
 Cursor(
 	ion_dictionary_t	*dictionary,
 	ion_predicate_t		*predicate
+) : cursor(NULL), count(0), position(0) {
+	bind();
+
+	if (err_ok != dictionary_find(dictionary, predicate, &cursor)) {
+		cursor = NULL;
+	}
+}
+
+/**
+@brief		Takes over the query of another cursor, leaving it exhausted.
+*/
+Cursor(
+	Cursor &&other
+) : cursor(other.cursor), count(other.count), position(other.position) {
+	bind();
+	take(other);
+}
+
+Cursor &
+operator=(
+	Cursor &&other
 ) {
-	this->dictionary	= dictionary;
-	dictionary_find(dictionary, predicate, &cursor);
-	record.key			= malloc(dictionary->instance->record.key_size);
-	record.value		= malloc(dictionary->instance->record.value_size);
+	if (this != &other) {
+		release();
+		cursor		= other.cursor;
+		count		= other.count;
+		position	= other.position;
+		take(other);
+	}
+
+	return *this;
 }
 
+/* The C cursor can only be destroyed once, so it has a single owner. */
+Cursor(
+	const Cursor &
+) = delete;
+
+Cursor &
+operator=(
+	const Cursor &
+) = delete;
+
 ~Cursor(
 ) {
-	cursor->destroy(&cursor);
-	free(record.key);
-	free(record.value);
+	release();
 }
 
 bool
 hasNext(
 ) {
-	return cursor->status == cs_cursor_initialized || cursor->status == cs_cursor_active;
+	return position + 1 < count || (NULL != cursor && (cursor->status == cs_cursor_initialized || cursor->status == cs_cursor_active));
 }
 
+/**
+@brief		Moves to the next record, fetching another batch once the
+			buffered records are used up.
+@returns	@c true if there is a current record.
+*/
 bool
 next(
 ) {
-	ion_cursor_status_t status = cursor->next(cursor, &record);
+	if (position + 1 < count) {
+		position++;
+		return true;
+	}
+
+	position	= 0;
+	count		= 0;
+
+	if ((NULL == cursor) || ((cursor->status != cs_cursor_initialized) && (cursor->status != cs_cursor_active))) {
+		return false;
+	}
 
-	return status == cs_cursor_initialized || status == cs_cursor_active;
+	dictionary_cursor_next_batch(cursor, slots, ION_CPP_CURSOR_BATCH_SIZE, &count);
+
+	return 0 < count;
 }
 
-K
+const K &
 getKey(
-) {
-	return *((K *) record.key);
+) const {
+	return buffer[position].key;
 }
 
-V
+const V &
 getValue(
+) const {
+	return buffer[position].value;
+}
+
+/**
+@brief		Returns an iterator at the current record, first moving to the
+			next record if there is none.
+*/
+iterator
+begin(
+) {
+	if ((position < count) || next()) {
+		return iterator(this);
+	}
+
+	return end();
+}
+
+iterator
+end(
 ) {
-	return *((V *) record.value);
+	return iterator();
 }
 
 private:
 
-ion_dictionary_t	*dictionary;
 ion_dict_cursor_t	*cursor;
-ion_record_t		record;
+ion_result_count_t	count;
+ion_result_count_t	position;
+Record<K, V>		buffer[ION_CPP_CURSOR_BATCH_SIZE];
+ion_record_t		slots[ION_CPP_CURSOR_BATCH_SIZE];
+
+void
+bind(
+) {
+	for (int i = 0; i < ION_CPP_CURSOR_BATCH_SIZE; i++) {
+		slots[i].key	= &buffer[i].key;
+		slots[i].value	= &buffer[i].value;
+	}
+}
+
+void
+take(
+	Cursor &other
+) {
+	for (ion_result_count_t i = 0; i < count; i++) {
+		buffer[i] = other.buffer[i];
+	}
+
+	other.cursor	= NULL;
+	other.count		= 0;
+	other.position	= 0;
+}
+
+void
+release(
+) {
+	if (NULL != cursor) {
+		cursor->destroy(&cursor);
+		cursor = NULL;
+	}
+}
 };
 
 #endif
@@ -43,28 +43,112 @@
 #include "../key_value/kv_system.h"
 #include "../dictionary/ion_master_table.h"
 
+#if !defined(ARDUINO)
+#include <type_traits>
+#endif
+
 #include "Cursor.h"
 
+/**
+@brief		Maps a C++ key type onto the IonDB key type, and with it the
+			comparison operator, used when none is given explicitly.
+@details	Integral types compare numerically with their own signedness.
+			Everything else is compared byte-wise as a fixed size array.
+*/
+template<typename K>
+struct KeyType {
+	static const ion_key_type_t value = key_type_char_array;
+};
+
+template<>
+struct KeyType<char> {
+	static const ion_key_type_t value = ((char) -1 < 0) ? key_type_numeric_signed : key_type_numeric_unsigned;
+};
+
+template<>
+struct KeyType<signed char> {
+	static const ion_key_type_t value = key_type_numeric_signed;
+};
+
+template<>
+struct KeyType<short> {
+	static const ion_key_type_t value = key_type_numeric_signed;
+};
+
+template<>
+struct KeyType<int> {
+	static const ion_key_type_t value = key_type_numeric_signed;
+};
+
+template<>
+struct KeyType<long> {
+	static const ion_key_type_t value = key_type_numeric_signed;
+};
+
+template<>
+struct KeyType<long long> {
+	static const ion_key_type_t value = key_type_numeric_signed;
+};
+
+template<>
+struct KeyType<unsigned char> {
+	static const ion_key_type_t value = key_type_numeric_unsigned;
+};
+
+template<>
+struct KeyType<unsigned short> {
+	static const ion_key_type_t value = key_type_numeric_unsigned;
+};
+
+template<>
+struct KeyType<unsigned int> {
+	static const ion_key_type_t value = key_type_numeric_unsigned;
+};
+
+template<>
+struct KeyType<unsigned long> {
+	static const ion_key_type_t value = key_type_numeric_unsigned;
+};
+
+template<>
+struct KeyType<unsigned long long> {
+	static const ion_key_type_t value = key_type_numeric_unsigned;
+};
+
 template<typename K, typename V>
 class Dictionary {
+#if !defined(ARDUINO)
+static_assert(std::is_trivially_copyable<K>::value, "Dictionary keys are stored as raw bytes and must be trivially copyable");
+static_assert(std::is_trivially_copyable<V>::value, "Dictionary values are stored as raw bytes and must be trivially copyable");
+#endif
+
 public:
 
+/** The size of every key, fixed by @p K. */
+static const ion_key_size_t		key_size	= sizeof(K);
+/** The size of every value, fixed by @p V. */
+static const ion_value_size_t	value_size	= sizeof(V);
+
 ion_dictionary_handler_t	handler;
 ion_dictionary_t			dict;
 ion_key_type_t				key_type;
-ion_key_size_t				key_size;
-ion_value_size_t			value_size;
 ion_dictionary_size_t		dict_size;
 ion_status_t				last_status;
 
+Dictionary(
+) {}
+
 ~Dictionary(
 ) {
-	this->deleteDictionary();
+	if (NULL != dict.instance) {
+		this->deleteDictionary();
+	}
 }
 
 /**
 @brief		Creates a dictionary with a specific identifier (for use through
 			the master table).
+@details	The key and value sizes are those of @p K and @p V.
 @param		dict_id
 				A unique identifier important for use of the dictionary through
 				the master table. If the dictionary is being created without
@@ -72,10 +156,6 @@ ion_status_t				last_status;
 @param		k_type
 				The type of key to be used with this dictionary, which
 				determines the key comparison operator.
-@param		k_size
-				The size of the key type to be used with this dictionary.
-@param		v_size
-				The size of the value type to be used with this dictionary.
 @param		dictionary_size
 				The dictionary implementation specific dictionary size
 				parameter.
@@ -85,16 +165,12 @@ ion_err_t
 initializeDictionary(
 	ion_dictionary_id_t		dict_id,
 	ion_key_type_t			k_type,
-	ion_key_size_t			k_size,
-	ion_value_size_t		v_size,
 	ion_dictionary_size_t	dictionary_size
 ) {
 	key_type	= k_type;
-	key_size	= k_size;
-	value_size	= v_size;
 	dict_size	= dictionary_size;
 
-	ion_err_t err = dictionary_create(&handler, &dict, dict_id, k_type, k_size, v_size, dictionary_size);
+	ion_err_t err = dictionary_create(&handler, &dict, dict_id, k_type, key_size, value_size, dictionary_size);
 
 	last_status.error = err;
 
@@ -112,13 +188,10 @@ initializeDictionary(
 */
 ion_status_t
 insert(
-	K	key,
-	V	value
+	const K &key,
+	const V &value
 ) {
-	ion_key_t	ion_key		= &key;
-	ion_value_t ion_value	= &value;
-
-	ion_status_t status		= dictionary_insert(&dict, ion_key, ion_value);
+	ion_status_t status = dictionary_insert(&dict, const_cast<K *>(&key), const_cast<V *>(&value));
 
 	this->last_status = status;
 
@@ -128,21 +201,20 @@ insert(
 /**
 @brief		Retrieve a value given a key.
 
+@details	The outcome of the lookup is left in @ref last_status.
 @param		key
 				The key to retrieve the value for.
-@return		value
-				A pointer to the value byte array to copy data into.
+@return		The value stored under @p key.
 */
 V
 get(
-	K key
+	const K &key
 ) {
-	ion_key_t	ion_key = &key;
-	ion_byte_t	ion_value[dict.instance->record.value_size];
+	V value = V();
 
-	this->last_status = dictionary_get(&dict, ion_key, ion_value);
+	this->last_status = dictionary_get(&dict, const_cast<K *>(&key), &value);
 
-	return *((V *) ion_value);
+	return value;
 }
 
 /**
@@ -154,10 +226,9 @@ get(
 */
 ion_status_t
 deleteRecord(
-	K key
+	const K &key
 ) {
-	ion_key_t		ion_key = &key;
-	ion_status_t	status	= dictionary_delete(&dict, ion_key);
+	ion_status_t status = dictionary_delete(&dict, const_cast<K *>(&key));
 
 	this->last_status = status;
 
@@ -175,12 +246,10 @@ deleteRecord(
 */
 ion_status_t
 update(
-	K	key,
-	V	value
+	const K &key,
+	const V &value
 ) {
-	ion_key_t		ion_key		= &key;
-	ion_value_t		ion_value	= &value;
-	ion_status_t	status		= dictionary_update(&dict, ion_key, ion_value);
+	ion_status_t status = dictionary_update(&dict, const_cast<K *>(&key), const_cast<V *>(&value));
 
 	this->last_status = status;
 
@@ -222,6 +291,8 @@ destroyDictionary(
 /**
 @brief	  Opens a dictionary, given the desired config.
 
+@details	The sizes recorded in @p config_info must be those of @p K and
+			@p V, otherwise the dictionary is left unopened.
 @param	  config_info
 				The configuration of the dictionary to be opened.
 @return	 An error message describing the result of of the open.
@@ -230,11 +301,16 @@ ion_err_t
 open(
 	ion_dictionary_config_info_t config_info
 ) {
+	if ((key_size != config_info.key_size) || (value_size != config_info.value_size)) {
+		dict.instance		= NULL;
+		last_status.error	= err_invalid_initial_size;
+
+		return err_invalid_initial_size;
+	}
+
 	ion_err_t err = dictionary_open(&handler, &dict, &config_info);
 
 	key_type			= config_info.type;
-	key_size			= config_info.key_size;
-	value_size			= config_info.value_size;
 	dict_size			= config_info.dictionary_size;
 	last_status.error	= err;
 
@@ -264,17 +340,15 @@ close(
 				The maximum key to be included in the query.
 @returns	An initialized cursor for the particular query.
 */
-Cursor<K, V> *
+Cursor<K, V>
 range(
-	K	min_key,
-	K	max_key
+	const K &min_key,
+	const K &max_key
 ) {
 	ion_predicate_t predicate;
-	ion_key_t		ion_min_key = &min_key;
-	ion_key_t		ion_max_key = &max_key;
 
-	dictionary_build_predicate(&predicate, predicate_range, ion_min_key, ion_max_key);
-	return new Cursor<K, V>(&dict, &predicate);
+	dictionary_build_predicate(&predicate, predicate_range, const_cast<K *>(&min_key), const_cast<K *>(&max_key));
+	return Cursor<K, V>(&dict, &predicate);
 }
 
 /**
@@ -285,15 +359,14 @@ range(
 				The key used to determine equality.
 @returns	An initialized cursor for the particular query.
 */
-Cursor<K, V> *
+Cursor<K, V>
 equality(
-	K key
+	const K &key
 ) {
 	ion_predicate_t predicate;
-	ion_key_t		ion_key = &key;
 
-	dictionary_build_predicate(&predicate, predicate_equality, ion_key);
-	return new Cursor<K, V>(&dict, &predicate);
+	dictionary_build_predicate(&predicate, predicate_equality, const_cast<K *>(&key));
+	return Cursor<K, V>(&dict, &predicate);
 }
 
 /**
@@ -302,14 +375,30 @@ equality(
 
 @returns	An initialized cursor for the particular query.
 */
-Cursor<K, V> *
+Cursor<K, V>
 allRecords(
 ) {
 	ion_predicate_t predicate;
 
 	dictionary_build_predicate(&predicate, predicate_all_records);
-	return new Cursor<K, V>(&dict, &predicate);
+	return Cursor<K, V>(&dict, &predicate);
 }
+
+/* The C dictionary points back at the handler, so a copy would share and double free the instance. */
+Dictionary(
+	const Dictionary &
+) = delete;
+
+Dictionary &
+operator=(
+	const Dictionary &
+) = delete;
 };
 
+template<typename K, typename V>
+const ion_key_size_t Dictionary<K, V>::key_size;
+
+template<typename K, typename V>
+const ion_value_size_t Dictionary<K, V>::value_size;
+
 #endif /* PROJECT_CPP_DICTIONARY_H */
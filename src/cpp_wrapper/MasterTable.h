@@ -46,6 +46,9 @@
 #include "OpenAddressHash.h"
 #include "SkipList.h"
 #include "LinearHash.h"
+#include "LsmTree.h"
+#include "ConcurrentSkipList.h"
+#include "Sharded.h"
 
 class MasterTable {
 public:
@@ -283,15 +286,14 @@ closeDictionary(
 				The type of key to be used with this dictionary.
 @param		v
 				The type of value to be used with this dictionary.
-@param		key_size
-				The size of the key type to be used with this dictionary.
-@param		value_size
-				The size of the value type to be used with this dictionary.
 @param		dictionary_size
 				The dictionary implementation specific dictionary size
 				parameter.
 @param		dictionary_type
-				The type of dictionary to be created.
+				The type of dictionary to be created. Every implementation
+				with a C++ wrapper is supported, including the LSM tree,
+				the concurrent skip list and the sharded dictionary. The
+				size is passed to each constructor as is.
 @returns	An error code describing the result of the operation.
 */
 template<typename K, typename V>
@@ -300,8 +302,6 @@ initializeDictionary(
 	ion_key_type_t			key_type,
 	K						k,
 	V						v,
-	ion_key_size_t			key_size,
-	ion_value_size_t		value_size,
 	ion_dictionary_size_t	dictionary_size,
 	ion_dictionary_type_t	dictionary_type
 ) {
@@ -314,43 +314,61 @@ initializeDictionary(
 
 	switch (dictionary_type) {
 		case dictionary_type_bpp_tree_t: {
-			dictionary = new BppTree<K, V>(id, key_type, key_size, value_size);
+			dictionary = new BppTree<K, V>(id, key_type);
 
 			break;
 		}
 
 		case dictionary_type_flat_file_t: {
-			dictionary = new FlatFile<K, V>(id, key_type, key_size, value_size, dictionary_size);
+			dictionary = new FlatFile<K, V>(id, dictionary_size, key_type);
 
 			break;
 		}
 
 		case dictionary_type_open_address_file_hash_t: {
-			dictionary = new OpenAddressFileHash<K, V>(id, key_type, key_size, value_size, dictionary_size);
+			dictionary = new OpenAddressFileHash<K, V>(id, dictionary_size, key_type);
 
 			break;
 		}
 
 		case dictionary_type_open_address_hash_t: {
-			dictionary = new OpenAddressHash<K, V>(id, key_type, key_size, value_size, dictionary_size);
+			dictionary = new OpenAddressHash<K, V>(id, dictionary_size, key_type);
 
 			break;
 		}
 
 		case dictionary_type_skip_list_t: {
-			dictionary = new SkipList<K, V>(id, key_type, key_size, value_size, dictionary_size);
+			dictionary = new SkipList<K, V>(id, dictionary_size, key_type);
 
 			break;
 		}
 
 		case dictionary_type_linear_hash_t: {
-			dictionary = new LinearHash<K, V>(id, key_type, key_size, value_size, dictionary_size);
+			dictionary = new LinearHash<K, V>(id, dictionary_size, key_type);
+
+			break;
+		}
+
+		case dictionary_type_lsm_t: {
+			dictionary = new LsmTree<K, V>(id, dictionary_size, key_type);
+
+			break;
+		}
+
+		case dictionary_type_concurrent_skip_list_t: {
+			dictionary = new ConcurrentSkipList<K, V>(id, dictionary_size, key_type);
+
+			break;
+		}
+
+		case dictionary_type_sharded_t: {
+			dictionary = new Sharded<K, V>(id, dictionary_size, key_type);
 
 			break;
 		}
 
 		case dictionary_type_error_t: {
-			dictionary				= new SkipList<K, V>(id, key_type, key_size, value_size, dictionary_size);
+			dictionary				= new SkipList<K, V>(id, dictionary_size, key_type);
 			dictionary->dict.status = ion_dictionary_status_error;
 			break;
 		}
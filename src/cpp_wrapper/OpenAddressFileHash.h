@@ -55,25 +55,20 @@ public:
 				A unique identifier important for use of the dictionary through
 				the master table. If the dictionary is being created without
 				the master table, this identifier can be 0.
-@param		key_type
-				The type of keys to be stored in the dictionary.
-@param		key_size
-				The size of keys to be stored in the dictionary.
-@param	  value_size
-				The size of the values to be stored in the dictionary.
 @param	  dictionary_size
 				The size desired for the dictionary.
+@param		key_type
+				The type of keys to be stored in the dictionary. Defaults to
+				the one derived from @p K.
 */
 OpenAddressFileHash(
 	ion_dictionary_id_t		id,
-	ion_key_type_t			key_type,
-	ion_key_size_t			key_size,
-	ion_value_size_t		value_size,
-	ion_dictionary_size_t	dictionary_size
+	ion_dictionary_size_t	dictionary_size,
+	ion_key_type_t			key_type = KeyType<K>::value
 ) {
 	oafdict_init(&this->handler);
 
-	this->initializeDictionary(id, key_type, key_size, value_size, dictionary_size);
+	this->initializeDictionary(id, key_type, dictionary_size);
 }
 
 OpenAddressFileHash(
@@ -88,14 +88,7 @@
 /* shortcuts */
 #define ks(ct)		((ct) * h->ks)
 
-/* statistics */
-int maxHeight;	/* maximum height attained */
-int nNodesIns;	/* number of nodes inserted */
-int nNodesDel;	/* number of nodes deleted */
-int nKeysIns;	/* number of keys inserted */
-int nKeysDel;	/* number of keys deleted */
-int nDiskReads;	/* number of disk reads */
-int nDiskWrites;/* number of disk writes */
+/* statistics are kept per handle, disk reads and writes are counted per file by ion_file */
 
 /* line number for last IO or memory error */
 int bErrLineNo;
@@ -141,11 +134,15 @@ typedef struct ion_bpp_h_node_tag {
 	void					*malloc1;	/* malloc'd resources */
 	void					*malloc2;	/* malloc'd resources */
 	ion_bpp_buffer_t		gbuf;			/* gather buffer, room for 3 sets */
-	ion_bpp_buffer_t		*curBuf;		/* current location */
-	ion_bpp_key_t			*curKey;	/* current key in current node */
 	unsigned int			maxCt;	/* minimum # keys in node */
 	int						ks;	/* sizeof key entry */
 	ion_bpp_address_t		nextFreeAdr;/* next free b-tree record address */
+	/* statistics */
+	int						maxHeight;	/* maximum height attained */
+	int						nNodesIns;	/* number of nodes inserted */
+	int						nNodesDel;	/* number of nodes deleted */
+	int						nKeysIns;	/* number of keys inserted */
+	int						nKeysDel;	/* number of keys deleted */
 } ion_bpp_h_node_t;
 
 #define error(rc) lineError(__LINE__, rc)
@@ -239,7 +236,6 @@ flush(
 #endif
 
 	buf->modified = boolean_false;
-	nDiskWrites++;
 	return bErrOk;
 }
 
@@ -368,7 +364,6 @@ readDisk(
 
 		buf->modified	= boolean_false;
 		buf->valid		= boolean_true;
-		nDiskReads++;
 
 #if 0
 		len = 1;
@@ -411,13 +406,81 @@ readDisk(
 
 		buf->modified	= boolean_false;
 		buf->valid		= boolean_true;
-		nDiskReads++;
 	}
 
 	*b = buf;
 	return bErrOk;
 }
 
+/*
+ * Reads a node for a reader. The root is read in place, and any other node
+ * is copied into the buffer of the reader. Only writers change the node cache
+ * of thread-safe builds, so concurrent readers look in it without reordering
+ * it, and read what is missing straight from the index file.
+*/
+static ion_bpp_err_t
+readNode(
+	ion_bpp_handle_t	handle,
+	ion_bpp_reader_t	*reader,
+	ion_bpp_address_t	adr,
+	ion_bpp_buffer_t	*buf
+) {
+	ion_bpp_h_node_t	*h = handle;
+	ion_bpp_buffer_t	*cached;	/* buffer in the node cache */
+
+	buf->adr = adr;
+
+	if (adr == 0) {
+		buf->p = h->root.p;
+		return bErrOk;
+	}
+
+	if ((reader->buffer == NULL) && ((reader->buffer = malloc(h->sectorSize)) == NULL)) {
+		return error(bErrMemory);
+	}
+
+	buf->p = reader->buffer;
+
+#if ION_THREAD_SAFE
+
+	for (cached = h->bufList.next; cached != &h->bufList; cached = cached->next) {
+		if (cached->valid && (cached->adr == adr)) {
+			memcpy(buf->p, cached->p, h->sectorSize);
+			return bErrOk;
+		}
+	}
+
+	if (err_ok != ion_fread_at(h->fp, adr, h->sectorSize, (ion_byte_t *) buf->p)) {
+		return error(bErrIO);
+	}
+
+#else
+
+	ion_bpp_err_t rc;	/* return code */
+
+	if ((rc = readDisk(handle, adr, &cached)) != 0) {
+		return rc;
+	}
+
+	memcpy(buf->p, cached->p, h->sectorSize);
+#endif
+
+	return bErrOk;
+}
+
+/*
+ * Records the node and key a reader is on.
+*/
+static void
+setReader(
+	ion_bpp_reader_t	*reader,
+	ion_bpp_buffer_t	*buf,
+	ion_bpp_key_t		*key
+) {
+	reader->node	= buf->p;
+	reader->key		= key;
+}
+
 typedef enum ION_BPP_MODE { MODE_FIRST, MODE_MATCH, MODE_FGEQ, MODE_LLEQ } ion_bpp_mode_e;
 
 static int
@@ -654,7 +717,7 @@ scatter(
 			}
 
 			iu++;
-			nNodesIns++;
+			h->nNodesIns++;
 		}
 		else if ((iu > 1) && (ct < (k0Min + (iu - 1) * knMin))) {
 			/* del a buffer */
@@ -666,7 +729,7 @@ scatter(
 			}
 
 			next(tmp[iu - 1]) = next(tmp[iu]);
-			nNodesDel++;
+			h->nNodesDel++;
 		}
 		else {
 			break;
@@ -993,14 +1056,15 @@ b_open(
 	p						= (ion_bpp_node_t *) ((char *) p + 3 * h->sectorSize);
 	h->gbuf.p				= p;/* done last to include extra 2 keys */
 
-	h->curBuf				= NULL;
-	h->curKey				= NULL;
-
 	/* initialize root */
 	if (ion_fexists(info.iName)) {
 		/* open an existing database */
 		h->fp = ion_fopen(info.iName);
 
+#if ION_FILE_STATS
+		ion_file_set_owner(h->fp, info.owner);
+#endif
+
 		if ((rc = readDisk(h, 0, &root)) != 0) {
 			return rc;
 		}
@@ -1014,10 +1078,9 @@ b_open(
 		}
 	}
 
-#if defined(ARDUINO)
-	else if (NULL != (h->fp = ion_fopen(info.iName)).file) {
-#else
-	else if (NULL != (h->fp = ion_fopen(info.iName))) {
+	else if (!ION_FILE_IS_NULL(h->fp = ion_fopen(info.iName))) {
+#if ION_FILE_STATS
+		ion_file_set_owner(h->fp, info.owner);
 #endif
 		/* initialize root */
 		memset(root->p, 0, 3 * h->sectorSize);
@@ -1036,6 +1099,24 @@ b_open(
 	return bErrOk;
 }
 
+ion_bpp_err_t
+b_sync(
+	ion_bpp_handle_t handle
+) {
+	ion_bpp_h_node_t	*h = handle;
+	ion_bpp_err_t		rc;
+
+	if ((rc = flushAll(handle)) != 0) {
+		return rc;
+	}
+
+	if (err_ok != ion_fsync(h->fp)) {
+		return bErrIO;
+	}
+
+	return bErrOk;
+}
+
 ion_bpp_err_t
 b_close(
 	ion_bpp_handle_t handle
@@ -1047,13 +1128,7 @@ b_close(
 	}
 
 	/* flush idx */
-#if defined(ARDUINO)
-
-	if (h->fp.file) {
-#else
-
-	if (h->fp) {
-#endif
+	if (!ION_FILE_IS_NULL(h->fp)) {
 		flushAll(handle);
 		ion_fclose(h->fp);
 	}
@@ -1070,27 +1145,45 @@ b_close(
 	return bErrOk;
 }
 
+void
+b_init_reader(
+	ion_bpp_reader_t *reader
+) {
+	reader->buffer	= NULL;
+	reader->node	= NULL;
+	reader->key		= NULL;
+}
+
+void
+b_free_reader(
+	ion_bpp_reader_t *reader
+) {
+	free(reader->buffer);
+	b_init_reader(reader);
+}
+
 ion_bpp_err_t
 b_get(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	ion_bpp_external_address_t	*rec
 ) {
 	ion_bpp_key_t		*mkey;			/* matched key */
-	ion_bpp_buffer_t	*buf;				/* buffer */
+	ion_bpp_buffer_t	node;				/* node being searched */
+	ion_bpp_buffer_t	*buf = &node;
 	ion_bpp_err_t		rc;			/* return code */
 
 	ion_bpp_h_node_t *h = handle;
 
-	buf = &h->root;
+	readNode(handle, reader, 0, buf);
 
 	/* find key, and return address */
 	while (1) {
 		if (leaf(buf)) {
 			if (search(handle, buf, key, 0, &mkey, MODE_FIRST) == 0) {
-				*rec		= rec(mkey);
-				h->curBuf	= buf;
-				h->curKey	= mkey;
+				*rec = rec(mkey);
+				setReader(reader, buf, mkey);
 				return bErrOk;
 			}
 			else {
@@ -1099,12 +1192,12 @@ b_get(
 		}
 		else {
 			if (search(handle, buf, key, 0, &mkey, MODE_MATCH) < 0) {
-				if ((rc = readDisk(handle, childLT(mkey), &buf)) != 0) {
+				if ((rc = readNode(handle, reader, childLT(mkey), buf)) != 0) {
 					return rc;
 				}
 			}
 			else {
-				if ((rc = readDisk(handle, childGE(mkey), &buf)) != 0) {
+				if ((rc = readNode(handle, reader, childGE(mkey), buf)) != 0) {
 					return rc;
 				}
 			}
@@ -1115,18 +1208,20 @@ b_get(
 ion_bpp_err_t
 b_find_first_greater_or_equal(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	void						*mkey,
 	ion_bpp_external_address_t	*rec
 ) {
 	ion_bpp_key_t		*lgeqkey;			/* matched key */
-	ion_bpp_buffer_t	*buf;				/* buffer */
+	ion_bpp_buffer_t	node;				/* node being searched */
+	ion_bpp_buffer_t	*buf = &node;
 	ion_bpp_err_t		rc;			/* return code */
 	int					cc;
 
 	ion_bpp_h_node_t *h = handle;
 
-	buf = &h->root;
+	readNode(handle, reader, 0, buf);
 
 	/* find key, and return address */
 	while (1) {
@@ -1139,10 +1234,9 @@ b_find_first_greater_or_equal(
 				lgeqkey += ks(1);
 			}
 
-			h->curBuf	= buf;
-			h->curKey	= lgeqkey;
+			setReader(reader, buf, lgeqkey);
 			memcpy(mkey, key(lgeqkey), h->keySize);
-			*rec		= rec(lgeqkey);
+			*rec = rec(lgeqkey);
 
 			return bErrOk;
 		}
@@ -1150,12 +1244,12 @@ b_find_first_greater_or_equal(
 			cc = search(handle, buf, key, 0, &lgeqkey, MODE_LLEQ);
 
 			if (cc < 0) {
-				if ((rc = readDisk(handle, childLT(lgeqkey), &buf)) != 0) {
+				if ((rc = readNode(handle, reader, childLT(lgeqkey), buf)) != 0) {
 					return rc;
 				}
 			}
 			else {
-				if ((rc = readDisk(handle, childGE(lgeqkey), &buf)) != 0) {
+				if ((rc = readNode(handle, reader, childGE(lgeqkey), buf)) != 0) {
 					return rc;
 				}
 			}
@@ -1208,8 +1302,8 @@ b_insert(
 		if (leaf(buf)) {
 			/* in leaf, and there' room guaranteed */
 
-			if (height > maxHeight) {
-				maxHeight = height;
+			if (height > h->maxHeight) {
+				h->maxHeight = height;
 			}
 
 			/* set mkey to point to insertion point */
@@ -1273,7 +1367,7 @@ b_insert(
 				}
 			}
 
-			nKeysIns++;
+			h->nKeysIns++;
 			break;
 		}
 		else {
@@ -1378,8 +1472,8 @@ b_update(
 		if (leaf(buf)) {
 			/* in leaf, and there' room guaranteed */
 
-			if (height > maxHeight) {
-				maxHeight = height;
+			if (height > h->maxHeight) {
+				h->maxHeight = height;
 			}
 
 			/* set mkey to point to update point */
@@ -1520,7 +1614,7 @@ b_delete(
 				}
 			}
 
-			nKeysDel++;
+			h->nKeysDel++;
 			break;
 		}
 		else {
@@ -1550,7 +1644,7 @@ b_delete(
 				if ((buf == root) && (ct(root) == 2) && (ct(gbuf) < (3 * (3 * h->maxCt)) / 4)) {
 					/* collapse tree by one level */
 					scatterRoot(handle);
-					nNodesDel += 3;
+					h->nNodesDel += 3;
 					continue;
 				}
 
@@ -1597,18 +1691,20 @@ b_delete(
 ion_bpp_err_t
 b_find_first_key(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	ion_bpp_external_address_t	*rec
 ) {
 	ion_bpp_err_t		rc;			/* return code */
-	ion_bpp_buffer_t	*buf;				/* buffer */
+	ion_bpp_buffer_t	node;				/* node being searched */
+	ion_bpp_buffer_t	*buf = &node;
 
 	ion_bpp_h_node_t *h = handle;
 
-	buf = &h->root;
+	readNode(handle, reader, 0, buf);
 
 	while (!leaf(buf)) {
-		if ((rc = readDisk(handle, childLT(fkey(buf)), &buf)) != 0) {
+		if ((rc = readNode(handle, reader, childLT(fkey(buf)), buf)) != 0) {
 			return rc;
 		}
 	}
@@ -1618,9 +1714,8 @@ b_find_first_key(
 	}
 
 	memcpy(key, key(fkey(buf)), h->keySize);
-	*rec		= rec(fkey(buf));
-	h->curBuf	= buf;
-	h->curKey	= fkey(buf);
+	*rec = rec(fkey(buf));
+	setReader(reader, buf, fkey(buf));
 	return bErrOk;
 }
 
@@ -1638,18 +1733,20 @@ b_find_first_key(
 ion_bpp_err_t
 b_find_last_key(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	ion_bpp_external_address_t	*rec
 ) {
 	ion_bpp_err_t		rc;			/* return code */
-	ion_bpp_buffer_t	*buf;				/* buffer */
+	ion_bpp_buffer_t	node;				/* node being searched */
+	ion_bpp_buffer_t	*buf = &node;
 
 	ion_bpp_h_node_t *h = handle;
 
-	buf = &h->root;
+	readNode(handle, reader, 0, buf);
 
 	while (!leaf(buf)) {
-		if ((rc = readDisk(handle, childGE(lkey(buf)), &buf)) != 0) {
+		if ((rc = readNode(handle, reader, childGE(lkey(buf)), buf)) != 0) {
 			return rc;
 		}
 	}
@@ -1659,33 +1756,34 @@ b_find_last_key(
 	}
 
 	memcpy(key, key(lkey(buf)), h->keySize);
-	*rec		= rec(lkey(buf));
-	h->curBuf	= buf;
-	h->curKey	= lkey(buf);
+	*rec = rec(lkey(buf));
+	setReader(reader, buf, lkey(buf));
 	return bErrOk;
 }
 
 ion_bpp_err_t
 b_find_next_key(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	ion_bpp_external_address_t	*rec
 ) {
 	ion_bpp_err_t		rc;			/* return code */
 	ion_bpp_key_t		*nkey;			/* next key */
-	ion_bpp_buffer_t	*buf;				/* buffer */
+	ion_bpp_buffer_t	node;				/* node the reader is on */
+	ion_bpp_buffer_t	*buf = &node;
 
 	ion_bpp_h_node_t *h = handle;
 
-	if ((buf = h->curBuf) == NULL) {
+	if ((buf->p = reader->node) == NULL) {
 		return bErrKeyNotFound;
 	}
 
-	if (h->curKey == lkey(buf)) {
+	if (reader->key == lkey(buf)) {
 		/* current key is last key in leaf node */
 		if (next(buf)) {
 			/* fetch next set */
-			if ((rc = readDisk(handle, next(buf), &buf)) != 0) {
+			if ((rc = readNode(handle, reader, next(buf), buf)) != 0) {
 				return rc;
 			}
 
@@ -1698,13 +1796,12 @@ b_find_next_key(
 	}
 	else {
 		/* bump to next key */
-		nkey = h->curKey + ks(1);
+		nkey = reader->key + ks(1);
 	}
 
 	memcpy(key, key(nkey), h->keySize);
-	*rec		= rec(nkey);
-	h->curBuf	= buf;
-	h->curKey	= nkey;
+	*rec = rec(nkey);
+	setReader(reader, buf, nkey);
 	return bErrOk;
 }
 
@@ -1721,27 +1818,29 @@ b_find_next_key(
 ion_bpp_err_t
 b_find_prev_key(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	ion_bpp_external_address_t	*rec
 ) {
 	ion_bpp_err_t		rc;			/* return code */
 	ion_bpp_key_t		*pkey;			/* previous key */
 	ion_bpp_key_t		*fkey;			/* first key */
-	ion_bpp_buffer_t	*buf;				/* buffer */
+	ion_bpp_buffer_t	node;				/* node the reader is on */
+	ion_bpp_buffer_t	*buf = &node;
 
 	ion_bpp_h_node_t *h = handle;
 
-	if ((buf = h->curBuf) == NULL) {
+	if ((buf->p = reader->node) == NULL) {
 		return bErrKeyNotFound;
 	}
 
 	fkey = fkey(buf);
 
-	if (h->curKey == fkey) {
+	if (reader->key == fkey) {
 		/* current key is first key in leaf node */
 		if (prev(buf)) {
 			/* fetch previous set */
-			if ((rc = readDisk(handle, prev(buf), &buf)) != 0) {
+			if ((rc = readNode(handle, reader, prev(buf), buf)) != 0) {
 				return rc;
 			}
 
@@ -1754,12 +1853,11 @@ b_find_prev_key(
 	}
 	else {
 		/* bump to previous key */
-		pkey = h->curKey - ks(1);
+		pkey = reader->key - ks(1);
 	}
 
 	memcpy(key, key(pkey), h->keySize);
-	*rec		= rec(pkey);
-	h->curBuf	= buf;
-	h->curKey	= pkey;
+	*rec = rec(pkey);
+	setReader(reader, buf, pkey);
 	return bErrOk;
 }
@@ -85,6 +85,17 @@ typedef enum ION_BPP_ERR {
 
 typedef void *ion_bpp_handle_t;
 
+/*
+ * Where a reader is in the tree. Readers each have their own, so that they can
+ * walk the tree side by side. Every node but the root is copied into the buffer
+ * of the reader, which is allocated the first time it is needed.
+ */
+typedef struct {
+	void	*buffer;	/* copy of the last node read, sector sized */
+	void	*node;		/* node the reader is on, the root or buffer */
+	char	*key;		/* key the reader is on within node */
+} ion_bpp_reader_t;
+
 typedef struct {
 	/* info for bOpen() */
 	char					*iName;	/* name of index file */
@@ -92,6 +103,9 @@ typedef struct {
 	ion_bpp_bool_t			dupKeys;		/* true if duplicate keys allowed */
 	size_t					sectorSize;	/* size of sector on disk */
 	ion_bpp_comparison_t	comp;			/* pointer to compare function */
+#if ION_FILE_STATS
+	ion_file_owner_t		owner;			/* who the index file's I/O is charged to */
+#endif
 } ion_bpp_open_t;
 
 /***********************
@@ -127,6 +141,41 @@ b_close(
  *   bErrOk				 file closed, resources deleted
 */
 
+ion_bpp_err_t
+b_sync(
+	ion_bpp_handle_t handle
+);
+
+/*
+ * input:
+ *   handle				 handle returned by bOpen
+ * returns:
+ *   bErrOk				 modified nodes written and forced to the device
+ *   bErrIO				 error writing or syncing the index file
+*/
+
+void
+b_init_reader(
+	ion_bpp_reader_t *reader
+);
+
+/*
+ * output:
+ *   reader				 reader that is on no key yet
+*/
+
+void
+b_free_reader(
+	ion_bpp_reader_t *reader
+);
+
+/*
+ * input:
+ *   reader				 reader set up by b_init_reader
+ * notes:
+ *   The reader is left as b_init_reader leaves it.
+*/
+
 ion_bpp_err_t
 b_insert(
 	ion_bpp_handle_t			handle,
@@ -199,6 +248,7 @@ b_delete(
 ion_bpp_err_t
 b_get(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	ion_bpp_external_address_t	*rec
 );
@@ -206,6 +256,7 @@ b_get(
 /*
  * input:
  *   handle				 handle returned by bOpen
+ *   reader				 reader to move to the key
  *   key					key to find
  * output:
  *   rec					record address
@@ -217,6 +268,7 @@ b_get(
 ion_bpp_err_t
 b_find_first_greater_or_equal(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	void						*mkey,
 	ion_bpp_external_address_t	*rec
@@ -225,6 +277,7 @@ b_find_first_greater_or_equal(
 /*
  * input:
  *   handle				 handle returned by bOpen
+ *   reader				 reader to move to the key found
  *   key					key to find
  * output:
  *   mkey				   key associated with the found offset
@@ -236,6 +289,7 @@ b_find_first_greater_or_equal(
 ion_bpp_err_t
 b_find_first_key(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	ion_bpp_external_address_t	*rec
 );
@@ -243,6 +297,7 @@ b_find_first_key(
 /*
  * input:
  *   handle				 handle returned by bOpen
+ *   reader				 reader to move to the first key
  * output:
  *   key					first key in sequential set
  *   rec					record address
@@ -254,6 +309,7 @@ b_find_first_key(
 ion_bpp_err_t
 b_find_last_key(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	ion_bpp_external_address_t	*rec
 );
@@ -261,6 +317,7 @@ b_find_last_key(
 /*
  * input:
  *   handle				 handle returned by bOpen
+ *   reader				 reader to move to the last key
  * output:
  *   key					last key in sequential set
  *   rec					record address
@@ -272,6 +329,7 @@ b_find_last_key(
 ion_bpp_err_t
 b_find_next_key(
 	ion_bpp_handle_t			handle,
+	ion_bpp_reader_t			*reader,
 	void						*key,
 	ion_bpp_external_address_t	*rec
 );
@@ -279,6 +337,7 @@ b_find_next_key(
 /*
  * input:
  *   handle				 handle returned by bOpen
+ *   reader				 reader to move on from the key it is on
  * output:
  *   key					key found
  *   rec					record address
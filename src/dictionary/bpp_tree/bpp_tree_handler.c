@@ -99,6 +99,9 @@ bpptree_create_dictionary(
 
 	bpptree_get_filename(id, value_filename);
 	bpptree->values.file_handle = ion_fopen(value_filename);
+#if ION_FILE_STATS
+	ion_file_set_owner(bpptree->values.file_handle, id);
+#endif
 
 	bpptree->values.next_empty	= ION_FILE_NULL;
 
@@ -115,6 +118,9 @@ bpptree_create_dictionary(
 	info.dupKeys	= boolean_false;
 	info.sectorSize = 256;
 	info.comp		= compare;
+#if ION_FILE_STATS
+	info.owner		= id;
+#endif
 
 	ion_bpp_err_t bErr = b_open(info, &(bpptree->tree));
 
@@ -133,6 +139,8 @@ bpptree_create_dictionary(
 	dictionary->instance->record.value_size = value_size;
 	dictionary->instance->type				= dictionary_type_bpp_tree_t;
 	dictionary->handler						= handler;
+	bpptree->version						= 0;
+	b_init_reader(&bpptree->reader);
 
 	return err_ok;
 }
@@ -160,9 +168,10 @@ bpptree_insert(
 	ion_file_offset_t	offset;
 
 	bpptree = (ion_bpptree_t *) dictionary->instance;
+	bpptree->version++;
 
 	offset	= ION_FILE_NULL;
-	bErr	= b_get(bpptree->tree, key, &offset);
+	bErr	= b_get(bpptree->tree, &bpptree->reader, key, &offset);
 
 	if (bErrKeyNotFound == bErr) {
 		offset = ION_FILE_NULL;
@@ -227,13 +236,21 @@ bpptree_get(
 
 	bpptree = (ion_bpptree_t *) dictionary->instance;
 
-	bErr	= b_get(bpptree->tree, key, &offset);
+#if ION_THREAD_SAFE
+	/* Gets run concurrently, so each one walks the tree with a reader of its own. */
+	ion_bpp_reader_t reader;
 
-	if (bErrOk != bErr) {
-		return ION_STATUS_ERROR(err_item_not_found);
-	}
+	b_init_reader(&reader);
+	bErr = b_get(bpptree->tree, &reader, key, &offset);
+	b_free_reader(&reader);
+#else
+	bErr = b_get(bpptree->tree, &bpptree->reader, key, &offset);
+#endif
+	err = err_item_not_found;
 
-	err = lfb_get(&(bpptree->values), offset, bpptree->super.record.value_size, (ion_byte_t *) value, &next);
+	if (bErrOk == bErr) {
+		err = lfb_get(&(bpptree->values), offset, bpptree->super.record.value_size, (ion_byte_t *) value, &next);
+	}
 
 	if (err_ok == err) {
 		return ION_STATUS_OK(1);
@@ -265,6 +282,7 @@ bpptree_delete(
 	status	= ION_STATUS_INITIALIZE;
 
 	bpptree = (ion_bpptree_t *) dictionary->instance;
+	bpptree->version++;
 
 	bErr	= b_delete(bpptree->tree, key, &offset);
 
@@ -296,6 +314,7 @@ bpptree_close_dictionary(
 	bpptree					= (ion_bpptree_t *) dictionary->instance;
 	bErr					= b_close(bpptree->tree);
 	ion_fclose(bpptree->values.file_handle);
+	b_free_reader(&bpptree->reader);
 	free(dictionary->instance);
 	dictionary->instance	= NULL;
 
@@ -306,6 +325,26 @@ bpptree_close_dictionary(
 	return err_ok;
 }
 
+/**
+@brief		Writes out the tree's modified nodes and forces them and the
+			values file to the device.
+@param		dictionary
+				The instance of the dictionary to sync.
+@return		The status of the sync.
+*/
+ion_err_t
+bpptree_sync_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	ion_bpptree_t *bpptree = (ion_bpptree_t *) dictionary->instance;
+
+	if (bErrOk != b_sync(bpptree->tree)) {
+		return err_file_write_error;
+	}
+
+	return ion_fsync(bpptree->values.file_handle);
+}
+
 /**
 @brief	  Deletes an instance of the dictionary and associated data.
 
@@ -395,8 +434,9 @@ bpptree_update(
 
 	count	= 0;
 	bpptree = (ion_bpptree_t *) dictionary->instance;
+	bpptree->version++;
 
-	bErr	= b_get(bpptree->tree, key, &offset);
+	bErr	= b_get(bpptree->tree, &bpptree->reader, key, &offset);
 
 	if (bErrKeyNotFound != bErr) {
 		lfb_update_all(&(bpptree->values), offset, bpptree->super.record.value_size, (ion_byte_t *) value, &count);
@@ -408,6 +448,42 @@ bpptree_update(
 	return ION_STATUS_OK(count);
 }
 
+/**
+@brief		Puts a cursor's reader back on the key the cursor last visited,
+			if the tree has been written to since the reader was placed.
+
+@details	The reader holds a copy of its leaf, which a write may have
+			split, merged or freed.
+
+@param		cursor
+				The cursor about to step forward.
+@param		key
+				The key the cursor last visited.
+@return		The status of the search.
+*/
+static ion_bpp_err_t
+bpptree_resume(
+	ion_dict_cursor_t	*cursor,
+	ion_key_t			key
+) {
+	ion_bpptree_t				*bpptree	= (ion_bpptree_t *) cursor->dictionary->instance;
+	ion_bpp_cursor_t			*bCursor	= (ion_bpp_cursor_t *) cursor;
+	ion_bpp_external_address_t	offset;
+	ion_bpp_err_t				bErr;
+
+	if (bCursor->version == bpptree->version) {
+		return bErrOk;
+	}
+
+	bErr = b_find_first_greater_or_equal(bpptree->tree, &bCursor->reader, key, alloca(bpptree->super.record.key_size), &offset);
+
+	if (bErrOk == bErr) {
+		bCursor->version = bpptree->version;
+	}
+
+	return bErr;
+}
+
 /**
 @brief		Next function to query and retrieve the next
 			<K,V> that stratifies the predicate of the cursor.
@@ -451,7 +527,11 @@ bpptree_next(
 				case predicate_range: {
 					/*do b_find_next_key then test_predicate */
 					if (-1 == bCursor->offset) {
-						ion_bpp_err_t bErr = b_find_next_key(bpptree->tree, bCursor->cur_key, &bCursor->offset);
+						ion_bpp_err_t bErr = bpptree_resume(cursor, bCursor->cur_key);
+
+						if (bErrOk == bErr) {
+							bErr = b_find_next_key(bpptree->tree, &bCursor->reader, bCursor->cur_key, &bCursor->offset);
+						}
 
 						if ((bErrOk != bErr) || (boolean_false == test_predicate(cursor, bCursor->cur_key))) {
 							is_valid = boolean_false;
@@ -463,7 +543,11 @@ bpptree_next(
 
 				case predicate_all_records: {
 					if (-1 == bCursor->offset) {
-						ion_bpp_err_t bErr = b_find_next_key(bpptree->tree, bCursor->cur_key, &bCursor->offset);
+						ion_bpp_err_t bErr = bpptree_resume(cursor, bCursor->cur_key);
+
+						if (bErrOk == bErr) {
+							bErr = b_find_next_key(bpptree->tree, &bCursor->reader, bCursor->cur_key, &bCursor->offset);
+						}
 
 						if (bErrOk != bErr) {
 							is_valid = boolean_false;
@@ -500,6 +584,86 @@ bpptree_next(
 	return cs_invalid_cursor;
 }
 
+/**
+@brief		Fetches up to @p max_records records from the cursor.
+
+@details	Keys are copied straight out of the current leaf into the caller's
+			records, and the leaf chain is followed without returning to the
+			caller between records. Should be called through
+			@ref dictionary_cursor_next_batch.
+
+@param		cursor
+				The cursor to iterate over the results.
+@param		records
+				An array of at least @p max_records allocated records.
+@param		max_records
+				The maximum number of records to fetch.
+@param		num_records
+				Written with the number of records fetched.
+@return		The status of the cursor.
+*/
+ion_cursor_status_t
+bpptree_next_batch(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*records,
+	ion_result_count_t	max_records,
+	ion_result_count_t	*num_records
+) {
+	ion_bpp_cursor_t	*bCursor	= (ion_bpp_cursor_t *) cursor;
+	ion_bpptree_t		*bpptree	= (ion_bpptree_t *) cursor->dictionary->instance;
+	ion_key_size_t		key_size	= cursor->dictionary->instance->record.key_size;
+	ion_value_size_t	value_size	= cursor->dictionary->instance->record.value_size;
+	ion_key_t			current_key = bCursor->cur_key;
+
+	*num_records = 0;
+
+	if ((cursor->status != cs_cursor_initialized) && (cursor->status != cs_cursor_active)) {
+		return cursor->status;
+	}
+
+	while (*num_records < max_records) {
+		ion_record_t *record = &records[*num_records];
+
+		if (cursor->status == cs_cursor_initialized) {
+			cursor->status = cs_cursor_active;
+			memcpy(record->key, current_key, key_size);
+		}
+		else if (-1 != bCursor->offset) {
+			/* More values are chained under the current key. */
+			memcpy(record->key, current_key, key_size);
+		}
+		else if ((predicate_range == cursor->predicate->type) || (predicate_all_records == cursor->predicate->type)) {
+			ion_bpp_err_t bErr = bpptree_resume(cursor, current_key);
+
+			if (bErrOk == bErr) {
+				bErr = b_find_next_key(bpptree->tree, &bCursor->reader, record->key, &bCursor->offset);
+			}
+
+			if ((bErrOk != bErr) || ((predicate_range == cursor->predicate->type) && (boolean_false == test_predicate(cursor, record->key)))) {
+				cursor->status = cs_end_of_results;
+				break;
+			}
+
+			current_key = record->key;
+		}
+		else {
+			/* Equality cursors have exhausted the only matching key. */
+			cursor->status = cs_end_of_results;
+			break;
+		}
+
+		lfb_get(&(bpptree->values), bCursor->offset, value_size, record->value, &bCursor->offset);
+		(*num_records)++;
+	}
+
+	/* Remember the last key visited so the leaf walk can resume from it. */
+	if (current_key != bCursor->cur_key) {
+		memcpy(bCursor->cur_key, current_key, key_size);
+	}
+
+	return 0 < *num_records ? cs_cursor_active : cursor->status;
+}
+
 /**
 @brief		Destroys the cursor.
 
@@ -516,6 +680,7 @@ void
 bpptree_destroy_cursor(
 	ion_dict_cursor_t **cursor
 ) {
+	b_free_reader(&((ion_bpp_cursor_t *) (*cursor))->reader);
 	(*cursor)->predicate->destroy(&(*cursor)->predicate);
 	free(((ion_bpp_cursor_t *) (*cursor))->cur_key);
 	free((*cursor));
@@ -557,6 +722,8 @@ bpptree_find(
 
 	ion_bpp_cursor_t *bCursor = (ion_bpp_cursor_t *) (*cursor);
 
+	b_init_reader(&bCursor->reader);
+	bCursor->version = bpptree->version;
 	bCursor->cur_key = malloc(key_size);
 
 	if (NULL == bCursor->cur_key) {
@@ -569,6 +736,7 @@ bpptree_find(
 
 	(*cursor)->destroy		= bpptree_destroy_cursor;
 	(*cursor)->next			= bpptree_next;
+	(*cursor)->next_batch	= bpptree_next_batch;
 
 	(*cursor)->predicate	= malloc(sizeof(ion_predicate_t));
 
@@ -598,7 +766,7 @@ bpptree_find(
 
 			memcpy(bCursor->cur_key, target_key, key_size);
 
-			ion_bpp_err_t err = b_get(bpptree->tree, target_key, &bCursor->offset);
+			ion_bpp_err_t err = b_get(bpptree->tree, &bCursor->reader, target_key, &bCursor->offset);
 
 			if (bErrOk != err) {
 				/* If this happens, that means the target key doesn't exist */
@@ -638,7 +806,7 @@ bpptree_find(
 			memcpy((*cursor)->predicate->statement.range.upper_bound, predicate->statement.range.upper_bound, key_size);
 
 			/* We search for the FGEQ of the Lower bound. */
-			b_find_first_greater_or_equal(bpptree->tree, (*cursor)->predicate->statement.range.lower_bound, bCursor->cur_key, &bCursor->offset);
+			b_find_first_greater_or_equal(bpptree->tree, &bCursor->reader, (*cursor)->predicate->statement.range.lower_bound, bCursor->cur_key, &bCursor->offset);
 
 			/* If the key returned doesn't satisfy the predicate, we can exit */
 			if (boolean_false == test_predicate(*cursor, bCursor->cur_key)) {
@@ -657,8 +825,7 @@ bpptree_find(
 			ion_bpp_err_t err;
 
 			/* We search for first key in B++ tree. */
-			err					= b_find_first_key(bpptree->tree, bCursor->cur_key, &bCursor->offset);
-
+			err					= b_find_first_key(bpptree->tree, &bCursor->reader, bCursor->cur_key, &bCursor->offset);
 			(*cursor)->status	= cs_cursor_initialized;
 
 			if (bErrOk != err) {
@@ -721,4 +888,9 @@ bpptree_init(
 	handler->destroy_dictionary = bpptree_destroy_dictionary;
 	handler->open_dictionary	= bpptree_open_dictionary;
 	handler->close_dictionary	= bpptree_close_dictionary;
+	handler->sync_dictionary	= bpptree_sync_dictionary;
+	handler->scan_extent		= NULL;
+	handler->scan_range			= NULL;
+	handler->get_many			= NULL;
+	handler->concurrent			= boolean_false;
 }
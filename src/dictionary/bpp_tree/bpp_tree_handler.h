@@ -51,12 +51,18 @@ typedef struct bplusplustree {
 	ion_dictionary_parent_t super;
 	ion_bpp_handle_t		tree;
 	ion_lfb_t				values;
+	ion_bpp_reader_t		reader;	/**< Used by writers, and by gets in builds that are not
+										 thread-safe. Cursors have readers of their own. */
+	unsigned int			version;/**< Counts writes, so that cursors know when the node
+										 they are on may have changed. */
 } ion_bpptree_t;
 
 typedef struct {
 	ion_dict_cursor_t	super;		/**< Supertype of cursor		*/
 	ion_key_t			cur_key;/**< Current key we're visiting */
 	ion_file_offset_t	offset;		/**< offset in LFB; holds value */
+	ion_bpp_reader_t	reader;		/**< Where the cursor is in the tree */
+	unsigned int		version;	/**< The version of the tree @p reader was placed in */
 } ion_bpp_cursor_t;
 
 /**
@@ -0,0 +1,888 @@
+/******************************************************************************/
+/**
+@file		concurrent_skip_list.c
+@author		IonDB Project
+@brief		Implementation of the lock-free skip list.
+@details	Follows the lock-free skip list of Herlihy and Shavit: the bottom
+			level is the list itself, and the levels above it are shortcuts
+			that may briefly lag behind it.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "concurrent_skip_list.h"
+
+#if ION_THREAD_SAFE
+#include <sched.h>
+#endif
+
+/**
+@brief		The node a next pointer points to, without its mark.
+*/
+#define csl_pointer(reference)		((ion_csl_node_t *) ((reference) & ~ION_CSL_MARK))
+
+/**
+@brief		Whether a next pointer belongs to a deleted node.
+*/
+#define csl_is_marked(reference)	(0 != ((reference) & ION_CSL_MARK))
+
+/**
+@brief		The value bytes held in a value block.
+*/
+#define csl_value_bytes(block)		((ion_value_t) ((block) + 1))
+
+/**
+@brief		Allocates a node and its next pointers, with every next pointer
+			cleared.
+@param[in]	skiplist
+				The skip list the node is for.
+@param[in]	height
+				Height index of the node.
+@param[in]	key
+				The key to copy into the node, or @c NULL for none.
+@return		The node, or @c NULL if out of memory.
+*/
+static ion_csl_node_t *
+csl_new_node(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_csl_level_t				height,
+	ion_key_t					key
+) {
+	ion_key_size_t	key_size	= skiplist->super.record.key_size;
+	size_t			next_size	= sizeof(uintptr_t) * (height + 1);
+	ion_csl_node_t	*node		= malloc(sizeof(ion_csl_node_t) + next_size + key_size);
+
+	if (NULL == node) {
+		return NULL;
+	}
+
+	node->block.retired = NULL;
+	node->block.is_node = boolean_true;
+	node->value			= NULL;
+	node->height		= height;
+	node->owners		= 2;
+	node->next			= (uintptr_t *) (node + 1);
+	node->key			= (ion_byte_t *) (node->next + height + 1);
+
+	memset(node->next, 0, next_size);
+
+	if (NULL != key) {
+		memcpy(node->key, key, key_size);
+	}
+
+	return node;
+}
+
+/**
+@brief		Allocates a value block holding a copy of @p value.
+@param[in]	skiplist
+				The skip list the value is for.
+@param[in]	value
+				The value to copy.
+@return		The block, or @c NULL if out of memory.
+*/
+static ion_csl_block_t *
+csl_new_value(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_value_t					value
+) {
+	ion_csl_block_t *block = malloc(sizeof(ion_csl_block_t) + skiplist->super.record.value_size);
+
+	if (NULL == block) {
+		return NULL;
+	}
+
+	block->retired	= NULL;
+	block->is_node	= boolean_false;
+	memcpy(csl_value_bytes(block), value, skiplist->super.record.value_size);
+
+	return block;
+}
+
+/**
+@brief		Frees a block, along with the value of a node.
+@param[in]	block
+				The block to free.
+*/
+static void
+csl_free_block(
+	ion_csl_block_t *block
+) {
+	if (block->is_node) {
+		free(((ion_csl_node_t *) block)->value);
+	}
+
+	free(block);
+}
+
+/**
+@brief		Frees a chain of retired blocks.
+@param[in]	block
+				The first block of the chain, or @c NULL.
+*/
+static void
+csl_free_retired(
+	ion_csl_block_t *block
+) {
+	ion_csl_block_t *next;
+
+	while (NULL != block) {
+		next = block->retired;
+		csl_free_block(block);
+		block = next;
+	}
+}
+
+/**
+@brief		Pushes a chain of blocks onto one of the retired lists.
+@param[in]	list
+				The retired list.
+@param[in]	first
+				The first block of the chain.
+@param[in]	last
+				The last block of the chain.
+*/
+static void
+csl_push_retired(
+	ion_csl_block_t **list,
+	ion_csl_block_t *first,
+	ion_csl_block_t *last
+) {
+	ion_csl_block_t *head;
+
+	do {
+		head			= ION_ATOMIC_LOAD(list);
+		last->retired	= head;
+	} while (!ION_ATOMIC_CAS(list, head, first));
+}
+
+/**
+@brief		Moves the skip list on to the next epoch if every guard has seen
+			the current one, and frees what was retired two epochs ago.
+@param[in]	skiplist
+				The skip list to advance.
+*/
+static void
+csl_try_advance(
+	ion_concurrent_skiplist_t *skiplist
+) {
+	ion_csl_epoch_t epoch = ION_ATOMIC_LOAD(&skiplist->epoch);
+	ion_csl_epoch_t next_epoch;
+	ion_csl_epoch_t guard_epoch;
+	ion_csl_block_t **list;
+	ion_csl_block_t *freed;
+	ion_csl_block_t *last;
+	int				i;
+
+	for (i = 0; i < ION_CSL_MAX_GUARDS; i++) {
+		guard_epoch = ION_ATOMIC_LOAD(&skiplist->guards[i].epoch);
+
+		if ((ION_CSL_IDLE != guard_epoch) && (epoch != guard_epoch)) {
+			return;
+		}
+	}
+
+	next_epoch = epoch + 1;
+
+	if (ION_CSL_IDLE == next_epoch) {
+		/* The largest epoch is a multiple of the number of lists, so skipping zero keeps them in turn. */
+		next_epoch++;
+	}
+
+	/* Every guard is in the current epoch, so nothing retired two epochs ago
+	   can still be reached. Those blocks sit in the list the next epoch
+	   retires into, which is emptied before moving on so that nothing
+	   retired in the next epoch is freed with them. */
+	list = &skiplist->retired[next_epoch % ION_CSL_EPOCHS];
+
+	do {
+		freed = ION_ATOMIC_LOAD(list);
+	} while (!ION_ATOMIC_CAS(list, freed, NULL));
+
+	if (ION_ATOMIC_CAS(&skiplist->epoch, epoch, next_epoch)) {
+		csl_free_retired(freed);
+	}
+	else if (NULL != freed) {
+		/* Another thread advanced first. Hand the blocks back to be freed later. */
+		for (last = freed; NULL != last->retired; last = last->retired) {}
+
+		csl_push_retired(list, freed, last);
+	}
+}
+
+/**
+@brief		Retires a block that can no longer be reached from the skip list,
+			to be freed once no guard can still be holding it.
+@param[in]	skiplist
+				The skip list the block was in.
+@param[in]	guard
+				The guard held by the caller.
+@param[in]	block
+				The block to retire.
+*/
+static void
+csl_retire(
+	ion_concurrent_skiplist_t	*skiplist,
+	int							guard,
+	ion_csl_block_t				*block
+) {
+	ion_csl_epoch_t epoch = ION_ATOMIC_LOAD(&skiplist->guards[guard].epoch);
+
+	csl_push_retired(&skiplist->retired[epoch % ION_CSL_EPOCHS], block, block);
+	csl_try_advance(skiplist);
+}
+
+/**
+@brief		Gives up the hold of the inserting or the deleting thread on a
+			node, retiring the node once both are done with it.
+@param[in]	skiplist
+				The skip list the node is in.
+@param[in]	guard
+				The guard held by the caller.
+@param[in]	node
+				The node to release.
+*/
+static void
+csl_release(
+	ion_concurrent_skiplist_t	*skiplist,
+	int							guard,
+	ion_csl_node_t				*node
+) {
+	if (1 == ION_ATOMIC_FETCH_ADD(&node->owners, -1)) {
+		csl_retire(skiplist, guard, &node->block);
+	}
+}
+
+/**
+@brief		Picks the height of a new node, using the generator of the guard
+			held by the caller.
+@param[in]	skiplist
+				The skip list the node is for.
+@param[in]	guard
+				The guard held by the caller.
+@return		The height index of the node.
+*/
+static ion_csl_level_t
+csl_gen_level(
+	ion_concurrent_skiplist_t	*skiplist,
+	int							guard
+) {
+	uint32_t		seed	= skiplist->guards[guard].seed;
+	ion_csl_level_t level	= 0;
+
+	while (level < skiplist->maxheight - 1) {
+		/* Xorshift, which needs no state beyond the seed. */
+		seed	^= seed << 13;
+		seed	^= seed >> 17;
+		seed	^= seed << 5;
+
+		if ((int) (seed % (uint32_t) skiplist->pden) >= skiplist->pnum) {
+			break;
+		}
+
+		level++;
+	}
+
+	skiplist->guards[guard].seed = seed;
+
+	return level;
+}
+
+/**
+@brief		Finds the nodes around where @p key belongs on every level,
+			unlinking deleted nodes on the way.
+@param[in]	skiplist
+				The skip list to search.
+@param[in]	key
+				The key to search for.
+@param[out]	preds
+				The last node before @p key on each level.
+@param[out]	succs
+				The first node at or after @p key on each level, or @c NULL.
+@return		Whether the bottom level holds @p key.
+*/
+static ion_boolean_t
+csl_find(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key,
+	ion_csl_node_t				**preds,
+	ion_csl_node_t				**succs
+) {
+	ion_key_size_t	key_size = skiplist->super.record.key_size;
+	ion_csl_node_t	*pred;
+	ion_csl_node_t	*curr;
+	uintptr_t		reference;
+	ion_csl_level_t h;
+	ion_boolean_t	retry;
+
+	do {
+		retry	= boolean_false;
+		pred	= skiplist->head;
+		curr	= NULL;
+
+		for (h = skiplist->maxheight - 1; (h >= 0) && !retry; h--) {
+			curr = csl_pointer(ION_ATOMIC_LOAD(&pred->next[h]));
+
+			while (NULL != curr) {
+				reference = ION_ATOMIC_LOAD(&curr->next[h]);
+
+				if (csl_is_marked(reference)) {
+					/* If the predecessor changed, start over from the top. */
+					if (!ION_ATOMIC_CAS(&pred->next[h], (uintptr_t) curr, reference & ~ION_CSL_MARK)) {
+						retry = boolean_true;
+						break;
+					}
+
+					curr = csl_pointer(reference);
+					continue;
+				}
+
+				if (skiplist->super.compare(curr->key, key, key_size) >= 0) {
+					break;
+				}
+
+				pred	= curr;
+				curr	= csl_pointer(reference);
+			}
+
+			preds[h]	= pred;
+			succs[h]	= curr;
+		}
+	} while (retry);
+
+	return (NULL != curr) && (0 == skiplist->super.compare(curr->key, key, key_size));
+}
+
+/**
+@brief		Links the levels of a new node above the bottom one.
+@details	Stops early if the node is deleted while this is going on.
+@param[in]	skiplist
+				The skip list the node is in.
+@param[in]	node
+				The node, already linked into the bottom level.
+@param[in]	preds
+				The predecessors found when the node was linked.
+@param[in]	succs
+				The successors found when the node was linked.
+*/
+static void
+csl_link_tower(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_csl_node_t				*node,
+	ion_csl_node_t				**preds,
+	ion_csl_node_t				**succs
+) {
+	uintptr_t		reference;
+	ion_csl_level_t h;
+
+	for (h = 1; h <= node->height; h++) {
+		while (boolean_true) {
+			reference = ION_ATOMIC_LOAD(&node->next[h]);
+
+			/* Only a delete changes the next pointers of a linked node besides this, by marking them. */
+			if (csl_is_marked(reference)) {
+				return;
+			}
+
+			if ((csl_pointer(reference) != succs[h]) && !ION_ATOMIC_CAS(&node->next[h], reference, (uintptr_t) succs[h])) {
+				return;
+			}
+
+			if (ION_ATOMIC_CAS(&preds[h]->next[h], (uintptr_t) succs[h], (uintptr_t) node)) {
+				break;
+			}
+
+			if (!csl_find(skiplist, node->key, preds, succs) || (succs[0] != node)) {
+				return;
+			}
+		}
+	}
+}
+
+/**
+@brief		Links a new record into a skip list.
+@param[in]	skiplist
+				The skip list to insert into.
+@param[in]	guard
+				The guard held by the caller.
+@param[in]	key
+				The key to insert.
+@param[in]	value
+				The value block of the record, which the node takes over on
+				success.
+@return		The status of the insertion, @c err_duplicate_key if the key is
+			already there.
+*/
+static ion_err_t
+csl_link(
+	ion_concurrent_skiplist_t	*skiplist,
+	int							guard,
+	ion_key_t					key,
+	ion_csl_block_t				*value
+) {
+	ion_csl_node_t	**preds = alloca(sizeof(ion_csl_node_t *) * skiplist->maxheight);
+	ion_csl_node_t	**succs = alloca(sizeof(ion_csl_node_t *) * skiplist->maxheight);
+	ion_csl_node_t	*node	= csl_new_node(skiplist, csl_gen_level(skiplist, guard), key);
+	ion_csl_level_t h;
+
+	if (NULL == node) {
+		return err_out_of_memory;
+	}
+
+	node->value = value;
+
+	while (boolean_true) {
+		if (csl_find(skiplist, key, preds, succs)) {
+			/* The node was never published, so it can be freed right away. */
+			free(node);
+			return err_duplicate_key;
+		}
+
+		for (h = 0; h <= node->height; h++) {
+			node->next[h] = (uintptr_t) succs[h];
+		}
+
+		/* Linking the bottom level is what inserts the record. */
+		if (ION_ATOMIC_CAS(&preds[0]->next[0], (uintptr_t) succs[0], (uintptr_t) node)) {
+			break;
+		}
+	}
+
+	csl_link_tower(skiplist, node, preds, succs);
+
+	/* A delete may have finished unlinking the node before a level above
+	   was linked, so unlink it again before letting go of it. */
+	if (csl_is_marked(ION_ATOMIC_LOAD(&node->next[0]))) {
+		csl_find(skiplist, key, preds, succs);
+	}
+
+	csl_release(skiplist, guard, node);
+
+	return err_ok;
+}
+
+/**
+@brief		Finds the first node not deleted at or after @p key without
+			changing the skip list.
+@param[in]	skiplist
+				The skip list to search.
+@param[in]	key
+				The key to search for.
+@return		The node found, or @c NULL if every key is smaller.
+*/
+static ion_csl_node_t *
+csl_search(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key
+) {
+	ion_key_size_t	key_size	= skiplist->super.record.key_size;
+	ion_csl_node_t	*pred		= skiplist->head;
+	ion_csl_node_t	*curr		= NULL;
+	uintptr_t		reference;
+	ion_csl_level_t h;
+
+	for (h = skiplist->maxheight - 1; h >= 0; h--) {
+		curr = csl_pointer(ION_ATOMIC_LOAD(&pred->next[h]));
+
+		while (NULL != curr) {
+			reference = ION_ATOMIC_LOAD(&curr->next[h]);
+
+			if (csl_is_marked(reference)) {
+				curr = csl_pointer(reference);
+				continue;
+			}
+
+			if (skiplist->super.compare(curr->key, key, key_size) >= 0) {
+				break;
+			}
+
+			pred	= curr;
+			curr	= csl_pointer(reference);
+		}
+	}
+
+	return curr;
+}
+
+ion_err_t
+csl_initialize(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_type_t				key_type,
+	ion_key_size_t				key_size,
+	ion_value_size_t			value_size,
+	int							maxheight,
+	int							pnum,
+	int							pden
+) {
+	int i;
+
+	if ((maxheight < 1) || (pnum < 0) || (pden < 1)) {
+		return err_invalid_initial_size;
+	}
+
+	skiplist->super.key_type			= key_type;
+	skiplist->super.record.key_size		= key_size;
+	skiplist->super.record.value_size	= value_size;
+	skiplist->maxheight					= maxheight;
+	skiplist->pnum						= pnum;
+	skiplist->pden						= pden;
+	skiplist->epoch						= ION_CSL_IDLE + 1;
+	skiplist->next_guard				= 0;
+
+	for (i = 0; i < ION_CSL_EPOCHS; i++) {
+		skiplist->retired[i] = NULL;
+	}
+
+	for (i = 0; i < ION_CSL_MAX_GUARDS; i++) {
+		skiplist->guards[i].epoch	= ION_CSL_IDLE;
+		skiplist->guards[i].lasting = boolean_false;
+		/* Any odd multiplier spreads the seeds out and never gives zero, which xorshift is stuck on. */
+		skiplist->guards[i].seed	= (uint32_t) (i + 1) * 2654435761u;
+	}
+
+	skiplist->head = csl_new_node(skiplist, maxheight - 1, NULL);
+
+	if (NULL == skiplist->head) {
+		return err_out_of_memory;
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+csl_destroy(
+	ion_concurrent_skiplist_t *skiplist
+) {
+	ion_csl_node_t	*node = skiplist->head;
+	ion_csl_node_t	*next;
+	int				i;
+
+	while (NULL != node) {
+		next = csl_pointer(node->next[0]);
+		csl_free_block(&node->block);
+		node = next;
+	}
+
+	for (i = 0; i < ION_CSL_EPOCHS; i++) {
+		csl_free_retired(skiplist->retired[i]);
+		skiplist->retired[i] = NULL;
+	}
+
+	skiplist->head = NULL;
+
+	return err_ok;
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Whether every guard of a skip list is held by a holder that did
+			not wait for it, so that waiting for one may never end.
+@param[in]	skiplist
+				The skip list whose guards to check.
+*/
+static ion_boolean_t
+csl_all_lasting(
+	ion_concurrent_skiplist_t *skiplist
+) {
+	int i;
+
+	for (i = 0; i < ION_CSL_MAX_GUARDS; i++) {
+		if ((ION_CSL_IDLE == ION_ATOMIC_LOAD(&skiplist->guards[i].epoch)) || !ION_ATOMIC_LOAD(&skiplist->guards[i].lasting)) {
+			return boolean_false;
+		}
+	}
+
+	return boolean_true;
+}
+
+#endif
+
+int
+csl_pin(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_boolean_t				wait
+) {
+	ion_csl_guard_t *guard;
+	ion_csl_epoch_t epoch;
+	ion_csl_epoch_t current;
+	unsigned int	start;
+	int				i;
+
+	while (boolean_true) {
+		/* Start each search somewhere else, so that threads spread out over the guards. */
+		start = ION_ATOMIC_FETCH_ADD(&skiplist->next_guard, 1);
+
+		for (i = 0; i < ION_CSL_MAX_GUARDS; i++) {
+			guard	= &skiplist->guards[(start + i) % ION_CSL_MAX_GUARDS];
+			epoch	= ION_ATOMIC_LOAD(&skiplist->epoch);
+
+			if (ION_ATOMIC_CAS(&guard->epoch, ION_CSL_IDLE, epoch)) {
+				/* The epoch may have moved on before the guard was taken. It
+				   must not lag behind once nodes are reached through it. */
+				while (epoch != (current = ION_ATOMIC_LOAD(&skiplist->epoch))) {
+					ION_ATOMIC_STORE(&guard->epoch, current);
+					epoch = current;
+				}
+
+				if (!wait) {
+					ION_ATOMIC_STORE(&guard->lasting, boolean_true);
+				}
+
+				return (int) ((start + i) % ION_CSL_MAX_GUARDS);
+			}
+		}
+
+#if ION_THREAD_SAFE
+
+		if (wait && !csl_all_lasting(skiplist)) {
+			sched_yield();
+			continue;
+		}
+
+#else
+		UNUSED(wait);
+#endif
+		return -1;
+	}
+}
+
+void
+csl_unpin(
+	ion_concurrent_skiplist_t	*skiplist,
+	int							guard
+) {
+	/* Cleared first, so that whoever takes the guard next is never seen as lasting by mistake. */
+	ION_ATOMIC_STORE(&skiplist->guards[guard].lasting, boolean_false);
+	ION_ATOMIC_STORE(&skiplist->guards[guard].epoch, ION_CSL_IDLE);
+}
+
+ion_status_t
+csl_insert(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key,
+	ion_value_t					value
+) {
+	ion_csl_block_t *block = csl_new_value(skiplist, value);
+	ion_err_t		error;
+	int				guard;
+
+	if (NULL == block) {
+		return ION_STATUS_ERROR(err_out_of_memory);
+	}
+
+	guard = csl_pin(skiplist, boolean_true);
+
+	if (-1 == guard) {
+		free(block);
+		return ION_STATUS_ERROR(err_max_capacity);
+	}
+
+	error = csl_link(skiplist, guard, key, block);
+	csl_unpin(skiplist, guard);
+
+	if (err_ok != error) {
+		free(block);
+		return ION_STATUS_ERROR(error);
+	}
+
+	return ION_STATUS_OK(1);
+}
+
+ion_status_t
+csl_get(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key,
+	ion_value_t					value
+) {
+	ion_status_t	status	= ION_STATUS_ERROR(err_item_not_found);
+	int				guard	= csl_pin(skiplist, boolean_true);
+	ion_csl_node_t	*node;
+
+	if (-1 == guard) {
+		return ION_STATUS_ERROR(err_max_capacity);
+	}
+
+	node = csl_search(skiplist, key);
+
+	if ((NULL != node) && (0 == skiplist->super.compare(node->key, key, skiplist->super.record.key_size))) {
+		memcpy(value, csl_value(node), skiplist->super.record.value_size);
+		status = ION_STATUS_OK(1);
+	}
+
+	csl_unpin(skiplist, guard);
+
+	return status;
+}
+
+ion_status_t
+csl_update(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key,
+	ion_value_t					value
+) {
+	ion_csl_block_t *block = csl_new_value(skiplist, value);
+	ion_csl_block_t *old;
+	ion_csl_node_t	*node;
+	ion_err_t		error;
+	int				guard;
+
+	if (NULL == block) {
+		return ION_STATUS_ERROR(err_out_of_memory);
+	}
+
+	guard = csl_pin(skiplist, boolean_true);
+
+	if (-1 == guard) {
+		free(block);
+		return ION_STATUS_ERROR(err_max_capacity);
+	}
+
+	while (boolean_true) {
+		node = csl_search(skiplist, key);
+
+		if ((NULL != node) && (0 == skiplist->super.compare(node->key, key, skiplist->super.record.key_size))) {
+			do {
+				old = ION_ATOMIC_LOAD(&node->value);
+			} while (!ION_ATOMIC_CAS(&node->value, old, block));
+
+			csl_retire(skiplist, guard, old);
+			error = err_ok;
+			break;
+		}
+
+		/* If the key is not there, insert it. Should another thread insert
+		   it first, update that record instead. */
+		error = csl_link(skiplist, guard, key, block);
+
+		if (err_duplicate_key != error) {
+			break;
+		}
+	}
+
+	csl_unpin(skiplist, guard);
+
+	if (err_ok != error) {
+		free(block);
+		return ION_STATUS_ERROR(error);
+	}
+
+	return ION_STATUS_OK(1);
+}
+
+ion_status_t
+csl_delete(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key
+) {
+	ion_csl_node_t	**preds = alloca(sizeof(ion_csl_node_t *) * skiplist->maxheight);
+	ion_csl_node_t	**succs = alloca(sizeof(ion_csl_node_t *) * skiplist->maxheight);
+	ion_status_t	status	= ION_STATUS_ERROR(err_item_not_found);
+	ion_csl_node_t	*victim;
+	uintptr_t		reference;
+	ion_csl_level_t h;
+	int				guard	= csl_pin(skiplist, boolean_true);
+
+	if (-1 == guard) {
+		return ION_STATUS_ERROR(err_max_capacity);
+	}
+
+	if (csl_find(skiplist, key, preds, succs)) {
+		victim = succs[0];
+
+		/* Mark the levels above the bottom first, so that nothing new is linked after the node. */
+		for (h = victim->height; h >= 1; h--) {
+			do {
+				reference = ION_ATOMIC_LOAD(&victim->next[h]);
+			} while (!csl_is_marked(reference) && !ION_ATOMIC_CAS(&victim->next[h], reference, reference | ION_CSL_MARK));
+		}
+
+		/* Whichever thread marks the bottom level deleted the record. */
+		do {
+			reference = ION_ATOMIC_LOAD(&victim->next[0]);
+		} while (!csl_is_marked(reference) && !ION_ATOMIC_CAS(&victim->next[0], reference, reference | ION_CSL_MARK));
+
+		if (!csl_is_marked(reference)) {
+			/* Unlinks the node from every level it is on. */
+			csl_find(skiplist, key, preds, succs);
+			csl_release(skiplist, guard, victim);
+			status = ION_STATUS_OK(1);
+		}
+	}
+
+	csl_unpin(skiplist, guard);
+
+	return status;
+}
+
+ion_csl_node_t *
+csl_seek(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key
+) {
+	if (NULL == key) {
+		return csl_skip_deleted(csl_next(skiplist->head));
+	}
+
+	return csl_search(skiplist, key);
+}
+
+ion_csl_node_t *
+csl_skip_deleted(
+	ion_csl_node_t *node
+) {
+	uintptr_t reference;
+
+	while (NULL != node) {
+		reference = ION_ATOMIC_LOAD(&node->next[0]);
+
+		if (!csl_is_marked(reference)) {
+			break;
+		}
+
+		node = csl_pointer(reference);
+	}
+
+	return node;
+}
+
+ion_csl_node_t *
+csl_next(
+	ion_csl_node_t *node
+) {
+	return csl_pointer(ION_ATOMIC_LOAD(&node->next[0]));
+}
+
+ion_value_t
+csl_value(
+	ion_csl_node_t *node
+) {
+	return csl_value_bytes(ION_ATOMIC_LOAD(&node->value));
+}
@@ -0,0 +1,247 @@
+/******************************************************************************/
+/**
+@file		concurrent_skip_list.h
+@author		IonDB Project
+@brief		Interface of the lock-free skip list.
+@details	Every operation may run at the same time as any other on the same
+			skip list, except @ref csl_initialize and @ref csl_destroy. Keys
+			are unique.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(CONCURRENT_SKIP_LIST_H_)
+#define CONCURRENT_SKIP_LIST_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "concurrent_skip_list_types.h"
+
+/**
+@brief		Initializes a lock-free skip list.
+@details	The comparison function in @p skiplist must be set before this is called.
+@param[in]	skiplist
+				The skip list to initialize.
+@param[in]	key_type
+				Key category to use for this instance.
+@param[in]	key_size
+				Key size, in bytes used for this instance.
+@param[in]	value_size
+				Value size, in bytes used for this instance.
+@param[in]	maxheight
+				Maximum number of levels the skip list will have.
+@param[in]	pnum
+				The numerator portion of the p value.
+@param[in]	pden
+				The denominator portion of the p value.
+@return		The status of initialization.
+*/
+ion_err_t
+csl_initialize(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_type_t				key_type,
+	ion_key_size_t				key_size,
+	ion_value_size_t			value_size,
+	int							maxheight,
+	int							pnum,
+	int							pden
+);
+
+/**
+@brief		Frees every node of a skip list, including the ones still waiting
+			to be reclaimed.
+@param[in]	skiplist
+				The skip list to destroy.
+@return		The status of destruction.
+*/
+ion_err_t
+csl_destroy(
+	ion_concurrent_skiplist_t *skiplist
+);
+
+/**
+@brief		Takes a guard, which keeps every node reachable from now on from
+			being freed until it is released.
+@param[in]	skiplist
+				The skip list to guard.
+@param[in]	wait
+				Whether to wait for a guard to be released when all of them are
+				held. Guards taken without waiting may be held indefinitely,
+				possibly by the caller, so this gives up once all of them are
+				held that way. Without threads, only the caller can be holding
+				them, so this never waits.
+@return		The guard taken, or -1 if none was free.
+*/
+int
+csl_pin(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_boolean_t				wait
+);
+
+/**
+@brief		Releases a guard taken by @ref csl_pin.
+@param[in]	skiplist
+				The skip list that was guarded.
+@param[in]	guard
+				The guard to release.
+*/
+void
+csl_unpin(
+	ion_concurrent_skiplist_t	*skiplist,
+	int							guard
+);
+
+/**
+@brief		Inserts a record into a skip list.
+@param[in]	skiplist
+				The skip list to insert into.
+@param[in]	key
+				The key to insert.
+@param[in]	value
+				The value to insert.
+@return		The status of the insertion, @c err_duplicate_key if the key is
+			already there.
+*/
+ion_status_t
+csl_insert(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key,
+	ion_value_t					value
+);
+
+/**
+@brief		Looks up the value of a key.
+@param[in]	skiplist
+				The skip list to search.
+@param[in]	key
+				The key to look for.
+@param[out]	value
+				Where the value is copied to.
+@return		The status of the lookup.
+*/
+ion_status_t
+csl_get(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key,
+	ion_value_t					value
+);
+
+/**
+@brief		Replaces the value of a key, inserting the key if it is not there.
+@details	The new value is swapped in whole, so readers see either the old
+			value or the new one.
+@param[in]	skiplist
+				The skip list to update.
+@param[in]	key
+				The key to update.
+@param[in]	value
+				The new value.
+@return		The status of the update.
+*/
+ion_status_t
+csl_update(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key,
+	ion_value_t					value
+);
+
+/**
+@brief		Deletes a key from a skip list.
+@param[in]	skiplist
+				The skip list to delete from.
+@param[in]	key
+				The key to delete.
+@return		The status of the deletion.
+*/
+ion_status_t
+csl_delete(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key
+);
+
+/**
+@brief		Finds the first node whose key is at least @p key.
+@details	The caller must hold a guard.
+@param[in]	skiplist
+				The skip list to search.
+@param[in]	key
+				The key to search for, or @c NULL for the first node.
+@return		The node found, or @c NULL if every key is smaller.
+*/
+ion_csl_node_t *
+csl_seek(
+	ion_concurrent_skiplist_t	*skiplist,
+	ion_key_t					key
+);
+
+/**
+@brief		Returns the first node from @p node onwards that has not been
+			deleted.
+@details	The caller must hold a guard since before it reached @p node.
+@param[in]	node
+				The node to start from, or @c NULL.
+@return		The node found, or @c NULL at the end of the skip list.
+*/
+ion_csl_node_t *
+csl_skip_deleted(
+	ion_csl_node_t *node
+);
+
+/**
+@brief		Returns the node after @p node on the bottom level, which may have
+			been deleted.
+@param[in]	node
+				The node to step from.
+@return		The next node, or @c NULL at the end of the skip list.
+*/
+ion_csl_node_t *
+csl_next(
+	ion_csl_node_t *node
+);
+
+/**
+@brief		Returns the current value of a node.
+@details	The caller must hold a guard since before it reached @p node.
+@param[in]	node
+				The node to read.
+@return		The value bytes.
+*/
+ion_value_t
+csl_value(
+	ion_csl_node_t *node
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONCURRENT_SKIP_LIST_H_ */
@@ -0,0 +1,416 @@
+/******************************************************************************/
+/**
+@file		concurrent_skip_list_handler.c
+@author		IonDB Project
+@brief		Handler liaison between the dictionary API and the lock-free skip list.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "concurrent_skip_list_handler.h"
+
+/**
+@brief		Ends a cursor, releasing its guard so that it no longer holds back
+			reclamation.
+@param[in]	cursor
+				The cursor to end.
+*/
+static void
+csldict_end_cursor(
+	ion_dict_cursor_t *cursor
+) {
+	ion_csldict_cursor_t *csl_cursor = (ion_csldict_cursor_t *) cursor;
+
+	cursor->status = cs_end_of_results;
+
+	if (-1 != csl_cursor->guard) {
+		csl_unpin((ion_concurrent_skiplist_t *) cursor->dictionary->instance, csl_cursor->guard);
+		csl_cursor->guard = -1;
+	}
+}
+
+/**
+@brief			Next function to query and retrieve the next <K,V> that stratifies the predicate
+				of the cursor.
+@details		This function should not be called directly, but instead will be bound to the cursor like a method.
+@param[in]		cursor
+					Which cursor to fetch results from.
+@param[out]		record
+					An initialized record struct with the @p key and @p value appropriately allocated to fit
+					the returned key and value. This function will write back data to the struct.
+@return			The resulting status of the operation.
+*/
+static ion_cursor_status_t
+csldict_next(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*record
+) {
+	ion_csldict_cursor_t	*csl_cursor = (ion_csldict_cursor_t *) cursor;
+	ion_csl_node_t			*node;
+
+	if ((cursor->status != cs_cursor_initialized) && (cursor->status != cs_cursor_active)) {
+		return cursor->status;
+	}
+
+	node = csl_skip_deleted(csl_cursor->current);
+
+	if ((NULL == node) || (boolean_false == test_predicate(cursor, node->key))) {
+		csldict_end_cursor(cursor);
+		return cursor->status;
+	}
+
+	memcpy(record->key, node->key, cursor->dictionary->instance->record.key_size);
+	memcpy(record->value, csl_value(node), cursor->dictionary->instance->record.value_size);
+
+	csl_cursor->current = csl_next(node);
+	cursor->status		= cs_cursor_active;
+	return cursor->status;
+}
+
+/**
+@brief		Retrieves up to @p max_records key/value pairs that satisfy the
+			predicate of the cursor.
+@details	Should be called through @ref dictionary_cursor_next_batch.
+@param[in]	cursor
+				The cursor used to iterate over results.
+@param[out]	records
+				An array of at least @p max_records records allocated by the
+				caller, which the cursor will fill with results.
+@param[in]	max_records
+				The maximum number of records to retrieve.
+@param[out]	num_records
+				Set to the number of records retrieved.
+@return		Status of cursor.
+*/
+static ion_cursor_status_t
+csldict_next_batch(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*records,
+	ion_result_count_t	max_records,
+	ion_result_count_t	*num_records
+) {
+	ion_csldict_cursor_t	*csl_cursor = (ion_csldict_cursor_t *) cursor;
+	ion_key_size_t			key_size	= cursor->dictionary->instance->record.key_size;
+	ion_value_size_t		value_size	= cursor->dictionary->instance->record.value_size;
+	ion_csl_node_t			*node;
+
+	*num_records = 0;
+
+	if ((cursor->status != cs_cursor_initialized) && (cursor->status != cs_cursor_active)) {
+		return cursor->status;
+	}
+
+	while (*num_records < max_records) {
+		node = csl_skip_deleted(csl_cursor->current);
+
+		if ((NULL == node) || (boolean_false == test_predicate(cursor, node->key))) {
+			csldict_end_cursor(cursor);
+			break;
+		}
+
+		memcpy(records[*num_records].key, node->key, key_size);
+		memcpy(records[*num_records].value, csl_value(node), value_size);
+		(*num_records)++;
+
+		csl_cursor->current = csl_next(node);
+		cursor->status		= cs_cursor_active;
+	}
+
+	return 0 < *num_records ? cs_cursor_active : cursor->status;
+}
+
+/**
+@brief		Destroys the cursor, along with its copy of the predicate.
+@param[in]	cursor
+				Which cursor to destroy.
+*/
+static void
+csldict_destroy_cursor(
+	ion_dict_cursor_t **cursor
+) {
+	ion_csldict_cursor_t *csl_cursor = (ion_csldict_cursor_t *) (*cursor);
+
+	if (-1 != csl_cursor->guard) {
+		csl_unpin((ion_concurrent_skiplist_t *) (*cursor)->dictionary->instance, csl_cursor->guard);
+	}
+
+	(*cursor)->predicate->destroy(&(*cursor)->predicate);
+	free(*cursor);
+	*cursor = NULL;
+}
+
+ion_err_t
+csldict_find(
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	ion_dict_cursor_t	**cursor
+) {
+	ion_concurrent_skiplist_t	*skiplist	= (ion_concurrent_skiplist_t *) dictionary->instance;
+	ion_key_size_t				key_size	= dictionary->instance->record.key_size;
+	ion_key_t					lower_bound = NULL;
+
+	*cursor = malloc(sizeof(ion_csldict_cursor_t));
+
+	if (NULL == *cursor) {
+		return err_out_of_memory;
+	}
+
+	ion_csldict_cursor_t *csl_cursor = (ion_csldict_cursor_t *) (*cursor);
+
+	(*cursor)->dictionary	= dictionary;
+	(*cursor)->status		= cs_cursor_uninitialized;
+
+	(*cursor)->destroy		= csldict_destroy_cursor;
+	(*cursor)->next			= csldict_next;
+	(*cursor)->next_batch	= csldict_next_batch;
+
+	csl_cursor->current		= NULL;
+	csl_cursor->guard		= -1;
+
+	(*cursor)->predicate	= malloc(sizeof(ion_predicate_t));
+
+	if (NULL == (*cursor)->predicate) {
+		free(*cursor);
+		return err_out_of_memory;
+	}
+
+	(*cursor)->predicate->type		= predicate->type;
+	(*cursor)->predicate->destroy	= predicate->destroy;
+
+	switch (predicate->type) {
+		case predicate_equality: {
+			(*cursor)->predicate->statement.equality.equality_value = malloc(key_size);
+
+			if (NULL == (*cursor)->predicate->statement.equality.equality_value) {
+				free((*cursor)->predicate);
+				free(*cursor);
+				return err_out_of_memory;
+			}
+
+			memcpy((*cursor)->predicate->statement.equality.equality_value, predicate->statement.equality.equality_value, key_size);
+			lower_bound = (*cursor)->predicate->statement.equality.equality_value;
+			break;
+		}
+
+		case predicate_range: {
+			(*cursor)->predicate->statement.range.lower_bound = malloc(key_size);
+
+			if (NULL == (*cursor)->predicate->statement.range.lower_bound) {
+				free((*cursor)->predicate);
+				free(*cursor);
+				return err_out_of_memory;
+			}
+
+			memcpy((*cursor)->predicate->statement.range.lower_bound, predicate->statement.range.lower_bound, key_size);
+
+			(*cursor)->predicate->statement.range.upper_bound = malloc(key_size);
+
+			if (NULL == (*cursor)->predicate->statement.range.upper_bound) {
+				free((*cursor)->predicate->statement.range.lower_bound);
+				free((*cursor)->predicate);
+				free(*cursor);
+				return err_out_of_memory;
+			}
+
+			memcpy((*cursor)->predicate->statement.range.upper_bound, predicate->statement.range.upper_bound, key_size);
+			lower_bound = (*cursor)->predicate->statement.range.lower_bound;
+			break;
+		}
+
+		case predicate_all_records: {
+			break;
+		}
+
+		case predicate_predicate: {
+			return err_ok;
+		}
+
+		default: {
+			free((*cursor)->predicate);
+			free(*cursor);
+			*cursor = NULL;
+			return err_invalid_predicate;
+		}
+	}
+
+	csl_cursor->guard = csl_pin(skiplist, boolean_false);
+
+	if (-1 == csl_cursor->guard) {
+		(*cursor)->predicate->destroy(&(*cursor)->predicate);
+		free(*cursor);
+		*cursor = NULL;
+		return err_max_capacity;
+	}
+
+	csl_cursor->current = csl_seek(skiplist, lower_bound);
+
+	if (NULL == csl_cursor->current) {
+		csldict_end_cursor(*cursor);
+	}
+	else {
+		(*cursor)->status = cs_cursor_initialized;
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+csldict_open_dictionary(
+	ion_dictionary_handler_t		*handler,
+	ion_dictionary_t				*dictionary,
+	ion_dictionary_config_info_t	*config,
+	ion_dictionary_compare_t		compare
+) {
+	UNUSED(handler);
+	UNUSED(dictionary);
+	UNUSED(config);
+	UNUSED(compare);
+	return err_not_implemented;
+}
+
+ion_err_t
+csldict_close_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	UNUSED(dictionary);
+	return err_not_implemented;
+}
+
+void
+csldict_init(
+	ion_dictionary_handler_t *handler
+) {
+	handler->insert				= csldict_insert;
+	handler->create_dictionary	= csldict_create_dictionary;
+	handler->get				= csldict_get;
+	handler->update				= csldict_update;
+	handler->find				= csldict_find;
+	handler->remove				= csldict_delete;
+	handler->delete_dictionary	= csldict_delete_dictionary;
+	handler->destroy_dictionary = csldict_destroy_dictionary;
+	handler->open_dictionary	= csldict_open_dictionary;
+	handler->close_dictionary	= csldict_close_dictionary;
+	handler->sync_dictionary	= NULL;	/* Records live in memory until the dictionary is closed. */
+	handler->scan_extent		= NULL;
+	handler->scan_range			= NULL;
+	handler->get_many			= NULL;
+	handler->concurrent			= boolean_true;
+}
+
+ion_status_t
+csldict_insert(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	return csl_insert((ion_concurrent_skiplist_t *) dictionary->instance, key, value);
+}
+
+ion_status_t
+csldict_get(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	return csl_get((ion_concurrent_skiplist_t *) dictionary->instance, key, value);
+}
+
+ion_err_t
+csldict_create_dictionary(
+	ion_dictionary_id_t			id,
+	ion_key_type_t				key_type,
+	ion_key_size_t				key_size,
+	ion_value_size_t			value_size,
+	ion_dictionary_size_t		dictionary_size,
+	ion_dictionary_compare_t	compare,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_t			*dictionary
+) {
+	UNUSED(id);
+
+	dictionary->instance = malloc(sizeof(ion_concurrent_skiplist_t));
+
+	if (NULL == dictionary->instance) {
+		return err_out_of_memory;
+	}
+
+	dictionary->instance->compare	= compare;
+	dictionary->instance->type		= dictionary_type_concurrent_skip_list_t;
+
+	ion_err_t result = csl_initialize((ion_concurrent_skiplist_t *) dictionary->instance, key_type, key_size, value_size, dictionary_size, 1, 4);
+
+	if (err_ok != result) {
+		free(dictionary->instance);
+		dictionary->instance = NULL;
+		return result;
+	}
+
+	if (NULL != handler) {
+		dictionary->handler = handler;
+	}
+
+	return err_ok;
+}
+
+ion_status_t
+csldict_delete(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key
+) {
+	return csl_delete((ion_concurrent_skiplist_t *) dictionary->instance, key);
+}
+
+ion_err_t
+csldict_delete_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	ion_err_t result = csl_destroy((ion_concurrent_skiplist_t *) dictionary->instance);
+
+	free(dictionary->instance);
+	dictionary->instance = NULL;
+	return result;
+}
+
+ion_err_t
+csldict_destroy_dictionary(
+	ion_dictionary_id_t id
+) {
+	UNUSED(id);
+	return err_not_implemented;
+}
+
+ion_status_t
+csldict_update(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	return csl_update((ion_concurrent_skiplist_t *) dictionary->instance, key, value);
+}
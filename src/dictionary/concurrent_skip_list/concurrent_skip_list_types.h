@@ -0,0 +1,187 @@
+/******************************************************************************/
+/**
+@file		concurrent_skip_list_types.h
+@author		IonDB Project
+@brief		Types local to the lock-free skip list.
+@details	Nodes are linked with compare-and-swap, one level at a time from
+			the bottom up. A delete first marks every next pointer of a node,
+			which is the logical delete, then unlinks it: the thread that
+			marks the bottom level owns the delete. Marks are kept in the low
+			bit of each next pointer.
+
+			Memory is reclaimed by epoch. Every operation holds one of
+			@ref ION_CSL_MAX_GUARDS guards for as long as it may touch nodes,
+			and the guard records the epoch it started in. Unlinked nodes and
+			replaced values are retired into the list of the current epoch,
+			and only freed once every guard has moved two epochs past it.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(CONCURRENT_SKIP_LIST_TYPES_H_)
+#define CONCURRENT_SKIP_LIST_TYPES_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "../dictionary_types.h"
+#include "../dictionary.h"
+
+#include "../../key_value/kv_system.h"
+
+#if !defined(ION_CSL_MAX_GUARDS)
+/**
+@brief		How many operations and cursors can run on one skip list at once.
+			Further operations wait for a guard to be released, unless
+			cursors hold every guard, and further cursors are refused.
+*/
+#define ION_CSL_MAX_GUARDS	64
+#endif
+
+/**
+@brief		The epoch of a guard that is not held.
+*/
+#define ION_CSL_IDLE		0
+
+/**
+@brief		How many lists of retired blocks are kept: the current epoch, the
+			previous one, and the one being freed.
+*/
+#define ION_CSL_EPOCHS		3
+
+/**
+@brief		Set in the next pointers of a node once it has been deleted.
+*/
+#define ION_CSL_MARK		((uintptr_t) 1)
+
+/**
+@brief		Height of a lock-free skip list node, counting from 0.
+*/
+typedef int ion_csl_level_t;
+
+/**
+@brief		An epoch of a lock-free skip list.
+*/
+typedef unsigned long ion_csl_epoch_t;
+
+/**
+@brief		The header of every block of memory that is freed through the
+			epochs: nodes and values.
+*/
+typedef struct csl_block {
+	/**> The next block retired in the same epoch. */
+	struct csl_block	*retired;
+	/**> Whether the block is a node, whose value has to be freed with it. */
+	ion_boolean_t		is_node;
+} ion_csl_block_t;
+
+/**
+@brief		A node of a lock-free skip list.
+@details	A node is allocated as one block: the node, its next pointers,
+			then its key.
+*/
+typedef struct {
+	/**> Header used to retire the node. */
+	ion_csl_block_t		block;
+	/**> The value, a block followed by the value bytes. Replaced as a whole
+		 on update. */
+	ion_csl_block_t		*value;
+	/**> Height index of the node, counting from 0. */
+	ion_csl_level_t		height;
+	/**> How many of the inserting and the deleting thread have not yet
+		 finished with the node. Whichever finishes last retires it. */
+	int					owners;
+	/**> Next node at each level, with @ref ION_CSL_MARK set once the node
+		 has been deleted. */
+	uintptr_t			*next;
+	/**> The key of the node. */
+	ion_key_t			key;
+} ion_csl_node_t;
+
+/**
+@brief		One of the guards that operations on a skip list hold.
+*/
+typedef struct {
+	/**> The epoch the holder started in, or @ref ION_CSL_IDLE. */
+	ion_csl_epoch_t epoch;
+	/**> State of the level generator of the holder. Each guard is only held
+		 by one thread at a time, so inserts never share a generator. */
+	uint32_t		seed;
+	/**> Whether the holder took the guard without waiting, as cursors do,
+		 and so may keep it for as long as it likes. */
+	ion_boolean_t	lasting;
+} ion_csl_guard_t;
+
+/**
+@brief		Struct of the lock-free skip list, holds metadata and the entry point
+			into the skip list.
+*/
+typedef struct {
+	/**> Parent structure holding dictionary level information. */
+	ion_dictionary_parent_t super;
+	/**> Entry point into the skip list. Holds no key or value. */
+	ion_csl_node_t			*head;
+	/**> Maximum height of the skip list in terms of the number of nodes. */
+	ion_csl_level_t			maxheight;
+	/**> Probability numerator, used in height generation. */
+	int						pnum;
+	/**> Probability denominator, used in height generation. */
+	int						pden;
+	/**> The current epoch, never @ref ION_CSL_IDLE. */
+	ion_csl_epoch_t			epoch;
+	/**> Where the next search for a free guard starts. */
+	unsigned int			next_guard;
+	/**> Blocks retired in each epoch, indexed by the epoch modulo
+		 @ref ION_CSL_EPOCHS. */
+	ion_csl_block_t			*retired[ION_CSL_EPOCHS];
+	/**> The guards. */
+	ion_csl_guard_t			guards[ION_CSL_MAX_GUARDS];
+} ion_concurrent_skiplist_t;
+
+/**
+@brief		Implementation cursor type for the lock-free skip list.
+@details	A cursor holds a guard until it reaches the end of its results or is
+			destroyed, so the node it is on is never freed under it.
+*/
+typedef struct {
+	/**> Supertype of the dictionary cursor. */
+	ion_dict_cursor_t	super;
+	/**> The node the cursor visits next. */
+	ion_csl_node_t		*current;
+	/**> The guard the cursor holds, or -1 once it has released it. */
+	int					guard;
+} ion_csldict_cursor_t;
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONCURRENT_SKIP_LIST_TYPES_H_ */
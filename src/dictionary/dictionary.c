@@ -35,6 +35,9 @@
 /******************************************************************************/
 
 #include "dictionary.h"
+#include "dictionary_bloom_filter.h"
+#include "dictionary_stats.h"
+#include "dictionary_wal.h"
 #include "flat_file/flat_file_dictionary_handler.h"
 
 int
@@ -121,6 +124,225 @@ dictionary_switch_compare(
 	return compare;
 }
 
+#if ION_THREAD_SAFE
+
+/**
+@brief		Key of the cursors the calling thread holds, linked through
+			@ref ion_dict_cursor_t.next_held.
+*/
+static pthread_key_t	dictionary_held_cursors;
+static pthread_once_t	dictionary_held_cursors_once = PTHREAD_ONCE_INIT;
+
+/**
+@brief		Creates @ref dictionary_held_cursors, once per process.
+*/
+static void
+dictionary_held_cursors_create(
+	void
+) {
+	pthread_key_create(&dictionary_held_cursors, NULL);
+}
+
+/**
+@brief		Returns the first cursor the calling thread holds, or @p NULL.
+*/
+static ion_dict_cursor_t *
+dictionary_held_cursors_first(
+	void
+) {
+	pthread_once(&dictionary_held_cursors_once, dictionary_held_cursors_create);
+	return pthread_getspecific(dictionary_held_cursors);
+}
+
+/**
+@brief		Whether the calling thread holds a cursor on a dictionary.
+@param		dictionary
+				The dictionary to look for.
+*/
+static ion_boolean_t
+dictionary_thread_holds_cursor_on(
+	ion_dictionary_t *dictionary
+) {
+	ion_dict_cursor_t *cursor;
+
+	for (cursor = dictionary_held_cursors_first(); NULL != cursor; cursor = cursor->next_held) {
+		if (cursor->dictionary == dictionary) {
+			return boolean_true;
+		}
+	}
+
+	return boolean_false;
+}
+
+ion_boolean_t
+dictionary_thread_holds_logged_cursor(
+	ion_wal_t *wal
+) {
+	ion_dict_cursor_t *cursor;
+
+	for (cursor = dictionary_held_cursors_first(); NULL != cursor; cursor = cursor->next_held) {
+		if (cursor->dictionary->wal == wal) {
+			return boolean_true;
+		}
+	}
+
+	return boolean_false;
+}
+
+/**
+@brief		Takes a dictionary for a write.
+@details	The log of the dictionary, if it has one, is taken first. Every
+			writer of a dictionary sharing the log then holds it, which lets
+			a checkpoint lock each dictionary it syncs without deadlocking
+			against them.
+
+			The dictionary is taken exclusively, unless its handler is
+			concurrent and no bloom filter, which writers update, is enabled.
+
+			A cursor the calling thread holds keeps its dictionary shared,
+			so the write is refused rather than waiting forever when it
+			would take the dictionary exclusively, or when the thread holds
+			a cursor on any dictionary attached to the same log, which a
+			checkpoint run by a writer holding the log waits on.
+@param		dictionary
+				The dictionary about to be written to.
+@returns	@ref err_would_deadlock if the write was refused, otherwise
+			@ref err_ok and the dictionary is held.
+*/
+static ion_err_t
+dictionary_lock_write(
+	ion_dictionary_t *dictionary
+) {
+	ion_boolean_t exclusive = !dictionary->handler->concurrent || (NULL != dictionary->bloom_filter);
+
+	if ((exclusive && dictionary_thread_holds_cursor_on(dictionary)) || ((NULL != dictionary->wal) && dictionary_thread_holds_logged_cursor(dictionary->wal))) {
+		return err_would_deadlock;
+	}
+
+	if (NULL != dictionary->wal) {
+		ION_MUTEX_LOCK(dictionary->wal->lock);
+	}
+
+	if (exclusive) {
+		ION_RWLOCK_WRITE(dictionary->lock);
+	}
+	else {
+		ION_RWLOCK_READ(dictionary->lock);
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Releases a dictionary taken by @ref dictionary_lock_write.
+@param		dictionary
+				The dictionary that was written to.
+*/
+static void
+dictionary_unlock_write(
+	ion_dictionary_t *dictionary
+) {
+	ION_RWLOCK_UNLOCK(dictionary->lock);
+
+	if (NULL != dictionary->wal) {
+		ION_MUTEX_UNLOCK(dictionary->wal->lock);
+	}
+}
+
+#else /* Clause ION_THREAD_SAFE */
+
+#define dictionary_lock_write(dictionary)	err_ok
+#define dictionary_unlock_write(dictionary)
+
+#endif /* Clause ION_THREAD_SAFE */
+#if ION_THREAD_SAFE || ION_DICTIONARY_STATS
+
+/**
+@brief		Destroys a cursor, then releases the shared hold that
+			@ref dictionary_find took on its dictionary and the cursor's
+			reference to its statistics.
+@param		cursor
+				The cursor to destroy.
+*/
+static void
+dictionary_destroy_cursor(
+	ion_dict_cursor_t **cursor
+) {
+	ion_dictionary_t *dictionary = (*cursor)->dictionary;
+
+#if ION_DICTIONARY_STATS
+	ion_dictionary_stats_t *stats = (*cursor)->stats;
+#endif
+#if ION_THREAD_SAFE
+	ion_dict_cursor_t	*held = dictionary_held_cursors_first();
+	ion_dict_cursor_t	**link;
+
+	if (held == *cursor) {
+		pthread_setspecific(dictionary_held_cursors, held->next_held);
+	}
+	else {
+		link = &held->next_held;
+
+		while (*link != *cursor) {
+			link = &(*link)->next_held;
+		}
+
+		*link = (*cursor)->next_held;
+	}
+
+#endif
+	(*cursor)->impl_destroy(cursor);
+#if ION_DICTIONARY_STATS
+
+	if (NULL != stats) {
+		dictionary_stats_release(stats);
+	}
+
+#endif
+	ION_RWLOCK_UNLOCK(dictionary->lock);
+	UNUSED(dictionary);
+}
+
+#endif
+
+/**
+@brief		Logs a write that the handler has just made, if it succeeded.
+@details	A write the handler refused is never logged, so recovery
+			cannot replay it. Either way a write is only durable once the
+			commit covering its record returns.
+@param		dictionary
+				The dictionary written to.
+@param		type
+				The kind of write.
+@param		key
+				The key written.
+@param		value
+				The value written, or @c NULL for a delete.
+@param		status
+				What the handler returned. Its error is set if the write
+				could not be logged.
+*/
+static void
+dictionary_log_write(
+	ion_dictionary_t		*dictionary,
+	ion_wal_record_type_t	type,
+	ion_key_t				key,
+	ion_value_t				value,
+	ion_status_t			*status
+) {
+	ion_err_t error;
+
+	if (err_ok != status->error) {
+		return;
+	}
+
+	error = dictionary_wal_log(dictionary, type, key, value);
+
+	if (err_ok != error) {
+		status->error = error;
+	}
+}
+
 ion_err_t
 dictionary_create(
 	ion_dictionary_handler_t	*handler,
@@ -134,11 +356,18 @@ dictionary_create(
 	ion_err_t					err;
 	ion_dictionary_compare_t	compare = dictionary_switch_compare(key_type);
 
+	dictionary->bloom_filter = NULL;
+#if ION_DICTIONARY_STATS
+	dictionary->stats = NULL;
+#endif
+	dictionary->wal = NULL;
+
 	err = handler->create_dictionary(id, key_type, key_size, value_size, dictionary_size, compare, handler, dictionary);
 
 	if (err_ok == err) {
 		dictionary->instance->id	= id;
 		dictionary->status			= ion_dictionary_status_ok;
+		ION_RWLOCK_INIT(dictionary->lock);
 	}
 	else {
 		dictionary->status = ion_dictionary_status_error;
@@ -147,13 +376,218 @@ dictionary_create(
 	return err;
 }
 
+/**
+@brief		Adds a key that is about to be written to the Bloom filter of a
+			dictionary, if it has one.
+@details	The persisted filter is marked stale before the dictionary is
+			modified, so that it is rebuilt if the dictionary is not closed
+			cleanly.
+@param		dictionary
+				The dictionary being written to.
+@param		key
+				The key being written.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+dictionary_bloom_filter_track(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key
+) {
+	ion_err_t error;
+
+	if (NULL == dictionary->bloom_filter) {
+		return err_ok;
+	}
+
+	error = bloom_filter_mark_stale(dictionary->bloom_filter);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	bloom_filter_add(dictionary->bloom_filter, key);
+
+	return err_ok;
+}
+
+/**
+@brief		Adds a key found by the scan rebuilding a Bloom filter.
+@param		record
+				The record found.
+@param		worker
+				Unused, the scan has a single worker.
+@param		context
+				The filter being rebuilt.
+@returns	@c boolean_true, to scan on.
+*/
+static ion_boolean_t
+dictionary_bloom_filter_rebuild_add(
+	ion_record_t	*record,
+	int				worker,
+	void			*context
+) {
+	UNUSED(worker);
+	bloom_filter_add((ion_bloom_filter_t *) context, record->key);
+
+	return boolean_true;
+}
+
+/**
+@brief		Repopulates the Bloom filter of a dictionary from its contents,
+			and persists it.
+@details	Dictionaries without cursors are read through a parallel scan.
+			If neither is supported the filter is left unpersisted, so that
+			it is never taken for a complete one.
+@param		dictionary
+				The dictionary whose filter is rebuilt.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+dictionary_bloom_filter_rebuild(
+	ion_dictionary_t *dictionary
+) {
+	ion_predicate_t		predicate;
+	ion_dict_cursor_t	*cursor = NULL;
+	ion_record_t		record;
+	ion_cursor_status_t cursor_status;
+	ion_err_t			error;
+
+	bloom_filter_clear(dictionary->bloom_filter);
+	dictionary_build_predicate(&predicate, predicate_all_records);
+
+	if (NULL == dictionary->handler->find) {
+		/* A single worker, as the filter is not synchronized. */
+		error = dictionary_parallel_scan(dictionary, &predicate, 1, dictionary_bloom_filter_rebuild_add, dictionary->bloom_filter);
+
+		if (err_ok != error) {
+			return error;
+		}
+	}
+	else {
+		error = dictionary_find(dictionary, &predicate, &cursor);
+
+		if (err_ok != error) {
+			return error;
+		}
+
+		record.key		= alloca(dictionary->instance->record.key_size);
+		record.value	= alloca(dictionary->instance->record.value_size);
+
+		while (cs_cursor_active == (cursor_status = cursor->next(cursor, &record)) || cs_cursor_initialized == cursor_status) {
+			bloom_filter_add(dictionary->bloom_filter, record.key);
+		}
+
+		cursor->destroy(&cursor);
+
+		if ((cs_end_of_results != cursor_status) && (cs_cursor_uninitialized != cursor_status)) {
+			return err_uninitialized;
+		}
+	}
+
+	return bloom_filter_persist(dictionary->bloom_filter);
+}
+
+/**
+@brief		Attaches the persisted Bloom filter of a dictionary, if one
+			exists, rebuilding it if it is stale.
+@param		dictionary
+				The freshly opened dictionary.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+dictionary_bloom_filter_load(
+	ion_dictionary_t *dictionary
+) {
+	ion_err_t error = bloom_filter_open(&dictionary->bloom_filter, dictionary->instance->id, dictionary->instance->key_type, dictionary->instance->record.key_size);
+
+	if (err_file_open_error == error) {
+		/* No filter has been enabled for this dictionary. */
+		return err_ok;
+	}
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	if (ION_BLOOM_FILTER_STATE_STALE == dictionary->bloom_filter->state) {
+		error = dictionary_bloom_filter_rebuild(dictionary);
+
+		if (err_ok != error) {
+			bloom_filter_free(&dictionary->bloom_filter);
+			return error;
+		}
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+dictionary_enable_bloom_filter(
+	ion_dictionary_t		*dictionary,
+	ion_bloom_filter_size_t num_bits,
+	ion_byte_t				num_hashes
+) {
+	ion_err_t error;
+
+	if (NULL != dictionary->bloom_filter) {
+		bloom_filter_free(&dictionary->bloom_filter);
+	}
+
+	error = bloom_filter_create(&dictionary->bloom_filter, dictionary->instance->id, dictionary->instance->key_type, dictionary->instance->record.key_size, num_bits, num_hashes);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = dictionary_bloom_filter_rebuild(dictionary);
+
+	if (err_ok != error) {
+		bloom_filter_free(&dictionary->bloom_filter);
+		bloom_filter_destroy(dictionary->instance->id);
+	}
+
+	return error;
+}
+
+ion_err_t
+dictionary_disable_bloom_filter(
+	ion_dictionary_t *dictionary
+) {
+	bloom_filter_free(&dictionary->bloom_filter);
+
+	return bloom_filter_destroy(dictionary->instance->id);
+}
+
 ion_status_t
 dictionary_insert(
 	ion_dictionary_t	*dictionary,
 	ion_key_t			key,
 	ion_value_t			value
 ) {
-	return dictionary->handler->insert(dictionary, key, value);
+	ION_STATS_BEGIN(dictionary);
+
+	ion_status_t	status	= ION_STATUS_INITIALIZE;
+	ion_err_t		error	= dictionary_lock_write(dictionary);
+
+	if (err_ok != error) {
+		status.error = error;
+		ION_STATS_END(dictionary, ion_stats_insert);
+		return status;
+	}
+
+	error = dictionary_bloom_filter_track(dictionary, key);
+
+	if (err_ok != error) {
+		status.error = error;
+	}
+	else {
+		status = dictionary->handler->insert(dictionary, key, value);
+		dictionary_log_write(dictionary, ion_wal_record_insert, key, value, &status);
+	}
+
+	dictionary_unlock_write(dictionary);
+	ION_STATS_END(dictionary, ion_stats_insert);
+	return status;
 }
 
 ion_status_t
@@ -162,7 +596,67 @@ dictionary_get(
 	ion_key_t			key,
 	ion_value_t			value
 ) {
-	return dictionary->handler->get(dictionary, key, value);
+	ION_STATS_BEGIN(dictionary);
+	ION_RWLOCK_READ(dictionary->lock);
+
+	ion_status_t status = ION_STATUS_ERROR(err_item_not_found);
+
+	if ((NULL == dictionary->bloom_filter) || bloom_filter_might_contain(dictionary->bloom_filter, key)) {
+		status = dictionary->handler->get(dictionary, key, value);
+	}
+
+	ION_RWLOCK_UNLOCK(dictionary->lock);
+	ION_STATS_END(dictionary, ion_stats_get);
+	return status;
+}
+
+ion_status_t
+dictionary_get_many(
+	ion_dictionary_t	*dictionary,
+	unsigned int		num_keys,
+	ion_key_t			*keys,
+	ion_value_t			*values,
+	ion_status_t		*statuses
+) {
+	ION_STATS_BEGIN(dictionary);
+	ION_RWLOCK_READ(dictionary->lock);
+
+	ion_status_t	status = ION_STATUS_OK(0);
+	unsigned int	i;
+
+	/* Keys the filter rules out already have their answer. */
+	for (i = 0; i < num_keys; i++) {
+		if ((NULL == dictionary->bloom_filter) || bloom_filter_might_contain(dictionary->bloom_filter, keys[i])) {
+			statuses[i] = ION_STATUS_INITIALIZE;
+		}
+		else {
+			statuses[i] = ION_STATUS_ERROR(err_item_not_found);
+		}
+	}
+
+	if (NULL != dictionary->handler->get_many) {
+		status.error = dictionary->handler->get_many(dictionary, num_keys, keys, values, statuses);
+	}
+	else {
+		for (i = 0; i < num_keys; i++) {
+			if (err_uninitialized == statuses[i].error) {
+				statuses[i] = dictionary->handler->get(dictionary, keys[i], values[i]);
+			}
+		}
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		if (err_ok == statuses[i].error) {
+			status.count++;
+		}
+		else if ((err_item_not_found != statuses[i].error) && (err_ok == status.error)) {
+			status.error = statuses[i].error;
+		}
+	}
+
+	ION_RWLOCK_UNLOCK(dictionary->lock);
+	ION_STATS_END(dictionary, ion_stats_get);
+	return status;
 }
 
 ion_status_t
@@ -171,14 +665,67 @@ dictionary_update(
 	ion_key_t			key,
 	ion_value_t			value
 ) {
-	return dictionary->handler->update(dictionary, key, value);
+	ION_STATS_BEGIN(dictionary);
+
+	ion_status_t	status	= ION_STATUS_INITIALIZE;
+	ion_err_t		error	= dictionary_lock_write(dictionary);
+
+	if (err_ok != error) {
+		status.error = error;
+		ION_STATS_END(dictionary, ion_stats_update);
+		return status;
+	}
+
+	/* Updates upsert, so the key may be new. */
+	error = dictionary_bloom_filter_track(dictionary, key);
+
+	if (err_ok != error) {
+		status.error = error;
+	}
+	else {
+		status = dictionary->handler->update(dictionary, key, value);
+		dictionary_log_write(dictionary, ion_wal_record_update, key, value, &status);
+	}
+
+	dictionary_unlock_write(dictionary);
+	ION_STATS_END(dictionary, ion_stats_update);
+	return status;
 }
 
 ion_err_t
 dictionary_delete_dictionary(
 	ion_dictionary_t *dictionary
 ) {
-	return dictionary->handler->delete_dictionary(dictionary);
+	ion_dictionary_id_t id		= dictionary->instance->id;
+	ion_err_t			error	= err_ok;
+
+	if (NULL != dictionary->wal) {
+		error = ion_wal_forget(dictionary->wal, id);
+
+		if (err_ok != error) {
+			return error;
+		}
+	}
+
+	error = dictionary->handler->delete_dictionary(dictionary);
+
+	if (err_ok == error) {
+		ION_RWLOCK_DESTROY(dictionary->lock);
+	}
+
+	if ((err_ok == error) && (NULL != dictionary->bloom_filter)) {
+		bloom_filter_free(&dictionary->bloom_filter);
+		error = bloom_filter_destroy(id);
+	}
+
+#if ION_DICTIONARY_STATS
+
+	if (err_ok == error) {
+		dictionary_disable_stats(dictionary);
+	}
+
+#endif
+	return error;
 }
 
 ion_err_t
@@ -192,6 +739,10 @@ dictionary_destroy_dictionary(
 		error = ffdict_destroy_dictionary(id);
 	}
 
+	if (err_ok == error) {
+		error = bloom_filter_destroy(id);
+	}
+
 	return error;
 }
 
@@ -200,7 +751,25 @@ dictionary_delete(
 	ion_dictionary_t	*dictionary,
 	ion_key_t			key
 ) {
-	return dictionary->handler->remove(dictionary, key);
+	ION_STATS_BEGIN(dictionary);
+
+	ion_status_t	status	= ION_STATUS_ERROR(err_item_not_found);
+	ion_err_t		error	= dictionary_lock_write(dictionary);
+
+	if (err_ok != error) {
+		status.error = error;
+		ION_STATS_END(dictionary, ion_stats_delete);
+		return status;
+	}
+
+	if ((NULL == dictionary->bloom_filter) || bloom_filter_might_contain(dictionary->bloom_filter, key)) {
+		status = dictionary->handler->remove(dictionary, key);
+		dictionary_log_write(dictionary, ion_wal_record_delete, key, NULL, &status);
+	}
+
+	dictionary_unlock_write(dictionary);
+	ION_STATS_END(dictionary, ion_stats_delete);
+	return status;
 }
 
 char
@@ -291,9 +860,19 @@ dictionary_open(
 ) {
 	ion_dictionary_compare_t compare	= dictionary_switch_compare(config->type);
 
+	dictionary->bloom_filter = NULL;
+#if ION_DICTIONARY_STATS
+	dictionary->stats = NULL;
+#endif
+	dictionary->wal = NULL;
+
 	ion_err_t error						= handler->open_dictionary(handler, dictionary, config, compare);
 
-	if (err_not_implemented == error) {
+	if (err_ok == error) {
+		ION_RWLOCK_INIT(dictionary->lock);
+	}
+	else if (err_not_implemented == error) {
+		/* Created through dictionary_create, which sets up the lock. */
 		ion_predicate_t				predicate;
 		ion_dict_cursor_t			*cursor = NULL;
 		ion_record_t				record;
@@ -313,6 +892,9 @@ dictionary_open(
 			return err;
 		}
 
+		/* The filter belongs to the dictionary being opened, not to its fallback copy. */
+		bloom_filter_free(&fallback_dict.bloom_filter);
+
 		dictionary_build_predicate(&predicate, predicate_all_records);
 		err = dictionary_find(&fallback_dict, &predicate, &cursor);
 
@@ -360,6 +942,8 @@ dictionary_open(
 	if (err_ok == error) {
 		dictionary->status			= ion_dictionary_status_ok;
 		dictionary->instance->id	= config->id;
+
+		error						= dictionary_bloom_filter_load(dictionary);
 	}
 	else {
 		dictionary->status = ion_dictionary_status_error;
@@ -376,9 +960,29 @@ dictionary_close(
 		return err_ok;
 	}
 
-	ion_err_t error = dictionary->handler->close_dictionary(dictionary);
+	ion_err_t error = bloom_filter_close(&dictionary->bloom_filter);
 
-	if (err_not_implemented == error) {
+	if (err_ok != error) {
+		return error;
+	}
+
+#if ION_DICTIONARY_STATS
+	dictionary_disable_stats(dictionary);
+#endif
+
+	error = dictionary_detach_wal(dictionary);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = dictionary->handler->close_dictionary(dictionary);
+
+	if (err_ok == error) {
+		ION_RWLOCK_DESTROY(dictionary->lock);
+	}
+	else if (err_not_implemented == error) {
+		/* Deleted through dictionary_delete_dictionary, which tears down the lock. */
 		ion_predicate_t		predicate;
 		ion_dict_cursor_t	*cursor = NULL;
 		ion_record_t		record;
@@ -451,6 +1055,35 @@ dictionary_close(
 	return error;
 }
 
+ion_err_t
+dictionary_sync(
+	ion_dictionary_t *dictionary
+) {
+	ion_err_t error = err_ok;
+
+#if ION_THREAD_SAFE
+
+	/* A cursor the calling thread holds keeps the dictionary shared. */
+	if (dictionary_thread_holds_cursor_on(dictionary)) {
+		return err_would_deadlock;
+	}
+
+#endif
+	ION_RWLOCK_WRITE(dictionary->lock);
+
+	if (NULL != dictionary->handler->sync_dictionary) {
+		error = dictionary->handler->sync_dictionary(dictionary);
+	}
+
+	if ((err_ok == error) && (NULL != dictionary->bloom_filter)) {
+		error = bloom_filter_persist(dictionary->bloom_filter);
+	}
+
+	ION_RWLOCK_UNLOCK(dictionary->lock);
+
+	return error;
+}
+
 /**
 @brief		Destroys an equality predicate.
 @details	This function should not be called directly. Instead, it is set
@@ -564,7 +1197,70 @@ dictionary_find(
 	ion_predicate_t		*predicate,
 	ion_dict_cursor_t	**cursor
 ) {
-	return dictionary->handler->find(dictionary, predicate, cursor);
+	ION_STATS_BEGIN(dictionary);
+	ION_RWLOCK_READ(dictionary->lock);
+
+	ion_err_t error = dictionary->handler->find(dictionary, predicate, cursor);
+
+#if ION_THREAD_SAFE || ION_DICTIONARY_STATS
+
+	if (err_ok == error) {
+		/* The cursor keeps the dictionary shared, and its statistics alive, until it is destroyed. */
+		(*cursor)->impl_destroy = (*cursor)->destroy;
+		(*cursor)->destroy		= dictionary_destroy_cursor;
+#if ION_THREAD_SAFE
+		(*cursor)->next_held	= dictionary_held_cursors_first();
+		pthread_setspecific(dictionary_held_cursors, *cursor);
+#endif
+#if ION_DICTIONARY_STATS
+		(*cursor)->stats		= NULL;
+
+		if (NULL != dictionary->stats) {
+			dictionary_stats_track_cursor(dictionary->stats, *cursor);
+		}
+
+#endif
+	}
+	else {
+		ION_RWLOCK_UNLOCK(dictionary->lock);
+	}
+
+#endif
+	ION_STATS_END(dictionary, ion_stats_find);
+	return error;
+}
+
+ion_cursor_status_t
+dictionary_cursor_next_batch(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*records,
+	ion_result_count_t	max_records,
+	ion_result_count_t	*num_records
+) {
+	ion_cursor_status_t status;
+
+	if (NULL != cursor->next_batch) {
+		ION_STATS_BEGIN(cursor);
+
+		status = cursor->next_batch(cursor, records, max_records, num_records);
+
+		ION_STATS_END(cursor, ion_stats_cursor_next);
+		return status;
+	}
+
+	*num_records = 0;
+
+	while (*num_records < max_records) {
+		status = cursor->next(cursor, &records[*num_records]);
+
+		if ((cs_cursor_active != status) && (cs_cursor_initialized != status)) {
+			return 0 < *num_records ? cs_cursor_active : status;
+		}
+
+		(*num_records)++;
+	}
+
+	return 0 < *num_records ? cs_cursor_active : cursor->status;
 }
 
 ion_boolean_t
@@ -607,3 +1303,29 @@ test_predicate(
 
 	return result;
 }
+
+#if ION_FILE_STATS
+
+void
+dictionary_get_io_stats(
+	ion_dictionary_t	*dictionary,
+	ion_file_io_stats_t *io
+) {
+	ion_file_io_stats_t *owner_io = ion_file_owner_stats(dictionary->instance->id);
+
+	if (NULL == owner_io) {
+		memset(io, 0, sizeof(*io));
+		return;
+	}
+
+	ion_file_stats_copy(io, owner_io);
+}
+
+void
+dictionary_reset_io_stats(
+	ion_dictionary_t *dictionary
+) {
+	ion_file_reset_owner_stats(dictionary->instance->id);
+}
+
+#endif /* Clause ION_FILE_STATS */
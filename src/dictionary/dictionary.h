@@ -44,6 +44,10 @@ extern "C" {
 #include <stdarg.h>
 #include "../key_value/kv_system.h"
 #include "dictionary_types.h"
+#include "dictionary_bloom_filter.h"
+#include "dictionary_stats.h"
+#include "dictionary_wal.h"
+#include "dictionary_scan.h"
 
 /**
 @brief			Given the ID, implementation specific extension, and a buffer to write to,
@@ -134,6 +138,35 @@ dictionary_get(
 	ion_value_t			value
 );
 
+/**
+@brief		Retrieves the values of a batch of keys.
+@details	Dictionaries on files that implement it have the reads of all
+			the keys in flight at once, see @ref ion_file_queue_t. Others
+			look the keys up one at a time. Either way this counts as one
+			get in the dictionary's latency statistics.
+@param		dictionary
+				The dictionary to search.
+@param		num_keys
+				How many keys to look up.
+@param		keys
+				The keys.
+@param		values
+				Buffers the value of each key is copied into.
+@param		statuses
+				Written with the status of each lookup, as
+				@ref dictionary_get would have returned it.
+@return		The number of keys found, with @c err_ok unless a lookup
+			failed for a reason other than its key being absent.
+*/
+ion_status_t
+dictionary_get_many(
+	ion_dictionary_t	*dictionary,
+	unsigned int		num_keys,
+	ion_key_t			*keys,
+	ion_value_t			*values,
+	ion_status_t		*statuses
+);
+
 /**
 @brief		Delete a value given a key.
 @param		dictionary
@@ -252,6 +285,9 @@ dictionary_compare_signed_value(
 
 /**
 @brief		Opens a dictionary, given the desired config.
+@details	Opening and closing are not thread-safe, even when built with
+			@ref ION_THREAD_SAFE: no other thread may use the dictionary, or
+			open or close any other dictionary, while this runs.
 @param		handler
 				A pointer to the dictionary handler object to be used.
 @param		dictionary
@@ -279,6 +315,67 @@ dictionary_close(
 	ion_dictionary_t *dictionary
 );
 
+/**
+@brief		Forces every change made so far to a dictionary to the device.
+@details	Dictionaries that keep their records in memory have nothing to
+			force, and succeed straight away. A Bloom filter attached to the
+			dictionary is written out as well, so that it need not be rebuilt
+			when the dictionary is next opened.
+@param		dictionary
+				A pointer to the dictionary object to be synced.
+@returns	@ref err_would_deadlock if the calling thread holds a cursor
+			on the dictionary, otherwise the status of the sync.
+*/
+ion_err_t
+dictionary_sync(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Attaches a persistent Bloom filter to a dictionary.
+@details	The filter is populated from the current contents of the
+			dictionary, and from then on is maintained on every insert and
+			update made through this layer. It is consulted before a get or
+			delete is passed to the implementation, so that lookups of absent
+			keys return @c err_item_not_found without touching the
+			implementation. The filter is stored next to the dictionary and
+			is re-attached by @ref dictionary_open, which rebuilds it if the
+			dictionary was not closed cleanly. Deletes do not clear bits, so
+			heavy delete workloads should periodically re-enable the filter.
+			Implementations without cursor support cannot be scanned, so for
+			these the filter must be enabled while the dictionary is empty.
+			Enabling a filter on a dictionary that already has one replaces
+			it.
+@param		dictionary
+				The dictionary to attach the filter to.
+@param		num_bits
+				The number of bits in the filter. Use
+				@ref ION_BLOOM_FILTER_BITS_PER_KEY times the expected number
+				of keys for roughly a 1% false positive rate.
+@param		num_hashes
+				The number of hash functions, usually
+				@ref ION_BLOOM_FILTER_DEFAULT_NUM_HASHES.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+dictionary_enable_bloom_filter(
+	ion_dictionary_t		*dictionary,
+	ion_bloom_filter_size_t num_bits,
+	ion_byte_t				num_hashes
+);
+
+/**
+@brief		Detaches the Bloom filter of a dictionary and removes it from
+			disk.
+@param		dictionary
+				The dictionary to detach the filter from.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+dictionary_disable_bloom_filter(
+	ion_dictionary_t *dictionary
+);
+
 /**
 @brief		Builds a predicate based on the type given.
 @details	The caller is responsible for allocating the memory needed
@@ -308,7 +405,17 @@ dictionary_build_predicate(
 @brief		Uses the given predicate and cursor to search the dictionary.
 @details	This function will allocate and initialize the cursor.
 			This means that it must freed once we are done. This function
-			sets up a cursor for traversal.
+			sets up a cursor for traversal. When built with
+			@ref ION_THREAD_SAFE, the cursor holds the dictionary shared
+			until it is destroyed, so other threads may keep reading while
+			writers wait. The cursor must be destroyed by the thread that
+			opened it. While it is open, that thread's inserts, updates and
+			deletes fail with @ref err_would_deadlock instead of waiting on
+			it, if they take the dictionary exclusively (any handler that
+			is not concurrent, or one with a bloom filter) or go to any
+			dictionary attached to the same log. So does every other
+			operation that locks that log, such as @ref ion_wal_commit and
+			@ref ion_wal_checkpoint.
 @param		dictionary
 				A pointer to the dictionary object to be created.
 @param		predicate
@@ -326,6 +433,32 @@ dictionary_find(
 	ion_dict_cursor_t	**cursor
 );
 
+/**
+@brief		Fetches up to @p max_records records from a cursor in one call.
+@details	Each record in @p records must already have its key and value
+			pointing to buffers large enough to hold a key and value of the
+			cursor's dictionary. If the implementation provides a native batch
+			function it is used, otherwise this falls back to repeatedly
+			calling the cursor's @c next function.
+@param		cursor
+				The cursor to advance.
+@param		records
+				An array of at least @p max_records pre-allocated records.
+@param		max_records
+				The maximum number of records to fetch.
+@param		num_records
+				Written with the number of records actually fetched.
+@returns	@c cs_cursor_active if at least one record was fetched, otherwise
+			the status that stopped the cursor (e.g. @c cs_end_of_results).
+*/
+ion_cursor_status_t
+dictionary_cursor_next_batch(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*records,
+	ion_result_count_t	max_records,
+	ion_result_count_t	*num_records
+);
+
 /**
 @brief		Tests the supplied @p key against the predicate registered in the
 			@p cursor. If the supplied @p cursor if of the type equality, the key is tested for equality with that
@@ -347,6 +480,55 @@ test_predicate(
 	ion_key_t			key
 );
 
+#if ION_THREAD_SAFE
+
+/**
+@brief		Whether the calling thread holds a cursor on a dictionary
+			attached to a log.
+@details	Used by the log to refuse to wait for itself while a
+			checkpoint holding it may be waiting on the calling thread's
+			own cursors.
+@param		wal
+				The log.
+*/
+ion_boolean_t
+dictionary_thread_holds_logged_cursor(
+	ion_wal_t *wal
+);
+
+#endif /* Clause ION_THREAD_SAFE */
+
+#if ION_FILE_STATS
+
+/**
+@brief		Reads the file I/O done on behalf of a dictionary since the
+			process started or its counters were last reset.
+@details	Covers every file the implementation opens under the
+			dictionary's ID, including its bloom filter. Counting does not
+			need @ref dictionary_enable_stats.
+@param		dictionary
+				An open dictionary.
+@param		io
+				Written with the counters.
+*/
+void
+dictionary_get_io_stats(
+	ion_dictionary_t	*dictionary,
+	ion_file_io_stats_t *io
+);
+
+/**
+@brief		Zeroes the file I/O counters of a dictionary.
+@param		dictionary
+				An open dictionary.
+*/
+void
+dictionary_reset_io_stats(
+	ion_dictionary_t *dictionary
+);
+
+#endif /* Clause ION_FILE_STATS */
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,388 @@
+/******************************************************************************/
+/**
+@file		dictionary_bloom_filter.c
+@author		IonDB Project
+@brief		Implementation of the persistent dictionary Bloom filter.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "dictionary_bloom_filter.h"
+#include "dictionary.h"
+#include "../file/ion_file.h"
+
+/**
+@brief		Computes the two base hashes used to derive every probe position
+			of a key (Kirsch-Mitzenmacher double hashing).
+@details	String keys compare equal up to their first null byte, so only
+			the bytes before it are hashed. Otherwise two keys that compare
+			equal could map to different bits.
+@param[in]	bloom_filter
+				The filter the key is hashed for.
+@param[in]	key
+				The key to hash.
+@param[out]	first_hash
+				Written with the first base hash.
+@param[out]	second_hash
+				Written with the second base hash, which is always odd.
+*/
+void
+bloom_filter_hash(
+	ion_bloom_filter_t	*bloom_filter,
+	ion_key_t			key,
+	uint32_t			*first_hash,
+	uint32_t			*second_hash
+) {
+	ion_byte_t		*bytes	= (ion_byte_t *) key;
+	ion_key_size_t	length	= bloom_filter->key_size;
+	uint32_t		hash	= 2166136261u;
+	ion_key_size_t	i;
+
+	if ((key_type_char_array == bloom_filter->key_type) || (key_type_null_terminated_string == bloom_filter->key_type)) {
+		length = 0;
+
+		while (length < bloom_filter->key_size && '\0' != bytes[length]) {
+			length++;
+		}
+	}
+
+	/* FNV-1a over the significant key bytes. */
+	for (i = 0; i < length; i++) {
+		hash	^= bytes[i];
+		hash	*= 16777619u;
+	}
+
+	*first_hash = hash;
+
+	/* Derive the second hash with the murmur3 finalizer. */
+	hash		^= hash >> 16;
+	hash		*= 0x85ebca6bu;
+	hash		^= hash >> 13;
+	hash		*= 0xc2b2ae35u;
+	hash		^= hash >> 16;
+
+	*second_hash = hash | 1;
+}
+
+/**
+@brief		Opens the filter file of a dictionary.
+@param[in]	id
+				ID of the dictionary.
+@param[in]	create
+				Whether to start a new, empty file. Otherwise the file must
+				already exist.
+@return		The opened file, or @ref ION_NOFILE on failure.
+*/
+ion_file_handle_t
+bloom_filter_fopen(
+	ion_dictionary_id_t id,
+	ion_boolean_t		create
+) {
+	char				filename[ION_MAX_FILENAME_LENGTH];
+	ion_file_handle_t	file;
+
+	dictionary_get_filename(id, ION_BLOOM_FILTER_FILE_EXTENSION, filename);
+
+	if (ion_fexists(filename)) {
+		if (create) {
+			ion_fremove(filename);
+		}
+	}
+	else if (!create) {
+		return ION_NOFILE;
+	}
+
+	file = ion_fopen(filename);
+
+#if ION_FILE_STATS
+
+	if (!ION_FILE_IS_NULL(file)) {
+		ion_file_set_owner(file, id);
+	}
+
+#endif
+	return file;
+}
+
+ion_err_t
+bloom_filter_create(
+	ion_bloom_filter_t		**bloom_filter,
+	ion_dictionary_id_t		id,
+	ion_key_type_t			key_type,
+	ion_key_size_t			key_size,
+	ion_bloom_filter_size_t num_bits,
+	ion_byte_t				num_hashes
+) {
+	ion_err_t error;
+
+	if ((0 == num_bits) || (0 == num_hashes)) {
+		return err_invalid_initial_size;
+	}
+
+	*bloom_filter = malloc(sizeof(ion_bloom_filter_t));
+
+	if (NULL == *bloom_filter) {
+		return err_out_of_memory;
+	}
+
+	(*bloom_filter)->bits = calloc((num_bits + 7) / 8, 1);
+
+	if (NULL == (*bloom_filter)->bits) {
+		free(*bloom_filter);
+		*bloom_filter = NULL;
+		return err_out_of_memory;
+	}
+
+	(*bloom_filter)->id			= id;
+	(*bloom_filter)->key_type	= key_type;
+	(*bloom_filter)->key_size	= key_size;
+	(*bloom_filter)->num_bits	= num_bits;
+	(*bloom_filter)->num_hashes = num_hashes;
+	(*bloom_filter)->state		= ION_BLOOM_FILTER_STATE_STALE;
+
+	/* Nothing has been added yet, so the file starts out stale. */
+	error						= bloom_filter_persist(*bloom_filter);
+
+	if (err_ok != error) {
+		bloom_filter_free(bloom_filter);
+		return error;
+	}
+
+	return bloom_filter_mark_stale(*bloom_filter);
+}
+
+ion_err_t
+bloom_filter_open(
+	ion_bloom_filter_t	**bloom_filter,
+	ion_dictionary_id_t id,
+	ion_key_type_t		key_type,
+	ion_key_size_t		key_size
+) {
+	ion_file_handle_t		file;
+	ion_byte_t				state;
+	ion_byte_t				num_hashes;
+	ion_bloom_filter_size_t num_bits;
+
+	*bloom_filter	= NULL;
+	file			= bloom_filter_fopen(id, boolean_false);
+
+	if (ION_FILE_IS_NULL(file)) {
+		return err_file_open_error;
+	}
+
+	if ((err_ok != ion_fread(file, sizeof(state), &state)) || (err_ok != ion_fread(file, sizeof(num_hashes), &num_hashes)) || (err_ok != ion_fread(file, sizeof(num_bits), (ion_byte_t *) &num_bits)) || (0 == num_bits) || (0 == num_hashes)) {
+		ion_fclose(file);
+		return err_file_read_error;
+	}
+
+	*bloom_filter = malloc(sizeof(ion_bloom_filter_t));
+
+	if (NULL == *bloom_filter) {
+		ion_fclose(file);
+		return err_out_of_memory;
+	}
+
+	(*bloom_filter)->bits = malloc((num_bits + 7) / 8);
+
+	if (NULL == (*bloom_filter)->bits) {
+		free(*bloom_filter);
+		*bloom_filter = NULL;
+		ion_fclose(file);
+		return err_out_of_memory;
+	}
+
+	(*bloom_filter)->id			= id;
+	(*bloom_filter)->key_type	= key_type;
+	(*bloom_filter)->key_size	= key_size;
+	(*bloom_filter)->num_bits	= num_bits;
+	(*bloom_filter)->num_hashes = num_hashes;
+	(*bloom_filter)->state		= state;
+
+	if (err_ok != ion_fread(file, (num_bits + 7) / 8, (*bloom_filter)->bits)) {
+		bloom_filter_free(bloom_filter);
+		ion_fclose(file);
+		return err_file_read_error;
+	}
+
+	if (err_ok != ion_fclose(file)) {
+		bloom_filter_free(bloom_filter);
+		return err_file_close_error;
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+bloom_filter_persist(
+	ion_bloom_filter_t *bloom_filter
+) {
+	ion_file_handle_t	file	= bloom_filter_fopen(bloom_filter->id, boolean_true);
+	ion_byte_t			state	= ION_BLOOM_FILTER_STATE_CLEAN;
+
+	if (ION_FILE_IS_NULL(file)) {
+		return err_file_open_error;
+	}
+
+	if ((err_ok != ion_fwrite(file, sizeof(state), &state)) || (err_ok != ion_fwrite(file, sizeof(bloom_filter->num_hashes), &bloom_filter->num_hashes)) || (err_ok != ion_fwrite(file, sizeof(bloom_filter->num_bits), (ion_byte_t *) &bloom_filter->num_bits)) || (err_ok != ion_fwrite(file, (bloom_filter->num_bits + 7) / 8, bloom_filter->bits))) {
+		ion_fclose(file);
+		return err_file_write_error;
+	}
+
+	if (err_ok != ion_fclose(file)) {
+		return err_file_close_error;
+	}
+
+	bloom_filter->state = ION_BLOOM_FILTER_STATE_CLEAN;
+
+	return err_ok;
+}
+
+ion_err_t
+bloom_filter_mark_stale(
+	ion_bloom_filter_t *bloom_filter
+) {
+	ion_file_handle_t	file;
+	ion_byte_t			state = ION_BLOOM_FILTER_STATE_STALE;
+
+	if (ION_BLOOM_FILTER_STATE_STALE == bloom_filter->state) {
+		return err_ok;
+	}
+
+	file = bloom_filter_fopen(bloom_filter->id, boolean_false);
+
+	if (ION_FILE_IS_NULL(file)) {
+		return err_file_open_error;
+	}
+
+	if (err_ok != ion_fwrite(file, sizeof(state), &state)) {
+		ion_fclose(file);
+		return err_file_write_error;
+	}
+
+	if (err_ok != ion_fclose(file)) {
+		return err_file_close_error;
+	}
+
+	bloom_filter->state = ION_BLOOM_FILTER_STATE_STALE;
+
+	return err_ok;
+}
+
+ion_err_t
+bloom_filter_close(
+	ion_bloom_filter_t **bloom_filter
+) {
+	ion_err_t error = err_ok;
+
+	if (NULL != *bloom_filter) {
+		error = bloom_filter_persist(*bloom_filter);
+		bloom_filter_free(bloom_filter);
+	}
+
+	return error;
+}
+
+void
+bloom_filter_free(
+	ion_bloom_filter_t **bloom_filter
+) {
+	if (NULL != *bloom_filter) {
+		free((*bloom_filter)->bits);
+		free(*bloom_filter);
+		*bloom_filter = NULL;
+	}
+}
+
+ion_err_t
+bloom_filter_destroy(
+	ion_dictionary_id_t id
+) {
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(id, ION_BLOOM_FILTER_FILE_EXTENSION, filename);
+
+	if (!ion_fexists(filename)) {
+		/* No filter was ever enabled for this dictionary. */
+		return err_ok;
+	}
+
+	if (err_ok != ion_fremove(filename)) {
+		return err_file_delete_error;
+	}
+
+	return err_ok;
+}
+
+void
+bloom_filter_clear(
+	ion_bloom_filter_t *bloom_filter
+) {
+	memset(bloom_filter->bits, 0, (bloom_filter->num_bits + 7) / 8);
+}
+
+void
+bloom_filter_add(
+	ion_bloom_filter_t	*bloom_filter,
+	ion_key_t			key
+) {
+	uint32_t	first_hash;
+	uint32_t	second_hash;
+	ion_byte_t	i;
+
+	bloom_filter_hash(bloom_filter, key, &first_hash, &second_hash);
+
+	for (i = 0; i < bloom_filter->num_hashes; i++) {
+		ion_bloom_filter_size_t bit = (first_hash + i * second_hash) % bloom_filter->num_bits;
+
+		bloom_filter->bits[bit / 8] |= (ion_byte_t) (1 << (bit % 8));
+	}
+}
+
+ion_boolean_t
+bloom_filter_might_contain(
+	ion_bloom_filter_t	*bloom_filter,
+	ion_key_t			key
+) {
+	uint32_t	first_hash;
+	uint32_t	second_hash;
+	ion_byte_t	i;
+
+	bloom_filter_hash(bloom_filter, key, &first_hash, &second_hash);
+
+	for (i = 0; i < bloom_filter->num_hashes; i++) {
+		ion_bloom_filter_size_t bit = (first_hash + i * second_hash) % bloom_filter->num_bits;
+
+		if (0 == (bloom_filter->bits[bit / 8] & (1 << (bit % 8)))) {
+			return boolean_false;
+		}
+	}
+
+	return boolean_true;
+}
@@ -0,0 +1,249 @@
+/******************************************************************************/
+/**
+@file		dictionary_bloom_filter.h
+@author		IonDB Project
+@brief		Persistent Bloom filter that the generic dictionary layer can
+			attach to any dictionary instance to short-circuit lookups of
+			keys that are not present.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(DICTIONARY_BLOOM_FILTER_H_)
+#define DICTIONARY_BLOOM_FILTER_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "../key_value/kv_system.h"
+#include "dictionary_types.h"
+
+/**
+@brief		File extension used for persisted Bloom filters.
+*/
+#define ION_BLOOM_FILTER_FILE_EXTENSION "blm"
+
+/**
+@brief		On-disk state flag written when the persisted bits match the
+			dictionary contents.
+*/
+#define ION_BLOOM_FILTER_STATE_CLEAN	0
+
+/**
+@brief		On-disk state flag written once the dictionary has been modified
+			after the filter was last persisted. A filter found in this state
+			on open must be rebuilt.
+*/
+#define ION_BLOOM_FILTER_STATE_STALE	1
+
+/**
+@brief		Suggested number of filter bits to use per expected key. Together
+			with @ref ION_BLOOM_FILTER_DEFAULT_NUM_HASHES this gives roughly a
+			1% false positive rate.
+*/
+#define ION_BLOOM_FILTER_BITS_PER_KEY		10
+
+/**
+@brief		Suggested number of hash functions for
+			@ref ION_BLOOM_FILTER_BITS_PER_KEY bits per key.
+*/
+#define ION_BLOOM_FILTER_DEFAULT_NUM_HASHES 7
+
+/**
+@brief		Type used to count the bits of a Bloom filter.
+*/
+typedef uint32_t ion_bloom_filter_size_t;
+
+/**
+@brief		A Bloom filter over the keys of a single dictionary instance.
+*/
+struct bloom_filter {
+	ion_dictionary_id_t		id;			/**< ID of the dictionary the filter
+											 belongs to, used to name the
+											 filter file. */
+	ion_key_type_t			key_type;	/**< Key type, which determines
+											 which key bytes are hashed. */
+	ion_key_size_t			key_size;	/**< Size of the keys in bytes. */
+	ion_bloom_filter_size_t num_bits;	/**< Number of bits in the filter. */
+	ion_byte_t				num_hashes;	/**< Number of bits set per key. */
+	ion_byte_t				state;		/**< State last written to disk. */
+	ion_byte_t				*bits;		/**< The filter bits. */
+};
+
+/**
+@brief		Allocates an empty Bloom filter and writes it to disk marked as
+			stale, since it has not yet been populated.
+@param[out]	bloom_filter
+				Written with the allocated filter.
+@param[in]	id
+				ID of the dictionary the filter belongs to.
+@param[in]	key_type
+				Key type of the dictionary.
+@param[in]	key_size
+				Key size of the dictionary.
+@param[in]	num_bits
+				Number of bits in the filter. Must be non-zero.
+@param[in]	num_hashes
+				Number of hash functions to use. Must be non-zero.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+bloom_filter_create(
+	ion_bloom_filter_t		**bloom_filter,
+	ion_dictionary_id_t		id,
+	ion_key_type_t			key_type,
+	ion_key_size_t			key_size,
+	ion_bloom_filter_size_t num_bits,
+	ion_byte_t				num_hashes
+);
+
+/**
+@brief		Loads a previously persisted Bloom filter.
+@param[out]	bloom_filter
+				Written with the allocated filter.
+@param[in]	id
+				ID of the dictionary the filter belongs to.
+@param[in]	key_type
+				Key type of the dictionary.
+@param[in]	key_size
+				Key size of the dictionary.
+@return		@c err_file_open_error if no filter exists for the dictionary,
+			otherwise the resulting status of the operation. Check the
+			@c state of the loaded filter to see whether it must be rebuilt.
+*/
+ion_err_t
+bloom_filter_open(
+	ion_bloom_filter_t	**bloom_filter,
+	ion_dictionary_id_t id,
+	ion_key_type_t		key_type,
+	ion_key_size_t		key_size
+);
+
+/**
+@brief		Writes the filter bits to disk and marks the file clean.
+@param[in]	bloom_filter
+				Which filter to persist.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+bloom_filter_persist(
+	ion_bloom_filter_t *bloom_filter
+);
+
+/**
+@brief		Marks the persisted filter as stale.
+@details	Only the state flag is written, and only the first time this is
+			called after the filter was last persisted, so this is cheap to
+			call before every modification.
+@param[in]	bloom_filter
+				Which filter to mark.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+bloom_filter_mark_stale(
+	ion_bloom_filter_t *bloom_filter
+);
+
+/**
+@brief		Persists and frees a filter.
+@param[in]	bloom_filter
+				A pointer to the filter to close, which is set to @p NULL.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+bloom_filter_close(
+	ion_bloom_filter_t **bloom_filter
+);
+
+/**
+@brief		Frees a filter without persisting it.
+@param[in]	bloom_filter
+				A pointer to the filter to free, which is set to @p NULL.
+*/
+void
+bloom_filter_free(
+	ion_bloom_filter_t **bloom_filter
+);
+
+/**
+@brief		Removes the persisted filter of a dictionary, if there is one.
+@param[in]	id
+				ID of the dictionary whose filter is removed.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+bloom_filter_destroy(
+	ion_dictionary_id_t id
+);
+
+/**
+@brief		Clears every bit of the filter.
+@param[in]	bloom_filter
+				Which filter to clear.
+*/
+void
+bloom_filter_clear(
+	ion_bloom_filter_t *bloom_filter
+);
+
+/**
+@brief		Adds a key to the filter.
+@param[in]	bloom_filter
+				Which filter to add to.
+@param[in]	key
+				The key to add.
+*/
+void
+bloom_filter_add(
+	ion_bloom_filter_t	*bloom_filter,
+	ion_key_t			key
+);
+
+/**
+@brief		Tests whether a key may be in the filter.
+@param[in]	bloom_filter
+				Which filter to test.
+@param[in]	key
+				The key to test.
+@return		@c boolean_false if the key is definitely not present,
+			@c boolean_true if it may be present.
+*/
+ion_boolean_t
+bloom_filter_might_contain(
+	ion_bloom_filter_t	*bloom_filter,
+	ion_key_t			key
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
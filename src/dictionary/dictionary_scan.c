@@ -0,0 +1,700 @@
+/******************************************************************************/
+/**
+@file		dictionary_scan.c
+@author		IonDB Project
+@brief		Implementation of parallel full scans.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "dictionary_scan.h"
+#include "dictionary.h"
+
+/**
+@brief		Records the first error met by a scan and stops it.
+@param		scan
+				The failed scan.
+@param		error
+				What went wrong.
+*/
+static void
+dictionary_scan_fail(
+	ion_dictionary_scan_t	*scan,
+	ion_err_t				error
+) {
+	ION_MUTEX_LOCK(scan->lock);
+
+	if (err_ok == scan->error) {
+		scan->error = error;
+	}
+
+	ION_ATOMIC_STORE(&scan->stopped, boolean_true);
+	ION_COND_BROADCAST(scan->changed);
+	ION_MUTEX_UNLOCK(scan->lock);
+}
+
+/**
+@brief		Gives a worker the next range nobody has claimed yet.
+@param		worker
+				The worker that has finished its range.
+@returns	@c boolean_false if every range has been claimed.
+*/
+static ion_boolean_t
+dictionary_scan_claim(
+	ion_dictionary_scan_worker_t *worker
+) {
+	ion_dictionary_scan_t	*scan	= worker->scan;
+	int						range	= ION_ATOMIC_FETCH_ADD(&scan->next_range, 1);
+
+	if (range >= scan->num_ranges) {
+		return boolean_false;
+	}
+
+	worker->range.position	= range * scan->range_size;
+	worker->range.end		= worker->range.position + scan->range_size;
+	worker->range.resume	= -1;
+
+	if (worker->range.end > scan->num_positions) {
+		worker->range.end = scan->num_positions;
+	}
+
+	return boolean_true;
+}
+
+/**
+@brief		Reads the next buffer of a worker's range, claiming a new range
+			once the last one is done.
+@param		worker
+				The worker to advance.
+@returns	@c boolean_false once there is nothing left to read or the scan
+			has stopped.
+*/
+static ion_boolean_t
+dictionary_scan_step(
+	ion_dictionary_scan_worker_t *worker
+) {
+	ion_dictionary_scan_t	*scan = worker->scan;
+	ion_err_t				error;
+
+	if (ION_ATOMIC_LOAD(&scan->stopped)) {
+		return boolean_false;
+	}
+
+	if (!worker->in_range || (worker->range.position >= worker->range.end)) {
+		worker->in_range = dictionary_scan_claim(worker);
+
+		if (!worker->in_range) {
+			return boolean_false;
+		}
+	}
+
+	error = scan->dictionary->handler->scan_range(scan->dictionary, &worker->range);
+
+	if (err_ok != error) {
+		dictionary_scan_fail(scan, error);
+		return boolean_false;
+	}
+
+	return boolean_true;
+}
+
+/**
+@brief		Passes a record to the callback of a scan.
+@param		range
+				The range the record was found in.
+@param		record
+				The record.
+@returns	@c boolean_false once the scan is to stop.
+*/
+static ion_boolean_t
+dictionary_scan_emit_callback(
+	ion_dictionary_scan_range_t *range,
+	ion_record_t				*record
+) {
+	ion_dictionary_scan_worker_t	*worker = range->worker;
+	ion_dictionary_scan_t			*scan	= worker->scan;
+
+	if (!scan->callback(record, worker->index, scan->context)) {
+		ION_ATOMIC_STORE(&scan->stopped, boolean_true);
+		return boolean_false;
+	}
+
+	return !ION_ATOMIC_LOAD(&scan->stopped);
+}
+
+/**
+@brief		Copies a record into the queue of a scan feeding a cursor,
+			waiting for room if the cursor has fallen behind.
+@param		range
+				The range the record was found in.
+@param		record
+				The record.
+@returns	@c boolean_false once the scan is to stop.
+*/
+static ion_boolean_t
+dictionary_scan_emit_queue(
+	ion_dictionary_scan_range_t *range,
+	ion_record_t				*record
+) {
+	ion_dictionary_scan_t	*scan		= ((ion_dictionary_scan_worker_t *) range->worker)->scan;
+	ion_key_size_t			key_size	= scan->dictionary->instance->record.key_size;
+	ion_value_size_t		value_size	= scan->dictionary->instance->record.value_size;
+	ion_byte_t				*slot;
+
+	ION_MUTEX_LOCK(scan->lock);
+
+#if ION_THREAD_SAFE
+
+	while ((scan->queue_capacity == scan->queue_count) && !ION_ATOMIC_LOAD(&scan->stopped)) {
+		ION_COND_WAIT(scan->changed, scan->lock);
+	}
+
+	if (ION_ATOMIC_LOAD(&scan->stopped)) {
+		ION_MUTEX_UNLOCK(scan->lock);
+		return boolean_false;
+	}
+
+#endif
+
+	/* Without threads the cursor only reads on when the queue is empty,
+	   and the queue holds a whole buffer of records. */
+	slot = scan->queue + ((scan->queue_head + scan->queue_count) % scan->queue_capacity) * (key_size + value_size);
+
+	memcpy(slot, record->key, key_size);
+	memcpy(slot + key_size, record->value, value_size);
+	scan->queue_count++;
+
+	ION_COND_BROADCAST(scan->changed);
+	ION_MUTEX_UNLOCK(scan->lock);
+
+	return boolean_true;
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Runs a worker until nothing is left to read.
+@param		argument
+				The worker.
+@returns	@c NULL.
+*/
+static void *
+dictionary_scan_work(
+	void *argument
+) {
+	ion_dictionary_scan_worker_t	*worker = argument;
+	ion_dictionary_scan_t			*scan	= worker->scan;
+
+	while (dictionary_scan_step(worker)) {}
+
+	ION_MUTEX_LOCK(scan->lock);
+	scan->active--;
+	ION_COND_BROADCAST(scan->changed);
+	ION_MUTEX_UNLOCK(scan->lock);
+
+	return NULL;
+}
+
+/**
+@brief		Starts workers on threads of their own.
+@param		scan
+				The scan to start.
+@param		first
+				The first worker to start. Any before it run on the calling
+				thread.
+@returns	An error code describing the result of the operation. Workers
+			that could not be started are left to the others.
+*/
+static ion_err_t
+dictionary_scan_start_threads(
+	ion_dictionary_scan_t	*scan,
+	int						first
+) {
+	int i;
+
+	for (i = first; i < scan->num_workers; i++) {
+		if (0 != pthread_create(&scan->workers[i].thread, NULL, dictionary_scan_work, &scan->workers[i])) {
+			break;
+		}
+
+		scan->num_threads++;
+	}
+
+	if ((0 == first) && (0 == scan->num_threads)) {
+		return err_out_of_memory;
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Waits for every worker started by
+			@ref dictionary_scan_start_threads.
+@param		scan
+				The scan to wait for.
+@param		first
+				As given to @ref dictionary_scan_start_threads.
+*/
+static void
+dictionary_scan_join_threads(
+	ion_dictionary_scan_t	*scan,
+	int						first
+) {
+	int i;
+
+	for (i = first; i < first + scan->num_threads; i++) {
+		pthread_join(scan->workers[i].thread, NULL);
+	}
+
+	scan->num_threads = 0;
+}
+
+#endif /* Clause ION_THREAD_SAFE */
+
+/**
+@brief		Sets up a scan and its workers.
+@param		scan
+				The scan to set up.
+@param		dictionary
+				The dictionary to scan.
+@param		predicate
+				Which records to find.
+@param		num_workers
+				How many workers to read with.
+@param		emit
+				Takes the records found.
+@returns	An error code describing the result of the operation.
+*/
+static ion_err_t
+dictionary_scan_initialize(
+	ion_dictionary_scan_t	*scan,
+	ion_dictionary_t		*dictionary,
+	ion_predicate_t			*predicate,
+	int						num_workers,
+	ion_boolean_t (*emit)(
+		ion_dictionary_scan_range_t *,
+		ion_record_t *
+	)
+) {
+	ion_err_t	error;
+	size_t		position_size;
+	size_t		buffer_size = ION_SCAN_BUFFER_SIZE;
+	int			i;
+
+	if ((NULL == dictionary->handler->scan_extent) || (NULL == dictionary->handler->scan_range)) {
+		return err_not_implemented;
+	}
+
+	memset(scan, 0, sizeof(ion_dictionary_scan_t));
+	scan->dictionary		= dictionary;
+	scan->filter.dictionary = dictionary;
+	scan->filter.predicate	= predicate;
+	scan->filter.status		= cs_cursor_active;
+	scan->error				= err_ok;
+
+	error					= dictionary->handler->scan_extent(dictionary, &scan->num_positions, &position_size);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+#if ION_THREAD_SAFE
+
+	if (num_workers > ION_SCAN_MAX_WORKERS) {
+		num_workers = ION_SCAN_MAX_WORKERS;
+	}
+
+	if (num_workers < 1) {
+		num_workers = 1;
+	}
+
+#else
+	/* Every range is read on the calling thread anyway. */
+	num_workers = 1;
+#endif
+
+	/* Read whole positions only. */
+	if (buffer_size < position_size) {
+		buffer_size = position_size;
+	}
+
+	if (0 < position_size) {
+		buffer_size -= buffer_size % position_size;
+	}
+
+	if (0 < scan->num_positions) {
+		scan->num_ranges = num_workers * ION_SCAN_RANGES_PER_WORKER;
+
+		if (scan->num_ranges > scan->num_positions) {
+			scan->num_ranges = scan->num_positions;
+		}
+
+		scan->range_size	= (scan->num_positions + scan->num_ranges - 1) / scan->num_ranges;
+		scan->num_ranges	= (scan->num_positions + scan->range_size - 1) / scan->range_size;
+	}
+
+	scan->num_workers	= num_workers;
+	scan->workers		= calloc(num_workers, sizeof(ion_dictionary_scan_worker_t));
+	scan->buffers		= malloc(num_workers * buffer_size);
+
+	if ((NULL == scan->workers) || (NULL == scan->buffers)) {
+		free(scan->workers);
+		free(scan->buffers);
+		return err_out_of_memory;
+	}
+
+	for (i = 0; i < num_workers; i++) {
+		scan->workers[i].scan				= scan;
+		scan->workers[i].index				= i;
+		scan->workers[i].in_range			= boolean_false;
+		scan->workers[i].range.filter		= &scan->filter;
+		scan->workers[i].range.buffer		= scan->buffers + i * buffer_size;
+		scan->workers[i].range.buffer_size	= buffer_size;
+		scan->workers[i].range.emit			= emit;
+		scan->workers[i].range.worker		= &scan->workers[i];
+	}
+
+	ION_MUTEX_INIT(scan->lock);
+	ION_COND_INIT(scan->changed);
+
+	return err_ok;
+}
+
+/**
+@brief		Frees what @ref dictionary_scan_initialize allocated.
+@param		scan
+				A scan whose workers have all finished.
+*/
+static void
+dictionary_scan_free(
+	ion_dictionary_scan_t *scan
+) {
+	ION_COND_DESTROY(scan->changed);
+	ION_MUTEX_DESTROY(scan->lock);
+	free(scan->queue);
+	free(scan->buffers);
+	free(scan->workers);
+}
+
+ion_boolean_t
+dictionary_scan_emit(
+	ion_dictionary_scan_range_t *range,
+	ion_key_t					key,
+	ion_value_t					value
+) {
+	ion_record_t record;
+
+	if (!test_predicate(range->filter, key)) {
+		return boolean_true;
+	}
+
+	record.key		= key;
+	record.value	= value;
+
+	return range->emit(range, &record);
+}
+
+ion_err_t
+dictionary_parallel_scan(
+	ion_dictionary_t				*dictionary,
+	ion_predicate_t					*predicate,
+	int								num_workers,
+	ion_dictionary_scan_callback_t	callback,
+	void							*context
+) {
+	ion_dictionary_scan_t	scan;
+	ion_err_t				error;
+
+	ION_RWLOCK_READ(dictionary->lock);
+
+	error = dictionary_scan_initialize(&scan, dictionary, predicate, num_workers, dictionary_scan_emit_callback);
+
+	if (err_ok != error) {
+		ION_RWLOCK_UNLOCK(dictionary->lock);
+		return error;
+	}
+
+	scan.callback	= callback;
+	scan.context	= context;
+
+#if ION_THREAD_SAFE
+	/* The calling thread works as well, so a failure to start any thread
+	   only slows the scan down. */
+	dictionary_scan_start_threads(&scan, 1);
+#endif
+
+	while (dictionary_scan_step(&scan.workers[0])) {}
+
+#if ION_THREAD_SAFE
+	dictionary_scan_join_threads(&scan, 1);
+#endif
+
+	error = scan.error;
+	dictionary_scan_free(&scan);
+
+	ION_RWLOCK_UNLOCK(dictionary->lock);
+
+	return error;
+}
+
+/**
+@brief		Fetches the next record merged from the workers of a parallel
+			scan.
+@param		cursor
+				The cursor to fetch from.
+@param		record
+				Where the key and value are copied to.
+@returns	The status of the cursor.
+*/
+static ion_cursor_status_t
+dictionary_scan_next(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*record
+) {
+	ion_dictionary_scan_t	*scan		= &((ion_dictionary_scan_cursor_t *) cursor)->scan;
+	ion_key_size_t			key_size	= cursor->dictionary->instance->record.key_size;
+	ion_value_size_t		value_size	= cursor->dictionary->instance->record.value_size;
+	ion_byte_t				*slot;
+
+	if ((cs_cursor_initialized != cursor->status) && (cs_cursor_active != cursor->status)) {
+		return cursor->status;
+	}
+
+	ION_MUTEX_LOCK(scan->lock);
+
+#if ION_THREAD_SAFE
+
+	while ((0 == scan->queue_count) && (0 < scan->active)) {
+		ION_COND_WAIT(scan->changed, scan->lock);
+	}
+
+#else
+
+	while ((0 == scan->queue_count) && dictionary_scan_step(&scan->workers[0])) {}
+
+#endif
+
+	if (0 == scan->queue_count) {
+		ION_MUTEX_UNLOCK(scan->lock);
+		cursor->status = err_ok == scan->error ? cs_end_of_results : cs_possible_data_inconsistency;
+		return cursor->status;
+	}
+
+	slot = scan->queue + scan->queue_head * (key_size + value_size);
+	memcpy(record->key, slot, key_size);
+	memcpy(record->value, slot + key_size, value_size);
+	scan->queue_head = (scan->queue_head + 1) % scan->queue_capacity;
+	scan->queue_count--;
+
+	ION_COND_BROADCAST(scan->changed);
+	ION_MUTEX_UNLOCK(scan->lock);
+
+	cursor->status = cs_cursor_active;
+	return cursor->status;
+}
+
+/**
+@brief		Stops the workers of a parallel scan cursor and destroys it.
+@param		cursor
+				The cursor to destroy.
+*/
+static void
+dictionary_scan_destroy_cursor(
+	ion_dict_cursor_t **cursor
+) {
+	ion_dictionary_scan_t *scan = &((ion_dictionary_scan_cursor_t *) *cursor)->scan;
+
+	ION_MUTEX_LOCK(scan->lock);
+	ION_ATOMIC_STORE(&scan->stopped, boolean_true);
+	ION_COND_BROADCAST(scan->changed);
+	ION_MUTEX_UNLOCK(scan->lock);
+
+#if ION_THREAD_SAFE
+	dictionary_scan_join_threads(scan, 0);
+#endif
+
+	ION_RWLOCK_UNLOCK((*cursor)->dictionary->lock);
+
+	(*cursor)->predicate->destroy(&(*cursor)->predicate);
+	dictionary_scan_free(scan);
+	free(*cursor);
+	*cursor = NULL;
+}
+
+/**
+@brief		Copies a predicate, keys included, for a cursor to keep.
+@param		predicate
+				The predicate to copy.
+@param		key_size
+				The size of the keys in the predicate.
+@param		copy
+				Set to the copy, to be freed by its own @c destroy.
+@returns	An error code describing the result of the operation.
+*/
+static ion_err_t
+dictionary_scan_copy_predicate(
+	ion_predicate_t *predicate,
+	ion_key_size_t	key_size,
+	ion_predicate_t **copy
+) {
+	*copy = malloc(sizeof(ion_predicate_t));
+
+	if (NULL == *copy) {
+		return err_out_of_memory;
+	}
+
+	(*copy)->type		= predicate->type;
+	(*copy)->destroy	= predicate->destroy;
+
+	switch (predicate->type) {
+		case predicate_equality: {
+			(*copy)->statement.equality.equality_value = malloc(key_size);
+
+			if (NULL == (*copy)->statement.equality.equality_value) {
+				free(*copy);
+				return err_out_of_memory;
+			}
+
+			memcpy((*copy)->statement.equality.equality_value, predicate->statement.equality.equality_value, key_size);
+			break;
+		}
+
+		case predicate_range: {
+			(*copy)->statement.range.lower_bound	= malloc(key_size);
+			(*copy)->statement.range.upper_bound	= malloc(key_size);
+
+			if ((NULL == (*copy)->statement.range.lower_bound) || (NULL == (*copy)->statement.range.upper_bound)) {
+				free((*copy)->statement.range.lower_bound);
+				free((*copy)->statement.range.upper_bound);
+				free(*copy);
+				return err_out_of_memory;
+			}
+
+			memcpy((*copy)->statement.range.lower_bound, predicate->statement.range.lower_bound, key_size);
+			memcpy((*copy)->statement.range.upper_bound, predicate->statement.range.upper_bound, key_size);
+			break;
+		}
+
+		case predicate_all_records: {
+			break;
+		}
+
+		default: {
+			free(*copy);
+			return err_invalid_predicate;
+		}
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+dictionary_parallel_find(
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	int					num_workers,
+	ion_dict_cursor_t	**cursor
+) {
+	ion_dictionary_scan_cursor_t	*scan_cursor;
+	ion_dictionary_scan_t			*scan;
+	ion_predicate_t					*copy;
+	ion_err_t						error;
+	size_t							record_size = dictionary->instance->record.key_size + dictionary->instance->record.value_size;
+
+	error = dictionary_scan_copy_predicate(predicate, dictionary->instance->record.key_size, &copy);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	scan_cursor = malloc(sizeof(ion_dictionary_scan_cursor_t));
+
+	if (NULL == scan_cursor) {
+		copy->destroy(&copy);
+		return err_out_of_memory;
+	}
+
+	scan = &scan_cursor->scan;
+
+	ION_RWLOCK_READ(dictionary->lock);
+
+	error = dictionary_scan_initialize(scan, dictionary, copy, num_workers, dictionary_scan_emit_queue);
+
+	if (err_ok != error) {
+		ION_RWLOCK_UNLOCK(dictionary->lock);
+		copy->destroy(&copy);
+		free(scan_cursor);
+		return error;
+	}
+
+	/* One buffer of positions never holds more records than this. */
+	scan->queue_capacity	= scan->workers[0].range.buffer_size / record_size;
+
+	if (scan->queue_capacity < 1) {
+		scan->queue_capacity = 1;
+	}
+
+	scan->queue				= malloc(scan->queue_capacity * record_size);
+
+	if (NULL == scan->queue) {
+		error = err_out_of_memory;
+	}
+
+#if ION_THREAD_SAFE
+	else {
+		scan->active	= scan->num_workers;
+		error			= dictionary_scan_start_threads(scan, 0);
+
+		/* Workers that failed to start will never finish. */
+		ION_MUTEX_LOCK(scan->lock);
+		scan->active -= scan->num_workers - scan->num_threads;
+		ION_MUTEX_UNLOCK(scan->lock);
+	}
+#endif
+
+	if (err_ok != error) {
+		dictionary_scan_free(scan);
+		ION_RWLOCK_UNLOCK(dictionary->lock);
+		copy->destroy(&copy);
+		free(scan_cursor);
+		return error;
+	}
+
+	scan_cursor->super.status		= cs_cursor_initialized;
+	scan_cursor->super.dictionary	= dictionary;
+	scan_cursor->super.predicate	= copy;
+	scan_cursor->super.next			= dictionary_scan_next;
+	scan_cursor->super.next_batch	= NULL;
+	scan_cursor->super.destroy		= dictionary_scan_destroy_cursor;
+
+	*cursor							= &scan_cursor->super;
+
+	return err_ok;
+}
@@ -0,0 +1,292 @@
+/******************************************************************************/
+/**
+@file		dictionary_scan.h
+@author		IonDB Project
+@brief		Parallel full scans over the rows, slots or buckets of a
+			dictionary.
+@details	A dictionary that supports parallel scans numbers the places
+			its records live in, its positions, and reads any range of them
+			on request. A scan splits the positions into ranges, and a pool
+			of workers claims the ranges one at a time, each reading through
+			its own I/O buffer. Matching records are either handed to a
+			callback together with the worker that found them, or merged
+			into a single cursor.
+
+			Workers are threads in builds with @c ION_THREAD_SAFE. Other
+			builds read every range on the calling thread.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(DICTIONARY_SCAN_H_)
+#define DICTIONARY_SCAN_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "../key_value/kv_system.h"
+#include "dictionary_types.h"
+
+#if !defined(ION_SCAN_BUFFER_SIZE)
+/**
+@brief		Size in bytes of the I/O buffer of each worker, unless a single
+			position takes more to read.
+*/
+#define ION_SCAN_BUFFER_SIZE		4096
+#endif
+
+#if !defined(ION_SCAN_MAX_WORKERS)
+/**
+@brief		Most workers a scan runs, whatever it is asked for.
+*/
+#define ION_SCAN_MAX_WORKERS		64
+#endif
+
+#if !defined(ION_SCAN_RANGES_PER_WORKER)
+/**
+@brief		How many ranges the positions are split into for each worker,
+			so that workers finishing early take over the ranges left.
+*/
+#define ION_SCAN_RANGES_PER_WORKER	4
+#endif
+
+/**
+@brief		Takes a record found by a parallel scan.
+@details	Workers call this at the same time, so anything shared between
+			them must be synchronized; state kept per @p worker need not be.
+			The record is only valid until the callback returns.
+@param		record
+				The matching record.
+@param		worker
+				Which worker found the record, from zero to one less than
+				the number of workers.
+@param		context
+				The context given to @ref dictionary_parallel_scan.
+@returns	@c boolean_false to stop the scan, otherwise @c boolean_true.
+*/
+typedef ion_boolean_t (*ion_dictionary_scan_callback_t)(
+	ion_record_t	*record,
+	int				worker,
+	void			*context
+);
+
+/**
+@brief		A range of positions being read by one worker.
+@details	This is all a handler sees of a scan. Its @c scan_range reads
+			the next buffer of the range into @c buffer, passes each
+			occupied record to @ref dictionary_scan_emit and advances
+			@c position past what it has read.
+*/
+struct dictionary_scan_range {
+	ion_dict_cursor_t	*filter;		/**< Carries the dictionary and
+											 predicate of the scan, for
+											 @ref test_predicate. */
+	ion_fpos_t			position;		/**< The next position to read. */
+	ion_fpos_t			end;			/**< One past the last position of
+											 the range. */
+	ion_fpos_t			resume;			/**< Where the handler carries on
+											 within @c position, or -1 to
+											 start it afresh. */
+	ion_byte_t			*buffer;		/**< The worker's own I/O buffer. */
+	size_t				buffer_size;	/**< Bytes in @c buffer, at least the
+											 size of one position. */
+	ion_boolean_t (*emit)(
+		ion_dictionary_scan_range_t *,
+		ion_record_t *
+	);
+	/**< Takes each matching record, returning
+		 @c boolean_false once the scan is to stop. */
+	void *worker;
+	/**< The worker reading the range. */
+};
+
+/**
+@brief		The state of a parallel scan.
+@see		dictionary_scan
+*/
+typedef struct dictionary_scan ion_dictionary_scan_t;
+
+/**
+@brief		One worker of a parallel scan.
+*/
+typedef struct {
+	ion_dictionary_scan_t		*scan;		/**< The scan the worker belongs to. */
+	int							index;		/**< Which worker this is. */
+	ion_dictionary_scan_range_t range;		/**< The range being read. */
+	ion_boolean_t				in_range;	/**< Whether @c range has been
+												 claimed. */
+#if ION_THREAD_SAFE
+	pthread_t					thread;		/**< The thread running the
+												 worker. */
+#endif
+} ion_dictionary_scan_worker_t;
+
+/**
+@brief		The state of a parallel scan.
+*/
+struct dictionary_scan {
+	ion_dictionary_t				*dictionary;	/**< The dictionary being
+														 scanned. */
+	ion_dict_cursor_t				filter;			/**< See
+														 @ref dictionary_scan_range. */
+	ion_fpos_t						num_positions;	/**< Positions in the
+														 dictionary. */
+	ion_fpos_t						range_size;		/**< Positions per range. */
+	int								num_ranges;		/**< Ranges to claim. */
+	int								next_range;		/**< The next range to
+														 claim. */
+	int								stopped;		/**< Whether the scan is
+														 to stop. */
+	ion_err_t						error;			/**< The first error met by
+														 a worker. */
+	int								num_workers;	/**< Entries in
+														 @c workers. */
+	int								num_threads;	/**< Workers started on
+														 threads of their own. */
+	ion_dictionary_scan_worker_t	*workers;		/**< The workers. */
+	ion_byte_t						*buffers;		/**< The I/O buffers of
+														 every worker. */
+	ion_dictionary_scan_callback_t	callback;		/**< Takes the records, or
+														 @c NULL to queue
+														 them for a cursor. */
+	void							*context;		/**< Passed to
+														 @c callback. */
+	ion_byte_t						*queue;			/**< Records waiting for
+														 the cursor, as keys
+														 followed by values. */
+	int								queue_capacity;	/**< Records @c queue
+														 has room for. */
+	int								queue_head;		/**< The oldest record in
+														 @c queue. */
+	int								queue_count;	/**< Records in
+														 @c queue. */
+	int								active;			/**< Workers still
+														 reading. */
+#if ION_THREAD_SAFE
+	ion_mutex_t						lock;			/**< Guards the queue. */
+	ion_cond_t						changed;		/**< Signalled whenever the
+														 queue changes or a
+														 worker finishes. */
+#endif
+};
+
+/**
+@brief		A cursor merging the records found by every worker of a
+			parallel scan.
+*/
+typedef struct {
+	ion_dict_cursor_t		super;	/**< Supertype of the cursor. */
+	ion_dictionary_scan_t	scan;	/**< The scan feeding the cursor. */
+} ion_dictionary_scan_cursor_t;
+
+/**
+@brief		Passes a record to a scan if it satisfies the scan's predicate.
+@details	Called by handlers from their @c scan_range, for occupied
+			records only.
+@param		range
+				The range being read.
+@param		key
+				The key of the record.
+@param		value
+				The value of the record.
+@returns	@c boolean_false once the scan is to stop, in which case the
+			handler returns straight away.
+*/
+ion_boolean_t
+dictionary_scan_emit(
+	ion_dictionary_scan_range_t *range,
+	ion_key_t					key,
+	ion_value_t					value
+);
+
+/**
+@brief		Scans a dictionary with a pool of workers, passing each record
+			that satisfies a predicate to a callback.
+@details	Records come in no particular order. The dictionary is held as
+			a reader until the scan has finished.
+@param		dictionary
+				The dictionary to scan.
+@param		predicate
+				Which records to pass on, built by
+				@ref dictionary_build_predicate.
+@param		num_workers
+				How many workers to read with. Clamped to between one and
+				@ref ION_SCAN_MAX_WORKERS, and to one without
+				@c ION_THREAD_SAFE.
+@param		callback
+				Takes each matching record.
+@param		context
+				Passed to @p callback.
+@returns	@c err_not_implemented if the dictionary cannot be scanned in
+			parallel, otherwise an error code describing the result of the
+			scan. Stopping the scan from @p callback is not an error.
+*/
+ion_err_t
+dictionary_parallel_scan(
+	ion_dictionary_t				*dictionary,
+	ion_predicate_t					*predicate,
+	int								num_workers,
+	ion_dictionary_scan_callback_t	callback,
+	void							*context
+);
+
+/**
+@brief		Scans a dictionary with a pool of workers, merging the records
+			that satisfy a predicate into a cursor.
+@details	Records come in no particular order. Workers stay a bounded
+			number of records ahead of the cursor. Like any cursor, this
+			one holds the dictionary as a reader until it is destroyed.
+@param		dictionary
+				The dictionary to scan.
+@param		predicate
+				Which records to return, built by
+				@ref dictionary_build_predicate. The cursor keeps a copy.
+@param		num_workers
+				As for @ref dictionary_parallel_scan.
+@param		cursor
+				Set to the new cursor.
+@returns	@c err_not_implemented if the dictionary cannot be scanned in
+			parallel, otherwise an error code describing the result of the
+			operation.
+*/
+ion_err_t
+dictionary_parallel_find(
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	int					num_workers,
+	ion_dict_cursor_t	**cursor
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DICTIONARY_SCAN_H_ */
@@ -0,0 +1,384 @@
+/******************************************************************************/
+/**
+@file		dictionary_stats.c
+@author		IonDB Project
+@brief		Implementation of per-dictionary latency histograms.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+/* Needed for clock_gettime; must come before any system header. */
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "dictionary_stats.h"
+
+#if ION_DICTIONARY_STATS
+
+#include <time.h>
+
+/**
+@brief		Maps a latency to its bucket.
+*/
+static uint32_t
+dictionary_stats_bucket(
+	uint64_t value
+) {
+	uint32_t msb;
+
+	if (value < (1u << ION_STATS_SUB_BUCKET_BITS)) {
+		return (uint32_t) value;
+	}
+
+	if (value >= ((uint64_t) 1 << ION_STATS_MAX_BITS)) {
+		return ION_STATS_NUM_BUCKETS - 1;
+	}
+
+	for (msb = ION_STATS_SUB_BUCKET_BITS; (value >> (msb + 1)) != 0; msb++) {}
+
+	return ((msb - ION_STATS_SUB_BUCKET_BITS + 1) << ION_STATS_SUB_BUCKET_BITS) + (uint32_t) ((value >> (msb - ION_STATS_SUB_BUCKET_BITS)) & ((1u << ION_STATS_SUB_BUCKET_BITS) - 1));
+}
+
+/**
+@brief		Returns the midpoint of the range of latencies in a bucket.
+*/
+static uint64_t
+dictionary_stats_bucket_value(
+	uint32_t bucket
+) {
+	uint32_t	group	= bucket >> ION_STATS_SUB_BUCKET_BITS;
+	uint64_t	sub		= bucket & ((1u << ION_STATS_SUB_BUCKET_BITS) - 1);
+	uint32_t	shift;
+
+	if (0 == group) {
+		return sub;
+	}
+
+	shift = group - 1;
+
+	return (((1u << ION_STATS_SUB_BUCKET_BITS) + sub) << shift) + (((uint64_t) 1 << shift) >> 1);
+}
+
+/**
+@brief		Finds the latency below which @p per_mille thousandths of the
+			samples fall.
+*/
+static uint64_t
+dictionary_stats_percentile(
+	ion_stats_histogram_t	*histogram,
+	uint32_t				per_mille
+) {
+	uint64_t	target;
+	uint64_t	seen = 0;
+	uint32_t	bucket;
+
+	if (0 == histogram->count) {
+		return 0;
+	}
+
+	/* Rank of the sample, rounded up, counting from one. */
+	target = ((uint64_t) histogram->count * per_mille + 999) / 1000;
+
+	for (bucket = 0; bucket < ION_STATS_NUM_BUCKETS; bucket++) {
+		seen += histogram->buckets[bucket];
+
+		if (seen >= target) {
+			break;
+		}
+	}
+
+	/* The exact maximum is a tighter answer for the top bucket. */
+	if (dictionary_stats_bucket_value(bucket) > histogram->max_ns) {
+		return histogram->max_ns;
+	}
+
+	return dictionary_stats_bucket_value(bucket);
+}
+
+/**
+@brief		Cursor @c next installed by @ref dictionary_find on cursors of
+			dictionaries with statistics enabled.
+*/
+static ion_cursor_status_t
+dictionary_stats_cursor_next(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*record
+) {
+	ion_dictionary_stats_t	*stats = cursor->stats;
+	ion_stats_span_t		span;
+	ion_cursor_status_t (*next)(
+		ion_dict_cursor_t *,
+		ion_record_t *
+	);
+
+	ION_MUTEX_LOCK(stats->lock);
+	next = stats->cursor_next;
+	ION_MUTEX_UNLOCK(stats->lock);
+
+	dictionary_stats_begin(stats, &span);
+
+	ion_cursor_status_t status = next(cursor, record);
+
+	dictionary_stats_record(stats, ion_stats_cursor_next, &span);
+
+	return status;
+}
+
+uint64_t
+dictionary_stats_now(
+	void
+) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+void
+dictionary_stats_begin(
+	ion_dictionary_stats_t	*stats,
+	ion_stats_span_t		*span
+) {
+#if ION_FILE_STATS
+
+	if (NULL != stats->owner_io) {
+		ion_file_stats_copy(&span->io_before, stats->owner_io);
+	}
+
+#else
+	UNUSED(stats);
+#endif
+	span->start = dictionary_stats_now();
+}
+
+void
+dictionary_stats_record(
+	ion_dictionary_stats_t	*stats,
+	ion_stats_op_t			op,
+	ion_stats_span_t		*span
+) {
+	ion_stats_histogram_t	*histogram	= &stats->histograms[op];
+	uint64_t				elapsed		= dictionary_stats_now() - span->start;
+
+#if ION_FILE_STATS
+	ion_file_io_stats_t io_after;
+
+	if (NULL != stats->owner_io) {
+		ion_file_stats_copy(&io_after, stats->owner_io);
+	}
+
+#endif
+
+	ION_MUTEX_LOCK(stats->lock);
+
+#if ION_FILE_STATS
+
+	if (NULL != stats->owner_io) {
+		ion_file_stats_accumulate(&stats->io[op], &io_after, &span->io_before);
+	}
+
+#endif
+
+	histogram->buckets[dictionary_stats_bucket(elapsed)]++;
+	histogram->count++;
+
+	if (elapsed > histogram->max_ns) {
+		histogram->max_ns = elapsed;
+	}
+
+	ION_MUTEX_UNLOCK(stats->lock);
+}
+
+/* Every cursor of an implementation shares the same next, so one saved
+   pointer per dictionary is enough. */
+void
+dictionary_stats_track_cursor(
+	ion_dictionary_stats_t	*stats,
+	ion_dict_cursor_t		*cursor
+) {
+	ION_MUTEX_LOCK(stats->lock);
+	stats->num_references++;
+
+	if (dictionary_stats_cursor_next != cursor->next) {
+		stats->cursor_next	= cursor->next;
+		cursor->next		= dictionary_stats_cursor_next;
+	}
+
+	ION_MUTEX_UNLOCK(stats->lock);
+	cursor->stats = stats;
+}
+
+void
+dictionary_stats_release(
+	ion_dictionary_stats_t *stats
+) {
+	ION_MUTEX_LOCK(stats->lock);
+
+	unsigned int num_references = --stats->num_references;
+
+	ION_MUTEX_UNLOCK(stats->lock);
+
+	if (0 == num_references) {
+		ION_MUTEX_DESTROY(stats->lock);
+		free(stats);
+	}
+}
+
+ion_err_t
+dictionary_enable_stats(
+	ion_dictionary_t *dictionary
+) {
+	if (NULL != dictionary->stats) {
+		return err_ok;
+	}
+
+	dictionary->stats = calloc(1, sizeof(ion_dictionary_stats_t));
+
+	if (NULL == dictionary->stats) {
+		return err_out_of_memory;
+	}
+
+#if ION_FILE_STATS
+	/* Without counters the operations are still timed, just not charged
+	   any I/O. */
+	dictionary->stats->owner_io = ion_file_owner_stats(dictionary->instance->id);
+#endif
+	dictionary->stats->num_references = 1;
+	ION_MUTEX_INIT(dictionary->stats->lock);
+
+	return err_ok;
+}
+
+void
+dictionary_disable_stats(
+	ion_dictionary_t *dictionary
+) {
+	ion_dictionary_stats_t *stats = dictionary->stats;
+
+	/* Open cursors still hold the statistics, the last of them frees them. */
+	dictionary->stats = NULL;
+
+	if (NULL != stats) {
+		dictionary_stats_release(stats);
+	}
+}
+
+void
+dictionary_reset_stats(
+	ion_dictionary_t *dictionary
+) {
+	if (NULL != dictionary->stats) {
+		ION_MUTEX_LOCK(dictionary->stats->lock);
+		memset(dictionary->stats->histograms, 0, sizeof(dictionary->stats->histograms));
+#if ION_FILE_STATS
+		memset(dictionary->stats->io, 0, sizeof(dictionary->stats->io));
+#endif
+		ION_MUTEX_UNLOCK(dictionary->stats->lock);
+	}
+}
+
+ion_err_t
+dictionary_get_stats(
+	ion_dictionary_t	*dictionary,
+	ion_stats_op_t		op,
+	ion_stats_summary_t *summary
+) {
+	ion_stats_histogram_t *histogram;
+
+	if ((NULL == dictionary->stats) || (op >= ion_stats_num_ops)) {
+		return err_uninitialized;
+	}
+
+	ION_MUTEX_LOCK(dictionary->stats->lock);
+
+	histogram			= &dictionary->stats->histograms[op];
+	summary->count		= histogram->count;
+	summary->p50_ns		= dictionary_stats_percentile(histogram, 500);
+	summary->p99_ns		= dictionary_stats_percentile(histogram, 990);
+	summary->p999_ns	= dictionary_stats_percentile(histogram, 999);
+	summary->max_ns		= histogram->max_ns;
+
+	ION_MUTEX_UNLOCK(dictionary->stats->lock);
+
+	return err_ok;
+}
+
+#if ION_FILE_STATS
+
+ion_err_t
+dictionary_get_op_io_stats(
+	ion_dictionary_t	*dictionary,
+	ion_stats_op_t		op,
+	ion_file_io_stats_t *io
+) {
+	if ((NULL == dictionary->stats) || (op >= ion_stats_num_ops)) {
+		return err_uninitialized;
+	}
+
+	ION_MUTEX_LOCK(dictionary->stats->lock);
+	*io = dictionary->stats->io[op];
+	ION_MUTEX_UNLOCK(dictionary->stats->lock);
+
+	return err_ok;
+}
+
+#endif /* Clause ION_FILE_STATS */
+
+void
+dictionary_print_stats(
+	ion_dictionary_t *dictionary
+) {
+	static const char	*names[ion_stats_num_ops] = {
+		"insert", "get", "update", "delete", "find", "cursor_next"
+	};
+	ion_stats_summary_t summary;
+	int					op;
+
+	for (op = 0; op < ion_stats_num_ops; op++) {
+		if (err_ok != dictionary_get_stats(dictionary, (ion_stats_op_t) op, &summary)) {
+			return;
+		}
+
+		printf("%-12s count=%lu p50=%.3fus p99=%.3fus p999=%.3fus max=%.3fus", names[op], (unsigned long) summary.count, summary.p50_ns / 1000.0, summary.p99_ns / 1000.0, summary.p999_ns / 1000.0, summary.max_ns / 1000.0);
+#if ION_FILE_STATS
+		{
+			ion_file_io_stats_t io;
+
+			dictionary_get_op_io_stats(dictionary, (ion_stats_op_t) op, &io);
+			printf(" reads=%lu writes=%lu seeks=%lu read=%luB written=%luB", (unsigned long) io.reads, (unsigned long) io.writes, (unsigned long) io.seeks, (unsigned long) io.bytes_read, (unsigned long) io.bytes_written);
+		}
+#endif
+		printf("\n");
+	}
+}
+
+#endif /* Clause ION_DICTIONARY_STATS */
@@ -0,0 +1,337 @@
+/******************************************************************************/
+/**
+@file		dictionary_stats.h
+@author		IonDB Project
+@brief		Per-dictionary, per-operation latency histograms.
+@details	Each histogram is log-linear in the style of HdrHistogram:
+			values below 2^@ref ION_STATS_SUB_BUCKET_BITS nanoseconds are
+			counted exactly, and every power of two above that is split
+			into 2^@ref ION_STATS_SUB_BUCKET_BITS equal buckets, bounding the
+			relative error of any reported percentile.
+
+			Statistics are compiled in when @ref ION_DICTIONARY_STATS is
+			nonzero and then enabled per dictionary with
+			@ref dictionary_enable_stats. A dictionary without statistics
+			pays a single null check per operation; with
+			@ref ION_DICTIONARY_STATS set to zero the instrumentation is
+			compiled out entirely.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(DICTIONARY_STATS_H_)
+#define DICTIONARY_STATS_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "../key_value/kv_system.h"
+#include "dictionary_types.h"
+#include "../file/ion_file_stats.h"
+
+#if ION_DICTIONARY_STATS
+
+/**
+@brief		Number of bits of precision kept within each power of two.
+*/
+#define ION_STATS_SUB_BUCKET_BITS	3
+
+/**
+@brief		Latencies of 2^ION_STATS_MAX_BITS nanoseconds (about 68 seconds)
+			and above are counted in the last bucket.
+*/
+#define ION_STATS_MAX_BITS			36
+
+/**
+@brief		Number of buckets in a histogram.
+*/
+#define ION_STATS_NUM_BUCKETS		((ION_STATS_MAX_BITS - ION_STATS_SUB_BUCKET_BITS + 1) << ION_STATS_SUB_BUCKET_BITS)
+
+/**
+@brief		The operations that are timed.
+*/
+typedef enum {
+	ion_stats_insert,		/**< @ref dictionary_insert. */
+	ion_stats_get,			/**< @ref dictionary_get, or one call to
+								 @ref dictionary_get_many. */
+	ion_stats_update,		/**< @ref dictionary_update. */
+	ion_stats_delete,		/**< @ref dictionary_delete. */
+	ion_stats_find,			/**< @ref dictionary_find. */
+	ion_stats_cursor_next,	/**< A cursor's @c next, or one call to
+								 @ref dictionary_cursor_next_batch on a
+								 cursor with a native batch function. */
+	ion_stats_num_ops		/**< Number of timed operations. */
+} ion_stats_op_t;
+
+/**
+@brief		A latency histogram of one operation.
+*/
+typedef struct {
+	uint32_t	buckets[ION_STATS_NUM_BUCKETS];	/**< Samples per bucket. */
+	uint32_t	count;							/**< Total samples. */
+	uint64_t	max_ns;							/**< Largest sample. */
+} ion_stats_histogram_t;
+
+/**
+@brief		Statistics of one dictionary.
+*/
+struct dictionary_stats {
+	ion_stats_histogram_t	histograms[ion_stats_num_ops];	/**< One per operation. */
+	ion_cursor_status_t (*cursor_next)(
+		ion_dict_cursor_t *,
+		ion_record_t *
+	);
+	/**< The implementation's cursor @c next, which timed cursors call
+		 through. */
+#if ION_FILE_STATS
+	ion_file_io_stats_t		io[ion_stats_num_ops];	/**< File I/O caused by each operation. */
+	ion_file_io_stats_t		*owner_io;				/**< The dictionary's counters in the file layer. */
+#endif
+	unsigned int			num_references;			/**< The dictionary's reference, if
+														 it still has the statistics,
+														 plus one per open cursor. */
+#if ION_THREAD_SAFE
+	ion_mutex_t				lock;					/**< Guards everything above, since
+														 readers record concurrently. */
+#endif
+};
+
+/**
+@brief		An operation being timed.
+*/
+typedef struct {
+	uint64_t			start;		/**< When the operation began. */
+#if ION_FILE_STATS
+	ion_file_io_stats_t io_before;	/**< Snapshot of the dictionary's
+										 counters in the file layer when
+										 the operation began. In
+										 thread-safe builds, I/O of
+										 concurrent operations on the
+										 same dictionary is charged to
+										 each of them. */
+#endif
+} ion_stats_span_t;
+
+/**
+@brief		Percentiles read from a histogram, in nanoseconds.
+@details	Percentiles are reported as the midpoint of the bucket they
+			fall in.
+*/
+typedef struct {
+	uint32_t	count;	/**< Number of samples. */
+	uint64_t	p50_ns;	/**< Median. */
+	uint64_t	p99_ns;	/**< 99th percentile. */
+	uint64_t	p999_ns;/**< 99.9th percentile. */
+	uint64_t	max_ns;	/**< Largest sample, exact. */
+} ion_stats_summary_t;
+
+/**
+@brief		Returns a monotonic timestamp in nanoseconds.
+*/
+uint64_t
+dictionary_stats_now(
+	void
+);
+
+/**
+@brief		Marks the start of an operation.
+@param		stats
+				The statistics of the dictionary the operation runs on.
+@param		span
+				Written with what @ref dictionary_stats_record needs.
+*/
+void
+dictionary_stats_begin(
+	ion_dictionary_stats_t	*stats,
+	ion_stats_span_t		*span
+);
+
+/**
+@brief		Adds the time elapsed since @p start to an operation's histogram,
+			and the file I/O done since then to the operation's I/O.
+@param		stats
+				The statistics to record into.
+@param		op
+				The operation that was timed.
+@param		span
+				Filled in by @ref dictionary_stats_begin.
+*/
+void
+dictionary_stats_record(
+	ion_dictionary_stats_t	*stats,
+	ion_stats_op_t			op,
+	ion_stats_span_t		*span
+);
+
+/**
+@brief		Routes a new cursor's @c next through the statistics so that
+			every call is timed, and has the cursor hold a reference to
+			them.
+@param		stats
+				The statistics of the cursor's dictionary.
+@param		cursor
+				A cursor just returned by the implementation's @c find.
+*/
+void
+dictionary_stats_track_cursor(
+	ion_dictionary_stats_t	*stats,
+	ion_dict_cursor_t		*cursor
+);
+
+/**
+@brief		Drops a reference to statistics, freeing them with the last one.
+@param		stats
+				The statistics.
+*/
+void
+dictionary_stats_release(
+	ion_dictionary_stats_t *stats
+);
+
+/**
+@brief		Starts collecting statistics for a dictionary.
+@details	Statistics live in memory only and are discarded when the
+			dictionary is closed or deleted. Cursors opened while
+			statistics are enabled keep recording into them until they
+			are destroyed, even once statistics have been disabled.
+@param		dictionary
+				An open dictionary.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+dictionary_enable_stats(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Stops collecting statistics for a dictionary, and frees them once
+			no open cursor holds them.
+@param		dictionary
+				The dictionary.
+*/
+void
+dictionary_disable_stats(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Clears all histograms of a dictionary.
+@param		dictionary
+				A dictionary with statistics enabled.
+*/
+void
+dictionary_reset_stats(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Reads the percentiles of one operation.
+@param		dictionary
+				A dictionary with statistics enabled.
+@param		op
+				The operation to summarize.
+@param		summary
+				Written with the percentiles.
+@returns	@c err_uninitialized if statistics are not enabled, otherwise
+			@c err_ok.
+*/
+ion_err_t
+dictionary_get_stats(
+	ion_dictionary_t	*dictionary,
+	ion_stats_op_t		op,
+	ion_stats_summary_t *summary
+);
+
+#if ION_FILE_STATS
+
+/**
+@brief		Reads the file I/O caused by one operation since statistics were
+			enabled or last reset.
+@param		dictionary
+				A dictionary with statistics enabled.
+@param		op
+				The operation.
+@param		io
+				Written with the counters.
+@returns	@c err_uninitialized if statistics are not enabled, otherwise
+			@c err_ok.
+*/
+ion_err_t
+dictionary_get_op_io_stats(
+	ion_dictionary_t	*dictionary,
+	ion_stats_op_t		op,
+	ion_file_io_stats_t *io
+);
+
+#endif /* Clause ION_FILE_STATS */
+
+/**
+@brief		Prints a line per operation with its count, p50, p99, p99.9 and
+			maximum latency in microseconds, and the file I/O it caused.
+@param		dictionary
+				A dictionary with statistics enabled.
+*/
+void
+dictionary_print_stats(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Starts timing an operation on @p owner, a dictionary or a cursor.
+			Must be paired with @ref ION_STATS_END in the same block.
+*/
+#define ION_STATS_BEGIN(owner) \
+	ion_stats_span_t ion_stats_span; \
+	if (NULL != (owner)->stats) { \
+		dictionary_stats_begin((owner)->stats, &ion_stats_span); \
+	}
+
+/**
+@brief		Records the operation timed since @ref ION_STATS_BEGIN.
+*/
+#define ION_STATS_END(owner, op) \
+	if (NULL != (owner)->stats) { \
+		dictionary_stats_record((owner)->stats, (op), &ion_stats_span); \
+	}
+
+#else /* Clause ION_DICTIONARY_STATS */
+
+#define ION_STATS_BEGIN(owner)
+#define ION_STATS_END(owner, op)
+
+#endif /* Clause ION_DICTIONARY_STATS */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DICTIONARY_STATS_H_ */
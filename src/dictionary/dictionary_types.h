@@ -110,6 +110,30 @@ typedef union predicate_statement ion_predicate_statement_t;
 */
 typedef struct dictionary_parent ion_dictionary_parent_t;
 
+/**
+@brief		The dictionary Bloom filter type.
+@see		bloom_filter
+*/
+typedef struct bloom_filter ion_bloom_filter_t;
+
+/**
+@brief		The dictionary latency statistics type.
+@see		dictionary_stats
+*/
+typedef struct dictionary_stats ion_dictionary_stats_t;
+
+/**
+@brief		The write-ahead log type.
+@see		ion_wal
+*/
+typedef struct ion_wal ion_wal_t;
+
+/**
+@brief		A range of positions read by one worker of a parallel scan.
+@see		dictionary_scan_range
+*/
+typedef struct dictionary_scan_range ion_dictionary_scan_range_t;
+
 /**
 @brief		A comparison result type that describes the result of a comparison.
 */
@@ -264,6 +288,43 @@ struct dictionary_handler {
 		ion_dictionary_t *
 	);
 	/**< A pointer to the dictionaries close function */
+	ion_err_t (*sync_dictionary)(
+		ion_dictionary_t *
+	);
+	/**< A pointer to the dictionaries sync function, which forces every
+		 change made so far to the device, or @p NULL for dictionaries
+		 that keep their records in memory. */
+	ion_err_t (*scan_extent)(
+		ion_dictionary_t *,
+		ion_fpos_t *,
+		size_t *
+	);
+	/**< A pointer to the function giving how many positions (rows, slots
+		 or buckets) a parallel scan splits the dictionary into, and how
+		 many bytes reading one of them takes, or @p NULL if the
+		 dictionary cannot be scanned in parallel. */
+	ion_err_t (*scan_range)(
+		ion_dictionary_t *,
+		ion_dictionary_scan_range_t *
+	);
+	/**< A pointer to the function reading the next buffer of a range
+		 for a parallel scan. See @ref dictionary_scan_range. */
+	ion_err_t (*get_many)(
+		ion_dictionary_t *,
+		unsigned int,
+		ion_key_t *,
+		ion_value_t *,
+		ion_status_t *
+	);
+	/**< A pointer to the function looking up a batch of keys with their
+		 reads overlapped, or @p NULL to look them up one at a time. Only
+		 keys whose status is still @c err_uninitialized are looked up.
+		 Returns an error if the batch as a whole failed. See
+		 @ref dictionary_get_many. */
+	ion_boolean_t concurrent;
+	/**< Whether the dictionary synchronizes its own writers. In thread-safe
+		 builds, writers of such a dictionary then share it with each other
+		 and with readers rather than taking it exclusively. */
 };
 
 /**
@@ -277,6 +338,22 @@ struct dictionary {
 											 dictionary (but we don't
 											 know type). */
 	ion_dictionary_handler_t	*handler;	/**< Handler for the specific type. */
+	ion_bloom_filter_t			*bloom_filter;	/**< Optional filter over the
+												 keys, consulted before
+												 lookups. @p NULL if not
+												 enabled. */
+#if ION_DICTIONARY_STATS
+	ion_dictionary_stats_t		*stats;	/**< Optional latency histograms.
+											 @p NULL if not enabled. */
+#endif
+	ion_wal_t					*wal;	/**< Optional redo log that writes
+											 are recorded in first. @p NULL
+											 if not attached. */
+#if ION_THREAD_SAFE
+	ion_rwlock_t				lock;	/**< Held shared by readers and open
+											 cursors, and exclusively by
+											 writers. */
+#endif
 };
 
 /**
@@ -408,12 +485,43 @@ struct dictionary_cursor {
 	);
 	/**< A pointer to the next function,
 		 which sets ion_cursor_status_t). */
+	ion_cursor_status_t (*next_batch)(
+		ion_dict_cursor_t *,
+		ion_record_t *records,
+		ion_result_count_t max_records,
+		ion_result_count_t *num_records
+	);
+	/**< A pointer to the batched next
+		 function, or @p NULL if the
+		 implementation has no native
+		 version. Use
+		 @ref dictionary_cursor_next_batch
+		 rather than calling this directly. */
 	void (*destroy)(
 		ion_dict_cursor_t **
 	);
 	/**< A pointer to the function used
 		 to destroy the cursor (frees
 		 internal memory). */
+#if ION_THREAD_SAFE || ION_DICTIONARY_STATS
+	void (*impl_destroy)(
+		ion_dict_cursor_t **
+	);
+	/**< The implementation's destroy,
+		 which the destroy installed by
+		 @ref dictionary_find calls before
+		 it releases the dictionary. */
+#endif
+#if ION_THREAD_SAFE
+	ion_dict_cursor_t *next_held;	/**< The next cursor held by the
+										 thread that opened this one. */
+#endif
+#if ION_DICTIONARY_STATS
+	ion_dictionary_stats_t *stats;	/**< The statistics the cursor is
+										 timed against, or @p NULL. The
+										 cursor holds a reference to them
+										 until it is destroyed. */
+#endif
 };
 
 /**
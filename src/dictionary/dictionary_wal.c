@@ -0,0 +1,987 @@
+/******************************************************************************/
+/**
+@file		dictionary_wal.c
+@author		IonDB Project
+@brief		Implementation of the redo write-ahead log.
+@details	The log file is a @ref ion_wal_file_header_t followed by
+			records. Each record is a @ref ion_wal_record_header_t followed
+			by the key and, for inserts and updates, the value. Records
+			carry consecutive sequence numbers and a checksum, so the end
+			of the log is the first record that is short, corrupt or out of
+			sequence.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+/* Needed for clock_gettime; must come before any system header. */
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "dictionary_wal.h"
+#include "dictionary.h"
+
+#if !defined(ARDUINO)
+#include <time.h>
+#endif
+
+/**
+@brief		Identifies a log file written by this implementation.
+*/
+#define ION_WAL_MAGIC 0x494f4e57
+
+/**
+@brief		Start of the log file.
+*/
+typedef struct {
+	uint32_t	magic;		/**< @ref ION_WAL_MAGIC. */
+	uint32_t	reserved;	/**< Zero. */
+	uint64_t	first_lsn;	/**< Sequence number of the first record. */
+} ion_wal_file_header_t;
+
+/**
+@brief		Start of a record.
+*/
+typedef struct {
+	uint64_t	lsn;		/**< Sequence number. */
+	uint32_t	checksum;	/**< Of the header, with this field zeroed, and
+								 the payload. */
+	uint32_t	id;			/**< ID of the dictionary written to. */
+	uint32_t	type;		/**< An @ref ion_wal_record_type_t. */
+	uint32_t	length;		/**< Bytes of payload that follow. */
+} ion_wal_record_header_t;
+
+/**
+@brief		Returns a monotonic timestamp in milliseconds, or zero where
+			there is no clock.
+*/
+static uint64_t
+ion_wal_now_ms(
+	void
+) {
+#if defined(ARDUINO)
+	return 0;
+#else
+
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t) now.tv_sec * 1000u + (uint64_t) now.tv_nsec / 1000000u;
+#endif
+}
+
+/**
+@brief		FNV-1a over a record.
+*/
+static uint32_t
+ion_wal_checksum(
+	ion_wal_record_header_t *header,
+	ion_byte_t				*payload
+) {
+	ion_wal_record_header_t copy	= *header;
+	uint32_t				hash	= 2166136261u;
+	ion_byte_t				*bytes	= (ion_byte_t *) &copy;
+	uint32_t				i;
+
+	copy.checksum = 0;
+
+	for (i = 0; i < sizeof(copy); i++) {
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+
+	for (i = 0; i < header->length; i++) {
+		hash = (hash ^ payload[i]) * 16777619u;
+	}
+
+	return hash;
+}
+
+/**
+@brief		Finds what the log knows about a dictionary, adding an entry
+			for it if needed.
+@returns	The entry, or @c NULL if it could not be allocated.
+*/
+static ion_wal_owner_t *
+ion_wal_owner(
+	ion_wal_t			*wal,
+	ion_dictionary_id_t id
+) {
+	ion_wal_owner_t *owners;
+	uint32_t		i;
+
+	for (i = 0; i < wal->num_owners; i++) {
+		if (wal->owners[i].id == id) {
+			return &wal->owners[i];
+		}
+	}
+
+	if (wal->num_owners == wal->owners_capacity) {
+		uint32_t capacity = (0 == wal->owners_capacity) ? 4 : wal->owners_capacity * 2;
+
+		owners = realloc(wal->owners, capacity * sizeof(ion_wal_owner_t));
+
+		if (NULL == owners) {
+			return NULL;
+		}
+
+		wal->owners				= owners;
+		wal->owners_capacity	= capacity;
+	}
+
+	memset(&wal->owners[wal->num_owners], 0, sizeof(ion_wal_owner_t));
+	wal->owners[wal->num_owners].id = id;
+
+	return &wal->owners[wal->num_owners++];
+}
+
+/**
+@brief		Whether a dictionary has logged writes that are not known to be
+			on the device.
+*/
+static ion_boolean_t
+ion_wal_owner_is_dirty(
+	ion_wal_owner_t *owner
+) {
+	return owner->last_lsn > owner->applied_lsn;
+}
+
+/**
+@brief		Adds a record to the commit buffer.
+*/
+static ion_err_t
+ion_wal_append(
+	ion_wal_t				*wal,
+	ion_dictionary_id_t		id,
+	ion_wal_record_type_t	type,
+	ion_byte_t				*key,
+	uint32_t				key_size,
+	ion_byte_t				*value,
+	uint32_t				value_size
+) {
+	ion_wal_record_header_t header;
+	ion_byte_t				*record;
+	uint32_t				needed = sizeof(header) + key_size + value_size;
+
+	if (wal->buffered + needed > wal->capacity) {
+		uint32_t	capacity	= (0 == wal->capacity) ? 256 : wal->capacity;
+		ion_byte_t	*buffer;
+
+		while (wal->buffered + needed > capacity) {
+			capacity *= 2;
+		}
+
+		buffer = realloc(wal->buffer, capacity);
+
+		if (NULL == buffer) {
+			return err_out_of_memory;
+		}
+
+		wal->buffer		= buffer;
+		wal->capacity	= capacity;
+	}
+
+	record = wal->buffer + wal->buffered;
+
+	if (0 < key_size) {
+		memcpy(record + sizeof(header), key, key_size);
+	}
+
+	if (0 < value_size) {
+		memcpy(record + sizeof(header) + key_size, value, value_size);
+	}
+
+	header.lsn		= wal->next_lsn++;
+	header.id		= id;
+	header.type		= type;
+	header.length	= key_size + value_size;
+	header.checksum = ion_wal_checksum(&header, record + sizeof(header));
+	memcpy(record, &header, sizeof(header));
+
+	if (0 == wal->pending) {
+		wal->first_pending_ms = ion_wal_now_ms();
+	}
+
+	wal->buffered += needed;
+	wal->pending++;
+
+	return err_ok;
+}
+
+/**
+@brief		Logs that every earlier record of a dictionary is on the device.
+*/
+static ion_err_t
+ion_wal_mark_applied(
+	ion_wal_t		*wal,
+	ion_wal_owner_t *owner
+) {
+	uint64_t	lsn		= wal->next_lsn;
+	ion_err_t	error	= ion_wal_append(wal, owner->id, ion_wal_record_applied, NULL, 0, NULL, 0);
+
+	if (err_ok == error) {
+		owner->applied_lsn = lsn;
+	}
+
+	return error;
+}
+
+/**
+@brief		Writes the header of an empty log and syncs it.
+*/
+static ion_err_t
+ion_wal_write_header(
+	ion_wal_t *wal
+) {
+	ion_wal_file_header_t	header;
+	ion_err_t				error;
+
+	header.magic		= ION_WAL_MAGIC;
+	header.reserved		= 0;
+	header.first_lsn	= wal->next_lsn;
+
+	error				= ion_fwrite_at(wal->file, 0, sizeof(header), (ion_byte_t *) &header);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	wal->end = sizeof(header);
+
+	return ion_fsync(wal->file);
+}
+
+/**
+@brief		Whether a dictionary holds a record with both this key and this
+			value, which a replayed insert would only duplicate.
+*/
+static ion_boolean_t
+ion_wal_holds_record(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	ion_key_size_t		key_size	= dictionary->instance->record.key_size;
+	ion_value_size_t	value_size	= dictionary->instance->record.value_size;
+	ion_boolean_t		found		= boolean_false;
+	ion_predicate_t		predicate;
+	ion_dict_cursor_t	*cursor		= NULL;
+	ion_record_t		record;
+
+	record.key = malloc(key_size + value_size);
+
+	if (NULL == record.key) {
+		return boolean_false;
+	}
+
+	record.value = (ion_byte_t *) record.key + key_size;
+
+	/* Implementations without cursors keep one record per key. */
+	if (NULL == dictionary->handler->find) {
+		found = (err_ok == dictionary_get(dictionary, key, record.value).error) && (0 == memcmp(record.value, value, value_size));
+	}
+	else {
+		dictionary_build_predicate(&predicate, predicate_equality, key);
+
+		if (err_ok == dictionary_find(dictionary, &predicate, &cursor)) {
+			while (!found && (cs_cursor_active == cursor->next(cursor, &record))) {
+				found = 0 == memcmp(record.value, value, value_size);
+			}
+
+			cursor->destroy(&cursor);
+		}
+	}
+
+	free(record.key);
+
+	return found;
+}
+
+/**
+@brief		Walks the committed records of the log.
+@details	With @p dictionary set, replays the records of that dictionary
+			that it has not applied. Otherwise, rebuilds what the log
+			knows about each dictionary and finds the end of the log.
+*/
+static ion_err_t
+ion_wal_scan(
+	ion_wal_t			*wal,
+	ion_dictionary_t	*dictionary,
+	uint32_t			*num_replayed
+) {
+	ion_wal_file_header_t	file_header;
+	ion_wal_record_header_t header;
+	ion_byte_t				*payload	= NULL;
+	uint32_t				allocated	= 0;
+	ion_file_offset_t		offset		= sizeof(file_header);
+	ion_file_offset_t		size		= ion_fend(wal->file);
+	ion_wal_owner_t			*owner		= NULL;
+	uint64_t				lsn;
+	ion_err_t				error		= err_ok;
+
+	if (err_ok != ion_fread_at(wal->file, 0, sizeof(file_header), (ion_byte_t *) &file_header)) {
+		return err_file_read_error;
+	}
+
+	if (ION_WAL_MAGIC != file_header.magic) {
+		return err_file_read_error;
+	}
+
+	lsn = file_header.first_lsn;
+
+	if (NULL != dictionary) {
+		owner = ion_wal_owner(wal, dictionary->instance->id);
+
+		if (NULL == owner) {
+			return err_out_of_memory;
+		}
+	}
+
+	while (offset + (ion_file_offset_t) sizeof(header) <= size) {
+		if (err_ok != ion_fread_at(wal->file, offset, sizeof(header), (ion_byte_t *) &header)) {
+			break;
+		}
+
+		if ((header.lsn != lsn) || (offset + (ion_file_offset_t) (sizeof(header) + header.length) > size)) {
+			break;
+		}
+
+		if (header.length > allocated) {
+			ion_byte_t *grown = realloc(payload, header.length);
+
+			if (NULL == grown) {
+				error = err_out_of_memory;
+				goto CLEANUP;
+			}
+
+			payload		= grown;
+			allocated	= header.length;
+		}
+
+		if ((0 < header.length) && (err_ok != ion_fread(wal->file, header.length, payload))) {
+			break;
+		}
+
+		if (ion_wal_checksum(&header, payload) != header.checksum) {
+			break;
+		}
+
+		if (NULL == dictionary) {
+			ion_wal_owner_t *entry = ion_wal_owner(wal, header.id);
+
+			if (NULL == entry) {
+				error = err_out_of_memory;
+				goto CLEANUP;
+			}
+
+			if (ion_wal_record_applied == header.type) {
+				entry->applied_lsn = header.lsn;
+			}
+			else {
+				entry->last_lsn = header.lsn;
+			}
+		}
+		else if ((header.id == owner->id) && (header.lsn > owner->applied_lsn) && (ion_wal_record_applied != header.type)) {
+			ion_byte_t *value = payload + dictionary->instance->record.key_size;
+
+			/* Dictionaries write in place before any checkpoint, so some
+			   of these writes may already be in the dictionary. Updates
+			   and deletes can simply be made again. An insert is skipped
+			   if its record is already there. If its key is there with
+			   another value, a later logged write reached the dictionary
+			   and its own replay settles the key. */
+			switch (header.type) {
+				case ion_wal_record_insert:
+					if (!ion_wal_holds_record(dictionary, payload, value)) {
+						dictionary_insert(dictionary, payload, value);
+					}
+
+					break;
+
+				case ion_wal_record_update:
+					dictionary_update(dictionary, payload, value);
+					break;
+
+				case ion_wal_record_delete:
+					dictionary_delete(dictionary, payload);
+					break;
+			}
+
+			(*num_replayed)++;
+		}
+
+		offset += sizeof(header) + header.length;
+		lsn++;
+	}
+
+	if (NULL == dictionary) {
+		wal->end		= offset;
+		wal->next_lsn	= lsn;
+	}
+
+CLEANUP:
+	free(payload);
+
+	return error;
+}
+
+/**
+@brief		Empties the log once no dictionary needs anything in it.
+*/
+static ion_err_t
+ion_wal_reset(
+	ion_wal_t *wal
+) {
+	uint32_t	kept = 0;
+	uint32_t	i;
+	ion_err_t	error;
+
+	for (i = 0; i < wal->num_owners; i++) {
+		if (ion_wal_owner_is_dirty(&wal->owners[i])) {
+			return err_ok;
+		}
+	}
+
+	/* A crash between removing the log and writing its new header
+	   leaves no log, which is correct since nothing in it was needed. */
+	ion_fclose(wal->file);
+	ion_fremove(wal->name);
+	wal->file = ion_fopen(wal->name);
+
+	if (ION_FILE_IS_NULL(wal->file)) {
+		return err_file_open_error;
+	}
+
+	error = ion_wal_write_header(wal);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	/* Only attached dictionaries are still worth tracking. */
+	for (i = 0; i < wal->num_owners; i++) {
+		if (NULL != wal->owners[i].dictionary) {
+			wal->owners[kept]				= wal->owners[i];
+			wal->owners[kept].last_lsn		= 0;
+			wal->owners[kept].applied_lsn	= 0;
+			kept++;
+		}
+	}
+
+	wal->num_owners = kept;
+
+	return err_ok;
+}
+
+/**
+@brief		Syncs a dictionary and logs that its writes are applied.
+*/
+static ion_err_t
+ion_wal_sync_owner(
+	ion_wal_t		*wal,
+	ion_wal_owner_t *owner
+) {
+	ion_err_t error;
+
+	if (!ion_wal_owner_is_dirty(owner)) {
+		return err_ok;
+	}
+
+	error = owner->dictionary->handler->sync_dictionary(owner->dictionary);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	return ion_wal_mark_applied(wal, owner);
+}
+
+ion_err_t
+ion_wal_open(
+	ion_wal_t			*wal,
+	char				*name,
+	ion_wal_config_t	*config
+) {
+	ion_boolean_t	is_new;
+	ion_err_t		error;
+
+	memset(wal, 0, sizeof(*wal));
+
+	if (strlen(name) >= ION_MAX_FILENAME_LENGTH) {
+		return err_file_open_error;
+	}
+
+	strcpy(wal->name, name);
+
+	if (NULL != config) {
+		wal->config = *config;
+	}
+	else {
+		wal->config.group_size			= ION_WAL_DEFAULT_GROUP_SIZE;
+		wal->config.commit_interval_ms	= ION_WAL_DEFAULT_COMMIT_INTERVAL_MS;
+		wal->config.checkpoint_bytes	= ION_WAL_DEFAULT_CHECKPOINT_BYTES;
+	}
+
+	if (0 == wal->config.group_size) {
+		wal->config.group_size = 1;
+	}
+
+	wal->next_lsn	= 1;
+	is_new			= !ion_fexists(name);
+	wal->file		= ion_fopen(name);
+
+	if (ION_FILE_IS_NULL(wal->file)) {
+		return err_file_open_error;
+	}
+
+	/* A log shorter than its header was being reset when it crashed. */
+	if (is_new || (ion_fend(wal->file) < (ion_file_offset_t) sizeof(ion_wal_file_header_t))) {
+		error = ion_wal_write_header(wal);
+	}
+	else {
+		error = ion_wal_scan(wal, NULL, NULL);
+	}
+
+	if (err_ok != error) {
+		ion_fclose(wal->file);
+		free(wal->owners);
+		wal->owners = NULL;
+	}
+	else {
+		ION_MUTEX_INIT(wal->lock);
+	}
+
+	return error;
+}
+
+ion_err_t
+ion_wal_close(
+	ion_wal_t *wal
+) {
+	ion_err_t	error = ion_wal_checkpoint(wal);
+	uint32_t	i;
+
+	for (i = 0; i < wal->num_owners; i++) {
+		if (NULL != wal->owners[i].dictionary) {
+			wal->owners[i].dictionary->wal	= NULL;
+			wal->owners[i].dictionary		= NULL;
+		}
+	}
+
+	if ((err_ok != ion_fclose(wal->file)) && (err_ok == error)) {
+		error = err_file_close_error;
+	}
+
+	free(wal->buffer);
+	free(wal->owners);
+	wal->buffer = NULL;
+	wal->owners = NULL;
+	wal->file	= ION_NOFILE;
+	ION_MUTEX_DESTROY(wal->lock);
+
+	return error;
+}
+
+/**
+@brief		Writes every buffered record to the log and forces it to the
+			device, with the log already locked.
+*/
+static ion_err_t
+ion_wal_do_commit(
+	ion_wal_t *wal
+) {
+	ion_err_t error;
+
+	if (0 == wal->buffered) {
+		return err_ok;
+	}
+
+	error = ion_fwrite_at(wal->file, wal->end, wal->buffered, wal->buffer);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = ion_fsync(wal->file);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	wal->end		+= wal->buffered;
+	wal->buffered	= 0;
+	wal->pending	= 0;
+
+	return err_ok;
+}
+
+/**
+@brief		Checkpoints a log that is already locked.
+@details	Each attached dictionary is held exclusively while it is synced,
+			except @p holder, which the caller is already writing to.
+*/
+static ion_err_t
+ion_wal_do_checkpoint(
+	ion_wal_t			*wal,
+	ion_dictionary_t	*holder
+) {
+	ion_dictionary_t	*dictionary;
+	ion_err_t			error;
+	uint32_t			i;
+
+	for (i = 0; i < wal->num_owners; i++) {
+		dictionary = wal->owners[i].dictionary;
+
+		if (NULL == dictionary) {
+			continue;
+		}
+
+		if (dictionary != holder) {
+			ION_RWLOCK_WRITE(dictionary->lock);
+		}
+
+		error = ion_wal_sync_owner(wal, &wal->owners[i]);
+
+		if (dictionary != holder) {
+			ION_RWLOCK_UNLOCK(dictionary->lock);
+		}
+
+		if (err_ok != error) {
+			return error;
+		}
+	}
+
+	error = ion_wal_do_commit(wal);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	return ion_wal_reset(wal);
+}
+
+/**
+@brief		Locks a log for the calling thread.
+@details	A checkpoint holds the log while it waits for the cursors on
+			every attached dictionary, so a thread holding one of those
+			cursors must not wait for the log.
+@returns	@ref err_would_deadlock if the calling thread holds a cursor on
+			an attached dictionary, otherwise @ref err_ok and the log is
+			locked.
+*/
+static ion_err_t
+ion_wal_lock(
+	ion_wal_t *wal
+) {
+#if ION_THREAD_SAFE
+
+	if (dictionary_thread_holds_logged_cursor(wal)) {
+		return err_would_deadlock;
+	}
+
+	ION_MUTEX_LOCK(wal->lock);
+#else
+	UNUSED(wal);
+#endif
+
+
+	return err_ok;
+}
+
+ion_err_t
+ion_wal_commit(
+	ion_wal_t *wal
+) {
+	ion_err_t error = ion_wal_lock(wal);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = ion_wal_do_commit(wal);
+
+	ION_MUTEX_UNLOCK(wal->lock);
+
+	return error;
+}
+
+ion_err_t
+ion_wal_checkpoint(
+	ion_wal_t *wal
+) {
+	ion_err_t error = ion_wal_lock(wal);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = ion_wal_do_checkpoint(wal, NULL);
+
+	ION_MUTEX_UNLOCK(wal->lock);
+
+	return error;
+}
+
+/**
+@brief		Drops everything logged for a dictionary, with the log already
+			locked.
+*/
+static ion_err_t
+ion_wal_do_forget(
+	ion_wal_t			*wal,
+	ion_dictionary_id_t id
+) {
+	ion_wal_owner_t *owner = NULL;
+	ion_err_t		error;
+	uint32_t		i;
+
+	for (i = 0; i < wal->num_owners; i++) {
+		if (wal->owners[i].id == id) {
+			owner = &wal->owners[i];
+		}
+	}
+
+	if (NULL == owner) {
+		return err_ok;
+	}
+
+	if (NULL != owner->dictionary) {
+		owner->dictionary->wal	= NULL;
+		owner->dictionary		= NULL;
+	}
+
+	if (!ion_wal_owner_is_dirty(owner)) {
+		return err_ok;
+	}
+
+	/* The records must not be replayed into a later dictionary that
+	   reuses the ID. */
+	error = ion_wal_mark_applied(wal, owner);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	return ion_wal_do_commit(wal);
+}
+
+/**
+@brief		Replays into and attaches a dictionary, with the log already
+			locked.
+*/
+static ion_err_t
+ion_wal_do_attach(
+	ion_dictionary_t	*dictionary,
+	ion_wal_t			*wal
+) {
+	ion_wal_owner_t *owner;
+	uint32_t		num_replayed = 0;
+	ion_err_t		error;
+
+	if (NULL == dictionary->handler->sync_dictionary) {
+		return err_not_implemented;
+	}
+
+	if (NULL != dictionary->wal) {
+		return err_duplicate_dictionary_error;
+	}
+
+	/* Replay reads the file, so it must hold every record. */
+	error = ion_wal_do_commit(wal);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = ion_wal_scan(wal, dictionary, &num_replayed);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	owner = ion_wal_owner(wal, dictionary->instance->id);
+
+	if (NULL == owner) {
+		return err_out_of_memory;
+	}
+
+	owner->dictionary	= dictionary;
+	dictionary->wal		= wal;
+
+	if (0 == num_replayed) {
+		return err_ok;
+	}
+
+	error = ion_wal_sync_owner(wal, owner);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	return ion_wal_do_commit(wal);
+}
+
+/**
+@brief		Syncs and detaches a dictionary, with its log already locked.
+*/
+static ion_err_t
+ion_wal_do_detach(
+	ion_wal_t			*wal,
+	ion_dictionary_t	*dictionary
+) {
+	ion_wal_owner_t *owner;
+	ion_err_t		error;
+
+	owner	= ion_wal_owner(wal, dictionary->instance->id);
+
+	error	= (NULL == owner) ? err_out_of_memory : ion_wal_sync_owner(wal, owner);
+
+	if (err_ok == error) {
+		error = ion_wal_do_commit(wal);
+	}
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	owner->dictionary	= NULL;
+	dictionary->wal		= NULL;
+
+	return err_ok;
+}
+
+ion_err_t
+ion_wal_forget(
+	ion_wal_t			*wal,
+	ion_dictionary_id_t id
+) {
+	ion_err_t error = ion_wal_lock(wal);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = ion_wal_do_forget(wal, id);
+
+	ION_MUTEX_UNLOCK(wal->lock);
+
+	return error;
+}
+
+ion_err_t
+dictionary_attach_wal(
+	ion_dictionary_t	*dictionary,
+	ion_wal_t			*wal
+) {
+	ion_err_t error = ion_wal_lock(wal);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = ion_wal_do_attach(dictionary, wal);
+
+	ION_MUTEX_UNLOCK(wal->lock);
+
+	return error;
+}
+
+ion_err_t
+dictionary_detach_wal(
+	ion_dictionary_t *dictionary
+) {
+	ion_wal_t	*wal = dictionary->wal;
+	ion_err_t	error;
+
+	if (NULL == wal) {
+		return err_ok;
+	}
+
+	error = ion_wal_lock(wal);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = ion_wal_do_detach(wal, dictionary);
+	ION_MUTEX_UNLOCK(wal->lock);
+
+	return error;
+}
+
+ion_err_t
+dictionary_wal_log(
+	ion_dictionary_t		*dictionary,
+	ion_wal_record_type_t	type,
+	ion_key_t				key,
+	ion_value_t				value
+) {
+	ion_wal_t		*wal = dictionary->wal;
+	ion_wal_owner_t *owner;
+	uint32_t		value_size;
+	uint64_t		lsn;
+	ion_err_t		error;
+
+	if (NULL == wal) {
+		return err_ok;
+	}
+
+	/* Checkpoint before logging, since a checkpoint marks every logged
+	   write as applied, and this one is only applied, not yet synced. */
+	if ((0 != wal->config.checkpoint_bytes) && (wal->end >= wal->config.checkpoint_bytes)) {
+		error = ion_wal_do_checkpoint(wal, dictionary);
+
+		if (err_ok != error) {
+			return error;
+		}
+	}
+
+	owner		= ion_wal_owner(wal, dictionary->instance->id);
+
+	if (NULL == owner) {
+		return err_out_of_memory;
+	}
+
+	value_size	= (ion_wal_record_delete == type) ? 0 : dictionary->instance->record.value_size;
+	lsn			= wal->next_lsn;
+	error		= ion_wal_append(wal, owner->id, type, key, dictionary->instance->record.key_size, value, value_size);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	owner->last_lsn = lsn;
+
+	if ((wal->pending >= wal->config.group_size) || ((0 != wal->config.commit_interval_ms) && (ion_wal_now_ms() - wal->first_pending_ms >= wal->config.commit_interval_ms))) {
+		error = ion_wal_do_commit(wal);
+	}
+
+	return error;
+}
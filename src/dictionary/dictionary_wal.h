@@ -0,0 +1,293 @@
+/******************************************************************************/
+/**
+@file		dictionary_wal.h
+@author		IonDB Project
+@brief		A redo write-ahead log shared by a set of dictionaries.
+@details	Once a dictionary is attached to a log, every insert, update
+			and delete the dictionary accepts is appended to the log. A
+			write it refuses is not logged, so it is never replayed. Records
+			are buffered in memory and group committed: the buffer is
+			written and forced to the device with a single sync once it
+			holds @ref ion_wal_config_t.group_size records, or on the first
+			write after @ref ion_wal_config_t.commit_interval_ms has passed.
+			An operation is durable once the commit covering it returns;
+			@ref ion_wal_commit forces one at the end of a batch.
+
+			Dictionaries still write in place without syncing. They are
+			only synced at a checkpoint, which happens when the log grows
+			past @ref ion_wal_config_t.checkpoint_bytes, on
+			@ref ion_wal_checkpoint, and when a dictionary is detached.
+			After a checkpoint has synced every dictionary that has records
+			in the log, the log is emptied.
+
+			Attaching a dictionary replays, in order, the records logged
+			for its ID that it is not known to have applied. Some of them
+			may have reached the dictionary before a crash, so replay is
+			idempotent: updates and deletes are replayed as they are, and
+			an insert is skipped if the dictionary already holds a record
+			with its key and value. Records written before the last
+			checkpoint are never touched. In an implementation that
+			allows duplicate keys, replay cannot tell how many of a key's
+			records written since the last checkpoint reached the device:
+			identical ones may be recovered as one, and an updated key
+			may be recovered with a different number of records.
+
+			Only dictionaries that implement
+			@ref dictionary_handler.sync_dictionary can be attached;
+			in-memory dictionaries are only written out when closed.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(DICTIONARY_WAL_H_)
+#define DICTIONARY_WAL_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "../key_value/kv_system.h"
+#include "dictionary_types.h"
+#include "../file/ion_file.h"
+
+/**
+@brief		Records per group commit when no configuration is given.
+*/
+#define ION_WAL_DEFAULT_GROUP_SIZE			32
+
+/**
+@brief		Longest time in milliseconds that a record waits for a group
+			commit when no configuration is given.
+*/
+#define ION_WAL_DEFAULT_COMMIT_INTERVAL_MS	10
+
+/**
+@brief		Size in bytes that the log may grow to before a checkpoint when
+			no configuration is given.
+*/
+#define ION_WAL_DEFAULT_CHECKPOINT_BYTES	(1024L * 1024L)
+
+/**
+@brief		The kinds of record in the log.
+*/
+typedef enum {
+	ion_wal_record_insert = 1,	/**< A @ref dictionary_insert. */
+	ion_wal_record_update,		/**< A @ref dictionary_update. */
+	ion_wal_record_delete,		/**< A @ref dictionary_delete. */
+	ion_wal_record_applied		/**< Every earlier record of the dictionary
+									 is on the device. */
+} ion_wal_record_type_t;
+
+/**
+@brief		Tuning of a log.
+*/
+typedef struct {
+	uint32_t			group_size;			/**< Records per commit. One
+												 syncs every operation. */
+	uint32_t			commit_interval_ms;	/**< Commit on the first write
+												 after records have waited
+												 this long, or zero to
+												 commit by count only.
+												 Ignored on Arduino. */
+	ion_file_offset_t	checkpoint_bytes;	/**< Checkpoint once the log is
+												 this large, or zero to
+												 only checkpoint when asked
+												 to. */
+} ion_wal_config_t;
+
+/**
+@brief		What the log knows about one dictionary that has records in it.
+*/
+typedef struct {
+	ion_dictionary_id_t id;			/**< The dictionary's ID. */
+	uint64_t			last_lsn;	/**< Its last logged write, or zero. */
+	uint64_t			applied_lsn;/**< Its last applied marker, or zero. */
+	ion_dictionary_t	*dictionary;/**< The attached dictionary, or
+										 @c NULL. */
+} ion_wal_owner_t;
+
+/**
+@brief		An open log.
+*/
+struct ion_wal {
+	char				name[ION_MAX_FILENAME_LENGTH];	/**< Name of the log file. */
+	ion_file_handle_t	file;			/**< The log file. */
+	ion_wal_config_t	config;			/**< Tuning. */
+	uint64_t			next_lsn;		/**< Sequence number of the next record. */
+	ion_file_offset_t	end;			/**< Size of the committed log. */
+	ion_byte_t			*buffer;		/**< Records not yet committed. */
+	uint32_t			buffered;		/**< Bytes used in @c buffer. */
+	uint32_t			capacity;		/**< Bytes allocated for @c buffer. */
+	uint32_t			pending;		/**< Records in @c buffer. */
+	uint64_t			first_pending_ms;	/**< When the oldest record in
+												 @c buffer was logged. */
+	ion_wal_owner_t		*owners;		/**< Dictionaries with records in
+											 the log or attached to it. */
+	uint32_t			num_owners;		/**< Entries used in @c owners. */
+	uint32_t			owners_capacity;/**< Entries allocated for @c owners. */
+#if ION_THREAD_SAFE
+	ion_mutex_t			lock;			/**< Held by writers of attached
+											 dictionaries, taken before
+											 their own locks. */
+#endif
+};
+
+/**
+@brief		Opens a log, creating it if it does not exist.
+@details	A partially written record at the end of the log, left by a
+			crash during a commit, is ignored and later overwritten.
+@param		wal
+				The log to initialize.
+@param		name
+				Name of the log file.
+@param		config
+				Tuning, or @c NULL for the defaults.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_wal_open(
+	ion_wal_t			*wal,
+	char				*name,
+	ion_wal_config_t	*config
+);
+
+/**
+@brief		Checkpoints and closes a log, detaching every dictionary still
+			attached to it.
+@param		wal
+				An open log.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_wal_close(
+	ion_wal_t *wal
+);
+
+/**
+@brief		Writes every buffered record to the log and forces it to the
+			device.
+@param		wal
+				An open log.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_wal_commit(
+	ion_wal_t *wal
+);
+
+/**
+@brief		Syncs every attached dictionary, notes it in the log, and
+			empties the log if nothing in it is still needed.
+@details	When built with @ref ION_THREAD_SAFE, each dictionary is held
+			exclusively while it is synced, so this waits for open cursors
+			on any attached dictionary. The same holds for the automatic
+			checkpoint a write may trigger. A thread holding such a cursor
+			gets @ref err_would_deadlock from every operation that locks
+			the log, this one included, instead of waiting on a checkpoint
+			that waits on it.
+@param		wal
+				An open log.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_wal_checkpoint(
+	ion_wal_t *wal
+);
+
+/**
+@brief		Drops everything logged for a dictionary that is being
+			deleted, detaching it if it is attached.
+@param		wal
+				An open log.
+@param		id
+				The ID of the dictionary.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_wal_forget(
+	ion_wal_t			*wal,
+	ion_dictionary_id_t id
+);
+
+/**
+@brief		Replays the records the log holds for a dictionary, then logs
+			its writes from now on.
+@param		dictionary
+				An open dictionary that is not attached to a log.
+@param		wal
+				An open log.
+@returns	@c err_not_implemented if the dictionary cannot be synced,
+			otherwise an error code describing the result of the operation.
+*/
+ion_err_t
+dictionary_attach_wal(
+	ion_dictionary_t	*dictionary,
+	ion_wal_t			*wal
+);
+
+/**
+@brief		Syncs a dictionary and stops logging its writes.
+@param		dictionary
+				A dictionary attached to a log.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+dictionary_detach_wal(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Appends a write to the log of a dictionary, if it has one.
+@details	Called by the dictionary layer once the write has been applied,
+			and only if it succeeded.
+@param		dictionary
+				The dictionary being written to.
+@param		type
+				The kind of write.
+@param		key
+				The key being written.
+@param		value
+				The value being written, ignored for deletes.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+dictionary_wal_log(
+	ion_dictionary_t		*dictionary,
+	ion_wal_record_type_t	type,
+	ion_key_t				key,
+	ion_value_t				value
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DICTIONARY_WAL_H_ */
@@ -36,6 +36,581 @@
 
 #include "flat_file.h"
 
+/**
+@brief		Opens one of the files of a flat file, creating it if needed.
+@param[in]	filename
+				Name of the file to open.
+@param[in]	id
+				The ID of the flat file, which the file's I/O is charged to.
+@param[in]	truncate
+				Whether to discard anything already in the file.
+@return		The opened file, or @ref ION_NOFILE on failure.
+*/
+static ion_file_handle_t
+flat_file_open(
+	char				*filename,
+	ion_dictionary_id_t id,
+	ion_boolean_t		truncate
+) {
+	if (truncate && ion_fexists(filename)) {
+		ion_fremove(filename);
+	}
+
+	ion_file_handle_t file = ion_fopen(filename);
+
+#if ION_FILE_STATS
+
+	if (!ION_FILE_IS_NULL(file)) {
+		ion_file_set_owner(file, id);
+	}
+
+#else
+	UNUSED(id);
+#endif
+	return file;
+}
+
+/**
+@brief		Makes sure the zone map has room for at least @p num_blocks blocks.
+@param[in]	flat_file
+				Which flat file instance to grow the zone map of.
+@param[in]	num_blocks
+				How many blocks the zone map must be able to describe.
+@return		The status of the allocation.
+*/
+ion_err_t
+flat_file_zone_map_reserve(
+	ion_flat_file_t *flat_file,
+	ion_fpos_t		num_blocks
+) {
+	if (num_blocks <= flat_file->zone_map_capacity) {
+		return err_ok;
+	}
+
+	ion_fpos_t new_capacity = 0 == flat_file->zone_map_capacity ? 1 : flat_file->zone_map_capacity;
+
+	while (new_capacity < num_blocks) {
+		new_capacity *= 2;
+	}
+
+	ion_byte_t *new_zone_map = realloc(flat_file->zone_map, new_capacity * 2 * flat_file->super.record.key_size);
+
+	if (NULL == new_zone_map) {
+		return err_out_of_memory;
+	}
+
+	flat_file->zone_map				= new_zone_map;
+	flat_file->zone_map_capacity	= new_capacity;
+
+	return err_ok;
+}
+
+/**
+@brief		Drops the zone map of the given flat file, so that it will be rebuilt on demand.
+@param[in]	flat_file
+				Which flat file instance to drop the zone map of.
+*/
+void
+flat_file_zone_map_invalidate(
+	ion_flat_file_t *flat_file
+) {
+	free(flat_file->zone_map);
+	flat_file->zone_map				= NULL;
+	flat_file->zone_map_capacity	= 0;
+	flat_file->zone_map_valid		= boolean_false;
+}
+
+/**
+@brief		Widens the bounds of the block holding row @p location to include @p key.
+@param[in]	flat_file
+				Which flat file instance to update the zone map of.
+@param[in]	location
+				The row index at which @p key now lives.
+@param[in]	key
+				The key that was written.
+@param[in]	first_in_block
+				If @c boolean_true, the bounds of the block are reset to @p key instead
+				of widened. Used when the row is the first one written to a fresh block.
+@return		The status of the update.
+*/
+ion_err_t
+flat_file_zone_map_include(
+	ion_flat_file_t *flat_file,
+	ion_fpos_t		location,
+	ion_key_t		key,
+	ion_boolean_t	first_in_block
+) {
+	ion_fpos_t	block	= location / flat_file->num_buffered;
+	ion_err_t	err		= flat_file_zone_map_reserve(flat_file, block + 1);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	ion_key_size_t	key_size	= flat_file->super.record.key_size;
+	ion_byte_t		*min_key	= flat_file->zone_map + block * 2 * key_size;
+	ion_byte_t		*max_key	= min_key + key_size;
+
+	if (first_in_block || (flat_file->super.compare(key, min_key, key_size) < 0)) {
+		memcpy(min_key, key, key_size);
+	}
+
+	if (first_in_block || (flat_file->super.compare(key, max_key, key_size) > 0)) {
+		memcpy(max_key, key, key_size);
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Rebuilds the zone map from scratch by reading through the whole data file.
+@details	The memory for the zone map is claimed before any I/O is done, so that
+			running out of memory is cheap to discover.
+@param[in]	flat_file
+				Which flat file instance to rebuild the zone map of.
+@param[in]	reader
+				Which reader's buffer to read the data file through.
+@return		The status of the rebuild.
+*/
+ion_err_t
+flat_file_zone_map_rebuild(
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader
+) {
+	ion_fpos_t	num_rows	= (flat_file->eof_position - flat_file->start_of_data) / flat_file->row_size;
+	ion_fpos_t	num_blocks	= (num_rows + flat_file->num_buffered - 1) / flat_file->num_buffered;
+	ion_err_t	err			= flat_file_zone_map_reserve(flat_file, num_blocks);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	/* The buffer of the reader is reused for the rebuild, so its loaded region is lost. */
+	reader->current_loaded_region	= -1;
+	reader->num_in_buffer			= 0;
+
+	ion_fpos_t row_index = 0;
+
+	while (row_index < num_rows) {
+		size_t num_records_to_process = num_rows - row_index > flat_file->num_buffered ? (size_t) flat_file->num_buffered : (size_t) (num_rows - row_index);
+
+		if (err_ok != ion_fread_at(flat_file->data_file, flat_file->start_of_data + row_index * flat_file->row_size, flat_file->row_size * num_records_to_process, reader->buffer)) {
+			return err_file_read_error;
+		}
+
+		size_t i;
+
+		for (i = 0; i < num_records_to_process; i++) {
+			ion_key_t key = &reader->buffer[i * flat_file->row_size + sizeof(ion_flat_file_row_status_t)];
+
+			flat_file_zone_map_include(flat_file, row_index, key, 0 == row_index % flat_file->num_buffered);
+			row_index++;
+		}
+	}
+
+	/* Readers that find the zone map valid use it without taking the latch. */
+	ION_ATOMIC_STORE(&flat_file->zone_map_valid, boolean_true);
+
+	return err_ok;
+}
+
+/**
+@brief		Makes sure the zone map is valid before a reader uses it, rebuilding it if needed.
+@details	Concurrent readers only take the latch if the zone map is invalid, in which
+			case the first of them rebuilds it and the others wait for the result.
+@param[in]	flat_file
+				Which flat file instance to check the zone map of.
+@param[in]	reader
+				Which reader's buffer to rebuild the zone map through.
+@return		@c boolean_true if the zone map can be used, @c boolean_false otherwise.
+*/
+ion_boolean_t
+flat_file_zone_map_ready(
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader
+) {
+	if (ION_ATOMIC_LOAD(&flat_file->zone_map_valid)) {
+		return boolean_true;
+	}
+
+	ION_MUTEX_LOCK(flat_file->zone_map_latch);
+
+	ion_boolean_t ready = flat_file->zone_map_valid || (err_ok == flat_file_zone_map_rebuild(flat_file, reader));
+
+	ION_MUTEX_UNLOCK(flat_file->zone_map_latch);
+
+	return ready;
+}
+
+/**
+@brief		Loads the zone map persisted by @ref flat_file_zone_map_persist, if it is still usable.
+@details	The persisted zone map is removed once it has been read, so that a crash before the
+			next clean close cannot leave an out of date zone map behind. If no usable zone map
+			is found, it is rebuilt on demand instead.
+@param[in]	flat_file
+				Which flat file instance to load the zone map for.
+@param[in]	id
+				The ID of the flat file, used to find the zone map file.
+*/
+void
+flat_file_zone_map_load(
+	ion_flat_file_t		*flat_file,
+	ion_dictionary_id_t id
+) {
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(id, ION_FLAT_FILE_ZONE_MAP_EXTENSION, filename);
+
+	if (!ion_fexists(filename)) {
+		return;
+	}
+
+	ion_file_handle_t zone_map_file = flat_file_open(filename, id, boolean_false);
+
+	if (ION_FILE_IS_NULL(zone_map_file)) {
+		return;
+	}
+
+	uint32_t	header[2];
+	ion_fpos_t	num_rows	= (flat_file->eof_position - flat_file->start_of_data) / flat_file->row_size;
+	ion_fpos_t	num_blocks	= (num_rows + flat_file->num_buffered - 1) / flat_file->num_buffered;
+
+	/* The header holds the number of rows and the block size that the zone map was built for. */
+	if ((err_ok == ion_fread(zone_map_file, sizeof(header), (ion_byte_t *) header)) && (header[0] == (uint32_t) num_rows) && (header[1] == (uint32_t) flat_file->num_buffered) && (err_ok == flat_file_zone_map_reserve(flat_file, num_blocks))) {
+		if ((0 == num_blocks) || (err_ok == ion_fread(zone_map_file, num_blocks * 2 * flat_file->super.record.key_size, flat_file->zone_map))) {
+			flat_file->zone_map_valid = boolean_true;
+		}
+	}
+
+	ion_fclose(zone_map_file);
+	ion_fremove(filename);
+}
+
+/**
+@brief		Writes the zone map out next to the data file so it can be reused on the next open.
+@param[in]	flat_file
+				Which flat file instance to persist the zone map of.
+@return		The status of the write.
+*/
+ion_err_t
+flat_file_zone_map_persist(
+	ion_flat_file_t *flat_file
+) {
+	if (!flat_file->zone_map_valid) {
+		return err_ok;
+	}
+
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(flat_file->super.id, ION_FLAT_FILE_ZONE_MAP_EXTENSION, filename);
+
+	ion_file_handle_t zone_map_file = flat_file_open(filename, flat_file->super.id, boolean_true);
+
+	if (ION_FILE_IS_NULL(zone_map_file)) {
+		return err_file_open_error;
+	}
+
+	ion_fpos_t	num_rows	= (flat_file->eof_position - flat_file->start_of_data) / flat_file->row_size;
+	ion_fpos_t	num_blocks	= (num_rows + flat_file->num_buffered - 1) / flat_file->num_buffered;
+	uint32_t	header[2]	= { (uint32_t) num_rows, (uint32_t) flat_file->num_buffered };
+	ion_err_t	err			= err_ok;
+
+	if ((err_ok != ion_fwrite(zone_map_file, sizeof(header), (ion_byte_t *) header)) || ((0 != num_blocks) && (err_ok != ion_fwrite(zone_map_file, num_blocks * 2 * flat_file->super.record.key_size, flat_file->zone_map)))) {
+		err = err_file_write_error;
+	}
+
+	if (err_ok != ion_fclose(zone_map_file)) {
+		err = err_file_close_error;
+	}
+
+	if (err_ok != err) {
+		/* Don't leave a partial zone map behind, it will be rebuilt on demand instead. */
+		ion_fremove(filename);
+	}
+
+	return err;
+}
+
+/**
+@brief		Checks whether any key in the given block could fall within @p lower_bound and @p upper_bound.
+@param[in]	flat_file
+				Which flat file instance to check.
+@param[in]	block
+				The index of the block to check.
+@param[in]	lower_bound
+				The smallest key being searched for.
+@param[in]	upper_bound
+				The largest key being searched for.
+@return		@c boolean_false if the block can be skipped, @c boolean_true otherwise.
+*/
+ion_boolean_t
+flat_file_zone_map_might_overlap(
+	ion_flat_file_t *flat_file,
+	ion_fpos_t		block,
+	ion_key_t		lower_bound,
+	ion_key_t		upper_bound
+) {
+	ion_key_size_t	key_size	= flat_file->super.record.key_size;
+	ion_byte_t		*min_key	= flat_file->zone_map + block * 2 * key_size;
+	ion_byte_t		*max_key	= min_key + key_size;
+
+	return flat_file->super.compare(max_key, lower_bound, key_size) >= 0 && flat_file->super.compare(min_key, upper_bound, key_size) <= 0;
+}
+
+/**
+@brief		Reads a numeric key as a @c double, for use in interpolation.
+@param[in]	flat_file
+				Which flat file instance the key belongs to.
+@param[in]	key
+				The key to convert.
+@param[out]	value
+				Where to write the converted key.
+@return		@c boolean_false if the key type or size cannot be interpolated.
+*/
+ion_boolean_t
+flat_file_key_as_double(
+	ion_flat_file_t *flat_file,
+	ion_key_t		key,
+	double			*value
+) {
+	ion_boolean_t is_signed = key_type_numeric_signed == flat_file->super.key_type;
+
+	if (!is_signed && (key_type_numeric_unsigned != flat_file->super.key_type)) {
+		return boolean_false;
+	}
+
+	switch (flat_file->super.record.key_size) {
+		case sizeof(uint8_t): {
+			uint8_t raw;
+
+			memcpy(&raw, key, sizeof(raw));
+			*value = is_signed ? (double) (int8_t) raw : (double) raw;
+			return boolean_true;
+		}
+
+		case sizeof(uint16_t): {
+			uint16_t raw;
+
+			memcpy(&raw, key, sizeof(raw));
+			*value = is_signed ? (double) (int16_t) raw : (double) raw;
+			return boolean_true;
+		}
+
+		case sizeof(uint32_t): {
+			uint32_t raw;
+
+			memcpy(&raw, key, sizeof(raw));
+			*value = is_signed ? (double) (int32_t) raw : (double) raw;
+			return boolean_true;
+		}
+
+		case sizeof(uint64_t): {
+			uint64_t raw;
+
+			memcpy(&raw, key, sizeof(raw));
+			*value = is_signed ? (double) (int64_t) raw : (double) raw;
+			return boolean_true;
+		}
+
+		default: {
+			return boolean_false;
+		}
+	}
+}
+
+/**
+@brief		Finds the first block whose first key is greater than or equal to @p target_key.
+@details	This is done purely in memory over the fence keys kept in the zone map. If
+			@p interpolation_search is enabled and the key type allows it, probes are
+			placed by interpolation. Any probe that fails to halve the search space is
+			followed by a bisection, which bounds the worst case on skewed data.
+@param[in]	flat_file
+				Which flat file instance to search. Must be in sorted mode.
+@param[in]	target_key
+				The key being searched for.
+@param[in]	num_blocks
+				How many blocks the data file currently has.
+@return		The found block index, or @p num_blocks if every block starts below @p target_key.
+*/
+ion_fpos_t
+flat_file_fence_lower_bound(
+	ion_flat_file_t *flat_file,
+	ion_key_t		target_key,
+	ion_fpos_t		num_blocks
+) {
+	ion_key_size_t	key_size		= flat_file->super.record.key_size;
+	ion_fpos_t		low_idx			= 0;
+	ion_fpos_t		high_idx		= num_blocks;
+	double			target_value	= 0;
+	ion_boolean_t	interpolate		= flat_file->interpolation_search && flat_file_key_as_double(flat_file, target_key, &target_value);
+	ion_boolean_t	use_probe		= interpolate;
+
+	while (low_idx < high_idx) {
+		ion_fpos_t	span	= high_idx - low_idx;
+		ion_fpos_t	mid_idx = low_idx + span / 2;
+
+		if (use_probe) {
+			double	low_value;
+			double	high_value;
+
+			flat_file_key_as_double(flat_file, flat_file->zone_map + low_idx * 2 * key_size, &low_value);
+			flat_file_key_as_double(flat_file, flat_file->zone_map + (high_idx - 1) * 2 * key_size, &high_value);
+
+			if (target_value <= low_value) {
+				mid_idx = low_idx;
+			}
+			else if ((target_value > high_value) || (high_value == low_value)) {
+				mid_idx = high_idx - 1;
+			}
+			else {
+				mid_idx = low_idx + (ion_fpos_t) ((target_value - low_value) / (high_value - low_value) * (span - 1));
+			}
+		}
+
+		if (flat_file->super.compare(flat_file->zone_map + mid_idx * 2 * key_size, target_key, key_size) < 0) {
+			low_idx = mid_idx + 1;
+		}
+		else {
+			high_idx = mid_idx;
+		}
+
+		/* Bisect once whenever an interpolation probe fails to halve the search space. */
+		use_probe = interpolate && (!use_probe || (high_idx - low_idx <= span / 2));
+	}
+
+	return low_idx;
+}
+
+/**
+@brief		Performs the search described by @ref flat_file_binary_search using the fence index.
+@details	The fence index narrows the search down to a single block, which is read
+			once and then searched in memory. The block is left in the buffer of the reader,
+			so that a following @ref flat_file_read_row of the found location is a cache hit.
+@param[in]	flat_file
+				Which flat file instance to search within. The zone map must be valid.
+@param[in]	reader
+				Which reader to read the block through.
+@param[in]	target_key
+				Desired key to search for.
+@param[out]	location
+				Found location to write back into.
+@return		Resulting status of the search.
+*/
+ion_err_t
+flat_file_fence_search(
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader,
+	ion_key_t				target_key,
+	ion_fpos_t				*location
+) {
+	ion_key_size_t	key_size	= flat_file->super.record.key_size;
+	ion_fpos_t		num_rows	= (flat_file->eof_position - flat_file->start_of_data) / flat_file->row_size;
+	ion_fpos_t		num_blocks	= (num_rows + flat_file->num_buffered - 1) / flat_file->num_buffered;
+	ion_fpos_t		block		= flat_file_fence_lower_bound(flat_file, target_key, num_blocks);
+
+	/* The first row with a key greater than or equal to the target is either inside the
+	   block before the found one, or is the first row of the found block. */
+	ion_fpos_t lower_bound_idx = block * flat_file->num_buffered;
+
+	if (block > 0) {
+		ion_fpos_t	block_start				= (block - 1) * flat_file->num_buffered;
+		/* Only the last block can be partially filled. */
+		size_t		num_records_to_process	= num_rows - block_start > flat_file->num_buffered ? (size_t) flat_file->num_buffered : (size_t) (num_rows - block_start);
+
+		/* The loaded region is only recorded once the whole block is in the buffer. */
+		reader->current_loaded_region = -1;
+
+		if (err_ok != ion_fread_at(flat_file->data_file, flat_file->start_of_data + block_start * flat_file->row_size, flat_file->row_size * num_records_to_process, reader->buffer)) {
+			return err_file_read_error;
+		}
+
+		reader->current_loaded_region	= block_start;
+		reader->num_in_buffer			= num_records_to_process;
+
+		size_t	low_idx		= 0;
+		size_t	high_idx	= num_records_to_process;
+
+		while (low_idx < high_idx) {
+			size_t mid_idx = low_idx + (high_idx - low_idx) / 2;
+
+			if (flat_file->super.compare(&reader->buffer[mid_idx * flat_file->row_size + sizeof(ion_flat_file_row_status_t)], target_key, key_size) < 0) {
+				low_idx = mid_idx + 1;
+			}
+			else {
+				high_idx = mid_idx;
+			}
+		}
+
+		lower_bound_idx = block_start + low_idx;
+	}
+
+	if (lower_bound_idx < num_rows) {
+		ion_key_t lower_bound_key = flat_file->zone_map + block * 2 * key_size;
+
+		if (lower_bound_idx < block * flat_file->num_buffered) {
+			lower_bound_key = &reader->buffer[(lower_bound_idx - reader->current_loaded_region) * flat_file->row_size + sizeof(ion_flat_file_row_status_t)];
+		}
+
+		if (0 == flat_file->super.compare(lower_bound_key, target_key, key_size)) {
+			*location = lower_bound_idx;
+			return err_ok;
+		}
+	}
+
+	/* No exact match, so step back to the last row that is less than the target. */
+	*location = lower_bound_idx - 1;
+	return *location >= 0 ? err_ok : err_item_not_found;
+}
+
+ion_err_t
+flat_file_write_header(
+	ion_flat_file_t *flat_file
+) {
+	int header = ION_FLAT_FILE_HEADER_UNSORTED;
+
+	if (flat_file->sorted_mode) {
+		header = flat_file->resortable ? ION_FLAT_FILE_HEADER_RESORTABLE : ION_FLAT_FILE_HEADER_SORTED;
+	}
+
+	if (err_ok != ion_fseek(flat_file->data_file, 0, ION_FILE_START)) {
+		return err_file_bad_seek;
+	}
+
+	if (err_ok != ion_fwrite(flat_file->data_file, sizeof(header), (ion_byte_t *) &header)) {
+		return err_file_write_error;
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Takes a flat file that @ref flat_file_sort left in sorted mode out of it, ahead of
+			a write that breaks the order.
+@details	The header is rewritten so that the file is opened unsorted from now on, and the
+			fence index is dropped. Sorting the flat file again puts it back in sorted mode.
+@param[in]	flat_file
+				Which flat file instance to take out of sorted mode.
+@return		The status of the header write. On failure the flat file stays in sorted mode.
+*/
+static ion_err_t
+flat_file_leave_sorted_mode(
+	ion_flat_file_t *flat_file
+) {
+	flat_file->sorted_mode = boolean_false;
+
+	ion_err_t err = flat_file_write_header(flat_file);
+
+	if (err_ok != err) {
+		flat_file->sorted_mode = boolean_true;
+		return err;
+	}
+
+	flat_file->resortable = boolean_false;
+	flat_file_zone_map_invalidate(flat_file);
+
+	return err_ok;
+}
+
 ion_err_t
 flat_file_initialize(
 	ion_flat_file_t			*flat_file,
@@ -50,6 +625,7 @@ flat_file_initialize(
 		dictionary_size = 1;
 	}
 
+	flat_file->super.id					= id;
 	flat_file->super.key_type			= key_type;
 	flat_file->super.record.key_size	= key_size;
 	flat_file->super.record.value_size	= value_size;
@@ -61,61 +637,72 @@ flat_file_initialize(
 		return err_uninitialized;
 	}
 
-	flat_file->sorted_mode				= boolean_false;/* By default, we don't use sorted mode */
-	flat_file->num_buffered				= dictionary_size;
-	flat_file->current_loaded_region	= -1;	/* No loaded region yet */
+	flat_file->sorted_mode					= boolean_false;/* By default, we don't use sorted mode */
+	flat_file->resortable					= boolean_false;
+	flat_file->interpolation_search			= boolean_false;
+	flat_file->num_buffered					= dictionary_size;
+	flat_file->reader.current_loaded_region = -1;	/* No loaded region yet */
+	flat_file->reader.num_in_buffer			= 0;
+	flat_file->zone_map						= NULL;
+	flat_file->zone_map_capacity			= 0;
+	flat_file->zone_map_valid				= boolean_false;
+
+	flat_file->data_file					= flat_file_open(filename, id, boolean_false);
+
+	if (ION_FILE_IS_NULL(flat_file->data_file)) {
+		/* Failed to open, even to create */
+		return err_file_open_error;
+	}
 
-	flat_file->data_file				= fopen(filename, "r+b");
+	/* The header records whether the data file was left in sorted mode, e.g. by @ref flat_file_sort. */
+	int header = ION_FLAT_FILE_HEADER_UNSORTED;
 
-	if (NULL == flat_file->data_file) {
-		/* The file did not exist - lets open to write */
-		flat_file->data_file = fopen(filename, "w+b");
+	if ((err_ok == ion_fread(flat_file->data_file, sizeof(header), (ion_byte_t *) &header)) && ((ION_FLAT_FILE_HEADER_SORTED == header) || (ION_FLAT_FILE_HEADER_RESORTABLE == header))) {
+		flat_file->sorted_mode	= boolean_true;
+		flat_file->resortable	= ION_FLAT_FILE_HEADER_RESORTABLE == header;
+	}
 
-		if (NULL == flat_file->data_file) {
-			/* Failed to open, even to create */
-			return err_file_open_error;
-		}
+	if (err_ok != flat_file_write_header(flat_file)) {
+		ion_fclose(flat_file->data_file);
+		return err_file_write_error;
 	}
 
-	/* For now, we don't have any header information. But we write some garbage there just so that
-	   we can verify that the code to handle the header is working.*/
-	fwrite(&(int) { 0xADDE }, sizeof(int), 1, flat_file->data_file);
-	flat_file->start_of_data = ftell(flat_file->data_file);
+	flat_file->start_of_data = ion_ftell(flat_file->data_file);
 
 	if (-1 == flat_file->start_of_data) {
-		fclose(flat_file->data_file);
+		ion_fclose(flat_file->data_file);
 		return err_file_read_error;
 	}
 
 	/* A record is laid out as: | STATUS |	  KEY	 |	   VALUE	  | */
 	/*				   Bytes:	(1)	 (key_size)   (value_size)	*/
 	flat_file->row_size = sizeof(ion_flat_file_row_status_t) + key_size + value_size;
-	flat_file->buffer	= calloc(flat_file->num_buffered, flat_file->row_size);
+	flat_file->reader.buffer	= calloc(flat_file->num_buffered, flat_file->row_size);
 
-	if (NULL == flat_file->buffer) {
-		fclose(flat_file->data_file);
+	if (NULL == flat_file->reader.buffer) {
+		ion_fclose(flat_file->data_file);
 		return err_out_of_memory;
 	}
 
-	if (0 != fseek(flat_file->data_file, 0, SEEK_END)) {
-		fclose(flat_file->data_file);
+	if (err_ok != ion_fseek(flat_file->data_file, 0, ION_FILE_END)) {
+		ion_fclose(flat_file->data_file);
 		return err_file_bad_seek;
 	}
 
-	flat_file->eof_position = ftell(flat_file->data_file);
+	flat_file->eof_position = ion_ftell(flat_file->data_file);
 
 	if (-1 == flat_file->eof_position) {
-		fclose(flat_file->data_file);
+		ion_fclose(flat_file->data_file);
 		return err_file_read_error;
 	}
 
 	/* Now move the eof to the last non-empty row in the file */
 	ion_fpos_t			loc = -1;
 	ion_flat_file_row_t row;
-	ion_err_t			err = flat_file_scan(flat_file, -1, &loc, &row, ION_FLAT_FILE_SCAN_BACKWARDS, flat_file_predicate_not_empty);
+	ion_err_t			err = flat_file_scan(flat_file, &flat_file->reader, -1, &loc, &row, ION_FLAT_FILE_SCAN_BACKWARDS, flat_file_predicate_not_empty);
 
 	if ((err_ok != err) && (err_file_hit_eof != err)) {
-		fclose(flat_file->data_file);
+		ion_fclose(flat_file->data_file);
 		return err;
 	}
 
@@ -127,6 +714,9 @@ flat_file_initialize(
 	/* Move to its final position as one-past the position found. */
 	flat_file->eof_position = flat_file->start_of_data + (loc + 1) * flat_file->row_size;
 
+	flat_file_zone_map_load(flat_file, id);
+	ION_MUTEX_INIT(flat_file->zone_map_latch);
+
 	return err_ok;
 }
 
@@ -144,18 +734,49 @@ flat_file_destroy(
 
 	dictionary_get_filename(flat_file->super.id, "ffs", filename);
 
-	if (0 != fremove(filename)) {
+	if (err_ok != ion_fremove(filename)) {
 		return err_file_delete_error;
 	}
 
-	flat_file->data_file = NULL;
+	/* The zone map is only persisted on a clean close, so it may legitimately not exist. */
+	dictionary_get_filename(flat_file->super.id, ION_FLAT_FILE_ZONE_MAP_EXTENSION, filename);
+	ion_fremove(filename);
+
+	flat_file->data_file = ION_NOFILE;
+
+	return err_ok;
+}
+
+ion_err_t
+flat_file_open_reader(
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader
+) {
+	reader->buffer					= calloc(flat_file->num_buffered, flat_file->row_size);
+	reader->current_loaded_region	= -1;
+	reader->num_in_buffer			= 0;
+
+	if (NULL == reader->buffer) {
+		return err_out_of_memory;
+	}
 
 	return err_ok;
 }
 
+void
+flat_file_close_reader(
+	ion_flat_file_reader_t *reader
+) {
+	free(reader->buffer);
+	reader->buffer					= NULL;
+	reader->current_loaded_region	= -1;
+	reader->num_in_buffer			= 0;
+}
+
 ion_err_t
 flat_file_scan(
 	ion_flat_file_t				*flat_file,
+	ion_flat_file_reader_t		*reader,
 	ion_fpos_t					start_location,
 	ion_fpos_t					*location,
 	ion_flat_file_row_t			*row,
@@ -185,9 +806,38 @@ flat_file_scan(
 		return err_out_of_bounds;
 	}
 
+	/* Key matches and range scans going forwards can consult the zone map to skip whole blocks. */
+	ion_boolean_t	use_zone_map	= boolean_false;
+	ion_key_t		lower_bound		= NULL;
+	ion_key_t		upper_bound		= NULL;
+
+	if ((ION_FLAT_FILE_SCAN_FORWARDS == scan_direction) && ((flat_file_predicate_key_match == predicate) || (flat_file_predicate_within_bounds == predicate))) {
+		va_list predicate_arguments;
+
+		va_start(predicate_arguments, predicate);
+		lower_bound = va_arg(predicate_arguments, ion_key_t);
+		upper_bound = flat_file_predicate_key_match == predicate ? lower_bound : va_arg(predicate_arguments, ion_key_t);
+		va_end(predicate_arguments);
+
+		use_zone_map = flat_file_zone_map_ready(flat_file, reader);
+	}
+
 	while (cur_offset != end_offset) {
-		if (0 != fseek(flat_file->data_file, cur_offset, SEEK_SET)) {
-			return err_file_bad_seek;
+		size_t records_left_in_block = flat_file->num_buffered;
+
+		if (use_zone_map) {
+			ion_fpos_t	row_index	= (cur_offset - flat_file->start_of_data) / flat_file->row_size;
+			ion_fpos_t	block		= row_index / flat_file->num_buffered;
+
+			if (!flat_file_zone_map_might_overlap(flat_file, block, lower_bound, upper_bound)) {
+				ion_fpos_t next_block_offset = flat_file->start_of_data + (block + 1) * flat_file->num_buffered * flat_file->row_size;
+
+				cur_offset = next_block_offset < end_offset ? next_block_offset : end_offset;
+				continue;
+			}
+
+			/* Stop the read at the block boundary, so that the next read lines up with the zone map. */
+			records_left_in_block = (block + 1) * flat_file->num_buffered - row_index;
 		}
 
 		/* We set cur_offset to be the next block to read after this next code segment, so */
@@ -199,15 +849,8 @@ flat_file_scan(
 			/* It's possible for this to do a partial read (if you're close to EOF), calculate how many we need to read */
 			size_t records_left = (end_offset - cur_offset) / flat_file->row_size;
 
-			num_records_to_process = records_left > (unsigned) flat_file->num_buffered ? (unsigned) flat_file->num_buffered : records_left;
-
-			if (num_records_to_process != fread(flat_file->buffer, flat_file->row_size, num_records_to_process, flat_file->data_file)) {
-				return err_file_read_error;
-			}
-
-			if (-1 == (cur_offset = ftell(flat_file->data_file))) {
-				return err_file_read_error;
-			}
+			num_records_to_process = records_left > records_left_in_block ? records_left_in_block : records_left;
+			cur_offset			   += flat_file->row_size * num_records_to_process;
 		}
 		else {
 			/* Move the offset pointer to the next read location, clamp it at start_of_file if we go too far. */
@@ -219,20 +862,19 @@ flat_file_scan(
 				cur_offset				= flat_file->start_of_data;
 			}
 
-			if (0 != fseek(flat_file->data_file, cur_offset, SEEK_SET)) {
-				return err_file_bad_seek;
-			}
-
-			if (num_records_to_process != fread(flat_file->buffer, flat_file->row_size, num_records_to_process, flat_file->data_file)) {
-				return err_file_read_error;
-			}
-
 			/* In this case, the prev_offset is actually the cur_offset. */
 			prev_offset = cur_offset;
 		}
 
-		flat_file->current_loaded_region	= (prev_offset - flat_file->start_of_data) / flat_file->row_size;
-		flat_file->num_in_buffer			= num_records_to_process;
+		/* Positional reads leave the data file where it is, so readers do not get in each other's way. */
+		reader->current_loaded_region = -1;
+
+		if (err_ok != ion_fread_at(flat_file->data_file, prev_offset, flat_file->row_size * num_records_to_process, reader->buffer)) {
+			return err_file_read_error;
+		}
+
+		reader->current_loaded_region	= (prev_offset - flat_file->start_of_data) / flat_file->row_size;
+		reader->num_in_buffer			= num_records_to_process;
 
 		int32_t i;
 
@@ -240,9 +882,9 @@ flat_file_scan(
 			size_t cur_rec = i * flat_file->row_size;
 
 			/* This cast is done because in the future, the status could possibly be a non-byte type */
-			row->row_status = *((ion_flat_file_row_status_t *) &flat_file->buffer[cur_rec]);
-			row->key		= &flat_file->buffer[cur_rec + sizeof(ion_flat_file_row_status_t)];
-			row->value		= &flat_file->buffer[cur_rec + sizeof(ion_flat_file_row_status_t) + flat_file->super.record.key_size];
+			row->row_status = *((ion_flat_file_row_status_t *) &reader->buffer[cur_rec]);
+			row->key		= &reader->buffer[cur_rec + sizeof(ion_flat_file_row_status_t)];
+			row->value		= &reader->buffer[cur_rec + sizeof(ion_flat_file_row_status_t) + flat_file->super.record.key_size];
 
 			va_list predicate_arguments;
 
@@ -323,23 +965,24 @@ flat_file_write_row(
 	ion_fpos_t			location,
 	ion_flat_file_row_t *row
 ) {
-	/* Invalidate the region cache, since data will be mutated. */
-	flat_file->current_loaded_region	= -1;
-	flat_file->num_in_buffer			= 0;
+	/* Invalidate the region cache, since data will be mutated. Cursors, which have their
+	   own readers, cannot be open while a writer runs. */
+	flat_file->reader.current_loaded_region = -1;
+	flat_file->reader.num_in_buffer			= 0;
 
-	if (0 != fseek(flat_file->data_file, flat_file->start_of_data + location * flat_file->row_size, SEEK_SET)) {
+	if (err_ok != ion_fseek(flat_file->data_file, flat_file->start_of_data + location * flat_file->row_size, ION_FILE_START)) {
 		return err_file_bad_seek;
 	}
 
-	if (1 != fwrite(&row->row_status, sizeof(row->row_status), 1, flat_file->data_file)) {
+	if (err_ok != ion_fwrite(flat_file->data_file, sizeof(row->row_status), (ion_byte_t *) &row->row_status)) {
 		return err_file_write_error;
 	}
 
-	if ((NULL != row->key) && (1 != fwrite(row->key, flat_file->super.record.key_size, 1, flat_file->data_file))) {
+	if ((NULL != row->key) && (err_ok != ion_fwrite(flat_file->data_file, flat_file->super.record.key_size, row->key))) {
 		return err_file_write_error;
 	}
 
-	if ((NULL != row->value) && (1 != fwrite(row->value, flat_file->super.record.value_size, 1, flat_file->data_file))) {
+	if ((NULL != row->value) && (err_ok != ion_fwrite(flat_file->data_file, flat_file->super.record.value_size, row->value))) {
 		return err_file_write_error;
 	}
 
@@ -348,38 +991,32 @@ flat_file_write_row(
 
 ion_err_t
 flat_file_read_row(
-	ion_flat_file_t		*flat_file,
-	ion_fpos_t			location,
-	ion_flat_file_row_t *row
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader,
+	ion_fpos_t				location,
+	ion_flat_file_row_t		*row
 ) {
 	ion_fpos_t read_index = 0;
 
-	if ((flat_file->current_loaded_region != -1) && (location >= flat_file->current_loaded_region) && ((unsigned) location < flat_file->current_loaded_region + flat_file->num_in_buffer)) {
+	if ((reader->current_loaded_region != -1) && (location >= reader->current_loaded_region) && ((unsigned) location < reader->current_loaded_region + reader->num_in_buffer)) {
 		/* Cache hit, return directly from buffer */
-		read_index = location - flat_file->current_loaded_region;
+		read_index = location - reader->current_loaded_region;
 	}
 	else {
-		/* Cache miss, have to re-read from file */
-		if (0 != fseek(flat_file->data_file, flat_file->start_of_data + location * flat_file->row_size, SEEK_SET)) {
-			return err_file_bad_seek;
-		}
-
-		if (1 != fread(flat_file->buffer, sizeof(row->row_status), 1, flat_file->data_file)) {
-			return err_file_write_error;
-		}
+		/* Cache miss, have to re-read from file into the start of the buffer */
+		reader->current_loaded_region = -1;
 
-		if (1 != fread(flat_file->buffer + sizeof(row->row_status), flat_file->super.record.key_size, 1, flat_file->data_file)) {
-			return err_file_write_error;
+		if (err_ok != ion_fread_at(flat_file->data_file, flat_file->start_of_data + location * flat_file->row_size, flat_file->row_size, reader->buffer)) {
+			return err_file_read_error;
 		}
 
-		if (1 != fread(flat_file->buffer + sizeof(row->row_status) + flat_file->super.record.key_size, flat_file->super.record.value_size, 1, flat_file->data_file)) {
-			return err_file_write_error;
-		}
+		reader->current_loaded_region	= location;
+		reader->num_in_buffer			= 1;
 	}
 
-	row->row_status = *((ion_flat_file_row_status_t *) &flat_file->buffer[read_index * flat_file->row_size]);
-	row->key		= &flat_file->buffer[read_index * flat_file->row_size + sizeof(ion_flat_file_row_status_t)];
-	row->value		= &flat_file->buffer[read_index * flat_file->row_size + sizeof(ion_flat_file_row_status_t) + flat_file->super.record.key_size];
+	row->row_status = *((ion_flat_file_row_status_t *) &reader->buffer[read_index * flat_file->row_size]);
+	row->key		= &reader->buffer[read_index * flat_file->row_size + sizeof(ion_flat_file_row_status_t)];
+	row->value		= &reader->buffer[read_index * flat_file->row_size + sizeof(ion_flat_file_row_status_t) + flat_file->super.record.key_size];
 
 	return err_ok;
 }
@@ -393,7 +1030,7 @@ flat_file_insert(
 	ion_status_t	status	= ION_STATUS_INITIALIZE;
 	ion_err_t		err;
 	/* We can assume append-only insert here because our delete operation does a swap replacement, and
-	   in sorted mode, we don't allow deletes - so there are no holes to fill. */
+	   in sorted mode, deletes are either refused or made after leaving sorted mode - so there are no holes to fill. */
 	ion_fpos_t insert_loc	= (flat_file->eof_position - flat_file->start_of_data) / flat_file->row_size;
 
 	if (flat_file->sorted_mode) {
@@ -401,7 +1038,7 @@ flat_file_insert(
 		ion_flat_file_row_t row;
 
 		if (last_record_loc >= 0) {
-			err = flat_file_read_row(flat_file, last_record_loc, &row);
+			err = flat_file_read_row(flat_file, &flat_file->reader, last_record_loc, &row);
 
 			if (err_ok != err) {
 				status.error = err;
@@ -409,8 +1046,17 @@ flat_file_insert(
 			}
 
 			if (flat_file->super.compare(key, row.key, flat_file->super.record.key_size) < 0) {
-				status.error = err_sorted_order_violation;
-				return status;
+				if (!flat_file->resortable) {
+					status.error = err_sorted_order_violation;
+					return status;
+				}
+
+				err = flat_file_leave_sorted_mode(flat_file);
+
+				if (err_ok != err) {
+					status.error = err;
+					return status;
+				}
 			}
 		}
 	}
@@ -422,8 +1068,13 @@ flat_file_insert(
 		return status;
 	}
 
+	if (flat_file->zone_map_valid && (err_ok != flat_file_zone_map_include(flat_file, insert_loc, key, 0 == insert_loc % flat_file->num_buffered))) {
+		/* Out of memory to track the new block, fall back to a rebuild when next needed. */
+		flat_file_zone_map_invalidate(flat_file);
+	}
+
 	/* Record new eof position */
-	flat_file->eof_position = ftell(flat_file->data_file);
+	flat_file->eof_position = ion_ftell(flat_file->data_file);
 
 	if (-1 == flat_file->eof_position) {
 		status.error = err_file_read_error;
@@ -435,11 +1086,15 @@ flat_file_insert(
 	return status;
 }
 
-ion_status_t
-flat_file_get(
-	ion_flat_file_t *flat_file,
-	ion_key_t		key,
-	ion_value_t		value
+/**
+@brief		Looks up a key through the given reader.
+*/
+static ion_status_t
+flat_file_get_through(
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader,
+	ion_key_t				key,
+	ion_value_t				value
 ) {
 	ion_status_t		status		= ION_STATUS_INITIALIZE;
 	ion_err_t			err;
@@ -447,7 +1102,7 @@ flat_file_get(
 	ion_flat_file_row_t row;
 
 	if (!flat_file->sorted_mode) {
-		err = flat_file_scan(flat_file, -1, &found_loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key);
+		err = flat_file_scan(flat_file, reader, -1, &found_loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key);
 
 		if (err_ok != err) {
 			if (err_file_hit_eof == err) {
@@ -464,14 +1119,14 @@ flat_file_get(
 		}
 	}
 	else {
-		err = flat_file_binary_search(flat_file, key, &found_loc);
+		err = flat_file_binary_search(flat_file, reader, key, &found_loc);
 
 		if (err_ok != err) {
 			status.error = err;
 			return status;
 		}
 
-		err = flat_file_read_row(flat_file, found_loc, &row);
+		err = flat_file_read_row(flat_file, reader, found_loc, &row);
 
 		if (err_ok != err) {
 			status.error = err;
@@ -492,20 +1147,67 @@ flat_file_get(
 }
 
 ion_status_t
-flat_file_delete(
+flat_file_get(
 	ion_flat_file_t *flat_file,
-	ion_key_t		key
+	ion_key_t		key,
+	ion_value_t		value
 ) {
-	if (flat_file->sorted_mode) {
-		return ION_STATUS_ERROR(err_sorted_order_violation);
+#if ION_THREAD_SAFE
+	/* Gets run concurrently, so each one reads through a reader of its own. */
+	ion_flat_file_reader_t	reader;
+	ion_err_t				err = flat_file_open_reader(flat_file, &reader);
+
+	if (err_ok != err) {
+		return ION_STATUS_ERROR(err);
 	}
 
+	ion_status_t status = flat_file_get_through(flat_file, &reader, key, value);
+
+	flat_file_close_reader(&reader);
+
+	return status;
+#else
+	return flat_file_get_through(flat_file, &flat_file->reader, key, value);
+#endif
+}
+
+ion_status_t
+flat_file_delete(
+	ion_flat_file_t *flat_file,
+	ion_key_t		key
+) {
 	ion_status_t		status	= ION_STATUS_INITIALIZE;
 	ion_flat_file_row_t row;
 	ion_err_t			err;
 	ion_fpos_t			loc		= -1;
 
-	while (err_ok == (err = flat_file_scan(flat_file, loc, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key))) {
+	if (flat_file->sorted_mode) {
+		if (!flat_file->resortable) {
+			return ION_STATUS_ERROR(err_sorted_order_violation);
+		}
+
+		/* Only leave sorted mode if there is a row to delete. The scan below then starts from
+		   the first row with the key, which is where the search left off. */
+		err = flat_file_binary_search(flat_file, &flat_file->reader, key, &loc);
+
+		if (err_ok == err) {
+			err = flat_file_read_row(flat_file, &flat_file->reader, loc, &row);
+		}
+
+		if ((err_ok == err) && (0 != flat_file->super.compare(row.key, key, flat_file->super.record.key_size))) {
+			err = err_item_not_found;
+		}
+
+		if (err_ok == err) {
+			err = flat_file_leave_sorted_mode(flat_file);
+		}
+
+		if (err_ok != err) {
+			return ION_STATUS_ERROR(err);
+		}
+	}
+
+	while (err_ok == (err = flat_file_scan(flat_file, &flat_file->reader, loc, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key))) {
 		ion_fpos_t			last_record_offset	= flat_file->eof_position - flat_file->row_size;
 		ion_flat_file_row_t last_row;
 		ion_fpos_t			last_record_index	= (last_record_offset - flat_file->start_of_data) / flat_file->row_size;
@@ -513,7 +1215,7 @@ flat_file_delete(
 
 		/* If the last index and the loc are the same, then we can just move the eof position. Saves a read/write. */
 		if (last_record_index != loc) {
-			row_err = flat_file_read_row(flat_file, last_record_index, &last_row);
+			row_err = flat_file_read_row(flat_file, &flat_file->reader, last_record_index, &last_row);
 
 			if (err_ok != row_err) {
 				status.error = row_err;
@@ -526,6 +1228,11 @@ flat_file_delete(
 				status.error = row_err;
 				return status;
 			}
+
+			/* The block the last row was moved into only has to be widened to stay correct. */
+			if (flat_file->zone_map_valid) {
+				flat_file_zone_map_include(flat_file, loc, last_row.key, boolean_false);
+			}
 		}
 
 		/* Set last row to be empty just for sanity reasons. */
@@ -569,7 +1276,7 @@ flat_file_update(
 	ion_err_t			err;
 
 	if (flat_file->sorted_mode) {
-		err = flat_file_binary_search(flat_file, key, &loc);
+		err = flat_file_binary_search(flat_file, &flat_file->reader, key, &loc);
 
 		if (err_ok != err) {
 			if (err_item_not_found == err) {
@@ -581,7 +1288,7 @@ flat_file_update(
 			return status;
 		}
 
-		err = flat_file_read_row(flat_file, loc, &row);
+		err = flat_file_read_row(flat_file, &flat_file->reader, loc, &row);
 
 		if (err_ok != err) {
 			status.error = err;
@@ -594,7 +1301,7 @@ flat_file_update(
 		}
 	}
 
-	while (err_ok == (err = flat_file_scan(flat_file, loc, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key))) {
+	while (err_ok == (err = flat_file_scan(flat_file, &flat_file->reader, loc, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key))) {
 		ion_err_t row_err = flat_file_write_row(flat_file, loc, &(ion_flat_file_row_t) { ION_FLAT_FILE_STATUS_OCCUPIED, key, value });
 
 		if (err_ok != row_err) {
@@ -620,30 +1327,55 @@ flat_file_update(
 	return status;
 }
 
+ion_err_t
+flat_file_sync(
+	ion_flat_file_t *flat_file
+) {
+	ion_err_t err = flat_file_write_header(flat_file);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	return ion_fsync(flat_file->data_file);
+}
+
 ion_err_t
 flat_file_close(
 	ion_flat_file_t *flat_file
 ) {
-	free(flat_file->buffer);
-	flat_file->buffer = NULL;
+	/* Failing to persist the zone map is not fatal, it will be rebuilt on the next open. */
+	flat_file_zone_map_persist(flat_file);
+	flat_file_zone_map_invalidate(flat_file);
 
-	if (0 != fclose(flat_file->data_file)) {
+	flat_file_close_reader(&flat_file->reader);
+	ION_MUTEX_DESTROY(flat_file->zone_map_latch);
+
+	ion_err_t err = flat_file_write_header(flat_file);
+
+	if (err_ok != ion_fclose(flat_file->data_file)) {
 		return err_file_close_error;
 	}
 
-	return err_ok;
+	return err;
 }
 
 ion_err_t
 flat_file_binary_search(
-	ion_flat_file_t *flat_file,
-	ion_key_t		target_key,
-	ion_fpos_t		*location
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader,
+	ion_key_t				target_key,
+	ion_fpos_t				*location
 ) {
 	if (!flat_file->sorted_mode) {
 		return err_sorted_order_violation;
 	}
 
+	if (flat_file_zone_map_ready(flat_file, reader)) {
+		return flat_file_fence_search(flat_file, reader, target_key, location);
+	}
+
+	/* Not enough memory for the fence index, so binary search the data file directly. */
 	ion_err_t			err;
 	ion_flat_file_row_t row;
 	ion_fpos_t			low_idx		= 0;
@@ -658,7 +1390,7 @@ flat_file_binary_search(
 
 	while (low_idx < high_idx) {
 		mid_idx = low_idx + (high_idx - low_idx) / 2;
-		err		= flat_file_read_row(flat_file, mid_idx, &row);
+		err		= flat_file_read_row(flat_file, reader, mid_idx, &row);
 
 		if (err_ok != err) {
 			return err;
@@ -680,7 +1412,7 @@ flat_file_binary_search(
 			do {
 				last_dup_idx	= dup_idx;
 				dup_idx--;
-				err				= flat_file_read_row(flat_file, dup_idx, &row);
+				err				= flat_file_read_row(flat_file, reader, dup_idx, &row);
 
 				if (err_ok != err) {
 					return err;
@@ -693,7 +1425,7 @@ flat_file_binary_search(
 	}
 
 	/* If we reach here, then we fell through the loop - do check and adjust for LEQ as necessary */
-	err = flat_file_read_row(flat_file, low_idx, &row);
+	err = flat_file_read_row(flat_file, reader, low_idx, &row);
 
 	if (err_ok != err) {
 		return err;
@@ -706,3 +1438,321 @@ flat_file_binary_search(
 	*location = low_idx;
 	return low_idx >= 0 ? err_ok : err_item_not_found;
 }
+
+/**
+@brief		Swaps two rows held in memory.
+@param[in]	flat_file
+				Which flat file instance the rows belong to.
+@param[in]	first_row
+				The first row to swap.
+@param[in]	second_row
+				The second row to swap.
+@param[in]	temp_row
+				Scratch memory of at least one row.
+*/
+void
+flat_file_sort_swap_rows(
+	ion_flat_file_t *flat_file,
+	ion_byte_t		*first_row,
+	ion_byte_t		*second_row,
+	ion_byte_t		*temp_row
+) {
+	memcpy(temp_row, first_row, flat_file->row_size);
+	memcpy(first_row, second_row, flat_file->row_size);
+	memcpy(second_row, temp_row, flat_file->row_size);
+}
+
+/**
+@brief		Sorts rows held in memory by key, using an in-place heap sort.
+@param[in]	flat_file
+				Which flat file instance the rows belong to.
+@param[in]	rows
+				The rows to sort, laid out back to back.
+@param[in]	num_rows
+				How many rows there are.
+@param[in]	temp_row
+				Scratch memory of at least one row.
+*/
+void
+flat_file_sort_rows(
+	ion_flat_file_t *flat_file,
+	ion_byte_t		*rows,
+	size_t			num_rows,
+	ion_byte_t		*temp_row
+) {
+	size_t	row_size	= flat_file->row_size;
+	size_t	key_offset	= sizeof(ion_flat_file_row_status_t);
+	size_t	heap_size	= num_rows;
+	size_t	start		= num_rows / 2;
+
+	/* Heapify first, then repeatedly move the largest row to the end. */
+	while (heap_size > 1) {
+		size_t root;
+
+		if (start > 0) {
+			root = --start;
+		}
+		else {
+			heap_size--;
+			flat_file_sort_swap_rows(flat_file, rows, rows + heap_size * row_size, temp_row);
+			root = 0;
+		}
+
+		size_t child;
+
+		while ((child = 2 * root + 1) < heap_size) {
+			if ((child + 1 < heap_size) && (flat_file->super.compare(rows + child * row_size + key_offset, rows + (child + 1) * row_size + key_offset, flat_file->super.record.key_size) < 0)) {
+				child++;
+			}
+
+			if (flat_file->super.compare(rows + root * row_size + key_offset, rows + child * row_size + key_offset, flat_file->super.record.key_size) >= 0) {
+				break;
+			}
+
+			flat_file_sort_swap_rows(flat_file, rows + root * row_size, rows + child * row_size, temp_row);
+			root = child;
+		}
+	}
+}
+
+/**
+@brief		Merges groups of @ref ION_FLAT_FILE_SORT_FAN_IN consecutive sorted runs into longer runs.
+@param[in]	flat_file
+				Which flat file instance is being sorted.
+@param[in]	inputs
+				@ref ION_FLAT_FILE_SORT_FAN_IN handles open for reading on the file holding the runs.
+@param[in]	output
+				Handle to append the merged runs to.
+@param[in]	num_rows
+				How many rows the runs hold in total.
+@param[in]	run_length
+				How many rows each run holds. Only the last run may be shorter.
+@param[in]	heads
+				Memory for one row per input.
+@return		The status of the merge.
+*/
+ion_err_t
+flat_file_sort_merge_pass(
+	ion_flat_file_t *flat_file,
+	ion_file_handle_t	*inputs,
+	ion_file_handle_t	output,
+	ion_fpos_t		num_rows,
+	ion_fpos_t		run_length,
+	ion_byte_t		*heads
+) {
+	size_t		row_size	= flat_file->row_size;
+	size_t		key_offset	= sizeof(ion_flat_file_row_status_t);
+	ion_fpos_t	remaining[ION_FLAT_FILE_SORT_FAN_IN];
+	ion_fpos_t	group_start;
+	int			i;
+
+	for (group_start = 0; group_start < num_rows; group_start += run_length * ION_FLAT_FILE_SORT_FAN_IN) {
+		for (i = 0; i < ION_FLAT_FILE_SORT_FAN_IN; i++) {
+			ion_fpos_t run_start = group_start + i * run_length;
+
+			remaining[i] = run_start >= num_rows ? 0 : num_rows - run_start > run_length ? run_length : num_rows - run_start;
+
+			if (0 == remaining[i]) {
+				continue;
+			}
+
+			if (err_ok != ion_fread_at(inputs[i], run_start * row_size, row_size, heads + i * row_size)) {
+				return err_file_read_error;
+			}
+		}
+
+		while (boolean_true) {
+			int chosen = -1;
+
+			/* Ties go to the earlier run, which keeps the merge stable. */
+			for (i = 0; i < ION_FLAT_FILE_SORT_FAN_IN; i++) {
+				if ((remaining[i] > 0) && ((-1 == chosen) || (flat_file->super.compare(heads + i * row_size + key_offset, heads + chosen * row_size + key_offset, flat_file->super.record.key_size) < 0))) {
+					chosen = i;
+				}
+			}
+
+			if (-1 == chosen) {
+				break;
+			}
+
+			if (err_ok != ion_fwrite(output, row_size, heads + chosen * row_size)) {
+				return err_file_write_error;
+			}
+
+			if ((--remaining[chosen] > 0) && (err_ok != ion_fread(inputs[chosen], row_size, heads + chosen * row_size))) {
+				return err_file_read_error;
+			}
+		}
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+flat_file_sort(
+	ion_flat_file_t *flat_file
+) {
+	if (flat_file->sorted_mode) {
+		return err_ok;
+	}
+
+	char	data_filename[ION_MAX_FILENAME_LENGTH];
+	char	run_filenames[2][ION_MAX_FILENAME_LENGTH];
+	char	sorted_filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(flat_file->super.id, "ffs", data_filename);
+	dictionary_get_filename(flat_file->super.id, "ffa", run_filenames[0]);
+	dictionary_get_filename(flat_file->super.id, "ffb", run_filenames[1]);
+	dictionary_get_filename(flat_file->super.id, "fft", sorted_filename);
+
+	ion_err_t	err			= err_ok;
+	ion_fpos_t	num_rows	= (flat_file->eof_position - flat_file->start_of_data) / flat_file->row_size;
+	ion_file_handle_t	inputs[ION_FLAT_FILE_SORT_FAN_IN];
+	ion_file_handle_t	output	= ION_NOFILE;
+	int					i;
+
+	for (i = 0; i < ION_FLAT_FILE_SORT_FAN_IN; i++) {
+		inputs[i] = ION_NOFILE;
+	}
+
+	/* One row per run being merged. This doubles as the scratch row for sorting runs in memory. */
+	ion_byte_t *heads		= malloc(ION_FLAT_FILE_SORT_FAN_IN * flat_file->row_size);
+
+	if (NULL == heads) {
+		return err_out_of_memory;
+	}
+
+	/* Cut the data file into runs of num_buffered rows, each sorted in the flat file's own buffer. */
+	flat_file->reader.current_loaded_region = -1;
+	flat_file->reader.num_in_buffer			= 0;
+	output									= flat_file_open(run_filenames[0], flat_file->super.id, boolean_true);
+
+	if (ION_FILE_IS_NULL(output)) {
+		err = err_file_open_error;
+		goto CLEANUP;
+	}
+
+	ion_fpos_t row_index = 0;
+
+	while (row_index < num_rows) {
+		size_t num_records_to_process = num_rows - row_index > flat_file->num_buffered ? (size_t) flat_file->num_buffered : (size_t) (num_rows - row_index);
+
+		if (err_ok != ion_fseek(flat_file->data_file, flat_file->start_of_data + row_index * flat_file->row_size, ION_FILE_START)) {
+			err = err_file_bad_seek;
+			goto CLEANUP;
+		}
+
+		if (err_ok != ion_fread(flat_file->data_file, flat_file->row_size * num_records_to_process, flat_file->reader.buffer)) {
+			err = err_file_read_error;
+			goto CLEANUP;
+		}
+
+		flat_file_sort_rows(flat_file, flat_file->reader.buffer, num_records_to_process, heads);
+
+		if (err_ok != ion_fwrite(output, flat_file->row_size * num_records_to_process, flat_file->reader.buffer)) {
+			err = err_file_write_error;
+			goto CLEANUP;
+		}
+
+		row_index += num_records_to_process;
+	}
+
+	/* Merge the runs back and forth between the two run files, until a single pass
+	   can write out the whole sorted result. */
+	ion_fpos_t		run_length	= flat_file->num_buffered;
+	int				source		= 0;
+	ion_boolean_t	final_pass	= boolean_false;
+
+	while (!final_pass) {
+		if (err_ok != ion_fclose(output)) {
+			output	= ION_NOFILE;
+			err		= err_file_close_error;
+			goto CLEANUP;
+		}
+
+		final_pass	= run_length * ION_FLAT_FILE_SORT_FAN_IN >= num_rows;
+		output		= flat_file_open(final_pass ? sorted_filename : run_filenames[1 - source], flat_file->super.id, boolean_true);
+
+		if (ION_FILE_IS_NULL(output)) {
+			err = err_file_open_error;
+			goto CLEANUP;
+		}
+
+		if (final_pass && (err_ok != ion_fwrite(output, sizeof(int), (ion_byte_t *) &(int) { ION_FLAT_FILE_HEADER_RESORTABLE }))) {
+			err = err_file_write_error;
+			goto CLEANUP;
+		}
+
+		for (i = 0; i < ION_FLAT_FILE_SORT_FAN_IN; i++) {
+			inputs[i] = flat_file_open(run_filenames[source], flat_file->super.id, boolean_false);
+
+			if (ION_FILE_IS_NULL(inputs[i])) {
+				err = err_file_open_error;
+				goto CLEANUP;
+			}
+		}
+
+		err = flat_file_sort_merge_pass(flat_file, inputs, output, num_rows, run_length, heads);
+
+		for (i = 0; i < ION_FLAT_FILE_SORT_FAN_IN; i++) {
+			ion_fclose(inputs[i]);
+			inputs[i] = ION_NOFILE;
+		}
+
+		if (err_ok != err) {
+			goto CLEANUP;
+		}
+
+		run_length	*= ION_FLAT_FILE_SORT_FAN_IN;
+		source		= 1 - source;
+	}
+
+	if (err_ok != ion_fclose(output)) {
+		output	= ION_NOFILE;
+		err		= err_file_close_error;
+		goto CLEANUP;
+	}
+
+	output = ION_NOFILE;
+
+	/* Swap the sorted file in. Until the rename, the original data file is untouched. */
+	if (err_ok != ion_fclose(flat_file->data_file)) {
+		flat_file->data_file	= flat_file_open(data_filename, flat_file->super.id, boolean_false);
+		err						= err_file_close_error;
+		goto CLEANUP;
+	}
+
+	err						= ion_frename(sorted_filename, data_filename);
+	flat_file->data_file	= flat_file_open(data_filename, flat_file->super.id, boolean_false);
+
+	if (ION_FILE_IS_NULL(flat_file->data_file)) {
+		err = err_file_open_error;
+		goto CLEANUP;
+	}
+
+	if (err_ok == err) {
+		flat_file->sorted_mode	= boolean_true;
+		flat_file->resortable	= boolean_true;
+		/* The unsorted zone map bounds are not exact first keys, so it cannot be used as a fence index. */
+		flat_file_zone_map_invalidate(flat_file);
+	}
+
+CLEANUP:
+
+	for (i = 0; i < ION_FLAT_FILE_SORT_FAN_IN; i++) {
+		if (!ION_FILE_IS_NULL(inputs[i])) {
+			ion_fclose(inputs[i]);
+		}
+	}
+
+	if (!ION_FILE_IS_NULL(output)) {
+		ion_fclose(output);
+	}
+
+	free(heads);
+	ion_fremove(run_filenames[0]);
+	ion_fremove(run_filenames[1]);
+	ion_fremove(sorted_filename);
+
+	return err;
+}
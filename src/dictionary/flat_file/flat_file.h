@@ -50,7 +50,8 @@ extern "C" {
 			instead of an initialize. The flat file supports a special mode called "sorted mode". This
 			is an append only mode that assumes all keys come in monotonic non-decreasing order. In this
 			mode, search operations are significantly faster, but the store does not support deletions while
-			in sorted mode.
+			in sorted mode. A flat file put in sorted mode by @ref flat_file_sort is the exception: an
+			insert out of order or a delete takes it back out of sorted mode instead.
 @param[in]	flat_file
 				Given instance of a flat file struct to initialize. This must be allocated **heap** memory,
 				as destruction will assume that it needs to be freed.
@@ -170,6 +171,56 @@ flat_file_close(
 	ion_flat_file_t *flat_file
 );
 
+/**
+@brief		Writes the header at the start of the data file, recording whether
+			or not the flat file is in sorted mode.
+@param[in]	flat_file
+				Which flat file instance to write the header of.
+@return		The status of the write.
+*/
+ion_err_t
+flat_file_write_header(
+	ion_flat_file_t *flat_file
+);
+
+/**
+@brief		Writes the header and forces the data file to the device.
+@param		flat_file
+				Which flat file to sync.
+@return		Status of the sync.
+*/
+ion_err_t
+flat_file_sync(
+	ion_flat_file_t *flat_file
+);
+
+/**
+@brief		Sets up a reader with a buffer of its own, so that it can read the
+			flat file concurrently with other readers.
+@details	Readers are only needed by thread-safe builds. Every other access goes
+			through the flat file's own reader, which writers also use.
+@param[in]	flat_file
+				Which flat file instance the reader will read.
+@param[out]	reader
+				The reader to set up.
+@return		The status of the setup.
+*/
+ion_err_t
+flat_file_open_reader(
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader
+);
+
+/**
+@brief		Frees the buffer of a reader set up by @ref flat_file_open_reader.
+@param[in]	reader
+				The reader to close.
+*/
+void
+flat_file_close_reader(
+	ion_flat_file_reader_t *reader
+);
+
 /**
 @brief			Performs a linear scan of the flat file writing the first location
 				seen that satisfies the given @p predicate to @p location.
@@ -180,6 +231,8 @@ flat_file_close(
 				in determining whether or not the row is a match.
 @param[in]		flat_file
 					Which flat file instance to scan.
+@param[in]		reader
+					Which reader to read the rows through. The found row lives in its buffer.
 @param[in]		start_location
 					Where to begin the scan. This is given as a row index. If
 					given as -1, then it is assumed to be either the start of
@@ -202,6 +255,7 @@ flat_file_close(
 ion_err_t
 flat_file_scan(
 	ion_flat_file_t				*flat_file,
+	ion_flat_file_reader_t		*reader,
 	ion_fpos_t					start_location,
 	ion_fpos_t					*location,
 	ion_flat_file_row_t			*row,
@@ -252,16 +306,18 @@ flat_file_predicate_not_empty(
 @brief		Reads the row specified by the given location into the buffer.
 @details	The returned row is given by attaching pointers correctly from
 			the given row parameter. These pointers are associated with the
-			internal read buffer of the flat file. You should assume that the
+			read buffer of the @p reader. You should assume that the
 			row does not have a lifetime beyond the scope of where you call
 			this function - any subsequent operation that mutates the read buffer
 			will cause the row to become garbage. Copy the row data out if you want
 			it to persist. If the requested row has already been loaded by a prior
 			call to @ref flat_file_scan, then it will retrieve it as a cache hit
-			directly from the buffer. Otherwise, it will do a seek and read to fetch
+			directly from the buffer. Otherwise, it will do a positional read to fetch
 			the row.
 @param[in]	flat_file
 				Which flat file instance to read from.
+@param[in]	reader
+				Which reader to read the row through.
 @param[in]	location
 				Which row index to read. This function will compute
 				the file offset of the row index.
@@ -271,9 +327,10 @@ flat_file_predicate_not_empty(
 */
 ion_err_t
 flat_file_read_row(
-	ion_flat_file_t		*flat_file,
-	ion_fpos_t			location,
-	ion_flat_file_row_t *row
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader,
+	ion_fpos_t				location,
+	ion_flat_file_row_t		*row
 );
 
 /**
@@ -285,8 +342,13 @@ flat_file_read_row(
 			the returned index points to the first key in a contiguous block of duplicate keys. If
 			no key in the flat file satisfies the condition of being less-than-or-equal, then @p -1
 			is written back to @p location. This function will only return records that are not deleted.
+			The search is done in memory over the fence index (the first key of every block), followed by
+			a single block read. If there is not enough memory for the fence index, the data file is
+			binary searched directly instead.
 @param[in]		flat_file
 				Which flat file instance to search within.
+@param[in]		reader
+				Which reader to read the data file through.
 @param[in]		target_key
 				Desired key to search for.
 @param[out]		location
@@ -295,9 +357,30 @@ flat_file_read_row(
 */
 ion_err_t
 flat_file_binary_search(
-	ion_flat_file_t *flat_file,
-	ion_key_t		target_key,
-	ion_fpos_t		*location
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_reader_t	*reader,
+	ion_key_t				target_key,
+	ion_fpos_t				*location
+);
+
+/**
+@brief		Converts an unsorted flat file into a sorted one, after which it runs in sorted mode.
+@details	This is a bounded memory external merge sort. The data file is cut into runs
+			of @p num_buffered rows, which are sorted in the flat file's buffer and written
+			to a run file. The runs are then merged @ref ION_FLAT_FILE_SORT_FAN_IN at a time
+			until one pass can write the sorted result into a new data file. The new data file
+			is then renamed over the old one, so the old data stays intact until the swap.
+			Sorted mode is recorded in the data file header and kept on later opens, until an
+			insert out of order or a delete takes the flat file back out of it. The flat file
+			can then be sorted again, so unsorted ingest and sorting can alternate.
+			Nothing is done if the flat file is already in sorted mode.
+@param[in]	flat_file
+				Which flat file instance to sort.
+@return		The status of the sort. On failure the flat file is left unsorted.
+*/
+ion_err_t
+flat_file_sort(
+	ion_flat_file_t *flat_file
 );
 
 #if defined(__cplusplus)
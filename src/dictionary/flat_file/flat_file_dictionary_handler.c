@@ -70,19 +70,19 @@ ffdict_next(
 
 			switch (cursor->predicate->type) {
 				case predicate_equality: {
-					err = flat_file_scan(flat_file, flat_file_cursor->current_location + 1, &flat_file_cursor->current_location, &throwaway_row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, cursor->predicate->statement.equality.equality_value);
+					err = flat_file_scan(flat_file, flat_file_cursor->reader, flat_file_cursor->current_location + 1, &flat_file_cursor->current_location, &throwaway_row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, cursor->predicate->statement.equality.equality_value);
 
 					break;
 				}
 
 				case predicate_range: {
-					err = flat_file_scan(flat_file, flat_file_cursor->current_location + 1, &flat_file_cursor->current_location, &throwaway_row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_within_bounds, cursor->predicate->statement.range.lower_bound, cursor->predicate->statement.range.upper_bound);
+					err = flat_file_scan(flat_file, flat_file_cursor->reader, flat_file_cursor->current_location + 1, &flat_file_cursor->current_location, &throwaway_row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_within_bounds, cursor->predicate->statement.range.lower_bound, cursor->predicate->statement.range.upper_bound);
 
 					break;
 				}
 
 				case predicate_all_records: {
-					err = flat_file_scan(flat_file, flat_file_cursor->current_location + 1, &flat_file_cursor->current_location, &throwaway_row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_not_empty);
+					err = flat_file_scan(flat_file, flat_file_cursor->reader, flat_file_cursor->current_location + 1, &flat_file_cursor->current_location, &throwaway_row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_not_empty);
 
 					break;
 				}
@@ -107,7 +107,7 @@ ffdict_next(
 		}
 
 		ion_flat_file_row_t row;
-		ion_err_t			err = flat_file_read_row(flat_file, flat_file_cursor->current_location, &row);
+		ion_err_t			err = flat_file_read_row(flat_file, flat_file_cursor->reader, flat_file_cursor->current_location, &row);
 
 		if (err_ok != err) {
 			return cs_invalid_index;
@@ -123,6 +123,158 @@ ffdict_next(
 	return cs_invalid_cursor;
 }
 
+/**
+@brief			Tests a row sitting in the flat file buffer against the predicate of a cursor.
+@details		This mirrors the flat file scan predicates, but avoids the variadic call so that
+				rows already loaded into the buffer can be tested in a tight loop.
+@param[in]		cursor
+					Which cursor's predicate to test against.
+@param[in]		row
+					The row to test.
+@return			@c boolean_true if the row satisfies the predicate, @c boolean_false otherwise.
+*/
+ion_boolean_t
+ffdict_row_satisfies_predicate(
+	ion_dict_cursor_t	*cursor,
+	ion_flat_file_row_t *row
+) {
+	ion_dictionary_parent_t *parent = cursor->dictionary->instance;
+
+	if (ION_FLAT_FILE_STATUS_OCCUPIED != row->row_status) {
+		return boolean_false;
+	}
+
+	switch (cursor->predicate->type) {
+		case predicate_equality: {
+			return 0 == parent->compare(cursor->predicate->statement.equality.equality_value, row->key, parent->record.key_size);
+		}
+
+		case predicate_range: {
+			return parent->compare(row->key, cursor->predicate->statement.range.lower_bound, parent->record.key_size) >= 0 && parent->compare(row->key, cursor->predicate->statement.range.upper_bound, parent->record.key_size) <= 0;
+		}
+
+		case predicate_all_records: {
+			return boolean_true;
+		}
+
+		default: {
+			return boolean_false;
+		}
+	}
+}
+
+/**
+@brief			Fetches up to @p max_records records from a cursor that has already been initialized.
+@details		Rows that are already sitting in the cursor's read buffer are tested and copied out
+				directly, and the file is only re-scanned once the buffer has been exhausted. This avoids
+				the block re-read that every individual call to @ref ffdict_next performs. This function
+				should not be called directly, but instead through @ref dictionary_cursor_next_batch.
+@param[in]		cursor
+					Which cursor to fetch results from.
+@param[out]		records
+					An array of at least @p max_records records, each with the @p key and @p value
+					appropriately allocated.
+@param[in]		max_records
+					The maximum number of records to fetch.
+@param[out]		num_records
+					The number of records written back to @p records.
+@return			The resulting status of the operation.
+*/
+ion_cursor_status_t
+ffdict_next_batch(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*records,
+	ion_result_count_t	max_records,
+	ion_result_count_t	*num_records
+) {
+	ion_flat_file_t			*flat_file			= (ion_flat_file_t *) cursor->dictionary->instance;
+	ion_flat_file_cursor_t	*flat_file_cursor	= (ion_flat_file_cursor_t *) cursor;
+	ion_key_size_t			key_size			= flat_file->super.record.key_size;
+	ion_value_size_t		value_size			= flat_file->super.record.value_size;
+	ion_fpos_t				location;
+	ion_flat_file_row_t		row;
+	ion_err_t				err;
+
+	*num_records = 0;
+
+	if ((cs_cursor_initialized != cursor->status) && (cs_cursor_active != cursor->status)) {
+		return cursor->status;
+	}
+
+	if ((0 < max_records) && (cs_cursor_initialized == cursor->status)) {
+		/* The cursor is sitting on its first result, which was located by the find. */
+		if (err_ok != flat_file_read_row(flat_file, flat_file_cursor->reader, flat_file_cursor->current_location, &row)) {
+			return cs_invalid_index;
+		}
+
+		memcpy(records[0].key, row.key, key_size);
+		memcpy(records[0].value, row.value, value_size);
+		*num_records	= 1;
+		cursor->status	= cs_cursor_active;
+	}
+
+	location = flat_file_cursor->current_location + 1;
+
+	while (*num_records < max_records) {
+		ion_flat_file_reader_t *reader = flat_file_cursor->reader;
+
+		if ((-1 != reader->current_loaded_region) && (location >= reader->current_loaded_region) && ((unsigned) location < reader->current_loaded_region + reader->num_in_buffer)) {
+			/* The row is already buffered, so test it in place. */
+			ion_byte_t *buffered = &reader->buffer[(location - reader->current_loaded_region) * flat_file->row_size];
+
+			row.row_status	= *((ion_flat_file_row_status_t *) buffered);
+			row.key			= buffered + sizeof(ion_flat_file_row_status_t);
+			row.value		= buffered + sizeof(ion_flat_file_row_status_t) + key_size;
+
+			if (!ffdict_row_satisfies_predicate(cursor, &row)) {
+				location++;
+				continue;
+			}
+		}
+		else {
+			/* Buffer exhausted, scan forward which loads the next block containing a match. */
+			switch (cursor->predicate->type) {
+				case predicate_equality: {
+					err = flat_file_scan(flat_file, flat_file_cursor->reader, location, &location, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, cursor->predicate->statement.equality.equality_value);
+					break;
+				}
+
+				case predicate_range: {
+					err = flat_file_scan(flat_file, flat_file_cursor->reader, location, &location, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_within_bounds, cursor->predicate->statement.range.lower_bound, cursor->predicate->statement.range.upper_bound);
+					break;
+				}
+
+				case predicate_all_records: {
+					err = flat_file_scan(flat_file, flat_file_cursor->reader, location, &location, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_not_empty);
+					break;
+				}
+
+				default: {
+					err = err_file_hit_eof;
+					break;
+				}
+			}
+
+			if ((err_file_hit_eof == err) || (err_out_of_bounds == err)) {
+				cursor->status = cs_end_of_results;
+				break;
+			}
+			else if (err_ok != err) {
+				cursor->status = cs_possible_data_inconsistency;
+				break;
+			}
+		}
+
+		memcpy(records[*num_records].key, row.key, key_size);
+		memcpy(records[*num_records].value, row.value, value_size);
+		(*num_records)++;
+		flat_file_cursor->current_location	= location;
+		location++;
+	}
+
+	return 0 < *num_records ? cs_cursor_active : cursor->status;
+}
+
 /**
 @brief		Destroys and frees the given cursor.
 @details	This function should not be called directly, but instead accessed through the interface
@@ -134,6 +286,9 @@ void
 ffdict_destroy_cursor(
 	ion_dict_cursor_t **cursor
 ) {
+#if ION_THREAD_SAFE
+	flat_file_close_reader(&((ion_flat_file_cursor_t *) *cursor)->own_reader);
+#endif
 	(*cursor)->predicate->destroy(&(*cursor)->predicate);
 	free(*cursor);
 	*cursor = NULL;
@@ -190,6 +345,108 @@ ffdict_close_dictionary(
 	return err_ok;
 }
 
+/**
+@brief		Forces everything written to this flat file store to the device.
+@param[in]	dictionary
+				Which instance of a flat file store to sync.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+ffdict_sync_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	return flat_file_sync((ion_flat_file_t *) dictionary->instance);
+}
+
+/**
+@brief		Gives the number of rows in a flat file store, for a parallel scan.
+@param[in]	dictionary
+				Which instance of a flat file store to scan.
+@param[out]	num_positions
+				Set to the number of rows, empty ones included.
+@param[out]	position_size
+				Set to the size of a row.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+ffdict_scan_extent(
+	ion_dictionary_t	*dictionary,
+	ion_fpos_t			*num_positions,
+	size_t				*position_size
+) {
+	ion_flat_file_t *flat_file = (ion_flat_file_t *) dictionary->instance;
+
+	*num_positions	= (flat_file->eof_position - flat_file->start_of_data) / flat_file->row_size;
+	*position_size	= flat_file->row_size;
+
+	return err_ok;
+}
+
+/**
+@brief		Reads as many rows of a scan range as fit in the range's buffer, and
+			passes the occupied ones on to the scan.
+@param[in]	dictionary
+				Which instance of a flat file store to scan.
+@param[in]	range
+				The range being read.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+ffdict_scan_range(
+	ion_dictionary_t			*dictionary,
+	ion_dictionary_scan_range_t *range
+) {
+	ion_flat_file_t *flat_file	= (ion_flat_file_t *) dictionary->instance;
+	ion_fpos_t		num_rows	= range->buffer_size / flat_file->row_size;
+	ion_byte_t		*row;
+	ion_err_t		err;
+	ion_fpos_t		i;
+
+	if (num_rows > range->end - range->position) {
+		num_rows = range->end - range->position;
+	}
+
+	err = ion_fread_at(flat_file->data_file, flat_file->start_of_data + range->position * flat_file->row_size, num_rows * flat_file->row_size, range->buffer);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	range->position += num_rows;
+
+	for (i = 0; i < num_rows; i++) {
+		row = range->buffer + i * flat_file->row_size;
+
+		if ((ION_FLAT_FILE_STATUS_OCCUPIED == *((ion_flat_file_row_status_t *) row)) && !dictionary_scan_emit(range, row + sizeof(ion_flat_file_row_status_t), row + sizeof(ion_flat_file_row_status_t) + flat_file->super.record.key_size)) {
+			break;
+		}
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Points a cursor at the reader it reads through.
+@param[in]	flat_file
+				Which flat file instance the cursor reads.
+@param[in]	flat_file_cursor
+				The cursor to set up the reader of.
+@return		The resulting status of the operation.
+*/
+static ion_err_t
+ffdict_cursor_open_reader(
+	ion_flat_file_t			*flat_file,
+	ion_flat_file_cursor_t	*flat_file_cursor
+) {
+#if ION_THREAD_SAFE
+	flat_file_cursor->reader = &flat_file_cursor->own_reader;
+	return flat_file_open_reader(flat_file, flat_file_cursor->reader);
+#else
+	flat_file_cursor->reader = &flat_file->reader;
+	return err_ok;
+#endif
+}
+
 /**
 @brief			Initializes a cursor query and returns an allocated cursor object.
 @details		Given a @p predicate that was previously initialized by @ref dictionary_build_predicate,
@@ -213,17 +470,24 @@ ffdict_find(
 ) {
 	*cursor = malloc(sizeof(ion_flat_file_cursor_t));
 
-	ion_flat_file_t *flat_file = (ion_flat_file_t *) dictionary->instance;
+	ion_flat_file_t			*flat_file			= (ion_flat_file_t *) dictionary->instance;
+	ion_flat_file_cursor_t	*flat_file_cursor	= (ion_flat_file_cursor_t *) (*cursor);
 
 	if (NULL == *cursor) {
 		return err_out_of_memory;
 	}
 
+#if ION_THREAD_SAFE
+	/* The reader is only set up once the predicate has been copied. */
+	flat_file_cursor->own_reader.buffer = NULL;
+#endif
+
 	(*cursor)->dictionary	= dictionary;
 	(*cursor)->status		= cs_cursor_uninitialized;
 
 	(*cursor)->destroy		= ffdict_destroy_cursor;
 	(*cursor)->next			= ffdict_next;
+	(*cursor)->next_batch	= ffdict_next_batch;
 
 	(*cursor)->predicate	= malloc(sizeof(ion_predicate_t));
 
@@ -253,7 +517,12 @@ ffdict_find(
 
 			ion_fpos_t			loc			= -1;
 			ion_flat_file_row_t row;
-			ion_err_t			scan_result = flat_file_scan(flat_file, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, target_key);
+
+			ion_err_t scan_result = ffdict_cursor_open_reader(flat_file, flat_file_cursor);
+
+			if (err_ok == scan_result) {
+				scan_result = flat_file_scan(flat_file, flat_file_cursor->reader, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, target_key);
+			}
 
 			if (err_file_hit_eof == scan_result) {
 				/* If this happens, that means the target key doesn't exist */
@@ -261,11 +530,8 @@ ffdict_find(
 				return err_ok;
 			}
 			else if (err_ok == scan_result) {
-				(*cursor)->status = cs_cursor_initialized;
-
-				ion_flat_file_cursor_t *flat_file_cursor = (ion_flat_file_cursor_t *) (*cursor);
-
-				flat_file_cursor->current_location = loc;
+				(*cursor)->status					= cs_cursor_initialized;
+				flat_file_cursor->current_location	= loc;
 				return err_ok;
 			}
 			else {
@@ -301,7 +567,12 @@ ffdict_find(
 			/* Find the first satisfactory key. */
 			ion_fpos_t			loc			= -1;
 			ion_flat_file_row_t row;
-			ion_err_t			scan_result = flat_file_scan(flat_file, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_within_bounds, (*cursor)->predicate->statement.range.lower_bound, (*cursor)->predicate->statement.range.upper_bound);
+
+			ion_err_t scan_result = ffdict_cursor_open_reader(flat_file, flat_file_cursor);
+
+			if (err_ok == scan_result) {
+				scan_result = flat_file_scan(flat_file, flat_file_cursor->reader, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_within_bounds, (*cursor)->predicate->statement.range.lower_bound, (*cursor)->predicate->statement.range.upper_bound);
+			}
 
 			if (err_file_hit_eof == scan_result) {
 				/* This means the returned node is smaller than the lower bound, which means that there are no valid records to return */
@@ -309,11 +580,8 @@ ffdict_find(
 				return err_ok;
 			}
 			else if (err_ok == scan_result) {
-				(*cursor)->status = cs_cursor_initialized;
-
-				ion_flat_file_cursor_t *flat_file_cursor = (ion_flat_file_cursor_t *) (*cursor);
-
-				flat_file_cursor->current_location = loc;
+				(*cursor)->status					= cs_cursor_initialized;
+				flat_file_cursor->current_location	= loc;
 				return err_ok;
 			}
 			else {
@@ -325,11 +593,14 @@ ffdict_find(
 		}
 
 		case predicate_all_records: {
-			ion_flat_file_cursor_t *flat_file_cursor	= (ion_flat_file_cursor_t *) (*cursor);
-
-			ion_fpos_t			loc						= -1;
+			ion_fpos_t			loc = -1;
 			ion_flat_file_row_t row;
-			ion_err_t			scan_result				= flat_file_scan(flat_file, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_not_empty);
+
+			ion_err_t scan_result = ffdict_cursor_open_reader(flat_file, flat_file_cursor);
+
+			if (err_ok == scan_result) {
+				scan_result = flat_file_scan(flat_file, flat_file_cursor->reader, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_not_empty);
+			}
 
 			if (err_file_hit_eof == scan_result) {
 				(*cursor)->status = cs_end_of_results;
@@ -374,6 +645,11 @@ ffdict_init(
 	handler->destroy_dictionary = ffdict_destroy_dictionary;
 	handler->open_dictionary	= ffdict_open_dictionary;
 	handler->close_dictionary	= ffdict_close_dictionary;
+	handler->sync_dictionary	= ffdict_sync_dictionary;
+	handler->scan_extent		= ffdict_scan_extent;
+	handler->scan_range			= ffdict_scan_range;
+	handler->get_many			= NULL;
+	handler->concurrent			= boolean_false;
 }
 
 ion_status_t
@@ -450,10 +726,13 @@ ffdict_destroy_dictionary(
 
 	dictionary_get_filename(id, "ffs", filename);
 
-	if (0 != fremove(filename)) {
+	if (err_ok != ion_fremove(filename)) {
 		return err_file_delete_error;
 	}
 
+	dictionary_get_filename(id, ION_FLAT_FILE_ZONE_MAP_EXTENSION, filename);
+	ion_fremove(filename);
+
 	return err_ok;
 }
 
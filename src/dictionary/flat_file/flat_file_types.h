@@ -42,6 +42,7 @@ extern "C" {
 #endif
 
 #include "../dictionary.h"
+#include "../../file/ion_file.h"
 #include "../../file/sd_stdio_c_iface.h"
 
 /**
@@ -67,6 +68,48 @@ typedef ion_byte_t ion_flat_file_row_status_t;
 */
 #define ION_FLAT_FILE_SCAN_BACKWARDS	0
 
+/**
+@brief		Header written at the start of a flat file data file that is not kept sorted.
+*/
+#define ION_FLAT_FILE_HEADER_UNSORTED	0xADDE
+/**
+@brief		Header written at the start of a flat file data file that is kept in sorted mode.
+*/
+#define ION_FLAT_FILE_HEADER_SORTED		0x50DE
+/**
+@brief		Header written at the start of a flat file data file that @ref flat_file_sort
+			left in sorted mode, which it leaves again on a write that breaks the order.
+*/
+#define ION_FLAT_FILE_HEADER_RESORTABLE	0x5EDE
+
+#if !defined(ION_FLAT_FILE_SORT_FAN_IN)
+/**
+@brief		How many sorted runs @ref flat_file_sort merges at once. Each of these needs
+			one open file and one row of memory during a merge pass.
+*/
+#define ION_FLAT_FILE_SORT_FAN_IN		8
+#endif
+
+/**
+@brief		File extension used to persist the zone map of a flat file next to its data file.
+*/
+#define ION_FLAT_FILE_ZONE_MAP_EXTENSION	"ffz"
+
+/**
+@brief		Read state of a flat file. Readers that run concurrently each need their own.
+*/
+typedef struct {
+	/**> Memory buffer capable of holding @p num_buffered number of rows. */
+	ion_byte_t	*buffer;
+	/**> When a scan is performed, a region (defined as @p num_in_buffer number of records) is loaded into
+		 memory. We can utilize this fact to do efficient cached reads as long as the buffer is intact.
+		 This is expressed as an index that points to the first record in the region. @p num_in_buffer-1 would
+		 be the last index in the region. */
+	ion_fpos_t	current_loaded_region;
+	/**> Expresses how many valid records are currently in the buffer. */
+	size_t		num_in_buffer;
+} ion_flat_file_reader_t;
+
 /**
 @brief		Metadata container that holds flat file specific information.
 */
@@ -75,6 +118,12 @@ typedef struct {
 	ion_dictionary_parent_t super;
 	/**> Flag to toggle whether or not to activate "sorted mode" for storage. */
 	ion_boolean_t			sorted_mode;
+	/**> Flag set when sorted mode was entered by @ref flat_file_sort. An insert out of order or a
+		 delete then takes the flat file out of sorted mode, rather than being refused. */
+	ion_boolean_t			resortable;
+	/**> Flag to search the fence index by interpolation rather than bisection in sorted mode.
+		 This pays off for uniformly distributed numeric keys, and is ignored for other key types. */
+	ion_boolean_t			interpolation_search;
 	/**> This signifies where the actual record data starts, in case we want to
 		 write some metadata at the beginning of the flat file's file. */
 	ion_fpos_t				start_of_data;
@@ -84,21 +133,31 @@ typedef struct {
 		 records we want to buffer at a time. This is a trade-off between
 		 better performance and increased memory usage. */
 	ion_dictionary_size_t	num_buffered;
-	/**> Memory buffer capable of holding @p row_size number of rows. This is used
-		 for many purposes throughout the flat file. */
-	ion_byte_t				*buffer;
+	/**> The flat file's own reader. Its buffer is used for many purposes by writers, and by
+		 readers in builds that are not thread-safe. */
+	ion_flat_file_reader_t	reader;
 	/**> The file descriptor of the file this flat file instance operates on. */
-	FILE					*data_file;
+	ion_file_handle_t		data_file;
 	/**> This value expresses the size of one row inside the @p data_file. A row is defined
 		 as a record + metadata. Change this if @ref ion_flat_file_row_t changes!*/
 	size_t					row_size;
-	/**> When a scan is performed, a region (defined as @p num_in_buffer number of records) is loaded into
-		 memory. We can utilize this fact to do efficient cached reads as long as the buffer is intact.
-		 This is expressed as an index that points to the first record in the region. @p num_in_buffer-1 would
-		 be the last index in the region. */
-	ion_fpos_t	current_loaded_region;
-	/**> Expresses how many valid records are currently in the buffer. */
-	size_t		num_in_buffer;
+	/**> Zone map holding the smallest and largest key of each block of @p num_buffered rows,
+		 laid out as | MIN KEY | MAX KEY | per block. The bounds are allowed to be wider than the
+		 keys actually present in the block, so they only ever need to be widened on mutation.
+		 In sorted mode the minimum is exactly the first key of the block, so the zone map also
+		 serves as the sparse fence index used by @ref flat_file_binary_search. */
+	ion_byte_t		*zone_map;
+	/**> How many blocks the @p zone_map has room for. */
+	ion_fpos_t		zone_map_capacity;
+	/**> Whether or not the @p zone_map covers every row in the data file. If not, it is rebuilt
+		 the next time a scan could make use of it. */
+	ion_boolean_t	zone_map_valid;
+#if ION_THREAD_SAFE
+	/**> Serializes readers that rebuild an invalid @p zone_map. Readers otherwise only
+		 share the zone map once it is valid, and read rows through their own reader.
+		 Writers are already exclusive at the dictionary level. */
+	ion_mutex_t zone_map_latch;
+#endif
 } ion_flat_file_t;
 
 /**
@@ -129,7 +188,14 @@ typedef struct {
 	/**> Supertype of the dictionary cursor. */
 	ion_dict_cursor_t	super;
 	/**> Holds the index of the current location in our search. */
-	ion_fpos_t			current_location;
+	ion_fpos_t				current_location;
+	/**> Which reader the cursor reads through. In thread-safe builds this is @p own_reader,
+		 so that cursors read concurrently. Otherwise it is the flat file's own reader. */
+	ion_flat_file_reader_t	*reader;
+#if ION_THREAD_SAFE
+	/**> The reader of this cursor alone. */
+	ion_flat_file_reader_t	own_reader;
+#endif
 } ion_flat_file_cursor_t;
 
 #if defined(__cplusplus)
@@ -37,136 +37,502 @@
 
 #include "ion_master_table.h"
 
+/**
+@brief		Number of records read per @c fread when loading the master table.
+*/
+#define ION_MASTER_TABLE_LOAD_RECORDS	32
+
+/**
+@brief		Size in bytes of a packed master table record.
+*/
+#define ION_MASTER_TABLE_PACKED_SIZE	ION_MASTER_TABLE_RECORD_SIZE((ion_dictionary_config_info_t *) 0)
+
+/**
+@brief		A cached master table row.
+@details	Rows belonging to the same use type are chained together in
+			id order, so that the first and last dictionary of a given use
+			can be found without scanning the table.
+*/
+typedef struct {
+	ion_dictionary_config_info_t	config;		/**< The row as stored on disk. */
+	ion_dictionary_id_t				prev_use;	/**< Previous row having the same
+													 use type, or 0 if none. */
+	ion_dictionary_id_t				next_use;	/**< Next row having the same
+													 use type, or 0 if none. */
+} ion_master_table_entry_t;
+
+/**
+@brief		The rows of one use type in the use-type index.
+*/
+typedef struct {
+	ion_dict_use_t		use_type;	/**< The use type. */
+	ion_dictionary_id_t first;		/**< First (lowest id) row of the use type. */
+	ion_dictionary_id_t last;		/**< Last (highest id) row of the use type. */
+} ion_master_table_use_t;
+
 FILE				*ion_master_table_file		= NULL;
 ion_dictionary_id_t ion_master_table_next_id	= 1;
 
-ion_err_t
-ion_master_table_write(
-	ion_dictionary_config_info_t	*config,
-	long							where
-) {
-	long old_pos = ftell(ion_master_table_file);
+/**
+@brief		In-memory copy of the master table, indexed by row.
+@details	Row 0 is the master row. Every write to the file goes through
+			@ref ion_master_table_write, which keeps this copy in sync.
+*/
+static ion_master_table_entry_t *ion_master_table_cache			= NULL;
 
-	if (ION_MASTER_TABLE_CALCULATE_POS == where) {
-		where = (int) (config->id * ION_MASTER_TABLE_RECORD_SIZE(config));
+/**
+@brief		Number of rows allocated in @ref ion_master_table_cache.
+*/
+static ion_dictionary_id_t ion_master_table_cache_size			= 0;
+
+/**
+@brief		Use-type index, with an entry for each use type that has rows.
+@details	Only the use types present take memory, rather than every
+			possible @ref ion_dict_use_t. It is allocated along with
+			@ref ion_master_table_cache and freed with it.
+*/
+static ion_master_table_use_t *ion_master_table_uses			= NULL;
+
+/**
+@brief		Number of entries in use in @ref ion_master_table_uses.
+*/
+static unsigned int ion_master_table_num_uses					= 0;
+
+/**
+@brief		Number of entries allocated in @ref ion_master_table_uses.
+*/
+static unsigned int ion_master_table_uses_capacity				= 0;
+
+/**
+@brief		Log that dictionaries created or opened through the master table
+			are attached to, or @c NULL.
+*/
+static ion_wal_t *ion_master_table_wal = NULL;
+
+/**
+@brief		Attaches a dictionary just created or opened to the master
+			table's log, if there is one and the dictionary can use it.
+*/
+static ion_err_t
+ion_master_table_attach_wal(
+	ion_dictionary_t *dictionary
+) {
+	if ((NULL == ion_master_table_wal) || (NULL == dictionary->handler->sync_dictionary)) {
+		return err_ok;
 	}
 
-	if (ION_MASTER_TABLE_CALCULATE_POS > where) {
-		if (0 != fseek(ion_master_table_file, 0, SEEK_END)) {
-			return err_file_bad_seek;
+	return dictionary_attach_wal(dictionary, ion_master_table_wal);
+}
+
+/**
+@brief		Frees the in-memory master table and empties the use-type index.
+*/
+static void
+ion_master_table_cache_clear(
+	void
+) {
+	free(ion_master_table_cache);
+	ion_master_table_cache			= NULL;
+	ion_master_table_cache_size		= 0;
+	free(ion_master_table_uses);
+	ion_master_table_uses			= NULL;
+	ion_master_table_num_uses		= 0;
+	ion_master_table_uses_capacity	= 0;
+}
+
+/**
+@brief		Finds the entry of a use type in the use-type index.
+@param[in]	use_type
+				The use type to find.
+@returns	The entry, or @c NULL if the use type has no rows.
+*/
+static ion_master_table_use_t *
+ion_master_table_use(
+	ion_dict_use_t use_type
+) {
+	unsigned int i;
+
+	for (i = 0; i < ion_master_table_num_uses; i++) {
+		if (use_type == ion_master_table_uses[i].use_type) {
+			return &ion_master_table_uses[i];
 		}
 	}
-	else if (0 != fseek(ion_master_table_file, where, SEEK_SET)) {
-		return err_file_bad_seek;
+
+	return NULL;
+}
+
+/**
+@brief		Makes sure the use-type index has room for an entry of a use type.
+@details	Entries are never given back until the cache is cleared, so a
+			row can always be linked once this has succeeded.
+@param[in]	use_type
+				The use type of a row about to be linked.
+@returns	An error code describing the result of the call.
+*/
+static ion_err_t
+ion_master_table_use_reserve(
+	ion_dict_use_t use_type
+) {
+	ion_master_table_use_t	*uses;
+	unsigned int			capacity;
+
+	if ((ion_master_table_num_uses < ion_master_table_uses_capacity) || (NULL != ion_master_table_use(use_type))) {
+		return err_ok;
 	}
 
-	if (1 != fwrite(&(config->id), sizeof(config->id), 1, ion_master_table_file)) {
-		return err_file_write_error;
+	capacity	= (0 == ion_master_table_uses_capacity) ? 4 : 2 * ion_master_table_uses_capacity;
+	uses		= realloc(ion_master_table_uses, capacity * sizeof(ion_master_table_use_t));
+
+	if (NULL == uses) {
+		return err_out_of_memory;
 	}
 
-	if (1 != fwrite(&(config->use_type), sizeof(config->use_type), 1, ion_master_table_file)) {
-		return err_file_write_error;
+	ion_master_table_uses			= uses;
+	ion_master_table_uses_capacity	= capacity;
+
+	return err_ok;
+}
+
+/**
+@brief		Makes sure the in-memory master table has room for a row.
+@param[in]	row
+				The row that must be addressable once this call returns.
+@returns	An error code describing the result of the call.
+*/
+static ion_err_t
+ion_master_table_cache_reserve(
+	ion_dictionary_id_t row
+) {
+	ion_master_table_entry_t	*cache;
+	ion_dictionary_id_t			size;
+
+	if (row < ion_master_table_cache_size) {
+		return err_ok;
 	}
 
-	if (1 != fwrite(&(config->type), sizeof(config->type), 1, ion_master_table_file)) {
-		return err_file_write_error;
+	size = (0 == ion_master_table_cache_size) ? ION_MASTER_TABLE_LOAD_RECORDS : ion_master_table_cache_size;
+
+	while (size <= row) {
+		size *= 2;
 	}
 
-	if (1 != fwrite(&(config->key_size), sizeof(config->key_size), 1, ion_master_table_file)) {
-		return err_file_write_error;
+	cache = realloc(ion_master_table_cache, size * sizeof(ion_master_table_entry_t));
+
+	if (NULL == cache) {
+		return err_out_of_memory;
 	}
 
-	if (1 != fwrite(&(config->value_size), sizeof(config->value_size), 1, ion_master_table_file)) {
-		return err_file_write_error;
+	memset(cache + ion_master_table_cache_size, 0, (size - ion_master_table_cache_size) * sizeof(ion_master_table_entry_t));
+	ion_master_table_cache		= cache;
+	ion_master_table_cache_size = size;
+
+	return err_ok;
+}
+
+/**
+@brief		Removes a cached row from the use-type index.
+@param[in]	row
+				The row to remove. Must be allocated in the cache.
+*/
+static void
+ion_master_table_cache_unlink(
+	ion_dictionary_id_t row
+) {
+	ion_master_table_entry_t	*entry = &ion_master_table_cache[row];
+	ion_master_table_use_t		*use;
+
+	if ((0 == row) || (0 == entry->config.id)) {
+		return;
 	}
 
-	if (1 != fwrite(&(config->dictionary_size), sizeof(config->dictionary_size), 1, ion_master_table_file)) {
-		return err_file_write_error;
+	use = ion_master_table_use(entry->config.use_type);
+
+	if (0 == entry->prev_use) {
+		use->first = entry->next_use;
+	}
+	else {
+		ion_master_table_cache[entry->prev_use].next_use = entry->next_use;
 	}
 
-	if (1 != fwrite(&(config->dictionary_type), sizeof(config->dictionary_type), 1, ion_master_table_file)) {
-		return err_file_write_error;
+	if (0 == entry->next_use) {
+		use->last = entry->prev_use;
+	}
+	else {
+		ion_master_table_cache[entry->next_use].prev_use = entry->prev_use;
 	}
 
-	if (1 != fwrite(&(config->dictionary_status), sizeof(config->dictionary_status), 1, ion_master_table_file)) {
-		return err_file_write_error;
+	entry->prev_use = 0;
+	entry->next_use = 0;
+
+	/* The last row of the use type is gone, so move the last entry into its place. */
+	if (0 == use->first) {
+		*use = ion_master_table_uses[--ion_master_table_num_uses];
 	}
+}
 
-	if (0 != fseek(ion_master_table_file, old_pos, SEEK_SET)) {
-		return err_file_bad_seek;
+/**
+@brief		Inserts a cached row into the use-type index, keeping id order.
+@details	Rows are normally added in increasing order, which appends to
+			the tail of the chain in constant time.
+@param[in]	row
+				The row to insert. Must be allocated in the cache, and
+				room for its use type reserved with
+				@ref ion_master_table_use_reserve.
+*/
+static void
+ion_master_table_cache_link(
+	ion_dictionary_id_t row
+) {
+	ion_master_table_entry_t	*entry = &ion_master_table_cache[row];
+	ion_master_table_use_t		*use;
+	ion_dictionary_id_t			next;
+
+	if ((0 == row) || (0 == entry->config.id)) {
+		return;
+	}
+
+	use = ion_master_table_use(entry->config.use_type);
+
+	if (NULL == use) {
+		use				= &ion_master_table_uses[ion_master_table_num_uses++];
+		use->use_type	= entry->config.use_type;
+		use->first		= 0;
+		use->last		= 0;
+	}
+
+	next = 0;
+
+	if (row < use->last) {
+		next = use->first;
+
+		while (next < row) {
+			next = ion_master_table_cache[next].next_use;
+		}
+	}
+
+	entry->next_use = next;
+
+	if (0 == next) {
+		entry->prev_use							= use->last;
+		use->last								= row;
+	}
+	else {
+		entry->prev_use							= ion_master_table_cache[next].prev_use;
+		ion_master_table_cache[next].prev_use	= row;
 	}
 
+	if (0 == entry->prev_use) {
+		use->first = row;
+	}
+	else {
+		ion_master_table_cache[entry->prev_use].next_use = row;
+	}
+}
+
+/**
+@brief		Stores a row in the in-memory master table.
+@param[in]	row
+				The row being written.
+@param[in]	config
+				The contents of the row.
+@returns	An error code describing the result of the call.
+*/
+static ion_err_t
+ion_master_table_cache_put(
+	ion_dictionary_id_t				row,
+	ion_dictionary_config_info_t	*config
+) {
+	ion_err_t error = ion_master_table_cache_reserve(row);
+
+	if (err_ok == error) {
+		error = ion_master_table_use_reserve(config->use_type);
+	}
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	ion_master_table_cache_unlink(row);
+	ion_master_table_cache[row].config = *config;
+	ion_master_table_cache_link(row);
+
 	return err_ok;
 }
 
 /**
-@brief		Read a record to the master table.
-@details	Automatically, this call will reposition the file position
-			back to where it was once the call is complete.
+@brief		Serializes a config into its on-disk record layout.
+@details	The fields are laid out back to back, in declaration order and
+			without padding.
+@param[in]	config
+				The config to serialize.
+@param[out]	record
+				A buffer of at least @ref ION_MASTER_TABLE_PACKED_SIZE bytes.
+*/
+static void
+ion_master_table_pack(
+	ion_dictionary_config_info_t	*config,
+	ion_byte_t						*record
+) {
+	memcpy(record, &config->id, sizeof(config->id));
+	record += sizeof(config->id);
+	memcpy(record, &config->use_type, sizeof(config->use_type));
+	record += sizeof(config->use_type);
+	memcpy(record, &config->type, sizeof(config->type));
+	record += sizeof(config->type);
+	memcpy(record, &config->key_size, sizeof(config->key_size));
+	record += sizeof(config->key_size);
+	memcpy(record, &config->value_size, sizeof(config->value_size));
+	record += sizeof(config->value_size);
+	memcpy(record, &config->dictionary_size, sizeof(config->dictionary_size));
+	record += sizeof(config->dictionary_size);
+	memcpy(record, &config->dictionary_type, sizeof(config->dictionary_type));
+	record += sizeof(config->dictionary_type);
+	memcpy(record, &config->dictionary_status, sizeof(config->dictionary_status));
+}
+
+/**
+@brief		Deserializes a config from its on-disk record layout.
+@param[in]	record
+				A buffer of @ref ION_MASTER_TABLE_PACKED_SIZE bytes, as
+				produced by @ref ion_master_table_pack.
 @param[out]	config
-				A pointer to a previously allocated config object to write to.
-@param[in]	where
-				An integral value representing where to read from in the file.
-				This file offset is byte-aligned, not record aligned, in general.
-
-				One special flag can be passed in here:
-					- @c ION_MASTER_TABLE_CALCULATE_POS
-						Calculate the position based on the passed-in config id.
-@returns	An error code describing the result of the call.
+				The config to write to.
 */
+static void
+ion_master_table_unpack(
+	ion_byte_t						*record,
+	ion_dictionary_config_info_t	*config
+) {
+	memcpy(&config->id, record, sizeof(config->id));
+	record += sizeof(config->id);
+	memcpy(&config->use_type, record, sizeof(config->use_type));
+	record += sizeof(config->use_type);
+	memcpy(&config->type, record, sizeof(config->type));
+	record += sizeof(config->type);
+	memcpy(&config->key_size, record, sizeof(config->key_size));
+	record += sizeof(config->key_size);
+	memcpy(&config->value_size, record, sizeof(config->value_size));
+	record += sizeof(config->value_size);
+	memcpy(&config->dictionary_size, record, sizeof(config->dictionary_size));
+	record += sizeof(config->dictionary_size);
+	memcpy(&config->dictionary_type, record, sizeof(config->dictionary_type));
+	record += sizeof(config->dictionary_type);
+	memcpy(&config->dictionary_status, record, sizeof(config->dictionary_status));
+}
+
 ion_err_t
-ion_master_table_read(
+ion_master_table_write(
 	ion_dictionary_config_info_t	*config,
 	long							where
 ) {
-	long old_pos = ftell(ion_master_table_file);
+	ion_byte_t	record[ION_MASTER_TABLE_PACKED_SIZE];
+	long		old_pos = ftell(ion_master_table_file);
 
 	if (ION_MASTER_TABLE_CALCULATE_POS == where) {
 		where = (int) (config->id * ION_MASTER_TABLE_RECORD_SIZE(config));
 	}
 
-	if (0 != fseek(ion_master_table_file, where, SEEK_SET)) {
+	if (ION_MASTER_TABLE_CALCULATE_POS > where) {
+		if (0 != fseek(ion_master_table_file, 0, SEEK_END)) {
+			return err_file_bad_seek;
+		}
+
+		where = ftell(ion_master_table_file);
+	}
+	else if (0 != fseek(ion_master_table_file, where, SEEK_SET)) {
 		return err_file_bad_seek;
 	}
 
-	if (1 != fread(&(config->id), sizeof(config->id), 1, ion_master_table_file)) {
-		return err_file_read_error;
-	}
+	ion_master_table_pack(config, record);
 
-	if (1 != fread(&(config->use_type), sizeof(config->use_type), 1, ion_master_table_file)) {
-		return err_file_read_error;
+	if (1 != fwrite(record, sizeof(record), 1, ion_master_table_file)) {
+		return err_file_write_error;
 	}
 
-	if (1 != fread(&(config->type), sizeof(config->type), 1, ion_master_table_file)) {
-		return err_file_read_error;
+	if (0 != fseek(ion_master_table_file, old_pos, SEEK_SET)) {
+		return err_file_bad_seek;
 	}
 
-	if (1 != fread(&(config->key_size), sizeof(config->key_size), 1, ion_master_table_file)) {
-		return err_file_read_error;
+	/* Write-through: only whole rows are mirrored, which is every write made by this module. */
+	if (0 == where % (long) sizeof(record)) {
+		return ion_master_table_cache_put((ion_dictionary_id_t) (where / (long) sizeof(record)), config);
 	}
 
-	if (1 != fread(&(config->value_size), sizeof(config->value_size), 1, ion_master_table_file)) {
-		return err_file_read_error;
+	return err_ok;
+}
+
+/**
+@brief		Loads the whole master table file into memory.
+@details	Rows are read in blocks of @ref ION_MASTER_TABLE_LOAD_RECORDS,
+			each with a single @c fread, and the use-type index is built
+			as they are loaded. The file position is left at the start of
+			the file.
+@returns	An error code describing the result of the call.
+*/
+static ion_err_t
+ion_master_table_load(
+	void
+) {
+	ion_byte_t						records[ION_MASTER_TABLE_LOAD_RECORDS * ION_MASTER_TABLE_PACKED_SIZE];
+	ion_dictionary_config_info_t	config;
+	ion_dictionary_id_t				num_rows;
+	ion_dictionary_id_t				row;
+	size_t							num_read;
+	size_t							i;
+	long							size;
+	ion_err_t						error;
+
+	ion_master_table_cache_clear();
+
+	if (0 != fseek(ion_master_table_file, 0, SEEK_END)) {
+		return err_file_bad_seek;
 	}
 
-	if (1 != fread(&(config->dictionary_size), sizeof(config->dictionary_size), 1, ion_master_table_file)) {
-		return err_file_read_error;
+	size = ftell(ion_master_table_file);
+
+	if ((size < 0) || (0 != fseek(ion_master_table_file, 0, SEEK_SET))) {
+		return err_file_bad_seek;
 	}
 
-	if (1 != fread(&(config->dictionary_type), sizeof(config->dictionary_type), 1, ion_master_table_file)) {
+	num_rows = (ion_dictionary_id_t) (size / ION_MASTER_TABLE_PACKED_SIZE);
+
+	if (0 == num_rows) {
 		return err_file_read_error;
 	}
 
-	if (1 != fread(&(config->dictionary_status), sizeof(config->dictionary_status), 1, ion_master_table_file)) {
-		return err_file_read_error;
+	error = ion_master_table_cache_reserve(num_rows - 1);
+
+	if (err_ok != error) {
+		return error;
 	}
 
-	if (0 != fseek(ion_master_table_file, old_pos, SEEK_SET)) {
-		return err_file_bad_seek;
+	for (row = 0; row < num_rows; row += num_read) {
+		num_read = num_rows - row;
+
+		if (num_read > ION_MASTER_TABLE_LOAD_RECORDS) {
+			num_read = ION_MASTER_TABLE_LOAD_RECORDS;
+		}
+
+		if (num_read != fread(records, ION_MASTER_TABLE_PACKED_SIZE, num_read, ion_master_table_file)) {
+			return err_file_read_error;
+		}
+
+		for (i = 0; i < num_read; i++) {
+			ion_master_table_unpack(records + i * ION_MASTER_TABLE_PACKED_SIZE, &config);
+
+			error = ion_master_table_use_reserve(config.use_type);
+
+			if (err_ok != error) {
+				return error;
+			}
+
+			ion_master_table_cache[row + i].config = config;
+			ion_master_table_cache_link(row + i);
+		}
 	}
 
-	if (0 == config->id) {
-		return err_item_not_found;
+	if (0 != fseek(ion_master_table_file, 0, SEEK_SET)) {
+		return err_file_bad_seek;
 	}
 
 	return err_ok;
@@ -216,6 +582,7 @@ ion_init_master_table(
 
 		/* Clean fresh file was opened. */
 		ion_master_table_next_id = 1;
+		ion_master_table_cache_clear();
 
 		/* Write master row. */
 		ion_dictionary_config_info_t master_config = { .id = ion_master_table_next_id };
@@ -226,15 +593,12 @@ ion_init_master_table(
 	}
 	else {
 		/* Here we read an existing file. */
-
-		/* Find existing ID count. */
-		ion_dictionary_config_info_t master_config;
-
-		if (ion_master_table_read(&master_config, 0)) {
-			return err_file_read_error;
+		if (err_ok != (error = ion_master_table_load())) {
+			return error;
 		}
 
-		ion_master_table_next_id = master_config.id;
+		/* Find existing ID count. */
+		ion_master_table_next_id = ion_master_table_cache[0].config.id;
 	}
 
 	return err_ok;
@@ -251,6 +615,7 @@ ion_close_master_table(
 	}
 
 	ion_master_table_file = NULL;
+	ion_master_table_cache_clear();
 
 	return err_ok;
 }
@@ -306,6 +671,7 @@ ion_close_all_master_table(
 	}
 
 	ion_master_table_file = NULL;
+	ion_master_table_cache_clear();
 
 	return err_ok;
 }
@@ -320,6 +686,7 @@ ion_delete_master_table(
 
 	/* Reset master table ID as master table has been deleted. */
 	ion_master_table_next_id = 1;
+	ion_master_table_cache_clear();
 
 	return err_ok;
 }
@@ -372,7 +739,11 @@ ion_master_table_create_dictionary(
 
 	err = ion_add_to_master_table(dictionary, dictionary_size);
 
-	return err;
+	if (err_ok != err) {
+		return err;
+	}
+
+	return ion_master_table_attach_wal(dictionary);
 }
 
 ion_err_t
@@ -380,15 +751,12 @@ ion_lookup_in_master_table(
 	ion_dictionary_id_t				id,
 	ion_dictionary_config_info_t	*config
 ) {
-	ion_err_t error = err_ok;
-
-	config->id	= id;
-	error		= ion_master_table_read(config, ION_MASTER_TABLE_CALCULATE_POS);
-
-	if (err_ok != error) {
-		return error;
+	if ((0 == id) || (id >= ion_master_table_cache_size) || (0 == ion_master_table_cache[id].config.id)) {
+		return err_item_not_found;
 	}
 
+	*config = ion_master_table_cache[id].config;
+
 	return err_ok;
 }
 
@@ -398,39 +766,23 @@ ion_find_by_use_master_table(
 	ion_dict_use_t					use_type,
 	char							whence
 ) {
-	ion_dictionary_id_t				id;
-	ion_dictionary_config_info_t	tconfig;
-	ion_err_t						error;
+	ion_master_table_use_t	*use = ion_master_table_use(use_type);
+	ion_dictionary_id_t		id;
 
-	tconfig.id	= 0;
-
-	id			= 1;
+	if (NULL == use) {
+		return err_item_not_found;
+	}
 
 	if (ION_MASTER_TABLE_FIND_LAST == whence) {
-		id = ion_master_table_next_id - 1;
+		id = use->last;
 	}
-
-	/* Loop through all items. */
-	for (; id < ion_master_table_next_id && id > 0; id += whence) {
-		error = ion_lookup_in_master_table(id, &tconfig);
-
-		if (err_item_not_found == error) {
-			continue;
-		}
-
-		if (err_ok != error) {
-			return error;
-		}
-
-		/* If this config has the right type, set the output pointer. */
-		if (tconfig.use_type == use_type) {
-			*config = tconfig;
-
-			return err_ok;
-		}
+	else {
+		id = use->first;
 	}
 
-	return err_item_not_found;
+	*config = ion_master_table_cache[id].config;
+
+	return err_ok;
 }
 
 ion_err_t
@@ -479,7 +831,18 @@ ion_open_dictionary(
 
 	err = dictionary_open(handler, dictionary, &config);
 
-	return err;
+	if (err_ok != err) {
+		return err;
+	}
+
+	return ion_master_table_attach_wal(dictionary);
+}
+
+void
+ion_master_table_set_wal(
+	ion_wal_t *wal
+) {
+	ion_master_table_wal = wal;
 }
 
 ion_err_t
@@ -517,6 +880,14 @@ ion_delete_dictionary(
 			return err_dictionary_destruction_error;
 		}
 
+		if (NULL != ion_master_table_wal) {
+			err = ion_wal_forget(ion_master_table_wal, id);
+
+			if (err_ok != err) {
+				return err;
+			}
+		}
+
 		ion_dictionary_handler_t handler;
 
 		ion_switch_handler(type, &handler);
@@ -569,6 +940,21 @@ ion_switch_handler(
 			break;
 		}
 
+		case dictionary_type_lsm_t: {
+			lsmdict_init(handler);
+			break;
+		}
+
+		case dictionary_type_concurrent_skip_list_t: {
+			csldict_init(handler);
+			break;
+		}
+
+		case dictionary_type_sharded_t: {
+			sharddict_init(handler);
+			break;
+		}
+
 		case dictionary_type_error_t: {
 			return err_uninitialized;
 		}
@@ -60,6 +60,9 @@ extern "C" {
 #include "open_address_hash/open_address_hash_dictionary_handler.h"
 #include "skip_list/skip_list_handler.h"
 #include "linear_hash/linear_hash_handler.h"
+#include "lsm/lsm_handler.h"
+#include "concurrent_skip_list/concurrent_skip_list_handler.h"
+#include "sharded/sharded_handler.h"
 
 #define ION_MASTER_TABLE_CALCULATE_POS	-1
 #define ION_MASTER_TABLE_WRITE_FROM_END -2
@@ -103,7 +106,9 @@ extern FILE *ion_master_table_file;
 /**
 @brief		Write a record to the master table.
 @details	Automatically, this call will reposition the file position
-			back to where it was once the call is complete.
+			back to where it was once the call is complete. The record is
+			packed and written with a single @c fwrite, and the in-memory
+			copy of the master table is updated to match.
 @param[in]	config
 				A pointer to a previously allocated config object to write from.
 @param[in]	where
@@ -125,7 +130,9 @@ ion_master_table_write(
 
 /**
 @brief	  Opens the master table.
-@details	Can be safely called multiple times without closing.
+@details	Can be safely called multiple times without closing. An
+			existing master table is loaded into memory, so that later
+			lookups do not touch the file.
 */
 ion_err_t
 ion_init_master_table(
@@ -197,6 +204,8 @@ ion_master_table_create_dictionary(
 @param		config
 				A pointer to an already allocated configuration object
 				that will be read into from the master table.
+@returns	@c err_ok if the dictionary is in the master table,
+			@c err_item_not_found otherwise. Served from memory.
 */
 ion_err_t
 ion_lookup_in_master_table(
@@ -219,7 +228,8 @@ ion_lookup_in_master_table(
 				@ref ION_MASTER_TABLE_FIND_LAST.
 @returns	@c err_ok if a dictionary having usage type @p use_type
 			is found, otherwise an error code properly describing
-			the situation and outcome.
+			the situation and outcome. Runs in constant time using the
+			in-memory use-type index.
 */
 ion_err_t
 ion_find_by_use_master_table(
@@ -258,6 +268,19 @@ ion_open_dictionary(
 	ion_dictionary_id_t			id
 );
 
+/**
+@brief		Sets the log that dictionaries are attached to when they are
+			created or opened through the master table.
+@details	Opening a dictionary then replays the writes it lost in a
+			crash. Dictionaries that cannot be synced are not attached.
+@param		wal
+				An open log, or @c NULL to stop attaching dictionaries.
+*/
+void
+ion_master_table_set_wal(
+	ion_wal_t *wal
+);
+
 /**
 @brief		Closes a given dictionary.
 @param		dictionary
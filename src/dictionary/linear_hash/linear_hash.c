@@ -103,15 +103,19 @@ linear_hash_init(
 	}
 
 	linear_hash->bucket_map = bucket_map;
-	linear_hash->database	= fopen(data_filename, "r+b");
+	ion_boolean_t is_new	= !ion_fexists(data_filename);
 
-	if (NULL == linear_hash->database) {
-		linear_hash->database = fopen(data_filename, "w+b");
+	linear_hash->database	= ion_fopen(data_filename);
 
-		if (NULL == linear_hash->database) {
-			return err_file_open_error;
-		}
+	if (ION_FILE_IS_NULL(linear_hash->database)) {
+		return err_file_open_error;
+	}
 
+#if ION_FILE_STATS
+	ion_file_set_owner(linear_hash->database, id);
+#endif
+
+	if (is_new) {
 		int i;
 
 		for (i = 0; i < linear_hash->initial_size; i++) {
@@ -124,15 +128,18 @@ linear_hash_init(
 		}
 	}
 
-	linear_hash->state = fopen(state_filename, "r+b");
+	is_new				= !ion_fexists(state_filename);
+	linear_hash->state	= ion_fopen(state_filename);
 
-	if (NULL == linear_hash->state) {
-		linear_hash->state = fopen(state_filename, "w+b");
+	if (ION_FILE_IS_NULL(linear_hash->state)) {
+		return err_file_open_error;
+	}
 
-		if (NULL == linear_hash->state) {
-			return err_file_open_error;
-		}
+#if ION_FILE_STATS
+	ion_file_set_owner(linear_hash->state, id);
+#endif
 
+	if (is_new) {
 		err = linear_hash_write_state(linear_hash);
 
 		if (err != err_ok) {
@@ -168,31 +175,31 @@ ion_err_t
 linear_hash_write_state(
 	linear_hash_table_t *linear_hash
 ) {
-	if (1 != fwrite(&linear_hash->initial_size, sizeof(linear_hash->initial_size), 1, linear_hash->state)) {
+	if (err_ok != ion_fwrite(linear_hash->state, sizeof(linear_hash->initial_size), (ion_byte_t *) &linear_hash->initial_size)) {
 		return err_file_write_error;
 	}
 
-	if (1 != fwrite(&linear_hash->next_split, sizeof(linear_hash->next_split), 1, linear_hash->state)) {
+	if (err_ok != ion_fwrite(linear_hash->state, sizeof(linear_hash->next_split), (ion_byte_t *) &linear_hash->next_split)) {
 		return err_file_write_error;
 	}
 
-	if (1 != fwrite(&linear_hash->split_threshold, sizeof(linear_hash->split_threshold), 1, linear_hash->state)) {
+	if (err_ok != ion_fwrite(linear_hash->state, sizeof(linear_hash->split_threshold), (ion_byte_t *) &linear_hash->split_threshold)) {
 		return err_file_write_error;
 	}
 
-	if (1 != fwrite(&linear_hash->num_buckets, sizeof(linear_hash->num_buckets), 1, linear_hash->state)) {
+	if (err_ok != ion_fwrite(linear_hash->state, sizeof(linear_hash->num_buckets), (ion_byte_t *) &linear_hash->num_buckets)) {
 		return err_file_write_error;
 	}
 
-	if (1 != fwrite(&linear_hash->num_records, sizeof(linear_hash->num_records), 1, linear_hash->state)) {
+	if (err_ok != ion_fwrite(linear_hash->state, sizeof(linear_hash->num_records), (ion_byte_t *) &linear_hash->num_records)) {
 		return err_file_write_error;
 	}
 
-	if (1 != fwrite(&linear_hash->records_per_bucket, sizeof(linear_hash->records_per_bucket), 1, linear_hash->state)) {
+	if (err_ok != ion_fwrite(linear_hash->state, sizeof(linear_hash->records_per_bucket), (ion_byte_t *) &linear_hash->records_per_bucket)) {
 		return err_file_write_error;
 	}
 
-	if (1 != fwrite(&linear_hash->bucket_map->current_size, sizeof(int), 1, linear_hash->state)) {
+	if (err_ok != ion_fwrite(linear_hash->state, sizeof(int), (ion_byte_t *) &linear_hash->bucket_map->current_size)) {
 		return err_file_write_error;
 	}
 
@@ -201,7 +208,7 @@ linear_hash_write_state(
 	memset(cached_bucket_map, 0, sizeof(ion_fpos_t) * linear_hash->bucket_map->current_size);
 	memcpy(cached_bucket_map, linear_hash->bucket_map->data, linear_hash->num_buckets * sizeof(ion_fpos_t));
 
-	if (1 != fwrite(cached_bucket_map, sizeof(linear_hash->bucket_map->data), 1, linear_hash->state)) {
+	if (err_ok != ion_fwrite(linear_hash->state, sizeof(linear_hash->bucket_map->data), cached_bucket_map)) {
 		return err_file_write_error;
 	}
 
@@ -219,39 +226,39 @@ ion_err_t
 linear_hash_read_state(
 	linear_hash_table_t *linear_hash
 ) {
-	if (0 != fseek(linear_hash->state, 0, SEEK_SET)) {
+	if (err_ok != ion_fseek(linear_hash->state, 0, ION_FILE_START)) {
 		return err_file_bad_seek;
 	}
 
-	if (1 != fread(&(linear_hash->initial_size), sizeof(linear_hash->initial_size), 1, linear_hash->state)) {
+	if (err_ok != ion_fread(linear_hash->state, sizeof(linear_hash->initial_size), (ion_byte_t *) &linear_hash->initial_size)) {
 		return err_file_read_error;
 	}
 
-	if (1 != fread(&linear_hash->next_split, sizeof(linear_hash->next_split), 1, linear_hash->state)) {
+	if (err_ok != ion_fread(linear_hash->state, sizeof(linear_hash->next_split), (ion_byte_t *) &linear_hash->next_split)) {
 		return err_file_read_error;
 	}
 
-	if (1 != fread(&linear_hash->split_threshold, sizeof(linear_hash->split_threshold), 1, linear_hash->state)) {
+	if (err_ok != ion_fread(linear_hash->state, sizeof(linear_hash->split_threshold), (ion_byte_t *) &linear_hash->split_threshold)) {
 		return err_file_read_error;
 	}
 
-	if (1 != fread(&linear_hash->num_buckets, sizeof(linear_hash->num_buckets), 1, linear_hash->state)) {
+	if (err_ok != ion_fread(linear_hash->state, sizeof(linear_hash->num_buckets), (ion_byte_t *) &linear_hash->num_buckets)) {
 		return err_file_read_error;
 	}
 
-	if (1 != fread(&linear_hash->num_records, sizeof(linear_hash->num_records), 1, linear_hash->state)) {
+	if (err_ok != ion_fread(linear_hash->state, sizeof(linear_hash->num_records), (ion_byte_t *) &linear_hash->num_records)) {
 		return err_file_read_error;
 	}
 
-	if (1 != fread(&linear_hash->records_per_bucket, sizeof(linear_hash->records_per_bucket), 1, linear_hash->state)) {
+	if (err_ok != ion_fread(linear_hash->state, sizeof(linear_hash->records_per_bucket), (ion_byte_t *) &linear_hash->records_per_bucket)) {
 		return err_file_read_error;
 	}
 
-	if (1 != fread(&linear_hash->bucket_map->current_size, sizeof(int), 1, linear_hash->state)) {
+	if (err_ok != ion_fread(linear_hash->state, sizeof(int), (ion_byte_t *) &linear_hash->bucket_map->current_size)) {
 		return err_file_read_error;
 	}
 
-	if (1 != fwrite(&linear_hash->bucket_map->data, sizeof(ion_fpos_t) * linear_hash->num_buckets, 1, linear_hash->state)) {
+	if (err_ok != ion_fwrite(linear_hash->state, sizeof(ion_fpos_t) * linear_hash->num_buckets, (ion_byte_t *) &linear_hash->bucket_map->data)) {
 		return err_file_read_error;
 	}
 
@@ -397,8 +404,7 @@ split(
 		/* if the bucket is not empty */
 		if (bucket.record_count > 0) {
 			/* read all records into memory */
-			fseek(linear_hash->database, bucket_loc + sizeof(linear_hash_bucket_t), SEEK_SET);
-			fread(records, linear_hash->record_total_size, linear_hash->records_per_bucket, linear_hash->database);
+			ion_fread_at(linear_hash->database, bucket_loc + sizeof(linear_hash_bucket_t), linear_hash->record_total_size * linear_hash->records_per_bucket, records);
 
 			/* scan records for records that should be placed in the new bucket */
 			for (i = 0; i < bucket.record_count; i++) {
@@ -436,8 +442,7 @@ split(
 					}
 
 					/* refresh cached data and restart iteration and offset tracker */
-					fseek(linear_hash->database, bucket_loc + sizeof(linear_hash_bucket_t), SEEK_SET);
-					fread(records, linear_hash->record_total_size, linear_hash->records_per_bucket, linear_hash->database);
+					ion_fread_at(linear_hash->database, bucket_loc + sizeof(linear_hash_bucket_t), linear_hash->record_total_size * linear_hash->records_per_bucket, records);
 					status.error	= linear_hash_get_bucket(bucket_loc, &bucket, linear_hash);
 					i				= -1;
 					record_offset	= -1 * linear_hash->record_total_size;
@@ -712,8 +717,7 @@ linear_hash_get(
 
 	while (terminal == boolean_false && found == boolean_false) {
 		record_loc = bucket_loc + sizeof(linear_hash_bucket_t);
-		fseek(linear_hash->database, bucket_loc + sizeof(linear_hash_bucket_t), SEEK_SET);
-		fread(records, linear_hash->record_total_size, linear_hash->records_per_bucket, linear_hash->database);
+		ion_fread_at(linear_hash->database, bucket_loc + sizeof(linear_hash_bucket_t), linear_hash->record_total_size * linear_hash->records_per_bucket, records);
 
 		for (i = 0; i < linear_hash->records_per_bucket; i++) {
 			memcpy(&record_status, records + record_offset, sizeof(record_status));
@@ -759,6 +763,127 @@ linear_hash_get(
 	return status;
 }
 
+/**
+@brief		Retrieve the records of a batch of keys from the linear hash.
+@details	Each round reads the next bucket of the chain of every key still being
+			looked for through one @ref ion_file_queue_t, so that the chains of a batch
+			are walked side by side rather than one after another.
+@param[in]	num_keys
+				How many keys to look up.
+@param[in]	keys
+				The keys.
+@param[in]	values
+				Pointers where the value of each key found is written back to.
+@param[in]	statuses
+				The status of each lookup. Only keys whose status is err_uninitialized are looked up.
+@param[in]	linear_hash
+				Pointer to a linear hash instance.
+@return		Resulting status of the batch as a whole.
+*/
+ion_err_t
+linear_hash_get_many(
+	unsigned int		num_keys,
+	ion_key_t			*keys,
+	ion_value_t			*values,
+	ion_status_t		*statuses,
+	linear_hash_table_t *linear_hash
+) {
+	size_t				bucket_size = sizeof(linear_hash_bucket_t) + linear_hash->record_total_size * linear_hash->records_per_bucket;
+	ion_file_queue_t	*queue;
+	ion_file_read_t		reads[ION_FILE_QUEUE_DEPTH];
+	/* the keys still being looked for */
+	unsigned int		probing[ION_FILE_QUEUE_DEPTH];
+	ion_fpos_t			locations[ION_FILE_QUEUE_DEPTH];
+	ion_fpos_t			overflow_location;
+	ion_byte_t			*buckets;
+	ion_byte_t			*record;
+	unsigned int		next		= 0;
+	unsigned int		num_probing = 0;
+	unsigned int		num_left;
+	unsigned int		i;
+	int					bucket_idx;
+	int					j;
+	ion_err_t			err;
+
+	buckets = malloc(ION_FILE_QUEUE_DEPTH * bucket_size);
+
+	if (NULL == buckets) {
+		return err_out_of_memory;
+	}
+
+	err = ion_file_queue_local(&queue);
+
+	if (err_ok != err) {
+		free(buckets);
+		return err;
+	}
+
+	while ((next < num_keys) || (num_probing > 0)) {
+		/* top the round up with the primary buckets of keys not looked for yet */
+		for (; (next < num_keys) && (num_probing < ION_FILE_QUEUE_DEPTH); next++) {
+			if (err_uninitialized == statuses[next].error) {
+				bucket_idx = insert_hash_to_bucket(keys[next], linear_hash);
+
+				if (bucket_idx < linear_hash->next_split) {
+					bucket_idx = hash_to_bucket(keys[next], linear_hash);
+				}
+
+				probing[num_probing]	= next;
+				locations[num_probing]	= bucket_idx_to_ion_fpos_t(bucket_idx, linear_hash);
+				num_probing++;
+			}
+		}
+
+		for (i = 0; i < num_probing; i++) {
+			reads[i].file		= linear_hash->database;
+			reads[i].offset		= locations[i];
+			reads[i].num_bytes	= bucket_size;
+			reads[i].write_to	= buckets + bucket_size * i;
+			ion_file_queue_read(queue, &reads[i]);
+		}
+
+		ion_file_queue_wait(queue);
+
+		/* settle what the round answered, keeping the rest in order */
+		num_left = 0;
+
+		for (i = 0; i < num_probing; i++) {
+			if (err_ok != reads[i].error) {
+				statuses[probing[i]] = ION_STATUS_ERROR(reads[i].error);
+				continue;
+			}
+
+			statuses[probing[i]] = ION_STATUS_ERROR(err_item_not_found);
+
+			for (j = 0; j < linear_hash->records_per_bucket; j++) {
+				record = buckets + bucket_size * i + sizeof(linear_hash_bucket_t) + linear_hash->record_total_size * j;
+
+				if ((linear_hash_record_status_empty != *record) && (0 == linear_hash->super.compare(record + sizeof(ion_byte_t), keys[probing[i]], linear_hash->super.record.key_size))) {
+					memcpy(values[probing[i]], record + sizeof(ion_byte_t) + linear_hash->super.record.key_size, linear_hash->super.record.value_size);
+					statuses[probing[i]] = ION_STATUS_OK(1);
+					break;
+				}
+			}
+
+			/* laid out as in linear_hash_get_bucket */
+			memcpy(&overflow_location, buckets + bucket_size * i + 2 * sizeof(int), sizeof(ion_fpos_t));
+
+			if ((err_ok != statuses[probing[i]].error) && (linear_hash_end_of_list != overflow_location)) {
+				statuses[probing[i]]	= ION_STATUS_INITIALIZE;
+				probing[num_left]		= probing[i];
+				locations[num_left]		= overflow_location;
+				num_left++;
+			}
+		}
+
+		num_probing = num_left;
+	}
+
+	free(buckets);
+
+	return err_ok;
+}
+
 /* linear hash operations */
 /**
 @brief		Update the value of the first record matching the key specified in the linear hash.
@@ -912,8 +1037,7 @@ linear_hash_delete(
 
 	while (terminal == boolean_false) {
 		record_loc = bucket_loc + sizeof(linear_hash_bucket_t);
-		fseek(linear_hash->database, bucket_loc + sizeof(linear_hash_bucket_t), SEEK_SET);
-		fread(records, linear_hash->record_total_size, linear_hash->records_per_bucket, linear_hash->database);
+		ion_fread_at(linear_hash->database, bucket_loc + sizeof(linear_hash_bucket_t), linear_hash->record_total_size * linear_hash->records_per_bucket, records);
 
 		for (i = 0; i < bucket.record_count; i++) {
 			/* read in record */
@@ -1021,15 +1145,10 @@ linear_hash_get_record(
 	ion_byte_t			*status,
 	linear_hash_table_t *linear_hash
 ) {
-	/* seek to location of record in file */
-	if (0 != fseek(linear_hash->database, loc, SEEK_SET)) {
-		return err_file_bad_seek;
-	}
-
-	/* cache record data from file */
+	/* cache record data from file, without moving the file position so that readers can share it */
 	ion_byte_t *record = alloca(linear_hash->record_total_size);
 
-	if (1 != fread(record, linear_hash->record_total_size, 1, linear_hash->database)) {
+	if (err_ok != ion_fread_at(linear_hash->database, loc, linear_hash->record_total_size, record)) {
 		return err_file_read_error;
 	}
 
@@ -1064,12 +1183,12 @@ linear_hash_write_record(
 	linear_hash_table_t *linear_hash
 ) {
 	/* check the file is open */
-	if (!linear_hash->database) {
+	if (ION_FILE_IS_NULL(linear_hash->database)) {
 		return err_file_close_error;
 	}
 
 	/* seek to end of file to append new bucket */
-	if (0 != fseek(linear_hash->database, record_loc, SEEK_SET)) {
+	if (err_ok != ion_fseek(linear_hash->database, record_loc, ION_FILE_START)) {
 		return err_file_bad_seek;
 	}
 
@@ -1079,7 +1198,7 @@ linear_hash_write_record(
 	memcpy(record + sizeof(*status), key, linear_hash->super.record.key_size);
 	memcpy(record + linear_hash->super.record.key_size + sizeof(*status), value, linear_hash->super.record.value_size);
 
-	if (1 != fwrite(record, linear_hash->record_total_size, 1, linear_hash->database)) {
+	if (err_ok != ion_fwrite(linear_hash->database, linear_hash->record_total_size, record)) {
 		return err_file_write_error;
 	}
 
@@ -1100,7 +1219,7 @@ write_new_bucket(
 	int					idx,
 	linear_hash_table_t *linear_hash
 ) {
-	if (linear_hash->database == NULL) {
+	if (ION_FILE_IS_NULL(linear_hash->database)) {
 		return err_file_open_error;
 	}
 
@@ -1114,26 +1233,26 @@ write_new_bucket(
 	/* seek to end of file to append new bucket */
 	ion_fpos_t bucket_loc;
 
-	if (0 != fseek(linear_hash->database, 0, SEEK_END)) {
+	if (err_ok != ion_fseek(linear_hash->database, 0, ION_FILE_END)) {
 		return err_file_bad_seek;
 	}
 
-	bucket_loc = ftell(linear_hash->database);
+	bucket_loc = ion_ftell(linear_hash->database);
 
 	/* write bucket data to file */
-	if (1 != fwrite(&bucket, sizeof(linear_hash_bucket_t), 1, linear_hash->database)) {
+	if (err_ok != ion_fwrite(linear_hash->database, sizeof(linear_hash_bucket_t), (ion_byte_t *) &bucket)) {
 		return err_file_write_error;
 	}
 
 	/* write bucket data to file */
 	ion_byte_t record_blank[linear_hash->super.record.key_size + linear_hash->super.record.value_size + sizeof(linear_hash_record_status_empty)];
 
-	memset(record_blank, 0, linear_hash->super.record.key_size + linear_hash->super.record.value_size);
+	memset(record_blank, 0, sizeof(record_blank));
 
 	int i;
 
 	for (i = 0; i < linear_hash->records_per_bucket; i++) {
-		if (1 != fwrite(record_blank, linear_hash->super.record.key_size + linear_hash->super.record.value_size + sizeof(linear_hash_record_status_empty), 1, linear_hash->database)) {
+		if (err_ok != ion_fwrite(linear_hash->database, linear_hash->super.record.key_size + linear_hash->super.record.value_size + sizeof(linear_hash_record_status_empty), record_blank)) {
 			return err_file_write_error;
 		}
 	}
@@ -1168,18 +1287,14 @@ linear_hash_get_bucket(
 	if (bucket_loc == -1) {}
 
 	/* check if file is open */
-	if (!linear_hash->database) {
+	if (ION_FILE_IS_NULL(linear_hash->database)) {
 		return err_file_close_error;
 	}
 
-	/* seek to location of record in file */
-	if (0 != fseek(linear_hash->database, bucket_loc, SEEK_SET)) {
-		return err_file_bad_seek;
-	}
-
 	ion_byte_t *bucket_cache = alloca(sizeof(linear_hash_bucket_t));
 
-	if (1 != fread(bucket_cache, sizeof(linear_hash_bucket_t), 1, linear_hash->database)) {
+	/* read without moving the file position so that readers can share it */
+	if (err_ok != ion_fread_at(linear_hash->database, bucket_loc, sizeof(linear_hash_bucket_t), bucket_cache)) {
 		return err_file_read_error;
 	}
 
@@ -1208,17 +1323,17 @@ linear_hash_update_bucket(
 	linear_hash_table_t		*linear_hash
 ) {
 	/* check the file is open */
-	if (NULL == linear_hash->database) {
+	if (ION_FILE_IS_NULL(linear_hash->database)) {
 		return err_file_open_error;
 	}
 
 	/* seek to end of file to append new bucket */
-	if (0 != fseek(linear_hash->database, bucket_loc, SEEK_SET)) {
+	if (err_ok != ion_fseek(linear_hash->database, bucket_loc, ION_FILE_START)) {
 		return err_file_bad_seek;
 	}
 
 	/* write bucket data to file */
-	if (1 != fwrite(bucket, sizeof(linear_hash_bucket_t), 1, linear_hash->database)) {
+	if (err_ok != ion_fwrite(linear_hash->database, sizeof(linear_hash_bucket_t), (ion_byte_t *) bucket)) {
 		return err_file_write_error;
 	}
 
@@ -1252,12 +1367,12 @@ create_overflow_bucket(
 	bucket.overflow_location	= array_list_get(bucket_idx, linear_hash->bucket_map);
 
 	/* seek to end of file to append new bucket */
-	if (0 != fseek(linear_hash->database, 0, SEEK_END)) {
+	if (err_ok != ion_fseek(linear_hash->database, 0, ION_FILE_END)) {
 		return err_file_bad_seek;
 	}
 
 	/* get overflow location for new overflow bucket */
-	*overflow_loc	= ftell(linear_hash->database);
+	*overflow_loc	= ion_ftell(linear_hash->database);
 
 	err				= array_list_insert(bucket.idx, *overflow_loc, linear_hash->bucket_map);
 
@@ -1266,7 +1381,7 @@ create_overflow_bucket(
 	}
 
 	/* write to file */
-	if (1 != fwrite(&bucket, sizeof(linear_hash_bucket_t), 1, linear_hash->database)) {
+	if (err_ok != ion_fwrite(linear_hash->database, sizeof(linear_hash_bucket_t), (ion_byte_t *) &bucket)) {
 		return err_file_write_error;
 	}
 
@@ -1278,7 +1393,7 @@ create_overflow_bucket(
 	int i;
 
 	for (i = 0; i < linear_hash->records_per_bucket; i++) {
-		if (1 != fwrite(record_blank, linear_hash->super.record.key_size + linear_hash->super.record.value_size + sizeof(linear_hash_record_status_empty), 1, linear_hash->database)) {
+		if (err_ok != ion_fwrite(linear_hash->database, linear_hash->super.record.key_size + linear_hash->super.record.value_size + sizeof(linear_hash_record_status_empty), record_blank)) {
 			return err_file_write_error;
 		}
 	}
@@ -1455,6 +1570,197 @@ array_list_get(
 	}
 }
 
+/**
+@brief		Rewrites the state of a linear hash to its .lhs file and forces
+			the state and the records to the device.
+@param[in]	linear_hash
+				The linear hash instance to sync.
+@return		Resulting status of the several file operations used to commit the write.
+*/
+ion_err_t
+linear_hash_sync(
+	linear_hash_table_t *linear_hash
+) {
+	ion_err_t err;
+
+	if (err_ok != ion_fseek(linear_hash->state, 0, ION_FILE_START)) {
+		return err_file_bad_seek;
+	}
+
+	err = linear_hash_write_state(linear_hash);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	err = ion_fsync(linear_hash->state);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	return ion_fsync(linear_hash->database);
+}
+
+/**
+@brief		Gives the number of bucket chains in the linear hash, for a parallel scan.
+@param[out]	num_positions
+				Set to the number of bucket chains.
+@param[out]	position_size
+				Set to the size of one bucket in the linear hash's .lhd file, records included.
+@param[in]	linear_hash
+				Pointer to a linear hash instance.
+@return		Resulting status of the operation.
+*/
+ion_err_t
+linear_hash_scan_extent(
+	ion_fpos_t			*num_positions,
+	size_t				*position_size,
+	linear_hash_table_t *linear_hash
+) {
+	*num_positions	= linear_hash->num_buckets;
+	*position_size	= sizeof(linear_hash_bucket_t) + linear_hash->record_total_size * linear_hash->records_per_bucket;
+
+	return err_ok;
+}
+
+/**
+@brief		Passes the records of a bucket read by a scan on to the scan.
+@param[in]	range
+				The range being read.
+@param[in]	bucket
+				The bucket as laid out in the file.
+@param[out]	overflow_location
+				Set to the location of the bucket's overflow bucket.
+@param[in]	linear_hash
+				Pointer to a linear hash instance.
+@return		False once the scan is to stop.
+*/
+static ion_boolean_t
+linear_hash_scan_bucket(
+	ion_dictionary_scan_range_t *range,
+	ion_byte_t					*bucket,
+	ion_fpos_t					*overflow_location,
+	linear_hash_table_t			*linear_hash
+) {
+	int			record_count;
+	ion_byte_t	*record;
+	int			i;
+
+	/* laid out as in linear_hash_get_bucket */
+	memcpy(&record_count, bucket + sizeof(int), sizeof(int));
+	memcpy(overflow_location, bucket + 2 * sizeof(int), sizeof(ion_fpos_t));
+
+	/* only the first record_count slots are live, blank slots are not guaranteed a clean status byte */
+	for (i = 0; i < record_count; i++) {
+		record = bucket + sizeof(linear_hash_bucket_t) + linear_hash->record_total_size * i;
+
+		if ((linear_hash_record_status_full == *record) && !dictionary_scan_emit(range, record + sizeof(ion_byte_t), record + sizeof(ion_byte_t) + linear_hash->super.record.key_size)) {
+			return boolean_false;
+		}
+	}
+
+	return boolean_true;
+}
+
+/**
+@brief		Reads the next buckets of a scan range and passes their records on to the scan.
+@details	The primary buckets of as many positions as fit in the range's buffer
+			are read at once through an @ref ion_file_queue_t. A chain is then
+			followed one overflow bucket at a time, so the range stays on a chain
+			until its last overflow bucket has been read.
+@param[in]	range
+				The range being read.
+@param[in]	linear_hash
+				Pointer to a linear hash instance.
+@return		Resulting status of the several file operations used to read the buckets.
+*/
+ion_err_t
+linear_hash_scan_range(
+	ion_dictionary_scan_range_t *range,
+	linear_hash_table_t			*linear_hash
+) {
+	size_t				bucket_size = sizeof(linear_hash_bucket_t) + linear_hash->record_total_size * linear_hash->records_per_bucket;
+	ion_file_queue_t	*queue;
+	ion_file_read_t		reads[ION_FILE_QUEUE_DEPTH];
+	ion_fpos_t			num_buckets;
+	ion_fpos_t			overflow_location;
+	ion_fpos_t			i;
+	ion_err_t			err;
+
+	if (-1 != range->resume) {
+		if (err_ok != ion_fread_at(linear_hash->database, range->resume, bucket_size, range->buffer)) {
+			return err_file_read_error;
+		}
+
+		if (linear_hash_scan_bucket(range, range->buffer, &overflow_location, linear_hash)) {
+			range->resume = overflow_location;
+
+			if (linear_hash_end_of_list == overflow_location) {
+				range->position++;
+				range->resume = -1;
+			}
+		}
+
+		return err_ok;
+	}
+
+	num_buckets = range->buffer_size / bucket_size;
+
+	if (num_buckets > ION_FILE_QUEUE_DEPTH) {
+		num_buckets = ION_FILE_QUEUE_DEPTH;
+	}
+
+	if (num_buckets > range->end - range->position) {
+		num_buckets = range->end - range->position;
+	}
+
+	err = ion_file_queue_local(&queue);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	for (i = 0; i < num_buckets; i++) {
+		reads[i].file		= linear_hash->database;
+		reads[i].offset		= bucket_idx_to_ion_fpos_t(range->position + i, linear_hash);
+		reads[i].num_bytes	= bucket_size;
+		reads[i].write_to	= range->buffer + bucket_size * i;
+
+		/* a bucket that has not been written yet is skipped */
+		if (linear_hash_end_of_list != reads[i].offset) {
+			ion_file_queue_read(queue, &reads[i]);
+		}
+	}
+
+	err = ion_file_queue_wait(queue);
+
+	if (err_ok != err) {
+		return err_file_read_error;
+	}
+
+	for (i = 0; i < num_buckets; i++) {
+		if (linear_hash_end_of_list == reads[i].offset) {
+			range->position++;
+			continue;
+		}
+
+		if (!linear_hash_scan_bucket(range, range->buffer + bucket_size * i, &overflow_location, linear_hash)) {
+			break;
+		}
+
+		if (linear_hash_end_of_list != overflow_location) {
+			/* the buckets read after this one are read again once its chain is done */
+			range->resume = overflow_location;
+			break;
+		}
+
+		range->position++;
+	}
+
+	return err_ok;
+}
+
 /**
 @brief		Close a linear hash instance with proper resource clean-up.
 @brief		This will free all the references related to the linear hash in memory and writes it state to its associated .lhs file.
@@ -1466,7 +1772,7 @@ ion_err_t
 linear_hash_close(
 	linear_hash_table_t *linear_hash
 ) {
-	if (0 != fclose(linear_hash->state)) {
+	if (err_ok != ion_fclose(linear_hash->state)) {
 		linear_hash_write_state(linear_hash);
 		return err_file_close_error;
 	}
@@ -1481,7 +1787,7 @@ linear_hash_close(
 		linear_hash->bucket_map = NULL;
 	}
 
-	if (0 != fclose(linear_hash->database)) {
+	if (err_ok != ion_fclose(linear_hash->database)) {
 		return err_file_close_error;
 	}
 
@@ -1490,9 +1796,9 @@ linear_hash_close(
 		linear_hash->bucket_map = NULL;
 	}
 
-	linear_hash->database	= NULL;
+	linear_hash->database	= ION_NOFILE;
 
-	linear_hash->state		= NULL;
+	linear_hash->state		= ION_NOFILE;
 
 	return err_ok;
 }
@@ -1517,13 +1823,13 @@ linear_hash_destroy(
 
 	dictionary_get_filename(linear_hash->super.id, "lhs", filename);
 
-	if (0 != fremove(filename)) {
+	if (err_ok != ion_fremove(filename)) {
 		return err_file_delete_error;
 	}
 
 	dictionary_get_filename(linear_hash->super.id, "lhd", filename);
 
-	if (0 != fremove(filename)) {
+	if (err_ok != ion_fremove(filename)) {
 		return err_file_delete_error;
 	}
 
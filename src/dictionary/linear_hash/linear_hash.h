@@ -36,6 +36,7 @@
 
 #include <stdio.h>
 #include "linear_hash_types.h"
+#include "../../file/ion_file_queue.h"
 
 #if defined(ARDUINO)
 #include "../../serial/serial_c_iface.h"
@@ -271,6 +272,33 @@ linear_hash_close(
 	linear_hash_table_t *linear_hash
 );
 
+ion_err_t
+linear_hash_sync(
+	linear_hash_table_t *linear_hash
+);
+
+ion_err_t
+linear_hash_get_many(
+	unsigned int		num_keys,
+	ion_key_t			*keys,
+	ion_value_t			*values,
+	ion_status_t		*statuses,
+	linear_hash_table_t *linear_hash
+);
+
+ion_err_t
+linear_hash_scan_extent(
+	ion_fpos_t			*num_positions,
+	size_t				*position_size,
+	linear_hash_table_t *linear_hash
+);
+
+ion_err_t
+linear_hash_scan_range(
+	ion_dictionary_scan_range_t *range,
+	linear_hash_table_t			*linear_hash
+);
+
 void
 print_linear_hash_distribution(
 	linear_hash_table_t *linear_hash
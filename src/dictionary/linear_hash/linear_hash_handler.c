@@ -47,9 +47,14 @@ linear_hash_dict_init(
 	handler->delete_dictionary	= linear_hash_delete_dictionary;
 	handler->destroy_dictionary = linear_hash_destroy_dictionary;
 	handler->update				= linear_hash_dict_update;
-	/* handler->find				= linear_hash_dict_find; */
+	handler->find				= NULL;	/* Cursors are not supported yet, see linear_hash_dict_find. Use a parallel scan instead. */
 	handler->close_dictionary	= linear_hash_close_dictionary;
 	handler->open_dictionary	= linear_hash_open_dictionary;
+	handler->sync_dictionary	= linear_hash_sync_dictionary;
+	handler->scan_extent		= linear_hash_dict_scan_extent;
+	handler->scan_range			= linear_hash_dict_scan_range;
+	handler->get_many			= linear_hash_dict_get_many;
+	handler->concurrent			= boolean_false;
 }
 
 ion_status_t
@@ -131,13 +136,13 @@ linear_hash_destroy_dictionary(
 
 	dictionary_get_filename(id, "lhs", filename);
 
-	if (0 != fremove(filename)) {
+	if (err_ok != ion_fremove(filename)) {
 		return err_file_delete_error;
 	}
 
 	dictionary_get_filename(id, "lhd", filename);
 
-	if (0 != fremove(filename)) {
+	if (err_ok != ion_fremove(filename)) {
 		return err_file_delete_error;
 	}
 
@@ -183,6 +188,41 @@ linear_hash_close_dictionary(
 	return err_ok;
 }
 
+ion_err_t
+linear_hash_sync_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	return linear_hash_sync((linear_hash_table_t *) dictionary->instance);
+}
+
+ion_err_t
+linear_hash_dict_get_many(
+	ion_dictionary_t	*dictionary,
+	unsigned int		num_keys,
+	ion_key_t			*keys,
+	ion_value_t			*values,
+	ion_status_t		*statuses
+) {
+	return linear_hash_get_many(num_keys, keys, values, statuses, (linear_hash_table_t *) dictionary->instance);
+}
+
+ion_err_t
+linear_hash_dict_scan_extent(
+	ion_dictionary_t	*dictionary,
+	ion_fpos_t			*num_positions,
+	size_t				*position_size
+) {
+	return linear_hash_scan_extent(num_positions, position_size, (linear_hash_table_t *) dictionary->instance);
+}
+
+ion_err_t
+linear_hash_dict_scan_range(
+	ion_dictionary_t			*dictionary,
+	ion_dictionary_scan_range_t *range
+) {
+	return linear_hash_scan_range(range, (linear_hash_table_t *) dictionary->instance);
+}
+
 ion_status_t
 linear_hash_dict_find(
 	ion_dictionary_t *dictionary
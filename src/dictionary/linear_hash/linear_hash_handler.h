@@ -117,6 +117,33 @@ linear_hash_close_dictionary(
 	ion_dictionary_t *dictionary
 );
 
+ion_err_t
+linear_hash_sync_dictionary(
+	ion_dictionary_t *dictionary
+);
+
+ion_err_t
+linear_hash_dict_get_many(
+	ion_dictionary_t	*dictionary,
+	unsigned int		num_keys,
+	ion_key_t			*keys,
+	ion_value_t			*values,
+	ion_status_t		*statuses
+);
+
+ion_err_t
+linear_hash_dict_scan_extent(
+	ion_dictionary_t	*dictionary,
+	ion_fpos_t			*num_positions,
+	size_t				*position_size
+);
+
+ion_err_t
+linear_hash_dict_scan_range(
+	ion_dictionary_t			*dictionary,
+	ion_dictionary_scan_range_t *range
+);
+
 ion_err_t
 linear_hash_open_dictionary(
 	ion_dictionary_handler_t		*handler,
@@ -37,6 +37,7 @@
 #include <stdio.h>
 #include "../../key_value/kv_system.h"
 #include "../dictionary.h"
+#include "../../file/ion_file.h"
 #include "../../file/sd_stdio_c_iface.h"
 
 typedef ion_byte_t *linear_hash_record_status_t;
@@ -77,8 +78,8 @@ typedef struct {
 	int						num_records;
 	int						records_per_bucket;
 	ion_fpos_t				record_total_size;
-	FILE					*database;
-	FILE					*state;
+	ion_file_handle_t		database;
+	ion_file_handle_t		state;
 
 	/* maps the location of the head of the linked list of buckets corresponding to its index */
 	array_list_t			*bucket_map;
@@ -0,0 +1,1490 @@
+/******************************************************************************/
+/**
+@file		lsm.c
+@author		IonDB Project
+@brief		Log-structured merge tree built from the skip list and sorted flat files.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "lsm.h"
+
+/**
+@brief		Works out the ID that names the run stored in a slot.
+@param[in]	id
+				The ID of the LSM tree.
+@param[in]	slot
+				The slot of the run.
+@return		The ID of the run's flat file.
+*/
+static ion_dictionary_id_t
+lsm_run_id(
+	ion_dictionary_id_t id,
+	int					slot
+) {
+	return ION_LSM_RUN_ID_BASE + id * ION_LSM_RUN_SLOTS + slot;
+}
+
+/**
+@brief		Removes the files of a run, whether or not they exist.
+@param[in]	run_id
+				The ID of the run's flat file.
+*/
+static void
+lsm_run_remove_files(
+	ion_dictionary_id_t run_id
+) {
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(run_id, "ffs", filename);
+
+	if (ion_fexists(filename)) {
+		ion_fremove(filename);
+	}
+
+	dictionary_get_filename(run_id, ION_FLAT_FILE_ZONE_MAP_EXTENSION, filename);
+
+	if (ion_fexists(filename)) {
+		ion_fremove(filename);
+	}
+}
+
+/**
+@brief		Opens the run stored in a slot.
+@param[in]	lsm
+				The LSM tree the run belongs to.
+@param[in]	slot
+				The slot of the run.
+@param[in]	fresh
+				If @c boolean_true, anything left in the slot is discarded and an
+				empty run is started. Rows must then be appended in key order,
+				followed by @ref lsm_run_finish.
+@param[out]	run
+				Where to write the opened run.
+@return		The status of the open.
+*/
+static ion_err_t
+lsm_run_open(
+	ion_lsm_t		*lsm,
+	int				slot,
+	ion_boolean_t	fresh,
+	ion_lsm_run_t	**run
+) {
+	ion_dictionary_id_t run_id = lsm_run_id(lsm->super.id, slot);
+
+	if (fresh) {
+		lsm_run_remove_files(run_id);
+	}
+
+	*run = malloc(sizeof(ion_lsm_run_t));
+
+	if (NULL == *run) {
+		return err_out_of_memory;
+	}
+
+	(*run)->slot						= slot;
+	(*run)->flat_file.super.compare		= lsm->super.compare;
+	(*run)->flat_file.super.type		= dictionary_type_flat_file_t;
+
+	ion_err_t err = flat_file_initialize(&(*run)->flat_file, run_id, lsm->super.key_type, lsm->super.record.key_size, lsm->super.record.value_size + sizeof(ion_lsm_tag_t), ION_LSM_RUN_BUFFERED_ROWS);
+
+	if (err_ok != err) {
+		free(*run);
+		*run = NULL;
+		return err;
+	}
+
+#if ION_FILE_STATS
+	/* Charge the run's I/O to the LSM tree rather than to the reserved run ID. */
+	ion_file_set_owner((*run)->flat_file.data_file, lsm->super.id);
+#endif
+
+	if (!fresh && !(*run)->flat_file.sorted_mode) {
+		/* A run listed in the manifest is always finished, so this one has been damaged. */
+		flat_file_close(&(*run)->flat_file);
+		free(*run);
+		*run = NULL;
+		return err_file_read_error;
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Marks a run whose rows have all been appended as sorted, and flushes it.
+@details	Rows are appended with the run out of sorted mode, which spares
+			@ref flat_file_insert from reading back the last row on every append.
+@param[in]	run
+				The run to finish.
+@return		The status of the write.
+*/
+static ion_err_t
+lsm_run_finish(
+	ion_lsm_run_t *run
+) {
+	run->flat_file.sorted_mode = boolean_true;
+
+	ion_err_t err = flat_file_write_header(&run->flat_file);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	return ion_fflush(run->flat_file.data_file);
+}
+
+/**
+@brief		Closes a run and removes its files.
+@param[in]	run
+				The run to discard. It is freed.
+@return		The status of the removal.
+*/
+static ion_err_t
+lsm_run_discard(
+	ion_lsm_run_t *run
+) {
+	ion_err_t err = flat_file_destroy(&run->flat_file);
+
+	free(run);
+	return err;
+}
+
+/**
+@brief		Closes a run, keeping its files.
+@param[in]	run
+				The run to close. It is freed.
+@return		The status of closing.
+*/
+static ion_err_t
+lsm_run_close(
+	ion_lsm_run_t *run
+) {
+	ion_err_t err = flat_file_close(&run->flat_file);
+
+	free(run);
+	return err;
+}
+
+/**
+@brief		Finds a slot that no run is stored in.
+@param[in]	lsm
+				The LSM tree to look in.
+@return		The free slot, or -1 if there is none.
+*/
+static int
+lsm_free_slot(
+	ion_lsm_t *lsm
+) {
+	ion_boolean_t	used[ION_LSM_RUN_SLOTS] = { boolean_false };
+	int				level;
+	int				i;
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		for (i = 0; i < lsm->num_runs[level]; i++) {
+			used[lsm->runs[level][i]->slot] = boolean_true;
+		}
+	}
+
+	for (i = 0; i < ION_LSM_RUN_SLOTS; i++) {
+		if (!used[i]) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+@brief		Starts an empty run in a free slot.
+@param[in]	lsm
+				The LSM tree the run belongs to.
+@param[out]	run
+				Where to write the new run.
+@return		The status of creating the run.
+*/
+static ion_err_t
+lsm_run_create(
+	ion_lsm_t		*lsm,
+	ion_lsm_run_t	**run
+) {
+	int slot = lsm_free_slot(lsm);
+
+	if (-1 == slot) {
+		return err_max_capacity;
+	}
+
+	return lsm_run_open(lsm, slot, boolean_true, run);
+}
+
+/**
+@brief		Checks whether a level and every level below it are empty.
+@param[in]	lsm
+				The LSM tree to check.
+@param[in]	level
+				The first level to check.
+@return		@c boolean_true if none of the levels hold a run.
+*/
+static ion_boolean_t
+lsm_levels_empty_from(
+	ion_lsm_t	*lsm,
+	int			level
+) {
+	for (; level < ION_LSM_MAX_LEVELS; level++) {
+		if (0 != lsm->num_runs[level]) {
+			return boolean_false;
+		}
+	}
+
+	return boolean_true;
+}
+
+/**
+@brief		Writes the manifest, replacing the previous one only once the new one is complete.
+@param[in]	lsm
+				The LSM tree whose runs to record.
+@param[in]	durable
+				Whether to force the manifest to the device before it replaces the old one.
+@return		The status of the write.
+*/
+static ion_err_t
+lsm_write_manifest(
+	ion_lsm_t		*lsm,
+	ion_boolean_t	durable
+) {
+	ion_lsm_manifest_t	manifest;
+	int					level;
+	int					i;
+
+	memset(&manifest, 0, sizeof(manifest));
+	manifest.magic			= ION_LSM_MANIFEST_MAGIC;
+	manifest.max_levels		= ION_LSM_MAX_LEVELS;
+	manifest.runs_per_level = ION_LSM_RUNS_PER_LEVEL;
+	manifest.compaction		= lsm->compaction;
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		manifest.num_runs[level] = lsm->num_runs[level];
+
+		for (i = 0; i < lsm->num_runs[level]; i++) {
+			manifest.slots[level][i] = lsm->runs[level][i]->slot;
+		}
+	}
+
+	char	temp_filename[ION_MAX_FILENAME_LENGTH];
+	char	filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(lsm->super.id, ION_LSM_MANIFEST_TEMP_EXTENSION, temp_filename);
+	dictionary_get_filename(lsm->super.id, ION_LSM_MANIFEST_EXTENSION, filename);
+
+	if (ion_fexists(temp_filename)) {
+		ion_fremove(temp_filename);
+	}
+
+	ion_file_handle_t file = ion_fopen(temp_filename);
+
+	if (ION_FILE_IS_NULL(file)) {
+		return err_file_open_error;
+	}
+
+#if ION_FILE_STATS
+	ion_file_set_owner(file, lsm->super.id);
+#endif
+
+	ion_err_t err = ion_fwrite(file, sizeof(manifest), (ion_byte_t *) &manifest);
+
+	if ((err_ok == err) && durable) {
+		err = ion_fsync(file);
+	}
+
+	if ((err_ok != ion_fclose(file)) && (err_ok == err)) {
+		err = err_file_close_error;
+	}
+
+	if (err_ok != err) {
+		ion_fremove(temp_filename);
+		return err;
+	}
+
+	return ion_frename(temp_filename, filename);
+}
+
+/**
+@brief		Reopens the runs listed in the manifest, writing an empty manifest if there is none.
+@param[in]	lsm
+				The LSM tree to load the runs of. It must not hold any runs yet.
+@return		The status of the load.
+*/
+static ion_err_t
+lsm_read_manifest(
+	ion_lsm_t *lsm
+) {
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(lsm->super.id, ION_LSM_MANIFEST_EXTENSION, filename);
+
+	if (!ion_fexists(filename)) {
+		return lsm_write_manifest(lsm, boolean_false);
+	}
+
+	ion_file_handle_t file = ion_fopen(filename);
+
+	if (ION_FILE_IS_NULL(file)) {
+		return err_file_open_error;
+	}
+
+	ion_lsm_manifest_t	manifest;
+	ion_err_t			err = ion_fread(file, sizeof(manifest), (ion_byte_t *) &manifest);
+
+	ion_fclose(file);
+
+	if (err_ok != err) {
+		return err_file_read_error;
+	}
+
+	if ((ION_LSM_MANIFEST_MAGIC != manifest.magic) || (ION_LSM_MAX_LEVELS != manifest.max_levels) || (ION_LSM_RUNS_PER_LEVEL != manifest.runs_per_level)) {
+		return err_file_read_error;
+	}
+
+	lsm->compaction = manifest.compaction;
+
+	int level;
+	int i;
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		if (manifest.num_runs[level] > ION_LSM_RUNS_PER_LEVEL) {
+			err = err_file_read_error;
+			goto CLEANUP;
+		}
+
+		for (i = 0; i < manifest.num_runs[level]; i++) {
+			if (manifest.slots[level][i] >= ION_LSM_RUN_SLOTS) {
+				err = err_file_read_error;
+				goto CLEANUP;
+			}
+
+			err = lsm_run_open(lsm, manifest.slots[level][i], boolean_false, &lsm->runs[level][i]);
+
+			if (err_ok != err) {
+				goto CLEANUP;
+			}
+
+			lsm->num_runs[level]++;
+		}
+	}
+
+	return err_ok;
+
+CLEANUP:
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		for (i = 0; i < lsm->num_runs[level]; i++) {
+			lsm_run_close(lsm->runs[level][i]);
+		}
+
+		lsm->num_runs[level] = 0;
+	}
+
+	return err;
+}
+
+/**
+@brief		Sets up an empty memtable.
+@details	The skip list is given enough levels to hold @p memtable_limit records
+			with a quarter of the nodes promoted at each level, like @ref sldict_create_dictionary.
+@param[in]	lsm
+				The LSM tree to set up the memtable of.
+@return		The status of the initialization.
+*/
+static ion_err_t
+lsm_memtable_initialize(
+	ion_lsm_t *lsm
+) {
+	int		height		= 1;
+	long	capacity	= 4;
+
+	while (capacity < lsm->memtable_limit) {
+		height++;
+		capacity *= 4;
+	}
+
+	lsm->memtable.super.compare = lsm->super.compare;
+	lsm->memtable_count			= 0;
+
+	return sl_initialize(&lsm->memtable, lsm->super.key_type, lsm->super.record.key_size, lsm->super.record.value_size + sizeof(ion_lsm_tag_t), height, 1, 4);
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Hands the memtable to the compaction worker and starts an empty one.
+@details	Waits for the worker to write out the memtable frozen before, if it
+			has not done so yet.
+@param[in]	lsm
+				The LSM tree whose memtable to freeze.
+@return		The status of the hand-over. If the worker failed to write out the
+			memtable frozen before, its error is returned and the memtable is kept.
+*/
+static ion_err_t
+lsm_freeze_memtable(
+	ion_lsm_t *lsm
+) {
+	ION_MUTEX_LOCK(lsm->worker_lock);
+
+	while (lsm->has_frozen && (err_ok == lsm->worker_error)) {
+		ION_COND_WAIT(lsm->worker_signal, lsm->worker_lock);
+	}
+
+	if (lsm->has_frozen) {
+		/* Report the failure, and have the worker try again in the meantime. */
+		ion_err_t err = lsm->worker_error;
+
+		lsm->worker_error	= err_ok;
+		lsm->work_requested = boolean_true;
+		ION_COND_BROADCAST(lsm->worker_signal);
+		ION_MUTEX_UNLOCK(lsm->worker_lock);
+		return err;
+	}
+
+	ion_skiplist_t			full		= lsm->memtable;
+	ion_dictionary_size_t	full_count	= lsm->memtable_count;
+	ion_err_t				err			= lsm_memtable_initialize(lsm);
+
+	if (err_ok != err) {
+		lsm->memtable		= full;
+		lsm->memtable_count = full_count;
+		ION_MUTEX_UNLOCK(lsm->worker_lock);
+		return err;
+	}
+
+	ION_RWLOCK_WRITE(lsm->version_lock);
+	lsm->frozen		= full;
+	lsm->has_frozen = boolean_true;
+	ION_RWLOCK_UNLOCK(lsm->version_lock);
+
+	lsm->work_requested = boolean_true;
+	ION_COND_BROADCAST(lsm->worker_signal);
+	ION_MUTEX_UNLOCK(lsm->worker_lock);
+
+	return err_ok;
+}
+
+#endif /* Clause ION_THREAD_SAFE */
+
+/**
+@brief		Writes a tagged record into the memtable, flushing it if it is full.
+@details	In thread-safe builds a full memtable is only handed to the compaction
+			worker, which writes it out while writes go on.
+@param[in]	lsm
+				The LSM tree to write to.
+@param[in]	key
+				The key to write.
+@param[in]	tag
+				Whether the record holds a value or is a tombstone.
+@param[in]	value
+				The value to write, or @p NULL for a tombstone.
+@return		The status of the write.
+*/
+static ion_err_t
+lsm_memtable_put(
+	ion_lsm_t		*lsm,
+	ion_key_t		key,
+	ion_lsm_tag_t	tag,
+	ion_value_t		value
+) {
+	ion_value_size_t value_size = lsm->super.record.value_size;
+
+	lsm->scratch[0] = tag;
+
+	if (NULL != value) {
+		memcpy(lsm->scratch + sizeof(ion_lsm_tag_t), value, value_size);
+	}
+	else {
+		memset(lsm->scratch + sizeof(ion_lsm_tag_t), 0, value_size);
+	}
+
+	ion_sl_node_t *node = sl_find_node(&lsm->memtable, key);
+
+	if ((NULL != node->key) && (0 == lsm->super.compare(node->key, key, lsm->super.record.key_size))) {
+		/* Newer writes simply replace older ones while they are still in memory. */
+		memcpy(node->value, lsm->scratch, value_size + sizeof(ion_lsm_tag_t));
+		return err_ok;
+	}
+
+	ion_err_t err = sl_insert(&lsm->memtable, key, lsm->scratch).error;
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	lsm->memtable_count++;
+
+	if (lsm->memtable_count >= lsm->memtable_limit) {
+#if ION_THREAD_SAFE
+		return lsm_freeze_memtable(lsm);
+#else
+		return lsm_flush(lsm);
+#endif
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Looks a key up in a memtable.
+@param[in]	lsm
+				The LSM tree the memtable belongs to.
+@param[in]	memtable
+				The memtable to look in.
+@param[in]	key
+				The key to look for.
+@param[out]	tagged
+				Room for one tagged value, written if the key is found.
+@return		@c boolean_true if the memtable holds the key.
+*/
+static ion_boolean_t
+lsm_memtable_lookup(
+	ion_lsm_t		*lsm,
+	ion_skiplist_t	*memtable,
+	ion_key_t		key,
+	ion_byte_t		*tagged
+) {
+	ion_sl_node_t *node = sl_find_node(memtable, key);
+
+	if ((NULL == node->key) || (0 != lsm->super.compare(node->key, key, lsm->super.record.key_size))) {
+		return boolean_false;
+	}
+
+	memcpy(tagged, node->value, lsm->super.record.value_size + sizeof(ion_lsm_tag_t));
+	return boolean_true;
+}
+
+/**
+@brief		Finds the newest tagged record for a key, which may be a tombstone.
+@param[in]	lsm
+				The LSM tree to look in.
+@param[in]	key
+				The key to look for.
+@param[out]	tagged
+				Room for one tagged value, written on success. This is kept
+				apart from the scratch memory of @p lsm so that lookups can
+				run alongside each other.
+@return		The status of the lookup.
+*/
+static ion_status_t
+lsm_lookup(
+	ion_lsm_t	*lsm,
+	ion_key_t	key,
+	ion_byte_t	*tagged
+) {
+	if (lsm_memtable_lookup(lsm, &lsm->memtable, key, tagged)) {
+		return ION_STATUS_OK(1);
+	}
+
+	ion_status_t	status = ION_STATUS_ERROR(err_item_not_found);
+	int				level;
+	int				i;
+
+	/* Keeps the compaction worker from replacing the frozen memtable or the runs underneath the lookup. */
+	ION_RWLOCK_READ(lsm->version_lock);
+
+#if ION_THREAD_SAFE
+
+	if (lsm->has_frozen && lsm_memtable_lookup(lsm, &lsm->frozen, key, tagged)) {
+		status = ION_STATUS_OK(1);
+	}
+
+#endif
+
+	for (level = 0; (err_item_not_found == status.error) && (level < ION_LSM_MAX_LEVELS); level++) {
+		for (i = lsm->num_runs[level] - 1; (err_item_not_found == status.error) && (i >= 0); i--) {
+			status = flat_file_get(&lsm->runs[level][i]->flat_file, key, tagged);
+		}
+	}
+
+	ION_RWLOCK_UNLOCK(lsm->version_lock);
+
+	return status;
+}
+
+/**
+@brief		Counts the rows held by the runs of a level.
+@param[in]	lsm
+				The LSM tree to look in.
+@param[in]	level
+				The level to count.
+@return		How many rows the level holds.
+*/
+static ion_fpos_t
+lsm_level_num_rows(
+	ion_lsm_t	*lsm,
+	int			level
+) {
+	ion_fpos_t	num_rows = 0;
+	int			i;
+
+	for (i = 0; i < lsm->num_runs[level]; i++) {
+		num_rows += lsm_run_num_rows(lsm->runs[level][i]);
+	}
+
+	return num_rows;
+}
+
+/**
+@brief		Checks whether a level has to be merged down under the compaction policy.
+@param[in]	lsm
+				The LSM tree to check.
+@param[in]	level
+				The level to check.
+@return		@c boolean_true if the level has to be merged.
+*/
+static ion_boolean_t
+lsm_level_needs_compaction(
+	ion_lsm_t	*lsm,
+	int			level
+) {
+	if (0 == lsm->num_runs[level]) {
+		return boolean_false;
+	}
+
+	if ((ion_lsm_compaction_tiered == lsm->compaction) || (0 == level)) {
+		return lsm->num_runs[level] >= ION_LSM_RUNS_PER_LEVEL;
+	}
+
+	if (lsm->num_runs[level] > 1) {
+		return boolean_true;
+	}
+
+	if (ION_LSM_MAX_LEVELS - 1 == level) {
+		return boolean_false;
+	}
+
+	ion_fpos_t	level_capacity = lsm->memtable_limit;
+	int			i;
+
+	for (i = 0; i < level; i++) {
+		level_capacity *= ION_LSM_RUNS_PER_LEVEL;
+	}
+
+	return lsm_level_num_rows(lsm, level) > level_capacity;
+}
+
+/**
+@brief		Moves one of the inputs of a merge on to its next row.
+@param[in]	run
+				The input to advance.
+@param[in,out]	location
+				The row the input is on.
+@param[out]	row
+				Where to point at the next row.
+@param[out]	live
+				Set to whether the input still has a row.
+@return		The status of the read. Running out of rows is not an error.
+*/
+static ion_err_t
+lsm_merge_advance(
+	ion_lsm_run_t		*run,
+	ion_fpos_t			*location,
+	ion_flat_file_row_t *row,
+	ion_boolean_t		*live
+) {
+	ion_err_t err = lsm_run_read(run, &run->flat_file.reader, ++(*location), row);
+
+	*live = err_ok == err;
+
+	return err_file_hit_eof == err ? err_ok : err;
+}
+
+/**
+@brief		Merges the runs of a level into one run in the next level.
+@details	The last level is merged into itself. Under leveled compaction the run
+			already in the next level takes part in the merge. The newest version of
+			each key wins, and tombstones are dropped once nothing older remains for
+			them to shadow.
+@param[in]	lsm
+				The LSM tree to compact.
+@param[in]	level
+				The level to merge.
+@return		The status of the merge. On failure the runs are left as they were.
+*/
+static ion_err_t
+lsm_compact_level(
+	ion_lsm_t	*lsm,
+	int			level
+) {
+	ion_lsm_run_t		*inputs[2 * ION_LSM_RUNS_PER_LEVEL];
+	ion_flat_file_row_t rows[2 * ION_LSM_RUNS_PER_LEVEL];
+	ion_fpos_t			locations[2 * ION_LSM_RUNS_PER_LEVEL];
+	ion_boolean_t		live[2 * ION_LSM_RUNS_PER_LEVEL];
+	int					num_inputs	= 0;
+	int					target		= level + 1 < ION_LSM_MAX_LEVELS ? level + 1 : level;
+	ion_boolean_t		merge_target = (ion_lsm_compaction_leveled == lsm->compaction) && (target != level);
+	ion_key_size_t		key_size	= lsm->super.record.key_size;
+	ion_lsm_run_t		*output		= NULL;
+	ion_err_t			err;
+	int					i;
+
+	/* Inputs are ordered from newest to oldest, so that ties go to the newest version. */
+	for (i = lsm->num_runs[level] - 1; i >= 0; i--) {
+		inputs[num_inputs++] = lsm->runs[level][i];
+	}
+
+	if (merge_target) {
+		for (i = lsm->num_runs[target] - 1; i >= 0; i--) {
+			inputs[num_inputs++] = lsm->runs[target][i];
+		}
+	}
+
+	ion_boolean_t drop_tombstones = lsm_levels_empty_from(lsm, target + 1) && (merge_target || (target == level) || (0 == lsm->num_runs[target]));
+
+	err = lsm_run_create(lsm, &output);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	for (i = 0; i < num_inputs; i++) {
+		locations[i]	= -1;
+		err				= lsm_merge_advance(inputs[i], &locations[i], &rows[i], &live[i]);
+
+		if (err_ok != err) {
+			goto CLEANUP;
+		}
+	}
+
+	while (boolean_true) {
+		int winner = -1;
+
+		for (i = 0; i < num_inputs; i++) {
+			if (live[i] && ((-1 == winner) || (lsm->super.compare(rows[i].key, rows[winner].key, key_size) < 0))) {
+				winner = i;
+			}
+		}
+
+		if (-1 == winner) {
+			break;
+		}
+
+		if (!drop_tombstones || (ION_LSM_TAG_TOMBSTONE != *((ion_lsm_tag_t *) rows[winner].value))) {
+			err = flat_file_insert(&output->flat_file, rows[winner].key, rows[winner].value).error;
+
+			if (err_ok != err) {
+				goto CLEANUP;
+			}
+		}
+
+		/* Step past every older version of the key, then past the winner itself. Each input
+		   reads into its own buffer, so the winner's row stays intact until it is advanced. */
+		for (i = 0; i < num_inputs; i++) {
+			if ((i != winner) && live[i] && (0 == lsm->super.compare(rows[i].key, rows[winner].key, key_size))) {
+				err = lsm_merge_advance(inputs[i], &locations[i], &rows[i], &live[i]);
+
+				if (err_ok != err) {
+					goto CLEANUP;
+				}
+			}
+		}
+
+		err = lsm_merge_advance(inputs[winner], &locations[winner], &rows[winner], &live[winner]);
+
+		if (err_ok != err) {
+			goto CLEANUP;
+		}
+	}
+
+	err = lsm_run_finish(output);
+
+	if (err_ok != err) {
+		goto CLEANUP;
+	}
+
+	/* Lookups and cursors move from the inputs to the output in one step. */
+	ION_RWLOCK_WRITE(lsm->version_lock);
+	lsm->num_runs[level] = 0;
+
+	if (merge_target) {
+		lsm->num_runs[target] = 0;
+	}
+
+	if (0 == lsm_run_num_rows(output)) {
+		/* Everything merged was deleted. */
+		lsm_run_discard(output);
+	}
+	else {
+		lsm->runs[target][lsm->num_runs[target]++] = output;
+	}
+
+	ION_RWLOCK_UNLOCK(lsm->version_lock);
+
+	output	= NULL;
+	err		= lsm_write_manifest(lsm, boolean_false);
+
+	/* The inputs are no longer listed, so they can go whether or not the manifest made it out. */
+	for (i = 0; i < num_inputs; i++) {
+		ion_err_t discard_err = lsm_run_discard(inputs[i]);
+
+		if (err_ok == err) {
+			err = discard_err;
+		}
+	}
+
+	return err;
+
+CLEANUP:
+
+	if (NULL != output) {
+		lsm_run_discard(output);
+	}
+
+	return err;
+}
+
+/**
+@brief		Merges levels down until none of them is full.
+@param[in]	lsm
+				The LSM tree to compact.
+@return		The status of the merges.
+*/
+static ion_err_t
+lsm_compact(
+	ion_lsm_t *lsm
+) {
+	int level;
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		if (lsm_level_needs_compaction(lsm, level)) {
+			ion_err_t err = lsm_compact_level(lsm, level);
+
+			if (err_ok != err) {
+				return err;
+			}
+		}
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Writes a memtable out as a new run.
+@param[in]	lsm
+				The LSM tree the memtable belongs to.
+@param[in]	memtable
+				The memtable to write out. It is left as it is.
+@param[out]	run
+				Set to the new run, which is not listed in any level yet, or to
+				@p NULL if nothing in the memtable had to be written.
+@return		The status of the write.
+*/
+static ion_err_t
+lsm_write_run(
+	ion_lsm_t		*lsm,
+	ion_skiplist_t	*memtable,
+	ion_lsm_run_t	**run
+) {
+	/* With nothing on disk, there is nothing for a tombstone to shadow. */
+	ion_boolean_t	drop_tombstones = lsm_levels_empty_from(lsm, 0);
+	ion_err_t		err				= lsm_run_create(lsm, run);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	ion_sl_node_t *node;
+
+	for (node = memtable->head->next[0]; NULL != node; node = node->next[0]) {
+		if (drop_tombstones && (ION_LSM_TAG_TOMBSTONE == *((ion_lsm_tag_t *) node->value))) {
+			continue;
+		}
+
+		err = flat_file_insert(&(*run)->flat_file, node->key, node->value).error;
+
+		if (err_ok != err) {
+			goto CLEANUP;
+		}
+	}
+
+	err = lsm_run_finish(*run);
+
+	if (err_ok != err) {
+		goto CLEANUP;
+	}
+
+	if (0 == lsm_run_num_rows(*run)) {
+		lsm_run_discard(*run);
+		*run = NULL;
+	}
+
+	return err_ok;
+
+CLEANUP:
+	lsm_run_discard(*run);
+	*run = NULL;
+	return err;
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Writes out the frozen memtable as the newest run of the first level.
+@param[in]	lsm
+				The LSM tree the memtable belongs to.
+@param[in]	frozen
+				A copy of the frozen memtable, destroyed once its run is in place.
+@return		The status of the write. On failure the memtable stays frozen.
+*/
+static ion_err_t
+lsm_write_frozen(
+	ion_lsm_t		*lsm,
+	ion_skiplist_t	*frozen
+) {
+	ion_lsm_run_t	*run;
+	ion_err_t		err = lsm_write_run(lsm, frozen, &run);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	/* Lookups and cursors move from the frozen memtable to its run in one step. */
+	ION_MUTEX_LOCK(lsm->worker_lock);
+	ION_RWLOCK_WRITE(lsm->version_lock);
+
+	if (NULL != run) {
+		lsm->runs[0][lsm->num_runs[0]++] = run;
+	}
+
+	lsm->has_frozen = boolean_false;
+	ION_RWLOCK_UNLOCK(lsm->version_lock);
+	ION_COND_BROADCAST(lsm->worker_signal);
+	ION_MUTEX_UNLOCK(lsm->worker_lock);
+
+	sl_destroy(frozen);
+
+	return lsm_write_manifest(lsm, boolean_false);
+}
+
+/**
+@brief		Writes out frozen memtables and merges full levels, until the worker is stopped.
+@param[in]	argument
+				The LSM tree.
+*/
+static void *
+lsm_worker_run(
+	void *argument
+) {
+	ion_lsm_t *lsm = argument;
+
+	ION_MUTEX_LOCK(lsm->worker_lock);
+
+	while (boolean_true) {
+		while (!lsm->work_requested && !lsm->stopping) {
+			ION_COND_WAIT(lsm->worker_signal, lsm->worker_lock);
+		}
+
+		if (lsm->stopping) {
+			break;
+		}
+
+		ion_boolean_t	has_frozen	= lsm->has_frozen;
+		ion_skiplist_t	frozen		= lsm->frozen;
+
+		lsm->work_requested = boolean_false;
+		lsm->busy			= boolean_true;
+		ION_MUTEX_UNLOCK(lsm->worker_lock);
+
+		ion_err_t err = err_ok;
+
+		if (has_frozen) {
+			err = lsm_write_frozen(lsm, &frozen);
+		}
+
+		if (err_ok == err) {
+			err = lsm_compact(lsm);
+		}
+
+		ION_MUTEX_LOCK(lsm->worker_lock);
+
+		if (err_ok != err) {
+			lsm->worker_error = err;
+		}
+
+		lsm->busy = boolean_false;
+		ION_COND_BROADCAST(lsm->worker_signal);
+	}
+
+	ION_MUTEX_UNLOCK(lsm->worker_lock);
+
+	return NULL;
+}
+
+/**
+@brief		Starts the compaction worker of an LSM tree.
+@param[in]	lsm
+				The LSM tree to start the worker of.
+@return		The status of starting the worker.
+*/
+static ion_err_t
+lsm_start_worker(
+	ion_lsm_t *lsm
+) {
+	lsm->has_frozen		= boolean_false;
+	lsm->work_requested = boolean_false;
+	lsm->busy			= boolean_false;
+	lsm->stopping		= boolean_false;
+	lsm->worker_error	= err_ok;
+
+	ION_RWLOCK_INIT(lsm->version_lock);
+	ION_MUTEX_INIT(lsm->worker_lock);
+	ION_COND_INIT(lsm->worker_signal);
+
+	if (0 != pthread_create(&lsm->worker, NULL, lsm_worker_run, lsm)) {
+		ION_COND_DESTROY(lsm->worker_signal);
+		ION_MUTEX_DESTROY(lsm->worker_lock);
+		ION_RWLOCK_DESTROY(lsm->version_lock);
+		return err_out_of_memory;
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Stops the compaction worker of an LSM tree and waits for it to exit.
+@details	Work the worker has not started on is dropped. A memtable that is
+			still frozen is released, as writing it out has already failed or
+			is not wanted.
+@param[in]	lsm
+				The LSM tree to stop the worker of.
+*/
+static void
+lsm_stop_worker(
+	ion_lsm_t *lsm
+) {
+	ION_MUTEX_LOCK(lsm->worker_lock);
+	lsm->stopping = boolean_true;
+	ION_COND_BROADCAST(lsm->worker_signal);
+	ION_MUTEX_UNLOCK(lsm->worker_lock);
+
+	pthread_join(lsm->worker, NULL);
+
+	if (lsm->has_frozen) {
+		sl_destroy(&lsm->frozen);
+		lsm->has_frozen = boolean_false;
+	}
+
+	ION_COND_DESTROY(lsm->worker_signal);
+	ION_MUTEX_DESTROY(lsm->worker_lock);
+	ION_RWLOCK_DESTROY(lsm->version_lock);
+}
+
+#else /* Clause ION_THREAD_SAFE */
+
+#define lsm_start_worker(lsm)	(err_ok)
+#define lsm_stop_worker(lsm)
+
+#endif /* Clause ION_THREAD_SAFE */
+
+ion_err_t
+lsm_initialize(
+	ion_lsm_t				*lsm,
+	ion_dictionary_id_t		id,
+	ion_key_type_t			key_type,
+	ion_key_size_t			key_size,
+	ion_value_size_t		value_size,
+	ion_dictionary_size_t	dictionary_size
+) {
+	if (dictionary_size <= 0) {
+		/* The memtable has to hold at least one record before it is written out. */
+		dictionary_size = 1;
+	}
+
+	lsm->super.id					= id;
+	lsm->super.key_type				= key_type;
+	lsm->super.record.key_size		= key_size;
+	lsm->super.record.value_size	= value_size;
+	lsm->memtable_limit				= dictionary_size;
+	lsm->compaction					= ION_LSM_DEFAULT_COMPACTION;
+
+	int level;
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		lsm->num_runs[level] = 0;
+	}
+
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	if (dictionary_get_filename(lsm_run_id(id, ION_LSM_RUN_SLOTS - 1), "ffs", filename) >= ION_MAX_FILENAME_LENGTH) {
+		/* The ID is too large for the run file names to fit. */
+		return err_uninitialized;
+	}
+
+	lsm->scratch = malloc(value_size + sizeof(ion_lsm_tag_t));
+
+	if (NULL == lsm->scratch) {
+		return err_out_of_memory;
+	}
+
+	ion_err_t err = lsm_memtable_initialize(lsm);
+
+	if (err_ok != err) {
+		free(lsm->scratch);
+		return err;
+	}
+
+	err = lsm_start_worker(lsm);
+
+	if (err_ok != err) {
+		sl_destroy(&lsm->memtable);
+		free(lsm->scratch);
+		return err;
+	}
+
+	err = lsm_read_manifest(lsm);
+
+	if (err_ok != err) {
+		lsm_stop_worker(lsm);
+		sl_destroy(&lsm->memtable);
+		free(lsm->scratch);
+		return err;
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+lsm_close(
+	ion_lsm_t *lsm
+) {
+	ion_err_t err = lsm_flush(lsm);
+
+	lsm_stop_worker(lsm);
+
+	if (err_ok == err) {
+		err = lsm_write_manifest(lsm, boolean_false);
+	}
+
+	int level;
+	int i;
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		for (i = 0; i < lsm->num_runs[level]; i++) {
+			ion_err_t close_err = lsm_run_close(lsm->runs[level][i]);
+
+			if (err_ok == err) {
+				err = close_err;
+			}
+		}
+
+		lsm->num_runs[level] = 0;
+	}
+
+	sl_destroy(&lsm->memtable);
+	free(lsm->scratch);
+	lsm->scratch = NULL;
+
+	return err;
+}
+
+ion_err_t
+lsm_destroy(
+	ion_lsm_t *lsm
+) {
+	int level;
+	int i;
+
+	lsm_stop_worker(lsm);
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		for (i = 0; i < lsm->num_runs[level]; i++) {
+			lsm_run_close(lsm->runs[level][i]);
+		}
+
+		lsm->num_runs[level] = 0;
+	}
+
+	sl_destroy(&lsm->memtable);
+	free(lsm->scratch);
+	lsm->scratch = NULL;
+
+	return lsm_remove_files(lsm->super.id);
+}
+
+ion_err_t
+lsm_remove_files(
+	ion_dictionary_id_t id
+) {
+	int slot;
+
+	for (slot = 0; slot < ION_LSM_RUN_SLOTS; slot++) {
+		lsm_run_remove_files(lsm_run_id(id, slot));
+	}
+
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(id, ION_LSM_MANIFEST_TEMP_EXTENSION, filename);
+
+	if (ion_fexists(filename)) {
+		ion_fremove(filename);
+	}
+
+	dictionary_get_filename(id, ION_LSM_MANIFEST_EXTENSION, filename);
+
+	if (ion_fexists(filename) && (err_ok != ion_fremove(filename))) {
+		return err_file_delete_error;
+	}
+
+	return err_ok;
+}
+
+ion_status_t
+lsm_insert(
+	ion_lsm_t	*lsm,
+	ion_key_t	key,
+	ion_value_t value
+) {
+	ion_err_t err = lsm_memtable_put(lsm, key, ION_LSM_TAG_VALUE, value);
+
+	if (err_ok != err) {
+		return ION_STATUS_ERROR(err);
+	}
+
+	return ION_STATUS_OK(1);
+}
+
+ion_status_t
+lsm_get(
+	ion_lsm_t	*lsm,
+	ion_key_t	key,
+	ion_value_t value
+) {
+	ion_byte_t		*tagged = alloca(lsm->super.record.value_size + sizeof(ion_lsm_tag_t));
+	ion_status_t	status	= lsm_lookup(lsm, key, tagged);
+
+	if (err_ok != status.error) {
+		return status;
+	}
+
+	if (ION_LSM_TAG_TOMBSTONE == tagged[0]) {
+		return ION_STATUS_ERROR(err_item_not_found);
+	}
+
+	memcpy(value, tagged + sizeof(ion_lsm_tag_t), lsm->super.record.value_size);
+
+	return ION_STATUS_OK(1);
+}
+
+ion_status_t
+lsm_delete(
+	ion_lsm_t	*lsm,
+	ion_key_t	key
+) {
+	ion_byte_t		*tagged = alloca(lsm->super.record.value_size + sizeof(ion_lsm_tag_t));
+	ion_status_t	status	= lsm_lookup(lsm, key, tagged);
+
+	if (err_ok != status.error) {
+		return status;
+	}
+
+	if (ION_LSM_TAG_TOMBSTONE == tagged[0]) {
+		return ION_STATUS_ERROR(err_item_not_found);
+	}
+
+	ion_err_t err = lsm_memtable_put(lsm, key, ION_LSM_TAG_TOMBSTONE, NULL);
+
+	if (err_ok != err) {
+		return ION_STATUS_ERROR(err);
+	}
+
+	return ION_STATUS_OK(1);
+}
+
+ion_err_t
+lsm_flush(
+	ion_lsm_t *lsm
+) {
+#if ION_THREAD_SAFE
+
+	if (0 != lsm->memtable_count) {
+		ion_err_t err = lsm_freeze_memtable(lsm);
+
+		if (err_ok != err) {
+			return err;
+		}
+	}
+
+	return lsm_wait_compaction(lsm);
+#else
+
+	if (0 == lsm->memtable_count) {
+		return err_ok;
+	}
+
+	ion_lsm_run_t	*run;
+	ion_err_t		err = lsm_write_run(lsm, &lsm->memtable, &run);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	if (NULL != run) {
+		lsm->runs[0][lsm->num_runs[0]++] = run;
+	}
+
+	sl_destroy(&lsm->memtable);
+	err = lsm_memtable_initialize(lsm);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	err = lsm_write_manifest(lsm, boolean_false);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	return lsm_compact(lsm);
+#endif
+}
+
+ion_err_t
+lsm_wait_compaction(
+	ion_lsm_t *lsm
+) {
+#if ION_THREAD_SAFE
+	ION_MUTEX_LOCK(lsm->worker_lock);
+
+	if (lsm->has_frozen && !lsm->busy) {
+		/* Writing out the frozen memtable failed before, so try again. */
+		lsm->work_requested = boolean_true;
+		ION_COND_BROADCAST(lsm->worker_signal);
+	}
+
+	while (lsm->work_requested || lsm->busy) {
+		ION_COND_WAIT(lsm->worker_signal, lsm->worker_lock);
+	}
+
+	ion_err_t err = lsm->worker_error;
+
+	lsm->worker_error = err_ok;
+	ION_MUTEX_UNLOCK(lsm->worker_lock);
+
+	return err;
+#else
+	UNUSED(lsm);
+	return err_ok;
+#endif
+}
+
+ion_err_t
+lsm_sync(
+	ion_lsm_t *lsm
+) {
+	ion_err_t err = lsm_flush(lsm);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	int level;
+	int i;
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		for (i = 0; i < lsm->num_runs[level]; i++) {
+			err = flat_file_sync(&lsm->runs[level][i]->flat_file);
+
+			if (err_ok != err) {
+				return err;
+			}
+		}
+	}
+
+	return lsm_write_manifest(lsm, boolean_true);
+}
+
+ion_fpos_t
+lsm_run_num_rows(
+	ion_lsm_run_t *run
+) {
+	return (run->flat_file.eof_position - run->flat_file.start_of_data) / run->flat_file.row_size;
+}
+
+ion_err_t
+lsm_run_read(
+	ion_lsm_run_t			*run,
+	ion_flat_file_reader_t	*reader,
+	ion_fpos_t				location,
+	ion_flat_file_row_t		*row
+) {
+	ion_flat_file_t *flat_file = &run->flat_file;
+
+	if (location >= lsm_run_num_rows(run)) {
+		return err_file_hit_eof;
+	}
+
+	if ((-1 != reader->current_loaded_region) && (location >= reader->current_loaded_region) && ((size_t) (location - reader->current_loaded_region) < reader->num_in_buffer)) {
+		return flat_file_read_row(flat_file, reader, location, row);
+	}
+
+	/* Every row of a run is occupied, so this loads the block starting at the row and stops on it. */
+	ion_fpos_t found_location;
+
+	return flat_file_scan(flat_file, reader, location, &found_location, row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_not_empty);
+}
+
+ion_err_t
+lsm_run_seek(
+	ion_lsm_run_t			*run,
+	ion_flat_file_reader_t	*reader,
+	ion_key_t				key,
+	ion_fpos_t				*location
+) {
+	ion_err_t err = flat_file_binary_search(&run->flat_file, reader, key, location);
+
+	if (err_item_not_found == err) {
+		/* Every key in the run is larger. */
+		*location = 0;
+		return err_ok;
+	}
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	ion_flat_file_row_t row;
+
+	err = flat_file_read_row(&run->flat_file, reader, *location, &row);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	if (run->flat_file.super.compare(row.key, key, run->flat_file.super.record.key_size) < 0) {
+		(*location)++;
+	}
+
+	return err_ok;
+}
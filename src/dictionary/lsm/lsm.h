@@ -0,0 +1,268 @@
+/******************************************************************************/
+/**
+@file		lsm.h
+@author		IonDB Project
+@brief		Log-structured merge tree built from the skip list and sorted flat files.
+@details	Keys are unique. Inserts and updates are blind writes into the
+			memtable, so inserting a key that already exists replaces its
+			value. A delete looks the key up first, so that it can report
+			whether anything was deleted, and then writes a tombstone.
+
+			In thread-safe builds the write that fills the memtable only
+			freezes it and hands it to a compaction worker, which writes it
+			out as a run and merges any full levels while lookups, cursors
+			and further writes go on. A write waits only if the memtable
+			frozen before has not been written out yet. Other builds fall
+			back to writing out the memtable and running the merges as part
+			of the write that fills it. Writing to an LSM tree invalidates
+			its open cursors.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(LSM_H_)
+#define LSM_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "lsm_types.h"
+#include "../skip_list/skip_list.h"
+#include "../flat_file/flat_file.h"
+
+/**
+@brief		Initializes an LSM tree, reopening the runs listed in its manifest if there is one.
+@details	The comparison function in @p lsm must be set before this is called.
+@param[in]	lsm
+				The LSM tree to initialize.
+@param[in]	id
+				The ID of the LSM tree, which names its manifest and its runs.
+@param[in]	key_type
+				Key category to use for this instance.
+@param[in]	key_size
+				Key size, in bytes used for this instance.
+@param[in]	value_size
+				Value size, in bytes used for this instance.
+@param[in]	dictionary_size
+				How many records the memtable holds before it is written out as a run.
+@return		The status of initialization.
+*/
+ion_err_t
+lsm_initialize(
+	ion_lsm_t				*lsm,
+	ion_dictionary_id_t		id,
+	ion_key_type_t			key_type,
+	ion_key_size_t			key_size,
+	ion_value_size_t		value_size,
+	ion_dictionary_size_t	dictionary_size
+);
+
+/**
+@brief		Writes out the memtable and closes every run.
+@param[in]	lsm
+				The LSM tree to close.
+@return		The status of closing. Memory is released even on failure.
+*/
+ion_err_t
+lsm_close(
+	ion_lsm_t *lsm
+);
+
+/**
+@brief		Closes an LSM tree and removes all of its files.
+@param[in]	lsm
+				The LSM tree to destroy.
+@return		The status of destruction.
+*/
+ion_err_t
+lsm_destroy(
+	ion_lsm_t *lsm
+);
+
+/**
+@brief		Removes all of the files of a closed LSM tree.
+@param[in]	id
+				The ID of the LSM tree.
+@return		The status of the removal.
+*/
+ion_err_t
+lsm_remove_files(
+	ion_dictionary_id_t id
+);
+
+/**
+@brief		Inserts a record, replacing the value of the key if it already exists.
+@param[in]	lsm
+				The LSM tree to insert into.
+@param[in]	key
+				Key portion of the record to insert.
+@param[in]	value
+				Value portion of the record to insert.
+@return		Resulting status of insertion.
+*/
+ion_status_t
+lsm_insert(
+	ion_lsm_t	*lsm,
+	ion_key_t	key,
+	ion_value_t value
+);
+
+/**
+@brief		Fetches the newest value stored with the given @p key.
+@param[in]	lsm
+				The LSM tree to look in.
+@param[in]	key
+				Specified key to look for.
+@param[out]	value
+				Where to write the value. Left untouched if the key is not found.
+@return		Resulting status of the operation.
+*/
+ion_status_t
+lsm_get(
+	ion_lsm_t	*lsm,
+	ion_key_t	key,
+	ion_value_t value
+);
+
+/**
+@brief		Deletes the given @p key by writing a tombstone for it.
+@param[in]	lsm
+				The LSM tree to delete from.
+@param[in]	key
+				Specified key to delete.
+@return		Resulting status of the operation.
+*/
+ion_status_t
+lsm_delete(
+	ion_lsm_t	*lsm,
+	ion_key_t	key
+);
+
+/**
+@brief		Writes the memtable out as a new run, then merges any levels that are full.
+@details	Nothing is written if the memtable is empty. In thread-safe builds the
+			memtable is handed to the compaction worker, and this waits until the
+			worker has finished with it and with every merge it leads to.
+@param[in]	lsm
+				The LSM tree to flush.
+@return		Resulting status of the operation, including any error the compaction
+			worker ran into since the last flush.
+*/
+ion_err_t
+lsm_flush(
+	ion_lsm_t *lsm
+);
+
+/**
+@brief		Waits until the compaction worker has written out every frozen memtable
+			and finished merging, without flushing the memtable.
+@details	Returns at once in builds that are not thread-safe, where writes do
+			this work themselves.
+@param[in]	lsm
+				The LSM tree to wait for.
+@return		Any error the compaction worker ran into since it was last reported.
+*/
+ion_err_t
+lsm_wait_compaction(
+	ion_lsm_t *lsm
+);
+
+/**
+@brief		Flushes the memtable and forces every run and the manifest to the device.
+@param[in]	lsm
+				The LSM tree to sync.
+@return		Resulting status of the operation.
+*/
+ion_err_t
+lsm_sync(
+	ion_lsm_t *lsm
+);
+
+/**
+@brief		Counts the rows of a run.
+@param[in]	run
+				The run to count.
+@return		How many rows the run holds.
+*/
+ion_fpos_t
+lsm_run_num_rows(
+	ion_lsm_run_t *run
+);
+
+/**
+@brief		Reads a row of a run, loading the block it is in if needed.
+@details	The row points into the buffer of the reader, and is only good until
+			the next read through it.
+@param[in]	run
+				The run to read from.
+@param[in]	reader
+				Which reader of the run's flat file to read through.
+@param[in]	location
+				Which row to read.
+@param[out]	row
+				Where to point at the row.
+@return		Resulting status of the read, @ref err_file_hit_eof if @p location
+			is past the last row.
+*/
+ion_err_t
+lsm_run_read(
+	ion_lsm_run_t			*run,
+	ion_flat_file_reader_t	*reader,
+	ion_fpos_t				location,
+	ion_flat_file_row_t		*row
+);
+
+/**
+@brief		Finds the first row of a run whose key is at least @p key.
+@param[in]	run
+				The run to search.
+@param[in]	reader
+				Which reader of the run's flat file to read through.
+@param[in]	key
+				The key to search for.
+@param[out]	location
+				Where to write the row found. Set to the number of rows if every
+				key is smaller than @p key.
+@return		Resulting status of the search.
+*/
+ion_err_t
+lsm_run_seek(
+	ion_lsm_run_t			*run,
+	ion_flat_file_reader_t	*reader,
+	ion_key_t				key,
+	ion_fpos_t				*location
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* LSM_H_ */
@@ -0,0 +1,664 @@
+/******************************************************************************/
+/**
+@file		lsm_handler.c
+@author		IonDB Project
+@brief		Handler liaison between the dictionary API and the LSM tree implementation.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "lsm_handler.h"
+
+/**
+@brief		Copies the record a cursor source is on, or marks the source exhausted.
+@param[in]	lsm
+				The LSM tree being read.
+@param[in]	source
+				The source to load.
+@return		The status of the read.
+*/
+static ion_err_t
+lsmdict_source_load(
+	ion_lsm_t				*lsm,
+	ion_lsm_cursor_source_t *source
+) {
+	ion_key_size_t		key_size	= lsm->super.record.key_size;
+	ion_value_size_t	value_size	= lsm->super.record.value_size + sizeof(ion_lsm_tag_t);
+
+	if (NULL == source->run) {
+		source->exhausted = NULL == source->node;
+
+		if (!source->exhausted) {
+			memcpy(source->key, source->node->key, key_size);
+			memcpy(source->value, source->node->value, value_size);
+		}
+
+		return err_ok;
+	}
+
+	ion_flat_file_row_t row;
+	ion_err_t			err = lsm_run_read(source->run, source->reader, source->location, &row);
+
+	source->exhausted = err_ok != err;
+
+	if (err_ok == err) {
+		memcpy(source->key, row.key, key_size);
+		memcpy(source->value, row.value, value_size);
+	}
+
+	if (err_file_hit_eof == err) {
+		return err_ok;
+	}
+
+	return err;
+}
+
+/**
+@brief		Moves a cursor source on to its next record.
+@param[in]	lsm
+				The LSM tree being read.
+@param[in]	source
+				The source to advance.
+@return		The status of the read.
+*/
+static ion_err_t
+lsmdict_source_advance(
+	ion_lsm_t				*lsm,
+	ion_lsm_cursor_source_t *source
+) {
+	if (NULL == source->run) {
+		source->node = source->node->next[0];
+	}
+	else {
+		source->location++;
+	}
+
+	return lsmdict_source_load(lsm, source);
+}
+
+/**
+@brief		Positions a cursor source on the first record with a key of at least @p lower_bound.
+@param[in]	lsm
+				The LSM tree being read.
+@param[in]	source
+				The source to position.
+@param[in]	lower_bound
+				The smallest key wanted, or @p NULL to start from the first record.
+@return		The status of the search.
+*/
+static ion_err_t
+lsmdict_source_seek(
+	ion_lsm_t				*lsm,
+	ion_lsm_cursor_source_t *source,
+	ion_key_t				lower_bound
+) {
+	if (NULL == source->run) {
+		if (NULL == lower_bound) {
+			source->node = source->memtable->head->next[0];
+		}
+		else {
+			/* This finds either the key itself or the last node before it, possibly the head. */
+			source->node = sl_find_node(source->memtable, lower_bound);
+
+			if ((NULL == source->node->key) || (lsm->super.compare(source->node->key, lower_bound, lsm->super.record.key_size) < 0)) {
+				source->node = source->node->next[0];
+			}
+		}
+	}
+	else if (NULL == lower_bound) {
+		source->location = 0;
+	}
+	else {
+		ion_err_t err = lsm_run_seek(source->run, source->reader, lower_bound, &source->location);
+
+		if (err_ok != err) {
+			return err;
+		}
+	}
+
+	return lsmdict_source_load(lsm, source);
+}
+
+/**
+@brief		Skips the sources of a cursor past shadowed versions and tombstones, until
+			the smallest key among them is a live record.
+@param[in]	cursor
+				The cursor to settle.
+@param[out]	winner
+				Set to the source holding the next record, or -1 if there are no more
+				records that satisfy the predicate.
+@return		The status of the reads.
+*/
+static ion_err_t
+lsmdict_cursor_settle(
+	ion_lsm_cursor_t	*cursor,
+	int					*winner
+) {
+	ion_lsm_t		*lsm		= (ion_lsm_t *) cursor->super.dictionary->instance;
+	ion_key_size_t	key_size	= lsm->super.record.key_size;
+	ion_err_t		err;
+	int				i;
+
+	while (boolean_true) {
+		*winner = -1;
+
+		/* Sources are ordered from newest to oldest, so the first source wins a tie. */
+		for (i = 0; i < cursor->num_sources; i++) {
+			if (!cursor->sources[i].exhausted && ((-1 == *winner) || (lsm->super.compare(cursor->sources[i].key, cursor->sources[*winner].key, key_size) < 0))) {
+				*winner = i;
+			}
+		}
+
+		if (-1 == *winner) {
+			return err_ok;
+		}
+
+		if (!test_predicate(&cursor->super, cursor->sources[*winner].key)) {
+			/* Keys only grow from here, so nothing further can satisfy the predicate. */
+			*winner = -1;
+			return err_ok;
+		}
+
+		if (ION_LSM_TAG_TOMBSTONE != cursor->sources[*winner].value[0]) {
+			return err_ok;
+		}
+
+		/* The key was deleted, so step every source past it. The winner goes last, since
+		   the others are compared against its key. */
+		for (i = 0; i < cursor->num_sources; i++) {
+			if ((i != *winner) && !cursor->sources[i].exhausted && (0 == lsm->super.compare(cursor->sources[i].key, cursor->sources[*winner].key, key_size))) {
+				if (err_ok != (err = lsmdict_source_advance(lsm, &cursor->sources[i]))) {
+					return err;
+				}
+			}
+		}
+
+		if (err_ok != (err = lsmdict_source_advance(lsm, &cursor->sources[*winner]))) {
+			return err;
+		}
+	}
+}
+
+/**
+@brief			Fetches the next record to be returned from a cursor that has already been initialized.
+@details		This function should not be called directly, but instead will be bound to the cursor like a method.
+@param[in]		cursor
+					Which cursor to fetch results from.
+@param[out]		record
+					An initialized record struct with the @p key and @p value appropriately allocated to fit
+					the returned key and value. This function will write back data to the struct.
+@return			The resulting status of the operation.
+*/
+ion_cursor_status_t
+lsmdict_next(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*record
+) {
+	ion_lsm_cursor_t	*lsm_cursor = (ion_lsm_cursor_t *) cursor;
+	ion_lsm_t			*lsm		= (ion_lsm_t *) cursor->dictionary->instance;
+	ion_key_size_t		key_size	= lsm->super.record.key_size;
+	int					winner;
+	int					i;
+
+	if ((cursor->status != cs_cursor_initialized) && (cursor->status != cs_cursor_active)) {
+		return cursor->status;
+	}
+
+	if (err_ok != lsmdict_cursor_settle(lsm_cursor, &winner)) {
+		cursor->status = cs_possible_data_inconsistency;
+		return cursor->status;
+	}
+
+	if (-1 == winner) {
+		cursor->status = cs_end_of_results;
+		return cursor->status;
+	}
+
+	ion_lsm_cursor_source_t *source = &lsm_cursor->sources[winner];
+
+	memcpy(record->key, source->key, key_size);
+	memcpy(record->value, source->value + sizeof(ion_lsm_tag_t), lsm->super.record.value_size);
+
+	for (i = 0; i < lsm_cursor->num_sources; i++) {
+		if ((i != winner) && !lsm_cursor->sources[i].exhausted && (0 == lsm->super.compare(lsm_cursor->sources[i].key, source->key, key_size))) {
+			if (err_ok != lsmdict_source_advance(lsm, &lsm_cursor->sources[i])) {
+				cursor->status = cs_possible_data_inconsistency;
+				return cursor->status;
+			}
+		}
+	}
+
+	if (err_ok != lsmdict_source_advance(lsm, source)) {
+		cursor->status = cs_possible_data_inconsistency;
+		return cursor->status;
+	}
+
+	cursor->status = cs_cursor_active;
+	return cursor->status;
+}
+
+/**
+@brief		Destroys the cursor, along with its copy of the predicate.
+@param[in]	cursor
+				Which cursor to destroy.
+*/
+void
+lsmdict_destroy_cursor(
+	ion_dict_cursor_t **cursor
+) {
+#if ION_THREAD_SAFE
+	ion_lsm_cursor_t	*lsm_cursor = (ion_lsm_cursor_t *) *cursor;
+	int					i;
+
+	for (i = 0; i < lsm_cursor->num_sources; i++) {
+		if (NULL != lsm_cursor->sources[i].run) {
+			flat_file_close_reader(&lsm_cursor->sources[i].own_reader);
+		}
+	}
+
+#endif
+	(*cursor)->predicate->destroy(&(*cursor)->predicate);
+	free(*cursor);
+	*cursor = NULL;
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Destroys a cursor, then lets the compaction worker replace the runs it read.
+@param[in]	cursor
+				Which cursor to destroy.
+*/
+static void
+lsmdict_destroy_versioned_cursor(
+	ion_dict_cursor_t **cursor
+) {
+	ion_lsm_t *lsm = (ion_lsm_t *) (*cursor)->dictionary->instance;
+
+	lsmdict_destroy_cursor(cursor);
+	ION_RWLOCK_UNLOCK(lsm->version_lock);
+}
+
+#endif /* Clause ION_THREAD_SAFE */
+
+/**
+@brief		Builds a cursor over the memtables and runs the LSM tree holds right now.
+@param[in]	dictionary
+				The LSM tree dictionary to read.
+@param[in]	predicate
+				The predicate the records returned must satisfy.
+@param[out]	cursor
+				Where to write the new cursor.
+@return		The status of building the cursor.
+*/
+static ion_err_t
+lsmdict_build_cursor(
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	ion_dict_cursor_t	**cursor
+) {
+	ion_lsm_t			*lsm			= (ion_lsm_t *) dictionary->instance;
+	ion_key_size_t		key_size		= dictionary->instance->record.key_size;
+	ion_value_size_t	value_size		= dictionary->instance->record.value_size + sizeof(ion_lsm_tag_t);
+	int					num_sources		= 1;
+	int					level;
+	int					i;
+
+#if ION_THREAD_SAFE
+
+	if (lsm->has_frozen) {
+		num_sources++;
+	}
+
+#endif
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		num_sources += lsm->num_runs[level];
+	}
+
+	/* The sources and their copies of the current record are allocated along with the cursor. */
+	*cursor = malloc(sizeof(ion_lsm_cursor_t) + num_sources * (sizeof(ion_lsm_cursor_source_t) + key_size + value_size));
+
+	if (NULL == *cursor) {
+		return err_out_of_memory;
+	}
+
+	ion_lsm_cursor_t *lsm_cursor = (ion_lsm_cursor_t *) (*cursor);
+
+	/* No source has a reader to close until they are set up below. */
+	lsm_cursor->num_sources = 0;
+	(*cursor)->dictionary	= dictionary;
+	(*cursor)->status		= cs_cursor_uninitialized;
+
+	(*cursor)->destroy		= lsmdict_destroy_cursor;
+	(*cursor)->next			= lsmdict_next;
+	(*cursor)->next_batch	= NULL;
+
+	(*cursor)->predicate	= malloc(sizeof(ion_predicate_t));
+
+	if (NULL == (*cursor)->predicate) {
+		free(*cursor);
+		return err_out_of_memory;
+	}
+
+	(*cursor)->predicate->type		= predicate->type;
+	(*cursor)->predicate->destroy	= predicate->destroy;
+
+	ion_key_t lower_bound = NULL;
+
+	switch (predicate->type) {
+		case predicate_equality: {
+			(*cursor)->predicate->statement.equality.equality_value = malloc(key_size);
+
+			if (NULL == (*cursor)->predicate->statement.equality.equality_value) {
+				free((*cursor)->predicate);
+				free(*cursor);
+				return err_out_of_memory;
+			}
+
+			memcpy((*cursor)->predicate->statement.equality.equality_value, predicate->statement.equality.equality_value, key_size);
+			lower_bound = (*cursor)->predicate->statement.equality.equality_value;
+			break;
+		}
+
+		case predicate_range: {
+			(*cursor)->predicate->statement.range.lower_bound = malloc(key_size);
+
+			if (NULL == (*cursor)->predicate->statement.range.lower_bound) {
+				free((*cursor)->predicate);
+				free(*cursor);
+				return err_out_of_memory;
+			}
+
+			memcpy((*cursor)->predicate->statement.range.lower_bound, predicate->statement.range.lower_bound, key_size);
+
+			(*cursor)->predicate->statement.range.upper_bound = malloc(key_size);
+
+			if (NULL == (*cursor)->predicate->statement.range.upper_bound) {
+				free((*cursor)->predicate->statement.range.lower_bound);
+				free((*cursor)->predicate);
+				free(*cursor);
+				return err_out_of_memory;
+			}
+
+			memcpy((*cursor)->predicate->statement.range.upper_bound, predicate->statement.range.upper_bound, key_size);
+			lower_bound = (*cursor)->predicate->statement.range.lower_bound;
+			break;
+		}
+
+		case predicate_all_records: {
+			break;
+		}
+
+		case predicate_predicate: {
+			return err_ok;
+		}
+
+		default: {
+			free((*cursor)->predicate);
+			free(*cursor);
+			*cursor = NULL;
+			return err_invalid_predicate;
+		}
+	}
+
+	ion_byte_t *record_memory = (ion_byte_t *) (lsm_cursor + 1) + num_sources * sizeof(ion_lsm_cursor_source_t);
+
+	lsm_cursor->sources		= (ion_lsm_cursor_source_t *) (lsm_cursor + 1);
+	lsm_cursor->num_sources = 0;
+
+	/* Newest first: the memtable, the frozen memtable, then each level's runs from newest to oldest. */
+	lsm_cursor->sources[0].run		= NULL;
+	lsm_cursor->sources[0].memtable = &lsm->memtable;
+	lsm_cursor->num_sources++;
+
+#if ION_THREAD_SAFE
+
+	if (lsm->has_frozen) {
+		lsm_cursor->sources[1].run		= NULL;
+		lsm_cursor->sources[1].memtable = &lsm->frozen;
+		lsm_cursor->num_sources++;
+	}
+
+#endif
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		for (i = lsm->num_runs[level] - 1; i >= 0; i--) {
+			ion_lsm_cursor_source_t *source = &lsm_cursor->sources[lsm_cursor->num_sources];
+
+			source->run = lsm->runs[level][i];
+#if ION_THREAD_SAFE
+			source->reader = &source->own_reader;
+
+			if (err_ok != flat_file_open_reader(&source->run->flat_file, source->reader)) {
+				lsmdict_destroy_cursor(cursor);
+				return err_out_of_memory;
+			}
+
+#else
+			source->reader = &source->run->flat_file.reader;
+#endif
+			lsm_cursor->num_sources++;
+		}
+	}
+
+	for (i = 0; i < num_sources; i++) {
+		ion_lsm_cursor_source_t *source = &lsm_cursor->sources[i];
+
+		source->key		= record_memory + i * (key_size + value_size);
+		source->value	= source->key + key_size;
+
+		ion_err_t err = lsmdict_source_seek(lsm, source, lower_bound);
+
+		if (err_ok != err) {
+			lsmdict_destroy_cursor(cursor);
+			return err;
+		}
+	}
+
+	int winner;
+
+	if (err_ok != lsmdict_cursor_settle(lsm_cursor, &winner)) {
+		(*cursor)->status = cs_possible_data_inconsistency;
+	}
+	else if (-1 == winner) {
+		(*cursor)->status = cs_end_of_results;
+	}
+	else {
+		(*cursor)->status = cs_cursor_initialized;
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+lsmdict_find(
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	ion_dict_cursor_t	**cursor
+) {
+#if ION_THREAD_SAFE
+	ion_lsm_t *lsm = (ion_lsm_t *) dictionary->instance;
+
+	/* The compaction worker leaves the frozen memtable and the runs alone until the cursor is destroyed. */
+	ION_RWLOCK_READ(lsm->version_lock);
+
+	ion_err_t err = lsmdict_build_cursor(dictionary, predicate, cursor);
+
+	if (err_ok != err) {
+		ION_RWLOCK_UNLOCK(lsm->version_lock);
+		return err;
+	}
+
+	(*cursor)->destroy = lsmdict_destroy_versioned_cursor;
+
+	return err_ok;
+#else
+	return lsmdict_build_cursor(dictionary, predicate, cursor);
+#endif
+}
+
+ion_err_t
+lsmdict_open_dictionary(
+	ion_dictionary_handler_t		*handler,
+	ion_dictionary_t				*dictionary,
+	ion_dictionary_config_info_t	*config,
+	ion_dictionary_compare_t		compare
+) {
+	return lsmdict_create_dictionary(config->id, config->type, config->key_size, config->value_size, config->dictionary_size, compare, handler, dictionary);
+}
+
+ion_err_t
+lsmdict_close_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	ion_err_t err = lsm_close((ion_lsm_t *) dictionary->instance);
+
+	free(dictionary->instance);
+	dictionary->instance = NULL;
+
+	return err;
+}
+
+ion_err_t
+lsmdict_sync_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	return lsm_sync((ion_lsm_t *) dictionary->instance);
+}
+
+void
+lsmdict_init(
+	ion_dictionary_handler_t *handler
+) {
+	handler->insert				= lsmdict_insert;
+	handler->create_dictionary	= lsmdict_create_dictionary;
+	handler->get				= lsmdict_get;
+	handler->update				= lsmdict_update;
+	handler->find				= lsmdict_find;
+	handler->remove				= lsmdict_delete;
+	handler->delete_dictionary	= lsmdict_delete_dictionary;
+	handler->destroy_dictionary = lsmdict_destroy_dictionary;
+	handler->open_dictionary	= lsmdict_open_dictionary;
+	handler->close_dictionary	= lsmdict_close_dictionary;
+	handler->sync_dictionary	= lsmdict_sync_dictionary;
+	handler->scan_extent		= NULL;
+	handler->scan_range			= NULL;
+	handler->get_many			= NULL;
+	handler->concurrent			= boolean_false;
+}
+
+ion_status_t
+lsmdict_insert(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	return lsm_insert((ion_lsm_t *) dictionary->instance, key, value);
+}
+
+ion_status_t
+lsmdict_get(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	return lsm_get((ion_lsm_t *) dictionary->instance, key, value);
+}
+
+ion_err_t
+lsmdict_create_dictionary(
+	ion_dictionary_id_t			id,
+	ion_key_type_t				key_type,
+	ion_key_size_t				key_size,
+	ion_value_size_t			value_size,
+	ion_dictionary_size_t		dictionary_size,
+	ion_dictionary_compare_t	compare,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_t			*dictionary
+) {
+	dictionary->instance = malloc(sizeof(ion_lsm_t));
+
+	if (NULL == dictionary->instance) {
+		return err_out_of_memory;
+	}
+
+	dictionary->instance->compare	= compare;
+	dictionary->instance->type		= dictionary_type_lsm_t;
+
+	ion_err_t result = lsm_initialize((ion_lsm_t *) dictionary->instance, id, key_type, key_size, value_size, dictionary_size);
+
+	if (err_ok != result) {
+		free(dictionary->instance);
+		dictionary->instance = NULL;
+		return result;
+	}
+
+	if (NULL != handler) {
+		dictionary->handler = handler;
+	}
+
+	return err_ok;
+}
+
+ion_status_t
+lsmdict_delete(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key
+) {
+	return lsm_delete((ion_lsm_t *) dictionary->instance, key);
+}
+
+ion_err_t
+lsmdict_delete_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	ion_err_t result = lsm_destroy((ion_lsm_t *) dictionary->instance);
+
+	free(dictionary->instance);
+	dictionary->instance = NULL;
+	return result;
+}
+
+ion_err_t
+lsmdict_destroy_dictionary(
+	ion_dictionary_id_t id
+) {
+	return lsm_remove_files(id);
+}
+
+ion_status_t
+lsmdict_update(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	return lsm_insert((ion_lsm_t *) dictionary->instance, key, value);
+}
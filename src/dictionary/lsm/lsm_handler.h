@@ -0,0 +1,242 @@
+/******************************************************************************/
+/**
+@file		lsm_handler.h
+@author		IonDB Project
+@brief		Handler liaison between the dictionary API and the LSM tree implementation.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(LSM_HANDLER_H_)
+#define LSM_HANDLER_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "lsm_types.h"
+#include "lsm.h"
+
+/**
+@brief		Given the @p handler instance, bind the appropriate LSM tree functions.
+@param[in]	handler
+				The handler is assumed to be memory that is allocated and initialized
+				by the user.
+*/
+void
+lsmdict_init(
+	ion_dictionary_handler_t *handler
+);
+
+/**
+@brief		Inserts a record, replacing the value of the key if it already exists.
+@param[in]	dictionary
+				The initialized dictionary instance we want to insert into.
+@param[in]	key
+				The key portion of the record to be inserted.
+@param[in]	value
+				The value portion of the record to be inserted.
+@return		The resulting status of the operation.
+*/
+ion_status_t
+lsmdict_insert(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+);
+
+/**
+@brief		Fetches the newest value stored with the given @p key.
+@param[in]	dictionary
+				The initialized dictionary instance we want to query.
+@param[in]	key
+				The key to look for.
+@param[out]	value
+				Where to write the value. Must be allocated by the caller.
+@return		The resulting status of the operation.
+*/
+ion_status_t
+lsmdict_get(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+);
+
+/**
+@brief		Creates an LSM tree, or reopens the one stored under @p id.
+@param[in]	id
+				The identifier of the dictionary, which names its files.
+@param[in]	key_type
+				The category of key used by the dictionary.
+@param[in]	key_size
+				The size of the keys used for this dictionary, specified in bytes.
+@param[in]	value_size
+				The size of the values used for this dictionary, specified in bytes.
+@param[in]	dictionary_size
+				How many records the memtable holds before it is written out as a run.
+@param[in]	compare
+				Function pointer to the comparison function used by the dictionary.
+@param[in]	handler
+				A bound handler for the LSM tree.
+@param[out]	dictionary
+				The dictionary to initialize.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+lsmdict_create_dictionary(
+	ion_dictionary_id_t			id,
+	ion_key_type_t				key_type,
+	ion_key_size_t				key_size,
+	ion_value_size_t			value_size,
+	ion_dictionary_size_t		dictionary_size,
+	ion_dictionary_compare_t	compare,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_t			*dictionary
+);
+
+/**
+@brief		Deletes the given @p key by writing a tombstone for it.
+@param[in]	dictionary
+				The initialized dictionary instance we want to delete from.
+@param[in]	key
+				The key to delete.
+@return		The resulting status of the operation.
+*/
+ion_status_t
+lsmdict_delete(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key
+);
+
+/**
+@brief		Closes the dictionary and removes all of its files.
+@param[in]	dictionary
+				The dictionary to delete.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+lsmdict_delete_dictionary(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Removes all of the files of a closed dictionary.
+@param[in]	id
+				The identifier of the dictionary to destroy.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+lsmdict_destroy_dictionary(
+	ion_dictionary_id_t id
+);
+
+/**
+@brief		Writes @p value for @p key, inserting the record if the key does not exist yet.
+@param[in]	dictionary
+				The initialized dictionary instance we want to update.
+@param[in]	key
+				The key to update.
+@param[in]	value
+				The new value.
+@return		The resulting status of the operation.
+*/
+ion_status_t
+lsmdict_update(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+);
+
+/**
+@brief		Builds a cursor that merges the memtable and every run in key order.
+@details	In thread-safe builds the compaction worker waits for the cursor to be
+			destroyed before it changes the runs the cursor reads.
+@param[in]	dictionary
+				Which dictionary to query on.
+@param[in]	predicate
+				An allocated, initialized predicate object that defines the parameters of the query.
+@param[out]	cursor
+				Redirected to point at the allocated cursor.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+lsmdict_find(
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	ion_dict_cursor_t	**cursor
+);
+
+/**
+@brief		Reopens an LSM tree that was previously closed.
+@param[in]	handler
+				A handler that must be bound with the LSM tree's functions.
+@param[in]	dictionary
+				A dictionary that is allocated but not initialized.
+@param[in]	config
+				The configuration parameters the LSM tree was created with.
+@param[in]	compare
+				The comparison function for the key type.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+lsmdict_open_dictionary(
+	ion_dictionary_handler_t		*handler,
+	ion_dictionary_t				*dictionary,
+	ion_dictionary_config_info_t	*config,
+	ion_dictionary_compare_t		compare
+);
+
+/**
+@brief		Writes out the memtable and closes the dictionary.
+@param[in]	dictionary
+				The dictionary to close.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+lsmdict_close_dictionary(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Writes out the memtable and forces every run to the device.
+@param[in]	dictionary
+				The dictionary to sync.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+lsmdict_sync_dictionary(
+	ion_dictionary_t *dictionary
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* LSM_HANDLER_H_ */
@@ -0,0 +1,276 @@
+/******************************************************************************/
+/**
+@file		lsm_types.h
+@author		IonDB Project
+@brief		Types local to the log-structured merge tree.
+@details	Writes go to an in-memory skip list, the memtable. Once it holds
+			as many records as the dictionary size, it is written out as an
+			immutable run: a flat file in sorted mode. Runs are kept in
+			levels, and a level that fills up is merged into the level below
+			it. Reads and cursors merge the memtable and every run, with
+			newer data shadowing older data.
+
+			Every record carries a tag byte in front of its value, so that a
+			delete can be written as a tombstone that shadows older versions
+			of the key until a merge into the oldest level drops it.
+
+			In thread-safe builds a full memtable is frozen and handed to a
+			compaction worker, which writes it out and runs the merges while
+			writes go on into a fresh memtable. Other builds have no threads
+			to hand the work to, so the write that fills the memtable writes
+			it out and merges the levels itself.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(LSM_TYPES_H_)
+#define LSM_TYPES_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "../dictionary_types.h"
+#include "../dictionary.h"
+#include "../skip_list/skip_list_types.h"
+#include "../flat_file/flat_file_types.h"
+
+#include "../../key_value/kv_system.h"
+
+/**
+@brief		The tag stored in front of every value in the memtable and the runs.
+*/
+typedef ion_byte_t ion_lsm_tag_t;
+
+/**
+@brief		Marks a record that deletes every older version of its key.
+*/
+#define ION_LSM_TAG_TOMBSTONE	0
+/**
+@brief		Marks a record that holds a live value.
+*/
+#define ION_LSM_TAG_VALUE		1
+
+#if !defined(ION_LSM_MAX_LEVELS)
+/**
+@brief		How many levels of runs an LSM tree has. The last level is never merged
+			any further down, it only grows.
+*/
+#define ION_LSM_MAX_LEVELS		4
+#endif
+
+#if !defined(ION_LSM_RUNS_PER_LEVEL)
+/**
+@brief		How many runs a level may hold before it is merged down, and the factor by
+			which each level is larger than the one above it.
+*/
+#define ION_LSM_RUNS_PER_LEVEL	4
+#endif
+
+#if !defined(ION_LSM_RUN_BUFFERED_ROWS)
+/**
+@brief		How many rows each open run buffers, passed to the run's flat file as its
+			dictionary size. Every run is kept open, so this is paid once per run.
+*/
+#define ION_LSM_RUN_BUFFERED_ROWS	8
+#endif
+
+/**
+@brief		How many runs an LSM tree can have on disk at once: every level full, plus
+			the output of the merge in progress.
+*/
+#define ION_LSM_RUN_SLOTS		(ION_LSM_MAX_LEVELS * ION_LSM_RUNS_PER_LEVEL + 1)
+
+/**
+@brief		First ID used to name run files. The runs of the LSM tree with ID @c id are
+			given the IDs @c ION_LSM_RUN_ID_BASE @c + @c id @c * @ref ION_LSM_RUN_SLOTS
+			@c + @c slot, which keeps them clear of the IDs handed out by the master
+			table and within 8.3 file names.
+*/
+#define ION_LSM_RUN_ID_BASE		8000000
+
+/**
+@brief		File extension of the manifest, which lists the runs of each level.
+*/
+#define ION_LSM_MANIFEST_EXTENSION	"lsm"
+
+/**
+@brief		File extension the manifest is written to before it is renamed into place.
+*/
+#define ION_LSM_MANIFEST_TEMP_EXTENSION "lsn"
+
+/**
+@brief		Written at the start of the manifest.
+*/
+#define ION_LSM_MANIFEST_MAGIC	0x314d534c
+
+/**
+@brief		How a full level is merged into the next one.
+*/
+typedef enum {
+	/**> A full level is merged into one new run that is added to the next level,
+		 next to the runs already there. Writes are cheap, reads look at more runs. */
+	ion_lsm_compaction_tiered,
+	/**> Each level below the first holds a single run. A level that grows past its
+		 size is merged together with the run of the next level. Reads look at fewer
+		 runs, at the cost of rewriting the next level on every merge. */
+	ion_lsm_compaction_leveled
+} ion_lsm_compaction_t;
+
+#if !defined(ION_LSM_DEFAULT_COMPACTION)
+/**
+@brief		The compaction policy given to newly created LSM trees.
+*/
+#define ION_LSM_DEFAULT_COMPACTION	ion_lsm_compaction_tiered
+#endif
+
+/**
+@brief		An immutable sorted run.
+*/
+typedef struct {
+	/**> The flat file holding the run, in sorted mode. Its values are tagged. */
+	ion_flat_file_t flat_file;
+	/**> Which of the @ref ION_LSM_RUN_SLOTS slots of the LSM tree the run is stored in. */
+	uint8_t			slot;
+} ion_lsm_run_t;
+
+/**
+@brief		Layout of the manifest file, which is rewritten whenever the set of runs changes.
+*/
+typedef struct {
+	/**> Always @ref ION_LSM_MANIFEST_MAGIC. */
+	uint32_t	magic;
+	/**> The @ref ION_LSM_MAX_LEVELS the manifest was written with. */
+	uint8_t		max_levels;
+	/**> The @ref ION_LSM_RUNS_PER_LEVEL the manifest was written with. */
+	uint8_t		runs_per_level;
+	/**> The @ref ion_lsm_compaction_t in use. */
+	uint8_t		compaction;
+	/**> How many runs each level holds. */
+	uint8_t		num_runs[ION_LSM_MAX_LEVELS];
+	/**> The slot of each run, from oldest to newest. */
+	uint8_t		slots[ION_LSM_MAX_LEVELS][ION_LSM_RUNS_PER_LEVEL];
+} ion_lsm_manifest_t;
+
+/**
+@brief		Metadata container that holds LSM tree specific information.
+*/
+typedef struct {
+	/**> Parent structure that holds dictionary level information. */
+	ion_dictionary_parent_t super;
+	/**> The skip list that absorbs writes. Its values are tagged. */
+	ion_skiplist_t			memtable;
+	/**> How many distinct keys the memtable holds. */
+	ion_dictionary_size_t	memtable_count;
+	/**> How many distinct keys the memtable may hold before it is written out as a run. */
+	ion_dictionary_size_t	memtable_limit;
+	/**> How full levels are merged. May be changed at any time. */
+	ion_lsm_compaction_t	compaction;
+	/**> The runs of each level, from oldest to newest. Every run in a level is newer
+		 than every run in the levels below it. */
+	ion_lsm_run_t			*runs[ION_LSM_MAX_LEVELS][ION_LSM_RUNS_PER_LEVEL];
+	/**> How many runs each level holds. */
+	int						num_runs[ION_LSM_MAX_LEVELS];
+	/**> Memory for one tagged value, only used while writing. */
+	ion_byte_t				*scratch;
+#if ION_THREAD_SAFE
+	/**> The memtable that filled up last, while the worker writes it out. It is newer
+		 than every run. Its values are tagged. */
+	ion_skiplist_t			frozen;
+	/**> Whether @p frozen holds a memtable. Only changed with both @p worker_lock and
+		 @p version_lock held, so it may be read under either. */
+	ion_boolean_t			has_frozen;
+	/**> Held for reading by lookups and for the lifetime of cursors, and for writing
+		 while @p frozen or the runs change. */
+	ion_rwlock_t			version_lock;
+	/**> The compaction worker, the only thread that changes the runs. */
+	pthread_t				worker;
+	/**> Guards the fields below. */
+	ion_mutex_t				worker_lock;
+	/**> Broadcast when work is handed over, when it is finished, and when the worker
+		 is told to stop. */
+	ion_cond_t				worker_signal;
+	/**> Whether the worker has been handed work it has not started on yet. */
+	ion_boolean_t			work_requested;
+	/**> Whether the worker is writing out @p frozen or merging levels. */
+	ion_boolean_t			busy;
+	/**> Whether the worker should exit once it is done with what it is working on. */
+	ion_boolean_t			stopping;
+	/**> The first error the worker ran into since it was last reported. */
+	ion_err_t				worker_error;
+#endif
+} ion_lsm_t;
+
+/**
+@brief		Where a cursor is within one of the sources it merges.
+*/
+typedef struct {
+	/**> The run this source reads, or @p NULL for a memtable. */
+	ion_lsm_run_t			*run;
+	/**> The memtable this source reads, if it does not read a run. */
+	ion_skiplist_t			*memtable;
+	/**> The memtable node this source is on. */
+	ion_sl_node_t			*node;
+	/**> The row this source is on within its run. */
+	ion_fpos_t				location;
+	/**> Which reader of the run this source reads through. In thread-safe builds this is
+		 @p own_reader, so that cursors read concurrently. Otherwise it is the run's own reader. */
+	ion_flat_file_reader_t	*reader;
+#if ION_THREAD_SAFE
+	/**> The reader of this source alone. */
+	ion_flat_file_reader_t	own_reader;
+#endif
+	/**> Whether this source has run out of records. */
+	ion_boolean_t			exhausted;
+	/**> Copy of the key this source is on. */
+	ion_byte_t				*key;
+	/**> Copy of the tagged value this source is on. */
+	ion_byte_t				*value;
+} ion_lsm_cursor_source_t;
+
+/**
+@brief		Implementation cursor type for the LSM tree cursor.
+@details	The sources are ordered from newest to oldest: the memtable, the frozen
+			memtable if there is one, then the runs of each level from newest to oldest.
+*/
+typedef struct {
+	/**> Supertype of the dictionary cursor. */
+	ion_dict_cursor_t		super;
+	/**> How many sources are merged. */
+	int						num_sources;
+	/**> The sources, allocated along with the cursor. */
+	ion_lsm_cursor_source_t *sources;
+} ion_lsm_cursor_t;
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* LSM_TYPES_H_ */
@@ -48,9 +48,9 @@ ion_err_t
 oafh_close(
 	ion_file_hashmap_t *hash_map
 ) {
-	if (NULL != hash_map->file) {
+	if (!ION_FILE_IS_NULL(hash_map->file)) {
 		/* check to ensure that you are not freeing something already free */
-		fclose(hash_map->file);
+		ion_fclose(hash_map->file);
 		free(hash_map);
 		return err_ok;
 	}
@@ -59,6 +59,13 @@ oafh_close(
 	}
 }
 
+ion_err_t
+oafh_sync(
+	ion_file_hashmap_t *hash_map
+) {
+	return ion_fsync(hash_map->file);
+}
+
 ion_err_t
 oafh_initialize(
 	ion_file_hashmap_t *hashmap,
@@ -89,14 +96,21 @@ oafh_initialize(
 		return err_uninitialized;
 	}
 
-	hashmap->file = fopen(addr_filename, "r+b");
+	ion_boolean_t is_new = !ion_fexists(addr_filename);
 
-	if (NULL != hashmap->file) {
-		return err_ok;
+	hashmap->file = ion_fopen(addr_filename);
+
+	if (ION_FILE_IS_NULL(hashmap->file)) {
+		return err_file_open_error;
 	}
 
-	/* open the file */
-	hashmap->file = fopen(addr_filename, "w+b");
+#if ION_FILE_STATS
+	ion_file_set_owner(hashmap->file, id);
+#endif
+
+	if (!is_new) {
+		return err_ok;
+	}
 
 	ion_hash_bucket_t *file_record;
 
@@ -113,14 +127,14 @@ oafh_initialize(
 	int i, writes = 0;
 
 	for (i = 0; i < hashmap->map_size; i++) {
-		writes	+= fwrite(&file_record->status, SIZEOF(STATUS), 1, hashmap->file);
-		writes	+= fwrite(file_record->data, record_size - SIZEOF(STATUS), 1, hashmap->file);
+		writes	+= err_ok == ion_fwrite(hashmap->file, SIZEOF(STATUS), (ion_byte_t *) &file_record->status);
+		writes	+= err_ok == ion_fwrite(hashmap->file, record_size - SIZEOF(STATUS), file_record->data);
 	}
 
-	fflush(hashmap->file);
+	ion_fflush(hashmap->file);
 
 	if (writes / 2 != hashmap->map_size) {
-		fclose(hashmap->file);
+		ion_fclose(hashmap->file);
 		return err_file_write_error;
 	}
 
@@ -154,11 +168,11 @@ oafh_destroy(
 		return err_dictionary_destruction_error;
 	}
 
-	if (hash_map->file != NULL) {
+	if (!ION_FILE_IS_NULL(hash_map->file)) {
 		/* check to ensure that you are not freeing something already free */
-		fclose(hash_map->file);
-		fremove(addr_filename);
-		hash_map->file = NULL;
+		ion_fclose(hash_map->file);
+		ion_fremove(addr_filename);
+		hash_map->file = ION_NOFILE;
 		return err_ok;
 	}
 	else {
@@ -202,12 +216,12 @@ oafh_insert(
 	item = malloc(record_size);
 
 	/* set file position */
-	fseek(hash_map->file, loc * record_size, SEEK_SET);
+	ion_fseek(hash_map->file, loc * record_size, ION_FILE_START);
 
 	while (count != hash_map->map_size) {
-		fread(item, record_size, 1, hash_map->file);
+		ion_fread(hash_map->file, record_size, (ion_byte_t *) item);
 #if ION_DEBUG
-		DUMP((int) ftell(hash_map->file), "%i");
+		DUMP((int) ion_ftell(hash_map->file), "%i");
 #endif
 
 		if (item->status == ION_IN_USE) {
@@ -222,12 +236,12 @@ oafh_insert(
 				else if (hash_map->write_concern == wc_update) {
 					/* allows for values to be updated											// */
 					/* backup and write */
-					fseek(hash_map->file, SIZEOF(STATUS) + hash_map->super.record.key_size - record_size, SEEK_CUR);
+					ion_fseek(hash_map->file, SIZEOF(STATUS) + hash_map->super.record.key_size - record_size, ION_FILE_CURRENT);
 #if ION_DEBUG
-					DUMP((int) ftell(hash_map->file), "%i");
+					DUMP((int) ion_ftell(hash_map->file), "%i");
 					DUMP(value, "%s");
 #endif
-					fwrite(value, hash_map->super.record.value_size, 1, hash_map->file);
+					ion_fwrite(hash_map->file, hash_map->super.record.value_size, (ion_byte_t *) value);
 					free(item);
 					return ION_STATUS_OK(1);
 				}
@@ -240,14 +254,14 @@ oafh_insert(
 		else if ((item->status == ION_EMPTY) || (item->status == ION_DELETED)) {
 			/* problem is here with base types as it is just an array of data.  Need better way */
 			/* printf("empty\n"); */
-			fseek(hash_map->file, -record_size, SEEK_CUR);
+			ion_fseek(hash_map->file, -record_size, ION_FILE_CURRENT);
 #if ION_DEBUG
-			DUMP((int) ftell(hash_map->file), "%i");
+			DUMP((int) ion_ftell(hash_map->file), "%i");
 #endif
 			item->status = ION_IN_USE;
 			memcpy(item->data, key, (hash_map->super.record.key_size));
 			memcpy(item->data + hash_map->super.record.key_size, value, (hash_map->super.record.value_size));
-			fwrite(item, record_size, 1, hash_map->file);
+			ion_fwrite(hash_map->file, record_size, (ion_byte_t *) item);
 			free(item);
 
 			return ION_STATUS_OK(1);
@@ -259,7 +273,7 @@ oafh_insert(
 			/* Perform wrapping */
 			loc = 0;
 			/* rewind the file */
-			frewind(hash_map->file);
+			ion_fseek(hash_map->file, 0, ION_FILE_START);
 		}
 
 #if ION_DEBUG
@@ -295,13 +309,9 @@ oafh_find_item_loc(
 
 	item = malloc(record_size);
 
-	/* set file position */
-	fseek(hash_map->file, loc * record_size, SEEK_SET);
-
-	/* needs to traverse file again */
+	/* needs to traverse file again, reading at each position so that the file position is left alone */
 	while (count != hash_map->map_size) {
-		fread(&item->status, SIZEOF(STATUS), 1, hash_map->file);
-		fread(item->data, record_size - SIZEOF(STATUS), 1, hash_map->file);
+		ion_fread_at(hash_map->file, loc * record_size, record_size, (ion_byte_t *) item);
 
 		if (item->status == ION_EMPTY) {
 			free(item);
@@ -326,7 +336,6 @@ oafh_find_item_loc(
 			if (loc >= hash_map->map_size) {
 				/* Perform wrapping */
 				loc = 0;
-				frewind(hash_map->file);
 			}
 		}
 	}
@@ -357,17 +366,17 @@ oafh_delete(
 		item = malloc(record_size);
 
 		/* set file position */
-		fseek(hash_map->file, loc * record_size, SEEK_SET);
+		ion_fseek(hash_map->file, loc * record_size, ION_FILE_START);
 
-		fread(&item->status, SIZEOF(STATUS), 1, hash_map->file);
-		fread(item->data, record_size - SIZEOF(STATUS), 1, hash_map->file);
+		ion_fread(hash_map->file, SIZEOF(STATUS), (ion_byte_t *) &item->status);
+		ion_fread(hash_map->file, record_size - SIZEOF(STATUS), item->data);
 
 		item->status = ION_DELETED;	/* delete item */
 
 		/* backup */
-		fseek(hash_map->file, -record_size, SEEK_CUR);
-		fwrite(&item->status, SIZEOF(STATUS), 1, hash_map->file);
-		fwrite(item->data, record_size - SIZEOF(STATUS), 1, hash_map->file);
+		ion_fseek(hash_map->file, -record_size, ION_FILE_CURRENT);
+		ion_fwrite(hash_map->file, SIZEOF(STATUS), (ion_byte_t *) &item->status);
+		ion_fwrite(hash_map->file, record_size - SIZEOF(STATUS), item->data);
 
 		free(item);
 #if ION_DEBUG
@@ -392,12 +401,10 @@ oafh_get(
 
 		int record_size = hash_map->super.record.key_size + hash_map->super.record.value_size + SIZEOF(STATUS);
 
-		/* set file position */
-		fseek(hash_map->file, (loc * record_size) + SIZEOF(STATUS) + hash_map->super.record.key_size, SEEK_SET);
 #if ION_DEBUG
-		printf("seeking %i\n", (loc * record_size) + SIZEOF(STATUS) + hash_map->super.record.key_size);
+		printf("reading at %i\n", (loc * record_size) + SIZEOF(STATUS) + hash_map->super.record.key_size);
 #endif
-		fread(value, hash_map->super.record.value_size, 1, hash_map->file);
+		ion_fread_at(hash_map->file, (loc * record_size) + SIZEOF(STATUS) + hash_map->super.record.key_size, hash_map->super.record.value_size, (ion_byte_t *) value);
 
 		return ION_STATUS_OK(1);
 	}
@@ -410,6 +417,97 @@ oafh_get(
 	}
 }
 
+ion_err_t
+oafh_get_many(
+	ion_file_hashmap_t	*hash_map,
+	unsigned int		num_keys,
+	ion_key_t			*keys,
+	ion_value_t			*values,
+	ion_status_t		*statuses
+) {
+	int					record_size = hash_map->super.record.key_size + hash_map->super.record.value_size + SIZEOF(STATUS);
+	ion_file_queue_t	*queue;
+	ion_file_read_t		reads[ION_FILE_QUEUE_DEPTH];
+	unsigned int		probing[ION_FILE_QUEUE_DEPTH];	/* the keys being probed for */
+	int					locations[ION_FILE_QUEUE_DEPTH];
+	int					counts[ION_FILE_QUEUE_DEPTH];
+	ion_hash_bucket_t	*item;
+	ion_byte_t			*buckets;
+	unsigned int		next			= 0;
+	unsigned int		num_probing		= 0;
+	unsigned int		num_left;
+	unsigned int		i;
+	ion_err_t			error;
+
+	buckets = malloc(ION_FILE_QUEUE_DEPTH * record_size);
+
+	if (NULL == buckets) {
+		return err_out_of_memory;
+	}
+
+	error = ion_file_queue_local(&queue);
+
+	if (err_ok != error) {
+		free(buckets);
+		return error;
+	}
+
+	while ((next < num_keys) || (num_probing > 0)) {
+		/* top the round up with keys that have not been probed for yet */
+		for (; (next < num_keys) && (num_probing < ION_FILE_QUEUE_DEPTH); next++) {
+			if (err_uninitialized == statuses[next].error) {
+				probing[num_probing]	= next;
+				locations[num_probing]	= oafh_get_location(hash_map->compute_hash(hash_map, keys[next], hash_map->super.record.key_size), hash_map->map_size);
+				counts[num_probing]		= 0;
+				num_probing++;
+			}
+		}
+
+		for (i = 0; i < num_probing; i++) {
+			reads[i].file		= hash_map->file;
+			reads[i].offset		= locations[i] * record_size;
+			reads[i].num_bytes	= record_size;
+			reads[i].write_to	= buckets + i * record_size;
+			ion_file_queue_read(queue, &reads[i]);
+		}
+
+		ion_file_queue_wait(queue);
+
+		/* settle what the round answered, keeping the rest in order */
+		num_left = 0;
+
+		for (i = 0; i < num_probing; i++) {
+			item = (ion_hash_bucket_t *) (buckets + i * record_size);
+
+			if (err_ok != reads[i].error) {
+				statuses[probing[i]] = ION_STATUS_ERROR(reads[i].error);
+			}
+			else if (item->status == ION_EMPTY) {
+				statuses[probing[i]] = ION_STATUS_ERROR(err_item_not_found);
+			}
+			else if ((item->status != ION_DELETED) && (ION_IS_EQUAL == hash_map->super.compare(item->data, keys[probing[i]], hash_map->super.record.key_size))) {
+				memcpy(values[probing[i]], item->data + hash_map->super.record.key_size, hash_map->super.record.value_size);
+				statuses[probing[i]] = ION_STATUS_OK(1);
+			}
+			else if (++counts[i] == hash_map->map_size) {
+				statuses[probing[i]] = ION_STATUS_ERROR(err_item_not_found);
+			}
+			else {
+				probing[num_left]	= probing[i];
+				locations[num_left] = (locations[i] + 1) % hash_map->map_size;
+				counts[num_left]	= counts[i];
+				num_left++;
+			}
+		}
+
+		num_probing = num_left;
+	}
+
+	free(buckets);
+
+	return err_ok;
+}
+
 ion_hash_t
 oafh_compute_simple_hash(
 	ion_file_hashmap_t	*hashmap,
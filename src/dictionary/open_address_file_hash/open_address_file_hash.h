@@ -47,6 +47,8 @@ extern "C" {
 #include "../dictionary_types.h"
 #include "./../dictionary.h"
 #include "open_address_file_hash_dictionary.h"
+#include "../../file/ion_file.h"
+#include "../../file/ion_file_queue.h"
 
 #include "../../key_value/kv_system.h"
 
@@ -80,7 +82,7 @@ struct file_hashmap {
 
 	/**< The hashing function to be used for
 		 the instance*/
-	FILE *file;	/**< file pointer */
+	ion_file_handle_t file;	/**< file pointer */
 };
 
 /**
@@ -110,6 +112,18 @@ oafh_close(
 	ion_file_hashmap_t *hash_map
 );
 
+/**
+@brief		Forces every write made to a hashmap's file to the device.
+
+@param		hash_map
+				Pointer to the hashmap instance to sync.
+@return		The status describing the result of the sync.
+ */
+ion_err_t
+oafh_sync(
+	ion_file_hashmap_t *hash_map
+);
+
 /**
 @brief		This function initializes an open address in memory hash map.
 
@@ -279,6 +293,36 @@ oafh_get(
 	ion_value_t			value
 );
 
+/**
+@brief		Looks up a batch of keys, probing for all of them at once.
+
+@details	Each round reads the next bucket of every key still being
+			probed for through the queue of @ref ion_file_queue_local, so
+			the reads of a batch are in flight together rather than one
+			after another.
+
+@param		hash_map
+				The map to search.
+@param		num_keys
+				How many keys to look up.
+@param		keys
+				The keys.
+@param		values
+				Buffers the value of each key found is copied into.
+@param		statuses
+				The status of each lookup. Only keys whose status is
+				@c err_uninitialized are looked up.
+@return		The status of the batch as a whole.
+*/
+ion_err_t
+oafh_get_many(
+	ion_file_hashmap_t	*hash_map,
+	unsigned int		num_keys,
+	ion_key_t			*keys,
+	ion_value_t			*values,
+	ion_status_t		*statuses
+);
+
 /**
 @brief		A simple hashing algorithm implementation.
 
@@ -97,16 +97,13 @@ oafdict_scan(
 
 	int record_size = SIZEOF(STATUS) + hash_map->super.record.key_size + hash_map->super.record.value_size;
 
-	/* move to the correct position in the fie */
-	fseek(hash_map->file, loc * record_size, SEEK_SET);
-
 	ion_hash_bucket_t *item;
 
 	item = malloc(record_size);
 
 	/* start at the current position, scan forward */
 	while (loc != cursor->first) {
-		fread(item, record_size, 1, hash_map->file);
+		ion_fread_at(hash_map->file, loc * record_size, record_size, (ion_byte_t *) item);
 
 		if ((item->status == ION_EMPTY) || (item->status == ION_DELETED)) {
 			/* if empty, just skip to next cell */
@@ -187,12 +184,11 @@ oafdict_next(
 
 		/* the results are now ready //reference item at given position */
 
-		/* set position in file to read value */
-		fseek(hash_map->file, (SIZEOF(STATUS) + data_length) * oafdict_cursor->current	/* position is based on indexes (not abs file pos) */
-			+ SIZEOF(STATUS), SEEK_SET);
+		/* position is based on indexes (not abs file pos) */
+		ion_file_offset_t offset = (SIZEOF(STATUS) + data_length) * oafdict_cursor->current + SIZEOF(STATUS);
 
-		fread(record->key, hash_map->super.record.key_size, 1, hash_map->file);
-		fread(record->value, hash_map->super.record.value_size, 1, hash_map->file);
+		ion_fread_at(hash_map->file, offset, hash_map->super.record.key_size, record->key);
+		ion_fread_at(hash_map->file, offset + hash_map->super.record.key_size, hash_map->super.record.value_size, record->value);
 
 		/* and update current cursor position */
 		return cursor->status;
@@ -202,6 +198,101 @@ oafdict_next(
 	return cs_invalid_cursor;
 }
 
+/**
+@brief		Batched next function to retrieve up to @p max_records
+			<K,V> pairs that satisfy the predicate of the cursor.
+
+@details	Buckets are read sequentially from the file and matching
+			records are copied out of the bucket that was just read, rather
+			than seeking back to re-read each result.
+
+@param	  cursor
+				The cursor to iterate over the results.
+@param		records
+				An array of at least @p max_records pre-allocated records.
+@param		max_records
+				The maximum number of records to retrieve.
+@param		num_records
+				Set to the number of records retrieved.
+@return		The status of the cursor.
+*/
+ion_cursor_status_t
+oafdict_next_batch(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*records,
+	ion_result_count_t	max_records,
+	ion_result_count_t	*num_records
+) {
+	ion_oafdict_cursor_t *oafdict_cursor = (ion_oafdict_cursor_t *) cursor;
+
+	*num_records = 0;
+
+	/* check the status of the cursor and if it is not valid or at the end, just exit */
+	if ((cursor->status != cs_cursor_initialized) && (cursor->status != cs_cursor_active)) {
+		return cursor->status;
+	}
+
+	if (0 == max_records) {
+		return cursor->status;
+	}
+
+	ion_file_hashmap_t	*hash_map		= ((ion_file_hashmap_t *) cursor->dictionary->instance);
+	ion_key_size_t		key_size		= hash_map->super.record.key_size;
+	ion_value_size_t	value_size		= hash_map->super.record.value_size;
+	int					record_size		= SIZEOF(STATUS) + key_size + value_size;
+	ion_hash_bucket_t	*item;
+	int					loc;
+
+	if ((item = malloc(record_size)) == NULL) {
+		return cs_invalid_cursor;
+	}
+
+	if (cursor->status == cs_cursor_initialized) {
+		/* the cursor is sitting on its first result, so take it without scanning */
+		if (err_ok != ion_fread_at(hash_map->file, record_size * oafdict_cursor->current, record_size, (ion_byte_t *) item)) {
+			free(item);
+			cursor->status = cs_possible_data_inconsistency;
+			return cursor->status;
+		}
+
+		memcpy(records[0].key, item->data, key_size);
+		memcpy(records[0].value, item->data + key_size, value_size);
+		*num_records	= 1;
+		cursor->status	= cs_cursor_active;
+	}
+
+	/* read buckets in order, wrapping until we are back at the first result */
+	loc = (oafdict_cursor->current + 1) % hash_map->map_size;
+
+	while (*num_records < max_records && loc != oafdict_cursor->first) {
+		if (err_ok != ion_fread_at(hash_map->file, record_size * loc, record_size, (ion_byte_t *) item)) {
+			cursor->status = cs_possible_data_inconsistency;
+			break;
+		}
+
+		if ((item->status != ION_EMPTY) && (item->status != ION_DELETED) && (test_predicate(cursor, item->data) == boolean_true)) {
+			memcpy(records[*num_records].key, item->data, key_size);
+			memcpy(records[*num_records].value, item->data + key_size, value_size);
+			(*num_records)++;
+			oafdict_cursor->current = loc;
+		}
+
+		if (++loc >= hash_map->map_size) {
+			/* Perform wrapping */
+			loc = 0;
+		}
+	}
+
+	if (loc == oafdict_cursor->first) {
+		/* every bucket has been visited */
+		cursor->status = cs_end_of_results;
+	}
+
+	free(item);
+
+	return 0 < *num_records ? cs_cursor_active : cursor->status;
+}
+
 /**
 @brief	  Finds multiple instances of a keys that satisfy the provided
 			 predicate in the dictionary.
@@ -238,6 +329,7 @@ oafdict_find(
 
 	/* bind correct next function */
 	(*cursor)->next					= oafdict_next;	/* this will use the correct value */
+	(*cursor)->next_batch			= oafdict_next_batch;
 
 	/* allocate predicate */
 	(*cursor)->predicate			= malloc(sizeof(ion_predicate_t));
@@ -390,6 +482,118 @@ oafdict_close_dictionary(
 	return err_ok;
 }
 
+/**
+@brief		Forces everything written to the hashmap to the device.
+
+@param		dictionary
+				The instance of the dictionary to sync.
+@return		The status of the sync.
+*/
+ion_err_t
+oafdict_sync_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	return oafh_sync((ion_file_hashmap_t *) dictionary->instance);
+}
+
+/**
+@brief		Gives the number of buckets in the hashmap file, for a parallel scan.
+
+@param		dictionary
+				The instance of the dictionary to scan.
+@param		num_positions
+				Set to the number of buckets, empty ones included.
+@param		position_size
+				Set to the size of a bucket.
+@return		The status of the operation.
+*/
+ion_err_t
+oafdict_scan_extent(
+	ion_dictionary_t	*dictionary,
+	ion_fpos_t			*num_positions,
+	size_t				*position_size
+) {
+	ion_file_hashmap_t *hash_map = (ion_file_hashmap_t *) dictionary->instance;
+
+	*num_positions	= hash_map->map_size;
+	*position_size	= SIZEOF(STATUS) + hash_map->super.record.key_size + hash_map->super.record.value_size;
+
+	return err_ok;
+}
+
+/**
+@brief		Reads as many buckets of a scan range as fit in the range's buffer,
+			and passes the occupied ones on to the scan.
+
+@param		dictionary
+				The instance of the dictionary to scan.
+@param		range
+				The range being read.
+@return		The status of the operation.
+*/
+ion_err_t
+oafdict_scan_range(
+	ion_dictionary_t			*dictionary,
+	ion_dictionary_scan_range_t *range
+) {
+	ion_file_hashmap_t	*hash_map		= (ion_file_hashmap_t *) dictionary->instance;
+	ion_key_size_t		key_size		= hash_map->super.record.key_size;
+	int					record_size		= SIZEOF(STATUS) + key_size + hash_map->super.record.value_size;
+	ion_fpos_t			num_buckets		= range->buffer_size / record_size;
+	ion_hash_bucket_t	*item;
+	ion_err_t			err;
+	ion_fpos_t			i;
+
+	if (num_buckets > range->end - range->position) {
+		num_buckets = range->end - range->position;
+	}
+
+	err = ion_fread_at(hash_map->file, record_size * range->position, record_size * num_buckets, range->buffer);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	range->position += num_buckets;
+
+	for (i = 0; i < num_buckets; i++) {
+		item = (ion_hash_bucket_t *) (range->buffer + record_size * i);
+
+		if ((item->status != ION_EMPTY) && (item->status != ION_DELETED) && !dictionary_scan_emit(range, item->data, item->data + key_size)) {
+			break;
+		}
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Looks up a batch of keys with the reads of the whole batch in
+			flight together.
+
+@param		dictionary
+				The instance of the dictionary to search.
+@param		num_keys
+				How many keys to look up.
+@param		keys
+				The keys.
+@param		values
+				Buffers the value of each key found is copied into.
+@param		statuses
+				The status of each lookup.
+@return		The status of the batch as a whole.
+*/
+ion_err_t
+oafdict_get_many(
+	ion_dictionary_t	*dictionary,
+	unsigned int		num_keys,
+	ion_key_t			*keys,
+	ion_value_t			*values,
+	ion_status_t		*statuses
+) {
+	return oafh_get_many((ion_file_hashmap_t *) dictionary->instance, num_keys, keys, values, statuses);
+}
+
 void
 oafdict_init(
 	ion_dictionary_handler_t *handler
@@ -404,6 +608,11 @@ oafdict_init(
 	handler->destroy_dictionary = oafdict_destroy_dictionary;
 	handler->open_dictionary	= oafdict_open_dictionary;
 	handler->close_dictionary	= oafdict_close_dictionary;
+	handler->sync_dictionary	= oafdict_sync_dictionary;
+	handler->scan_extent		= oafdict_scan_extent;
+	handler->scan_range			= oafdict_scan_range;
+	handler->get_many			= oafdict_get_many;
+	handler->concurrent			= boolean_false;
 }
 
 ion_status_t
@@ -481,7 +690,7 @@ oafdict_destroy_dictionary(
 		return err_dictionary_destruction_error;
 	}
 
-	fremove(addr_filename);
+	ion_fremove(addr_filename);
 
 	return err_ok;
 }
@@ -164,6 +164,7 @@ oadict_find(
 
 	/* bind correct next function */
 	(*cursor)->next					= oadict_next;	/* this will use the correct value */
+	(*cursor)->next_batch			= oadict_next_batch;
 
 	/* allocate predicate */
 	(*cursor)->predicate			= malloc(sizeof(ion_predicate_t));
@@ -320,6 +321,75 @@ oadict_close_dictionary(
 	return err_not_implemented;
 }
 
+/**
+@brief			Gives the number of buckets in a hashmap, for a parallel scan.
+
+@param			dictionary
+					The instance of the dictionary to scan.
+@param			num_positions
+					Set to the number of buckets, empty ones included.
+@param			position_size
+					Set to the size of a bucket.
+
+@return			The status of the operation.
+ */
+ion_err_t
+oadict_scan_extent(
+	ion_dictionary_t	*dictionary,
+	ion_fpos_t			*num_positions,
+	size_t				*position_size
+) {
+	ion_hashmap_t *hash_map = (ion_hashmap_t *) dictionary->instance;
+
+	*num_positions	= hash_map->map_size;
+	*position_size	= SIZEOF(STATUS) + hash_map->super.record.key_size + hash_map->super.record.value_size;
+
+	return err_ok;
+}
+
+/**
+@brief			Passes the occupied buckets of the next part of a scan range on
+				to the scan.
+
+@details		The buckets are in memory, so they are read in place; the size
+				of the range's buffer only bounds how many are visited at once.
+
+@param			dictionary
+					The instance of the dictionary to scan.
+@param			range
+					The range being read.
+
+@return			The status of the operation.
+ */
+ion_err_t
+oadict_scan_range(
+	ion_dictionary_t			*dictionary,
+	ion_dictionary_scan_range_t *range
+) {
+	ion_hashmap_t		*hash_map		= (ion_hashmap_t *) dictionary->instance;
+	ion_key_size_t		key_size		= hash_map->super.record.key_size;
+	int					bucket_size		= SIZEOF(STATUS) + key_size + hash_map->super.record.value_size;
+	ion_fpos_t			loc				= range->position;
+	ion_fpos_t			end				= range->position + range->buffer_size / bucket_size;
+	ion_hash_bucket_t	*item;
+
+	if (end > range->end) {
+		end = range->end;
+	}
+
+	range->position = end;
+
+	for (; loc < end; loc++) {
+		item = (ion_hash_bucket_t *) (hash_map->entry + bucket_size * loc);
+
+		if ((item->status != ION_EMPTY) && (item->status != ION_DELETED) && !dictionary_scan_emit(range, item->data, item->data + key_size)) {
+			break;
+		}
+	}
+
+	return err_ok;
+}
+
 void
 oadict_init(
 	ion_dictionary_handler_t *handler
@@ -334,6 +404,11 @@ oadict_init(
 	handler->destroy_dictionary = oadict_destroy_dictionary;
 	handler->close_dictionary	= oadict_close_dictionary;
 	handler->open_dictionary	= oadict_open_dictionary;
+	handler->sync_dictionary	= NULL;	/* Records live in memory until the dictionary is closed. */
+	handler->scan_extent		= oadict_scan_extent;
+	handler->scan_range			= oadict_scan_range;
+	handler->get_many			= NULL;
+	handler->concurrent			= boolean_false;
 }
 
 ion_status_t
@@ -469,6 +544,66 @@ oadict_next(
 	return cs_invalid_cursor;
 }
 
+ion_cursor_status_t
+oadict_next_batch(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*records,
+	ion_result_count_t	max_records,
+	ion_result_count_t	*num_records
+) {
+	ion_oadict_cursor_t *oadict_cursor = (ion_oadict_cursor_t *) cursor;
+
+	*num_records = 0;
+
+	/* check the status of the cursor and if it is not valid or at the end, just exit */
+	if ((cursor->status != cs_cursor_initialized) && (cursor->status != cs_cursor_active)) {
+		return cursor->status;
+	}
+
+	ion_hashmap_t		*hash_map		= ((ion_hashmap_t *) cursor->dictionary->instance);
+	ion_key_size_t		key_size		= hash_map->super.record.key_size;
+	ion_value_size_t	value_size		= hash_map->super.record.value_size;
+	int					bucket_size		= key_size + value_size + SIZEOF(STATUS);
+	ion_hash_bucket_t	*item;
+	int					loc;
+
+	if ((0 < max_records) && (cursor->status == cs_cursor_initialized)) {
+		/* the cursor is sitting on its first result, so take it without scanning */
+		item = (ion_hash_bucket_t *) (hash_map->entry + bucket_size * oadict_cursor->current);
+
+		memcpy(records[0].key, item->data, key_size);
+		memcpy(records[0].value, item->data + key_size, value_size);
+		*num_records	= 1;
+		cursor->status	= cs_cursor_active;
+	}
+
+	/* walk the buckets directly, wrapping until we are back at the first result */
+	loc = (oadict_cursor->current + 1) % hash_map->map_size;
+
+	while (*num_records < max_records && loc != oadict_cursor->first) {
+		item = (ion_hash_bucket_t *) (hash_map->entry + bucket_size * loc);
+
+		if ((item->status != ION_EMPTY) && (item->status != ION_DELETED) && (test_predicate(cursor, item->data) == boolean_true)) {
+			memcpy(records[*num_records].key, item->data, key_size);
+			memcpy(records[*num_records].value, item->data + key_size, value_size);
+			(*num_records)++;
+			oadict_cursor->current = loc;
+		}
+
+		if (++loc >= hash_map->map_size) {
+			/* Perform wrapping */
+			loc = 0;
+		}
+	}
+
+	if (loc == oadict_cursor->first) {
+		/* every bucket has been visited */
+		cursor->status = cs_end_of_results;
+	}
+
+	return 0 < *num_records ? cs_cursor_active : cursor->status;
+}
+
 ion_boolean_t
 oadict_is_equal(
 	ion_dictionary_t	*dict,
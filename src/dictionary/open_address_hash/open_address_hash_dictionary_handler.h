@@ -265,6 +265,31 @@ oadict_next(
 	ion_record_t		*record
 );
 
+/**
+@brief	  Batched next function to retrieve up to @p max_records
+			<K,V> pairs that satisfy the predicate of the cursor.
+
+@details	The buckets of the map are walked directly, without returning
+			to the caller between results.
+
+@param	  cursor
+				The cursor to iterate over the results.
+@param		records
+				An array of at least @p max_records pre-allocated records.
+@param		max_records
+				The maximum number of records to retrieve.
+@param		num_records
+				Set to the number of records retrieved.
+@return	 The status of the cursor.
+*/
+ion_cursor_status_t
+oadict_next_batch(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*records,
+	ion_result_count_t	max_records,
+	ion_result_count_t	*num_records
+);
+
 /**
 @brief	  Compares two keys and determines if they are equal assuming
 			that they are equal is length (in size).
@@ -0,0 +1,720 @@
+/******************************************************************************/
+/**
+@file		sharded.c
+@author		IonDB Project
+@brief		Implementation of the sharded dictionary.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "sharded.h"
+#include "../bpp_tree/bpp_tree_handler.h"
+#include "../flat_file/flat_file_dictionary_handler.h"
+#include "../open_address_file_hash/open_address_file_hash_dictionary_handler.h"
+#include "../open_address_hash/open_address_hash_dictionary_handler.h"
+#include "../skip_list/skip_list_handler.h"
+#include "../linear_hash/linear_hash_handler.h"
+#include "../lsm/lsm_handler.h"
+#include "../concurrent_skip_list/concurrent_skip_list_handler.h"
+
+/**
+@brief		Computes the ID of a shard.
+@param[in]	id
+				The ID of the sharded dictionary.
+@param[in]	shard
+				The index of the shard.
+@return		The ID of the shard, see @ref ION_SHARDED_SHARD_ID_BASE.
+*/
+static ion_dictionary_id_t
+sharded_shard_id(
+	ion_dictionary_id_t id,
+	int					shard
+) {
+	return ION_SHARDED_SHARD_ID_BASE + id * ION_SHARDED_MAX_SHARDS + shard;
+}
+
+/**
+@brief		Binds the handler of a type of shard.
+@param[in]	type
+				The type of the shards.
+@param[out]	handler
+				The handler to bind.
+@return		@ref err_uninitialized if @p type cannot be used for shards.
+*/
+static ion_err_t
+sharded_init_handler(
+	ion_dictionary_type_t		type,
+	ion_dictionary_handler_t	*handler
+) {
+	switch (type) {
+		case dictionary_type_bpp_tree_t: {
+			bpptree_init(handler);
+			break;
+		}
+
+		case dictionary_type_flat_file_t: {
+			ffdict_init(handler);
+			break;
+		}
+
+		case dictionary_type_open_address_file_hash_t: {
+			oafdict_init(handler);
+			break;
+		}
+
+		case dictionary_type_open_address_hash_t: {
+			oadict_init(handler);
+			break;
+		}
+
+		case dictionary_type_skip_list_t: {
+			sldict_init(handler);
+			break;
+		}
+
+		case dictionary_type_linear_hash_t: {
+			linear_hash_dict_init(handler);
+			break;
+		}
+
+		case dictionary_type_lsm_t: {
+			lsmdict_init(handler);
+			break;
+		}
+
+		case dictionary_type_concurrent_skip_list_t: {
+			csldict_init(handler);
+			break;
+		}
+
+		default: {
+			return err_uninitialized;
+		}
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Writes the manifest of a sharded dictionary.
+@param[in]	sharded
+				The sharded dictionary whose shards to record.
+@return		The status of the write.
+*/
+static ion_err_t
+sharded_write_manifest(
+	ion_sharded_t *sharded
+) {
+	ion_sharded_manifest_t	manifest;
+	char					filename[ION_MAX_FILENAME_LENGTH];
+
+	memset(&manifest, 0, sizeof(manifest));
+	manifest.magic		= ION_SHARDED_MANIFEST_MAGIC;
+	manifest.shard_type = sharded->shard_type;
+	manifest.num_shards = sharded->num_shards;
+
+	dictionary_get_filename(sharded->super.id, ION_SHARDED_MANIFEST_EXTENSION, filename);
+
+	/* Opening never truncates, so clear out any manifest left by an earlier dictionary. */
+	if (ion_fexists(filename)) {
+		ion_fremove(filename);
+	}
+
+	ion_file_handle_t file = ion_fopen(filename);
+
+	if (ION_FILE_IS_NULL(file)) {
+		return err_file_open_error;
+	}
+
+#if ION_FILE_STATS
+	ion_file_set_owner(file, sharded->super.id);
+#endif
+
+	ion_err_t err = ion_fwrite(file, sizeof(manifest), (ion_byte_t *) &manifest);
+
+	if ((err_ok != ion_fclose(file)) && (err_ok == err)) {
+		err = err_file_close_error;
+	}
+
+	return err;
+}
+
+/**
+@brief		Reads the manifest of a sharded dictionary.
+@param[in]	id
+				The ID of the sharded dictionary.
+@param[out]	manifest
+				Where to read the manifest to.
+@return		The status of the read.
+*/
+static ion_err_t
+sharded_read_manifest(
+	ion_dictionary_id_t		id,
+	ion_sharded_manifest_t	*manifest
+) {
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(id, ION_SHARDED_MANIFEST_EXTENSION, filename);
+
+	if (!ion_fexists(filename)) {
+		return err_file_open_error;
+	}
+
+	ion_file_handle_t file = ion_fopen(filename);
+
+	if (ION_FILE_IS_NULL(file)) {
+		return err_file_open_error;
+	}
+
+	ion_err_t err = ion_fread(file, sizeof(*manifest), (ion_byte_t *) manifest);
+
+	ion_fclose(file);
+
+	if ((err_ok != err) || (ION_SHARDED_MANIFEST_MAGIC != manifest->magic) || (0 == manifest->num_shards) || (manifest->num_shards > ION_SHARDED_MAX_SHARDS)) {
+		return err_file_read_error;
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Runs one operation of a batch on its shard.
+@param[in]	shard
+				The shard the key of the operation belongs to.
+@param[in]	op
+				The operation to run.
+@return		The result of the operation.
+*/
+static ion_status_t
+sharded_run_op(
+	ion_dictionary_t	*shard,
+	ion_sharded_op_t	*op
+) {
+	switch (op->type) {
+		case ion_sharded_op_insert: {
+			return dictionary_insert(shard, op->key, op->value);
+		}
+
+		case ion_sharded_op_get: {
+			return dictionary_get(shard, op->key, op->value);
+		}
+
+		case ion_sharded_op_update: {
+			return dictionary_update(shard, op->key, op->value);
+		}
+
+		case ion_sharded_op_delete: {
+			return dictionary_delete(shard, op->key);
+		}
+	}
+
+	return ION_STATUS_ERROR(err_not_implemented);
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Runs the operations handed to a worker, until it is stopped.
+@param[in]	argument
+				The worker.
+*/
+static void *
+sharded_worker_run(
+	void *argument
+) {
+	ion_sharded_worker_t	*worker = argument;
+	ion_dictionary_t		*shard	= &worker->sharded->shards[worker->shard];
+	int						i;
+
+	ION_MUTEX_LOCK(worker->lock);
+
+	while (boolean_true) {
+		while (!worker->pending && !worker->stopping) {
+			ION_COND_WAIT(worker->signal, worker->lock);
+		}
+
+		if (!worker->pending) {
+			break;
+		}
+
+		/* The batch is left alone until the worker is done with it. */
+		ION_MUTEX_UNLOCK(worker->lock);
+
+		for (i = 0; i < worker->num_ops; i++) {
+			if (worker->shard == worker->ops[i].shard) {
+				worker->ops[i].status = sharded_run_op(shard, &worker->ops[i]);
+			}
+		}
+
+		ION_MUTEX_LOCK(worker->lock);
+		worker->pending = boolean_false;
+		ION_COND_BROADCAST(worker->signal);
+	}
+
+	ION_MUTEX_UNLOCK(worker->lock);
+
+	return NULL;
+}
+
+/**
+@brief		Stops the first @p num_workers workers and waits for them to exit.
+*/
+static void
+sharded_stop_workers(
+	ion_sharded_t	*sharded,
+	int				num_workers
+) {
+	int i;
+
+	for (i = 0; i < num_workers; i++) {
+		ion_sharded_worker_t *worker = &sharded->workers[i];
+
+		ION_MUTEX_LOCK(worker->lock);
+		worker->stopping = boolean_true;
+		ION_COND_BROADCAST(worker->signal);
+		ION_MUTEX_UNLOCK(worker->lock);
+
+		pthread_join(worker->thread, NULL);
+
+		ION_COND_DESTROY(worker->signal);
+		ION_MUTEX_DESTROY(worker->lock);
+	}
+
+	ION_MUTEX_DESTROY(sharded->batch_lock);
+}
+
+/**
+@brief		Starts one worker per shard.
+*/
+static ion_err_t
+sharded_start_workers(
+	ion_sharded_t *sharded
+) {
+	int i;
+
+	ION_MUTEX_INIT(sharded->batch_lock);
+
+	for (i = 0; i < sharded->num_shards; i++) {
+		ion_sharded_worker_t *worker = &sharded->workers[i];
+
+		worker->sharded		= sharded;
+		worker->shard		= i;
+		worker->ops			= NULL;
+		worker->num_ops		= 0;
+		worker->pending		= boolean_false;
+		worker->stopping	= boolean_false;
+
+		ION_MUTEX_INIT(worker->lock);
+		ION_COND_INIT(worker->signal);
+
+		if (0 != pthread_create(&worker->thread, NULL, sharded_worker_run, worker)) {
+			ION_COND_DESTROY(worker->signal);
+			ION_MUTEX_DESTROY(worker->lock);
+			sharded_stop_workers(sharded, i);
+			return err_out_of_memory;
+		}
+	}
+
+	return err_ok;
+}
+
+#else /* Clause ION_THREAD_SAFE */
+
+#define sharded_start_workers(sharded)				(err_ok)
+#define sharded_stop_workers(sharded, num_workers)
+
+#endif /* Clause ION_THREAD_SAFE */
+
+ion_err_t
+sharded_initialize(
+	ion_sharded_t			*sharded,
+	ion_dictionary_id_t		id,
+	ion_dictionary_type_t	shard_type,
+	int						num_shards,
+	ion_key_type_t			key_type,
+	ion_key_size_t			key_size,
+	ion_value_size_t		value_size,
+	ion_dictionary_size_t	dictionary_size
+) {
+	char		filename[ION_MAX_FILENAME_LENGTH];
+	ion_err_t	err;
+	int			i;
+
+	if ((num_shards < 1) || (num_shards > ION_SHARDED_MAX_SHARDS)) {
+		return err_invalid_initial_size;
+	}
+
+	if (err_ok != sharded_init_handler(shard_type, &sharded->shard_handler)) {
+		return err_uninitialized;
+	}
+
+	if (dictionary_get_filename(sharded_shard_id(id, ION_SHARDED_MAX_SHARDS - 1), "ffs", filename) >= ION_MAX_FILENAME_LENGTH) {
+		/* The ID is too large for the shard file names to fit. */
+		return err_uninitialized;
+	}
+
+	sharded->super.id				= id;
+	sharded->super.key_type			= key_type;
+	sharded->super.record.key_size	= key_size;
+	sharded->super.record.value_size = value_size;
+	sharded->shard_type				= shard_type;
+	sharded->num_shards				= num_shards;
+
+	for (i = 0; i < num_shards; i++) {
+		err = dictionary_create(&sharded->shard_handler, &sharded->shards[i], sharded_shard_id(id, i), key_type, key_size, value_size, dictionary_size);
+
+		if (err_ok != err) {
+			goto CLEANUP;
+		}
+	}
+
+	err = sharded_write_manifest(sharded);
+
+	if (err_ok == err) {
+		err = sharded_start_workers(sharded);
+	}
+
+	if (err_ok == err) {
+		return err_ok;
+	}
+
+	dictionary_get_filename(id, ION_SHARDED_MANIFEST_EXTENSION, filename);
+
+	if (ion_fexists(filename)) {
+		ion_fremove(filename);
+	}
+
+CLEANUP:
+
+	while (--i >= 0) {
+		dictionary_delete_dictionary(&sharded->shards[i]);
+	}
+
+	return err;
+}
+
+ion_err_t
+sharded_open(
+	ion_sharded_t			*sharded,
+	ion_dictionary_id_t		id,
+	ion_key_type_t			key_type,
+	ion_key_size_t			key_size,
+	ion_value_size_t		value_size,
+	ion_dictionary_size_t	dictionary_size
+) {
+	ion_sharded_manifest_t	manifest;
+	ion_err_t				err;
+	int						i;
+
+	err = sharded_read_manifest(id, &manifest);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	if (err_ok != sharded_init_handler(manifest.shard_type, &sharded->shard_handler)) {
+		return err_file_read_error;
+	}
+
+	sharded->super.id				= id;
+	sharded->super.key_type			= key_type;
+	sharded->super.record.key_size	= key_size;
+	sharded->super.record.value_size = value_size;
+	sharded->shard_type				= manifest.shard_type;
+	sharded->num_shards				= manifest.num_shards;
+
+	for (i = 0; i < sharded->num_shards; i++) {
+		ion_dictionary_config_info_t config = {
+			sharded_shard_id(id, i), 0, key_type, key_size, value_size, dictionary_size, sharded->shard_type, ion_dictionary_status_ok
+		};
+
+		err = dictionary_open(&sharded->shard_handler, &sharded->shards[i], &config);
+
+		if (err_ok != err) {
+			break;
+		}
+	}
+
+	if (err_ok == err) {
+		err = sharded_start_workers(sharded);
+	}
+
+	if (err_ok != err) {
+		while (--i >= 0) {
+			dictionary_close(&sharded->shards[i]);
+		}
+	}
+
+	return err;
+}
+
+ion_err_t
+sharded_close(
+	ion_sharded_t *sharded
+) {
+	ion_err_t	err = err_ok;
+	int			i;
+
+	sharded_stop_workers(sharded, sharded->num_shards);
+
+	for (i = 0; i < sharded->num_shards; i++) {
+		ion_err_t close_err = dictionary_close(&sharded->shards[i]);
+
+		if (err_ok == err) {
+			err = close_err;
+		}
+	}
+
+	return err;
+}
+
+ion_err_t
+sharded_destroy(
+	ion_sharded_t *sharded
+) {
+	ion_err_t	err = err_ok;
+	int			i;
+
+	sharded_stop_workers(sharded, sharded->num_shards);
+
+	for (i = 0; i < sharded->num_shards; i++) {
+		ion_err_t delete_err = dictionary_delete_dictionary(&sharded->shards[i]);
+
+		if (err_ok == err) {
+			err = delete_err;
+		}
+	}
+
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(sharded->super.id, ION_SHARDED_MANIFEST_EXTENSION, filename);
+
+	if ((err_ok != ion_fremove(filename)) && (err_ok == err)) {
+		err = err_file_delete_error;
+	}
+
+	return err;
+}
+
+ion_err_t
+sharded_remove_files(
+	ion_dictionary_id_t id
+) {
+	ion_sharded_manifest_t		manifest;
+	ion_dictionary_handler_t	handler;
+	ion_err_t					err;
+	int							i;
+
+	err = sharded_read_manifest(id, &manifest);
+
+	if (err_ok != err) {
+		return err;
+	}
+
+	if (err_ok != sharded_init_handler(manifest.shard_type, &handler)) {
+		return err_file_read_error;
+	}
+
+	for (i = 0; i < manifest.num_shards; i++) {
+		ion_err_t remove_err = dictionary_destroy_dictionary(&handler, sharded_shard_id(id, i));
+
+		if (err_ok == err) {
+			err = remove_err;
+		}
+	}
+
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(id, ION_SHARDED_MANIFEST_EXTENSION, filename);
+
+	if ((err_ok != ion_fremove(filename)) && (err_ok == err)) {
+		err = err_file_delete_error;
+	}
+
+	return err;
+}
+
+int
+sharded_shard_of(
+	ion_sharded_t	*sharded,
+	ion_key_t		key
+) {
+	ion_byte_t		*bytes	= (ion_byte_t *) key;
+	ion_key_size_t	length	= sharded->super.record.key_size;
+	uint32_t		hash	= 2166136261u;
+	ion_key_size_t	i;
+
+	/* String keys compare equal up to their first null byte, so equal keys
+	   must hash the same whatever follows it. */
+	if ((key_type_char_array == sharded->super.key_type) || (key_type_null_terminated_string == sharded->super.key_type)) {
+		length = 0;
+
+		while (length < sharded->super.record.key_size && '\0' != bytes[length]) {
+			length++;
+		}
+	}
+
+	/* FNV-1a over the significant key bytes, then the murmur3 finalizer, so
+	   that keys that only differ in their high bytes still spread out. */
+	for (i = 0; i < length; i++) {
+		hash	^= bytes[i];
+		hash	*= 16777619u;
+	}
+
+	hash	^= hash >> 16;
+	hash	*= 0x85ebca6bu;
+	hash	^= hash >> 13;
+	hash	*= 0xc2b2ae35u;
+	hash	^= hash >> 16;
+
+	return hash % sharded->num_shards;
+}
+
+ion_status_t
+sharded_insert(
+	ion_sharded_t	*sharded,
+	ion_key_t		key,
+	ion_value_t		value
+) {
+	return dictionary_insert(&sharded->shards[sharded_shard_of(sharded, key)], key, value);
+}
+
+ion_status_t
+sharded_get(
+	ion_sharded_t	*sharded,
+	ion_key_t		key,
+	ion_value_t		value
+) {
+	return dictionary_get(&sharded->shards[sharded_shard_of(sharded, key)], key, value);
+}
+
+ion_status_t
+sharded_update(
+	ion_sharded_t	*sharded,
+	ion_key_t		key,
+	ion_value_t		value
+) {
+	return dictionary_update(&sharded->shards[sharded_shard_of(sharded, key)], key, value);
+}
+
+ion_status_t
+sharded_delete(
+	ion_sharded_t	*sharded,
+	ion_key_t		key
+) {
+	return dictionary_delete(&sharded->shards[sharded_shard_of(sharded, key)], key);
+}
+
+ion_err_t
+sharded_execute(
+	ion_sharded_t		*sharded,
+	ion_sharded_op_t	*ops,
+	int					num_ops
+) {
+	int i;
+
+	for (i = 0; i < num_ops; i++) {
+		ops[i].shard = sharded_shard_of(sharded, ops[i].key);
+	}
+
+#if ION_THREAD_SAFE
+	ion_boolean_t	busy[ION_SHARDED_MAX_SHARDS];
+	int				shard;
+
+	memset(busy, 0, sizeof(busy));
+
+	for (i = 0; i < num_ops; i++) {
+		busy[ops[i].shard] = boolean_true;
+	}
+
+	/* Each worker only has room for one batch. */
+	ION_MUTEX_LOCK(sharded->batch_lock);
+
+	for (shard = 0; shard < sharded->num_shards; shard++) {
+		if (busy[shard]) {
+			ion_sharded_worker_t *worker = &sharded->workers[shard];
+
+			ION_MUTEX_LOCK(worker->lock);
+			worker->ops		= ops;
+			worker->num_ops = num_ops;
+			worker->pending = boolean_true;
+			ION_COND_BROADCAST(worker->signal);
+			ION_MUTEX_UNLOCK(worker->lock);
+		}
+	}
+
+	for (shard = 0; shard < sharded->num_shards; shard++) {
+		if (busy[shard]) {
+			ion_sharded_worker_t *worker = &sharded->workers[shard];
+
+			ION_MUTEX_LOCK(worker->lock);
+
+			while (worker->pending) {
+				ION_COND_WAIT(worker->signal, worker->lock);
+			}
+
+			ION_MUTEX_UNLOCK(worker->lock);
+		}
+	}
+
+	ION_MUTEX_UNLOCK(sharded->batch_lock);
+#else
+
+	for (i = 0; i < num_ops; i++) {
+		ops[i].status = sharded_run_op(&sharded->shards[ops[i].shard], &ops[i]);
+	}
+
+#endif
+	return err_ok;
+}
+
+ion_err_t
+sharded_sync(
+	ion_sharded_t *sharded
+) {
+	ion_err_t	err;
+	int			i;
+
+	if (NULL == sharded->shard_handler.sync_dictionary) {
+		return err_not_implemented;
+	}
+
+	for (i = 0; i < sharded->num_shards; i++) {
+		ION_RWLOCK_WRITE(sharded->shards[i].lock);
+		err = sharded->shard_handler.sync_dictionary(&sharded->shards[i]);
+		ION_RWLOCK_UNLOCK(sharded->shards[i].lock);
+
+		if (err_ok != err) {
+			return err;
+		}
+	}
+
+	return err_ok;
+}
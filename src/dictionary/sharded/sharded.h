@@ -0,0 +1,257 @@
+/******************************************************************************/
+/**
+@file		sharded.h
+@author		IonDB Project
+@brief		Interface of the sharded dictionary.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(SHARDED_H_)
+#define SHARDED_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "sharded_types.h"
+
+/**
+@brief		Initializes a sharded dictionary with new, empty shards.
+@details	The comparison function in @p sharded must be set before this is called.
+@param[in]	sharded
+				The sharded dictionary to initialize.
+@param[in]	id
+				The ID of the sharded dictionary, which names its manifest and
+				its shards.
+@param[in]	shard_type
+				The type of every shard. Shards cannot be sharded themselves.
+@param[in]	num_shards
+				How many shards to spread the keys over, at most
+				@ref ION_SHARDED_MAX_SHARDS.
+@param[in]	key_type
+				Key category to use for this instance.
+@param[in]	key_size
+				Key size, in bytes used for this instance.
+@param[in]	value_size
+				Value size, in bytes used for this instance.
+@param[in]	dictionary_size
+				The dictionary size given to each shard.
+@return		The status of initialization.
+*/
+ion_err_t
+sharded_initialize(
+	ion_sharded_t			*sharded,
+	ion_dictionary_id_t		id,
+	ion_dictionary_type_t	shard_type,
+	int						num_shards,
+	ion_key_type_t			key_type,
+	ion_key_size_t			key_size,
+	ion_value_size_t		value_size,
+	ion_dictionary_size_t	dictionary_size
+);
+
+/**
+@brief		Reopens the shards of a sharded dictionary, as listed in its manifest.
+@details	The comparison function in @p sharded must be set before this is called.
+@param[in]	sharded
+				The sharded dictionary to open.
+@param[in]	id
+				The ID of the sharded dictionary.
+@param[in]	key_type
+				Key category of the dictionary.
+@param[in]	key_size
+				Key size of the dictionary, in bytes.
+@param[in]	value_size
+				Value size of the dictionary, in bytes.
+@param[in]	dictionary_size
+				The dictionary size given to each shard.
+@return		The status of the open.
+*/
+ion_err_t
+sharded_open(
+	ion_sharded_t			*sharded,
+	ion_dictionary_id_t		id,
+	ion_key_type_t			key_type,
+	ion_key_size_t			key_size,
+	ion_value_size_t		value_size,
+	ion_dictionary_size_t	dictionary_size
+);
+
+/**
+@brief		Closes every shard.
+@param[in]	sharded
+				The sharded dictionary to close.
+@return		The status of closing. Every shard is closed even on failure.
+*/
+ion_err_t
+sharded_close(
+	ion_sharded_t *sharded
+);
+
+/**
+@brief		Deletes every shard, and the manifest.
+@param[in]	sharded
+				The sharded dictionary to destroy.
+@return		The status of destruction.
+*/
+ion_err_t
+sharded_destroy(
+	ion_sharded_t *sharded
+);
+
+/**
+@brief		Removes all of the files of a closed sharded dictionary.
+@param[in]	id
+				The ID of the sharded dictionary.
+@return		The status of the removal.
+*/
+ion_err_t
+sharded_remove_files(
+	ion_dictionary_id_t id
+);
+
+/**
+@brief		Finds the shard a key belongs to.
+@param[in]	sharded
+				The sharded dictionary.
+@param[in]	key
+				The key to look up.
+@return		The index of the shard.
+*/
+int
+sharded_shard_of(
+	ion_sharded_t	*sharded,
+	ion_key_t		key
+);
+
+/**
+@brief		Inserts a record into the shard of its key.
+@param[in]	sharded
+				The sharded dictionary to insert into.
+@param[in]	key
+				Key portion of the record to insert.
+@param[in]	value
+				Value portion of the record to insert.
+@return		Resulting status of insertion.
+*/
+ion_status_t
+sharded_insert(
+	ion_sharded_t	*sharded,
+	ion_key_t		key,
+	ion_value_t		value
+);
+
+/**
+@brief		Fetches the value stored with the given @p key from its shard.
+@param[in]	sharded
+				The sharded dictionary to look in.
+@param[in]	key
+				Specified key to look for.
+@param[out]	value
+				Where to write the value.
+@return		Resulting status of the operation.
+*/
+ion_status_t
+sharded_get(
+	ion_sharded_t	*sharded,
+	ion_key_t		key,
+	ion_value_t		value
+);
+
+/**
+@brief		Updates the value stored with the given @p key in its shard.
+@param[in]	sharded
+				The sharded dictionary to update.
+@param[in]	key
+				Specified key to update.
+@param[in]	value
+				The new value.
+@return		Resulting status of the operation.
+*/
+ion_status_t
+sharded_update(
+	ion_sharded_t	*sharded,
+	ion_key_t		key,
+	ion_value_t		value
+);
+
+/**
+@brief		Deletes the given @p key from its shard.
+@param[in]	sharded
+				The sharded dictionary to delete from.
+@param[in]	key
+				Specified key to delete.
+@return		Resulting status of the operation.
+*/
+ion_status_t
+sharded_delete(
+	ion_sharded_t	*sharded,
+	ion_key_t		key
+);
+
+/**
+@brief		Runs a batch of operations, each shard's share in parallel with
+			the others in thread-safe builds.
+@details	The operations on one shard run in the order they appear in the
+			batch, so operations on the same key keep their order. The
+			result of each operation is written to its @c status.
+@param[in]	sharded
+				The sharded dictionary to work on.
+@param[in]	ops
+				The operations to run.
+@param[in]	num_ops
+				How many operations there are.
+@return		@ref err_ok once every operation has run, whatever its result.
+*/
+ion_err_t
+sharded_execute(
+	ion_sharded_t		*sharded,
+	ion_sharded_op_t	*ops,
+	int					num_ops
+);
+
+/**
+@brief		Forces every change made so far to every shard to the device.
+@param[in]	sharded
+				The sharded dictionary to sync.
+@return		Resulting status of the operation, @ref err_not_implemented if
+			the shards keep their records in memory.
+*/
+ion_err_t
+sharded_sync(
+	ion_sharded_t *sharded
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* SHARDED_H_ */
@@ -0,0 +1,470 @@
+/******************************************************************************/
+/**
+@file		sharded_handler.c
+@author		IonDB Project
+@brief		The handler for the sharded dictionary.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "sharded_handler.h"
+
+/**
+@brief		The type of the shards of sharded dictionaries created from now on.
+*/
+static ion_dictionary_type_t sharddict_shard_type	= ION_SHARDED_DEFAULT_TYPE;
+
+/**
+@brief		How many shards sharded dictionaries created from now on have.
+*/
+static int sharddict_num_shards						= ION_SHARDED_DEFAULT_SHARDS;
+
+/**
+@brief		Moves a cursor source on to the next record of its shard, ending
+			the shard's cursor once it runs out.
+@param[in]	source
+				The source to advance.
+@return		Whether the shard's cursor is still in a good state.
+*/
+static ion_boolean_t
+sharddict_source_advance(
+	ion_sharded_cursor_source_t *source
+) {
+	ion_cursor_status_t status = source->cursor->next(source->cursor, &source->record);
+
+	if ((cs_cursor_active == status) || (cs_cursor_initialized == status)) {
+		return boolean_true;
+	}
+
+	/* Let go of the shard as soon as possible, so writers can get at it. */
+	source->cursor->destroy(&source->cursor);
+	source->cursor = NULL;
+
+	/* A shard that found nothing to position its cursor on has no records to give. */
+	return (cs_end_of_results == status) || (cs_cursor_uninitialized == status);
+}
+
+/**
+@brief			Fetches the next record to be returned from a cursor that has already been initialized.
+@details		This function should not be called directly, but instead will be bound to the cursor like a method.
+@param[in]		cursor
+					Which cursor to fetch results from.
+@param[out]		record
+					An initialized record struct with the @p key and @p value appropriately allocated to fit
+					the returned key and value. This function will write back data to the struct.
+@return			The resulting status of the operation.
+*/
+static ion_cursor_status_t
+sharddict_next(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*record
+) {
+	ion_sharded_cursor_t	*sharded_cursor = (ion_sharded_cursor_t *) cursor;
+	ion_dictionary_parent_t *parent			= cursor->dictionary->instance;
+	int						winner			= -1;
+	int						i;
+
+	if ((cursor->status != cs_cursor_initialized) && (cursor->status != cs_cursor_active)) {
+		return cursor->status;
+	}
+
+	for (i = 0; i < sharded_cursor->num_sources; i++) {
+		if ((NULL != sharded_cursor->sources[i].cursor) && ((-1 == winner) || (parent->compare(sharded_cursor->sources[i].record.key, sharded_cursor->sources[winner].record.key, parent->record.key_size) < 0))) {
+			winner = i;
+		}
+	}
+
+	if (-1 == winner) {
+		cursor->status = cs_end_of_results;
+		return cursor->status;
+	}
+
+	ion_sharded_cursor_source_t *source = &sharded_cursor->sources[winner];
+
+	memcpy(record->key, source->record.key, parent->record.key_size);
+	memcpy(record->value, source->record.value, parent->record.value_size);
+
+	if (!sharddict_source_advance(source)) {
+		cursor->status = cs_possible_data_inconsistency;
+		return cursor->status;
+	}
+
+	cursor->status = cs_cursor_active;
+	return cursor->status;
+}
+
+/**
+@brief		Destroys the cursor, the cursors over its shards and its copy of the predicate.
+@param[in]	cursor
+				Which cursor to destroy.
+*/
+static void
+sharddict_destroy_cursor(
+	ion_dict_cursor_t **cursor
+) {
+	ion_sharded_cursor_t	*sharded_cursor = (ion_sharded_cursor_t *) (*cursor);
+	int						i;
+
+	for (i = 0; i < sharded_cursor->num_sources; i++) {
+		if (NULL != sharded_cursor->sources[i].cursor) {
+			sharded_cursor->sources[i].cursor->destroy(&sharded_cursor->sources[i].cursor);
+		}
+	}
+
+	(*cursor)->predicate->destroy(&(*cursor)->predicate);
+	free(*cursor);
+	*cursor = NULL;
+}
+
+ion_err_t
+sharddict_find(
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	ion_dict_cursor_t	**cursor
+) {
+	ion_sharded_t		*sharded		= (ion_sharded_t *) dictionary->instance;
+	ion_key_size_t		key_size		= dictionary->instance->record.key_size;
+	ion_value_size_t	value_size		= dictionary->instance->record.value_size;
+	int					first_shard		= 0;
+	int					num_sources		= sharded->num_shards;
+	int					i;
+
+	/* Only one shard can hold a key. */
+	if (predicate_equality == predicate->type) {
+		first_shard = sharded_shard_of(sharded, predicate->statement.equality.equality_value);
+		num_sources = 1;
+	}
+
+	/* The sources and their copies of the current record are allocated along with the cursor. */
+	*cursor = malloc(sizeof(ion_sharded_cursor_t) + num_sources * (sizeof(ion_sharded_cursor_source_t) + key_size + value_size));
+
+	if (NULL == *cursor) {
+		return err_out_of_memory;
+	}
+
+	ion_sharded_cursor_t *sharded_cursor = (ion_sharded_cursor_t *) (*cursor);
+
+	(*cursor)->dictionary	= dictionary;
+	(*cursor)->status		= cs_cursor_uninitialized;
+
+	(*cursor)->destroy		= sharddict_destroy_cursor;
+	(*cursor)->next			= sharddict_next;
+	(*cursor)->next_batch	= NULL;
+
+	(*cursor)->predicate	= malloc(sizeof(ion_predicate_t));
+
+	if (NULL == (*cursor)->predicate) {
+		free(*cursor);
+		return err_out_of_memory;
+	}
+
+	(*cursor)->predicate->type		= predicate->type;
+	(*cursor)->predicate->destroy	= predicate->destroy;
+
+	switch (predicate->type) {
+		case predicate_equality: {
+			(*cursor)->predicate->statement.equality.equality_value = malloc(key_size);
+
+			if (NULL == (*cursor)->predicate->statement.equality.equality_value) {
+				free((*cursor)->predicate);
+				free(*cursor);
+				return err_out_of_memory;
+			}
+
+			memcpy((*cursor)->predicate->statement.equality.equality_value, predicate->statement.equality.equality_value, key_size);
+			break;
+		}
+
+		case predicate_range: {
+			(*cursor)->predicate->statement.range.lower_bound = malloc(key_size);
+
+			if (NULL == (*cursor)->predicate->statement.range.lower_bound) {
+				free((*cursor)->predicate);
+				free(*cursor);
+				return err_out_of_memory;
+			}
+
+			memcpy((*cursor)->predicate->statement.range.lower_bound, predicate->statement.range.lower_bound, key_size);
+
+			(*cursor)->predicate->statement.range.upper_bound = malloc(key_size);
+
+			if (NULL == (*cursor)->predicate->statement.range.upper_bound) {
+				free((*cursor)->predicate->statement.range.lower_bound);
+				free((*cursor)->predicate);
+				free(*cursor);
+				return err_out_of_memory;
+			}
+
+			memcpy((*cursor)->predicate->statement.range.upper_bound, predicate->statement.range.upper_bound, key_size);
+			break;
+		}
+
+		case predicate_all_records:
+		case predicate_predicate: {
+			break;
+		}
+
+		default: {
+			free((*cursor)->predicate);
+			free(*cursor);
+			*cursor = NULL;
+			return err_invalid_predicate;
+		}
+	}
+
+	ion_byte_t *record_memory = (ion_byte_t *) (sharded_cursor + 1) + num_sources * sizeof(ion_sharded_cursor_source_t);
+
+	sharded_cursor->sources		= (ion_sharded_cursor_source_t *) (sharded_cursor + 1);
+	sharded_cursor->num_sources = num_sources;
+
+	for (i = 0; i < num_sources; i++) {
+		sharded_cursor->sources[i].cursor		= NULL;
+		sharded_cursor->sources[i].record.key	= record_memory + i * (key_size + value_size);
+		sharded_cursor->sources[i].record.value = (ion_byte_t *) sharded_cursor->sources[i].record.key + key_size;
+	}
+
+	(*cursor)->status = cs_end_of_results;
+
+	for (i = 0; i < num_sources; i++) {
+		ion_sharded_cursor_source_t *source = &sharded_cursor->sources[i];
+		ion_err_t					err		= dictionary_find(&sharded->shards[first_shard + i], predicate, &source->cursor);
+
+		if (err_ok != err) {
+			source->cursor = NULL;
+			sharddict_destroy_cursor(cursor);
+			return err;
+		}
+
+		if (!sharddict_source_advance(source)) {
+			(*cursor)->status = cs_possible_data_inconsistency;
+		}
+		else if ((NULL != source->cursor) && (cs_end_of_results == (*cursor)->status)) {
+			(*cursor)->status = cs_cursor_initialized;
+		}
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+sharddict_open_dictionary(
+	ion_dictionary_handler_t		*handler,
+	ion_dictionary_t				*dictionary,
+	ion_dictionary_config_info_t	*config,
+	ion_dictionary_compare_t		compare
+) {
+	dictionary->instance = malloc(sizeof(ion_sharded_t));
+
+	if (NULL == dictionary->instance) {
+		return err_out_of_memory;
+	}
+
+	dictionary->instance->compare	= compare;
+	dictionary->instance->type		= dictionary_type_sharded_t;
+
+	ion_err_t result = sharded_open((ion_sharded_t *) dictionary->instance, config->id, config->type, config->key_size, config->value_size, config->dictionary_size);
+
+	if (err_ok != result) {
+		free(dictionary->instance);
+		dictionary->instance = NULL;
+		return result;
+	}
+
+	dictionary->handler = handler;
+
+	return err_ok;
+}
+
+ion_err_t
+sharddict_close_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	ion_err_t err = sharded_close((ion_sharded_t *) dictionary->instance);
+
+	free(dictionary->instance);
+	dictionary->instance = NULL;
+
+	return err;
+}
+
+ion_err_t
+sharddict_sync_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	return sharded_sync((ion_sharded_t *) dictionary->instance);
+}
+
+void
+sharddict_init(
+	ion_dictionary_handler_t *handler
+) {
+	handler->insert				= sharddict_insert;
+	handler->create_dictionary	= sharddict_create_dictionary;
+	handler->get				= sharddict_get;
+	handler->update				= sharddict_update;
+	handler->find				= sharddict_find;
+	handler->remove				= sharddict_delete;
+	handler->delete_dictionary	= sharddict_delete_dictionary;
+	handler->destroy_dictionary = sharddict_destroy_dictionary;
+	handler->open_dictionary	= sharddict_open_dictionary;
+	handler->close_dictionary	= sharddict_close_dictionary;
+	handler->sync_dictionary	= sharddict_sync_dictionary;
+	handler->scan_extent		= NULL;
+	handler->scan_range			= NULL;
+	handler->get_many			= NULL;
+	handler->concurrent			= boolean_true;	/* Each shard locks itself. */
+}
+
+ion_err_t
+sharddict_configure(
+	ion_dictionary_type_t	shard_type,
+	int						num_shards
+) {
+	if ((num_shards < 1) || (num_shards > ION_SHARDED_MAX_SHARDS)) {
+		return err_invalid_initial_size;
+	}
+
+	if ((dictionary_type_sharded_t == shard_type) || (dictionary_type_error_t == shard_type)) {
+		return err_uninitialized;
+	}
+
+	sharddict_shard_type	= shard_type;
+	sharddict_num_shards	= num_shards;
+
+	return err_ok;
+}
+
+ion_err_t
+sharddict_execute(
+	ion_dictionary_t	*dictionary,
+	ion_sharded_op_t	*ops,
+	int					num_ops
+) {
+	if ((NULL != dictionary->wal) || (NULL != dictionary->bloom_filter)) {
+		return err_not_implemented;
+	}
+
+	/* Writers share the dictionary, the shards lock themselves. */
+	ION_RWLOCK_READ(dictionary->lock);
+
+	ion_err_t err = sharded_execute((ion_sharded_t *) dictionary->instance, ops, num_ops);
+
+	ION_RWLOCK_UNLOCK(dictionary->lock);
+
+	return err;
+}
+
+ion_status_t
+sharddict_insert(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	return sharded_insert((ion_sharded_t *) dictionary->instance, key, value);
+}
+
+ion_status_t
+sharddict_get(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	return sharded_get((ion_sharded_t *) dictionary->instance, key, value);
+}
+
+ion_err_t
+sharddict_create_dictionary(
+	ion_dictionary_id_t			id,
+	ion_key_type_t				key_type,
+	ion_key_size_t				key_size,
+	ion_value_size_t			value_size,
+	ion_dictionary_size_t		dictionary_size,
+	ion_dictionary_compare_t	compare,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_t			*dictionary
+) {
+	dictionary->instance = malloc(sizeof(ion_sharded_t));
+
+	if (NULL == dictionary->instance) {
+		return err_out_of_memory;
+	}
+
+	dictionary->instance->compare	= compare;
+	dictionary->instance->type		= dictionary_type_sharded_t;
+
+	ion_err_t result = sharded_initialize((ion_sharded_t *) dictionary->instance, id, sharddict_shard_type, sharddict_num_shards, key_type, key_size, value_size, dictionary_size);
+
+	if (err_ok != result) {
+		free(dictionary->instance);
+		dictionary->instance = NULL;
+		return result;
+	}
+
+	if (NULL != handler) {
+		dictionary->handler = handler;
+	}
+
+	return err_ok;
+}
+
+ion_status_t
+sharddict_delete(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key
+) {
+	return sharded_delete((ion_sharded_t *) dictionary->instance, key);
+}
+
+ion_err_t
+sharddict_delete_dictionary(
+	ion_dictionary_t *dictionary
+) {
+	ion_err_t result = sharded_destroy((ion_sharded_t *) dictionary->instance);
+
+	free(dictionary->instance);
+	dictionary->instance = NULL;
+	return result;
+}
+
+ion_err_t
+sharddict_destroy_dictionary(
+	ion_dictionary_id_t id
+) {
+	return sharded_remove_files(id);
+}
+
+ion_status_t
+sharddict_update(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+) {
+	return sharded_update((ion_sharded_t *) dictionary->instance, key, value);
+}
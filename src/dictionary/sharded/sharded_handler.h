@@ -0,0 +1,281 @@
+/******************************************************************************/
+/**
+@file		sharded_handler.h
+@author		IonDB Project
+@brief		The handler for the sharded dictionary.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(SHARDED_HANDLER_H_)
+#define SHARDED_HANDLER_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "sharded_types.h"
+#include "sharded.h"
+
+/**
+@brief		Given the @p handler instance, bind the appropriate sharded dictionary functions.
+@param[in]	handler
+				The handler is assumed to be memory that is allocated and initialized
+				by the user.
+*/
+void
+sharddict_init(
+	ion_dictionary_handler_t *handler
+);
+
+/**
+@brief		Sets the type and the number of shards that sharded dictionaries
+			created from now on are given.
+@param[in]	shard_type
+				The type of every shard. Shards cannot be sharded themselves.
+@param[in]	num_shards
+				How many shards to spread the keys over, at most
+				@ref ION_SHARDED_MAX_SHARDS.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+sharddict_configure(
+	ion_dictionary_type_t	shard_type,
+	int						num_shards
+);
+
+/**
+@brief		Runs a batch of operations on a sharded dictionary, each shard's
+			share on its own worker thread in thread-safe builds.
+@details	Batches go straight to the shards, so they are refused while a
+			write-ahead log or a Bloom filter, which they would bypass, is
+			attached to the dictionary.
+@param[in]	dictionary
+				The initialized dictionary instance to work on.
+@param[in]	ops
+				The operations to run. The result of each is written to its
+				@c status.
+@param[in]	num_ops
+				How many operations there are.
+@return		The resulting status of the operation.
+@see		sharded_execute
+*/
+ion_err_t
+sharddict_execute(
+	ion_dictionary_t	*dictionary,
+	ion_sharded_op_t	*ops,
+	int					num_ops
+);
+
+/**
+@brief		Inserts a record into the shard of its key.
+@param[in]	dictionary
+				The initialized dictionary instance we want to insert into.
+@param[in]	key
+				The key portion of the record to be inserted.
+@param[in]	value
+				The value portion of the record to be inserted.
+@return		The resulting status of the operation.
+*/
+ion_status_t
+sharddict_insert(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+);
+
+/**
+@brief		Fetches the value stored with the given @p key from its shard.
+@param[in]	dictionary
+				The initialized dictionary instance we want to query.
+@param[in]	key
+				The key to look for.
+@param[out]	value
+				Where to write the value. Must be allocated by the caller.
+@return		The resulting status of the operation.
+*/
+ion_status_t
+sharddict_get(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+);
+
+/**
+@brief		Creates a sharded dictionary, with the shards last set by
+			@ref sharddict_configure.
+@param[in]	id
+				The identifier of the dictionary, which names its files.
+@param[in]	key_type
+				The category of key used by the dictionary.
+@param[in]	key_size
+				The size of the keys used for this dictionary, specified in bytes.
+@param[in]	value_size
+				The size of the values used for this dictionary, specified in bytes.
+@param[in]	dictionary_size
+				The dictionary size given to each shard.
+@param[in]	compare
+				Function pointer to the comparison function used by the dictionary.
+@param[in]	handler
+				A bound handler for the sharded dictionary.
+@param[out]	dictionary
+				The dictionary to initialize.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+sharddict_create_dictionary(
+	ion_dictionary_id_t			id,
+	ion_key_type_t				key_type,
+	ion_key_size_t				key_size,
+	ion_value_size_t			value_size,
+	ion_dictionary_size_t		dictionary_size,
+	ion_dictionary_compare_t	compare,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_t			*dictionary
+);
+
+/**
+@brief		Deletes the given @p key from its shard.
+@param[in]	dictionary
+				The initialized dictionary instance we want to delete from.
+@param[in]	key
+				The key to delete.
+@return		The resulting status of the operation.
+*/
+ion_status_t
+sharddict_delete(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key
+);
+
+/**
+@brief		Deletes every shard and removes all of the files of the dictionary.
+@param[in]	dictionary
+				The dictionary to delete.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+sharddict_delete_dictionary(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Removes all of the files of a closed dictionary.
+@param[in]	id
+				The identifier of the dictionary to destroy.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+sharddict_destroy_dictionary(
+	ion_dictionary_id_t id
+);
+
+/**
+@brief		Updates the value stored with the given @p key in its shard.
+@param[in]	dictionary
+				The initialized dictionary instance we want to update.
+@param[in]	key
+				The key to update.
+@param[in]	value
+				The new value.
+@return		The resulting status of the operation.
+*/
+ion_status_t
+sharddict_update(
+	ion_dictionary_t	*dictionary,
+	ion_key_t			key,
+	ion_value_t			value
+);
+
+/**
+@brief		Builds a cursor that merges the records of every shard the
+			predicate can match, smallest key first.
+@param[in]	dictionary
+				Which dictionary to query on.
+@param[in]	predicate
+				An allocated, initialized predicate object that defines the parameters of the query.
+@param[out]	cursor
+				Redirected to point at the allocated cursor.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+sharddict_find(
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	ion_dict_cursor_t	**cursor
+);
+
+/**
+@brief		Reopens a sharded dictionary that was previously closed.
+@param[in]	handler
+				A handler that must be bound with the sharded dictionary's functions.
+@param[in]	dictionary
+				A dictionary that is allocated but not initialized.
+@param[in]	config
+				The configuration parameters the dictionary was created with.
+@param[in]	compare
+				The comparison function for the key type.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+sharddict_open_dictionary(
+	ion_dictionary_handler_t		*handler,
+	ion_dictionary_t				*dictionary,
+	ion_dictionary_config_info_t	*config,
+	ion_dictionary_compare_t		compare
+);
+
+/**
+@brief		Closes every shard, then the dictionary.
+@param[in]	dictionary
+				The dictionary to close.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+sharddict_close_dictionary(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Forces every change made to any shard so far to the device.
+@param[in]	dictionary
+				The dictionary to sync.
+@return		The resulting status of the operation.
+*/
+ion_err_t
+sharddict_sync_dictionary(
+	ion_dictionary_t *dictionary
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* SHARDED_HANDLER_H_ */
@@ -0,0 +1,219 @@
+/******************************************************************************/
+/**
+@file		sharded_types.h
+@author		IonDB Project
+@brief		Types local to the sharded dictionary.
+@details	A sharded dictionary spreads its keys over several inner
+			dictionaries of one type, picked by a hash of the key. Each
+			shard is a full dictionary with its own files, cache and, in
+			thread-safe builds, its own lock, so writers to different
+			shards never wait for each other.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(SHARDED_TYPES_H_)
+#define SHARDED_TYPES_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "../dictionary_types.h"
+#include "../dictionary.h"
+
+#include "../../key_value/kv_system.h"
+
+#if !defined(ION_SHARDED_MAX_SHARDS)
+/**
+@brief		The most shards a sharded dictionary can have.
+*/
+#define ION_SHARDED_MAX_SHARDS		16
+#endif
+
+#if !defined(ION_SHARDED_DEFAULT_SHARDS)
+/**
+@brief		How many shards newly created sharded dictionaries have, unless
+			changed with @ref sharddict_configure.
+*/
+#define ION_SHARDED_DEFAULT_SHARDS	4
+#endif
+
+#if !defined(ION_SHARDED_DEFAULT_TYPE)
+/**
+@brief		The type of the shards of newly created sharded dictionaries,
+			unless changed with @ref sharddict_configure.
+*/
+#define ION_SHARDED_DEFAULT_TYPE	dictionary_type_skip_list_t
+#endif
+
+/**
+@brief		First ID given to shards. The shards of the sharded dictionary
+			with ID @c id are given the IDs @c ION_SHARDED_SHARD_ID_BASE
+			@c + @c id @c * @ref ION_SHARDED_MAX_SHARDS @c + @c shard, which
+			keeps them clear of the IDs handed out by the master table, and
+			low enough that LSM tree shards can still name their runs.
+*/
+#define ION_SHARDED_SHARD_ID_BASE	4000000
+
+/**
+@brief		File extension of the manifest, which records the type and the
+			number of the shards.
+*/
+#define ION_SHARDED_MANIFEST_EXTENSION	"shd"
+
+/**
+@brief		Written at the start of the manifest.
+*/
+#define ION_SHARDED_MANIFEST_MAGIC	0x44524853
+
+/**
+@brief		Layout of the manifest file, written when the dictionary is created.
+*/
+typedef struct {
+	/**> Always @ref ION_SHARDED_MANIFEST_MAGIC. */
+	uint32_t	magic;
+	/**> The @ref ion_dictionary_type_t of every shard. */
+	uint8_t		shard_type;
+	/**> How many shards there are. */
+	uint8_t		num_shards;
+} ion_sharded_manifest_t;
+
+/**
+@brief		The operations a batch can hold.
+*/
+typedef enum {
+	/**> Inserts @c value under @c key. */
+	ion_sharded_op_insert,
+	/**> Reads the value of @c key into @c value. */
+	ion_sharded_op_get,
+	/**> Updates @c key to @c value, inserting it if it is missing. */
+	ion_sharded_op_update,
+	/**> Deletes @c key. */
+	ion_sharded_op_delete
+} ion_sharded_op_type_t;
+
+/**
+@brief		One operation of a batch run by @ref sharded_execute.
+*/
+typedef struct {
+	/**> What to do. */
+	ion_sharded_op_type_t	type;
+	/**> The key to work on. */
+	ion_key_t				key;
+	/**> The value to write, or where to read it to. Unused by deletes. */
+	ion_value_t				value;
+	/**> Set to the result of the operation. */
+	ion_status_t			status;
+	/**> Set to the shard the key belongs to. */
+	int						shard;
+} ion_sharded_op_t;
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		The thread that runs the operations of a batch on one shard.
+*/
+typedef struct {
+	/**> The sharded dictionary the worker belongs to. */
+	struct sharded		*sharded;
+	/**> The shard the worker runs operations on. */
+	int					shard;
+	/**> The thread itself. */
+	pthread_t			thread;
+	/**> Guards the fields below. */
+	ion_mutex_t			lock;
+	/**> Broadcast when work is handed over, when it is finished, and when
+		 the worker is told to stop. */
+	ion_cond_t			signal;
+	/**> The batch being run. The worker only runs the operations on its shard. */
+	ion_sharded_op_t	*ops;
+	/**> How many operations the batch holds. */
+	int					num_ops;
+	/**> Whether the batch is still running. */
+	ion_boolean_t		pending;
+	/**> Whether the thread should exit once it is idle. */
+	ion_boolean_t		stopping;
+} ion_sharded_worker_t;
+
+#endif /* Clause ION_THREAD_SAFE */
+
+/**
+@brief		Metadata container that holds sharded dictionary specific information.
+*/
+typedef struct sharded {
+	/**> Parent structure that holds dictionary level information. */
+	ion_dictionary_parent_t		super;
+	/**> The type of every shard. */
+	ion_dictionary_type_t		shard_type;
+	/**> The handler shared by every shard. */
+	ion_dictionary_handler_t	shard_handler;
+	/**> How many shards there are. */
+	int							num_shards;
+	/**> The shards. */
+	ion_dictionary_t			shards[ION_SHARDED_MAX_SHARDS];
+#if ION_THREAD_SAFE
+	/**> Runs one batch at a time. */
+	ion_mutex_t					batch_lock;
+	/**> One worker per shard. */
+	ion_sharded_worker_t		workers[ION_SHARDED_MAX_SHARDS];
+#endif
+} ion_sharded_t;
+
+/**
+@brief		Where a cursor is within one of the shards it merges.
+*/
+typedef struct {
+	/**> The cursor over the shard, or @p NULL once it has run out of records. */
+	ion_dict_cursor_t	*cursor;
+	/**> The record the shard is on, which is the next one it returns. */
+	ion_record_t		record;
+} ion_sharded_cursor_source_t;
+
+/**
+@brief		Implementation cursor type for the sharded dictionary cursor.
+@details	Each shard returns its records in its own order, and the cursor
+			always returns the smallest key any shard is on. Shards that
+			keep their keys in order therefore give records in key order.
+*/
+typedef struct {
+	/**> Supertype of the dictionary cursor. */
+	ion_dict_cursor_t			super;
+	/**> How many shards are merged. */
+	int							num_sources;
+	/**> The shards, allocated along with the cursor. */
+	ion_sharded_cursor_source_t *sources;
+} ion_sharded_cursor_t;
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* SHARDED_TYPES_H_ */
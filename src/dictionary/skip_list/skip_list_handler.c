@@ -113,6 +113,67 @@ sldict_next(
 	return cs_invalid_cursor;
 }
 
+/**
+@brief	  Retrieves up to @p max_records key/value pairs that satisfy the
+			predicate of the cursor.
+
+@details	Walks the bottom level of the skip list directly, copying each node
+			into the caller's records. Should be called through
+			@ref dictionary_cursor_next_batch.
+
+@param	  cursor
+				The cursor used to iterate over results.
+@param	  records
+				An array of at least @p max_records records allocated by the
+				caller, which the cursor will fill with results.
+@param	  max_records
+				The maximum number of records to retrieve.
+@param	  num_records
+				Set to the number of records retrieved.
+@return	 Status of cursor.
+*/
+ion_cursor_status_t
+sldict_next_batch(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*records,
+	ion_result_count_t	max_records,
+	ion_result_count_t	*num_records
+) {
+	ion_sldict_cursor_t *sl_cursor	= (ion_sldict_cursor_t *) cursor;
+	ion_key_size_t		key_size	= cursor->dictionary->instance->record.key_size;
+	ion_value_size_t	value_size	= cursor->dictionary->instance->record.value_size;
+	ion_sl_node_t		*current	= sl_cursor->current;
+
+	*num_records = 0;
+
+	if ((cursor->status != cs_cursor_initialized) && (cursor->status != cs_cursor_active)) {
+		return cursor->status;
+	}
+
+	while (*num_records < max_records) {
+		if (cursor->status == cs_cursor_active) {
+			if ((NULL == current) || (test_predicate(cursor, current->key) == boolean_false)) {
+				cursor->status = cs_end_of_results;
+				break;
+			}
+		}
+		else {
+			/* The status is cs_cursor_initialized */
+			cursor->status = cs_cursor_active;
+		}
+
+		memcpy(records[*num_records].key, current->key, key_size);
+		memcpy(records[*num_records].value, current->value, value_size);
+		(*num_records)++;
+
+		current = current->next[0];
+	}
+
+	sl_cursor->current = current;
+
+	return 0 < *num_records ? cs_cursor_active : cursor->status;
+}
+
 /**
 @brief			Closes a skiplist instance of a dictionary.
 
@@ -183,6 +244,7 @@ sldict_find(
 
 	(*cursor)->destroy		= sldict_destroy_cursor;
 	(*cursor)->next			= sldict_next;
+	(*cursor)->next_batch	= sldict_next_batch;
 
 	(*cursor)->predicate	= malloc(sizeof(ion_predicate_t));
 
@@ -361,6 +423,11 @@ sldict_init(
 	handler->find				= sldict_find;
 	handler->close_dictionary	= sldict_close_dictionary;
 	handler->open_dictionary	= sldict_open_dictionary;
+	handler->sync_dictionary	= NULL;	/* Records live in memory until the dictionary is closed. */
+	handler->scan_extent		= NULL;
+	handler->scan_range			= NULL;
+	handler->get_many			= NULL;
+	handler->concurrent			= boolean_false;
 }
 
 ion_status_t
@@ -0,0 +1,840 @@
+/******************************************************************************/
+/**
+@file		ion_container.c
+@author		IonDB Project
+@brief		Implementation of single-file container storage.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+/* Needed for fopencookie, pread and pwrite; must come before any system header. */
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "ion_file.h"
+
+#if ION_USING_CONTAINER
+
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+/**
+@brief		Identifies a directory file written by this implementation.
+*/
+#define ION_CONTAINER_MAGIC		0x494f4e43
+
+/**
+@brief		Marks the end of an extent chain.
+*/
+#define ION_CONTAINER_NO_EXTENT UINT32_MAX
+
+/**
+@brief		Index of an extent within @ref ION_CONTAINER_DATA_FILENAME.
+*/
+typedef uint32_t ion_container_extent_t;
+
+/**
+@brief		A file stored inside the container.
+*/
+typedef struct {
+	char					name[ION_CONTAINER_NAME_LENGTH];/**< Name the file was opened
+															 with. */
+	ion_boolean_t			in_use;		/**< Whether this slot holds a file. */
+	ion_file_offset_t		size;		/**< Logical length of the file. */
+	ion_container_extent_t	*extents;	/**< Extent backing each
+											 @ref ION_CONTAINER_EXTENT_SIZE
+											 bytes of the file, in order. */
+	uint32_t				num_extents;/**< Number of extents in use. */
+	uint32_t				capacity;	/**< Number of extents
+											 @p extents has room for. */
+} ion_container_file_t;
+
+/**
+@brief		State of one open stream on a contained file.
+*/
+typedef struct {
+	uint32_t			file;		/**< Slot of the file in the directory. */
+	ion_file_offset_t	position;	/**< Current stream position. */
+} ion_container_stream_t;
+
+/**
+@brief		On-disk header of @ref ION_CONTAINER_DIR_FILENAME.
+@details	Followed by @p num_extents extent table entries, then
+			@p num_files directory entries.
+*/
+typedef struct {
+	uint32_t	magic;			/**< Always @ref ION_CONTAINER_MAGIC. */
+	uint32_t	extent_size;	/**< @ref ION_CONTAINER_EXTENT_SIZE at
+									 creation time. */
+	uint32_t	num_extents;	/**< Extents allocated in the data file. */
+	uint32_t	free_head;		/**< First free extent. */
+	uint32_t	num_files;		/**< Directory entries that follow. */
+} ion_container_header_t;
+
+/**
+@brief		On-disk directory entry.
+*/
+typedef struct {
+	char					name[ION_CONTAINER_NAME_LENGTH];	/**< File name. */
+	int64_t					size;								/**< Logical length. */
+	ion_container_extent_t	first;								/**< First extent. */
+} ion_container_entry_t;
+
+/**
+@brief		The container data file, or @c NULL when no container is open.
+*/
+static FILE *ion_container_data						= NULL;
+
+/**
+@brief		Directory of contained files. Slots are reused after removal.
+*/
+static ion_container_file_t *ion_container_files	= NULL;
+
+/**
+@brief		Number of directory slots in use or previously used.
+*/
+static uint32_t ion_container_num_files				= 0;
+
+/**
+@brief		Number of directory slots allocated.
+*/
+static uint32_t ion_container_files_capacity		= 0;
+
+/**
+@brief		Extent table: the next extent in the chain of each extent, or
+			@ref ION_CONTAINER_NO_EXTENT at the end of a chain. Free
+			extents are chained the same way from
+			@ref ion_container_free_head.
+*/
+static ion_container_extent_t *ion_container_next	= NULL;
+
+/**
+@brief		Number of extents in the data file.
+*/
+static uint32_t ion_container_num_extents			= 0;
+
+/**
+@brief		Number of entries allocated in @ref ion_container_next.
+*/
+static uint32_t ion_container_next_capacity			= 0;
+
+/**
+@brief		First free extent, or @ref ION_CONTAINER_NO_EXTENT.
+*/
+static ion_container_extent_t ion_container_free_head = ION_CONTAINER_NO_EXTENT;
+
+/**
+@brief		Grows an array so that it has room for at least @p needed
+			elements, doubling its capacity as required.
+@returns	The possibly moved array, or @c NULL if out of memory, in
+			which case the original array is left untouched.
+*/
+static void *
+ion_container_grow(
+	void		*array,
+	uint32_t	*capacity,
+	uint32_t	needed,
+	size_t		element_size
+) {
+	uint32_t	new_capacity;
+	void		*grown;
+
+	if ((needed <= *capacity) && (NULL != array)) {
+		return array;
+	}
+
+	new_capacity = (0 == *capacity) ? 16 : *capacity;
+
+	while (new_capacity < needed) {
+		new_capacity *= 2;
+	}
+
+	grown = realloc(array, new_capacity * element_size);
+
+	if (NULL != grown) {
+		*capacity = new_capacity;
+	}
+
+	return grown;
+}
+
+/**
+@brief		Frees all in-memory container state.
+*/
+static void
+ion_container_reset(
+	void
+) {
+	uint32_t i;
+
+	for (i = 0; i < ion_container_num_files; i++) {
+		free(ion_container_files[i].extents);
+	}
+
+	free(ion_container_files);
+	free(ion_container_next);
+	ion_container_files				= NULL;
+	ion_container_num_files			= 0;
+	ion_container_files_capacity	= 0;
+	ion_container_next				= NULL;
+	ion_container_num_extents		= 0;
+	ion_container_next_capacity		= 0;
+	ion_container_free_head			= ION_CONTAINER_NO_EXTENT;
+}
+
+/**
+@brief		Finds the directory slot of a contained file.
+@returns	The slot, or @ref ion_container_num_files if not found.
+*/
+static uint32_t
+ion_container_find(
+	char *name
+) {
+	uint32_t i;
+
+	for (i = 0; i < ion_container_num_files; i++) {
+		if (ion_container_files[i].in_use && (0 == strncmp(ion_container_files[i].name, name, ION_CONTAINER_NAME_LENGTH))) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+/**
+@brief		Appends an extent to a contained file, reusing a free extent
+			when there is one.
+*/
+static ion_err_t
+ion_container_add_extent(
+	ion_container_file_t *file
+) {
+	ion_container_extent_t	extent;
+	ion_container_extent_t	*grown;
+
+	grown = ion_container_grow(file->extents, &file->capacity, file->num_extents + 1, sizeof(ion_container_extent_t));
+
+	if (NULL == grown) {
+		return err_out_of_memory;
+	}
+
+	file->extents = grown;
+
+	if (ION_CONTAINER_NO_EXTENT != ion_container_free_head) {
+		extent					= ion_container_free_head;
+		ion_container_free_head = ion_container_next[extent];
+	}
+	else {
+		grown = ion_container_grow(ion_container_next, &ion_container_next_capacity, ion_container_num_extents + 1, sizeof(ion_container_extent_t));
+
+		if (NULL == grown) {
+			return err_out_of_memory;
+		}
+
+		ion_container_next	= grown;
+		extent = ion_container_num_extents++;
+	}
+
+	ion_container_next[extent] = ION_CONTAINER_NO_EXTENT;
+
+	if (0 < file->num_extents) {
+		ion_container_next[file->extents[file->num_extents - 1]] = extent;
+	}
+
+	file->extents[file->num_extents++] = extent;
+
+	return err_ok;
+}
+
+/**
+@brief		Reads or writes a range of a contained file.
+@details	The range is split at extent boundaries and each piece is
+			transferred with a single positioned read or write on the
+			data file. When writing, extents are added as needed.
+*/
+static ion_err_t
+ion_container_transfer(
+	ion_container_file_t	*file,
+	ion_file_offset_t		offset,
+	size_t					num_bytes,
+	char					*buffer,
+	ion_boolean_t			is_write
+) {
+	uint32_t	index;
+	size_t		within;
+	size_t		chunk;
+	off_t		physical;
+	ssize_t		done;
+	ion_err_t	error;
+
+	while (num_bytes > 0) {
+		index	= (uint32_t) (offset / ION_CONTAINER_EXTENT_SIZE);
+		within	= (size_t) (offset % ION_CONTAINER_EXTENT_SIZE);
+		chunk	= ION_CONTAINER_EXTENT_SIZE - within;
+
+		if (chunk > num_bytes) {
+			chunk = num_bytes;
+		}
+
+		while (index >= file->num_extents) {
+			if (!is_write) {
+				return err_file_read_error;
+			}
+
+			if (err_ok != (error = ion_container_add_extent(file))) {
+				return error;
+			}
+		}
+
+		physical = (off_t) file->extents[index] * ION_CONTAINER_EXTENT_SIZE + within;
+
+		if (is_write) {
+			done = pwrite(fileno(ion_container_data), buffer, chunk, physical);
+		}
+		else {
+			done = pread(fileno(ion_container_data), buffer, chunk, physical);
+		}
+
+		if ((ssize_t) chunk != done) {
+			return is_write ? err_file_write_error : err_file_read_error;
+		}
+
+		offset		+= chunk;
+		buffer		+= chunk;
+		num_bytes	-= chunk;
+	}
+
+	return err_ok;
+}
+
+static ssize_t
+ion_container_stream_read(
+	void	*cookie,
+	char	*buffer,
+	size_t	size
+) {
+	ion_container_stream_t	*stream = cookie;
+	ion_container_file_t	*file	= &ion_container_files[stream->file];
+
+	if (stream->position >= file->size) {
+		return 0;
+	}
+
+	if ((ion_file_offset_t) size > file->size - stream->position) {
+		size = (size_t) (file->size - stream->position);
+	}
+
+	if (err_ok != ion_container_transfer(file, stream->position, size, buffer, boolean_false)) {
+		return -1;
+	}
+
+	stream->position += size;
+
+	return (ssize_t) size;
+}
+
+static ssize_t
+ion_container_stream_write(
+	void		*cookie,
+	const char	*buffer,
+	size_t		size
+) {
+	static char				zeros[ION_CONTAINER_EXTENT_SIZE];
+	ion_container_stream_t	*stream = cookie;
+	ion_container_file_t	*file	= &ion_container_files[stream->file];
+	size_t					gap;
+
+	/* Writing past the end leaves a hole, which must read back as zeros. */
+	while (file->size < stream->position) {
+		gap = sizeof(zeros);
+
+		if ((ion_file_offset_t) gap > stream->position - file->size) {
+			gap = (size_t) (stream->position - file->size);
+		}
+
+		if (err_ok != ion_container_transfer(file, file->size, gap, zeros, boolean_true)) {
+			return 0;
+		}
+
+		file->size += gap;
+	}
+
+	if (err_ok != ion_container_transfer(file, stream->position, size, (char *) buffer, boolean_true)) {
+		return 0;
+	}
+
+	stream->position += size;
+
+	if (stream->position > file->size) {
+		file->size = stream->position;
+	}
+
+	return (ssize_t) size;
+}
+
+static int
+ion_container_stream_seek(
+	void	*cookie,
+	off64_t *offset,
+	int		whence
+) {
+	ion_container_stream_t	*stream = cookie;
+	ion_file_offset_t		position;
+
+	switch (whence) {
+		case SEEK_SET:
+			position = *offset;
+			break;
+
+		case SEEK_CUR:
+			position = stream->position + *offset;
+			break;
+
+		case SEEK_END:
+			position = ion_container_files[stream->file].size + *offset;
+			break;
+
+		default:
+			return -1;
+	}
+
+	if (position < 0) {
+		return -1;
+	}
+
+	stream->position	= position;
+	*offset				= position;
+
+	return 0;
+}
+
+static int
+ion_container_stream_close(
+	void *cookie
+) {
+	free(cookie);
+
+	return 0;
+}
+
+/**
+@brief		Loads the directory and extent table from
+			@ref ION_CONTAINER_DIR_FILENAME.
+*/
+static ion_err_t
+ion_container_load(
+	void
+) {
+	ion_container_header_t	header;
+	ion_container_entry_t	entry;
+	ion_container_file_t	*file;
+	ion_container_file_t	*files;
+	ion_container_extent_t	*grown;
+	ion_container_extent_t	extent;
+	FILE					*directory;
+	ion_err_t				error;
+	uint32_t				i;
+
+	directory = fopen(ION_CONTAINER_DIR_FILENAME, "rb");
+
+	if (NULL == directory) {
+		return err_file_open_error;
+	}
+
+	error = err_file_read_error;
+
+	if ((1 != fread(&header, sizeof(header), 1, directory)) || (ION_CONTAINER_MAGIC != header.magic) || (ION_CONTAINER_EXTENT_SIZE != header.extent_size)) {
+		goto CLEANUP;
+	}
+
+	error	= err_out_of_memory;
+	grown	= ion_container_grow(ion_container_next, &ion_container_next_capacity, header.num_extents, sizeof(ion_container_extent_t));
+
+	if (NULL == grown) {
+		goto CLEANUP;
+	}
+
+	ion_container_next	= grown;
+	files				= ion_container_grow(ion_container_files, &ion_container_files_capacity, header.num_files, sizeof(ion_container_file_t));
+
+	if (NULL == files) {
+		goto CLEANUP;
+	}
+
+	ion_container_files = files;
+	error				= err_file_read_error;
+
+	if ((0 < header.num_extents) && (header.num_extents != fread(ion_container_next, sizeof(ion_container_extent_t), header.num_extents, directory))) {
+		goto CLEANUP;
+	}
+
+	ion_container_num_extents	= header.num_extents;
+	ion_container_free_head		= header.free_head;
+
+	for (i = 0; i < header.num_files; i++) {
+		if (1 != fread(&entry, sizeof(entry), 1, directory)) {
+			error = err_file_read_error;
+			goto CLEANUP;
+		}
+
+		file = &ion_container_files[ion_container_num_files++];
+		memset(file, 0, sizeof(*file));
+		memcpy(file->name, entry.name, ION_CONTAINER_NAME_LENGTH);
+		file->in_use	= boolean_true;
+		file->size		= (ion_file_offset_t) entry.size;
+
+		/* Rebuild the offset map by walking the extent chain once. */
+		for (extent = entry.first; ION_CONTAINER_NO_EXTENT != extent; extent = ion_container_next[extent]) {
+			if (extent >= ion_container_num_extents) {
+				error = err_file_read_error;
+				goto CLEANUP;
+			}
+
+			grown = ion_container_grow(file->extents, &file->capacity, file->num_extents + 1, sizeof(ion_container_extent_t));
+
+			if (NULL == grown) {
+				error = err_out_of_memory;
+				goto CLEANUP;
+			}
+
+			file->extents						= grown;
+			file->extents[file->num_extents++]	= extent;
+		}
+	}
+
+	error = err_ok;
+
+CLEANUP:
+
+	if (0 != fclose(directory)) {
+		return err_file_close_error;
+	}
+
+	return error;
+}
+
+ion_err_t
+ion_container_open(
+	void
+) {
+	ion_err_t error;
+
+	if (NULL != ion_container_data) {
+		return err_ok;
+	}
+
+	ion_container_data = fopen(ION_CONTAINER_DATA_FILENAME, "r+b");
+
+	if (NULL != ion_container_data) {
+		error = ion_container_load();
+	}
+	else {
+		/* A fresh container; the directory is written on first flush. */
+		ion_container_data	= fopen(ION_CONTAINER_DATA_FILENAME, "w+b");
+		error				= (NULL == ion_container_data) ? err_file_open_error : ion_container_flush();
+	}
+
+	if (err_ok != error) {
+		if (NULL != ion_container_data) {
+			fclose(ion_container_data);
+			ion_container_data = NULL;
+		}
+
+		ion_container_reset();
+	}
+
+	return error;
+}
+
+/**
+@brief		Writes the in-memory directory out, and optionally forces it to
+			the device before returning.
+*/
+static ion_err_t
+ion_container_write_directory(
+	ion_boolean_t sync
+) {
+	ion_container_header_t	header;
+	ion_container_entry_t	entry;
+	ion_container_file_t	*file;
+	FILE					*directory;
+	ion_err_t				error;
+	uint32_t				i;
+
+	if (NULL == ion_container_data) {
+		return err_file_open_error;
+	}
+
+	header.magic		= ION_CONTAINER_MAGIC;
+	header.extent_size	= ION_CONTAINER_EXTENT_SIZE;
+	header.num_extents	= ion_container_num_extents;
+	header.free_head	= ion_container_free_head;
+	header.num_files	= 0;
+
+	for (i = 0; i < ion_container_num_files; i++) {
+		header.num_files += ion_container_files[i].in_use ? 1 : 0;
+	}
+
+	directory = fopen(ION_CONTAINER_DIR_FILENAME, "wb");
+
+	if (NULL == directory) {
+		return err_file_open_error;
+	}
+
+	error = err_file_write_error;
+
+	if (1 != fwrite(&header, sizeof(header), 1, directory)) {
+		goto CLEANUP;
+	}
+
+	if ((0 < ion_container_num_extents) && (ion_container_num_extents != fwrite(ion_container_next, sizeof(ion_container_extent_t), ion_container_num_extents, directory))) {
+		goto CLEANUP;
+	}
+
+	for (i = 0; i < ion_container_num_files; i++) {
+		file = &ion_container_files[i];
+
+		if (!file->in_use) {
+			continue;
+		}
+
+		memset(&entry, 0, sizeof(entry));
+		memcpy(entry.name, file->name, ION_CONTAINER_NAME_LENGTH);
+		entry.size	= file->size;
+		entry.first = (0 < file->num_extents) ? file->extents[0] : ION_CONTAINER_NO_EXTENT;
+
+		if (1 != fwrite(&entry, sizeof(entry), 1, directory)) {
+			goto CLEANUP;
+		}
+	}
+
+	if (sync && ((0 != fflush(directory)) || (0 != fsync(fileno(directory))))) {
+		goto CLEANUP;
+	}
+
+	error = err_ok;
+
+CLEANUP:
+
+	if (0 != fclose(directory)) {
+		return err_file_close_error;
+	}
+
+	return error;
+}
+
+ion_err_t
+ion_container_flush(
+	void
+) {
+	return ion_container_write_directory(boolean_false);
+}
+
+ion_err_t
+ion_container_sync(
+	void
+) {
+	ion_err_t error = ion_container_write_directory(boolean_true);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	/* Contained streams write straight to the descriptor, so there is no
+	   stdio buffer of the data file to flush first. */
+	if (0 != fdatasync(fileno(ion_container_data))) {
+		return err_file_write_error;
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+ion_container_close(
+	void
+) {
+	ion_err_t error;
+
+	if (NULL == ion_container_data) {
+		return err_ok;
+	}
+
+	error = ion_container_flush();
+
+	if ((0 != fclose(ion_container_data)) && (err_ok == error)) {
+		error = err_file_close_error;
+	}
+
+	ion_container_data = NULL;
+	ion_container_reset();
+
+	return error;
+}
+
+ion_err_t
+ion_container_delete(
+	void
+) {
+	ion_err_t error = ion_container_close();
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	fremove(ION_CONTAINER_DIR_FILENAME);
+
+	if (0 != fremove(ION_CONTAINER_DATA_FILENAME)) {
+		return err_file_delete_error;
+	}
+
+	return err_ok;
+}
+
+ion_boolean_t
+ion_container_is_open(
+	void
+) {
+	return NULL != ion_container_data;
+}
+
+ion_boolean_t
+ion_container_exists(
+	char *name
+) {
+	return ion_container_find(name) < ion_container_num_files;
+}
+
+FILE *
+ion_container_fopen(
+	char *name
+) {
+	static cookie_io_functions_t	functions = {
+		ion_container_stream_read, ion_container_stream_write, ion_container_stream_seek, ion_container_stream_close
+	};
+	ion_container_stream_t			*stream;
+	ion_container_file_t			*file;
+	uint32_t						slot;
+	FILE							*handle;
+
+	if ((NULL == ion_container_data) || (strlen(name) >= ION_CONTAINER_NAME_LENGTH)) {
+		return NULL;
+	}
+
+	slot = ion_container_find(name);
+
+	if (slot == ion_container_num_files) {
+		/* Reuse the slot of a removed file before growing the directory. */
+		for (slot = 0; slot < ion_container_num_files && ion_container_files[slot].in_use; slot++) {}
+
+		if (slot == ion_container_num_files) {
+			file = ion_container_grow(ion_container_files, &ion_container_files_capacity, ion_container_num_files + 1, sizeof(ion_container_file_t));
+
+			if (NULL == file) {
+				return NULL;
+			}
+
+			ion_container_files = file;
+		}
+
+		file = &ion_container_files[slot];
+		memset(file, 0, sizeof(*file));
+		strcpy(file->name, name);
+		file->in_use = boolean_true;
+
+		if (slot == ion_container_num_files) {
+			ion_container_num_files++;
+		}
+	}
+
+	stream = malloc(sizeof(ion_container_stream_t));
+
+	if (NULL == stream) {
+		return NULL;
+	}
+
+	stream->file		= slot;
+	stream->position	= 0;
+	handle				= fopencookie(stream, "r+", functions);
+
+	if (NULL == handle) {
+		free(stream);
+	}
+
+	return handle;
+}
+
+ion_err_t
+ion_container_remove(
+	char *name
+) {
+	ion_container_file_t	*file;
+	uint32_t				slot = ion_container_find(name);
+
+	if (slot == ion_container_num_files) {
+		return err_file_delete_error;
+	}
+
+	file = &ion_container_files[slot];
+
+	/* Splice the whole chain onto the free list in one step. */
+	if (0 < file->num_extents) {
+		ion_container_next[file->extents[file->num_extents - 1]]	= ion_container_free_head;
+		ion_container_free_head										= file->extents[0];
+	}
+
+	free(file->extents);
+	memset(file, 0, sizeof(*file));
+
+	return err_ok;
+}
+
+ion_err_t
+ion_container_rename(
+	char	*old_name,
+	char	*new_name
+) {
+	uint32_t slot = ion_container_find(old_name);
+
+	if ((slot == ion_container_num_files) || (strlen(new_name) >= ION_CONTAINER_NAME_LENGTH)) {
+		return err_file_rename_error;
+	}
+
+	if (ion_container_exists(new_name)) {
+		ion_container_remove(new_name);
+	}
+
+	strcpy(ion_container_files[slot].name, new_name);
+
+	return err_ok;
+}
+
+#endif /* ION_USING_CONTAINER */
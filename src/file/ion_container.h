@@ -0,0 +1,209 @@
+/******************************************************************************/
+/**
+@file		ion_container.h
+@author		IonDB Project
+@brief		Single-file container storage for the file API.
+@details	When a container is open, every file opened through the
+			@ref ion_fopen family lives inside one shared segment file
+			instead of a file of its own. Space in the segment file is
+			handed out in fixed-size extents, and each contained file keeps
+			an in-memory map from its logical offsets to those extents.
+			Opening, creating and looking up a contained file never
+			touch the file system.
+
+			The directory (file names, sizes and the extent chains) is
+			kept in memory and written to a small side file by
+			@ref ion_container_flush and @ref ion_container_close.
+			Only available on Linux, since contained files are exposed as
+			ordinary @c FILE streams through @c fopencookie.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(ION_CONTAINER_H_)
+#define ION_CONTAINER_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "../key_value/kv_system.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+#define ION_USING_CONTAINER 1
+#else
+#define ION_USING_CONTAINER 0
+#endif
+
+#if ION_USING_CONTAINER
+
+/**
+@brief		File holding the extents of every contained file.
+*/
+#define ION_CONTAINER_DATA_FILENAME "ion_ct.dat"
+
+/**
+@brief		File holding the container directory and extent table.
+*/
+#define ION_CONTAINER_DIR_FILENAME	"ion_ct.dir"
+
+/**
+@brief		Size in bytes of a single extent.
+@details	Every contained file occupies a whole number of extents, so
+			this trades wasted space in small files against the size of
+			the per-file extent maps.
+*/
+#define ION_CONTAINER_EXTENT_SIZE	4096
+
+/**
+@brief		Maximum length of a contained file name, including the null
+			terminator.
+*/
+#define ION_CONTAINER_NAME_LENGTH	16
+
+/**
+@brief		Opens the container, creating it if it does not exist.
+@details	Once open, @ref ion_fopen, @ref ion_fexists and
+			@ref ion_fremove operate on contained files. Can be safely
+			called multiple times without closing.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_container_open(
+	void
+);
+
+/**
+@brief		Writes the in-memory directory out to
+			@ref ION_CONTAINER_DIR_FILENAME.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_container_flush(
+	void
+);
+
+/**
+@brief		Writes out the directory and forces it and every contained
+			file's data to the device.
+@details	Contained streams must be flushed first.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_container_sync(
+	void
+);
+
+/**
+@brief		Flushes and closes the container.
+@details	All contained files must already be closed.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_container_close(
+	void
+);
+
+/**
+@brief		Closes the container, if open, and deletes its files.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_container_delete(
+	void
+);
+
+/**
+@brief		Tells whether a container is currently open.
+*/
+ion_boolean_t
+ion_container_is_open(
+	void
+);
+
+/**
+@brief		Tells whether a file exists in the open container.
+@param		name
+				The name of the contained file.
+*/
+ion_boolean_t
+ion_container_exists(
+	char *name
+);
+
+/**
+@brief		Opens a contained file for reading and writing, creating it
+			if it does not exist.
+@param		name
+				The name of the contained file.
+@returns	A stream positioned at the start of the file, or @c NULL on
+			failure.
+*/
+FILE *
+ion_container_fopen(
+	char *name
+);
+
+/**
+@brief		Removes a contained file and returns its extents to the
+			container for reuse.
+@details	The file must not be open.
+@param		name
+				The name of the contained file.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_container_remove(
+	char *name
+);
+
+/**
+@brief		Renames a contained file, replacing any file already called
+			@p new_name.
+@details	Neither file may be open.
+@param		old_name
+				The current name of the contained file.
+@param		new_name
+				The name to give it.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_container_rename(
+	char	*old_name,
+	char	*new_name
+);
+
+#endif /* ION_USING_CONTAINER */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* ION_CONTAINER_H_ */
@@ -34,6 +34,11 @@
 */
 /******************************************************************************/
 
+/* Needed for fileno and fdatasync; must come before any system header. */
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include "ion_file.h"
 
 ion_boolean_t
@@ -43,10 +48,39 @@ ion_fexists(
 #if defined(ARDUINO)
 	return (ion_boolean_t) SD_File_Exists(name);
 #else
+#if ION_USING_CONTAINER
+
+	if (ion_container_is_open()) {
+		return ion_container_exists(name);
+	}
+
+#endif
 	return -1 != access(name, F_OK);
 #endif
 }
 
+#if ION_FILE_STATS
+
+ion_err_t
+ion_file_set_owner(
+	ion_file_handle_t	file,
+	ion_file_owner_t	owner
+) {
+	file->owner_io = ion_file_owner_stats(owner);
+
+	return NULL == file->owner_io ? err_out_of_memory : err_ok;
+}
+
+void
+ion_file_get_stats(
+	ion_file_handle_t	file,
+	ion_file_io_stats_t *stats
+) {
+	ion_file_stats_copy(stats, &file->io);
+}
+
+#endif /* Clause ION_FILE_STATS */
+
 ion_file_handle_t
 ion_fopen(
 	char *name
@@ -64,15 +98,8 @@ ion_fopen(
 	return toret;
 #else
 
-	ion_file_handle_t file;
-
-	file = fopen(name, "r+b");
-
-	if (NULL == file) {
-		file = fopen(name, "w+b");
-	}
-
-	return file;
+	/* The pool opens inside the container when one is open. */
+	return ion_file_pool_open(name);
 #endif
 }
 
@@ -84,8 +111,7 @@ ion_fclose(
 	fclose(file.file);
 	return err_ok;
 #else
-	fclose(file);
-	return err_ok;
+	return ion_file_pool_close(file);
 #endif
 }
 
@@ -95,6 +121,14 @@ ion_fremove(
 ) {
 	int status;
 
+#if ION_USING_CONTAINER
+
+	if (ion_container_is_open()) {
+		return ion_container_remove(name);
+	}
+
+#endif
+
 	status = fremove(name);
 
 	if (0 == status) {
@@ -105,6 +139,26 @@ ion_fremove(
 	}
 }
 
+ion_err_t
+ion_frename(
+	char	*old_name,
+	char	*new_name
+) {
+#if ION_USING_CONTAINER
+
+	if (ion_container_is_open()) {
+		return ion_container_rename(old_name, new_name);
+	}
+
+#endif
+
+	if (0 != frename(old_name, new_name)) {
+		return err_file_rename_error;
+	}
+
+	return err_ok;
+}
+
 ion_err_t
 ion_fseek(
 	ion_file_handle_t	file,
@@ -120,7 +174,20 @@ ion_fseek(
 	return err_ok;
 #else
 
-	if (0 != fseek(file, seek_to, origin)) {
+	FILE *stream = ion_file_pool_acquire(file);
+
+	if (NULL == stream) {
+		return err_file_bad_seek;
+	}
+
+	ION_FILE_IO_BEGIN();
+
+	int status = fseek(stream, seek_to, origin);
+
+	ION_FILE_IO_END(file, ion_file_io_seek, 0);
+	ion_file_pool_release(file);
+
+	if (0 != status) {
 		return err_file_bad_seek;
 	}
 
@@ -135,7 +202,18 @@ ion_ftell(
 #if defined(ARDUINO)
 	return ftell(file.file);
 #else
-	return ftell(file);
+
+	FILE *stream = ion_file_pool_acquire(file);
+
+	if (NULL == stream) {
+		return -1;
+	}
+
+	ion_file_offset_t position = ftell(stream);
+
+	ion_file_pool_release(file);
+
+	return position;
 #endif
 }
 
@@ -168,7 +246,29 @@ ion_fwrite(
 
 	return err_ok;
 #else
-	fwrite(to_write, num_bytes, 1, file);
+
+	FILE *stream = ion_file_pool_acquire(file);
+
+	if (NULL == stream) {
+		return err_file_write_error;
+	}
+
+	if (0 == num_bytes) {
+		ion_file_pool_release(file);
+		return err_ok;
+	}
+
+	ION_FILE_IO_BEGIN();
+
+	size_t written = fwrite(to_write, num_bytes, 1, stream);
+
+	ION_FILE_IO_END(file, ion_file_io_write, num_bytes);
+	ion_file_pool_release(file);
+
+	if (1 != written) {
+		return err_file_write_error;
+	}
+
 	return err_ok;
 #endif
 }
@@ -225,7 +325,25 @@ ion_fread(
 	return err_ok;
 #else
 
-	if (1 != fread(write_to, num_bytes, 1, file)) {
+	FILE *stream = ion_file_pool_acquire(file);
+
+	if (NULL == stream) {
+		return err_file_read_error;
+	}
+
+	if (0 == num_bytes) {
+		ion_file_pool_release(file);
+		return err_ok;
+	}
+
+	ION_FILE_IO_BEGIN();
+
+	size_t read = fread(write_to, num_bytes, 1, stream);
+
+	ION_FILE_IO_END(file, ion_file_io_read, num_bytes);
+	ion_file_pool_release(file);
+
+	if (1 != read) {
 		return err_file_read_error;
 	}
 
@@ -240,6 +358,43 @@ ion_fread_at(
 	unsigned int		num_bytes,
 	ion_byte_t			*write_to
 ) {
+#if ION_THREAD_SAFE
+
+	/* Readers share the file, so read without moving its position. */
+	FILE		*stream = ion_file_pool_acquire(file);
+	ion_err_t	error	= err_ok;
+
+	if (NULL == stream) {
+		return err_file_read_error;
+	}
+
+	ION_FILE_IO_BEGIN();
+
+	if (file->contained) {
+		/* No descriptor to read from, but the pool stays locked while a
+		   contained file is acquired. */
+		if (0 != fseek(stream, offset, SEEK_SET)) {
+			error = err_file_bad_seek;
+		}
+		else if ((0 != num_bytes) && (1 != fread(write_to, num_bytes, 1, stream))) {
+			error = err_file_read_error;
+		}
+	}
+	/* Writes may still be in the stdio buffer. The position is only
+	   moved afterwards, for writers that carry on from it, so a reader
+	   racing another one still reads the right bytes. */
+	else if ((0 != fflush(stream)) || ((ssize_t) num_bytes != pread(fileno(stream), write_to, num_bytes, offset))) {
+		error = err_file_read_error;
+	}
+	else if (0 != fseek(stream, offset + num_bytes, SEEK_SET)) {
+		error = err_file_bad_seek;
+	}
+
+	ION_FILE_IO_END(file, ion_file_io_read, num_bytes);
+	ion_file_pool_release(file);
+
+	return error;
+#else
 	ion_err_t error;
 
 	error = ion_fseek(file, offset, ION_FILE_START);
@@ -250,4 +405,86 @@ ion_fread_at(
 
 	error = ion_fread(file, num_bytes, write_to);
 	return error;
+#endif
+}
+
+ion_err_t
+ion_fflush(
+	ion_file_handle_t file
+) {
+#if defined(ARDUINO)
+
+	if (0 != fflush(file.file)) {
+		return err_file_write_error;
+	}
+
+	return err_ok;
+#else
+
+	FILE *stream = ion_file_pool_acquire(file);
+
+	if (NULL == stream) {
+		return err_file_write_error;
+	}
+
+	ION_FILE_IO_BEGIN();
+
+	int status = fflush(stream);
+
+	ION_FILE_IO_END(file, ion_file_io_flush, 0);
+	ion_file_pool_release(file);
+
+	if (0 != status) {
+		return err_file_write_error;
+	}
+
+	return err_ok;
+#endif
+}
+
+ion_err_t
+ion_fsync(
+	ion_file_handle_t file
+) {
+	ion_err_t error = ion_fflush(file);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+#if defined(ARDUINO)
+	/* Flushing an SD file already commits it to the card. */
+	return err_ok;
+#else
+#if ION_USING_CONTAINER
+
+	if (ion_container_is_open()) {
+		return ion_container_sync();
+	}
+
+#endif
+
+	FILE *stream = ion_file_pool_acquire(file);
+
+	if (NULL == stream) {
+		return err_file_write_error;
+	}
+
+	ION_FILE_IO_BEGIN();
+
+#if defined(__linux__)
+	int status = fdatasync(fileno(stream));
+#else
+	int status = fsync(fileno(stream));
+#endif
+
+	ION_FILE_IO_END(file, ion_file_io_flush, 0);
+	ion_file_pool_release(file);
+
+	if (0 != status) {
+		return err_file_write_error;
+	}
+
+	return err_ok;
+#endif
 }
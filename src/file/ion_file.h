@@ -46,8 +46,9 @@ extern "C" {
 
 typedef long ion_file_offset_t;
 
-#define ION_FILE_START	SEEK_SET
-#define ION_FILE_END	SEEK_END
+#define ION_FILE_START		SEEK_SET
+#define ION_FILE_CURRENT	SEEK_CUR
+#define ION_FILE_END		SEEK_END
 
 #if defined(ARDUINO)
 
@@ -61,15 +62,22 @@ typedef struct file_handle {
 	SD_FILE *file;
 } ion_file_handle_t;
 
+#define ION_FILE_IS_NULL(handle)	(NULL == (handle).file)
+
 #else /* Clause ARDUINO */
 
 #include "stdio.h"
 #include "unistd.h"
+#include "ion_container.h"
+#include "ion_file_pool.h"
 
-typedef FILE *ion_file_handle_t;
+/* Handles are pool tokens; the OS file behind one may be closed and reopened. */
+typedef ion_file_pool_entry_t *ion_file_handle_t;
 
 #define ION_NOFILE ((ion_file_handle_t) (NULL))
 
+#define ION_FILE_IS_NULL(handle)	(NULL == (handle))
+
 #endif /* Clause ARDUINO */
 
 #define ION_FILE_NULL -1
@@ -94,6 +102,12 @@ ion_fremove(
 	char *name
 );
 
+ion_err_t
+ion_frename(
+	char	*old_name,
+	char	*new_name
+);
+
 ion_err_t
 ion_fseek(
 	ion_file_handle_t	file,
@@ -141,6 +155,56 @@ ion_fread_at(
 	ion_byte_t			*write_to
 );
 
+ion_err_t
+ion_fflush(
+	ion_file_handle_t file
+);
+
+/**
+@brief		Flushes a file and forces its data to the device.
+@details	On a desktop this costs a device round trip; batch writes and
+			call it once per batch rather than once per write.
+@param		file
+				An open file.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_fsync(
+	ion_file_handle_t file
+);
+
+#if ION_FILE_STATS
+
+/**
+@brief		Charges all further I/O on a file to an owner.
+@param		file
+				An open file.
+@param		owner
+				The owner, usually the ID of the dictionary the file
+				belongs to.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_file_set_owner(
+	ion_file_handle_t	file,
+	ion_file_owner_t	owner
+);
+
+/**
+@brief		Copies the I/O counters of an open file.
+@param		file
+				An open file.
+@param		stats
+				Written with the counters.
+*/
+void
+ion_file_get_stats(
+	ion_file_handle_t	file,
+	ion_file_io_stats_t *stats
+);
+
+#endif /* Clause ION_FILE_STATS */
+
 #if defined(__cplusplus)
 }
 #endif
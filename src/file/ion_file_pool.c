@@ -0,0 +1,364 @@
+/******************************************************************************/
+/**
+@file		ion_file_pool.c
+@author		IonDB Project
+@brief		Implementation of the bounded pool of open files.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "ion_file.h"
+
+#if !defined(ARDUINO)
+
+/**
+@brief		Maximum number of files kept open at once.
+*/
+static unsigned int ion_file_pool_max_open		= ION_FILE_POOL_MAX_OPEN;
+
+/**
+@brief		Stdio buffer size given to each file as it is opened.
+*/
+static size_t ion_file_pool_buffer_size			= ION_FILE_POOL_BUFFER_SIZE;
+
+/**
+@brief		Number of files currently open.
+*/
+static unsigned int ion_file_pool_open_count	= 0;
+
+/**
+@brief		Most recently used open entry.
+*/
+static ion_file_pool_entry_t *ion_file_pool_newest = NULL;
+
+/**
+@brief		Least recently used open entry; the next one to be evicted.
+*/
+static ion_file_pool_entry_t *ion_file_pool_oldest = NULL;
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Guards the recency list, the open count and the limits.
+*/
+static ion_mutex_t ion_file_pool_lock = ION_MUTEX_INITIALIZER;
+
+#endif
+
+/**
+@brief		Removes an open entry from the recency list.
+*/
+static void
+ion_file_pool_unlink(
+	ion_file_pool_entry_t *entry
+) {
+	if (NULL == entry->newer) {
+		ion_file_pool_newest = entry->older;
+	}
+	else {
+		entry->newer->older = entry->older;
+	}
+
+	if (NULL == entry->older) {
+		ion_file_pool_oldest = entry->newer;
+	}
+	else {
+		entry->older->newer = entry->newer;
+	}
+
+	entry->newer	= NULL;
+	entry->older	= NULL;
+}
+
+/**
+@brief		Puts an open entry at the most recently used end of the list.
+*/
+static void
+ion_file_pool_push(
+	ion_file_pool_entry_t *entry
+) {
+	entry->newer	= NULL;
+	entry->older	= ion_file_pool_newest;
+
+	if (NULL == ion_file_pool_newest) {
+		ion_file_pool_oldest = entry;
+	}
+	else {
+		ion_file_pool_newest->newer = entry;
+	}
+
+	ion_file_pool_newest = entry;
+}
+
+/**
+@brief		Returns the least recently used open entry that is not in use,
+			or @c NULL if every open entry is.
+*/
+static ion_file_pool_entry_t *
+ion_file_pool_victim(
+	void
+) {
+	ion_file_pool_entry_t *entry = ion_file_pool_oldest;
+
+#if ION_THREAD_SAFE
+
+	while ((NULL != entry) && (0 != entry->pins)) {
+		entry = entry->newer;
+	}
+
+#endif
+	return entry;
+}
+
+/**
+@brief		Closes the file of an open entry, remembering its position.
+*/
+static ion_err_t
+ion_file_pool_evict(
+	ion_file_pool_entry_t *entry
+) {
+	ion_file_pool_unlink(entry);
+	ion_file_pool_open_count--;
+
+	entry->position = ftell(entry->file);
+
+	if (0 != fclose(entry->file)) {
+		entry->file = NULL;
+		return err_file_close_error;
+	}
+
+	entry->file = NULL;
+
+	return err_ok;
+}
+
+/**
+@brief		Opens the file of an entry, evicting the least recently used
+			files to stay within the limit.
+@param		entry
+				The entry to open.
+@param		mode
+				The @c fopen mode to use for an uncontained file.
+*/
+static ion_err_t
+ion_file_pool_reopen(
+	ion_file_pool_entry_t	*entry,
+	char					*mode
+) {
+	ion_err_t				error;
+	ion_file_pool_entry_t	*victim;
+
+	/* When every open file is in use by another thread, go over the limit
+	   rather than wait for one to be released. */
+	while ((ion_file_pool_open_count >= ion_file_pool_max_open) && (NULL != (victim = ion_file_pool_victim()))) {
+		if (err_ok != (error = ion_file_pool_evict(victim))) {
+			return error;
+		}
+	}
+
+#if ION_USING_CONTAINER
+
+	if (entry->contained) {
+		entry->file = ion_container_fopen(entry->name);
+	}
+	else
+#endif
+	{
+		entry->file = fopen(entry->name, mode);
+	}
+
+	if (NULL == entry->file) {
+		return err_file_open_error;
+	}
+
+	setvbuf(entry->file, NULL, _IOFBF, ion_file_pool_buffer_size);
+
+	if (0 != fseek(entry->file, entry->position, SEEK_SET)) {
+		fclose(entry->file);
+		entry->file = NULL;
+		return err_file_bad_seek;
+	}
+
+	ion_file_pool_open_count++;
+	ion_file_pool_push(entry);
+
+	return err_ok;
+}
+
+ion_err_t
+ion_file_pool_configure(
+	unsigned int	max_open,
+	size_t			buffer_size
+) {
+	ion_err_t				error = err_ok;
+	ion_file_pool_entry_t	*victim;
+
+	if ((max_open < 2) || (0 == buffer_size)) {
+		return err_invalid_initial_size;
+	}
+
+	ION_MUTEX_LOCK(ion_file_pool_lock);
+
+	ion_file_pool_max_open		= max_open;
+	ion_file_pool_buffer_size	= buffer_size;
+
+	while ((ion_file_pool_open_count > ion_file_pool_max_open) && (NULL != (victim = ion_file_pool_victim()))) {
+		if (err_ok != (error = ion_file_pool_evict(victim))) {
+			break;
+		}
+	}
+
+	ION_MUTEX_UNLOCK(ion_file_pool_lock);
+
+	return error;
+}
+
+ion_file_pool_entry_t *
+ion_file_pool_open(
+	char *name
+) {
+	ion_file_pool_entry_t *entry;
+
+	if (strlen(name) >= sizeof(entry->name)) {
+		return NULL;
+	}
+
+	entry = calloc(1, sizeof(ion_file_pool_entry_t));
+
+	if (NULL == entry) {
+		return NULL;
+	}
+
+	strcpy(entry->name, name);
+#if ION_USING_CONTAINER
+	entry->contained = ion_container_is_open();
+#endif
+
+	ION_MUTEX_LOCK(ion_file_pool_lock);
+
+	/* Same semantics as ion_fopen: open for update, creating if needed. */
+	if ((err_ok != ion_file_pool_reopen(entry, "r+b")) && (entry->contained || (err_ok != ion_file_pool_reopen(entry, "w+b")))) {
+		ION_MUTEX_UNLOCK(ion_file_pool_lock);
+		free(entry);
+		return NULL;
+	}
+
+	ION_MUTEX_UNLOCK(ion_file_pool_lock);
+
+	return entry;
+}
+
+FILE *
+ion_file_pool_acquire(
+	ion_file_pool_entry_t *entry
+) {
+	FILE *file;
+
+	ION_MUTEX_LOCK(ion_file_pool_lock);
+
+	if (NULL == entry->file) {
+		/* The file exists by now, so never truncate when reopening. */
+		if (err_ok != ion_file_pool_reopen(entry, "r+b")) {
+			ION_MUTEX_UNLOCK(ion_file_pool_lock);
+			return NULL;
+		}
+	}
+	else if (ion_file_pool_newest != entry) {
+		ion_file_pool_unlink(entry);
+		ion_file_pool_push(entry);
+	}
+
+	file = entry->file;
+
+#if ION_THREAD_SAFE
+	entry->pins++;
+
+	/* Every file in the container shares its extents, so I/O on a
+	   contained file keeps the whole pool locked. */
+	if (!entry->contained) {
+		ION_MUTEX_UNLOCK(ion_file_pool_lock);
+	}
+
+#endif
+
+	return file;
+}
+
+void
+ion_file_pool_release(
+	ion_file_pool_entry_t *entry
+) {
+#if ION_THREAD_SAFE
+
+	if (!entry->contained) {
+		ION_MUTEX_LOCK(ion_file_pool_lock);
+	}
+
+	entry->pins--;
+
+	ION_MUTEX_UNLOCK(ion_file_pool_lock);
+#else
+	UNUSED(entry);
+#endif
+}
+
+ion_err_t
+ion_file_pool_close(
+	ion_file_pool_entry_t *entry
+) {
+	ion_err_t error = err_ok;
+
+	ION_MUTEX_LOCK(ion_file_pool_lock);
+
+	if (NULL != entry->file) {
+		error = ion_file_pool_evict(entry);
+	}
+
+	ION_MUTEX_UNLOCK(ion_file_pool_lock);
+
+	free(entry);
+
+	return error;
+}
+
+unsigned int
+ion_file_pool_num_open(
+	void
+) {
+	unsigned int num_open;
+
+	ION_MUTEX_LOCK(ion_file_pool_lock);
+	num_open = ion_file_pool_open_count;
+	ION_MUTEX_UNLOCK(ion_file_pool_lock);
+
+	return num_open;
+}
+
+#endif /* Clause ARDUINO */
@@ -0,0 +1,186 @@
+/******************************************************************************/
+/**
+@file		ion_file_pool.h
+@author		IonDB Project
+@brief		A bounded, least-recently-used pool of open files.
+@details	Files opened through the pool are represented by a token that
+			stays valid while the file is logically open. The underlying
+			@c FILE is only kept open while it is among the most recently
+			used; older ones are closed, remembering their position, and
+			transparently reopened the next time they are acquired. This
+			caps both the number of OS handles and the memory spent on
+			stdio buffers, no matter how many files are logically open.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(ION_FILE_POOL_H_)
+#define ION_FILE_POOL_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "../key_value/kv_system.h"
+#include "ion_file_stats.h"
+
+/**
+@brief		Maximum length of a pooled file name, including the null
+			terminator.
+*/
+#define ION_FILE_POOL_NAME_LENGTH	16
+
+#if !defined(ION_FILE_POOL_MAX_OPEN)
+/**
+@brief		Default number of files the pool keeps open at once.
+*/
+#define ION_FILE_POOL_MAX_OPEN		64
+#endif
+
+#if !defined(ION_FILE_POOL_BUFFER_SIZE)
+/**
+@brief		Default stdio buffer size, in bytes, of each pooled file.
+*/
+#define ION_FILE_POOL_BUFFER_SIZE	1024
+#endif
+
+/**
+@brief		A file opened through the pool.
+*/
+typedef struct ion_file_pool_entry ion_file_pool_entry_t;
+
+struct ion_file_pool_entry {
+	char					name[ION_FILE_POOL_NAME_LENGTH];/**< Name to reopen
+															 the file with. */
+	FILE					*file;		/**< The open file, or @c NULL
+											 while evicted. */
+	long					position;	/**< Position to restore on
+											 reopen. */
+	ion_boolean_t			contained;	/**< Whether the file lives
+											 in the container. */
+	ion_file_pool_entry_t	*newer;		/**< Next more recently used
+											 open entry. */
+	ion_file_pool_entry_t	*older;		/**< Next less recently used
+											 open entry. */
+#if ION_THREAD_SAFE
+	unsigned int			pins;		/**< Calls between @ref
+											 ion_file_pool_acquire and
+											 @ref ion_file_pool_release;
+											 a pinned file is not
+											 evicted. */
+#endif
+#if ION_FILE_STATS
+	ion_file_io_stats_t		io;			/**< I/O made on this file. */
+	ion_file_io_stats_t		*owner_io;	/**< Counters of the file's
+											 owner, or @c NULL. */
+#endif
+};
+
+/**
+@brief		Sets the limits of the pool.
+@details	Lowering @p max_open closes the least recently used files
+			immediately. A new @p buffer_size applies to files as they
+			are (re)opened.
+@param		max_open
+				Maximum number of files kept open at once. At least 2, so
+				that a structure alternating between two files does not
+				thrash.
+@param		buffer_size
+				Size in bytes of the stdio buffer given to each open file.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_file_pool_configure(
+	unsigned int	max_open,
+	size_t			buffer_size
+);
+
+/**
+@brief		Opens a file through the pool, creating it if it does not
+			exist.
+@param		name
+				The name of the file.
+@returns	A token for the file, or @c NULL on failure.
+*/
+ion_file_pool_entry_t *
+ion_file_pool_open(
+	char *name
+);
+
+/**
+@brief		Returns the open @c FILE of a pooled file, reopening it at
+			its previous position if it was evicted.
+@details	The returned @c FILE stays valid until the matching
+			@ref ion_file_pool_release.
+@param		entry
+				The token of the file.
+@returns	The open file, or @c NULL if it could not be reopened, in
+			which case it must not be released.
+*/
+FILE *
+ion_file_pool_acquire(
+	ion_file_pool_entry_t *entry
+);
+
+/**
+@brief		Ends the use of a @c FILE returned by @ref ion_file_pool_acquire,
+			allowing the pool to evict it again.
+@param		entry
+				The token of the file.
+*/
+void
+ion_file_pool_release(
+	ion_file_pool_entry_t *entry
+);
+
+/**
+@brief		Closes a pooled file and releases its token.
+@param		entry
+				The token of the file.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_file_pool_close(
+	ion_file_pool_entry_t *entry
+);
+
+/**
+@brief		Returns the number of OS handles currently held by the pool.
+*/
+unsigned int
+ion_file_pool_num_open(
+	void
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* ION_FILE_POOL_H_ */
@@ -0,0 +1,584 @@
+/******************************************************************************/
+/**
+@file		ion_file_queue.c
+@author		IonDB Project
+@brief		Reads that are issued many at a time and waited for together.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+/* Needed for syscall and dup; must come before any system header. */
+#if !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include "ion_file_queue.h"
+
+#if ION_FILE_IO_URING
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/* The kernel reads and writes the rings concurrently with us, so their
+   indices always need real barriers, threads or not. */
+#define ION_FILE_QUEUE_LOAD(pointer)			__atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+#define ION_FILE_QUEUE_STORE(pointer, value)	__atomic_store_n((pointer), (value), __ATOMIC_RELEASE)
+
+/**
+@brief		Maps the rings of a freshly created io_uring instance.
+@param		queue
+				The queue, with @c ring set.
+@param		params
+				What the kernel returned when creating the instance.
+@returns	An error code describing the result of the operation.
+*/
+static ion_err_t
+ion_file_queue_map(
+	ion_file_queue_t		*queue,
+	struct io_uring_params	*params
+) {
+	queue->sq_ring_size = params->sq_off.array + params->sq_entries * sizeof(unsigned int);
+	queue->cq_ring_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+
+	if (params->features & IORING_FEAT_SINGLE_MMAP) {
+		if (queue->cq_ring_size > queue->sq_ring_size) {
+			queue->sq_ring_size = queue->cq_ring_size;
+		}
+
+		queue->cq_ring_size = queue->sq_ring_size;
+	}
+
+	queue->sq_ring = mmap(NULL, queue->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, queue->ring, IORING_OFF_SQ_RING);
+
+	if (MAP_FAILED == queue->sq_ring) {
+		queue->sq_ring = NULL;
+		return err_out_of_memory;
+	}
+
+	if (params->features & IORING_FEAT_SINGLE_MMAP) {
+		queue->cq_ring = queue->sq_ring;
+	}
+	else {
+		queue->cq_ring = mmap(NULL, queue->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, queue->ring, IORING_OFF_CQ_RING);
+
+		if (MAP_FAILED == queue->cq_ring) {
+			queue->cq_ring = NULL;
+			return err_out_of_memory;
+		}
+	}
+
+	queue->sqes_size	= params->sq_entries * sizeof(struct io_uring_sqe);
+	queue->sqes			= mmap(NULL, queue->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED, queue->ring, IORING_OFF_SQES);
+
+	if (MAP_FAILED == queue->sqes) {
+		queue->sqes = NULL;
+		return err_out_of_memory;
+	}
+
+	queue->sq_head	= (unsigned int *) ((ion_byte_t *) queue->sq_ring + params->sq_off.head);
+	queue->sq_tail	= (unsigned int *) ((ion_byte_t *) queue->sq_ring + params->sq_off.tail);
+	queue->sq_mask	= (unsigned int *) ((ion_byte_t *) queue->sq_ring + params->sq_off.ring_mask);
+	queue->sq_array = (unsigned int *) ((ion_byte_t *) queue->sq_ring + params->sq_off.array);
+	queue->cq_head	= (unsigned int *) ((ion_byte_t *) queue->cq_ring + params->cq_off.head);
+	queue->cq_tail	= (unsigned int *) ((ion_byte_t *) queue->cq_ring + params->cq_off.tail);
+	queue->cq_mask	= (unsigned int *) ((ion_byte_t *) queue->cq_ring + params->cq_off.ring_mask);
+	queue->cqes		= (struct io_uring_cqe *) ((ion_byte_t *) queue->cq_ring + params->cq_off.cqes);
+
+	return err_ok;
+}
+
+/**
+@brief		Unmaps the rings of a queue and closes its io_uring instance.
+@param		queue
+				The queue.
+*/
+static void
+ion_file_queue_unmap(
+	ion_file_queue_t *queue
+) {
+	if (NULL != queue->sqes) {
+		munmap(queue->sqes, queue->sqes_size);
+	}
+
+	if ((NULL != queue->cq_ring) && (queue->cq_ring != queue->sq_ring)) {
+		munmap(queue->cq_ring, queue->cq_ring_size);
+	}
+
+	if (NULL != queue->sq_ring) {
+		munmap(queue->sq_ring, queue->sq_ring_size);
+	}
+
+	close(queue->ring);
+
+	queue->sqes		= NULL;
+	queue->cq_ring	= NULL;
+	queue->sq_ring	= NULL;
+	queue->ring		= -1;
+	queue->async	= boolean_false;
+}
+
+/**
+@brief		Records the outcome of a read.
+@param		queue
+				The queue the read was in.
+@param		read
+				The read.
+@param		error
+				Its outcome.
+*/
+static void
+ion_file_queue_finish(
+	ion_file_queue_t	*queue,
+	ion_file_read_t		*read,
+	ion_err_t			error
+) {
+	read->error = error;
+
+	if ((err_ok != error) && (err_ok == queue->error)) {
+		queue->error = error;
+	}
+
+#if ION_FILE_STATS
+	ion_file_stats_account(&read->file->io, read->file->owner_io, ion_file_io_read, read->num_bytes, read->start);
+#endif
+}
+
+/**
+@brief		Records what the kernel returned for a read.
+@param		queue
+				The queue the read was in.
+@param		read
+				The read.
+@param		result
+				Bytes read, or a negated @c errno.
+*/
+static void
+ion_file_queue_complete(
+	ion_file_queue_t	*queue,
+	ion_file_read_t		*read,
+	int					result
+) {
+	if (result < 0) {
+		ion_file_queue_finish(queue, read, err_file_read_error);
+	}
+	else if ((unsigned int) result < read->num_bytes) {
+		/* Short reads are rare enough for files that the rest is read in
+		   place. Past the end of the file this fails, as a read should. */
+		ion_file_queue_finish(queue, read, ion_fread_at(read->file, read->offset + result, read->num_bytes - result, read->write_to + result));
+	}
+	else {
+		ion_file_queue_finish(queue, read, err_ok);
+	}
+}
+
+/**
+@brief		Hands the kernel every queued read it does not have yet.
+@details	If the kernel refuses them, they are taken back out of the ring
+			and read synchronously, so that every queued read completes.
+@param		queue
+				The queue.
+@returns	An error code describing the result of the operation.
+*/
+static ion_err_t
+ion_file_queue_enter(
+	ion_file_queue_t *queue
+) {
+	int submitted;
+
+	while (queue->num_submitted < queue->num_queued) {
+		submitted = (int) syscall(__NR_io_uring_enter, queue->ring, queue->num_queued - queue->num_submitted, 0, 0, NULL, 0);
+
+		if (submitted >= 0) {
+			queue->num_submitted += submitted;
+		}
+		else if (EINTR != errno) {
+			/* Without polling the kernel only reads the ring inside the
+			   call, so the entries it did not take can be withdrawn. */
+			ION_FILE_QUEUE_STORE(queue->sq_tail, ION_FILE_QUEUE_LOAD(queue->sq_head));
+
+			while (queue->num_submitted < queue->num_queued) {
+				ion_file_read_t *read = queue->reads[queue->num_submitted];
+
+				ion_file_queue_finish(queue, read, ion_fread_at(read->file, read->offset, read->num_bytes, read->write_to));
+				queue->num_submitted++;
+				queue->num_completed++;
+			}
+
+			return err_file_read_error;
+		}
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Stops reading through the descriptor of the last file queued.
+@details	Entries already handed to the kernel hold on to the file
+			themselves, so only the ones still in the ring need it.
+@param		queue
+				The queue.
+@returns	An error code describing the result of the operation.
+*/
+static ion_err_t
+ion_file_queue_drop_file(
+	ion_file_queue_t *queue
+) {
+	ion_err_t error = err_ok;
+
+	if (-1 != queue->fd) {
+		error		= ion_file_queue_enter(queue);
+		close(queue->fd);
+		queue->fd	= -1;
+	}
+
+	queue->file = ION_NOFILE;
+
+	return error;
+}
+
+/**
+@brief		Gets a descriptor for a file that reads can be queued on.
+@param		queue
+				The queue.
+@param		file
+				The file.
+@returns	An error code describing the result of the operation.
+*/
+static ion_err_t
+ion_file_queue_use_file(
+	ion_file_queue_t	*queue,
+	ion_file_handle_t	file
+) {
+	FILE *stream;
+
+	ion_file_queue_drop_file(queue);
+
+	stream = ion_file_pool_acquire(file);
+
+	if (NULL == stream) {
+		return err_file_read_error;
+	}
+
+	/* Writes may still be in the stdio buffer, where the kernel cannot
+	   see them. The duplicate stays valid if the pool closes the file. */
+	if (0 == fflush(stream)) {
+		queue->fd = dup(fileno(stream));
+	}
+
+	ion_file_pool_release(file);
+
+	if (-1 == queue->fd) {
+		return err_file_read_error;
+	}
+
+	queue->file = file;
+
+	return err_ok;
+}
+
+#endif /* Clause ION_FILE_IO_URING */
+
+ion_err_t
+ion_file_queue_init(
+	ion_file_queue_t *queue
+) {
+	memset(queue, 0, sizeof(*queue));
+	queue->error = err_ok;
+
+#if ION_FILE_IO_URING
+
+	struct io_uring_params params;
+
+	memset(&params, 0, sizeof(params));
+	queue->fd	= -1;
+	queue->file = ION_NOFILE;
+	queue->ring = (int) syscall(__NR_io_uring_setup, ION_FILE_QUEUE_DEPTH, &params);
+
+	if (queue->ring < 0) {
+		/* Old kernels and sandboxes refuse io_uring. */
+		queue->ring = -1;
+		return err_ok;
+	}
+
+	queue->async = boolean_true;
+
+	if (err_ok != ion_file_queue_map(queue, &params)) {
+		ion_file_queue_unmap(queue);
+	}
+
+#endif
+
+	return err_ok;
+}
+
+ion_err_t
+ion_file_queue_read(
+	ion_file_queue_t	*queue,
+	ion_file_read_t		*read
+) {
+	read->error = err_uninitialized;
+
+#if ION_FILE_IO_URING
+
+	if (queue->async && !read->file->contained && (0 != read->num_bytes)) {
+		struct io_uring_sqe *entry;
+		unsigned int		tail;
+		ion_err_t			error;
+
+		if (ION_FILE_QUEUE_DEPTH == queue->num_queued) {
+			/* The error, if any, is kept for the caller's own wait. */
+			queue->error = ion_file_queue_wait(queue);
+		}
+
+		if (queue->file != read->file) {
+			error = ion_file_queue_use_file(queue, read->file);
+
+			if (err_ok != error) {
+				ion_file_queue_finish(queue, read, error);
+				return error;
+			}
+		}
+
+#if ION_FILE_STATS
+		read->start = ion_file_stats_now();
+#endif
+
+		queue->reads[queue->num_queued]				= read;
+		queue->buffers[queue->num_queued].iov_base	= read->write_to;
+		queue->buffers[queue->num_queued].iov_len	= read->num_bytes;
+
+		tail										= *queue->sq_tail;
+		entry										= &queue->sqes[tail & *queue->sq_mask];
+
+		memset(entry, 0, sizeof(*entry));
+		entry->opcode								= IORING_OP_READV;
+		entry->fd									= queue->fd;
+		entry->off									= read->offset;
+		entry->addr									= (uintptr_t) &queue->buffers[queue->num_queued];
+		entry->len									= 1;
+		entry->user_data							= queue->num_queued;
+
+		queue->sq_array[tail & *queue->sq_mask]		= tail & *queue->sq_mask;
+		ION_FILE_QUEUE_STORE(queue->sq_tail, tail + 1);
+		queue->num_queued++;
+
+		return err_ok;
+	}
+
+#endif
+
+	/* Without io_uring each read is simply done now. */
+	read->error = ion_fread_at(read->file, read->offset, read->num_bytes, read->write_to);
+
+	if ((err_ok != read->error) && (err_ok == queue->error)) {
+		queue->error = read->error;
+	}
+
+	return read->error;
+}
+
+ion_err_t
+ion_file_queue_submit(
+	ion_file_queue_t *queue
+) {
+#if ION_FILE_IO_URING
+
+	if (queue->async) {
+		return ion_file_queue_enter(queue);
+	}
+
+#endif
+
+	UNUSED(queue);
+	return err_ok;
+}
+
+ion_err_t
+ion_file_queue_wait(
+	ion_file_queue_t *queue
+) {
+	ion_err_t error;
+
+#if ION_FILE_IO_URING
+
+	if (queue->async) {
+		struct io_uring_cqe *completion;
+		unsigned int		head;
+
+		ion_file_queue_drop_file(queue);
+
+		while (queue->num_completed < queue->num_submitted) {
+			head = *queue->cq_head;
+
+			if (head == ION_FILE_QUEUE_LOAD(queue->cq_tail)) {
+				/* Reads in flight write into the caller's memory, so
+				   there is no giving up on them. */
+				syscall(__NR_io_uring_enter, queue->ring, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+				continue;
+			}
+
+			completion = &queue->cqes[head & *queue->cq_mask];
+			ion_file_queue_complete(queue, queue->reads[completion->user_data], completion->res);
+			ION_FILE_QUEUE_STORE(queue->cq_head, head + 1);
+			queue->num_completed++;
+		}
+
+		queue->num_queued		= 0;
+		queue->num_submitted	= 0;
+		queue->num_completed	= 0;
+	}
+
+#endif
+
+	error			= queue->error;
+	queue->error	= err_ok;
+
+	return error;
+}
+
+void
+ion_file_queue_destroy(
+	ion_file_queue_t *queue
+) {
+	ion_file_queue_wait(queue);
+
+#if ION_FILE_IO_URING
+
+	if (-1 != queue->ring) {
+		ion_file_queue_unmap(queue);
+	}
+
+#endif
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Key of the queue of each thread.
+*/
+static pthread_key_t	ion_file_queue_key;
+static pthread_once_t	ion_file_queue_key_once = PTHREAD_ONCE_INIT;
+
+/**
+@brief		Releases the queue of a thread that is exiting.
+@param		queue
+				The queue.
+*/
+static void
+ion_file_queue_free(
+	void *queue
+) {
+	ion_file_queue_destroy(queue);
+	free(queue);
+}
+
+/**
+@brief		Creates @ref ion_file_queue_key, once per process.
+*/
+static void
+ion_file_queue_create_key(
+	void
+) {
+	pthread_key_create(&ion_file_queue_key, ion_file_queue_free);
+}
+
+ion_err_t
+ion_file_queue_local(
+	ion_file_queue_t **queue
+) {
+	ion_err_t error;
+
+	pthread_once(&ion_file_queue_key_once, ion_file_queue_create_key);
+	*queue = pthread_getspecific(ion_file_queue_key);
+
+	if (NULL != *queue) {
+		return err_ok;
+	}
+
+	*queue = malloc(sizeof(ion_file_queue_t));
+
+	if (NULL == *queue) {
+		return err_out_of_memory;
+	}
+
+	error = ion_file_queue_init(*queue);
+
+	if ((err_ok == error) && (0 != pthread_setspecific(ion_file_queue_key, *queue))) {
+		ion_file_queue_destroy(*queue);
+		error = err_out_of_memory;
+	}
+
+	if (err_ok != error) {
+		free(*queue);
+		*queue = NULL;
+	}
+
+	return error;
+}
+
+#else /* Clause ION_THREAD_SAFE */
+
+/**
+@brief		The one queue of a process without threads.
+*/
+static ion_file_queue_t ion_file_queue_shared;
+
+/**
+@brief		Whether @ref ion_file_queue_shared has been set up.
+*/
+static ion_boolean_t ion_file_queue_shared_ready = boolean_false;
+
+ion_err_t
+ion_file_queue_local(
+	ion_file_queue_t **queue
+) {
+	ion_err_t error;
+
+	if (!ion_file_queue_shared_ready) {
+		error = ion_file_queue_init(&ion_file_queue_shared);
+
+		if (err_ok != error) {
+			return error;
+		}
+
+		ion_file_queue_shared_ready = boolean_true;
+	}
+
+	*queue = &ion_file_queue_shared;
+
+	return err_ok;
+}
+
+#endif /* Clause ION_THREAD_SAFE */
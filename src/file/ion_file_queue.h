@@ -0,0 +1,235 @@
+/******************************************************************************/
+/**
+@file		ion_file_queue.h
+@author		IonDB Project
+@brief		Reads that are issued many at a time and waited for together.
+@details	A structure that knows several locations it needs, such as the
+			buckets of a batch of keys, queues a read for each and then
+			waits for all of them. With io_uring the reads are in flight at
+			the same time, so the device sees a queue deep enough to keep
+			it busy. Elsewhere each read is done as it is queued.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(ION_FILE_QUEUE_H_)
+#define ION_FILE_QUEUE_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "ion_file.h"
+
+#if ION_FILE_IO_URING
+#include <sys/uio.h>
+#endif
+
+#if !defined(ION_FILE_QUEUE_DEPTH)
+/**
+@brief		Default number of reads a queue keeps in flight at once. A
+			queue that fills up waits for what it holds before taking more.
+*/
+#define ION_FILE_QUEUE_DEPTH 64
+#endif
+
+/**
+@brief		A read queued with @ref ion_file_queue_read.
+@details	The read, and the memory it reads into, belongs to the queue
+			until @ref ion_file_queue_wait returns.
+*/
+typedef struct {
+	ion_file_handle_t	file;		/**< The file to read. */
+	ion_file_offset_t	offset;		/**< Where in the file to start. */
+	unsigned int		num_bytes;	/**< How many bytes to read. */
+	ion_byte_t			*write_to;	/**< Where to put them. */
+	ion_err_t			error;		/**< The outcome, once the read is
+										 done. */
+#if ION_FILE_STATS
+	uint64_t			start;		/**< When the read was queued. */
+#endif
+} ion_file_read_t;
+
+/**
+@brief		A queue of reads.
+@details	A queue is used by one thread at a time. The files it reads
+			must not be written between the first read queued on them and
+			the following @ref ion_file_queue_wait.
+*/
+typedef struct {
+	ion_boolean_t		async;							/**< Whether reads
+															 are handed to
+															 the kernel
+															 rather than
+															 done as they
+															 are queued. */
+	unsigned int		num_queued;						/**< Reads queued
+															 since the last
+															 wait. */
+	ion_err_t			error;							/**< The first
+															 error since the
+															 last wait. */
+#if ION_FILE_IO_URING
+	unsigned int		num_submitted;					/**< Queued reads
+															 the kernel has
+															 taken. */
+	unsigned int		num_completed;					/**< Submitted
+															 reads that are
+															 done. */
+	ion_file_read_t		*reads[ION_FILE_QUEUE_DEPTH];	/**< The queued
+															 reads. */
+	struct iovec		buffers[ION_FILE_QUEUE_DEPTH];	/**< Where each
+															 queued read
+															 goes. */
+	ion_file_handle_t	file;							/**< The file of
+															 the last read
+															 queued. */
+	int					fd;								/**< A descriptor
+															 of our own for
+															 @c file, so that
+															 the pool may
+															 close its own. */
+	int					ring;							/**< The io_uring
+															 instance. */
+	void				*sq_ring;						/**< The mapped
+															 submission
+															 ring. */
+	size_t				sq_ring_size;					/**< Its size. */
+	void				*cq_ring;						/**< The mapped
+															 completion
+															 ring, which may
+															 be @c sq_ring. */
+	size_t				cq_ring_size;					/**< Its size. */
+	struct io_uring_sqe *sqes;							/**< The mapped
+															 submission
+															 entries. */
+	size_t				sqes_size;						/**< Their size. */
+	unsigned int		*sq_tail;						/**< Ring indices
+															 shared with the
+															 kernel. */
+	unsigned int		*sq_head;
+	unsigned int		*sq_mask;
+	unsigned int		*sq_array;
+	unsigned int		*cq_head;
+	unsigned int		*cq_tail;
+	unsigned int		*cq_mask;
+	struct io_uring_cqe *cqes;							/**< The completion
+															 entries. */
+#endif
+} ion_file_queue_t;
+
+/**
+@brief		Sets up a queue.
+@details	Falls back to synchronous reads, rather than failing, if the
+			kernel does not offer io_uring.
+@param		queue
+				The queue to set up.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_file_queue_init(
+	ion_file_queue_t *queue
+);
+
+/**
+@brief		Queues a read.
+@details	The read may start right away, but is only known to be done
+			once @ref ion_file_queue_wait returns. Reads do not move the
+			position of their file.
+@param		queue
+				The queue.
+@param		read
+				The read, with its file, offset, size and destination
+				filled in. Its @c error is set when it completes.
+@returns	An error code describing the result of the operation. Errors
+			of the read itself are also reported by the next wait.
+*/
+ion_err_t
+ion_file_queue_read(
+	ion_file_queue_t	*queue,
+	ion_file_read_t		*read
+);
+
+/**
+@brief		Starts every queued read without waiting for any of them.
+@param		queue
+				The queue.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_file_queue_submit(
+	ion_file_queue_t *queue
+);
+
+/**
+@brief		Waits for every queued read to complete.
+@param		queue
+				The queue, which is empty afterwards.
+@returns	The first error of a read queued since the last wait, or
+			@c err_ok.
+*/
+ion_err_t
+ion_file_queue_wait(
+	ion_file_queue_t *queue
+);
+
+/**
+@brief		Waits for any reads still queued and releases a queue.
+@param		queue
+				The queue.
+*/
+void
+ion_file_queue_destroy(
+	ion_file_queue_t *queue
+);
+
+/**
+@brief		Gets the calling thread's own queue, setting it up on first use.
+@details	Structures that read in batches take this queue rather than
+			setting one up each time, which with io_uring costs a handful
+			of system calls. The queue is empty when it is handed out, and
+			must be waited for before anything else on the thread may use
+			it. Without @ref ION_THREAD_SAFE there is a single queue, kept
+			for the life of the process. Otherwise each queue is released
+			when its thread exits.
+@param		queue
+				Set to the queue.
+@returns	An error code describing the result of the operation.
+*/
+ion_err_t
+ion_file_queue_local(
+	ion_file_queue_t **queue
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* ION_FILE_QUEUE_H_ */
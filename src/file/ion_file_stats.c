@@ -0,0 +1,243 @@
+/******************************************************************************/
+/**
+@file		ion_file_stats.c
+@author		IonDB Project
+@brief		Implementation of I/O accounting for the file layer.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+/* Needed for clock_gettime; must come before any system header. */
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "ion_file_stats.h"
+
+#if ION_FILE_STATS
+
+#include <time.h>
+
+/**
+@brief		Counters of one owner.
+*/
+typedef struct ion_file_owner_node {
+	ion_file_owner_t			owner;	/**< The owner. */
+	ion_file_io_stats_t			stats;	/**< Its counters. */
+	struct ion_file_owner_node	*next;	/**< Next owner in the list. */
+} ion_file_owner_node_t;
+
+/**
+@brief		Every owner that has been given counters. Nodes are never
+			freed, since open files hold pointers to their counters.
+*/
+static ion_file_owner_node_t *ion_file_owners = NULL;
+
+/**
+@brief		Counters of all I/O.
+*/
+static ion_file_io_stats_t ion_file_total_stats;
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Guards every set of counters and the owner list.
+*/
+static ion_mutex_t ion_file_stats_lock = ION_MUTEX_INITIALIZER;
+
+#endif
+
+/**
+@brief		Adds one call to a set of counters.
+*/
+static void
+ion_file_stats_add(
+	ion_file_io_stats_t *stats,
+	ion_file_io_op_t	op,
+	uint32_t			num_bytes,
+	uint64_t			elapsed
+) {
+	switch (op) {
+		case ion_file_io_read:
+			stats->reads++;
+			stats->bytes_read	+= num_bytes;
+			stats->read_ns		+= elapsed;
+			break;
+
+		case ion_file_io_write:
+			stats->writes++;
+			stats->bytes_written	+= num_bytes;
+			stats->write_ns			+= elapsed;
+			break;
+
+		case ion_file_io_seek:
+			stats->seeks++;
+			stats->seek_ns += elapsed;
+			break;
+
+		case ion_file_io_flush:
+			stats->flushes++;
+			stats->seek_ns += elapsed;
+			break;
+	}
+}
+
+uint64_t
+ion_file_stats_now(
+	void
+) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+void
+ion_file_stats_account(
+	ion_file_io_stats_t *file_io,
+	ion_file_io_stats_t *owner_io,
+	ion_file_io_op_t	op,
+	uint32_t			num_bytes,
+	uint64_t			start
+) {
+	uint64_t elapsed = ion_file_stats_now() - start;
+
+	ION_MUTEX_LOCK(ion_file_stats_lock);
+
+	ion_file_stats_add(file_io, op, num_bytes, elapsed);
+	ion_file_stats_add(&ion_file_total_stats, op, num_bytes, elapsed);
+
+	if (NULL != owner_io) {
+		ion_file_stats_add(owner_io, op, num_bytes, elapsed);
+	}
+
+	ION_MUTEX_UNLOCK(ion_file_stats_lock);
+}
+
+void
+ion_file_stats_copy(
+	ion_file_io_stats_t			*to,
+	const ion_file_io_stats_t	*from
+) {
+	ION_MUTEX_LOCK(ion_file_stats_lock);
+	*to = *from;
+	ION_MUTEX_UNLOCK(ion_file_stats_lock);
+}
+
+ion_file_io_stats_t *
+ion_file_owner_stats(
+	ion_file_owner_t owner
+) {
+	ion_file_owner_node_t *node;
+
+	ION_MUTEX_LOCK(ion_file_stats_lock);
+
+	for (node = ion_file_owners; NULL != node; node = node->next) {
+		if (owner == node->owner) {
+			break;
+		}
+	}
+
+	if (NULL == node) {
+		node = calloc(1, sizeof(ion_file_owner_node_t));
+
+		if (NULL != node) {
+			node->owner		= owner;
+			node->next		= ion_file_owners;
+			ion_file_owners = node;
+		}
+	}
+
+	ION_MUTEX_UNLOCK(ion_file_stats_lock);
+
+	return NULL == node ? NULL : &node->stats;
+}
+
+void
+ion_file_get_total_stats(
+	ion_file_io_stats_t *stats
+) {
+	ion_file_stats_copy(stats, &ion_file_total_stats);
+}
+
+void
+ion_file_reset_owner_stats(
+	ion_file_owner_t owner
+) {
+	ion_file_owner_node_t *node;
+
+	ION_MUTEX_LOCK(ion_file_stats_lock);
+
+	for (node = ion_file_owners; NULL != node; node = node->next) {
+		if (owner == node->owner) {
+			memset(&node->stats, 0, sizeof(node->stats));
+			break;
+		}
+	}
+
+	ION_MUTEX_UNLOCK(ion_file_stats_lock);
+}
+
+void
+ion_file_reset_all_stats(
+	void
+) {
+	ion_file_owner_node_t *node;
+
+	ION_MUTEX_LOCK(ion_file_stats_lock);
+
+	for (node = ion_file_owners; NULL != node; node = node->next) {
+		memset(&node->stats, 0, sizeof(node->stats));
+	}
+
+	memset(&ion_file_total_stats, 0, sizeof(ion_file_total_stats));
+
+	ION_MUTEX_UNLOCK(ion_file_stats_lock);
+}
+
+void
+ion_file_stats_accumulate(
+	ion_file_io_stats_t			*total,
+	const ion_file_io_stats_t	*after,
+	const ion_file_io_stats_t	*before
+) {
+	total->reads			+= after->reads - before->reads;
+	total->writes			+= after->writes - before->writes;
+	total->seeks			+= after->seeks - before->seeks;
+	total->flushes			+= after->flushes - before->flushes;
+	total->bytes_read		+= after->bytes_read - before->bytes_read;
+	total->bytes_written	+= after->bytes_written - before->bytes_written;
+	total->read_ns			+= after->read_ns - before->read_ns;
+	total->write_ns			+= after->write_ns - before->write_ns;
+	total->seek_ns			+= after->seek_ns - before->seek_ns;
+}
+
+#endif /* Clause ION_FILE_STATS */
@@ -0,0 +1,217 @@
+/******************************************************************************/
+/**
+@file		ion_file_stats.h
+@author		IonDB Project
+@brief		I/O accounting for the file layer.
+@details	Every read, write, seek and flush made through @ref ion_file.h
+			is counted, with its byte count and elapsed time, against the
+			file it was made on, against the owner the file was tagged with
+			through @ref ion_file_set_owner, and against process-wide
+			totals. Dictionaries tag their files with their ID, so the
+			counters of an owner are the I/O of one dictionary.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#if !defined(ION_FILE_STATS_H_)
+#define ION_FILE_STATS_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "../key_value/kv_system.h"
+
+#if ION_FILE_STATS
+
+/**
+@brief		Identifies who a file's I/O is charged to. Dictionaries use
+			their @ref ion_dictionary_id_t.
+*/
+typedef unsigned int ion_file_owner_t;
+
+/**
+@brief		The owner of files that have not been tagged.
+*/
+#define ION_FILE_NO_OWNER ((ion_file_owner_t) -1)
+
+/**
+@brief		I/O counters.
+*/
+typedef struct {
+	uint64_t	reads;			/**< Read calls. */
+	uint64_t	writes;			/**< Write calls. */
+	uint64_t	seeks;			/**< Seek calls. */
+	uint64_t	flushes;		/**< Flush calls. */
+	uint64_t	bytes_read;		/**< Bytes requested by reads. */
+	uint64_t	bytes_written;	/**< Bytes requested by writes. */
+	uint64_t	read_ns;		/**< Time spent reading. */
+	uint64_t	write_ns;		/**< Time spent writing. */
+	uint64_t	seek_ns;		/**< Time spent seeking and flushing. */
+} ion_file_io_stats_t;
+
+/**
+@brief		The kinds of I/O that are counted.
+*/
+typedef enum {
+	ion_file_io_read,	/**< A read. */
+	ion_file_io_write,	/**< A write. */
+	ion_file_io_seek,	/**< A seek. */
+	ion_file_io_flush	/**< A flush. */
+} ion_file_io_op_t;
+
+/**
+@brief		Returns a monotonic timestamp in nanoseconds.
+*/
+uint64_t
+ion_file_stats_now(
+	void
+);
+
+/**
+@brief		Counts one I/O call against a file, its owner and the totals.
+@param		file_io
+				Counters of the file.
+@param		owner_io
+				Counters of the file's owner, or @c NULL if it has none.
+@param		op
+				The kind of call.
+@param		num_bytes
+				Bytes transferred by a read or write.
+@param		start
+				A timestamp from @ref ion_file_stats_now taken before the
+				call.
+*/
+void
+ion_file_stats_account(
+	ion_file_io_stats_t *file_io,
+	ion_file_io_stats_t *owner_io,
+	ion_file_io_op_t	op,
+	uint32_t			num_bytes,
+	uint64_t			start
+);
+
+/**
+@brief		Copies a set of counters while no I/O is being counted into it.
+@details	Counters may be updated by other threads in thread-safe builds,
+			so they must be read through this rather than directly.
+@param		to
+				Written with the counters.
+@param		from
+				The counters to read.
+*/
+void
+ion_file_stats_copy(
+	ion_file_io_stats_t			*to,
+	const ion_file_io_stats_t	*from
+);
+
+/**
+@brief		Returns the counters of an owner, creating them if needed.
+@details	The counters stay at the same address for the life of the
+			process, so callers may keep the pointer.
+@param		owner
+				The owner.
+@returns	The counters, or @c NULL if they could not be allocated.
+*/
+ion_file_io_stats_t *
+ion_file_owner_stats(
+	ion_file_owner_t owner
+);
+
+/**
+@brief		Copies the counters of all I/O made through the file layer.
+@param		stats
+				Written with the totals.
+*/
+void
+ion_file_get_total_stats(
+	ion_file_io_stats_t *stats
+);
+
+/**
+@brief		Zeroes the counters of one owner.
+@param		owner
+				The owner.
+*/
+void
+ion_file_reset_owner_stats(
+	ion_file_owner_t owner
+);
+
+/**
+@brief		Zeroes the totals and the counters of every owner.
+*/
+void
+ion_file_reset_all_stats(
+	void
+);
+
+/**
+@brief		Adds the change between two snapshots of counters to a total.
+@param		total
+				The counters to add to.
+@param		after
+				The later snapshot.
+@param		before
+				The earlier snapshot.
+*/
+void
+ion_file_stats_accumulate(
+	ion_file_io_stats_t			*total,
+	const ion_file_io_stats_t	*after,
+	const ion_file_io_stats_t	*before
+);
+
+/**
+@brief		Starts timing an I/O call. Must be paired with
+			@ref ION_FILE_IO_END in the same block.
+*/
+#define ION_FILE_IO_BEGIN() 	uint64_t ion_file_io_start = ion_file_stats_now()
+
+/**
+@brief		Counts the I/O call timed since @ref ION_FILE_IO_BEGIN against
+			a pool entry.
+*/
+#define ION_FILE_IO_END(entry, op, num_bytes) 	ion_file_stats_account(&(entry)->io, (entry)->owner_io, (op), (num_bytes), ion_file_io_start)
+
+#else /* Clause ION_FILE_STATS */
+
+#define ION_FILE_IO_BEGIN()
+#define ION_FILE_IO_END(entry, op, num_bytes)
+
+#endif /* Clause ION_FILE_STATS */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* ION_FILE_STATS_H_ */
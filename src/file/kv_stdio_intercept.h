@@ -66,6 +66,7 @@ extern "C" {
 #define  feof(x)			sd_feof(x)
 #define  ftell(x)			sd_ftell(x)
 #define  fremove(x)			sd_remove(x)
+#define  frename(x, y)		sd_rename(x, y)
 #define  frewind(x)			sd_rewind(x)
 #define  fdeleteall()		SD_File_Delete_All()
 #if defined(__cplusplus)
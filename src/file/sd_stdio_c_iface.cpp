@@ -345,6 +345,45 @@ sd_remove(
 	return SD.remove(filename) ? 0 : 1;
 }
 
+int
+sd_rename(
+	char	*old_filename,
+	char	*new_filename
+) {
+	File source = SD.open(old_filename, FILE_READ);
+
+	if (!source) {
+		return 1;
+	}
+
+	if (SD.exists(new_filename)) {
+		SD.remove(new_filename);
+	}
+
+	File destination = SD.open(new_filename, FILE_WRITE);
+
+	if (!destination) {
+		source.close();
+		return 1;
+	}
+
+	uint8_t copy_buffer[32];
+	int		bytes_read;
+
+	while ((bytes_read = source.read(copy_buffer, sizeof(copy_buffer))) > 0) {
+		if ((size_t) bytes_read != destination.write(copy_buffer, bytes_read)) {
+			source.close();
+			destination.close();
+			return 1;
+		}
+	}
+
+	source.close();
+	destination.close();
+
+	return SD.remove(old_filename) ? 0 : 1;
+}
+
 void
 sd_rewind(
 	SD_FILE *stream
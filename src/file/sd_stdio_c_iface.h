@@ -251,6 +251,24 @@ sd_remove(
 	char *filename
 );
 
+/**
+@brief		Rename a file on the Arduino SD file system.
+@details	The Arduino SD library has no rename, so the file is copied to
+			its new name and then removed. Unlike @c rename, this is not atomic.
+			If @p new_filename already exists, it is replaced.
+@param		old_filename
+				A pointer to the string data containing the path to the file
+				that is to be renamed.
+@param		new_filename
+				A pointer to the string data containing the new path of the file.
+@returns	@c 0 if the file was renamed successfully, @c 1 otherwise.
+*/
+int
+sd_rename(
+	char	*old_filename,
+	char	*new_filename
+);
+
 /**
 @brief		Set the file position to the beginning of the file
 			for a given Arduino SD File stream.
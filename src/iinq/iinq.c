@@ -152,34 +152,188 @@ iinq_open_source(
 	return error;
 }
 
+ion_iinq_cached_source_t *iinq_source_cache = NULL;
+
+/**
+@brief		Closes a cached source and removes it from the source cache.
+@param[in]	link
+				The link in the cache that points to the source to close.
+@return		The status of closing the source's dictionary.
+*/
+ion_err_t
+iinq_evict_source(
+	ion_iinq_cached_source_t **link
+) {
+	ion_iinq_cached_source_t	*source = *link;
+	ion_err_t					error	= ion_close_dictionary(&source->dictionary);
+
+	*link = source->next;
+	free(source->schema_file_name);
+	free(source);
+
+	return error;
+}
+
+ion_err_t
+iinq_acquire_source(
+	char				*schema_file_name,
+	ion_dictionary_t	**dictionary
+) {
+	ion_iinq_cached_source_t	**link	= &iinq_source_cache;
+	ion_iinq_cached_source_t	*source = NULL;
+
+	while (NULL != *link) {
+		if (0 == strcmp((*link)->schema_file_name, schema_file_name)) {
+			/* Move the hit to the front of the cache. */
+			source			= *link;
+			*link			= source->next;
+			source->next	= iinq_source_cache;
+			break;
+		}
+
+		link = &(*link)->next;
+	}
+
+	if (NULL == source) {
+		source = malloc(sizeof(ion_iinq_cached_source_t));
+
+		if (NULL == source) {
+			return err_out_of_memory;
+		}
+
+		source->schema_file_name = malloc(strlen(schema_file_name) + 1);
+
+		if (NULL == source->schema_file_name) {
+			free(source);
+			return err_out_of_memory;
+		}
+
+		strcpy(source->schema_file_name, schema_file_name);
+		source->dictionary.handler = &source->handler;
+
+		ion_err_t error = iinq_open_source(schema_file_name, &source->dictionary, &source->handler);
+
+		if (err_ok != error) {
+			free(source->schema_file_name);
+			free(source);
+			return error;
+		}
+
+		source->num_users	= 0;
+		source->next		= iinq_source_cache;
+	}
+
+	source->num_users++;
+	iinq_source_cache	= source;
+	*dictionary			= &source->dictionary;
+
+	return err_ok;
+}
+
+void
+iinq_release_source(
+	ion_dictionary_t *dictionary
+) {
+	ion_iinq_cached_source_t	**link			= &iinq_source_cache;
+	unsigned int				num_released	= 0;
+
+	while (NULL != *link) {
+		if (&(*link)->dictionary == dictionary) {
+			(*link)->num_users--;
+		}
+
+		/* Close the least recently used sources that are not held, beyond the cache size. */
+		if ((0 == (*link)->num_users) && (++num_released > IINQ_SOURCE_CACHE_SIZE)) {
+			iinq_evict_source(link);
+			continue;
+		}
+
+		link = &(*link)->next;
+	}
+}
+
+/**
+@brief		Finds a source in the source cache.
+@param[in]	schema_file_name
+				The schema file of the source.
+@return		The link in the cache that points to the source, or @p NULL
+			if the source is not cached.
+*/
+static ion_iinq_cached_source_t **
+iinq_find_source(
+	char *schema_file_name
+) {
+	ion_iinq_cached_source_t **link = &iinq_source_cache;
+
+	while (NULL != *link) {
+		if (0 == strcmp((*link)->schema_file_name, schema_file_name)) {
+			return link;
+		}
+
+		link = &(*link)->next;
+	}
+
+	return NULL;
+}
+
+ion_err_t
+iinq_flush_source(
+	char *schema_file_name
+) {
+	ion_iinq_cached_source_t **link = iinq_find_source(schema_file_name);
+
+	if (NULL == link) {
+		return err_ok;
+	}
+
+	if (0 < (*link)->num_users) {
+		return err_would_deadlock;
+	}
+
+	return dictionary_sync(&(*link)->dictionary);
+}
+
+ion_err_t
+iinq_close_sources(
+) {
+	ion_iinq_cached_source_t	**link	= &iinq_source_cache;
+	ion_err_t					error	= err_ok;
+
+	while (NULL != *link) {
+		if (0 == (*link)->num_users) {
+			ion_err_t close_error = iinq_evict_source(link);
+
+			if (err_ok == error) {
+				error = close_error;
+			}
+
+			continue;
+		}
+
+		link = &(*link)->next;
+	}
+
+	return error;
+}
+
 ion_status_t
 iinq_insert(
 	char		*schema_file_name,
 	ion_key_t	key,
 	ion_value_t value
 ) {
-	ion_err_t					error;
-	ion_status_t				status = ION_STATUS_INITIALIZE;
-	ion_dictionary_t			dictionary;
-	ion_dictionary_handler_t	handler;
-
-	dictionary.handler	= &handler;
-
-	error				= iinq_open_source(schema_file_name, &dictionary, &handler);
+	ion_status_t		status;
+	ion_dictionary_t	*dictionary;
+	ion_err_t			error = iinq_acquire_source(schema_file_name, &dictionary);
 
 	if (err_ok != error) {
-		status = ION_STATUS_ERROR(error);
-		goto RETURN;
+		return ION_STATUS_ERROR(error);
 	}
 
-	status	= dictionary_insert(&dictionary, key, value);
-	error	= ion_close_dictionary(&dictionary);
+	status = dictionary_insert(dictionary, key, value);
+	iinq_release_source(dictionary);
 
-	if ((err_ok == status.error) && (err_ok != error)) {
-		status.error = error;
-	}
-
-RETURN: return status;
+	return status;
 }
 
 ion_status_t
@@ -188,28 +342,18 @@ iinq_update(
 	ion_key_t	key,
 	ion_value_t value
 ) {
-	ion_err_t					error;
-	ion_status_t				status = ION_STATUS_INITIALIZE;
-	ion_dictionary_t			dictionary;
-	ion_dictionary_handler_t	handler;
-
-	dictionary.handler	= &handler;
-
-	error				= iinq_open_source(schema_file_name, &dictionary, &handler);
+	ion_status_t		status;
+	ion_dictionary_t	*dictionary;
+	ion_err_t			error = iinq_acquire_source(schema_file_name, &dictionary);
 
 	if (err_ok != error) {
-		status = ION_STATUS_ERROR(error);
-		goto RETURN;
+		return ION_STATUS_ERROR(error);
 	}
 
-	status	= dictionary_update(&dictionary, key, value);
-	error	= ion_close_dictionary(&dictionary);
-
-	if ((err_ok == status.error) && (err_ok != error)) {
-		status.error = error;
-	}
+	status = dictionary_update(dictionary, key, value);
+	iinq_release_source(dictionary);
 
-RETURN: return status;
+	return status;
 }
 
 ion_status_t
@@ -217,28 +361,18 @@ iinq_delete(
 	char		*schema_file_name,
 	ion_key_t	key
 ) {
-	ion_err_t					error;
-	ion_status_t				status = ION_STATUS_INITIALIZE;
-	ion_dictionary_t			dictionary;
-	ion_dictionary_handler_t	handler;
-
-	dictionary.handler	= &handler;
-
-	error				= iinq_open_source(schema_file_name, &dictionary, &handler);
+	ion_status_t		status;
+	ion_dictionary_t	*dictionary;
+	ion_err_t			error = iinq_acquire_source(schema_file_name, &dictionary);
 
 	if (err_ok != error) {
-		status = ION_STATUS_ERROR(error);
-		goto RETURN;
+		return ION_STATUS_ERROR(error);
 	}
 
-	status	= dictionary_delete(&dictionary, key);
-	error	= ion_close_dictionary(&dictionary);
-
-	if ((err_ok == status.error) && (err_ok != error)) {
-		status.error = error;
-	}
+	status = dictionary_delete(dictionary, key);
+	iinq_release_source(dictionary);
 
-RETURN: return status;
+	return status;
 }
 
 ion_err_t
@@ -248,10 +382,24 @@ iinq_drop(
 	ion_err_t					error;
 	ion_dictionary_t			dictionary;
 	ion_dictionary_handler_t	handler;
+	ion_iinq_cached_source_t	**link = iinq_find_source(schema_file_name);
 
-	dictionary.handler	= &handler;
+	dictionary.handler = &handler;
+
+	/* The cached source must be closed before its files can be removed. */
+	if (NULL != link) {
+		if (0 < (*link)->num_users) {
+			return err_would_deadlock;
+		}
 
-	error				= iinq_open_source(schema_file_name, &dictionary, &handler);
+		error = iinq_evict_source(link);
+
+		if (err_ok != error) {
+			return error;
+		}
+	}
+
+	error = iinq_open_source(schema_file_name, &dictionary, &handler);
 
 	if (err_ok != error) {
 		return error;
@@ -263,3 +411,97 @@ iinq_drop(
 
 	return error;
 }
+
+void
+iinq_bind_records(
+	ion_iinq_cleanup_t	*first,
+	unsigned char		*data
+) {
+	while (NULL != first) {
+		ion_iinq_source_t *source = first->reference;
+
+		source->key					= data;
+		data						+= IINQ_ALIGN(source->dictionary->instance->record.key_size);
+		source->value				= data;
+		data						+= IINQ_ALIGN(source->dictionary->instance->record.value_size);
+		source->ion_record.key		= source->key;
+		source->ion_record.value	= source->value;
+		first						= first->next;
+	}
+}
+
+ion_iinq_result_size_t
+iinq_columns_size(
+	ion_iinq_column_t	*columns,
+	unsigned int		num_columns
+) {
+	ion_iinq_result_size_t	size = 0;
+	unsigned int			i;
+
+	for (i = 0; i < num_columns; i++) {
+		size += columns[i].size;
+	}
+
+	return size;
+}
+
+ion_iinq_result_size_t
+iinq_project(
+	ion_iinq_column_t	*columns,
+	unsigned int		num_columns,
+	unsigned char		*data
+) {
+	ion_iinq_result_size_t	size = 0;
+	unsigned int			i;
+
+	for (i = 0; i < num_columns; i++) {
+		memcpy(data + size, columns[i].data, columns[i].size);
+		size += columns[i].size;
+	}
+
+	return size;
+}
+
+void
+iinq_finish_processor(
+	ion_iinq_query_processor_t *processor
+) {
+	if (NULL != processor->finish) {
+		processor->finish(processor->state);
+	}
+}
+
+ion_boolean_t
+iinq_key_condition(
+	ion_iinq_source_t		*source,
+	ion_boolean_t			planning,
+	ion_predicate_type_t	type,
+	ion_key_t				lower_bound,
+	ion_key_t				upper_bound
+) {
+	ion_dictionary_compare_t	compare		= source->dictionary->instance->compare;
+	ion_key_size_t				key_size	= source->dictionary->instance->record.key_size;
+
+	if (planning) {
+		/* Only one key condition per source is pushed down, the rest are checked per record. */
+		if (predicate_all_records == source->predicate.type) {
+			memcpy(source->lower_bound, lower_bound, key_size);
+
+			if (predicate_equality == type) {
+				dictionary_build_predicate(&source->predicate, predicate_equality, source->lower_bound);
+			}
+			else {
+				memcpy(source->upper_bound, upper_bound, key_size);
+				dictionary_build_predicate(&source->predicate, predicate_range, source->lower_bound, source->upper_bound);
+			}
+		}
+
+		return boolean_true;
+	}
+
+	if (predicate_equality == type) {
+		return 0 == compare(source->key, lower_bound, key_size);
+	}
+
+	return 0 <= compare(source->key, lower_bound, key_size) && 0 >= compare(source->key, upper_bound, key_size);
+}
@@ -43,11 +43,36 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include "../dictionary/dictionary_types.h"
 #include "../dictionary/ion_master_table.h"
 
 typedef unsigned int ion_iinq_result_size_t;
 
+/**
+@brief		The scalar types a key or value read into a result may hold.
+*/
+typedef union {
+	long long	integer;
+	double		real;
+	void		*pointer;
+} ion_iinq_max_align_t;
+
+/**
+@brief		Measures the alignment of @ref ion_iinq_max_align_t.
+*/
+typedef struct {
+	char					offset;
+	ion_iinq_max_align_t	field;
+} ion_iinq_alignment_t;
+
+/*
+ * Each key and value read into a result starts at a multiple of IINQ_ALIGNMENT, so that it can be read in place even
+ * on targets with strict alignment. IINQ_ALIGN gives the space a field of the given size takes in a result.
+ */
+#define IINQ_ALIGNMENT		offsetof(ion_iinq_alignment_t, field)
+#define IINQ_ALIGN(size)	(((size) + IINQ_ALIGNMENT - 1) / IINQ_ALIGNMENT * IINQ_ALIGNMENT)
+
 typedef struct {
 	ion_iinq_result_size_t	num_bytes;
 	unsigned char			*data;
@@ -62,12 +87,20 @@ typedef	void	(*ion_iinq_query_processor_func_t)(ion_iinq_result_t*, void*);
 #define IINQ_NEW_PROCESSOR_FUNC(name) \
 void name(ion_iinq_result_t *result, void* state)
 
+/**
+@brief		Function pointer type called once a query has produced all of its
+			results, for processors that hold results back.
+*/
+typedef void (*ion_iinq_query_finish_func_t)(void*);
+
 typedef struct {
 	ion_iinq_query_processor_func_t	execute;
 	void						*state;
+	/**> Called after the last result, may be @c NULL. */
+	ion_iinq_query_finish_func_t	finish;
 } ion_iinq_query_processor_t;
 
-#define IINQ_QUERY_PROCESSOR(execute, state)	((ion_iinq_query_processor_t){ execute, state })
+#define IINQ_QUERY_PROCESSOR(execute, state)	((ion_iinq_query_processor_t){ execute, state, NULL })
 
 typedef struct iinq_source ion_iinq_source_t;
 
@@ -77,9 +110,19 @@ typedef struct iinq_cleanup {
 	struct iinq_cleanup *last;
 } ion_iinq_cleanup_t;
 
+/**
+@brief		A column kept by SELECT: a number of bytes from the current record
+			of a source.
+*/
+typedef struct {
+	/**> Where the column is in the current record. */
+	unsigned char			*data;
+	/**> Size of the column in bytes. */
+	ion_iinq_result_size_t	size;
+} ion_iinq_column_t;
+
 struct iinq_source {
-	ion_dictionary_handler_t	handler;
-	ion_dictionary_t			dictionary;
+	ion_dictionary_t			*dictionary;
 	ion_predicate_t				predicate;
 	ion_dict_cursor_t			*cursor;
 	ion_cursor_status_t			cursor_status;
@@ -87,8 +130,39 @@ struct iinq_source {
 	ion_value_t					value;
 	ion_record_t				ion_record;
 	ion_iinq_cleanup_t			cleanup;
+	ion_key_t					lower_bound;
+	ion_key_t					upper_bound;
 };
 
+#if !defined(IINQ_SOURCE_CACHE_SIZE)
+/**
+@brief		How many sources that are not in use are kept open between IINQ
+			operations. Each one holds an open dictionary and its buffers.
+*/
+#define IINQ_SOURCE_CACHE_SIZE 4
+#endif
+
+/**
+@brief		An open source kept in the IINQ source cache.
+*/
+typedef struct iinq_cached_source {
+	/**> The schema file the source was opened from. */
+	char						*schema_file_name;
+	/**> The handler of the open dictionary. */
+	ion_dictionary_handler_t	handler;
+	/**> The open dictionary. */
+	ion_dictionary_t			dictionary;
+	/**> How many users currently hold the source. Held sources are never closed. */
+	unsigned int				num_users;
+	/**> The next cached source, in order of most to least recently used. */
+	struct iinq_cached_source	*next;
+} ion_iinq_cached_source_t;
+
+/**
+@brief		The open sources kept between IINQ operations, most recently used first.
+*/
+extern ion_iinq_cached_source_t *iinq_source_cache;
+
 ion_err_t
 iinq_create_source(
 	char				*schema_file_name,
@@ -104,6 +178,59 @@ iinq_open_source(
 	ion_dictionary_handler_t	*handler
 );
 
+/**
+@brief		Gets the open dictionary of a source, opening it only if it is not
+			already in the source cache.
+@details	The source is held until it is given back with @ref iinq_release_source.
+			Once released, it stays open for later operations, up to
+			@ref IINQ_SOURCE_CACHE_SIZE released sources.
+@param[in]	schema_file_name
+				The schema file of the source.
+@param[out]	dictionary
+				Where to write back the open dictionary.
+@return		The status of opening the source.
+*/
+ion_err_t
+iinq_acquire_source(
+	char				*schema_file_name,
+	ion_dictionary_t	**dictionary
+);
+
+/**
+@brief		Gives back a source held through @ref iinq_acquire_source.
+@param[in]	dictionary
+				The dictionary given out by @ref iinq_acquire_source.
+*/
+void
+iinq_release_source(
+	ion_dictionary_t *dictionary
+);
+
+/**
+@brief		Syncs the cached source of the given schema, so that everything
+			written through it is on disk. The source stays open.
+@details	Does nothing if the source is not cached. A source held by a
+			running query is refused, since the query may be partway
+			through writing it.
+@param[in]	schema_file_name
+				The schema file of the source.
+@return		@ref err_would_deadlock if the source is held, otherwise the
+			status of syncing the source.
+*/
+ion_err_t
+iinq_flush_source(
+	char *schema_file_name
+);
+
+/**
+@brief		Closes every cached source that is not held by a running query.
+			This should be called at the end of a session.
+@return		The status of closing the sources.
+*/
+ion_err_t
+iinq_close_sources(
+);
+
 ion_status_t
 iinq_insert(
 	char		*schema_file_name,
@@ -124,11 +251,106 @@ iinq_delete(
 	ion_key_t	key
 );
 
+/**
+@brief		Deletes the source of the given schema, and its schema file.
+@details	A cached source is closed first. A source held by a running
+			query is refused, and nothing is deleted.
+@param[in]	schema_file_name
+				The schema file of the source.
+@return		@ref err_would_deadlock if the source is held, otherwise the
+			status of deleting the source.
+*/
 ion_err_t
 iinq_drop(
 		char *schema_file_name
 );
 
+/**
+@brief		Tells a processor that no more results are coming.
+@param[in]	processor
+				The processor the results were given to.
+*/
+void
+iinq_finish_processor(
+	ion_iinq_query_processor_t *processor
+);
+
+/**
+@brief		Points the record of each source of a query into the result, one
+			after the other as key then value, so that its cursor reads
+			straight into it. Each key and value is padded to
+			@ref IINQ_ALIGN of its size.
+@param[in]	first
+				The first source of the query.
+@param[in]	data
+				The result, large enough to hold a record of each source.
+*/
+void
+iinq_bind_records(
+	ion_iinq_cleanup_t	*first,
+	unsigned char		*data
+);
+
+/**
+@brief		Returns how many bytes the given SELECT columns take.
+@param[in]	columns
+				The columns.
+@param[in]	num_columns
+				How many columns there are.
+@return		The total size of the columns.
+*/
+ion_iinq_result_size_t
+iinq_columns_size(
+	ion_iinq_column_t	*columns,
+	unsigned int		num_columns
+);
+
+/**
+@brief		Copies the given SELECT columns one after the other.
+@param[in]	columns
+				The columns.
+@param[in]	num_columns
+				How many columns there are.
+@param[out]	data
+				Where to copy the columns to.
+@return		The total size of the columns.
+*/
+ion_iinq_result_size_t
+iinq_project(
+	ion_iinq_column_t	*columns,
+	unsigned int		num_columns,
+	unsigned char		*data
+);
+
+/**
+@brief		Checks a key condition of a WHERE clause against the current
+			record of a source.
+@details	While a query is being planned, the condition is instead pushed
+			down into the predicate the source is scanned with, as long as the
+			source is not already restricted by another key condition. Conditions
+			that are not pushed down are still checked on every record.
+@param[in]	source
+				The source whose key is tested.
+@param[in]	planning
+				Whether the query is being planned rather than run.
+@param[in]	type
+				Either @ref predicate_equality or @ref predicate_range.
+@param[in]	lower_bound
+				The key to match, or the smallest key in the range.
+@param[in]	upper_bound
+				The largest key in the range. Ignored for equality.
+@return		Whether the current key of the source satisfies the condition.
+			Always @ref boolean_true while planning.
+*/
+ion_boolean_t
+iinq_key_condition(
+	ion_iinq_source_t		*source,
+	ion_boolean_t			planning,
+	ion_predicate_type_t	type,
+	ion_key_t				lower_bound,
+	ion_key_t				upper_bound
+);
+
 #define CREATE_DICTIONARY(schema_name, key_type, key_size, value_size) \
 iinq_create_source(#schema_name ".inq", key_type, key_size, value_size)
 
@@ -136,7 +358,7 @@ iinq_create_source(#schema_name ".inq", key_type, key_size, value_size)
 iinq_insert(#schema_name ".inq", key, value)
 
 #define UPDATE(schema_name, key, value) \
-iinq_insert(#schema_name ".inq", key, value)
+iinq_update(#schema_name ".inq", key, value)
 
 #define DELETE_FROM(schema_name, key) \
 iinq_delete(#schema_name ".inq", key)
@@ -144,16 +366,34 @@ iinq_delete(#schema_name ".inq", key)
 #define DROP(schema_name)\
 iinq_drop(#schema_name ".inq")
 
-#define SELECT_ALL \
-ion_iinq_result_size_t result_loc	= 0; \
-ion_iinq_cleanup_t *copyer			= first; \
-while (NULL != copyer) { \
-	memcpy(result.data+(result_loc), copyer->reference->key, copyer->reference->dictionary.instance->record.key_size); \
-	result_loc += copyer->reference->dictionary.instance->record.key_size; \
-	memcpy(result.data+(result_loc), copyer->reference->value, copyer->reference->dictionary.instance->record.value_size); \
-	result_loc += copyer->reference->dictionary.instance->record.value_size; \
-	copyer						= copyer->next; \
-}
+/*
+ * The cursors read each record straight into the result, laid out as the key and value of each source in FROM order,
+ * so selecting everything copies nothing. Each key and value takes IINQ_ALIGN of its size.
+ */
+#define SELECT_ALL
+
+/*
+ * Columns for SELECT. A column points into the current record of its source.
+ */
+#define KEY_OF(source) \
+	((ion_iinq_column_t) { (unsigned char *) (source).key, (source).dictionary->instance->record.key_size })
+
+#define VALUE_OF(source) \
+	((ion_iinq_column_t) { (unsigned char *) (source).value, (source).dictionary->instance->record.value_size })
+
+#define VALUE_FIELD(source, offset, size) \
+	((ion_iinq_column_t) { (unsigned char *) (source).value + (offset), (size) })
+
+/*
+ * SELECT takes the columns to keep, and passes on only those, one after the other.
+ */
+#define SELECT(...) \
+	ion_iinq_column_t query_columns[] = { __VA_ARGS__ }; \
+	if (NULL == query_projection) { \
+		query_projection = alloca(iinq_columns_size(query_columns, sizeof(query_columns) / sizeof(ion_iinq_column_t))); \
+	} \
+	result.data			= query_projection; \
+	result.num_bytes	= iinq_project(query_columns, sizeof(query_columns) / sizeof(ion_iinq_column_t), query_projection);
 
 #define _FROM_SOURCE_SINGLE(source) \
 	ion_iinq_source_t source; \
@@ -168,22 +408,42 @@ while (NULL != copyer) { \
 	} \
 	last						= &source.cleanup; \
 	source.cleanup.next			= NULL; \
-	source.dictionary.handler	= &source.handler; \
-	error						= iinq_open_source(#source ".inq", &(source.dictionary), &(source.handler)); \
-	if (err_ok != error) { \
-		break; \
+	source.cursor				= NULL; \
+	source.dictionary			= NULL; \
+	/* Once a source fails, the rest are skipped and the query goes straight to its cleanup. */ \
+	if (err_ok == error) { \
+		error					= iinq_acquire_source(#source ".inq", &(source.dictionary)); \
 	} \
-	source.key					= alloca(source.dictionary.instance->record.key_size); \
-	source.value				= alloca(source.dictionary.instance->record.value_size); \
-	source.ion_record.key		= source.key; \
-	source.ion_record.value		= source.value; \
-	result.num_bytes			+= source.dictionary.instance->record.key_size; \
-	result.num_bytes			+= source.dictionary.instance->record.value_size; \
-	error						= dictionary_build_predicate(&(source.predicate), predicate_all_records); \
-	if (err_ok != error) { \
-		break; \
-	} \
-	dictionary_find(&source.dictionary, &source.predicate, &source.cursor);
+	if (err_ok == error) { \
+		source.lower_bound		= alloca(source.dictionary->instance->record.key_size); \
+		source.upper_bound		= alloca(source.dictionary->instance->record.key_size); \
+		result.num_bytes		+= IINQ_ALIGN(source.dictionary->instance->record.key_size); \
+		result.num_bytes		+= IINQ_ALIGN(source.dictionary->instance->record.value_size); \
+		error					= dictionary_build_predicate(&(source.predicate), predicate_all_records); \
+	}
+
+/* Opens the cursors of all sources once the WHERE clause has been planned. */
+#define _FROM_START_CURSORS \
+		ref_cursor	= first; \
+		while (NULL != ref_cursor) { \
+			error		= dictionary_find(ref_cursor->reference->dictionary, &ref_cursor->reference->predicate, &ref_cursor->reference->cursor); \
+			if (err_ok != error) { \
+				break; \
+			} \
+			ref_cursor	= ref_cursor->next; \
+		} \
+		if (err_ok != error) { \
+			break; \
+		} \
+		ref_cursor	= first; \
+		/* Initialize all cursors except the last one. */ \
+		while (ref_cursor != last) { \
+			if (NULL == ref_cursor || (cs_cursor_active != (ref_cursor->reference->cursor_status = ref_cursor->reference->cursor->next(ref_cursor->reference->cursor, &ref_cursor->reference->ion_record)) && cs_cursor_initialized != ref_cursor->reference->cursor_status)) { \
+				break; \
+			} \
+			ref_cursor = ref_cursor->next; \
+		} \
+		ref_cursor	= last;
 
 #define _FROM_CHECK_CURSOR_SINGLE(source) \
 	(cs_cursor_active == (source.cursor_status = source.cursor->next(source.cursor, &source.ion_record)) || cs_cursor_initialized == source.cursor_status)
@@ -196,9 +456,11 @@ while (NULL != copyer) { \
 		/* Keep going backwards through sources until we find one we can advance. If we re-initialize any cursors, reset ref_cursor to last. */ \
 		while (NULL != ref_cursor && (cs_cursor_active != (ref_cursor->reference->cursor_status = ref_cursor->reference->cursor->next(ref_cursor->reference->cursor, &ref_cursor->reference->ion_record)) && cs_cursor_initialized != ref_cursor->reference->cursor_status)) { \
 			ref_cursor->reference->cursor->destroy(&ref_cursor->reference->cursor); \
-			dictionary_find(&ref_cursor->reference->dictionary, &ref_cursor->reference->predicate, &ref_cursor->reference->cursor); \
+			dictionary_find(ref_cursor->reference->dictionary, &ref_cursor->reference->predicate, &ref_cursor->reference->cursor); \
 			if ((cs_cursor_active != (ref_cursor->reference->cursor_status = ref_cursor->reference->cursor->next(ref_cursor->reference->cursor, &ref_cursor->reference->ion_record)) && cs_cursor_initialized != ref_cursor->reference->cursor_status)) { \
-				goto IINQ_QUERY_CLEANUP; \
+				/* Nothing is left to produce, this ends the query. */ \
+				ref_cursor = NULL; \
+				break; \
 			} \
 			ref_cursor	= ref_cursor->last; \
 		} \
@@ -243,42 +505,125 @@ while (NULL != copyer) { \
 	ref_cursor	= NULL; \
 	last_cursor	= NULL; \
 	_FROM_SOURCES(__VA_ARGS__) \
-	result.data	= alloca(result.num_bytes); \
-	ref_cursor	= first; \
-	/* Initialize all cursors except the last one. */ \
-	while (ref_cursor != last) { \
-		if (NULL == ref_cursor || (cs_cursor_active != (ref_cursor->reference->cursor_status = ref_cursor->reference->cursor->next(ref_cursor->reference->cursor, &ref_cursor->reference->ion_record)) && cs_cursor_initialized != ref_cursor->reference->cursor_status)) { \
-			break; \
-		} \
-		ref_cursor = ref_cursor->next; \
+	if (err_ok == error) { \
+		result.data	= alloca(result.num_bytes); \
+		/* So that the padding between fields passed on is never uninitialized. */ \
+		memset(result.data, 0, result.num_bytes); \
+		iinq_bind_records(first, result.data); \
 	} \
-	ref_cursor	= last; \
-	while (1) { \
-		_FROM_ADVANCE_CURSORS
+	/* The first pass through the loop plans the WHERE clause and opens the cursors. */ \
+	planning	= boolean_true; \
+	while (err_ok == error) { \
+		if (!planning) { \
+			_FROM_ADVANCE_CURSORS \
+		}
 /*if (!_FROM_CHECK_CURSOR(__VA_ARGS__)) {*/ \
 		/*	break; */ \
 		/*}*/
 
-#define WHERE(condition) (condition)
+/*
+ * Key conditions. The keys are given as ion_key_t, e.g. using IONIZE. Used as arguments of WHERE, they are only
+ * checked against every record. Listed as the key hints of WHERE_KEYS, the first one given for a source is also
+ * pushed down into the predicate the source is scanned with, so that only matching keys are ever read.
+ */
+#define KEY_EQUAL(source, key) \
+	iinq_key_condition(&(source), planning, predicate_equality, (key), (key))
+
+#define KEY_RANGE(source, lower_bound, upper_bound) \
+	iinq_key_condition(&(source), planning, predicate_range, (lower_bound), (upper_bound))
+
+#define _WHERE_PLAN_SINGLE(key_condition) (void) (key_condition)
+
+#define _WHERE_PLAN_1(_1) _WHERE_PLAN_SINGLE(_1)
+#define _WHERE_PLAN_2(_1, _2) _WHERE_PLAN_1(_1), _WHERE_PLAN_1(_2)
+#define _WHERE_PLAN_3(_1, _2, _3) _WHERE_PLAN_2(_1, _2), _WHERE_PLAN_1(_3)
+#define _WHERE_PLAN_4(_1, _2, _3, _4) _WHERE_PLAN_3(_1, _2, _3), _WHERE_PLAN_1(_4)
+#define _WHERE_PLAN_5(_1, _2, _3, _4, _5) _WHERE_PLAN_4(_1, _2, _3, _4), _WHERE_PLAN_1(_5)
+#define _WHERE_PLAN_6(_1, _2, _3, _4, _5, _6) _WHERE_PLAN_5(_1, _2, _3, _4, _5), _WHERE_PLAN_1(_6)
+#define _WHERE_PLAN_7(_1, _2, _3, _4, _5, _6, _7) _WHERE_PLAN_6(_1, _2, _3, _4, _5, _6), _WHERE_PLAN_1(_7)
+#define _WHERE_PLAN_8(_1, _2, _3, _4, _5, _6, _7, _8) _WHERE_PLAN_7(_1, _2, _3, _4, _5, _6, _7), _WHERE_PLAN_1(_8)
+
+#define _WHERE_CONDITION_1(_1) (_1)
+#define _WHERE_CONDITION_2(_1, _2) _WHERE_CONDITION_1(_1) && (_2)
+#define _WHERE_CONDITION_3(_1, _2, _3) _WHERE_CONDITION_2(_1, _2) && (_3)
+#define _WHERE_CONDITION_4(_1, _2, _3, _4) _WHERE_CONDITION_3(_1, _2, _3) && (_4)
+#define _WHERE_CONDITION_5(_1, _2, _3, _4, _5) _WHERE_CONDITION_4(_1, _2, _3, _4) && (_5)
+#define _WHERE_CONDITION_6(_1, _2, _3, _4, _5, _6) _WHERE_CONDITION_5(_1, _2, _3, _4, _5) && (_6)
+#define _WHERE_CONDITION_7(_1, _2, _3, _4, _5, _6, _7) _WHERE_CONDITION_6(_1, _2, _3, _4, _5, _6) && (_7)
+#define _WHERE_CONDITION_8(_1, _2, _3, _4, _5, _6, _7, _8) _WHERE_CONDITION_7(_1, _2, _3, _4, _5, _6, _7) && (_8)
+
+#define _WHERE_GET_OVERRIDE(_1, _2, _3, _4, _5, _6, _7, _8, MACRO, ...) MACRO
+
+#define _WHERE_PLAN(...) \
+	_WHERE_GET_OVERRIDE(__VA_ARGS__, _WHERE_PLAN_8, _WHERE_PLAN_7, _WHERE_PLAN_6, _WHERE_PLAN_5, _WHERE_PLAN_4, _WHERE_PLAN_3, _WHERE_PLAN_2, _WHERE_PLAN_1, THEBLACKWHOLE)(__VA_ARGS__)
+
+#define _WHERE_CONDITIONS(...) \
+	(_WHERE_GET_OVERRIDE(__VA_ARGS__, _WHERE_CONDITION_8, _WHERE_CONDITION_7, _WHERE_CONDITION_6, _WHERE_CONDITION_5, _WHERE_CONDITION_4, _WHERE_CONDITION_3, _WHERE_CONDITION_2, _WHERE_CONDITION_1, THEBLACKWHOLE)(__VA_ARGS__))
+
+/*
+ * WHERE takes up to 8 conditions, all of which must hold. None of them is evaluated before the sources hold a record.
+ */
+#define WHERE(...) \
+	(planning ? 1 : _WHERE_CONDITIONS(__VA_ARGS__))
+
+/*
+ * WHERE_KEYS takes a parenthesized list of up to 8 key conditions, followed by up to 8 other conditions, 1 if there are
+ * none. Every result must satisfy all of them. The key conditions are the only part evaluated while the query is
+ * planned, which pushes them down into the source predicates, e.g.
+ *
+ * WHERE_KEYS((KEY_RANGE(test, IONIZE(10, int), IONIZE(19, int))), 0 == NEUTRALIZE(test.value, int) % 4)
+ */
+#define WHERE_KEYS(key_conditions, ...) \
+	(planning \
+		? (_WHERE_PLAN key_conditions, 1) \
+		: (_WHERE_CONDITIONS key_conditions && _WHERE_CONDITIONS(__VA_ARGS__)))
 
 #define QUERY(select, from, where, groupby, having, orderby, limit, when, p) \
 do { \
-	ion_err_t			error; \
+	ion_err_t			error	= err_ok; \
 	ion_iinq_result_t	result; \
+	ion_boolean_t		planning; \
+	/* The clauses after WHERE wrap the processor in operators, innermost first. */ \
+	ion_iinq_query_processor_t	*query_processor	= (p); \
+	/* Set while a LIMIT is the first operator results go through, to stop the scan once it is reached. */ \
+	ion_boolean_t				*query_limit_reached	= NULL; \
+	unsigned long				query_limit			= 0; \
+	/* Where SELECT lays out the columns it keeps. */ \
+	unsigned char				*query_projection	= NULL; \
+	UNUSED(query_limit); \
+	UNUSED(query_projection); \
 	result.num_bytes	= 0; \
+	limit \
+	orderby \
+	having \
+	groupby \
 	from/* This includes a loop declaration with some other stuff. */ \
+		if (planning) { \
+			/* Push the key conditions down into the source predicates. */ \
+			(void) where; \
+			planning = boolean_false; \
+			_FROM_START_CURSORS \
+			continue; \
+		} \
 		if (!where) { \
 			continue; \
 		} \
 		select \
-		(p)->execute(&result, (p)->state); \
+		query_processor->execute(&result, query_processor->state); \
+		if (NULL != query_limit_reached && *query_limit_reached) { \
+			break; \
+		} \
 	} \
-	IINQ_QUERY_CLEANUP: \
 	while (NULL != first) { \
-		first->reference->cursor->destroy(&first->reference->cursor); \
-		ion_close_dictionary(&first->reference->dictionary); \
+		if (NULL != first->reference->cursor) { \
+			first->reference->cursor->destroy(&first->reference->cursor); \
+		} \
+		if (NULL != first->reference->dictionary) { \
+			iinq_release_source(first->reference->dictionary); \
+		} \
 		first			= first->next; \
 	}\
+	iinq_finish_processor(query_processor); \
 } while (0);
 
 #if defined(__cplusplus)
@@ -0,0 +1,655 @@
+/******************************************************************************/
+/**
+@file		iinq_join.c
+@author		IonDB Project
+@brief		Implementation of the hash join and sort-merge join operators for IINQ.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "iinq_join.h"
+#include "../dictionary/flat_file/flat_file_types.h"
+
+/**
+@brief		A source taking part in a join, along with the records read from it
+			that are currently held in memory.
+*/
+typedef struct {
+	/**> Which source this is, and what it is joined on. */
+	ion_iinq_join_side_t	*side;
+	/**> The open dictionary of the source. */
+	ion_dictionary_t		*dictionary;
+	/**> Predicate used to read every record of the source. */
+	ion_predicate_t			predicate;
+	/**> Cursor over every record of the source. */
+	ion_dict_cursor_t		*cursor;
+	/**> Size of a held record, laid out as | KEY | VALUE |. */
+	size_t					row_size;
+	/**> The held records. */
+	ion_byte_t				*rows;
+	/**> How many records are held. */
+	size_t					num_rows;
+	/**> How many records there is room for. */
+	size_t					capacity;
+	/**> Set once the cursor has no more records. */
+	ion_boolean_t			exhausted;
+	/**> Set if the cursor stopped on something other than the end of its records. */
+	ion_err_t				error;
+} ion_iinq_join_input_t;
+
+/**
+@brief		Opens a source for a join and positions a cursor over all of its records.
+@param[out]	input
+				The join input to set up.
+@param[in]	side
+				The source to open.
+@return		The status of opening the source.
+*/
+ion_err_t
+iinq_join_open_input(
+	ion_iinq_join_input_t	*input,
+	ion_iinq_join_side_t	*side
+) {
+	input->side			= side;
+	input->cursor		= NULL;
+	input->rows			= NULL;
+	input->num_rows		= 0;
+	input->capacity		= 0;
+	input->exhausted	= boolean_false;
+	input->error		= err_ok;
+
+	ion_err_t error = iinq_acquire_source(side->schema_file_name, &input->dictionary);
+
+	if (err_ok != error) {
+		input->dictionary = NULL;
+		return error;
+	}
+
+	input->row_size = input->dictionary->instance->record.key_size + input->dictionary->instance->record.value_size;
+
+	error			= dictionary_build_predicate(&input->predicate, predicate_all_records);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	return dictionary_find(input->dictionary, &input->predicate, &input->cursor);
+}
+
+/**
+@brief		Closes a join input and frees the records it holds.
+@param[in]	input
+				The join input to close.
+*/
+void
+iinq_join_close_input(
+	ion_iinq_join_input_t *input
+) {
+	if (NULL != input->cursor) {
+		input->cursor->destroy(&input->cursor);
+	}
+
+	if (NULL != input->dictionary) {
+		iinq_release_source(input->dictionary);
+	}
+
+	free(input->rows);
+	input->rows = NULL;
+}
+
+/**
+@brief		Makes sure a join input has room to hold at least @p num_rows records.
+@param[in]	input
+				The join input to grow.
+@param[in]	num_rows
+				How many records must fit.
+@return		The status of the allocation.
+*/
+ion_err_t
+iinq_join_reserve(
+	ion_iinq_join_input_t	*input,
+	size_t					num_rows
+) {
+	if (num_rows <= input->capacity) {
+		return err_ok;
+	}
+
+	size_t new_capacity = 0 == input->capacity ? IINQ_JOIN_BATCH_SIZE : input->capacity;
+
+	while (new_capacity < num_rows) {
+		new_capacity *= 2;
+	}
+
+	ion_byte_t *new_rows = realloc(input->rows, new_capacity * input->row_size);
+
+	if (NULL == new_rows) {
+		return err_out_of_memory;
+	}
+
+	input->rows		= new_rows;
+	input->capacity = new_capacity;
+
+	return err_ok;
+}
+
+/**
+@brief		Records why a join input's cursor stopped, if it did not simply run
+			out of records.
+@param[in]	input
+				The join input whose cursor stopped.
+@param[in]	status
+				The status the cursor stopped with.
+@return		The error recorded for the input.
+*/
+ion_err_t
+iinq_join_stop(
+	ion_iinq_join_input_t	*input,
+	ion_cursor_status_t		status
+) {
+	input->exhausted = boolean_true;
+
+	if ((cs_end_of_results != status) && (cs_cursor_uninitialized != status) && (err_ok == input->error)) {
+		input->error = err_uninitialized;
+	}
+
+	return input->error;
+}
+
+/**
+@brief		Reads the next batch of records from a join input's cursor, appending
+			them to the records it already holds.
+@param[in]	input
+				The join input to read from.
+@return		The status of the read, which is an error if the cursor failed
+			rather than ran out of records.
+*/
+ion_err_t
+iinq_join_read_batch(
+	ion_iinq_join_input_t *input
+) {
+	ion_err_t error = iinq_join_reserve(input, input->num_rows + IINQ_JOIN_BATCH_SIZE);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	ion_record_t		records[IINQ_JOIN_BATCH_SIZE];
+	ion_result_count_t	num_records;
+	int					i;
+
+	for (i = 0; i < IINQ_JOIN_BATCH_SIZE; i++) {
+		records[i].key		= input->rows + (input->num_rows + i) * input->row_size;
+		records[i].value	= (ion_byte_t *) records[i].key + input->dictionary->instance->record.key_size;
+	}
+
+	ion_cursor_status_t status = dictionary_cursor_next_batch(input->cursor, records, IINQ_JOIN_BATCH_SIZE, &num_records);
+
+	input->num_rows += num_records;
+
+	if (0 == num_records) {
+		return iinq_join_stop(input, status);
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Reads the next record from a join input's cursor into @p row.
+@param[in]	input
+				The join input to read from.
+@param[in]	row
+				Where to read the record to, laid out as | KEY | VALUE |.
+@return		@c boolean_true if a record was read, @c boolean_false once the cursor is done.
+			Why it is done is left in the input's @c error.
+*/
+ion_boolean_t
+iinq_join_next(
+	ion_iinq_join_input_t	*input,
+	ion_byte_t				*row
+) {
+	ion_record_t		record = { row, row + input->dictionary->instance->record.key_size };
+	ion_cursor_status_t status = input->cursor->next(input->cursor, &record);
+
+	if ((cs_cursor_active == status) || (cs_cursor_initialized == status)) {
+		return boolean_true;
+	}
+
+	iinq_join_stop(input, status);
+
+	return boolean_false;
+}
+
+/**
+@brief		Finds the join attribute within a held record.
+@param[in]	input
+				The join input the record belongs to.
+@param[in]	row
+				The record, laid out as | KEY | VALUE |.
+@return		A pointer to the first byte of the join attribute.
+*/
+ion_byte_t *
+iinq_join_attribute(
+	ion_iinq_join_input_t	*input,
+	ion_byte_t				*row
+) {
+	return row + (input->side->in_value ? input->dictionary->instance->record.key_size : 0) + input->side->offset;
+}
+
+/**
+@brief		Works out how many bytes make up the join attribute of an input.
+@param[in]	input
+				The join input to check.
+@param[out]	size
+				Where to write the size of the join attribute.
+@return		@c err_invalid_predicate if the attribute does not fit inside the key
+			or value, @c err_ok otherwise.
+*/
+ion_err_t
+iinq_join_attribute_size(
+	ion_iinq_join_input_t	*input,
+	ion_iinq_result_size_t	*size
+) {
+	ion_iinq_result_size_t field_size = input->side->in_value ? (ion_iinq_result_size_t) input->dictionary->instance->record.value_size : (ion_iinq_result_size_t) input->dictionary->instance->record.key_size;
+
+	if (input->side->offset + input->side->size > field_size) {
+		return err_invalid_predicate;
+	}
+
+	*size = 0 == input->side->size ? field_size - input->side->offset : input->side->size;
+
+	return 0 == *size ? err_invalid_predicate : err_ok;
+}
+
+/**
+@brief		Hashes a join attribute using FNV-1a.
+@param[in]	attribute
+				The bytes of the join attribute.
+@param[in]	size
+				How many bytes the join attribute has.
+@return		The hash of the attribute.
+*/
+uint32_t
+iinq_join_hash(
+	ion_byte_t				*attribute,
+	ion_iinq_result_size_t	size
+) {
+	uint32_t				hash = 2166136261UL;
+	ion_iinq_result_size_t	i;
+
+	for (i = 0; i < size; i++) {
+		hash	^= attribute[i];
+		hash	*= 16777619UL;
+	}
+
+	return hash;
+}
+
+/**
+@brief		Passes one joined record to the processor.
+@param[in]	result
+				The result to fill. Its data must have room for both records.
+@param[in]	left
+				The left input.
+@param[in]	left_row
+				The record from the left input.
+@param[in]	right
+				The right input.
+@param[in]	right_row
+				The record from the right input.
+@param[in]	processor
+				Where to send the joined record.
+*/
+void
+iinq_join_emit(
+	ion_iinq_result_t			*result,
+	ion_iinq_join_input_t		*left,
+	ion_byte_t					*left_row,
+	ion_iinq_join_input_t		*right,
+	ion_byte_t					*right_row,
+	ion_iinq_query_processor_t	*processor
+) {
+	memcpy(result->data, left_row, left->row_size);
+	memcpy(result->data + left->row_size, right_row, right->row_size);
+	processor->execute(result, processor->state);
+}
+
+/**
+@brief		Checks whether a dictionary's all records cursor returns records in key order.
+@param[in]	dictionary
+				The dictionary to check.
+@return		@c boolean_true if the records come back in key order.
+*/
+ion_boolean_t
+iinq_join_is_ordered(
+	ion_dictionary_t *dictionary
+) {
+	switch (dictionary->instance->type) {
+		case dictionary_type_bpp_tree_t:
+		case dictionary_type_skip_list_t:
+		case dictionary_type_concurrent_skip_list_t: {
+			return boolean_true;
+		}
+
+		case dictionary_type_flat_file_t: {
+			return ((ion_flat_file_t *) dictionary->instance)->sorted_mode;
+		}
+
+		default: {
+			return boolean_false;
+		}
+	}
+}
+
+/**
+@brief		Checks whether an equi-join can be done by merging two ordered sources on their keys.
+@param[in]	left
+				The left side of the join.
+@param[in]	left_dictionary
+				The open dictionary of the left side.
+@param[in]	right
+				The right side of the join.
+@param[in]	right_dictionary
+				The open dictionary of the right side.
+@return		@c err_ok if the join can be merged, @c err_invalid_predicate if either side does not
+			join on the whole key or the keys differ, and @c err_sorted_order_violation if either
+			source is not ordered.
+*/
+ion_err_t
+iinq_join_check_mergeable(
+	ion_iinq_join_side_t	*left,
+	ion_dictionary_t		*left_dictionary,
+	ion_iinq_join_side_t	*right,
+	ion_dictionary_t		*right_dictionary
+) {
+	ion_iinq_join_side_t	*sides[2]			= { left, right };
+	ion_dictionary_t		*dictionaries[2]	= { left_dictionary, right_dictionary };
+	int						i;
+
+	for (i = 0; i < 2; i++) {
+		ion_key_size_t key_size = dictionaries[i]->instance->record.key_size;
+
+		if (sides[i]->in_value || (0 != sides[i]->offset) || ((0 != sides[i]->size) && (key_size != (ion_key_size_t) sides[i]->size))) {
+			return err_invalid_predicate;
+		}
+	}
+
+	if ((left_dictionary->instance->key_type != right_dictionary->instance->key_type) || (left_dictionary->instance->record.key_size != right_dictionary->instance->record.key_size)) {
+		return err_invalid_predicate;
+	}
+
+	if (!iinq_join_is_ordered(left_dictionary) || !iinq_join_is_ordered(right_dictionary)) {
+		return err_sorted_order_violation;
+	}
+
+	return err_ok;
+}
+
+ion_err_t
+iinq_hash_join(
+	ion_iinq_join_side_t		*left,
+	ion_iinq_join_side_t		*right,
+	ion_iinq_query_processor_t	*processor
+) {
+	ion_iinq_join_input_t	inputs[2];
+	ion_iinq_result_t		result;
+	ion_iinq_result_size_t	attribute_sizes[2];
+	uint32_t				*slots	= NULL;
+	ion_err_t				error	= iinq_join_open_input(&inputs[0], left);
+
+	result.data = NULL;
+
+	if (err_ok != error) {
+		iinq_join_close_input(&inputs[0]);
+		return error;
+	}
+
+	error = iinq_join_open_input(&inputs[1], right);
+
+	if (err_ok != error) {
+		goto CLEANUP;
+	}
+
+	if ((err_ok != (error = iinq_join_attribute_size(&inputs[0], &attribute_sizes[0]))) || (err_ok != (error = iinq_join_attribute_size(&inputs[1], &attribute_sizes[1])))) {
+		goto CLEANUP;
+	}
+
+	if (attribute_sizes[0] != attribute_sizes[1]) {
+		error = err_invalid_predicate;
+		goto CLEANUP;
+	}
+
+	/* Read both sides in lockstep until one runs out. That one is the smaller side. */
+	while (!inputs[0].exhausted && !inputs[1].exhausted) {
+		if ((err_ok != (error = iinq_join_read_batch(&inputs[0]))) || (err_ok != (error = iinq_join_read_batch(&inputs[1])))) {
+			goto CLEANUP;
+		}
+	}
+
+	int						build_idx	= inputs[0].exhausted && (!inputs[1].exhausted || inputs[0].num_rows <= inputs[1].num_rows) ? 0 : 1;
+	ion_iinq_join_input_t	*build		= &inputs[build_idx];
+	ion_iinq_join_input_t	*probe		= &inputs[1 - build_idx];
+
+	/* Build an open addressing table over the smaller side, holding record index + 1 so that 0 is empty. */
+	size_t	num_slots	= IINQ_JOIN_BATCH_SIZE;
+	size_t	i;
+
+	while (num_slots < 2 * build->num_rows) {
+		num_slots *= 2;
+	}
+
+	slots = calloc(num_slots, sizeof(uint32_t));
+
+	if (NULL == slots) {
+		error = err_out_of_memory;
+		goto CLEANUP;
+	}
+
+	for (i = 0; i < build->num_rows; i++) {
+		size_t slot = iinq_join_hash(iinq_join_attribute(build, build->rows + i * build->row_size), attribute_sizes[0]) & (num_slots - 1);
+
+		while (0 != slots[slot]) {
+			slot = (slot + 1) & (num_slots - 1);
+		}
+
+		slots[slot] = i + 1;
+	}
+
+	result.num_bytes	= inputs[0].row_size + inputs[1].row_size;
+	result.data			= malloc(result.num_bytes);
+
+	if (NULL == result.data) {
+		error = err_out_of_memory;
+		goto CLEANUP;
+	}
+
+	/* Probe with the records of the larger side already held, then stream the rest of it. */
+	while (boolean_true) {
+		for (i = 0; i < probe->num_rows; i++) {
+			ion_byte_t	*probe_row	= probe->rows + i * probe->row_size;
+			ion_byte_t	*attribute	= iinq_join_attribute(probe, probe_row);
+			size_t		slot		= iinq_join_hash(attribute, attribute_sizes[0]) & (num_slots - 1);
+
+			while (0 != slots[slot]) {
+				ion_byte_t *build_row = build->rows + (slots[slot] - 1) * build->row_size;
+
+				if (0 == memcmp(attribute, iinq_join_attribute(build, build_row), attribute_sizes[0])) {
+					if (0 == build_idx) {
+						iinq_join_emit(&result, build, build_row, probe, probe_row, processor);
+					}
+					else {
+						iinq_join_emit(&result, probe, probe_row, build, build_row, processor);
+					}
+				}
+
+				slot = (slot + 1) & (num_slots - 1);
+			}
+		}
+
+		if (probe->exhausted) {
+			break;
+		}
+
+		probe->num_rows = 0;
+
+		if (err_ok != (error = iinq_join_read_batch(probe))) {
+			goto CLEANUP;
+		}
+	}
+
+CLEANUP:
+	iinq_finish_processor(processor);
+	free(result.data);
+	free(slots);
+	iinq_join_close_input(&inputs[0]);
+	iinq_join_close_input(&inputs[1]);
+
+	return error;
+}
+
+ion_err_t
+iinq_sort_merge_join(
+	ion_iinq_join_side_t		*left,
+	ion_iinq_join_side_t		*right,
+	ion_iinq_query_processor_t	*processor
+) {
+	ion_iinq_join_input_t	inputs[2];
+	ion_iinq_result_t		result;
+	ion_err_t				error = iinq_join_open_input(&inputs[0], left);
+
+	result.data = NULL;
+
+	if (err_ok != error) {
+		iinq_join_close_input(&inputs[0]);
+		return error;
+	}
+
+	error = iinq_join_open_input(&inputs[1], right);
+
+	if (err_ok != error) {
+		goto CLEANUP;
+	}
+
+	error = iinq_join_check_mergeable(left, inputs[0].dictionary, right, inputs[1].dictionary);
+
+	if (err_ok != error) {
+		goto CLEANUP;
+	}
+
+	ion_dictionary_parent_t *left_parent = inputs[0].dictionary->instance;
+
+	/* The first half holds the joined record, the second half the current record of each side.
+	   Records of the right side that share a key are held in its input. */
+	result.num_bytes	= inputs[0].row_size + inputs[1].row_size;
+	result.data			= malloc(2 * result.num_bytes);
+
+	if (NULL == result.data) {
+		error = err_out_of_memory;
+		goto CLEANUP;
+	}
+
+	ion_byte_t		*left_row		= result.data + result.num_bytes;
+	ion_byte_t		*right_row		= left_row + inputs[0].row_size;
+	ion_key_size_t	key_size		= left_parent->record.key_size;
+	ion_boolean_t	left_active		= iinq_join_next(&inputs[0], left_row);
+	ion_boolean_t	right_active	= iinq_join_next(&inputs[1], right_row);
+
+	while (left_active && right_active) {
+		char comparison = left_parent->compare(left_row, right_row, key_size);
+
+		if (comparison < 0) {
+			left_active = iinq_join_next(&inputs[0], left_row);
+		}
+		else if (comparison > 0) {
+			right_active = iinq_join_next(&inputs[1], right_row);
+		}
+		else {
+			inputs[1].num_rows = 0;
+
+			do {
+				if (err_ok != (error = iinq_join_reserve(&inputs[1], inputs[1].num_rows + 1))) {
+					goto CLEANUP;
+				}
+
+				memcpy(inputs[1].rows + inputs[1].num_rows * inputs[1].row_size, right_row, inputs[1].row_size);
+				inputs[1].num_rows++;
+				right_active = iinq_join_next(&inputs[1], right_row);
+			} while (right_active && 0 == left_parent->compare(right_row, inputs[1].rows, key_size));
+
+			do {
+				size_t i;
+
+				for (i = 0; i < inputs[1].num_rows; i++) {
+					iinq_join_emit(&result, &inputs[0], left_row, &inputs[1], inputs[1].rows + i * inputs[1].row_size, processor);
+				}
+
+				left_active = iinq_join_next(&inputs[0], left_row);
+			} while (left_active && 0 == left_parent->compare(left_row, inputs[1].rows, key_size));
+		}
+	}
+
+	/* A failed cursor must not pass for the end of its source. */
+	error = err_ok != inputs[0].error ? inputs[0].error : inputs[1].error;
+
+CLEANUP:
+	iinq_finish_processor(processor);
+	free(result.data);
+	iinq_join_close_input(&inputs[0]);
+	iinq_join_close_input(&inputs[1]);
+
+	return error;
+}
+
+ion_err_t
+iinq_join(
+	ion_iinq_join_side_t		*left,
+	ion_iinq_join_side_t		*right,
+	ion_iinq_query_processor_t	*processor
+) {
+	ion_dictionary_t	*left_dictionary;
+	ion_dictionary_t	*right_dictionary;
+	ion_err_t			error = iinq_acquire_source(left->schema_file_name, &left_dictionary);
+
+	if (err_ok != error) {
+		return error;
+	}
+
+	error = iinq_acquire_source(right->schema_file_name, &right_dictionary);
+
+	if (err_ok != error) {
+		iinq_release_source(left_dictionary);
+		return error;
+	}
+
+	ion_boolean_t use_merge = err_ok == iinq_join_check_mergeable(left, left_dictionary, right, right_dictionary);
+
+	iinq_release_source(right_dictionary);
+	iinq_release_source(left_dictionary);
+
+	return use_merge ? iinq_sort_merge_join(left, right, processor) : iinq_hash_join(left, right, processor);
+}
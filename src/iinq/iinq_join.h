@@ -0,0 +1,157 @@
+/******************************************************************************/
+/**
+@file		iinq_join.h
+@author		IonDB Project
+@brief		Equi-join operators for IINQ sources.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#if !defined(IINQ_JOIN_H_)
+#define IINQ_JOIN_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "iinq.h"
+
+#if !defined(IINQ_JOIN_BATCH_SIZE)
+/**
+@brief		How many records a join reads from a source cursor at a time.
+*/
+#define IINQ_JOIN_BATCH_SIZE 16
+#endif
+
+/**
+@brief		Describes one side of an equi-join: the source, and which bytes of
+			its records make up the join attribute.
+*/
+typedef struct {
+	/**> The schema file of the source. */
+	char					*schema_file_name;
+	/**> If @c boolean_true, the join attribute is a field of the value, otherwise of the key. */
+	ion_boolean_t			in_value;
+	/**> Byte offset of the join attribute within the key or value. */
+	ion_iinq_result_size_t	offset;
+	/**> Size in bytes of the join attribute, or @c 0 to use the rest of the key or value. */
+	ion_iinq_result_size_t	size;
+} ion_iinq_join_side_t;
+
+/**
+@brief		Joins on the whole key of the given source.
+*/
+#define IINQ_JOIN_ON_KEY(schema_name) \
+	(&(ion_iinq_join_side_t) { #schema_name ".inq", boolean_false, 0, 0 })
+
+/**
+@brief		Joins on @p size bytes at @p offset within the value of the given source.
+*/
+#define IINQ_JOIN_ON_VALUE_FIELD(schema_name, offset, size) \
+	(&(ion_iinq_join_side_t) { #schema_name ".inq", boolean_true, offset, size })
+
+/**
+@brief		Runs an equi-join using a hash table built over the smaller source.
+@details	Both sources are read in lockstep until one of them runs out, which
+			makes it the smaller side without having to count either source
+			first. The smaller side is hashed in memory, and the other side is
+			then streamed past it. Memory use is therefore bounded by roughly
+			twice the size of the smaller source. Join attributes are compared
+			byte for byte, so both sides must use the same size and encoding.
+
+			Every matching pair is passed to @p processor, laid out as the left
+			key, left value, right key and right value, and the processor is
+			finished once the join ends.
+@param[in]	left
+				The left side of the join.
+@param[in]	right
+				The right side of the join.
+@param[in]	processor
+				Where to send the joined records.
+@return		The status of the join. @c err_invalid_predicate is returned if the
+			join attributes are not the same size.
+*/
+ion_err_t
+iinq_hash_join(
+	ion_iinq_join_side_t		*left,
+	ion_iinq_join_side_t		*right,
+	ion_iinq_query_processor_t	*processor
+);
+
+/**
+@brief		Runs an equi-join on the keys of two sources that both return
+			their records in key order, by merging their cursors.
+@details	This needs no memory beyond the records of the right source that
+			share the current key. Both sources must be B+ trees or sorted flat
+			files with the same key type and size.
+
+			Every matching pair is passed to @p processor, laid out as the left
+			key, left value, right key and right value, and the processor is
+			finished once the join ends.
+@param[in]	left
+				The left side of the join. Must join on the whole key.
+@param[in]	right
+				The right side of the join. Must join on the whole key.
+@param[in]	processor
+				Where to send the joined records.
+@return		The status of the join. @c err_sorted_order_violation is returned if
+			either source is not ordered, and @c err_invalid_predicate if either
+			side does not join on the whole key or the keys do not match in type.
+*/
+ion_err_t
+iinq_sort_merge_join(
+	ion_iinq_join_side_t		*left,
+	ion_iinq_join_side_t		*right,
+	ion_iinq_query_processor_t	*processor
+);
+
+/**
+@brief		Runs an equi-join with the cheapest available operator.
+@details	@ref iinq_sort_merge_join is used when both sides join on the whole
+			key of an ordered source, otherwise @ref iinq_hash_join is used.
+@param[in]	left
+				The left side of the join.
+@param[in]	right
+				The right side of the join.
+@param[in]	processor
+				Where to send the joined records.
+@return		The status of the join.
+*/
+ion_err_t
+iinq_join(
+	ion_iinq_join_side_t		*left,
+	ion_iinq_join_side_t		*right,
+	ion_iinq_query_processor_t	*processor
+);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -0,0 +1,1181 @@
+/******************************************************************************/
+/**
+@file		iinq_operators.c
+@author		IonDB Project
+@brief		Implementation of the GROUP BY, HAVING, ORDER BY, LIMIT and
+			batching operators for IINQ queries.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "iinq_operators.h"
+#include "../dictionary/dictionary.h"
+
+/**
+@brief		Used to give each sort its own run files.
+*/
+static unsigned int iinq_sort_next_id = 0;
+
+/**
+@brief		Compares a field of two results according to its type.
+*/
+static char
+iinq_field_compare(
+	ion_iinq_field_t	*field,
+	unsigned char		*first,
+	unsigned char		*second
+) {
+	switch (field->type) {
+		case key_type_numeric_signed: {
+			return dictionary_compare_signed_value(first + field->offset, second + field->offset, field->size);
+		}
+
+		case key_type_numeric_unsigned: {
+			return dictionary_compare_unsigned_value(first + field->offset, second + field->offset, field->size);
+		}
+
+		default: {
+			int comparison = strncmp((char *) first + field->offset, (char *) second + field->offset, field->size);
+
+			return comparison < 0 ? -1 : comparison > 0;
+		}
+	}
+}
+
+/**
+@brief		Reads a numeric field of a result, into the integer member of the
+			value for signed fields and the unsigned one for unsigned fields.
+			Fields that are not 1, 2, 4 or 8 byte integers read as @c 0.
+*/
+static ion_iinq_aggregate_value_t
+iinq_field_value(
+	ion_iinq_field_t	*field,
+	unsigned char		*row
+) {
+	ion_iinq_aggregate_value_t	value;
+	unsigned char				*data = row + field->offset;
+
+	value.integer = 0;
+
+	if (key_type_numeric_signed == field->type) {
+		switch (field->size) {
+			case sizeof(int8_t): {
+				int8_t field_value;
+
+				memcpy(&field_value, data, sizeof(field_value));
+				value.integer = field_value;
+				break;
+			}
+
+			case sizeof(int16_t): {
+				int16_t field_value;
+
+				memcpy(&field_value, data, sizeof(field_value));
+				value.integer = field_value;
+				break;
+			}
+
+			case sizeof(int32_t): {
+				int32_t field_value;
+
+				memcpy(&field_value, data, sizeof(field_value));
+				value.integer = field_value;
+				break;
+			}
+
+			case sizeof(int64_t): {
+				memcpy(&value.integer, data, sizeof(value.integer));
+				break;
+			}
+		}
+	}
+	else if (key_type_numeric_unsigned == field->type) {
+		switch (field->size) {
+			case sizeof(uint8_t): {
+				uint8_t field_value;
+
+				memcpy(&field_value, data, sizeof(field_value));
+				value.unsigned_integer = field_value;
+				break;
+			}
+
+			case sizeof(uint16_t): {
+				uint16_t field_value;
+
+				memcpy(&field_value, data, sizeof(field_value));
+				value.unsigned_integer = field_value;
+				break;
+			}
+
+			case sizeof(uint32_t): {
+				uint32_t field_value;
+
+				memcpy(&field_value, data, sizeof(field_value));
+				value.unsigned_integer = field_value;
+				break;
+			}
+
+			case sizeof(uint64_t): {
+				memcpy(&value.unsigned_integer, data, sizeof(value.unsigned_integer));
+				break;
+			}
+		}
+	}
+
+	return value;
+}
+
+/**
+@brief		Swaps two results through a spare one.
+*/
+static void
+iinq_swap_rows(
+	unsigned char			*first,
+	unsigned char			*second,
+	unsigned char			*spare,
+	ion_iinq_result_size_t	row_size
+) {
+	memcpy(spare, first, row_size);
+	memcpy(first, second, row_size);
+	memcpy(second, spare, row_size);
+}
+
+/**
+@brief		Moves a result down a heap until it is not before either child,
+			so that the last result in order stays on top.
+*/
+static void
+iinq_heap_sift_down(
+	unsigned char			*rows,
+	unsigned long			num_rows,
+	unsigned long			root,
+	ion_iinq_result_size_t	row_size,
+	ion_iinq_row_compare_t	compare,
+	void					*context,
+	unsigned char			*spare
+) {
+	while (2 * root + 1 < num_rows) {
+		unsigned long child = 2 * root + 1;
+
+		if ((child + 1 < num_rows) && (compare(rows + child * row_size, rows + (child + 1) * row_size, context) < 0)) {
+			child++;
+		}
+
+		if (compare(rows + root * row_size, rows + child * row_size, context) >= 0) {
+			return;
+		}
+
+		iinq_swap_rows(rows + root * row_size, rows + child * row_size, spare, row_size);
+		root = child;
+	}
+}
+
+/**
+@brief		Moves the result at @p index up a heap until it is not after its parent.
+*/
+static void
+iinq_heap_sift_up(
+	unsigned char			*rows,
+	unsigned long			index,
+	ion_iinq_result_size_t	row_size,
+	ion_iinq_row_compare_t	compare,
+	void					*context,
+	unsigned char			*spare
+) {
+	while (index > 0) {
+		unsigned long parent = (index - 1) / 2;
+
+		if (compare(rows + parent * row_size, rows + index * row_size, context) >= 0) {
+			return;
+		}
+
+		iinq_swap_rows(rows + parent * row_size, rows + index * row_size, spare, row_size);
+		index = parent;
+	}
+}
+
+/**
+@brief		Sorts results in place with a heapsort, which needs no memory
+			beyond the spare result.
+*/
+static void
+iinq_heap_sort(
+	unsigned char			*rows,
+	unsigned long			num_rows,
+	ion_iinq_result_size_t	row_size,
+	ion_iinq_row_compare_t	compare,
+	void					*context,
+	unsigned char			*spare
+) {
+	unsigned long i;
+
+	for (i = num_rows / 2; i > 0; i--) {
+		iinq_heap_sift_down(rows, num_rows, i - 1, row_size, compare, context, spare);
+	}
+
+	for (i = num_rows; i > 1; i--) {
+		iinq_swap_rows(rows, rows + (i - 1) * row_size, spare, row_size);
+		iinq_heap_sift_down(rows, i - 1, 0, row_size, compare, context, spare);
+	}
+}
+
+/**
+@brief		Passes each of a set of results to a processor.
+*/
+static void
+iinq_emit_rows(
+	unsigned char				*rows,
+	unsigned long				num_rows,
+	ion_iinq_result_size_t		row_size,
+	ion_iinq_query_processor_t	*processor
+) {
+	ion_iinq_result_t	result;
+	unsigned long		i;
+
+	result.num_bytes = row_size;
+
+	for (i = 0; i < num_rows; i++) {
+		result.data = rows + i * row_size;
+		processor->execute(&result, processor->state);
+	}
+}
+
+/**
+@brief		Builds the name of one of the two run files of a sort.
+*/
+static void
+iinq_sort_file_name(
+	ion_iinq_sort_t *sort,
+	int				which,
+	char			*name
+) {
+	sprintf(name, "%u.is%d", sort->id, which);
+}
+
+ion_err_t
+iinq_sort_init(
+	ion_iinq_sort_t			*sort,
+	ion_iinq_result_size_t	row_size,
+	ion_iinq_row_compare_t	compare,
+	void					*context
+) {
+	sort->row_size		= row_size;
+	sort->compare		= compare;
+	sort->context		= context;
+	sort->num_rows		= 0;
+	sort->capacity		= IINQ_SORT_BUFFER_SIZE / row_size;
+	sort->files[0]		= NULL;
+	sort->files[1]		= NULL;
+	sort->id			= iinq_sort_next_id++;
+	sort->run_lengths	= NULL;
+	sort->num_runs		= 0;
+	sort->runs_capacity = 0;
+
+	if (sort->capacity < 2) {
+		sort->capacity = 2;
+	}
+
+	sort->rows = malloc((sort->capacity + 1) * row_size);
+
+	if (NULL == sort->rows) {
+		return err_out_of_memory;
+	}
+
+	return err_ok;
+}
+
+/**
+@brief		Sorts the results held in memory and appends them to the run file
+			as a new run.
+*/
+static ion_err_t
+iinq_sort_write_run(
+	ion_iinq_sort_t *sort
+) {
+	unsigned char *spare = sort->rows + sort->capacity * sort->row_size;
+
+	if (NULL == sort->files[0]) {
+		char name[20];
+
+		iinq_sort_file_name(sort, 0, name);
+		sort->files[0] = fopen(name, "w+b");
+
+		if (NULL == sort->files[0]) {
+			return err_file_open_error;
+		}
+	}
+
+	if (sort->num_runs == sort->runs_capacity) {
+		unsigned int	capacity	= 0 == sort->runs_capacity ? IINQ_SORT_FAN_IN : 2 * sort->runs_capacity;
+		unsigned long	*lengths	= realloc(sort->run_lengths, capacity * sizeof(unsigned long));
+
+		if (NULL == lengths) {
+			return err_out_of_memory;
+		}
+
+		sort->run_lengths	= lengths;
+		sort->runs_capacity = capacity;
+	}
+
+	iinq_heap_sort(sort->rows, sort->num_rows, sort->row_size, sort->compare, sort->context, spare);
+
+	if (sort->num_rows != fwrite(sort->rows, sort->row_size, sort->num_rows, sort->files[0])) {
+		return err_file_write_error;
+	}
+
+	sort->run_lengths[sort->num_runs++] = sort->num_rows;
+	sort->num_rows						= 0;
+
+	return err_ok;
+}
+
+ion_err_t
+iinq_sort_add(
+	ion_iinq_sort_t *sort,
+	unsigned char	*row
+) {
+	if (sort->num_rows == sort->capacity) {
+		ion_err_t error = iinq_sort_write_run(sort);
+
+		if (err_ok != error) {
+			return error;
+		}
+	}
+
+	memcpy(sort->rows + sort->num_rows * sort->row_size, row, sort->row_size);
+	sort->num_rows++;
+
+	return err_ok;
+}
+
+/**
+@brief		Merges consecutive runs of a run file, either into another run
+			file or out to a processor.
+@param[in]	sort
+				The sort.
+@param[in]	input
+				The run file holding the runs.
+@param[in]	first_row
+				Where the first run starts in @p input, counted in results.
+@param[in]	lengths
+				How many results each run holds.
+@param[in]	num_runs
+				How many runs to merge, at most @ref IINQ_SORT_FAN_IN.
+@param[in]	output
+				The run file to append the merged run to, or @c NULL to pass
+				the results to @p processor instead.
+@param[in]	processor
+				Where to send the results when @p output is @c NULL.
+@param[in]	buffers
+				Room to read @ref IINQ_SORT_READ_ROWS results of each run.
+@return		The status of reading and writing the runs.
+*/
+static ion_err_t
+iinq_sort_merge(
+	ion_iinq_sort_t				*sort,
+	FILE						*input,
+	unsigned long				first_row,
+	unsigned long				*lengths,
+	unsigned int				num_runs,
+	FILE						*output,
+	ion_iinq_query_processor_t	*processor,
+	unsigned char				*buffers
+) {
+	unsigned long			positions[IINQ_SORT_FAN_IN];
+	unsigned long			remaining[IINQ_SORT_FAN_IN];
+	unsigned int			num_buffered[IINQ_SORT_FAN_IN];
+	unsigned int			next_row[IINQ_SORT_FAN_IN];
+	ion_iinq_result_size_t	row_size = sort->row_size;
+	ion_iinq_result_t		result;
+	unsigned int			i;
+
+	for (i = 0; i < num_runs; i++) {
+		positions[i]	= first_row;
+		remaining[i]	= lengths[i];
+		num_buffered[i] = 0;
+		next_row[i]		= 0;
+		first_row		+= lengths[i];
+	}
+
+	result.num_bytes = row_size;
+
+	while (boolean_true) {
+		unsigned char	*best_row	= NULL;
+		unsigned int	best		= 0;
+
+		for (i = 0; i < num_runs; i++) {
+			unsigned char *buffer = buffers + i * IINQ_SORT_READ_ROWS * row_size;
+
+			if (next_row[i] == num_buffered[i]) {
+				if (0 == remaining[i]) {
+					continue;
+				}
+
+				num_buffered[i] = remaining[i] < IINQ_SORT_READ_ROWS ? remaining[i] : IINQ_SORT_READ_ROWS;
+				next_row[i]		= 0;
+
+				if (0 != fseek(input, (long) (positions[i] * row_size), SEEK_SET)) {
+					return err_file_bad_seek;
+				}
+
+				if (num_buffered[i] != fread(buffer, row_size, num_buffered[i], input)) {
+					return err_file_read_error;
+				}
+
+				positions[i]	+= num_buffered[i];
+				remaining[i]	-= num_buffered[i];
+			}
+
+			unsigned char *row = buffer + next_row[i] * row_size;
+
+			if ((NULL == best_row) || (sort->compare(row, best_row, sort->context) < 0)) {
+				best_row	= row;
+				best		= i;
+			}
+		}
+
+		if (NULL == best_row) {
+			return err_ok;
+		}
+
+		if (NULL != output) {
+			if (1 != fwrite(best_row, row_size, 1, output)) {
+				return err_file_write_error;
+			}
+		}
+		else {
+			result.data = best_row;
+			processor->execute(&result, processor->state);
+		}
+
+		next_row[best]++;
+	}
+}
+
+ion_err_t
+iinq_sort_finish(
+	ion_iinq_sort_t				*sort,
+	ion_iinq_query_processor_t	*processor
+) {
+	ion_err_t		error	= err_ok;
+	unsigned char	*buffers = NULL;
+	char			name[20];
+	int				i;
+
+	if (NULL == processor) {
+		goto CLEANUP;
+	}
+
+	if (0 == sort->num_runs) {
+		/* Everything fit in memory. */
+		iinq_heap_sort(sort->rows, sort->num_rows, sort->row_size, sort->compare, sort->context, sort->rows + sort->capacity * sort->row_size);
+		iinq_emit_rows(sort->rows, sort->num_rows, sort->row_size, processor);
+		goto CLEANUP;
+	}
+
+	if ((0 != sort->num_rows) && (err_ok != (error = iinq_sort_write_run(sort)))) {
+		goto CLEANUP;
+	}
+
+	/* The run buffer is no longer needed, the merge buffers take its place. */
+	free(sort->rows);
+	sort->rows	= NULL;
+	buffers		= malloc(IINQ_SORT_FAN_IN * IINQ_SORT_READ_ROWS * sort->row_size);
+
+	if (NULL == buffers) {
+		error = err_out_of_memory;
+		goto CLEANUP;
+	}
+
+	while (sort->num_runs > IINQ_SORT_FAN_IN) {
+		unsigned long	first_row	= 0;
+		unsigned int	num_merged	= 0;
+		unsigned int	run;
+
+		if (NULL == sort->files[1]) {
+			iinq_sort_file_name(sort, 1, name);
+			sort->files[1] = fopen(name, "w+b");
+
+			if (NULL == sort->files[1]) {
+				error = err_file_open_error;
+				goto CLEANUP;
+			}
+		}
+
+		if (0 != fseek(sort->files[1], 0, SEEK_SET)) {
+			error = err_file_bad_seek;
+			goto CLEANUP;
+		}
+
+		for (run = 0; run < sort->num_runs; run += IINQ_SORT_FAN_IN) {
+			unsigned int	num_inputs	= sort->num_runs - run < IINQ_SORT_FAN_IN ? sort->num_runs - run : IINQ_SORT_FAN_IN;
+			unsigned long	length		= 0;
+			unsigned int	j;
+
+			for (j = 0; j < num_inputs; j++) {
+				length += sort->run_lengths[run + j];
+			}
+
+			error = iinq_sort_merge(sort, sort->files[0], first_row, sort->run_lengths + run, num_inputs, sort->files[1], NULL, buffers);
+
+			if (err_ok != error) {
+				goto CLEANUP;
+			}
+
+			/* The merged run always lands at or before the runs it came from. */
+			sort->run_lengths[num_merged++] = length;
+			first_row						+= length;
+		}
+
+		sort->num_runs = num_merged;
+
+		FILE *merged = sort->files[1];
+
+		sort->files[1]	= sort->files[0];
+		sort->files[0]	= merged;
+	}
+
+	error = iinq_sort_merge(sort, sort->files[0], 0, sort->run_lengths, sort->num_runs, NULL, processor, buffers);
+
+CLEANUP:
+
+	for (i = 0; i < 2; i++) {
+		if (NULL != sort->files[i]) {
+			fclose(sort->files[i]);
+			sort->files[i] = NULL;
+		}
+
+		iinq_sort_file_name(sort, i, name);
+		fremove(name);
+	}
+
+	free(buffers);
+	free(sort->rows);
+	free(sort->run_lengths);
+	sort->rows			= NULL;
+	sort->run_lengths	= NULL;
+	sort->num_rows		= 0;
+	sort->num_runs		= 0;
+
+	return error;
+}
+
+/**
+@brief		Passes a result on if the limit has not been reached yet.
+*/
+static
+IINQ_NEW_PROCESSOR_FUNC(iinq_limit_execute) {
+	ion_iinq_limit_t *limit = state;
+
+	if (limit->count < limit->limit) {
+		limit->next->execute(result, limit->next->state);
+		limit->count++;
+	}
+
+	limit->reached = limit->count >= limit->limit;
+}
+
+static void
+iinq_limit_finish(
+	void *state
+) {
+	iinq_finish_processor(((ion_iinq_limit_t *) state)->next);
+}
+
+void
+iinq_limit_init(
+	ion_iinq_limit_t			*limit,
+	unsigned long				count,
+	ion_iinq_query_processor_t	*next
+) {
+	limit->processor	= IINQ_QUERY_PROCESSOR(iinq_limit_execute, limit);
+	limit->processor.finish = iinq_limit_finish;
+	limit->next			= next;
+	limit->limit		= count;
+	limit->count		= 0;
+	limit->reached		= 0 == count;
+}
+
+/**
+@brief		Passes a result on if it satisfies the condition.
+*/
+static
+IINQ_NEW_PROCESSOR_FUNC(iinq_having_execute) {
+	ion_iinq_having_t *having = state;
+
+	if (having->condition(result, having->state)) {
+		having->next->execute(result, having->next->state);
+	}
+}
+
+static void
+iinq_having_finish(
+	void *state
+) {
+	iinq_finish_processor(((ion_iinq_having_t *) state)->next);
+}
+
+void
+iinq_having_init(
+	ion_iinq_having_t			*having,
+	ion_iinq_having_func_t		condition,
+	void						*state,
+	ion_iinq_query_processor_t	*next
+) {
+	having->processor			= IINQ_QUERY_PROCESSOR(iinq_having_execute, having);
+	having->processor.finish	= iinq_having_finish;
+	having->next				= next;
+	having->condition			= condition;
+	having->state				= state;
+}
+
+/**
+@brief		Compares two results on the fields of an ORDER BY.
+*/
+static int
+iinq_order_by_compare(
+	unsigned char	*first,
+	unsigned char	*second,
+	void			*context
+) {
+	ion_iinq_order_by_t *order_by = context;
+	unsigned int		i;
+
+	for (i = 0; i < order_by->num_orders; i++) {
+		char comparison = iinq_field_compare(&order_by->orders[i].field, first, second);
+
+		if (0 != comparison) {
+			return comparison * order_by->orders[i].direction;
+		}
+	}
+
+	return 0;
+}
+
+/**
+@brief		Adds a result to the heap of a limited ORDER BY, or to its sort.
+*/
+static
+IINQ_NEW_PROCESSOR_FUNC(iinq_order_by_execute) {
+	ion_iinq_order_by_t *order_by = state;
+
+	if (err_ok != order_by->error) {
+		return;
+	}
+
+	if (!order_by->started) {
+		order_by->started	= boolean_true;
+		order_by->row_size	= result->num_bytes;
+
+		if (0 != order_by->limit) {
+			/* If the limit is too large to hold, fall back to a full sort. */
+			order_by->heap = malloc((order_by->limit + 1) * order_by->row_size);
+		}
+
+		if ((NULL == order_by->heap) && (err_ok != (order_by->error = iinq_sort_init(&order_by->sort, order_by->row_size, iinq_order_by_compare, order_by)))) {
+			return;
+		}
+	}
+
+	if (NULL == order_by->heap) {
+		order_by->error = iinq_sort_add(&order_by->sort, result->data);
+		return;
+	}
+
+	unsigned char	*spare		= order_by->heap + order_by->limit * order_by->row_size;
+	unsigned char	*last		= order_by->heap + order_by->heap_size * order_by->row_size;
+
+	if (order_by->heap_size < order_by->limit) {
+		memcpy(last, result->data, order_by->row_size);
+		iinq_heap_sift_up(order_by->heap, order_by->heap_size++, order_by->row_size, iinq_order_by_compare, order_by, spare);
+	}
+	else if (iinq_order_by_compare(result->data, order_by->heap, order_by) < 0) {
+		/* Replace the last of the kept results. */
+		memcpy(order_by->heap, result->data, order_by->row_size);
+		iinq_heap_sift_down(order_by->heap, order_by->heap_size, 0, order_by->row_size, iinq_order_by_compare, order_by, spare);
+	}
+}
+
+static void
+iinq_order_by_finish(
+	void *state
+) {
+	ion_iinq_order_by_t *order_by = state;
+
+	if (order_by->started) {
+		if (NULL != order_by->heap) {
+			if (err_ok == order_by->error) {
+				iinq_heap_sort(order_by->heap, order_by->heap_size, order_by->row_size, iinq_order_by_compare, order_by, order_by->heap + order_by->limit * order_by->row_size);
+				iinq_emit_rows(order_by->heap, order_by->heap_size, order_by->row_size, order_by->next);
+			}
+
+			free(order_by->heap);
+			order_by->heap = NULL;
+		}
+		else if (err_ok == order_by->error) {
+			order_by->error = iinq_sort_finish(&order_by->sort, order_by->next);
+		}
+		else {
+			iinq_sort_finish(&order_by->sort, NULL);
+		}
+	}
+
+	iinq_finish_processor(order_by->next);
+}
+
+void
+iinq_order_by_init(
+	ion_iinq_order_by_t			*order_by,
+	ion_iinq_order_t			*orders,
+	unsigned int				num_orders,
+	unsigned long				limit,
+	ion_iinq_query_processor_t	*next
+) {
+	order_by->processor			= IINQ_QUERY_PROCESSOR(iinq_order_by_execute, order_by);
+	order_by->processor.finish	= iinq_order_by_finish;
+	order_by->next				= next;
+	order_by->orders			= orders;
+	order_by->num_orders		= num_orders;
+	order_by->limit				= limit;
+	order_by->row_size			= 0;
+	order_by->heap				= NULL;
+	order_by->heap_size			= 0;
+	order_by->started			= boolean_false;
+	order_by->error				= err_ok;
+}
+
+/**
+@brief		Returns the value and count of each aggregate of a group.
+*/
+static ion_iinq_aggregate_value_t *
+iinq_group_by_accumulators(
+	ion_iinq_group_by_t *group_by,
+	unsigned char		*group
+) {
+	return (ion_iinq_aggregate_value_t *) (group + group_by->key_space);
+}
+
+/**
+@brief		Starts a group from its first result.
+*/
+static void
+iinq_group_by_start(
+	ion_iinq_group_by_t *group_by,
+	unsigned char		*group,
+	unsigned char		*row
+) {
+	ion_iinq_aggregate_value_t	*accumulators = iinq_group_by_accumulators(group_by, group);
+	unsigned int				i;
+
+	memcpy(group, row + group_by->key.offset, group_by->key.size);
+
+	for (i = 0; i < group_by->num_aggregates; i++) {
+		ion_iinq_aggregate_t *aggregate = &group_by->aggregates[i];
+
+		if (iinq_aggregate_count == aggregate->type) {
+			accumulators[2 * i].integer = 1;
+		}
+		else {
+			accumulators[2 * i] = iinq_field_value(&aggregate->field, row);
+
+			/* Averages are summed as reals, so that they cannot overflow. */
+			if (iinq_aggregate_avg == aggregate->type) {
+				accumulators[2 * i].real = key_type_numeric_unsigned == aggregate->field.type ? (double) accumulators[2 * i].unsigned_integer : (double) accumulators[2 * i].integer;
+			}
+		}
+
+		accumulators[2 * i + 1].integer = 1;
+	}
+}
+
+/**
+@brief		Combines the aggregates of @p other into those of @p group.
+*/
+static void
+iinq_group_by_combine(
+	ion_iinq_group_by_t			*group_by,
+	ion_iinq_aggregate_value_t	*accumulators,
+	ion_iinq_aggregate_value_t	*other
+) {
+	unsigned int i;
+
+	for (i = 0; i < group_by->num_aggregates; i++) {
+		ion_iinq_aggregate_t		*aggregate	= &group_by->aggregates[i];
+		ion_iinq_aggregate_value_t	*value		= &accumulators[2 * i];
+		ion_iinq_aggregate_value_t	*partial	= &other[2 * i];
+		ion_boolean_t				is_unsigned = key_type_numeric_unsigned == aggregate->field.type;
+
+		switch (aggregate->type) {
+			case iinq_aggregate_min: {
+				if (is_unsigned ? partial->unsigned_integer < value->unsigned_integer : partial->integer < value->integer) {
+					*value = *partial;
+				}
+
+				break;
+			}
+
+			case iinq_aggregate_max: {
+				if (is_unsigned ? partial->unsigned_integer > value->unsigned_integer : partial->integer > value->integer) {
+					*value = *partial;
+				}
+
+				break;
+			}
+
+			case iinq_aggregate_avg: {
+				value->real += partial->real;
+				break;
+			}
+
+			default: {
+				if (is_unsigned && (iinq_aggregate_sum == aggregate->type)) {
+					value->unsigned_integer += partial->unsigned_integer;
+				}
+				else {
+					value->integer += partial->integer;
+				}
+
+				break;
+			}
+		}
+
+		accumulators[2 * i + 1].integer += other[2 * i + 1].integer;
+	}
+}
+
+/**
+@brief		Passes a finished group on.
+*/
+static void
+iinq_group_by_emit(
+	ion_iinq_group_by_t *group_by,
+	unsigned char		*group
+) {
+	ion_iinq_aggregate_value_t	*accumulators	= iinq_group_by_accumulators(group_by, group);
+	ion_iinq_result_t			result;
+	unsigned int				i;
+
+	result.num_bytes	= group_by->key.size + group_by->num_aggregates * sizeof(ion_iinq_aggregate_value_t);
+	result.data			= group_by->output;
+
+	memcpy(result.data, group, group_by->key.size);
+
+	for (i = 0; i < group_by->num_aggregates; i++) {
+		ion_iinq_aggregate_value_t value = accumulators[2 * i];
+
+		if (iinq_aggregate_avg == group_by->aggregates[i].type) {
+			value.real /= accumulators[2 * i + 1].integer;
+		}
+
+		memcpy(result.data + group_by->key.size + i * sizeof(ion_iinq_aggregate_value_t), &value, sizeof(ion_iinq_aggregate_value_t));
+	}
+
+	group_by->next->execute(&result, group_by->next->state);
+}
+
+/**
+@brief		Orders spilled groups byte for byte on the grouped field.
+*/
+static int
+iinq_group_by_compare(
+	unsigned char	*first,
+	unsigned char	*second,
+	void			*context
+) {
+	return memcmp(first, second, ((ion_iinq_group_by_t *) context)->key.size);
+}
+
+/**
+@brief		Hashes the grouped field with FNV-1a.
+*/
+static unsigned int
+iinq_group_by_hash(
+	unsigned char			*key,
+	ion_iinq_result_size_t	size
+) {
+	uint32_t				hash = 2166136261u;
+	ion_iinq_result_size_t	i;
+
+	for (i = 0; i < size; i++) {
+		hash	^= key[i];
+		hash	*= 16777619u;
+	}
+
+	return hash % (2 * IINQ_GROUP_BY_MAX_GROUPS);
+}
+
+/**
+@brief		Hands every group in memory to the spill sort and empties the table.
+*/
+static ion_err_t
+iinq_group_by_spill(
+	ion_iinq_group_by_t *group_by
+) {
+	ion_err_t		error;
+	unsigned int	i;
+
+	if (!group_by->spilled) {
+		error = iinq_sort_init(&group_by->spill, group_by->group_size, iinq_group_by_compare, group_by);
+
+		if (err_ok != error) {
+			return error;
+		}
+
+		group_by->spilled = boolean_true;
+	}
+
+	for (i = 0; i < group_by->num_groups; i++) {
+		error = iinq_sort_add(&group_by->spill, group_by->groups + i * group_by->group_size);
+
+		if (err_ok != error) {
+			return error;
+		}
+	}
+
+	group_by->num_groups = 0;
+	memset(group_by->slots, 0, 2 * IINQ_GROUP_BY_MAX_GROUPS * sizeof(unsigned int));
+
+	return err_ok;
+}
+
+/**
+@brief		Adds a result to its group.
+*/
+static
+IINQ_NEW_PROCESSOR_FUNC(iinq_group_by_execute) {
+	ion_iinq_group_by_t *group_by = state;
+
+	if (err_ok != group_by->error) {
+		return;
+	}
+
+	if (NULL == group_by->groups) {
+		group_by->groups	= malloc((IINQ_GROUP_BY_MAX_GROUPS + 1) * group_by->group_size);
+		group_by->slots		= calloc(2 * IINQ_GROUP_BY_MAX_GROUPS, sizeof(unsigned int));
+		group_by->output	= malloc(group_by->key.size + group_by->num_aggregates * sizeof(ion_iinq_aggregate_value_t));
+
+		if ((NULL == group_by->groups) || (NULL == group_by->slots) || (NULL == group_by->output)) {
+			group_by->error = err_out_of_memory;
+			return;
+		}
+	}
+
+	unsigned char	*key		= result->data + group_by->key.offset;
+	unsigned int	slot		= iinq_group_by_hash(key, group_by->key.size);
+	unsigned char	*spare		= group_by->groups + IINQ_GROUP_BY_MAX_GROUPS * group_by->group_size;
+
+	while (0 != group_by->slots[slot]) {
+		unsigned char *group = group_by->groups + (group_by->slots[slot] - 1) * group_by->group_size;
+
+		if (0 == memcmp(group, key, group_by->key.size)) {
+			iinq_group_by_start(group_by, spare, result->data);
+			iinq_group_by_combine(group_by, iinq_group_by_accumulators(group_by, group), iinq_group_by_accumulators(group_by, spare));
+			return;
+		}
+
+		slot = (slot + 1) % (2 * IINQ_GROUP_BY_MAX_GROUPS);
+	}
+
+	if (IINQ_GROUP_BY_MAX_GROUPS == group_by->num_groups) {
+		if (err_ok != (group_by->error = iinq_group_by_spill(group_by))) {
+			return;
+		}
+
+		slot = iinq_group_by_hash(key, group_by->key.size);
+	}
+
+	iinq_group_by_start(group_by, group_by->groups + group_by->num_groups * group_by->group_size, result->data);
+	group_by->slots[slot] = ++group_by->num_groups;
+}
+
+/**
+@brief		Combines the spilled groups coming out of the sort, passing each
+			group on once all of its partial aggregates have been seen.
+*/
+static
+IINQ_NEW_PROCESSOR_FUNC(iinq_group_by_merge) {
+	ion_iinq_group_by_t *group_by	= state;
+	unsigned char		*current	= group_by->groups;
+	unsigned char		*partial	= group_by->groups + group_by->group_size;
+
+	if (group_by->pending && (0 == memcmp(current, result->data, group_by->key.size))) {
+		/* Copied so that the aggregates are aligned. */
+		memcpy(partial, result->data, group_by->group_size);
+		iinq_group_by_combine(group_by, iinq_group_by_accumulators(group_by, current), iinq_group_by_accumulators(group_by, partial));
+		return;
+	}
+
+	if (group_by->pending) {
+		iinq_group_by_emit(group_by, current);
+	}
+
+	memcpy(current, result->data, group_by->group_size);
+	group_by->pending = boolean_true;
+}
+
+static void
+iinq_group_by_finish(
+	void *state
+) {
+	ion_iinq_group_by_t *group_by = state;
+	unsigned int		i;
+
+	if ((NULL != group_by->groups) && (err_ok == group_by->error)) {
+		if (!group_by->spilled) {
+			for (i = 0; i < group_by->num_groups; i++) {
+				iinq_group_by_emit(group_by, group_by->groups + i * group_by->group_size);
+			}
+		}
+		else if (err_ok == (group_by->error = iinq_group_by_spill(group_by))) {
+			ion_iinq_query_processor_t merge = IINQ_QUERY_PROCESSOR(iinq_group_by_merge, group_by);
+
+			group_by->pending	= boolean_false;
+			group_by->error		= iinq_sort_finish(&group_by->spill, &merge);
+			group_by->spilled	= boolean_false;
+
+			if ((err_ok == group_by->error) && group_by->pending) {
+				iinq_group_by_emit(group_by, group_by->groups);
+			}
+		}
+	}
+
+	if (group_by->spilled) {
+		iinq_sort_finish(&group_by->spill, NULL);
+	}
+
+	free(group_by->groups);
+	free(group_by->slots);
+	free(group_by->output);
+	group_by->groups	= NULL;
+	group_by->slots		= NULL;
+	group_by->output	= NULL;
+
+	iinq_finish_processor(group_by->next);
+}
+
+void
+iinq_group_by_init(
+	ion_iinq_group_by_t			*group_by,
+	ion_iinq_field_t			key,
+	ion_iinq_aggregate_t		*aggregates,
+	unsigned int				num_aggregates,
+	ion_iinq_query_processor_t	*next
+) {
+	group_by->processor			= IINQ_QUERY_PROCESSOR(iinq_group_by_execute, group_by);
+	group_by->processor.finish	= iinq_group_by_finish;
+	group_by->next				= next;
+	group_by->key				= key;
+	group_by->aggregates		= aggregates;
+	group_by->num_aggregates	= num_aggregates;
+	group_by->key_space			= (key.size + sizeof(ion_iinq_aggregate_value_t) - 1) / sizeof(ion_iinq_aggregate_value_t) * sizeof(ion_iinq_aggregate_value_t);
+	group_by->group_size		= group_by->key_space + 2 * num_aggregates * sizeof(ion_iinq_aggregate_value_t);
+	group_by->groups			= NULL;
+	group_by->slots				= NULL;
+	group_by->num_groups		= 0;
+	group_by->output			= NULL;
+	group_by->spilled			= boolean_false;
+	group_by->pending			= boolean_false;
+	group_by->error				= err_ok;
+}
+
+/**
+@brief		Passes the current batch on, if it holds anything.
+*/
+static void
+iinq_batch_flush(
+	ion_iinq_batch_t *batch
+) {
+	ion_iinq_result_t result;
+
+	if (0 == batch->num_rows) {
+		return;
+	}
+
+	result.num_bytes	= batch->num_rows * batch->row_size;
+	result.data			= batch->rows;
+	batch->execute(&result, batch->num_rows, batch->state);
+	batch->num_rows		= 0;
+}
+
+/**
+@brief		Adds a result to the current batch, passing the batch on once full.
+*/
+static
+IINQ_NEW_PROCESSOR_FUNC(iinq_batch_execute) {
+	ion_iinq_batch_t *batch = state;
+
+	if (err_ok != batch->error) {
+		return;
+	}
+
+	if (NULL == batch->rows) {
+		batch->row_size = result->num_bytes;
+		batch->rows		= malloc(batch->batch_size * batch->row_size);
+
+		if (NULL == batch->rows) {
+			batch->error = err_out_of_memory;
+			return;
+		}
+	}
+
+	memcpy(batch->rows + batch->num_rows * batch->row_size, result->data, batch->row_size);
+
+	if (++batch->num_rows == batch->batch_size) {
+		iinq_batch_flush(batch);
+	}
+}
+
+static void
+iinq_batch_finish(
+	void *state
+) {
+	ion_iinq_batch_t *batch = state;
+
+	iinq_batch_flush(batch);
+	free(batch->rows);
+	batch->rows = NULL;
+}
+
+void
+iinq_batch_init(
+	ion_iinq_batch_t		*batch,
+	unsigned int			batch_size,
+	ion_iinq_batch_func_t	execute,
+	void					*state
+) {
+	batch->processor		= IINQ_QUERY_PROCESSOR(iinq_batch_execute, batch);
+	batch->processor.finish = iinq_batch_finish;
+	batch->execute			= execute;
+	batch->state			= state;
+	batch->batch_size		= 0 == batch_size ? 1 : batch_size;
+	batch->num_rows			= 0;
+	batch->row_size			= 0;
+	batch->rows				= NULL;
+	batch->error			= err_ok;
+}
@@ -0,0 +1,473 @@
+/******************************************************************************/
+/**
+@file		iinq_operators.h
+@author		IonDB Project
+@brief		GROUP BY, HAVING, ORDER BY, LIMIT and batching operators for IINQ
+			queries.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#if !defined(IINQ_OPERATORS_H_)
+#define IINQ_OPERATORS_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include "iinq.h"
+
+#if !defined(IINQ_SORT_BUFFER_SIZE)
+/**
+@brief		How many bytes of results a sort holds in memory before writing
+			them out to disk as a sorted run.
+*/
+#define IINQ_SORT_BUFFER_SIZE 1024
+#endif
+
+#if !defined(IINQ_SORT_FAN_IN)
+/**
+@brief		How many sorted runs are merged at once.
+*/
+#define IINQ_SORT_FAN_IN 8
+#endif
+
+#if !defined(IINQ_SORT_READ_ROWS)
+/**
+@brief		How many results of each run are read at a time while merging.
+*/
+#define IINQ_SORT_READ_ROWS 4
+#endif
+
+#if !defined(IINQ_GROUP_BY_MAX_GROUPS)
+/**
+@brief		How many groups a GROUP BY holds in memory. Once more groups are
+			seen, the partial aggregates are sorted out to disk and combined
+			when the query ends.
+*/
+#define IINQ_GROUP_BY_MAX_GROUPS 32
+#endif
+
+/**
+@brief		A fixed size field of a query result.
+*/
+typedef struct {
+	/**> Byte offset of the field within the result. */
+	ion_iinq_result_size_t	offset;
+	/**> Size of the field in bytes. */
+	ion_iinq_result_size_t	size;
+	/**> How the field is compared and read, as for a key of the same type. */
+	ion_key_type_t			type;
+} ion_iinq_field_t;
+
+#define IINQ_FIELD(offset, size, type) \
+	((ion_iinq_field_t) { (offset), (size), (type) })
+
+/**
+@brief		A field to sort on, and in which direction.
+*/
+typedef struct {
+	ion_iinq_field_t	field;
+	/**> @c 1 to sort ascending, @c -1 to sort descending. */
+	signed char			direction;
+} ion_iinq_order_t;
+
+#define IINQ_ASC(offset, size, type) \
+	((ion_iinq_order_t) { IINQ_FIELD(offset, size, type), 1 })
+
+#define IINQ_DESC(offset, size, type) \
+	((ion_iinq_order_t) { IINQ_FIELD(offset, size, type), -1 })
+
+/**
+@brief		A type for storing aggregate function data.
+*/
+typedef char ion_iinq_aggregate_type_t;
+
+/**
+@brief		The aggregate functions supported by GROUP BY.
+*/
+enum aggregate_types {
+	iinq_aggregate_count,	/**< Number of results in the group. */
+	iinq_aggregate_sum,	/**< Sum of a numeric field. */
+	iinq_aggregate_min,	/**< Smallest value of a numeric field. */
+	iinq_aggregate_max,	/**< Largest value of a numeric field. */
+	iinq_aggregate_avg	/**< Mean value of a numeric field. */
+};
+
+/**
+@brief		An aggregate function, and the field it is computed over.
+*/
+typedef struct {
+	ion_iinq_aggregate_type_t	type;
+	/**> The numeric field aggregated. Unused for @ref iinq_aggregate_count. */
+	ion_iinq_field_t			field;
+} ion_iinq_aggregate_t;
+
+/**
+@brief		The value of an aggregate. @ref iinq_aggregate_count, and
+			@ref iinq_aggregate_sum, @ref iinq_aggregate_min and
+			@ref iinq_aggregate_max of signed fields are integers, those of
+			unsigned fields are unsigned integers, and
+			@ref iinq_aggregate_avg is real.
+*/
+typedef union {
+	int64_t		integer;
+	uint64_t	unsigned_integer;
+	double		real;
+} ion_iinq_aggregate_value_t;
+
+#define IINQ_COUNT() \
+	((ion_iinq_aggregate_t) { iinq_aggregate_count, IINQ_FIELD(0, 0, key_type_numeric_signed) })
+
+#define IINQ_SUM(offset, size, type) \
+	((ion_iinq_aggregate_t) { iinq_aggregate_sum, IINQ_FIELD(offset, size, type) })
+
+#define IINQ_MIN(offset, size, type) \
+	((ion_iinq_aggregate_t) { iinq_aggregate_min, IINQ_FIELD(offset, size, type) })
+
+#define IINQ_MAX(offset, size, type) \
+	((ion_iinq_aggregate_t) { iinq_aggregate_max, IINQ_FIELD(offset, size, type) })
+
+#define IINQ_AVG(offset, size, type) \
+	((ion_iinq_aggregate_t) { iinq_aggregate_avg, IINQ_FIELD(offset, size, type) })
+
+/**
+@brief		Function pointer type comparing two results for a sort, returning
+			less than, equal to or greater than @c 0 like @c memcmp.
+*/
+typedef int (*ion_iinq_row_compare_t)(unsigned char *, unsigned char *, void *);
+
+/**
+@brief		An external merge sort of fixed size results.
+@details	Results are held in memory up to @ref IINQ_SORT_BUFFER_SIZE bytes.
+			Beyond that, each full buffer is sorted and appended to a run file,
+			and the runs are merged @ref IINQ_SORT_FAN_IN at a time once every
+			result has been added.
+*/
+typedef struct {
+	/**> Size of each result in bytes. */
+	ion_iinq_result_size_t	row_size;
+	/**> How results are ordered. */
+	ion_iinq_row_compare_t	compare;
+	/**> Passed to @p compare. */
+	void					*context;
+	/**> The results held in memory, followed by one spare result used for swaps. */
+	unsigned char			*rows;
+	/**> How many results are held in memory. */
+	unsigned long			num_rows;
+	/**> How many results fit in memory. */
+	unsigned long			capacity;
+	/**> The run file being read from, and the one merged runs are written to. */
+	FILE					*files[2];
+	/**> Used to name the run files. */
+	unsigned int			id;
+	/**> How many results each run on disk holds. */
+	unsigned long			*run_lengths;
+	/**> How many runs are on disk. */
+	unsigned int			num_runs;
+	/**> How many run lengths there is room for. */
+	unsigned int			runs_capacity;
+} ion_iinq_sort_t;
+
+/**
+@brief		Starts an external sort.
+@param[out]	sort
+				The sort to start.
+@param[in]	row_size
+				Size of each result in bytes.
+@param[in]	compare
+				How results are ordered.
+@param[in]	context
+				Passed to @p compare.
+@return		The status of allocating the sort buffer.
+*/
+ion_err_t
+iinq_sort_init(
+	ion_iinq_sort_t			*sort,
+	ion_iinq_result_size_t	row_size,
+	ion_iinq_row_compare_t	compare,
+	void					*context
+);
+
+/**
+@brief		Adds a result to a sort.
+@param[in]	sort
+				The sort.
+@param[in]	row
+				The result, @c row_size bytes long.
+@return		The status of writing out a run, if the buffer was full.
+*/
+ion_err_t
+iinq_sort_add(
+	ion_iinq_sort_t	*sort,
+	unsigned char	*row
+);
+
+/**
+@brief		Passes every result added to a sort to @p processor in order, then
+			frees the sort and removes its run files.
+@details	The processor is not finished, so that the sorted results can be
+			passed on as part of a larger stream.
+@param[in]	sort
+				The sort.
+@param[in]	processor
+				Where to send the sorted results, or @c NULL to drop them.
+@return		The status of merging the runs.
+*/
+ion_err_t
+iinq_sort_finish(
+	ion_iinq_sort_t				*sort,
+	ion_iinq_query_processor_t	*processor
+);
+
+/**
+@brief		Passes on the first results it is given, then drops the rest.
+*/
+typedef struct {
+	ion_iinq_query_processor_t	processor;
+	/**> Where the results are passed on to. */
+	ion_iinq_query_processor_t	*next;
+	/**> How many results are passed on. */
+	unsigned long				limit;
+	/**> How many results have been passed on. */
+	unsigned long				count;
+	/**> Set once the limit has been reached, so that whoever feeds this can stop. */
+	ion_boolean_t				reached;
+} ion_iinq_limit_t;
+
+void
+iinq_limit_init(
+	ion_iinq_limit_t			*limit,
+	unsigned long				count,
+	ion_iinq_query_processor_t	*next
+);
+
+/**
+@brief		Function pointer type deciding whether a result of a GROUP BY is kept.
+*/
+typedef ion_boolean_t (*ion_iinq_having_func_t)(ion_iinq_result_t *, void *);
+
+/**
+@brief		Passes on only the results that satisfy a condition.
+*/
+typedef struct {
+	ion_iinq_query_processor_t	processor;
+	/**> Where the results are passed on to. */
+	ion_iinq_query_processor_t	*next;
+	/**> The condition results must satisfy. */
+	ion_iinq_having_func_t		condition;
+	/**> Passed to @p condition. */
+	void						*state;
+} ion_iinq_having_t;
+
+void
+iinq_having_init(
+	ion_iinq_having_t			*having,
+	ion_iinq_having_func_t		condition,
+	void						*state,
+	ion_iinq_query_processor_t	*next
+);
+
+/**
+@brief		Sorts results before passing them on.
+@details	With a limit of @c N, only the first @c N results in order are kept,
+			in a heap in memory. Without one, results are sorted with an
+			external merge sort, so memory use is bounded by
+			@ref IINQ_SORT_BUFFER_SIZE.
+*/
+typedef struct {
+	ion_iinq_query_processor_t	processor;
+	/**> Where the sorted results are passed on to. */
+	ion_iinq_query_processor_t	*next;
+	/**> The fields to sort on, most significant first. */
+	ion_iinq_order_t			*orders;
+	/**> How many fields are sorted on. */
+	unsigned int				num_orders;
+	/**> How many results to keep, or @c 0 to keep them all. */
+	unsigned long				limit;
+	/**> Size of each result, known once the first one arrives. */
+	ion_iinq_result_size_t		row_size;
+	/**> The kept results as a heap with the last in order on top, when limited. */
+	unsigned char				*heap;
+	/**> How many results are in the heap. */
+	unsigned long				heap_size;
+	/**> The external sort, when not limited. */
+	ion_iinq_sort_t				sort;
+	/**> Set once the first result has arrived. */
+	ion_boolean_t				started;
+	/**> The first error met while sorting. */
+	ion_err_t					error;
+} ion_iinq_order_by_t;
+
+void
+iinq_order_by_init(
+	ion_iinq_order_by_t			*order_by,
+	ion_iinq_order_t			*orders,
+	unsigned int				num_orders,
+	unsigned long				limit,
+	ion_iinq_query_processor_t	*next
+);
+
+/**
+@brief		Groups results on a field and computes aggregates over each group.
+@details	Groups are kept in a hash table of @ref IINQ_GROUP_BY_MAX_GROUPS
+			entries. When it overflows, its partial aggregates are handed to an
+			external sort and the table is emptied. Once the query ends the
+			sorted partial aggregates of each group are combined.
+
+			Each group is passed on as the grouped field followed by one
+			@ref ion_iinq_aggregate_value_t per aggregate, in the order the
+			aggregates were given. The values are not necessarily aligned and
+			should be read with @c memcpy.
+*/
+typedef struct {
+	ion_iinq_query_processor_t	processor;
+	/**> Where the groups are passed on to. */
+	ion_iinq_query_processor_t	*next;
+	/**> The field results are grouped on. */
+	ion_iinq_field_t			key;
+	/**> The aggregates computed for each group. */
+	ion_iinq_aggregate_t		*aggregates;
+	/**> How many aggregates are computed. */
+	unsigned int				num_aggregates;
+	/**> Bytes taken by the grouped field, rounded up to align what follows. */
+	ion_iinq_result_size_t		key_space;
+	/**> Size of a group: the grouped field then a value and a count per aggregate. */
+	ion_iinq_result_size_t		group_size;
+	/**> The groups in memory, followed by one spare group. */
+	unsigned char				*groups;
+	/**> Hash table of group index + 1, so that @c 0 is empty. */
+	unsigned int				*slots;
+	/**> How many groups are in memory. */
+	unsigned int				num_groups;
+	/**> Where a group is laid out before being passed on. */
+	unsigned char				*output;
+	/**> Holds partial aggregates once the table has overflowed. */
+	ion_iinq_sort_t				spill;
+	/**> Set once the table has overflowed. */
+	ion_boolean_t				spilled;
+	/**> Set while combining the spilled groups once a group is pending. */
+	ion_boolean_t				pending;
+	/**> The first error met while grouping. */
+	ion_err_t					error;
+} ion_iinq_group_by_t;
+
+void
+iinq_group_by_init(
+	ion_iinq_group_by_t			*group_by,
+	ion_iinq_field_t			key,
+	ion_iinq_aggregate_t		*aggregates,
+	unsigned int				num_aggregates,
+	ion_iinq_query_processor_t	*next
+);
+
+/**
+@brief		Function pointer type for processing a batch of query results.
+@details	The batch holds @p num_rows results of equal size one after the
+			other, @c num_bytes in total.
+*/
+typedef void (*ion_iinq_batch_func_t)(ion_iinq_result_t *, unsigned int, void *);
+
+/**
+@brief		Gathers results into batches, so that they are processed many at
+			a time rather than one at a time.
+*/
+typedef struct {
+	ion_iinq_query_processor_t	processor;
+	/**> Called with each full batch, and with the last partial one. */
+	ion_iinq_batch_func_t		execute;
+	/**> Passed to @p execute. */
+	void						*state;
+	/**> How many results make up a batch. */
+	unsigned int				batch_size;
+	/**> How many results are in the current batch. */
+	unsigned int				num_rows;
+	/**> Size of each result, known once the first one arrives. */
+	ion_iinq_result_size_t		row_size;
+	/**> The current batch. */
+	unsigned char				*rows;
+	/**> Set if the batch could not be allocated. */
+	ion_err_t					error;
+} ion_iinq_batch_t;
+
+/**
+@brief		Sets up a processor that passes results on in batches.
+@param[out]	batch
+				The batch processor. Give @c &batch->processor to the query.
+@param[in]	batch_size
+				How many results make up a batch.
+@param[in]	execute
+				Called with each batch.
+@param[in]	state
+				Passed to @p execute.
+*/
+void
+iinq_batch_init(
+	ion_iinq_batch_t		*batch,
+	unsigned int			batch_size,
+	ion_iinq_batch_func_t	execute,
+	void					*state
+);
+
+/*
+ * The clauses below are meant for the QUERY macro, which applies them in the order GROUP BY, HAVING, ORDER BY, LIMIT.
+ */
+#define GROUP_BY(key, ...) \
+	ion_iinq_group_by_t group_by_operator; \
+	iinq_group_by_init(&group_by_operator, key, (ion_iinq_aggregate_t[]) { __VA_ARGS__ }, sizeof((ion_iinq_aggregate_t[]) { __VA_ARGS__ }) / sizeof(ion_iinq_aggregate_t), query_processor); \
+	query_processor		= &group_by_operator.processor; \
+	query_limit_reached = NULL;
+
+#define HAVING(condition, state) \
+	ion_iinq_having_t having_operator; \
+	iinq_having_init(&having_operator, condition, state, query_processor); \
+	query_processor		= &having_operator.processor; \
+	query_limit_reached = NULL;
+
+/*
+ * ORDER_BY takes the fields to sort on, each given with IINQ_ASC or IINQ_DESC.
+ */
+#define ORDER_BY(...) \
+	ion_iinq_order_by_t order_by_operator; \
+	iinq_order_by_init(&order_by_operator, (ion_iinq_order_t[]) { __VA_ARGS__ }, sizeof((ion_iinq_order_t[]) { __VA_ARGS__ }) / sizeof(ion_iinq_order_t), query_limit, query_processor); \
+	query_processor		= &order_by_operator.processor; \
+	query_limit_reached = NULL;
+
+#define LIMIT(count) \
+	ion_iinq_limit_t limit_operator; \
+	iinq_limit_init(&limit_operator, (count), query_processor); \
+	query_processor		= &limit_operator.processor; \
+	query_limit_reached = &limit_operator.reached; \
+	query_limit			= limit_operator.limit;
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
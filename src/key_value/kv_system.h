@@ -54,6 +54,7 @@ extern "C" {
 /* Only on PC */
 #if !defined(ARDUINO)
 #define fremove(x)	remove(x)
+#define frename(x, y)	rename(x, y)
 #define frewind(x)	rewind(x)
 #define fdeleteall()
 #endif
@@ -72,6 +73,127 @@ extern "C" {
 */
 #define ION_MAX_FILENAME_LENGTH 12
 
+/**
+@brief		Compiles in per-dictionary latency histograms. Off on Arduino,
+			where the histograms would not fit in RAM.
+@see		dictionary_enable_stats
+*/
+#if !defined(ION_DICTIONARY_STATS)
+#if defined(ARDUINO)
+#define ION_DICTIONARY_STATS 0
+#else
+#define ION_DICTIONARY_STATS 1
+#endif
+#endif
+
+/**
+@brief		Compiles in per-file and per-dictionary I/O counters in the
+			file layer. Off on Arduino.
+@see		ion_file_stats.h
+*/
+#if !defined(ION_FILE_STATS)
+#if defined(ARDUINO)
+#define ION_FILE_STATS 0
+#else
+#define ION_FILE_STATS 1
+#endif
+#endif
+
+/**
+@brief		Serves the reads of an @ref ion_file_queue_t with io_uring, so
+			that many of them are in flight at once. Only on Linux with
+			kernel headers that know io_uring. Kernels that refuse it at run
+			time get synchronous reads instead.
+@see		ion_file_queue.h
+*/
+#if !defined(ION_FILE_IO_URING)
+#if defined(__linux__) && !defined(ARDUINO) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define ION_FILE_IO_URING 1
+#endif
+#endif
+#endif
+
+#if !defined(ION_FILE_IO_URING)
+#define ION_FILE_IO_URING 0
+#endif
+
+/**
+@brief		Makes dictionaries safe to share between threads. Readers
+			(@ref dictionary_get and cursors) of a dictionary run
+			concurrently, writers take it exclusively unless its handler
+			is concurrent. Off by default, and unavailable on Arduino.
+			Needs POSIX threads and a
+			@c _POSIX_C_SOURCE of at least 200112L, which the CMake
+			option @c ION_THREAD_SAFE sets up.
+@see		dictionary_find
+*/
+#if !defined(ION_THREAD_SAFE)
+#define ION_THREAD_SAFE 0
+#endif
+
+#if ION_THREAD_SAFE && defined(ARDUINO)
+#error "ION_THREAD_SAFE is not supported on Arduino"
+#endif
+
+#if ION_THREAD_SAFE
+
+#include <pthread.h>
+
+typedef pthread_rwlock_t	ion_rwlock_t;
+typedef pthread_mutex_t		ion_mutex_t;
+typedef pthread_cond_t		ion_cond_t;
+
+#define ION_RWLOCK_INIT(lock)		pthread_rwlock_init(&(lock), NULL)
+#define ION_RWLOCK_DESTROY(lock)	pthread_rwlock_destroy(&(lock))
+#define ION_RWLOCK_READ(lock)		pthread_rwlock_rdlock(&(lock))
+#define ION_RWLOCK_WRITE(lock)		pthread_rwlock_wrlock(&(lock))
+#define ION_RWLOCK_UNLOCK(lock)		pthread_rwlock_unlock(&(lock))
+
+#define ION_MUTEX_INITIALIZER		PTHREAD_MUTEX_INITIALIZER
+#define ION_MUTEX_INIT(mutex)		pthread_mutex_init(&(mutex), NULL)
+#define ION_MUTEX_DESTROY(mutex)	pthread_mutex_destroy(&(mutex))
+#define ION_MUTEX_LOCK(mutex)		pthread_mutex_lock(&(mutex))
+#define ION_MUTEX_UNLOCK(mutex)		pthread_mutex_unlock(&(mutex))
+
+#define ION_COND_INIT(cond)			pthread_cond_init(&(cond), NULL)
+#define ION_COND_DESTROY(cond)		pthread_cond_destroy(&(cond))
+#define ION_COND_WAIT(cond, mutex)	pthread_cond_wait(&(cond), &(mutex))
+#define ION_COND_BROADCAST(cond)	pthread_cond_broadcast(&(cond))
+
+/* Sequentially consistent, so that code built on them never has to reason about weaker orderings. */
+#define ION_ATOMIC_LOAD(pointer)					__atomic_load_n((pointer), __ATOMIC_SEQ_CST)
+#define ION_ATOMIC_STORE(pointer, value)			__atomic_store_n((pointer), (value), __ATOMIC_SEQ_CST)
+#define ION_ATOMIC_CAS(pointer, expected, desired)	__sync_bool_compare_and_swap((pointer), (expected), (desired))
+#define ION_ATOMIC_FETCH_ADD(pointer, value)		__atomic_fetch_add((pointer), (value), __ATOMIC_SEQ_CST)
+
+#else /* Clause ION_THREAD_SAFE */
+
+/* Locks only exist in thread-safe builds, so their arguments are never evaluated. */
+#define ION_RWLOCK_INIT(lock)
+#define ION_RWLOCK_DESTROY(lock)
+#define ION_RWLOCK_READ(lock)
+#define ION_RWLOCK_WRITE(lock)
+#define ION_RWLOCK_UNLOCK(lock)
+
+#define ION_MUTEX_INIT(mutex)
+#define ION_MUTEX_DESTROY(mutex)
+#define ION_MUTEX_LOCK(mutex)
+#define ION_MUTEX_UNLOCK(mutex)
+
+#define ION_COND_INIT(cond)
+#define ION_COND_DESTROY(cond)
+#define ION_COND_WAIT(cond, mutex)
+#define ION_COND_BROADCAST(cond)
+
+/* Without threads, atomic operations are plain ones. */
+#define ION_ATOMIC_LOAD(pointer)					(*(pointer))
+#define ION_ATOMIC_STORE(pointer, value)			(*(pointer) = (value))
+#define ION_ATOMIC_CAS(pointer, expected, desired)	((*(pointer) == (expected)) ? (*(pointer) = (desired), 1) : 0)
+#define ION_ATOMIC_FETCH_ADD(pointer, value)		((*(pointer) += (value)) - (value))
+
+#endif /* Clause ION_THREAD_SAFE */
+
 /* ==================== ARDUINO CONDITIONAL COMPILATION ================================ */
 #if !defined(ARDUINO)
 /* Only if we're on desktop do we want to flush. Otherwise we only do a printf. */
@@ -147,6 +269,12 @@ typedef enum ION_DICTIONARY_TYPE {
 	dictionary_type_skip_list_t,
 	/**> Dictionary type is a Linear Hash implementation. */
 	dictionary_type_linear_hash_t,
+	/**> Dictionary type is a Log-Structured Merge tree implementation. */
+	dictionary_type_lsm_t,
+	/**> Dictionary type is a lock-free Skip List implementation. */
+	dictionary_type_concurrent_skip_list_t,
+	/**> Dictionary type is a hash partitioned set of inner dictionaries. */
+	dictionary_type_sharded_t,
 	/**> Dictionary type is not initialized. */
 	dictionary_type_error_t
 } ion_dictionary_type_t;
@@ -215,7 +343,13 @@ enum ION_ERROR {
 	err_out_of_bounds,
 	/**> An error code describing the situation where an operation would
 		 violate the sorted precondition. */
-	err_sorted_order_violation
+	err_sorted_order_violation,
+	/**> An error code describing the situation where a rename operation
+		 has failed. */
+	err_file_rename_error,
+	/**> An error code describing the situation where an operation would
+		 wait on a lock the calling thread itself holds. */
+	err_would_deadlock
 };
 
 /**
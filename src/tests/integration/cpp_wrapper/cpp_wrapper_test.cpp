@@ -35,6 +35,7 @@
 /******************************************************************************/
 
 #include <iostream>
+#include <cstring>
 
 using namespace std;
 
@@ -45,91 +46,95 @@ using namespace std;
 /* #include "../../../cpp_wrapper/OpenAddressFileHash.h" */
 /*#include "../../../cpp_wrapper/OpenAddressHash.h"*/
 
+/* Values are stored as raw bytes, so they must have a fixed size. */
+struct message {
+	char text[10];
+};
+
+static message
+to_message(
+	const char *text
+) {
+	message m = message();
+
+	strncpy(m.text, text, sizeof(m.text) - 1);
+	return m;
+}
+
 int
 main(
 ) {
-	/* The following is example test code using int keys and string values */
-	Dictionary<int, string> *dict = new FlatFile<int, string>(0, key_type_numeric_signed, sizeof(int), 10, 30);
+	/* The following is example test code using int keys and fixed size string values */
+	Dictionary<int, message> *dict = new FlatFile<int, message>(0, 30);
 
 	printf("Insert %d [%s]\n", 3, "hello!");
 
-	string s = "hello!";
-
-	dict->insert(3, s);
+	dict->insert(3, to_message("hello!"));
 
-	string buf = dict->get(3);
+	message buf = dict->get(3);
 
-	cout << "Retrieve key 3 and got back " << buf << endl << endl;
+	cout << "Retrieve key 3 and got back " << buf.text << endl << endl;
 
 	cout << "Updating value of key 3 to hi!" << endl;
 
-	string t = "hi!";
+	dict->update(3, to_message("hi!"));
 
-	dict->update(3, t);
+	message buf2 = dict->get(3);
 
-	string buf2 = dict->get(3);
-
-	cout << "Retrieve key 3 after update and got back " << buf2 << endl << endl;
+	cout << "Retrieve key 3 after update and got back " << buf2.text << endl << endl;
 
 	cout << "Delete key 3" << endl;
 	dict->deleteRecord(3);
 
 	cout << "Try and retrieve key 3 after deletion" << endl;
 
-	string buf3 = dict->get(3);
+	dict->get(3);
 
 	cout << "Retrieve key 3 and got back status " << (int) dict->last_status.error << endl << endl;
 
 	printf("Insert %d [%s]\n", 3, "test1!");
 
-	string u = "test1!";
-
-	dict->insert(3, u);
+	dict->insert(3, to_message("test1!"));
 
 	printf("Insert %d [%s]\n", 3, "test2!");
 
-	string v = "test2!";
-
-	dict->insert(3, v);
+	dict->insert(3, to_message("test2!"));
 
 	printf("Insert %d [%s]\n", 4, "test3!");
 
-	string w = "test3!";
-
-	dict->insert(4, w);
+	dict->insert(4, to_message("test3!"));
 
 	cout << "Testing equality query on key 3: " << endl;
-	Cursor<int, string> *eq_cursor = dict->equality(3);
 
-	while (eq_cursor->next()) {
-		cout << "[eq] Got back [" << eq_cursor->getKey() << ", " << eq_cursor->getValue() << "]" << endl;
+	{
+		Cursor<int, message> eq_cursor = dict->equality(3);
+
+		while (eq_cursor.next()) {
+			cout << "[eq] Got back [" << eq_cursor.getKey() << ", " << eq_cursor.getValue().text << "]" << endl;
+		}
 	}
 
 	cout << endl;
 
-	delete eq_cursor;
-
 	cout << "Testing all records query: " << endl;
-	Cursor<int, string> *all_cursor = dict->allRecords();
 
-	while (all_cursor->next()) {
-		cout << "[all] Got back [" << all_cursor->getKey() << ", " << all_cursor->getValue() << "]" << endl;
+	for (auto &record : dict->allRecords()) {
+		cout << "[all] Got back [" << record.key << ", " << record.value.text << "]" << endl;
 	}
 
 	cout << endl;
 
-	delete all_cursor;
-
 	cout << "Testing range query: 2<=key<=3 " << endl;
-	Cursor<int, string> *range_cursor = dict->range(2, 3);
 
-	while (range_cursor->next()) {
-		cout << "[range] Got back [" << range_cursor->getKey() << ", " << range_cursor->getValue() << "]" << endl;
+	{
+		Cursor<int, message> range_cursor = dict->range(2, 3);
+
+		while (range_cursor.next()) {
+			cout << "[range] Got back [" << range_cursor.getKey() << ", " << range_cursor.getValue().text << "]" << endl;
+		}
 	}
 
 	cout << endl;
 
-	delete range_cursor;
-
 	delete dict;
 }
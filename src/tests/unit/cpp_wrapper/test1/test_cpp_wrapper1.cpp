@@ -341,27 +341,27 @@ test_cpp_wrapper_delete_empty_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_delete_empty(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_delete_empty(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_delete_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_empty(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_empty(tc, dict);
 	delete dict;
 }
@@ -392,27 +392,27 @@ test_cpp_wrapper_delete_nonexist_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_delete_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_delete_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_delete_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_nonexist_single(tc, dict);
 	delete dict;
 }
@@ -442,27 +442,27 @@ test_cpp_wrapper_delete_nonexist_several_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_delete_nonexist_several(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_delete_nonexist_several(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_delete_nonexist_several(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_nonexist_several(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_nonexist_several(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_nonexist_several(tc, dict);
 	delete dict;
 }
@@ -491,27 +491,27 @@ test_cpp_wrapper_delete_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_delete_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_delete_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_delete_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_delete_single(tc, dict);
 	delete dict;
 }
@@ -539,27 +539,27 @@ test_cpp_wrapper_delete_single_several_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_delete_single_several(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new SkipList<int, int>(0, 50);
 	test_cpp_wrapper_delete_single_several(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new FlatFile<int, int>(0, 50);
 	test_cpp_wrapper_delete_single_several(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressHash<int, int>(0, 160);
 	test_cpp_wrapper_delete_single_several(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressFileHash<int, int>(0, 160);
 	test_cpp_wrapper_delete_single_several(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new LinearHash<int, int>(0, 160);
 	test_cpp_wrapper_delete_single_several(tc, dict);
 	delete dict;
 }
@@ -600,27 +600,27 @@ test_cpp_wrapper_delete_all_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_delete_all(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new SkipList<int, int>(0, 50);
 	test_cpp_wrapper_delete_all(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new FlatFile<int, int>(0, 50);
 	test_cpp_wrapper_delete_all(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressHash<int, int>(0, 160);
 	test_cpp_wrapper_delete_all(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressFileHash<int, int>(0, 160);
 	test_cpp_wrapper_delete_all(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new LinearHash<int, int>(0, 160);
 	test_cpp_wrapper_delete_all(tc, dict);
 	delete dict;
 }
@@ -654,27 +654,27 @@ test_cpp_wrapper_delete_then_insert_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_delete_then_insert(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new SkipList<int, int>(0, 50);
 	test_cpp_wrapper_delete_then_insert(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new FlatFile<int, int>(0, 50);
 	test_cpp_wrapper_delete_then_insert(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressHash<int, int>(0, 160);
 	test_cpp_wrapper_delete_then_insert(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressFileHash<int, int>(0, 160);
 	test_cpp_wrapper_delete_then_insert(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new LinearHash<int, int>(0, 160);
 	test_cpp_wrapper_delete_then_insert(tc, dict);
 	delete dict;
 }
@@ -728,27 +728,27 @@ test_master_table_dictionary_create_delete_all_1(
 ) {
 	Dictionary<int, int> *dictionary;
 
-	dictionary = new BppTree<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dictionary = new BppTree<int, int>(1);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_create_delete(tc, dictionary, 0, dictionary_type_bpp_tree_t);
 
-	dictionary = new FlatFile<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dictionary = new FlatFile<int, int>(1, 30);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_create_delete(tc, dictionary, 30, dictionary_type_flat_file_t);
 
-	dictionary = new OpenAddressHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dictionary = new OpenAddressHash<int, int>(1, 50);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_create_delete(tc, dictionary, 50, dictionary_type_open_address_hash_t);
 
-	dictionary = new OpenAddressFileHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dictionary = new OpenAddressFileHash<int, int>(1, 50);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_create_delete(tc, dictionary, 50, dictionary_type_open_address_file_hash_t);
 
-	dictionary = new SkipList<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dictionary = new SkipList<int, int>(1, 7);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_create_delete(tc, dictionary, 7, dictionary_type_skip_list_t);
 
-	dictionary = new LinearHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dictionary = new LinearHash<int, int>(1, 7);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_create_delete(tc, dictionary, 7, dictionary_type_linear_hash_t);
 }
@@ -771,7 +771,7 @@ test_master_table_dictionary_create_delete(
 
 	int type = 0;
 
-	dictionary = master_table->initializeDictionary(key_type_numeric_signed, type, type, sizeof(int), sizeof(int), dictionary_size, dictionary_type);
+	dictionary = master_table->initializeDictionary(key_type_numeric_signed, type, type, dictionary_size, dictionary_type);
 	master_table_create_dictionary(tc, master_table, dictionary, 1, key_type_numeric_signed, sizeof(int), sizeof(int), dictionary_size, dictionary_type);
 	master_table_delete_dictionary(tc, master_table, dictionary);
 
@@ -856,6 +856,173 @@ test_static_delete_all_all(
 /*	delete dict; */
 }
 
+/**
+@brief	This function tests that key types and record sizes follow the C++
+		types of a dictionary, and that reopening it with other sizes fails.
+*/
+void
+test_cpp_wrapper_compile_time_types(
+	planck_unit_test_t *tc
+) {
+	Dictionary<unsigned int, char> *unsigned_dict = new SkipList<unsigned int, char>(0, 7);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, unsigned_dict->last_status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, key_type_numeric_unsigned, unsigned_dict->dict.instance->key_type);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, sizeof(unsigned int), unsigned_dict->dict.instance->record.key_size);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, sizeof(char), unsigned_dict->dict.instance->record.value_size);
+	delete unsigned_dict;
+
+	Dictionary<int, int> *dict = new SkipList<int, int>(0, 7, key_type_char_array);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, key_type_char_array, dict->dict.instance->key_type);
+	delete dict;
+
+	ion_dictionary_config_info_t config = {
+		.id = 1, .use_type = 0, .type = key_type_numeric_signed, .key_size = sizeof(int), .value_size = sizeof(int) + 1, .dictionary_size = 7, .dictionary_type = dictionary_type_skip_list_t, .dictionary_status = err_ok
+	};
+
+	dict = new SkipList<int, int>(config);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_invalid_initial_size, dict->last_status.error);
+	delete dict;
+}
+
+/**
+@brief	This function tests that a cursor moved into another keeps its
+		position, and that the cursor it was moved from yields nothing.
+*/
+void
+test_cpp_wrapper_cursor_move(
+	planck_unit_test_t *tc
+) {
+	Dictionary<int, int> *dict = new SkipList<int, int>(0, 7);
+
+	dict->insert(1, 10);
+	dict->insert(2, 20);
+
+	/* Cursors have to be gone before their dictionary is deleted. */
+	{
+		Cursor<int, int> cursor = dict->allRecords();
+
+		PLANCK_UNIT_ASSERT_TRUE(tc, cursor.next());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, cursor.getKey());
+
+		Cursor<int, int> moved = dict->equality(2);
+
+		moved = static_cast<Cursor<int, int> &&>(cursor);
+
+		PLANCK_UNIT_ASSERT_FALSE(tc, cursor.hasNext());
+		PLANCK_UNIT_ASSERT_FALSE(tc, cursor.next());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, moved.getKey());
+		PLANCK_UNIT_ASSERT_TRUE(tc, moved.next());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, moved.getKey());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 20, moved.getValue());
+		PLANCK_UNIT_ASSERT_FALSE(tc, moved.next());
+	}
+
+	delete dict;
+}
+
+/**
+@brief	This function checks range-for iteration over cursors of a dictionary
+		holding more records than a cursor fetches at a time.
+*/
+void
+cpp_wrapper_cursor_iterate(
+	planck_unit_test_t *tc,
+	Dictionary<int, int> *dict
+) {
+	int num_records = 3 * ION_CPP_CURSOR_BATCH_SIZE + 1;
+
+	for (int i = 0; i < num_records; i++) {
+		int key = num_records - 1 - i;
+
+		dict->insert(key, key * 2);
+	}
+
+	int count	= 0;
+	int sum		= 0;
+
+	for (auto &record : dict->allRecords()) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, record.key * 2, record.value);
+		count++;
+		sum += record.key;
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, num_records, count);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, num_records * (num_records - 1) / 2, sum);
+
+	count = 0;
+
+	for (auto &record : dict->range(5, num_records - 6)) {
+		PLANCK_UNIT_ASSERT_TRUE(tc, 5 <= record.key && record.key <= num_records - 6);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, record.key * 2, record.value);
+		count++;
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, num_records - 10, count);
+
+	/* Iteration picks up wherever next() left the cursor. */
+	{
+		Cursor<int, int> cursor = dict->allRecords();
+
+		PLANCK_UNIT_ASSERT_TRUE(tc, cursor.next());
+
+		int first = cursor.getKey();
+
+		Cursor<int, int>::iterator it = cursor.begin();
+
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, first, it->key);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, first, (*it++).key);
+		PLANCK_UNIT_ASSERT_TRUE(tc, first != it->key);
+
+		count = 1;
+
+		for (; it != cursor.end(); ++it) {
+			count++;
+		}
+
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, num_records, count);
+		PLANCK_UNIT_ASSERT_FALSE(tc, cursor.hasNext());
+		PLANCK_UNIT_ASSERT_TRUE(tc, cursor.begin() == cursor.end());
+	}
+
+	for (auto &record : dict->equality(num_records)) {
+		UNUSED(record);
+		PLANCK_UNIT_ASSERT_TRUE(tc, boolean_false);
+	}
+}
+
+/**
+@brief	Aggregate test to test range-for iteration over cursors on all
+		dictionary implementations.
+*/
+void
+test_cpp_wrapper_cursor_iterate_all(
+	planck_unit_test_t *tc
+) {
+	Dictionary<int, int> *dict;
+
+	dict = new BppTree<int, int>(0);
+	cpp_wrapper_cursor_iterate(tc, dict);
+	delete dict;
+
+	dict = new SkipList<int, int>(0, 7);
+	cpp_wrapper_cursor_iterate(tc, dict);
+	delete dict;
+
+	dict = new FlatFile<int, int>(0, 30);
+	cpp_wrapper_cursor_iterate(tc, dict);
+	delete dict;
+
+	dict = new OpenAddressHash<int, int>(0, 160);
+	cpp_wrapper_cursor_iterate(tc, dict);
+	delete dict;
+
+	dict = new OpenAddressFileHash<int, int>(0, 160);
+	cpp_wrapper_cursor_iterate(tc, dict);
+	delete dict;
+}
+
 /**
 @brief		Creates the suite to test.
 @return		Pointer to a test suite.
@@ -890,6 +1057,9 @@ cpp_wrapper1_getsuite_2(
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_master_table_dictionary_create_delete_all_2);
 
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_static_delete_all_all);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_cpp_wrapper_compile_time_types);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_cpp_wrapper_cursor_move);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_cpp_wrapper_cursor_iterate_all);
 
 	return suite;
 }
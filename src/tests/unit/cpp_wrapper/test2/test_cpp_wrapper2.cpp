@@ -104,13 +104,11 @@ cpp_wrapper_equality(
 	int expected_num_records,
 	ion_boolean_t key_exists
 ) {
-	Cursor<int, int> *cursor = dict->equality(key);
+	Cursor<int, int> cursor = dict->equality(key);
 
 	if (!key_exists) {
-		PLANCK_UNIT_ASSERT_FALSE(tc, cursor->hasNext());
-		PLANCK_UNIT_ASSERT_FALSE(tc, cursor->next());
-
-		delete cursor;
+		PLANCK_UNIT_ASSERT_FALSE(tc, cursor.hasNext());
+		PLANCK_UNIT_ASSERT_FALSE(tc, cursor.next());
 
 		return;
 	}
@@ -118,32 +116,30 @@ cpp_wrapper_equality(
 	int records_found	= 0;
 	int curr_pos		= 0;
 
-	PLANCK_UNIT_ASSERT_TRUE(tc, cursor->hasNext());
+	PLANCK_UNIT_ASSERT_TRUE(tc, cursor.hasNext());
 
-	ion_cursor_status_t status = cursor->next();
+	ion_cursor_status_t status = cursor.next();
 
 	while (status) {
 		for (int i = 0; i < key; i++) {
-			if (expected_values[i] == cursor->getValue()) {
+			if (expected_values[i] == cursor.getValue()) {
 				curr_pos = i;
 				break;
 			}
 		}
 
-		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, key, cursor->getKey());
-		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_values[curr_pos], cursor->getValue());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, key, cursor.getKey());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_values[curr_pos], cursor.getValue());
 
 		expected_values[curr_pos]	= NULL_VALUE;
-		status						= cursor->next();
+		status						= cursor.next();
 		records_found++;
 	}
 
-	PLANCK_UNIT_ASSERT_FALSE(tc, cursor->hasNext());
+	PLANCK_UNIT_ASSERT_FALSE(tc, cursor.hasNext());
 
 	/* Check that same number of records are found as were inserted with desired key. */
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_num_records, records_found);
-
-	delete cursor;
 }
 
 /**
@@ -161,47 +157,43 @@ cpp_wrapper_range(
 ) {
 	PLANCK_UNIT_ASSERT_TRUE(tc, min_key < max_key);
 
-	Cursor<int, int> *cursor = dict->range(min_key, max_key);
+	Cursor<int, int> cursor = dict->range(min_key, max_key);
 
 	if (!records_exist) {
-		PLANCK_UNIT_ASSERT_FALSE(tc, cursor->hasNext());
-		PLANCK_UNIT_ASSERT_FALSE(tc, cursor->next());
-
-		delete cursor;
+		PLANCK_UNIT_ASSERT_FALSE(tc, cursor.hasNext());
+		PLANCK_UNIT_ASSERT_FALSE(tc, cursor.next());
 
 		return;
 	}
 
-	PLANCK_UNIT_ASSERT_TRUE(tc, cursor->hasNext());
+	PLANCK_UNIT_ASSERT_TRUE(tc, cursor.hasNext());
 
 	int records_found			= 0;
 	int curr_pos				= 0;
 
-	ion_cursor_status_t status	= cursor->next();
+	ion_cursor_status_t status	= cursor.next();
 
 	while (status) {
 		for (int i = 0; i < expected_num_records; i++) {
-			if (expected_records[i] == cursor->getKey()) {
+			if (expected_records[i] == cursor.getKey()) {
 				curr_pos = i;
 				break;
 			}
 		}
 
-		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_records[curr_pos], cursor->getKey());
-		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_records[curr_pos], cursor->getValue());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_records[curr_pos], cursor.getKey());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_records[curr_pos], cursor.getValue());
 
 		expected_records[curr_pos]	= NULL_VALUE;
-		status						= cursor->next();
+		status						= cursor.next();
 		min_key++;
 		records_found++;
 	}
 
-	PLANCK_UNIT_ASSERT_FALSE(tc, cursor->hasNext());
+	PLANCK_UNIT_ASSERT_FALSE(tc, cursor.hasNext());
 
 	/* Check that same number of records are found as were inserted with desired key. */
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_num_records, records_found);
-
-	delete cursor;
 }
 
 /**
@@ -215,46 +207,42 @@ cpp_wrapper_all_records(
 	int expected_num_records,
 	ion_boolean_t records_exist
 ) {
-	Cursor<int, int> *cursor = dict->allRecords();
+	Cursor<int, int> cursor = dict->allRecords();
 
 	if (!records_exist) {
-		PLANCK_UNIT_ASSERT_FALSE(tc, cursor->hasNext());
-		PLANCK_UNIT_ASSERT_FALSE(tc, cursor->next());
-
-		delete cursor;
+		PLANCK_UNIT_ASSERT_FALSE(tc, cursor.hasNext());
+		PLANCK_UNIT_ASSERT_FALSE(tc, cursor.next());
 
 		return;
 	}
 
-	PLANCK_UNIT_ASSERT_TRUE(tc, cursor->hasNext());
+	PLANCK_UNIT_ASSERT_TRUE(tc, cursor.hasNext());
 
 	int records_found			= 0;
 	int curr_pos				= 0;
 
-	ion_cursor_status_t status	= cursor->next();
+	ion_cursor_status_t status	= cursor.next();
 
 	while (status) {
 		for (int i = 0; i < expected_num_records; i++) {
-			if (expected_records[i] == cursor->getKey()) {
+			if (expected_records[i] == cursor.getKey()) {
 				curr_pos = i;
 				break;
 			}
 		}
 
-		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_records[curr_pos], cursor->getKey());
-		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_records[curr_pos], cursor->getValue());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_records[curr_pos], cursor.getKey());
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_records[curr_pos], cursor.getValue());
 
 		expected_records[curr_pos]	= NULL_VALUE;
-		status						= cursor->next();
+		status						= cursor.next();
 		records_found++;
 	}
 
-	PLANCK_UNIT_ASSERT_FALSE(tc, cursor->hasNext());
+	PLANCK_UNIT_ASSERT_FALSE(tc, cursor.hasNext());
 
 	/* Check that same number of records are found as were inserted with desired key. */
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_num_records, records_found);
-
-	delete cursor;
 }
 
 /* =================================================== TEST CASES =================================================== */
@@ -280,27 +268,27 @@ test_cpp_wrapper_setup_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_setup(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_setup(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_setup(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_setup(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_setup(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_setup(tc, dict);
 	delete dict;
 }
@@ -327,27 +315,27 @@ test_cpp_wrapper_insert_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_insert_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_insert_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_insert_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_insert_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_insert_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_insert_single(tc, dict);
 	delete dict;
 }
@@ -379,27 +367,27 @@ test_cpp_wrapper_insert_multiple_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_insert_multiple(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_insert_multiple(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_insert_multiple(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_insert_multiple(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_insert_multiple(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_insert_multiple(tc, dict);
 	delete dict;
 }
@@ -426,27 +414,27 @@ test_cpp_wrapper_get_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_get_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_get_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_get_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_get_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_get_single(tc, dict);
 	delete dict;
 }
@@ -476,27 +464,27 @@ test_cpp_wrapper_get_in_many_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_in_many(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_get_in_many(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_get_in_many(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_get_in_many(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_get_in_many(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_get_in_many(tc, dict);
 	delete dict;
 }
@@ -532,27 +520,27 @@ test_cpp_wrapper_get_lots_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_lots(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_get_lots(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_get_lots(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_get_lots(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_get_lots(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_get_lots(tc, dict);
 	delete dict;
 }
@@ -579,27 +567,27 @@ test_cpp_wrapper_get_nonexist_empty_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_get_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_get_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_get_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_get_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_get_nonexist_empty(tc, dict);
 	delete dict;
 }
@@ -626,27 +614,27 @@ test_cpp_wrapper_get_nonexist_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_get_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_get_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_get_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_get_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_get_nonexist_single(tc, dict);
 	delete dict;
 }
@@ -674,27 +662,27 @@ test_cpp_wrapper_get_nonexist_many_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_nonexist_many(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new SkipList<int, int>(0, 50);
 	test_cpp_wrapper_get_nonexist_many(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new FlatFile<int, int>(0, 50);
 	test_cpp_wrapper_get_nonexist_many(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressHash<int, int>(0, 160);
 	test_cpp_wrapper_get_nonexist_many(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressFileHash<int, int>(0, 160);
 	test_cpp_wrapper_get_nonexist_many(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_get_nonexist_many(tc, dict);
 	delete dict;
 }
@@ -724,27 +712,27 @@ test_cpp_wrapper_get_exist_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_exist_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_get_exist_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_get_exist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_get_exist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_get_exist_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_get_exist_single(tc, dict);
 	delete dict;
 }
@@ -773,27 +761,27 @@ test_cpp_wrapper_get_populated_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_populated_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_get_populated_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_get_populated_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_get_populated_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_get_populated_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_get_populated_single(tc, dict);
 	delete dict;
 }
@@ -827,27 +815,27 @@ test_cpp_wrapper_get_populated_multiple_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_populated_multiple(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_get_populated_multiple(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_get_populated_multiple(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_get_populated_multiple(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_get_populated_multiple(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_get_populated_multiple(tc, dict);
 	delete dict;
 }
@@ -888,27 +876,27 @@ test_cpp_wrapper_get_all_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_get_all(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new SkipList<int, int>(0, 50);
 	test_cpp_wrapper_get_all(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new FlatFile<int, int>(0, 50);
 	test_cpp_wrapper_get_all(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressHash<int, int>(0, 160);
 	test_cpp_wrapper_get_all(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressFileHash<int, int>(0, 160);
 	test_cpp_wrapper_get_all(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new LinearHash<int, int>(0, 160);
 	test_cpp_wrapper_get_all(tc, dict);
 	delete dict;
 }
@@ -935,27 +923,27 @@ test_cpp_wrapper_update_empty_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_update_empty_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_update_empty_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_update_empty_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_update_empty_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_update_empty_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_update_empty_single(tc, dict);
 	delete dict;
 }
@@ -985,27 +973,27 @@ test_cpp_wrapper_update_nonexist_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_update_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_update_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_update_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_update_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_update_nonexist_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_update_nonexist_single(tc, dict);
 	delete dict;
 }
@@ -1034,27 +1022,27 @@ test_cpp_wrapper_update_nonexist_in_many_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_update_nonexist_in_many(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_update_nonexist_in_many(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_update_nonexist_in_many(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_update_nonexist_in_many(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_update_nonexist_in_many(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_update_nonexist_in_many(tc, dict);
 	delete dict;
 }
@@ -1083,27 +1071,27 @@ test_cpp_wrapper_update_exist_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_update_exist_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_update_exist_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_update_exist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_update_exist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_update_exist_single(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_update_exist_single(tc, dict);
 	delete dict;
 }
@@ -1131,27 +1119,27 @@ test_cpp_wrapper_update_exist_in_many_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_update_exist_in_many(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_update_exist_in_many(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_update_exist_in_many(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_update_exist_in_many(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_update_exist_in_many(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new LinearHash<int, int>(0, 50);
 	test_cpp_wrapper_update_exist_in_many(tc, dict);
 	delete dict;
 }
@@ -1192,27 +1180,27 @@ test_cpp_wrapper_update_all_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_update_all(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new SkipList<int, int>(0, 50);
 	test_cpp_wrapper_update_all(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new FlatFile<int, int>(0, 50);
 	test_cpp_wrapper_update_all(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressHash<int, int>(0, 160);
 	test_cpp_wrapper_update_all(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new OpenAddressFileHash<int, int>(0, 160);
 	test_cpp_wrapper_update_all(tc, dict);
 	delete dict;
 
-	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 160);
+	dict = new LinearHash<int, int>(0, 160);
 	test_cpp_wrapper_update_all(tc, dict);
 	delete dict;
 }
@@ -1268,23 +1256,23 @@ test_cpp_wrapper_equality(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_equality_duplicates(tc, dict, key);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_equality_duplicates(tc, dict, key);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_equality_no_duplicates(tc, dict, key);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressHash<int, int>(0, 20);
 	test_cpp_wrapper_equality_no_duplicates(tc, dict, key);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressFileHash<int, int>(0, 20);
 	test_cpp_wrapper_equality_no_duplicates(tc, dict, key);
 	delete dict;
 }
@@ -1391,28 +1379,28 @@ test_master_table_dictionary_open_close_all_1(
 ) {
 	Dictionary<int, int> *dictionary;
 
-	dictionary = new BppTree<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dictionary = new BppTree<int, int>(1);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_open_close(tc, dictionary, 0, dictionary_type_bpp_tree_t);
 
-	dictionary = new FlatFile<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dictionary = new FlatFile<int, int>(1, 30);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_open_close(tc, dictionary, 30, dictionary_type_flat_file_t);
 
-	dictionary = new OpenAddressHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dictionary = new OpenAddressHash<int, int>(1, 50);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_open_close(tc, dictionary, 50, dictionary_type_open_address_hash_t);
 
-	dictionary = new OpenAddressFileHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dictionary = new OpenAddressFileHash<int, int>(1, 50);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_open_close(tc, dictionary, 50, dictionary_type_open_address_file_hash_t);
 
-	dictionary = new SkipList<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dictionary = new SkipList<int, int>(1, 7);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	test_master_table_dictionary_open_close(tc, dictionary, 7, dictionary_type_skip_list_t);
 
 	/* Uncomment when LinearHash dictionary open memory issue fixed. */
-/*	dictionary = new LinearHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 7); */
+/*	dictionary = new LinearHash<int, int>(1, 7); */
 /*	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status); */
 /*	test_master_table_dictionary_open_close(tc, dictionary, 7, dictionary_type_linear_hash_t); */
 }
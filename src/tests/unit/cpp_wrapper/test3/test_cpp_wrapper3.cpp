@@ -120,23 +120,23 @@ test_cpp_wrapper_equality_nonexist_empty_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_equality_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_equality_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_equality_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressHash<int, int>(0, 20);
 	test_cpp_wrapper_equality_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressFileHash<int, int>(0, 20);
 	test_cpp_wrapper_equality_nonexist_empty(tc, dict);
 	delete dict;
 }
@@ -169,23 +169,23 @@ test_cpp_wrapper_equality_nonexist_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_equality_nonexist(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_equality_nonexist(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_equality_nonexist(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressHash<int, int>(0, 20);
 	test_cpp_wrapper_equality_nonexist(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressFileHash<int, int>(0, 20);
 	test_cpp_wrapper_equality_nonexist(tc, dict);
 	delete dict;
 }
@@ -199,23 +199,23 @@ test_cpp_wrapper_range_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_range(tc, dict, 5, 6);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_range(tc, dict, 1, 2);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_range(tc, dict, 17, 18);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_range(tc, dict, 30, 31);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 15);
+	dict = new OpenAddressFileHash<int, int>(0, 15);
 	test_cpp_wrapper_range(tc, dict, 6, 7);
 	delete dict;
 }
@@ -229,23 +229,23 @@ test_cpp_wrapper_range_multiple_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_range(tc, dict, 5, 10);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_range(tc, dict, 1, 7);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_range(tc, dict, 13, 18);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_range(tc, dict, 30, 39);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new OpenAddressFileHash<int, int>(0, 30);
 	test_cpp_wrapper_range(tc, dict, 6, 23);
 	delete dict;
 }
@@ -278,23 +278,23 @@ test_cpp_wrapper_range_nonexist_empty_all(
 	/* This test has been excluded as the BppTree range query functionality */
 	/* needs to be revised. */
 
-/*	dict = new BppTree<int, int>(key_type_numeric_signed, sizeof(int), sizeof(int)); */
+/*	dict = new BppTree<int, int>(0); */
 /*	test_cpp_wrapper_range_nonexist_empty(tc, dict); */
 /*	delete dict; */
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_range_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_range_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressHash<int, int>(0, 20);
 	test_cpp_wrapper_range_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressFileHash<int, int>(0, 20);
 	test_cpp_wrapper_range_nonexist_empty(tc, dict);
 	delete dict;
 }
@@ -328,23 +328,23 @@ test_cpp_wrapper_range_nonexist_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_range_nonexist(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_range_nonexist(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_range_nonexist(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_range_nonexist(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 15);
+	dict = new OpenAddressFileHash<int, int>(0, 15);
 	test_cpp_wrapper_range_nonexist(tc, dict);
 	delete dict;
 }
@@ -378,23 +378,23 @@ test_cpp_wrapper_range_exist_single_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_range_exist_single(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_range_exist_single(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_range_exist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_range_exist_single(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 15);
+	dict = new OpenAddressFileHash<int, int>(0, 15);
 	test_cpp_wrapper_range_exist_single(tc, dict);
 	delete dict;
 }
@@ -428,23 +428,23 @@ test_cpp_wrapper_range_all_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_range_all(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_range_all(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_range_all(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	test_cpp_wrapper_range_all(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 15);
+	dict = new OpenAddressFileHash<int, int>(0, 15);
 	test_cpp_wrapper_range_all(tc, dict);
 	delete dict;
 }
@@ -459,23 +459,23 @@ test_cpp_wrapper_all_records_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_all_records(tc, dict, 10);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_all_records(tc, dict, 4);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_all_records(tc, dict, 13);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressHash<int, int>(0, 20);
 	test_cpp_wrapper_all_records(tc, dict, 5);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_all_records(tc, dict, 8);
 	delete dict;
 }
@@ -504,23 +504,23 @@ test_cpp_wrapper_all_records_nonexist_empty_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_all_records_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 10);
+	dict = new SkipList<int, int>(0, 10);
 	test_cpp_wrapper_all_records_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_all_records_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressHash<int, int>(0, 20);
 	test_cpp_wrapper_all_records_nonexist_empty(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressFileHash<int, int>(0, 20);
 	test_cpp_wrapper_all_records_nonexist_empty(tc, dict);
 	delete dict;
 }
@@ -553,23 +553,23 @@ test_cpp_wrapper_all_records_populated_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_all_records_populated(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_all_records_populated(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_all_records_populated(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressHash<int, int>(0, 20);
 	test_cpp_wrapper_all_records_populated(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_all_records_populated(tc, dict);
 	delete dict;
 }
@@ -603,23 +603,23 @@ test_cpp_wrapper_all_records_random_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	test_cpp_wrapper_all_records_random(tc, dict);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	test_cpp_wrapper_all_records_random(tc, dict);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dict = new FlatFile<int, int>(0, 30);
 	test_cpp_wrapper_all_records_random(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 20);
+	dict = new OpenAddressHash<int, int>(0, 20);
 	test_cpp_wrapper_all_records_random(tc, dict);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	test_cpp_wrapper_all_records_random(tc, dict);
 	delete dict;
 }
@@ -633,27 +633,27 @@ test_cpp_wrapper_open_close_all(
 ) {
 	Dictionary<int, int> *dict;
 
-	dict = new BppTree<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dict = new BppTree<int, int>(0);
 	cpp_wrapper_open_close(tc, dict, 66, 12);
 	delete dict;
 
-	dict = new FlatFile<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 15);
+	dict = new FlatFile<int, int>(0, 15);
 	cpp_wrapper_open_close(tc, dict, 45, 14);
 	delete dict;
 
-	dict = new OpenAddressHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressHash<int, int>(0, 50);
 	cpp_wrapper_open_close(tc, dict, 3, 15);
 	delete dict;
 
-	dict = new OpenAddressFileHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dict = new OpenAddressFileHash<int, int>(0, 50);
 	cpp_wrapper_open_close(tc, dict, 5, 12);
 	delete dict;
 
-	dict = new SkipList<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dict = new SkipList<int, int>(0, 7);
 	cpp_wrapper_open_close(tc, dict, 1, 13);
 	delete dict;
 
-/*	dict = new LinearHash<int, int>(0, key_type_numeric_signed, sizeof(int), sizeof(int), 7); */
+/*	dict = new LinearHash<int, int>(0, 7); */
 /*	cpp_wrapper_open_close(tc, dict, 2, 22); */
 /*	delete dict; */
 }
@@ -104,6 +104,21 @@ cpp_wrapper_static_open_close(
 			break;
 		}
 
+		case dictionary_type_lsm_t: {
+			dict = LsmTree<int, int>::openDictionary(config, type, type);
+			break;
+		}
+
+		case dictionary_type_concurrent_skip_list_t: {
+			dict = ConcurrentSkipList<int, int>::openDictionary(config, type, type);
+			break;
+		}
+
+		case dictionary_type_sharded_t: {
+			dict = Sharded<int, int>::openDictionary(config, type, type);
+			break;
+		}
+
 		case dictionary_type_error_t: {
 			dict					= SkipList<int, int>::openDictionary(config, type, type);
 			dict->last_status.error = err_uninitialized;
@@ -190,6 +205,21 @@ cpp_wrapper_static_open_close_complex(
 			break;
 		}
 
+		case dictionary_type_lsm_t: {
+			dict = LsmTree<int, int>::openDictionary(config, type, type);
+			break;
+		}
+
+		case dictionary_type_concurrent_skip_list_t: {
+			dict = ConcurrentSkipList<int, int>::openDictionary(config, type, type);
+			break;
+		}
+
+		case dictionary_type_sharded_t: {
+			dict = Sharded<int, int>::openDictionary(config, type, type);
+			break;
+		}
+
 		case dictionary_type_error_t: {
 			dict					= SkipList<int, int>::openDictionary(config, type, type);
 			dict->last_status.error = err_uninitialized;
@@ -247,6 +277,21 @@ cpp_wrapper_static_open_close_complex(
 			break;
 		}
 
+		case dictionary_type_lsm_t: {
+			dict = LsmTree<int, int>::openDictionary(config, type, type);
+			break;
+		}
+
+		case dictionary_type_concurrent_skip_list_t: {
+			dict = ConcurrentSkipList<int, int>::openDictionary(config, type, type);
+			break;
+		}
+
+		case dictionary_type_sharded_t: {
+			dict = Sharded<int, int>::openDictionary(config, type, type);
+			break;
+		}
+
 		case dictionary_type_error_t: {
 			dict					= SkipList<int, int>::openDictionary(config, type, type);
 			dict->last_status.error = err_uninitialized;
@@ -725,28 +770,28 @@ test_static_open_close_all(
 ) {
 	Dictionary<int, int> *dictionary;
 
-	dictionary = new BppTree<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dictionary = new BppTree<int, int>(1);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close(tc, dictionary, 66, 12);
 
-	dictionary = new FlatFile<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dictionary = new FlatFile<int, int>(1, 30);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close(tc, dictionary, 45, 14);
 
-	dictionary = new OpenAddressHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dictionary = new OpenAddressHash<int, int>(1, 50);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close(tc, dictionary, 3, 15);
 
-	dictionary = new OpenAddressFileHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dictionary = new OpenAddressFileHash<int, int>(1, 50);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close(tc, dictionary, 5, 12);
 
-	dictionary = new SkipList<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dictionary = new SkipList<int, int>(1, 7);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close(tc, dictionary, 1, 13);
 
 	/* Uncomment when LinearHash dictionary open memory issue fixed. */
-/*	dictionary = new LinearHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 7); */
+/*	dictionary = new LinearHash<int, int>(1, 7); */
 /*	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status); */
 /*	cpp_wrapper_static_open_close(tc, dictionary, 2, 22); */
 }
@@ -815,28 +860,28 @@ test_static_open_close_complex_all(
 ) {
 	Dictionary<int, int> *dictionary;
 
-	dictionary = new BppTree<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int));
+	dictionary = new BppTree<int, int>(1);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close_complex(tc, dictionary, 66, 12);
 
-	dictionary = new FlatFile<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 30);
+	dictionary = new FlatFile<int, int>(1, 30);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close_complex(tc, dictionary, 45, 14);
 
-	dictionary = new OpenAddressHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dictionary = new OpenAddressHash<int, int>(1, 50);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close_complex(tc, dictionary, 3, 15);
 
-	dictionary = new OpenAddressFileHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 50);
+	dictionary = new OpenAddressFileHash<int, int>(1, 50);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close_complex(tc, dictionary, 5, 12);
 
-	dictionary = new SkipList<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+	dictionary = new SkipList<int, int>(1, 7);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status);
 	cpp_wrapper_static_open_close_complex(tc, dictionary, 1, 13);
 
 	/* Uncomment when LinearHash dictionary open memory issue fixed. */
-/*	dictionary = new LinearHash<int, int>(1, key_type_numeric_signed, sizeof(int), sizeof(int), 7); */
+/*	dictionary = new LinearHash<int, int>(1, 7); */
 /*	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_dictionary_status_ok, dictionary->dict.status); */
 /*	cpp_wrapper_static_open_close(tc, dictionary, 2, 22); */
 }
@@ -148,17 +148,150 @@ run_bpptreehandler_generic_test_set_1(
 
 	dictionary_test_all_records(&test, 106, tc);
 
+	dictionary_test_all_records_batch(&test, 106, 1, tc);
+
+	dictionary_test_all_records_batch(&test, 106, 7, tc);
+
+	dictionary_test_all_records_batch(&test, 106, 200, tc);
+
 	dictionary_test_open_close(&test, tc);
 
 	cleanup_generic_dictionary_test(&test);
 }
 
+#if !defined(ARDUINO)
+
+/**
+@brief		Interleaves work on several B+ trees while the file pool may
+			only keep two files open, so that every tree's files are
+			repeatedly evicted and reopened underneath it.
+*/
+void
+test_bpptreehandler_file_pool(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionaries[3];
+	ion_status_t				status;
+	int							value;
+	int							i;
+	int							j;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_invalid_initial_size, ion_file_pool_configure(1, 256));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_pool_configure(2, 256));
+
+	bpptree_init(&handler);
+
+	for (j = 0; j < 3; j++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionaries[j], 70 + j, key_type_numeric_signed, sizeof(int), sizeof(int), -1));
+	}
+
+	for (i = 0; i < 300; i++) {
+		for (j = 0; j < 3; j++) {
+			status = dictionary_insert(&dictionaries[j], IONIZE(i, int), IONIZE(i * (j + 1), int));
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+		}
+	}
+
+	PLANCK_UNIT_ASSERT_TRUE(tc, ion_file_pool_num_open() <= 2);
+
+	for (i = 299; i >= 0; i--) {
+		for (j = 0; j < 3; j++) {
+			status = dictionary_get(&dictionaries[j], IONIZE(i, int), &value);
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i * (j + 1), value);
+		}
+	}
+
+	for (j = 0; j < 3; j++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionaries[j]));
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, ion_file_pool_num_open());
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_pool_configure(ION_FILE_POOL_MAX_OPEN, ION_FILE_POOL_BUFFER_SIZE));
+}
+
+#endif /* Clause ARDUINO */
+
+#if ION_USING_CONTAINER
+
+/**
+@brief		Runs a B+ tree inside a container: no per-dictionary files
+			must appear on disk, and the data must survive closing and
+			reopening the container.
+*/
+void
+test_bpptreehandler_container(
+	planck_unit_test_t *tc
+) {
+	ion_generic_test_t				test;
+	ion_dictionary_config_info_t	config;
+	ion_status_t					status;
+	char							filename[ION_MAX_FILENAME_LENGTH];
+	FILE							*raw;
+	int								value;
+	int								i;
+
+	ion_container_delete();
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_container_open());
+
+	init_generic_dictionary_test(&test, bpptree_init, key_type_numeric_signed, sizeof(int), sizeof(int), -1);
+	dictionary_test_init(&test, tc);
+
+	for (i = 0; i < 500; i++) {
+		status = dictionary_insert(&test.dictionary, IONIZE(i, int), IONIZE(i * 3, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	dictionary_get_filename(test.dictionary.instance->id, "bpt", filename);
+	PLANCK_UNIT_ASSERT_TRUE(tc, ion_fexists(filename));
+
+	raw = fopen(filename, "rb");
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == raw);
+
+	if (NULL != raw) {
+		fclose(raw);
+	}
+
+	config = (ion_dictionary_config_info_t) {
+		test.dictionary.instance->id, 0, test.key_type, test.key_size, test.value_size, test.dictionary_size
+	};
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_close(&test.dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_container_close());
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_container_open());
+
+	test.init_dict_handler(&test.handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_open(&test.handler, &test.dictionary, &config));
+
+	for (i = 0; i < 500; i++) {
+		status = dictionary_get(&test.dictionary, IONIZE(i, int), &value);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i * 3, value);
+	}
+
+	/* Deleting the dictionary frees its extents for the next one. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&test.dictionary));
+	PLANCK_UNIT_ASSERT_FALSE(tc, ion_fexists(filename));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_container_delete());
+	PLANCK_UNIT_ASSERT_FALSE(tc, ion_container_is_open());
+}
+
+#endif /* ION_USING_CONTAINER */
+
 planck_unit_suite_t *
 bpptreehandler_get_suite(
 ) {
 	planck_unit_suite_t *suite = planck_unit_new_suite();
 
 	PLANCK_UNIT_ADD_TO_SUITE(suite, run_bpptreehandler_generic_test_set_1);
+#if !defined(ARDUINO)
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_bpptreehandler_file_pool);
+#endif
+#if ION_USING_CONTAINER
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_bpptreehandler_container);
+#endif
 
 	return suite;
 }
@@ -0,0 +1,658 @@
+/******************************************************************************/
+/**
+@file		test_concurrent_skip_list.c
+@author		IonDB Project
+@brief		Unit tests for the lock-free skip list.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "test_concurrent_skip_list.h"
+
+/**
+@brief		How many keys the tests insert.
+*/
+#define CSLTEST_NUM_KEYS 100
+
+/**
+@brief		Initializes a test skip list with integer keys and values.
+*/
+void
+csltest_create(
+	planck_unit_test_t			*tc,
+	ion_concurrent_skiplist_t	*skiplist
+) {
+	skiplist->super.compare = dictionary_compare_signed_value;
+
+	ion_err_t err = csl_initialize(skiplist, key_type_numeric_signed, sizeof(int), sizeof(int), 7, 1, 4);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 7, skiplist->maxheight);
+}
+
+/**
+@brief		Inserts every key below @ref CSLTEST_NUM_KEYS out of order, each
+			with its key plus @p offset as value.
+*/
+void
+csltest_insert_all(
+	planck_unit_test_t			*tc,
+	ion_concurrent_skiplist_t	*skiplist,
+	int							offset
+) {
+	int i;
+	int key;
+
+	for (i = 0; i < CSLTEST_NUM_KEYS; i++) {
+		key = (i * 37) % CSLTEST_NUM_KEYS;
+
+		ion_status_t status = csl_insert(skiplist, &key, IONIZE(key + offset, int));
+
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+	}
+}
+
+/**
+@brief		Checks that a key is found with the expected value.
+*/
+void
+csltest_assert_get(
+	planck_unit_test_t			*tc,
+	ion_concurrent_skiplist_t	*skiplist,
+	int							key,
+	int							expected
+) {
+	int				value;
+	ion_status_t	status = csl_get(skiplist, IONIZE(key, int), &value);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected, value);
+}
+
+/**
+@brief		Checks that a key is not found.
+*/
+void
+csltest_assert_missing(
+	planck_unit_test_t			*tc,
+	ion_concurrent_skiplist_t	*skiplist,
+	int							key
+) {
+	int				value;
+	ion_status_t	status = csl_get(skiplist, IONIZE(key, int), &value);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, status.count);
+}
+
+/**
+@brief		Checks how many records are on the bottom level, and that they are
+			in key order.
+*/
+void
+csltest_assert_count(
+	planck_unit_test_t			*tc,
+	ion_concurrent_skiplist_t	*skiplist,
+	int							expected
+) {
+	int				count	= 0;
+	int				guard	= csl_pin(skiplist, boolean_false);
+	ion_csl_node_t	*node	= csl_seek(skiplist, NULL);
+	ion_csl_node_t	*prev	= NULL;
+
+	PLANCK_UNIT_ASSERT_TRUE(tc, -1 != guard);
+
+	while (NULL != node) {
+		if (NULL != prev) {
+			PLANCK_UNIT_ASSERT_TRUE(tc, *(int *) prev->key < *(int *) node->key);
+		}
+
+		count++;
+		prev	= node;
+		node	= csl_skip_deleted(csl_next(node));
+	}
+
+	csl_unpin(skiplist, guard);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected, count);
+}
+
+/**
+@brief		Tests inserting and looking up records, and that keys are unique.
+*/
+void
+test_csl_insert_get(
+	planck_unit_test_t *tc
+) {
+	ion_concurrent_skiplist_t	skiplist;
+	int							i;
+
+	csltest_create(tc, &skiplist);
+	csltest_insert_all(tc, &skiplist, 1000);
+
+	for (i = 0; i < CSLTEST_NUM_KEYS; i++) {
+		csltest_assert_get(tc, &skiplist, i, i + 1000);
+	}
+
+	csltest_assert_missing(tc, &skiplist, -1);
+	csltest_assert_missing(tc, &skiplist, CSLTEST_NUM_KEYS);
+	csltest_assert_count(tc, &skiplist, CSLTEST_NUM_KEYS);
+
+	ion_status_t status = csl_insert(&skiplist, IONIZE(5, int), IONIZE(5, int));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_duplicate_key, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, status.count);
+	csltest_assert_get(tc, &skiplist, 5, 1005);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, csl_destroy(&skiplist));
+}
+
+/**
+@brief		Tests that updates replace values and insert missing keys.
+*/
+void
+test_csl_update(
+	planck_unit_test_t *tc
+) {
+	ion_concurrent_skiplist_t	skiplist;
+	ion_status_t				status;
+
+	csltest_create(tc, &skiplist);
+	csltest_insert_all(tc, &skiplist, 0);
+
+	status = csl_update(&skiplist, IONIZE(10, int), IONIZE(-10, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+	csltest_assert_get(tc, &skiplist, 10, -10);
+	csltest_assert_get(tc, &skiplist, 11, 11);
+
+	status = csl_update(&skiplist, IONIZE(500, int), IONIZE(-500, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+	csltest_assert_get(tc, &skiplist, 500, -500);
+	csltest_assert_count(tc, &skiplist, CSLTEST_NUM_KEYS + 1);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, csl_destroy(&skiplist));
+}
+
+/**
+@brief		Tests deleting records, and inserting their keys again.
+*/
+void
+test_csl_delete(
+	planck_unit_test_t *tc
+) {
+	ion_concurrent_skiplist_t	skiplist;
+	ion_status_t				status;
+	int							i;
+
+	csltest_create(tc, &skiplist);
+
+	status = csl_delete(&skiplist, IONIZE(3, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+
+	csltest_insert_all(tc, &skiplist, 0);
+
+	status = csl_delete(&skiplist, IONIZE(3, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+	csltest_assert_missing(tc, &skiplist, 3);
+	csltest_assert_get(tc, &skiplist, 4, 4);
+
+	status = csl_delete(&skiplist, IONIZE(3, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, status.count);
+
+	status = csl_insert(&skiplist, IONIZE(3, int), IONIZE(33, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	csltest_assert_get(tc, &skiplist, 3, 33);
+
+	for (i = 0; i < CSLTEST_NUM_KEYS; i++) {
+		status = csl_delete(&skiplist, &i);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	csltest_assert_count(tc, &skiplist, 0);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, csl_destroy(&skiplist));
+}
+
+/**
+@brief		Tests that retired nodes and values are freed once no guard can
+			hold them, and not before.
+*/
+void
+test_csl_reclamation(
+	planck_unit_test_t *tc
+) {
+	ion_concurrent_skiplist_t	skiplist;
+	ion_csl_epoch_t				epoch;
+	int							guard;
+	int							i;
+
+	csltest_create(tc, &skiplist);
+	csltest_insert_all(tc, &skiplist, 0);
+
+	/* Nothing has been retired yet. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ION_CSL_IDLE + 1, skiplist.epoch);
+
+	/* A guard held from before stops the epoch two steps on. */
+	guard = csl_pin(&skiplist, boolean_false);
+	epoch = skiplist.epoch;
+
+	for (i = 0; i < CSLTEST_NUM_KEYS / 2; i++) {
+		csl_update(&skiplist, &i, IONIZE(-i, int));
+	}
+
+	PLANCK_UNIT_ASSERT_TRUE(tc, skiplist.epoch <= epoch + 1);
+	csl_unpin(&skiplist, guard);
+
+	for (i = CSLTEST_NUM_KEYS / 2; i < CSLTEST_NUM_KEYS; i++) {
+		csl_delete(&skiplist, &i);
+	}
+
+	/* With no guards held, every retirement moves the epoch on and frees
+	   the list that the new epoch retires into. */
+	PLANCK_UNIT_ASSERT_TRUE(tc, skiplist.epoch > epoch + 2);
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == skiplist.retired[skiplist.epoch % ION_CSL_EPOCHS]);
+
+	for (i = 0; i < CSLTEST_NUM_KEYS / 2; i++) {
+		csltest_assert_get(tc, &skiplist, i, -i);
+	}
+
+	csltest_assert_count(tc, &skiplist, CSLTEST_NUM_KEYS / 2);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, csl_destroy(&skiplist));
+}
+
+/**
+@brief		Creates a lock-free skip list dictionary holding every key below
+			@ref CSLTEST_NUM_KEYS.
+*/
+void
+csltest_build_dictionary(
+	planck_unit_test_t			*tc,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_t			*dictionary
+) {
+	int i;
+
+	csldict_init(handler);
+	PLANCK_UNIT_ASSERT_TRUE(tc, handler->concurrent);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(handler, dictionary, 1, key_type_numeric_signed, sizeof(int), sizeof(int), 7));
+
+	for (i = 0; i < CSLTEST_NUM_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(dictionary, &i, &i).error);
+	}
+}
+
+/**
+@brief		Tests range and equality cursors.
+*/
+void
+test_csl_cursor_predicates(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	ion_dict_cursor_t			*cursor = NULL;
+	ion_record_t				record;
+	int							key;
+	int							value;
+	int							expected;
+
+	record.key		= &key;
+	record.value	= &value;
+
+	csltest_build_dictionary(tc, &handler, &dictionary);
+
+	dictionary_build_predicate(&predicate, predicate_range, IONIZE(-5, int), IONIZE(9, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+
+	for (expected = 0; cs_cursor_active == cursor->next(cursor, &record); expected++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected, key);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected, value);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 10, expected);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_end_of_results, cursor->status);
+	/* The guard is given back as soon as the results run out. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, -1, ((ion_csldict_cursor_t *) cursor)->guard);
+	cursor->destroy(&cursor);
+
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(42, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_cursor_active, cursor->next(cursor, &record));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 42, key);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_end_of_results, cursor->next(cursor, &record));
+	cursor->destroy(&cursor);
+
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(CSLTEST_NUM_KEYS, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_end_of_results, cursor->next(cursor, &record));
+	cursor->destroy(&cursor);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests that a cursor keeps going while the records around it are
+			deleted, updated and inserted, including the one it is on.
+*/
+void
+test_csl_cursor_during_updates(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	ion_dict_cursor_t			*cursor = NULL;
+	ion_record_t				record;
+	int							key;
+	int							value;
+	int							i;
+
+	record.key		= &key;
+	record.value	= &value;
+
+	csltest_build_dictionary(tc, &handler, &dictionary);
+
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_cursor_active, cursor->next(cursor, &record));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, key);
+
+	/* Delete the record the cursor is on and the ten after it, several
+	   epochs worth, which must not free anything the cursor can reach. */
+	for (i = 1; i <= 11; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete(&dictionary, &i).error);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_update(&dictionary, IONIZE(12, int), IONIZE(-12, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(CSLTEST_NUM_KEYS, int), IONIZE(0, int)).error);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_cursor_active, cursor->next(cursor, &record));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 12, key);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, -12, value);
+
+	for (i = 13; cs_cursor_active == cursor->next(cursor, &record); i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i, key);
+	}
+
+	/* The record inserted ahead of the cursor is seen. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, CSLTEST_NUM_KEYS + 1, i);
+	cursor->destroy(&cursor);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests that cursors are refused once every guard is held.
+*/
+void
+test_csl_guards_exhausted(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	ion_dict_cursor_t			*cursor = NULL;
+	ion_concurrent_skiplist_t	*skiplist;
+	int							guards[ION_CSL_MAX_GUARDS];
+	int							i;
+
+	csltest_build_dictionary(tc, &handler, &dictionary);
+	skiplist = (ion_concurrent_skiplist_t *) dictionary.instance;
+
+	for (i = 0; i < ION_CSL_MAX_GUARDS; i++) {
+		guards[i] = csl_pin(skiplist, boolean_false);
+		PLANCK_UNIT_ASSERT_TRUE(tc, -1 != guards[i]);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, -1, csl_pin(skiplist, boolean_false));
+
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_max_capacity, dictionary_find(&dictionary, &predicate, &cursor));
+
+	csl_unpin(skiplist, guards[0]);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+	cursor->destroy(&cursor);
+
+	for (i = 1; i < ION_CSL_MAX_GUARDS; i++) {
+		csl_unpin(skiplist, guards[i]);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests that operations fail rather than wait for a guard once
+			open cursors hold every one of them.
+*/
+void
+test_csl_guards_held_by_cursors(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	ion_dict_cursor_t			*cursors[ION_CSL_MAX_GUARDS];
+	ion_dict_cursor_t			*cursor = NULL;
+	int							value;
+	int							i;
+
+	csltest_build_dictionary(tc, &handler, &dictionary);
+	dictionary_build_predicate(&predicate, predicate_all_records);
+
+	for (i = 0; i < ION_CSL_MAX_GUARDS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursors[i]));
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_max_capacity, dictionary_find(&dictionary, &predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_max_capacity, dictionary_insert(&dictionary, IONIZE(CSLTEST_NUM_KEYS, int), &value).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_max_capacity, dictionary_get(&dictionary, IONIZE(0, int), &value).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_max_capacity, dictionary_update(&dictionary, IONIZE(0, int), IONIZE(1, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_max_capacity, dictionary_delete(&dictionary, IONIZE(0, int)).error);
+
+	cursors[0]->destroy(&cursors[0]);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get(&dictionary, IONIZE(0, int), &value).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_update(&dictionary, IONIZE(0, int), IONIZE(1, int)).error);
+
+	for (i = 1; i < ION_CSL_MAX_GUARDS; i++) {
+		cursors[i]->destroy(&cursors[i]);
+	}
+
+	csltest_assert_count(tc, (ion_concurrent_skiplist_t *) dictionary.instance, CSLTEST_NUM_KEYS);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		How many threads each of the concurrency tests runs.
+*/
+#define CSLTEST_NUM_THREADS 4
+
+/**
+@brief		What each thread of the concurrency test works on.
+*/
+typedef struct {
+	/**> The dictionary shared by every thread. */
+	ion_dictionary_t	*dictionary;
+	/**> Which thread this is. */
+	int					id;
+	/**> How many checks failed in the thread. */
+	int					failures;
+} csltest_thread_t;
+
+/**
+@brief		Inserts the keys of one writer, updating and deleting some of
+			them, while running a cursor over everything written so far.
+*/
+static void *
+csltest_thread_run(
+	void *argument
+) {
+	csltest_thread_t	*thread = argument;
+	ion_predicate_t		predicate;
+	ion_dict_cursor_t	*cursor;
+	ion_record_t		record;
+	int					key;
+	int					value;
+	int					previous;
+	int					i;
+
+	record.key		= &key;
+	record.value	= &value;
+
+	for (i = CSLTEST_NUM_KEYS + thread->id; i < 20 * CSLTEST_NUM_KEYS; i += CSLTEST_NUM_THREADS) {
+		if (err_ok != dictionary_insert(thread->dictionary, &i, &i).error) {
+			thread->failures++;
+		}
+
+		if ((0 == i % 3) && (err_ok != dictionary_update(thread->dictionary, &i, IONIZE(-i, int)).error)) {
+			thread->failures++;
+		}
+
+		if ((0 == i % 5) && (err_ok != dictionary_delete(thread->dictionary, &i).error)) {
+			thread->failures++;
+		}
+
+		if (0 == i % 97) {
+			dictionary_build_predicate(&predicate, predicate_all_records);
+
+			if (err_ok != dictionary_find(thread->dictionary, &predicate, &cursor)) {
+				thread->failures++;
+				continue;
+			}
+
+			previous = -1;
+
+			while (cs_cursor_active == cursor->next(cursor, &record)) {
+				if ((key <= previous) || ((key != value) && (key != -value))) {
+					thread->failures++;
+				}
+
+				previous = key;
+			}
+
+			cursor->destroy(&cursor);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+@brief		Tests writers and cursors running on the same skip list at once.
+*/
+void
+test_csl_threads(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	csltest_thread_t			threads[CSLTEST_NUM_THREADS];
+	pthread_t					ids[CSLTEST_NUM_THREADS];
+	int							expected;
+	int							i;
+
+	csltest_build_dictionary(tc, &handler, &dictionary);
+
+	for (i = 0; i < CSLTEST_NUM_THREADS; i++) {
+		threads[i].dictionary	= &dictionary;
+		threads[i].id			= i;
+		threads[i].failures		= 0;
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, pthread_create(&ids[i], NULL, csltest_thread_run, &threads[i]));
+	}
+
+	for (i = 0; i < CSLTEST_NUM_THREADS; i++) {
+		pthread_join(ids[i], NULL);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, threads[i].failures);
+	}
+
+	for (i = 0, expected = CSLTEST_NUM_KEYS; i < 20 * CSLTEST_NUM_KEYS; i++) {
+		int				value;
+		ion_status_t	status = dictionary_get(&dictionary, &i, &value);
+
+		if ((i >= CSLTEST_NUM_KEYS) && (0 == i % 5)) {
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+			continue;
+		}
+
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ((i >= CSLTEST_NUM_KEYS) && (0 == i % 3)) ? -i : i, value);
+
+		if (i >= CSLTEST_NUM_KEYS) {
+			expected++;
+		}
+	}
+
+	csltest_assert_count(tc, (ion_concurrent_skiplist_t *) dictionary.instance, expected);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+#endif /* Clause ION_THREAD_SAFE */
+
+planck_unit_suite_t *
+concurrent_skip_list_getsuite(
+) {
+	planck_unit_suite_t *suite = planck_unit_new_suite();
+
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_csl_insert_get);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_csl_update);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_csl_delete);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_csl_reclamation);
+
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_csl_cursor_predicates);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_csl_cursor_during_updates);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_csl_guards_exhausted);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_csl_guards_held_by_cursors);
+#if ION_THREAD_SAFE
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_csl_threads);
+#endif
+
+	return suite;
+}
+
+void
+runalltests_concurrent_skip_list(
+) {
+	planck_unit_suite_t *suite = concurrent_skip_list_getsuite();
+
+	planck_unit_run_suite(suite);
+	planck_unit_destroy_suite(suite);
+}
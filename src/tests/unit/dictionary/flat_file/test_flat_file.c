@@ -140,18 +140,18 @@ ftest_insert(
 
 		ion_byte_t read_buffer[flat_file->row_size];
 
-		fseek(flat_file->data_file, flat_file->start_of_data, SEEK_SET);
+		ion_fseek(flat_file->data_file, flat_file->start_of_data, ION_FILE_START);
 
 		ion_fpos_t cur_index = 0;
 
 		while (boolean_true) {
-			if (1 != fread(read_buffer, flat_file->row_size, 1, flat_file->data_file)) {
+			if (err_ok != ion_fread(flat_file->data_file, flat_file->row_size, read_buffer)) {
 				break;
 			}
 
 			if (0 == memcmp(read_buffer, expected_result, flat_file->row_size)) {
 				ion_flat_file_row_t test_row;
-				ion_err_t			err = flat_file_read_row(flat_file, cur_index, &test_row);
+				ion_err_t			err = flat_file_read_row(flat_file, &flat_file->reader, cur_index, &test_row);
 
 				PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
 				PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ION_FLAT_FILE_STATUS_OCCUPIED, test_row.row_status);
@@ -188,7 +188,7 @@ ftest_delete(
 	if (check_result) {
 		ion_fpos_t			loc = -1;
 		ion_flat_file_row_t row;
-		ion_err_t			err = flat_file_scan(flat_file, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key);
+		ion_err_t			err = flat_file_scan(flat_file, &flat_file->reader, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key);
 
 		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_file_hit_eof, err);
 	}
@@ -215,7 +215,7 @@ ftest_get(
 
 		ion_fpos_t			loc = -1;
 		ion_flat_file_row_t row;
-		ion_err_t			err = flat_file_scan(flat_file, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key);
+		ion_err_t			err = flat_file_scan(flat_file, &flat_file->reader, -1, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key);
 
 		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
 	}
@@ -243,7 +243,7 @@ ftest_update(
 		ion_flat_file_row_t row;
 		ion_err_t			err;
 
-		while (err_ok == (err = flat_file_scan(flat_file, loc, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key))) {
+		while (err_ok == (err = flat_file_scan(flat_file, &flat_file->reader, loc, &loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_key_match, key))) {
 			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, memcmp(row.value, value, flat_file->super.record.value_size));
 			loc++;
 		}
@@ -267,7 +267,7 @@ ftest_file_scan(
 ) {
 	ion_fpos_t			found_loc	= -1;
 	ion_flat_file_row_t row;
-	ion_err_t			err			= flat_file_scan(flat_file, start_location, &found_loc, &row, scan_direction, flat_file_predicate_key_match, target_key);
+	ion_err_t			err			= flat_file_scan(flat_file, &flat_file->reader, start_location, &found_loc, &row, scan_direction, flat_file_predicate_key_match, target_key);
 
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_status, err);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_location, found_loc);
@@ -340,7 +340,7 @@ ftest_file_binary_search(
 	ion_fpos_t			expected_location
 ) {
 	ion_fpos_t	found_loc	= -1;
-	ion_err_t	err			= flat_file_binary_search(flat_file, target_key, &found_loc);
+	ion_err_t	err			= flat_file_binary_search(flat_file, &flat_file->reader, target_key, &found_loc);
 
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_status, err);
 	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_location, found_loc);
@@ -775,6 +775,424 @@ test_flat_file_sort_update_many_exist_duplicates(
 	ftest_takedown(tc, &flat_file);
 }
 
+/**
+@brief		Scans the flat file for keys within the given bounds and asserts the result.
+*/
+void
+ftest_file_range_scan(
+	planck_unit_test_t	*tc,
+	ion_flat_file_t		*flat_file,
+	ion_fpos_t			start_location,
+	ion_key_t			lower_bound,
+	ion_key_t			upper_bound,
+	ion_err_t			expected_status,
+	ion_fpos_t			expected_location
+) {
+	ion_fpos_t			found_loc	= -1;
+	ion_flat_file_row_t row;
+	ion_err_t			err			= flat_file_scan(flat_file, &flat_file->reader, start_location, &found_loc, &row, ION_FLAT_FILE_SCAN_FORWARDS, flat_file_predicate_within_bounds, lower_bound, upper_bound);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_status, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_location, found_loc);
+}
+
+/**
+@brief		Inserts four blocks of four rows each, where every block covers a distinct key range.
+*/
+void
+ftest_zone_map_populate(
+	planck_unit_test_t	*tc,
+	ion_flat_file_t		*flat_file
+) {
+	int block_starts[]	= { 1, 100, 10, 200 };
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		int key = block_starts[i / 4] + i % 4;
+
+		ftest_insert(tc, flat_file, IONIZE(key, int), IONIZE(i, int), err_ok, 1, boolean_false);
+	}
+}
+
+/**
+@brief		Checks whether the persisted zone map file of the flat file with the given ID exists.
+*/
+ion_boolean_t
+ftest_zone_map_file_exists(
+	ion_dictionary_id_t id
+) {
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(id, ION_FLAT_FILE_ZONE_MAP_EXTENSION, filename);
+
+	FILE *file = fopen(filename, "rb");
+
+	if (NULL == file) {
+		return boolean_false;
+	}
+
+	fclose(file);
+	return boolean_true;
+}
+
+/**
+@brief		Tests that scans which skip blocks using the zone map find the same rows as a full scan,
+			including after the zone map is changed by deletes and inserts.
+*/
+void
+test_flat_file_zone_map_scan(
+	planck_unit_test_t *tc
+) {
+	ion_flat_file_t flat_file;
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 4);
+	ftest_zone_map_populate(tc, &flat_file);
+
+	ftest_file_scan(tc, &flat_file, ION_FLAT_FILE_SCAN_FORWARDS, -1, IONIZE(11, int), err_ok, 9);
+	PLANCK_UNIT_ASSERT_TRUE(tc, flat_file.zone_map_valid);
+	ftest_file_scan(tc, &flat_file, ION_FLAT_FILE_SCAN_FORWARDS, -1, IONIZE(50, int), err_file_hit_eof, 16);
+	/* Start in the middle of a block */
+	ftest_file_scan(tc, &flat_file, ION_FLAT_FILE_SCAN_FORWARDS, 9, IONIZE(12, int), err_ok, 10);
+	ftest_file_scan(tc, &flat_file, ION_FLAT_FILE_SCAN_FORWARDS, 11, IONIZE(12, int), err_file_hit_eof, 16);
+
+	ftest_file_range_scan(tc, &flat_file, -1, IONIZE(101, int), IONIZE(150, int), err_ok, 5);
+	ftest_file_range_scan(tc, &flat_file, 8, IONIZE(101, int), IONIZE(150, int), err_file_hit_eof, 16);
+	ftest_file_range_scan(tc, &flat_file, -1, IONIZE(14, int), IONIZE(99, int), err_file_hit_eof, 16);
+
+	/* The last row (203) is swapped into the hole left in the first block */
+	ftest_delete(tc, &flat_file, IONIZE(2, int), err_ok, 1, boolean_true);
+	ftest_file_scan(tc, &flat_file, ION_FLAT_FILE_SCAN_FORWARDS, -1, IONIZE(203, int), err_ok, 1);
+	ftest_file_range_scan(tc, &flat_file, -1, IONIZE(150, int), IONIZE(250, int), err_ok, 1);
+
+	/* This lands at the end of the last block, which must be widened */
+	ftest_insert(tc, &flat_file, IONIZE(-7, int), IONIZE(0, int), err_ok, 1, boolean_true);
+	ftest_file_scan(tc, &flat_file, ION_FLAT_FILE_SCAN_FORWARDS, -1, IONIZE(-7, int), err_ok, 15);
+	ftest_get(tc, &flat_file, IONIZE(-7, int), err_ok, IONIZE(0, int));
+
+	/* Updates leave the key alone, so the zone map must keep finding the row */
+	ftest_update(tc, &flat_file, IONIZE(12, int), IONIZE(99, int), err_ok, 1);
+	ftest_get(tc, &flat_file, IONIZE(12, int), err_ok, IONIZE(99, int));
+
+	ftest_takedown(tc, &flat_file);
+	PLANCK_UNIT_ASSERT_FALSE(tc, ftest_zone_map_file_exists(0));
+}
+
+/**
+@brief		Tests that the zone map is persisted on close and reused on the next open,
+			and is rebuilt if the block size no longer matches.
+*/
+void
+test_flat_file_zone_map_reopen(
+	planck_unit_test_t *tc
+) {
+	ion_flat_file_t flat_file;
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 4);
+	ftest_zone_map_populate(tc, &flat_file);
+	ftest_file_scan(tc, &flat_file, ION_FLAT_FILE_SCAN_FORWARDS, -1, IONIZE(13, int), err_ok, 11);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_close(&flat_file));
+	PLANCK_UNIT_ASSERT_TRUE(tc, ftest_zone_map_file_exists(0));
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 4);
+	PLANCK_UNIT_ASSERT_TRUE(tc, flat_file.zone_map_valid);
+	/* Consumed on open, so that a crash cannot leave a stale zone map behind */
+	PLANCK_UNIT_ASSERT_FALSE(tc, ftest_zone_map_file_exists(0));
+	ftest_file_scan(tc, &flat_file, ION_FLAT_FILE_SCAN_FORWARDS, -1, IONIZE(13, int), err_ok, 11);
+	ftest_file_range_scan(tc, &flat_file, -1, IONIZE(200, int), IONIZE(201, int), err_ok, 12);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_close(&flat_file));
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 3);
+	PLANCK_UNIT_ASSERT_FALSE(tc, flat_file.zone_map_valid);
+	ftest_file_scan(tc, &flat_file, ION_FLAT_FILE_SCAN_FORWARDS, -1, IONIZE(103, int), err_ok, 7);
+	PLANCK_UNIT_ASSERT_TRUE(tc, flat_file.zone_map_valid);
+	ftest_file_range_scan(tc, &flat_file, -1, IONIZE(10, int), IONIZE(10, int), err_ok, 8);
+
+	ftest_takedown(tc, &flat_file);
+}
+
+/**
+@brief		Tests binary search cases where duplicates and search targets span several fence blocks.
+*/
+void
+ftest_fence_search_cases(
+	planck_unit_test_t	*tc,
+	ion_flat_file_t		*flat_file
+) {
+	int keys[] = { 2, 9, 9, 9, 9, 13, 24, 36, 99 };
+	int i;
+
+	for (i = 0; i < (int) (sizeof(keys) / sizeof(int)); i++) {
+		ftest_insert(tc, flat_file, IONIZE(keys[i], int), IONIZE(i, int), err_ok, 1, boolean_false);
+	}
+
+	/* Duplicates spread over three blocks - should return the first in block */
+	ftest_file_binary_search(tc, flat_file, IONIZE(9, int), err_ok, 1);
+	ftest_file_binary_search(tc, flat_file, IONIZE(13, int), err_ok, 5);
+	ftest_file_binary_search(tc, flat_file, IONIZE(2, int), err_ok, 0);
+	ftest_file_binary_search(tc, flat_file, IONIZE(99, int), err_ok, 8);
+	ftest_file_binary_search(tc, flat_file, IONIZE(24, int), err_ok, 6);
+	/* Missing keys return the first less than */
+	ftest_file_binary_search(tc, flat_file, IONIZE(12, int), err_ok, 4);
+	ftest_file_binary_search(tc, flat_file, IONIZE(5, int), err_ok, 0);
+	ftest_file_binary_search(tc, flat_file, IONIZE(30, int), err_ok, 6);
+	ftest_file_binary_search(tc, flat_file, IONIZE(130, int), err_ok, 8);
+	ftest_file_binary_search(tc, flat_file, IONIZE(-5, int), err_item_not_found, -1);
+
+	ftest_get(tc, flat_file, IONIZE(36, int), err_ok, IONIZE(7, int));
+	ftest_get(tc, flat_file, IONIZE(37, int), err_item_not_found, NULL);
+}
+
+/**
+@brief		Tests the fence index search in sorted mode with blocks smaller than the data set.
+*/
+void
+test_flat_file_sort_fence_search(
+	planck_unit_test_t *tc
+) {
+	ion_flat_file_t flat_file;
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 2);
+	flat_file.sorted_mode = boolean_true;
+
+	ftest_fence_search_cases(tc, &flat_file);
+
+	ftest_takedown(tc, &flat_file);
+}
+
+/**
+@brief		Tests the fence index search in sorted mode when probing by interpolation.
+*/
+void
+test_flat_file_sort_fence_search_interpolation(
+	planck_unit_test_t *tc
+) {
+	ion_flat_file_t flat_file;
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 2);
+	flat_file.sorted_mode			= boolean_true;
+	flat_file.interpolation_search	= boolean_true;
+
+	ftest_fence_search_cases(tc, &flat_file);
+
+	ftest_takedown(tc, &flat_file);
+}
+
+/**
+@brief		Tests interpolation search over many uniformly distributed keys.
+*/
+void
+test_flat_file_sort_fence_search_interpolation_uniform(
+	planck_unit_test_t *tc
+) {
+	ion_flat_file_t flat_file;
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 8);
+	flat_file.sorted_mode			= boolean_true;
+	flat_file.interpolation_search	= boolean_true;
+
+	int i;
+
+	for (i = 0; i < 500; i++) {
+		ftest_insert(tc, &flat_file, IONIZE(i * 3, int), IONIZE(i, int), err_ok, 1, boolean_false);
+	}
+
+	for (i = 0; i < 500; i++) {
+		ftest_file_binary_search(tc, &flat_file, IONIZE(i * 3, int), err_ok, i);
+		ftest_file_binary_search(tc, &flat_file, IONIZE(i * 3 + 1, int), err_ok, i);
+	}
+
+	ftest_file_binary_search(tc, &flat_file, IONIZE(-1, int), err_item_not_found, -1);
+
+	ftest_takedown(tc, &flat_file);
+}
+
+/**
+@brief		Checks whether the file with the given extension exists for the flat file with the given ID.
+*/
+ion_boolean_t
+ftest_flat_file_file_exists(
+	ion_dictionary_id_t id,
+	char				*extension
+) {
+	char filename[ION_MAX_FILENAME_LENGTH];
+
+	dictionary_get_filename(id, extension, filename);
+
+	FILE *file = fopen(filename, "rb");
+
+	if (NULL == file) {
+		return boolean_false;
+	}
+
+	fclose(file);
+	return boolean_true;
+}
+
+/**
+@brief		Inserts @p num_records keys out of order (with duplicates), sorts the flat file and
+			checks that every row survived and that the rows are now in order.
+*/
+void
+ftest_sort(
+	planck_unit_test_t	*tc,
+	ion_flat_file_t		*flat_file,
+	int					num_records
+) {
+	int i;
+
+	for (i = 0; i < num_records; i++) {
+		ftest_insert(tc, flat_file, IONIZE((i * 37) % 50, int), IONIZE(i, int), err_ok, 1, boolean_false);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_sort(flat_file));
+	PLANCK_UNIT_ASSERT_TRUE(tc, flat_file->sorted_mode);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, num_records, (flat_file->eof_position - flat_file->start_of_data) / flat_file->row_size);
+
+	/* Temporary run and output files must be cleaned up */
+	PLANCK_UNIT_ASSERT_FALSE(tc, ftest_flat_file_file_exists(flat_file->super.id, "ffa"));
+	PLANCK_UNIT_ASSERT_FALSE(tc, ftest_flat_file_file_exists(flat_file->super.id, "ffb"));
+	PLANCK_UNIT_ASSERT_FALSE(tc, ftest_flat_file_file_exists(flat_file->super.id, "fft"));
+
+	int value_sum	= 0;
+	int last_key	= -1;
+
+	for (i = 0; i < num_records; i++) {
+		ion_flat_file_row_t row;
+
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_read_row(flat_file, &flat_file->reader, i, &row));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ION_FLAT_FILE_STATUS_OCCUPIED, row.row_status);
+		PLANCK_UNIT_ASSERT_TRUE(tc, NEUTRALIZE(row.key, int) >= last_key);
+		/* Every value must still be paired with the key it was inserted with */
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, (NEUTRALIZE(row.value, int) * 37) % 50, NEUTRALIZE(row.key, int));
+
+		last_key	= NEUTRALIZE(row.key, int);
+		value_sum	+= NEUTRALIZE(row.value, int);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, num_records * (num_records - 1) / 2, value_sum);
+}
+
+/**
+@brief		Tests sorting a flat file that needs several merge passes.
+*/
+void
+test_flat_file_sort_external(
+	planck_unit_test_t *tc
+) {
+	ion_flat_file_t flat_file;
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 3);
+
+	ftest_sort(tc, &flat_file, 200);
+
+	ftest_file_binary_search(tc, &flat_file, IONIZE(0, int), err_ok, 0);
+	ftest_file_binary_search(tc, &flat_file, IONIZE(-1, int), err_item_not_found, -1);
+	ftest_file_binary_search(tc, &flat_file, IONIZE(60, int), err_ok, 199);
+	ftest_get(tc, &flat_file, IONIZE(37, int), err_ok, IONIZE(1, int));
+
+	/* Sorting again is a no-op */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_sort(&flat_file));
+
+	ftest_takedown(tc, &flat_file);
+}
+
+/**
+@brief		Tests sorting flat files that are empty or fit in a single run.
+*/
+void
+test_flat_file_sort_small(
+	planck_unit_test_t *tc
+) {
+	ion_flat_file_t flat_file;
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 15);
+	ftest_sort(tc, &flat_file, 0);
+	ftest_takedown(tc, &flat_file);
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 15);
+	ftest_sort(tc, &flat_file, 15);
+	ftest_takedown(tc, &flat_file);
+}
+
+/**
+@brief		Tests that a sorted flat file stays in sorted mode when it is opened again.
+*/
+void
+test_flat_file_sort_reopen(
+	planck_unit_test_t *tc
+) {
+	ion_flat_file_t flat_file;
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 4);
+	ftest_sort(tc, &flat_file, 30);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_close(&flat_file));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_initialize(&flat_file, 0, key_type_numeric_signed, sizeof(int), sizeof(int), 4));
+	flat_file.super.compare = dictionary_compare_signed_value;
+	PLANCK_UNIT_ASSERT_TRUE(tc, flat_file.sorted_mode);
+
+	ftest_get(tc, &flat_file, IONIZE(24, int), err_ok, IONIZE(2, int));
+	ftest_insert(tc, &flat_file, IONIZE(49, int), IONIZE(0, int), err_ok, 1, boolean_true);
+	PLANCK_UNIT_ASSERT_TRUE(tc, flat_file.sorted_mode);
+
+	ftest_takedown(tc, &flat_file);
+}
+
+/**
+@brief		Tests that a sorted flat file leaves sorted mode on an insert out of order or a
+			delete, and that it can then be sorted again.
+*/
+void
+test_flat_file_sort_again(
+	planck_unit_test_t *tc
+) {
+	ion_flat_file_t flat_file;
+	int				last_key = -1;
+	int				i;
+
+	ftest_create(tc, &flat_file, key_type_numeric_signed, sizeof(int), sizeof(int), 4);
+	ftest_sort(tc, &flat_file, 30);
+
+	/* Deleting a key that is not there leaves nothing out of order. */
+	ftest_delete(tc, &flat_file, IONIZE(100, int), err_item_not_found, 0, boolean_false);
+	PLANCK_UNIT_ASSERT_TRUE(tc, flat_file.sorted_mode);
+
+	ftest_insert(tc, &flat_file, IONIZE(4, int), IONIZE(-4, int), err_ok, 1, boolean_true);
+	PLANCK_UNIT_ASSERT_FALSE(tc, flat_file.sorted_mode);
+
+	/* The data file must be opened unsorted from now on. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_close(&flat_file));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_initialize(&flat_file, 0, key_type_numeric_signed, sizeof(int), sizeof(int), 4));
+	flat_file.super.compare = dictionary_compare_signed_value;
+	PLANCK_UNIT_ASSERT_FALSE(tc, flat_file.sorted_mode);
+
+	ftest_insert(tc, &flat_file, IONIZE(2, int), IONIZE(-2, int), err_ok, 1, boolean_true);
+	ftest_delete(tc, &flat_file, IONIZE(24, int), err_ok, 1, boolean_true);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_sort(&flat_file));
+	PLANCK_UNIT_ASSERT_TRUE(tc, flat_file.sorted_mode);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 31, (flat_file.eof_position - flat_file.start_of_data) / flat_file.row_size);
+
+	for (i = 0; i < 31; i++) {
+		ion_flat_file_row_t row;
+
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, flat_file_read_row(&flat_file, &flat_file.reader, i, &row));
+		PLANCK_UNIT_ASSERT_TRUE(tc, NEUTRALIZE(row.key, int) >= last_key);
+		last_key = NEUTRALIZE(row.key, int);
+	}
+
+	ftest_get(tc, &flat_file, IONIZE(2, int), err_ok, IONIZE(-2, int));
+	ftest_get(tc, &flat_file, IONIZE(4, int), err_ok, IONIZE(-4, int));
+	ftest_get(tc, &flat_file, IONIZE(24, int), err_item_not_found, IONIZE(0, int));
+
+	ftest_delete(tc, &flat_file, IONIZE(4, int), err_ok, 1, boolean_true);
+	PLANCK_UNIT_ASSERT_FALSE(tc, flat_file.sorted_mode);
+
+	ftest_takedown(tc, &flat_file);
+}
+
 planck_unit_suite_t *
 flat_file_getsuite(
 ) {
@@ -786,10 +1204,19 @@ flat_file_getsuite(
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_scan_cases_small_buf);
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_scan_cases_large_buf);
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_delete_edge_case);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_zone_map_scan);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_zone_map_reopen);
 
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_insert_bad_sort);
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_insert_good_sort);
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_binary_search_cases);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_fence_search);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_fence_search_interpolation);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_fence_search_interpolation_uniform);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_external);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_small);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_reopen);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_again);
 
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_get_empty);
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_sort_get_single_nonexist);
@@ -36,11 +36,116 @@
 
 #include "test_flat_file_dictionary_handler.h"
 
+/**
+@brief		Runs a cursor query through the batched interface, and checks that every record
+			fetched satisfies the query and that the expected number of records is produced.
+@param[in]	tc
+				Test case.
+@param[in]	dictionary
+				Dictionary to query.
+@param[in]	predicate
+				Predicate to query with.
+@param[in]	batch_size
+				How many records to ask for per call.
+@param[in]	expected_count
+				How many records the query should produce in total.
+*/
+void
+test_flat_file_handler_cursor_batch(
+	planck_unit_test_t	*tc,
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	int					batch_size,
+	int					expected_count
+) {
+	ion_dict_cursor_t	*cursor = NULL;
+	ion_record_t		records[batch_size];
+	int					keys[batch_size];
+	int					values[batch_size];
+	ion_result_count_t	num_records;
+	ion_cursor_status_t cursor_status;
+	int					count = 0;
+	int					i;
+
+	for (i = 0; i < batch_size; i++) {
+		records[i].key		= &keys[i];
+		records[i].value	= &values[i];
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(dictionary, predicate, &cursor));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL != cursor->next_batch);
+
+	while (cs_cursor_active == (cursor_status = dictionary_cursor_next_batch(cursor, records, batch_size, &num_records))) {
+		PLANCK_UNIT_ASSERT_TRUE(tc, 0 < num_records && batch_size >= num_records);
+
+		for (i = 0; i < num_records; i++) {
+			PLANCK_UNIT_ASSERT_TRUE(tc, test_predicate(cursor, &keys[i]));
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, keys[i] * 2, values[i]);
+		}
+
+		count += num_records;
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_end_of_results, cursor_status);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, num_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_count, count);
+
+	cursor->destroy(&cursor);
+}
+
+/**
+@brief		Tests that batched cursors over a flat file produce the same results as
+			single record cursors, across several buffer boundaries.
+@param[in]	tc
+				Test case.
+*/
+void
+test_flat_file_handler_next_batch(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	int							i;
+	int							value;
+
+	ffdict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 1, key_type_numeric_signed, sizeof(int), sizeof(int), 4));
+
+	for (i = 0; i < 50; i++) {
+		value = i * 2;
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, &i, &value).error);
+	}
+
+	for (i = 0; i < 3; i++) {
+		value = 7 * 2;
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(7, int), &value).error);
+	}
+
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	test_flat_file_handler_cursor_batch(tc, &dictionary, &predicate, 1, 53);
+	test_flat_file_handler_cursor_batch(tc, &dictionary, &predicate, 3, 53);
+	test_flat_file_handler_cursor_batch(tc, &dictionary, &predicate, 64, 53);
+
+	dictionary_build_predicate(&predicate, predicate_range, IONIZE(10, int), IONIZE(29, int));
+	test_flat_file_handler_cursor_batch(tc, &dictionary, &predicate, 6, 20);
+
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(7, int));
+	test_flat_file_handler_cursor_batch(tc, &dictionary, &predicate, 3, 4);
+
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(100, int));
+	test_flat_file_handler_cursor_batch(tc, &dictionary, &predicate, 3, 0);
+
+	dictionary_delete_dictionary(&dictionary);
+}
+
 planck_unit_suite_t *
 flat_file_handler_getsuite(
 ) {
 	planck_unit_suite_t *suite = planck_unit_new_suite();
 
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_flat_file_handler_next_batch);
+
 	return suite;
 }
 
@@ -45,6 +45,7 @@ extern "C" {
 #include <string.h>
 #include "../../../planck-unit/src/planck_unit.h"
 #include "../../../../dictionary/flat_file/flat_file_dictionary_handler.h"
+#include "../../../../dictionary/dictionary.h"
 
 void
 runalltests_flat_file_handler(
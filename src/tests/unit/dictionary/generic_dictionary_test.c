@@ -372,6 +372,59 @@ dictionary_test_all_records(
 	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == cursor);
 }
 
+void
+dictionary_test_all_records_batch(
+	ion_generic_test_t	*test,
+	int					expected_count,
+	int					batch_size,
+	planck_unit_test_t	*tc
+) {
+	ion_err_t error;
+
+	ion_dict_cursor_t	*cursor = NULL;
+	ion_predicate_t		predicate;
+
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	error = dictionary_find(&test->dictionary, &predicate, &cursor);
+
+	PLANCK_UNIT_ASSERT_TRUE(tc, err_ok == error);
+	PLANCK_UNIT_ASSERT_TRUE(tc, cs_cursor_initialized == cursor->status);
+
+	ion_record_t		records[batch_size];
+	ion_result_count_t	num_records;
+	ion_cursor_status_t cursor_status;
+	int					i;
+
+	for (i = 0; i < batch_size; i++) {
+		records[i].key		= malloc(test->key_size);
+		records[i].value	= malloc(test->value_size);
+	}
+
+	int count = 0;
+
+	while (cs_cursor_active == (cursor_status = dictionary_cursor_next_batch(cursor, records, batch_size, &num_records))) {
+		PLANCK_UNIT_ASSERT_TRUE(tc, 0 < num_records);
+		PLANCK_UNIT_ASSERT_TRUE(tc, batch_size >= num_records);
+
+		count += num_records;
+	}
+
+	PLANCK_UNIT_ASSERT_TRUE(tc, cs_end_of_results == cursor_status);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 == num_records);
+
+	if (expected_count >= 0) {
+		PLANCK_UNIT_ASSERT_TRUE(tc, expected_count == count);
+	}
+
+	for (i = 0; i < batch_size; i++) {
+		free(records[i].key);
+		free(records[i].value);
+	}
+
+	cursor->destroy(&cursor);
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == cursor);
+}
+
 void
 dictionary_test_open_close(
 	ion_generic_test_t	*test,
@@ -150,6 +150,14 @@ dictionary_test_all_records(
 	planck_unit_test_t	*tc
 );
 
+void
+dictionary_test_all_records_batch(
+	ion_generic_test_t	*test,
+	int					expected_count,
+	int					batch_size,
+	planck_unit_test_t	*tc
+);
+
 void
 dictionary_test_open_close(
 	ion_generic_test_t	*test,
@@ -258,7 +258,7 @@ test_linear_hash_bucket_map_head_updates(
 	ion_fpos_t total_record_size = linear_hash->super.record.key_size + linear_hash->super.record.value_size + sizeof(ion_byte_t);
 
 	/* test that the new head of 0 index bucket is at the correct location */
-	expected_bucket_head = fseek(linear_hash->database, -4 * total_record_size - sizeof(linear_hash_bucket_t), SEEK_END);
+	expected_bucket_head = ion_fseek(linear_hash->database, -4 * total_record_size - sizeof(linear_hash_bucket_t), ION_FILE_END);
 	PLANCK_UNIT_ASSERT_TRUE(tc, expected_bucket_head != array_list_get(0, linear_hash->bucket_map));
 
 	test_linear_hash_takedown(tc, linear_hash);
@@ -0,0 +1,738 @@
+/******************************************************************************/
+/**
+@file		test_lsm.c
+@author		IonDB Project
+@brief		Unit tests for the LSM tree.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "test_lsm.h"
+
+/**
+@brief		Initializes a test LSM tree with integer keys and values.
+*/
+void
+ltest_create(
+	planck_unit_test_t		*tc,
+	ion_lsm_t				*lsm,
+	ion_dictionary_size_t	memtable_limit
+) {
+	lsm->super.compare = dictionary_compare_signed_value;
+
+	ion_err_t err = lsm_initialize(lsm, 0, key_type_numeric_signed, sizeof(int), sizeof(int), memtable_limit);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, memtable_limit, lsm->memtable_limit);
+}
+
+/**
+@brief		Closes a test LSM tree and removes its files.
+*/
+void
+ltest_takedown(
+	planck_unit_test_t	*tc,
+	ion_lsm_t			*lsm
+) {
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_destroy(lsm));
+}
+
+/**
+@brief		Inserts the keys from @p from up to but excluding @p to, each with
+			its key plus @p offset as value.
+*/
+void
+ltest_insert_range(
+	planck_unit_test_t	*tc,
+	ion_lsm_t			*lsm,
+	int					from,
+	int					to,
+	int					offset
+) {
+	int i;
+
+	for (i = from; i < to; i++) {
+		ion_status_t status = lsm_insert(lsm, IONIZE(i, int), IONIZE(i + offset, int));
+
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+	}
+}
+
+/**
+@brief		Checks that a key is found with the expected value.
+*/
+void
+ltest_assert_get(
+	planck_unit_test_t	*tc,
+	ion_lsm_t			*lsm,
+	int					key,
+	int					expected
+) {
+	int				value;
+	ion_status_t	status = lsm_get(lsm, IONIZE(key, int), &value);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected, value);
+}
+
+/**
+@brief		Checks that a key is not found.
+*/
+void
+ltest_assert_missing(
+	planck_unit_test_t	*tc,
+	ion_lsm_t			*lsm,
+	int					key
+) {
+	int				value;
+	ion_status_t	status = lsm_get(lsm, IONIZE(key, int), &value);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, status.count);
+}
+
+/**
+@brief		Counts the rows held by the runs of a level.
+*/
+ion_fpos_t
+ltest_level_rows(
+	ion_lsm_t	*lsm,
+	int			level
+) {
+	ion_fpos_t	num_rows = 0;
+	int			i;
+
+	for (i = 0; i < lsm->num_runs[level]; i++) {
+		num_rows += lsm_run_num_rows(lsm->runs[level][i]);
+	}
+
+	return num_rows;
+}
+
+/**
+@brief		Tests that an LSM tree starts empty and leaves no files behind.
+*/
+void
+test_lsm_create_destroy(
+	planck_unit_test_t *tc
+) {
+	ion_lsm_t	lsm;
+	char		filename[ION_MAX_FILENAME_LENGTH];
+	int			level;
+
+	ltest_create(tc, &lsm, 4);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.memtable_count);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ION_LSM_DEFAULT_COMPACTION, lsm.compaction);
+
+	for (level = 0; level < ION_LSM_MAX_LEVELS; level++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.num_runs[level]);
+	}
+
+	dictionary_get_filename(0, ION_LSM_MANIFEST_EXTENSION, filename);
+	PLANCK_UNIT_ASSERT_TRUE(tc, ion_fexists(filename));
+
+	ltest_takedown(tc, &lsm);
+	PLANCK_UNIT_ASSERT_FALSE(tc, ion_fexists(filename));
+}
+
+/**
+@brief		Tests that a full memtable is written out as a sorted run.
+*/
+void
+test_lsm_flush(
+	planck_unit_test_t *tc
+) {
+	ion_lsm_t lsm;
+
+	ltest_create(tc, &lsm, 4);
+
+	ltest_insert_range(tc, &lsm, 0, 3, 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 3, lsm.memtable_count);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.num_runs[0]);
+
+	/* Writing a key that is already in memory does not count towards the limit. */
+	ltest_insert_range(tc, &lsm, 0, 3, 10);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 3, lsm.memtable_count);
+
+	/* In thread-safe builds the full memtable is written out by the compaction worker. */
+	ltest_insert_range(tc, &lsm, 3, 4, 10);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.memtable_count);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm.num_runs[0]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 4, lsm_run_num_rows(lsm.runs[0][0]));
+	PLANCK_UNIT_ASSERT_TRUE(tc, lsm.runs[0][0]->flat_file.sorted_mode);
+
+	ltest_assert_get(tc, &lsm, 0, 10);
+	ltest_assert_get(tc, &lsm, 3, 13);
+	ltest_assert_missing(tc, &lsm, 4);
+
+	/* Flushing an empty memtable does nothing. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_flush(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm.num_runs[0]);
+
+	ltest_takedown(tc, &lsm);
+}
+
+/**
+@brief		Tests that newer values shadow the ones in older runs.
+*/
+void
+test_lsm_update_shadows_older_run(
+	planck_unit_test_t *tc
+) {
+	ion_lsm_t lsm;
+
+	ltest_create(tc, &lsm, 4);
+
+	ltest_insert_range(tc, &lsm, 0, 4, 0);
+	ltest_insert_range(tc, &lsm, 1, 2, 100);
+	ltest_assert_get(tc, &lsm, 1, 101);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_flush(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, lsm.num_runs[0]);
+	ltest_assert_get(tc, &lsm, 1, 101);
+	ltest_assert_get(tc, &lsm, 2, 2);
+
+	ltest_takedown(tc, &lsm);
+}
+
+/**
+@brief		Tests that a tombstone hides a key stored in an older run.
+*/
+void
+test_lsm_delete_shadows_older_run(
+	planck_unit_test_t *tc
+) {
+	ion_lsm_t		lsm;
+	ion_status_t	status;
+
+	ltest_create(tc, &lsm, 4);
+
+	ltest_insert_range(tc, &lsm, 0, 4, 0);
+
+	status = lsm_delete(&lsm, IONIZE(2, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+	ltest_assert_missing(tc, &lsm, 2);
+
+	status = lsm_delete(&lsm, IONIZE(2, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, status.count);
+
+	status = lsm_delete(&lsm, IONIZE(5, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+
+	/* The tombstone is kept, as the older run still holds the key. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_flush(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, lsm.num_runs[0]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm_run_num_rows(lsm.runs[0][1]));
+	ltest_assert_missing(tc, &lsm, 2);
+	ltest_assert_get(tc, &lsm, 3, 3);
+
+	/* A key can be written again after it was deleted. */
+	ltest_insert_range(tc, &lsm, 2, 3, 20);
+	ltest_assert_get(tc, &lsm, 2, 22);
+
+	ltest_takedown(tc, &lsm);
+}
+
+/**
+@brief		Tests that tombstones written before anything is on disk are never stored.
+*/
+void
+test_lsm_delete_before_first_run(
+	planck_unit_test_t *tc
+) {
+	ion_lsm_t lsm;
+
+	ltest_create(tc, &lsm, 4);
+
+	ltest_insert_range(tc, &lsm, 0, 2, 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_delete(&lsm, IONIZE(0, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_delete(&lsm, IONIZE(1, int)).error);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_flush(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.num_runs[0]);
+	ltest_assert_missing(tc, &lsm, 0);
+
+	ltest_takedown(tc, &lsm);
+}
+
+/**
+@brief		Tests that tiered compaction merges a full level into one new run of the next.
+*/
+void
+test_lsm_tiered_compaction(
+	planck_unit_test_t *tc
+) {
+	ion_lsm_t	lsm;
+	int			i;
+
+	ltest_create(tc, &lsm, 2);
+	lsm.compaction = ion_lsm_compaction_tiered;
+
+	ltest_insert_range(tc, &lsm, 0, 2 * (ION_LSM_RUNS_PER_LEVEL - 1), 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ION_LSM_RUNS_PER_LEVEL - 1, lsm.num_runs[0]);
+
+	ltest_insert_range(tc, &lsm, 2 * (ION_LSM_RUNS_PER_LEVEL - 1), 2 * ION_LSM_RUNS_PER_LEVEL, 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.num_runs[0]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm.num_runs[1]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2 * ION_LSM_RUNS_PER_LEVEL, ltest_level_rows(&lsm, 1));
+
+	/* Runs gather in the next level until it is full in turn. */
+	ltest_insert_range(tc, &lsm, 2 * ION_LSM_RUNS_PER_LEVEL, 2 * ION_LSM_RUNS_PER_LEVEL * (ION_LSM_RUNS_PER_LEVEL - 1), 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ION_LSM_RUNS_PER_LEVEL - 1, lsm.num_runs[1]);
+
+	ltest_insert_range(tc, &lsm, 2 * ION_LSM_RUNS_PER_LEVEL * (ION_LSM_RUNS_PER_LEVEL - 1), 2 * ION_LSM_RUNS_PER_LEVEL * ION_LSM_RUNS_PER_LEVEL, 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.num_runs[0]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.num_runs[1]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm.num_runs[2]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2 * ION_LSM_RUNS_PER_LEVEL * ION_LSM_RUNS_PER_LEVEL, ltest_level_rows(&lsm, 2));
+
+	for (i = 0; i < 2 * ION_LSM_RUNS_PER_LEVEL * ION_LSM_RUNS_PER_LEVEL; i++) {
+		ltest_assert_get(tc, &lsm, i, i);
+	}
+
+	ltest_takedown(tc, &lsm);
+}
+
+/**
+@brief		Tests that a merge keeps only the newest version of each key, and
+			drops tombstones once nothing older is left below them.
+*/
+void
+test_lsm_compaction_drops_tombstones(
+	planck_unit_test_t *tc
+) {
+	ion_lsm_t	lsm;
+	int			i;
+
+	ltest_create(tc, &lsm, 2);
+
+	ltest_insert_range(tc, &lsm, 0, 2 * (ION_LSM_RUNS_PER_LEVEL - 1), 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_delete(&lsm, IONIZE(0, int)).error);
+	ltest_insert_range(tc, &lsm, 1, 2, 100);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.num_runs[0]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm.num_runs[1]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2 * (ION_LSM_RUNS_PER_LEVEL - 1) - 1, ltest_level_rows(&lsm, 1));
+
+	ltest_assert_missing(tc, &lsm, 0);
+	ltest_assert_get(tc, &lsm, 1, 101);
+
+	for (i = 2; i < 2 * (ION_LSM_RUNS_PER_LEVEL - 1); i++) {
+		ltest_assert_get(tc, &lsm, i, i);
+	}
+
+	ltest_takedown(tc, &lsm);
+}
+
+/**
+@brief		Tests that leveled compaction keeps a single run in each level below
+			the first, pushing it down once it outgrows its level.
+*/
+void
+test_lsm_leveled_compaction(
+	planck_unit_test_t *tc
+) {
+	ion_lsm_t	lsm;
+	int			level_size = 2 * ION_LSM_RUNS_PER_LEVEL;
+	int			i;
+
+	ltest_create(tc, &lsm, 2);
+	lsm.compaction = ion_lsm_compaction_leveled;
+
+	ltest_insert_range(tc, &lsm, 0, level_size, 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.num_runs[0]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm.num_runs[1]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, level_size, ltest_level_rows(&lsm, 1));
+
+	/* The second merge into the level grows it past its size, so it moves down. */
+	ltest_insert_range(tc, &lsm, level_size, 2 * level_size, 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.num_runs[1]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm.num_runs[2]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2 * level_size, ltest_level_rows(&lsm, 2));
+
+	/* Overwrites are merged away rather than adding rows. */
+	ltest_insert_range(tc, &lsm, 0, level_size, 1000);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(&lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm.num_runs[1]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, lsm.num_runs[2]);
+
+	for (i = 0; i < 2 * level_size; i++) {
+		ltest_assert_get(tc, &lsm, i, i < level_size ? i + 1000 : i);
+	}
+
+	ltest_takedown(tc, &lsm);
+}
+
+/**
+@brief		Tests that closing an LSM tree keeps its runs, memtable and policy.
+*/
+void
+test_lsm_reopen(
+	planck_unit_test_t *tc
+) {
+	ion_lsm_t lsm;
+
+	ltest_create(tc, &lsm, 4);
+	lsm.compaction = ion_lsm_compaction_leveled;
+
+	ltest_insert_range(tc, &lsm, 0, 6, 0);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_delete(&lsm, IONIZE(1, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_close(&lsm));
+
+	ltest_create(tc, &lsm, 4);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ion_lsm_compaction_leveled, lsm.compaction);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, lsm.num_runs[0]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, lsm.memtable_count);
+
+	ltest_assert_get(tc, &lsm, 0, 0);
+	ltest_assert_missing(tc, &lsm, 1);
+	ltest_assert_get(tc, &lsm, 5, 5);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_sync(&lsm));
+	ltest_takedown(tc, &lsm);
+}
+
+/**
+@brief		Builds a dictionary whose records are spread over the memtable, the
+			first level and the second level. Keys 0 to 19 hold twice the key, except
+			that 5 holds 500 and 7 is deleted.
+*/
+void
+ltest_build_dictionary(
+	planck_unit_test_t			*tc,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_t			*dictionary
+) {
+	int i;
+
+	lsmdict_init(handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(handler, dictionary, 1, key_type_numeric_signed, sizeof(int), sizeof(int), 4));
+
+	for (i = 0; i < 20; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(dictionary, &i, IONIZE(i * 2, int)).error);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_update(dictionary, IONIZE(5, int), IONIZE(500, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete(dictionary, IONIZE(7, int)).error);
+
+	ion_lsm_t *lsm = (ion_lsm_t *) dictionary->instance;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction(lsm));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, lsm->memtable_count);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 < lsm->num_runs[0]);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 < lsm->num_runs[1]);
+}
+
+/**
+@brief		Runs a cursor to its end, checking the keys it returns and their values.
+*/
+void
+ltest_check_cursor(
+	planck_unit_test_t	*tc,
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	int					*expected_keys,
+	int					num_expected
+) {
+	ion_dict_cursor_t	*cursor = NULL;
+	ion_record_t		record;
+	int					key;
+	int					value;
+	int					i;
+
+	record.key		= (ion_key_t) &key;
+	record.value	= (ion_value_t) &value;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(dictionary, predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0 == num_expected ? cs_end_of_results : cs_cursor_initialized, cursor->status);
+
+	for (i = 0; i < num_expected; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_cursor_active, cursor->next(cursor, &record));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected_keys[i], key);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 5 == key ? 500 : key * 2, value);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_end_of_results, cursor->next(cursor, &record));
+	cursor->destroy(&cursor);
+}
+
+/**
+@brief		Tests an all records cursor over the memtable and several runs.
+*/
+void
+test_lsm_cursor_all_records(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	int							expected[19];
+	int							num_expected = 0;
+	int							i;
+
+	ltest_build_dictionary(tc, &handler, &dictionary);
+
+	for (i = 0; i < 20; i++) {
+		if (7 != i) {
+			expected[num_expected++] = i;
+		}
+	}
+
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	ltest_check_cursor(tc, &dictionary, &predicate, expected, num_expected);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests range cursors over the memtable and several runs.
+*/
+void
+test_lsm_cursor_range(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	int							expected[] = { 4, 5, 6, 8, 9 };
+
+	ltest_build_dictionary(tc, &handler, &dictionary);
+
+	dictionary_build_predicate(&predicate, predicate_range, IONIZE(4, int), IONIZE(9, int));
+	ltest_check_cursor(tc, &dictionary, &predicate, expected, 5);
+
+	dictionary_build_predicate(&predicate, predicate_range, IONIZE(7, int), IONIZE(7, int));
+	ltest_check_cursor(tc, &dictionary, &predicate, NULL, 0);
+
+	dictionary_build_predicate(&predicate, predicate_range, IONIZE(30, int), IONIZE(40, int));
+	ltest_check_cursor(tc, &dictionary, &predicate, NULL, 0);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests equality cursors over the memtable and several runs.
+*/
+void
+test_lsm_cursor_equality(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	int							expected[] = { 5 };
+
+	ltest_build_dictionary(tc, &handler, &dictionary);
+
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(5, int));
+	ltest_check_cursor(tc, &dictionary, &predicate, expected, 1);
+
+	expected[0] = 12;
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(12, int));
+	ltest_check_cursor(tc, &dictionary, &predicate, expected, 1);
+
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(7, int));
+	ltest_check_cursor(tc, &dictionary, &predicate, NULL, 0);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		How many keys the concurrency test writes.
+*/
+#define LTEST_NUM_KEYS		400
+
+/**
+@brief		How many threads read while the concurrency test writes.
+*/
+#define LTEST_NUM_READERS	3
+
+/**
+@brief		What each reader of the concurrency test works on.
+*/
+typedef struct {
+	/**> The dictionary shared by every thread. */
+	ion_dictionary_t	*dictionary;
+	/**> How many checks failed in the thread. */
+	int					failures;
+} ltest_reader_t;
+
+/**
+@brief		Runs cursors and lookups over the dictionary while it is written
+			and compacted. Keys are written in order, so every cursor must see
+			them from 0 up without a gap, and never fewer than the cursor before.
+*/
+static void *
+ltest_reader_run(
+	void *argument
+) {
+	ltest_reader_t		*reader = argument;
+	ion_predicate_t		predicate;
+	ion_dict_cursor_t	*cursor;
+	ion_record_t		record;
+	int					key;
+	int					value;
+	int					num_seen;
+	int					previous	= 0;
+	int					round;
+	int					i;
+
+	record.key		= &key;
+	record.value	= &value;
+
+	for (round = 0; round < 50; round++) {
+		dictionary_build_predicate(&predicate, predicate_all_records);
+
+		if (err_ok != dictionary_find(reader->dictionary, &predicate, &cursor)) {
+			reader->failures++;
+			continue;
+		}
+
+		num_seen = 0;
+
+		while (cs_cursor_active == cursor->next(cursor, &record)) {
+			if ((key != num_seen) || (key != value)) {
+				reader->failures++;
+			}
+
+			num_seen++;
+		}
+
+		cursor->destroy(&cursor);
+
+		if (num_seen < previous) {
+			reader->failures++;
+		}
+
+		previous = num_seen;
+
+		for (i = 0; i < num_seen; i += 7) {
+			if ((err_ok != dictionary_get(reader->dictionary, &i, &value).error) || (i != value)) {
+				reader->failures++;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/**
+@brief		Tests lookups and cursors running while the compaction worker writes
+			out memtables and merges levels.
+*/
+void
+test_lsm_reads_during_compaction(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ltest_reader_t				readers[LTEST_NUM_READERS];
+	pthread_t					ids[LTEST_NUM_READERS];
+	int							value;
+	int							i;
+
+	lsmdict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 2, key_type_numeric_signed, sizeof(int), sizeof(int), 4));
+
+	for (i = 0; i < LTEST_NUM_READERS; i++) {
+		readers[i].dictionary	= &dictionary;
+		readers[i].failures		= 0;
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, pthread_create(&ids[i], NULL, ltest_reader_run, &readers[i]));
+	}
+
+	for (i = 0; i < LTEST_NUM_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, &i, &i).error);
+	}
+
+	for (i = 0; i < LTEST_NUM_READERS; i++) {
+		pthread_join(ids[i], NULL);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, readers[i].failures);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, lsm_wait_compaction((ion_lsm_t *) dictionary.instance));
+
+	for (i = 0; i < LTEST_NUM_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get(&dictionary, &i, &value).error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i, value);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+#endif /* Clause ION_THREAD_SAFE */
+
+planck_unit_suite_t *
+lsm_getsuite(
+) {
+	planck_unit_suite_t *suite = planck_unit_new_suite();
+
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_create_destroy);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_flush);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_update_shadows_older_run);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_delete_shadows_older_run);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_delete_before_first_run);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_tiered_compaction);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_compaction_drops_tombstones);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_leveled_compaction);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_reopen);
+
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_cursor_all_records);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_cursor_range);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_cursor_equality);
+
+#if ION_THREAD_SAFE
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_lsm_reads_during_compaction);
+#endif
+
+	return suite;
+}
+
+void
+runalltests_lsm(
+) {
+	planck_unit_suite_t *suite = lsm_getsuite();
+
+	planck_unit_run_suite(suite);
+	planck_unit_destroy_suite(suite);
+}
@@ -0,0 +1,488 @@
+/******************************************************************************/
+/**
+@file		test_sharded.c
+@author		IonDB Project
+@brief		Unit tests for the sharded dictionary.
+@copyright	Copyright 2017
+			The University of British Columbia,
+			IonDB Project Contributors (see AUTHORS.md)
+@par Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+@par 1.Redistributions of source code must retain the above copyright notice,
+	this list of conditions and the following disclaimer.
+
+@par 2.Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+@par 3.Neither the name of the copyright holder nor the names of its contributors
+	may be used to endorse or promote products derived from this software without
+	specific prior written permission.
+
+@par THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+/******************************************************************************/
+
+#include "test_sharded.h"
+
+/**
+@brief		How many keys the tests insert.
+*/
+#define SHARDTEST_NUM_KEYS	100
+
+/**
+@brief		How many shards the tests spread their keys over.
+*/
+#define SHARDTEST_NUM_SHARDS	4
+
+/**
+@brief		Creates a sharded dictionary of @p shard_type shards holding every
+			key below @ref SHARDTEST_NUM_KEYS, each with its key as value.
+*/
+void
+shardtest_build_dictionary(
+	planck_unit_test_t			*tc,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_t			*dictionary,
+	ion_dictionary_type_t		shard_type,
+	ion_dictionary_size_t		dictionary_size
+) {
+	int i;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, sharddict_configure(shard_type, SHARDTEST_NUM_SHARDS));
+
+	sharddict_init(handler);
+	PLANCK_UNIT_ASSERT_TRUE(tc, handler->concurrent);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(handler, dictionary, 1, key_type_numeric_signed, sizeof(int), sizeof(int), dictionary_size));
+
+	for (i = 0; i < SHARDTEST_NUM_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(dictionary, &i, &i).error);
+	}
+
+	sharddict_configure(ION_SHARDED_DEFAULT_TYPE, ION_SHARDED_DEFAULT_SHARDS);
+}
+
+/**
+@brief		Tests that each key is stored in its own shard only, and that
+			keys spread over every shard.
+*/
+void
+test_sharded_routing(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_sharded_t				*sharded;
+	int							counts[SHARDTEST_NUM_SHARDS] = { 0 };
+	int							value;
+	int							shard;
+	int							i;
+
+	shardtest_build_dictionary(tc, &handler, &dictionary, dictionary_type_skip_list_t, 7);
+	sharded = (ion_sharded_t *) dictionary.instance;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, SHARDTEST_NUM_SHARDS, sharded->num_shards);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, dictionary_type_sharded_t, sharded->super.type);
+
+	for (i = 0; i < SHARDTEST_NUM_KEYS; i++) {
+		int owner = sharded_shard_of(sharded, &i);
+
+		counts[owner]++;
+
+		for (shard = 0; shard < SHARDTEST_NUM_SHARDS; shard++) {
+			ion_status_t status = dictionary_get(&sharded->shards[shard], &i, &value);
+
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, owner == shard ? err_ok : err_item_not_found, status.error);
+		}
+	}
+
+	for (shard = 0; shard < SHARDTEST_NUM_SHARDS; shard++) {
+		PLANCK_UNIT_ASSERT_TRUE(tc, counts[shard] >= SHARDTEST_NUM_KEYS / SHARDTEST_NUM_SHARDS / 2);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests that string keys which compare equal go to the same shard,
+			whatever follows their terminating null.
+*/
+void
+test_sharded_string_keys(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_sharded_t				*sharded;
+	char						first[8]	= { 'k', 'e', 'y', '\0', 'a', 'b', 'c', 'd' };
+	char						second[8]	= { 'k', 'e', 'y', '\0', 'w', 'x', 'y', 'z' };
+	char						value[4];
+	ion_status_t				status;
+
+	sharddict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 2, key_type_null_terminated_string, sizeof(first), sizeof(value), 7));
+	sharded = (ion_sharded_t *) dictionary.instance;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, sharded_shard_of(sharded, first), sharded_shard_of(sharded, second));
+
+	status = dictionary_insert(&dictionary, first, "one");
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+
+	status = dictionary_get(&dictionary, second, value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_STR_ARE_EQUAL(tc, "one", value);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests that cursors merge the shards back into key order.
+*/
+void
+test_sharded_cursors(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	ion_dict_cursor_t			*cursor = NULL;
+	ion_record_t				record;
+	int							key;
+	int							value;
+	int							expected;
+
+	record.key		= &key;
+	record.value	= &value;
+
+	shardtest_build_dictionary(tc, &handler, &dictionary, dictionary_type_skip_list_t, 7);
+
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+
+	for (expected = 0; cs_cursor_active == cursor->next(cursor, &record); expected++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected, key);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected, value);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, SHARDTEST_NUM_KEYS, expected);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_end_of_results, cursor->status);
+	cursor->destroy(&cursor);
+
+	dictionary_build_predicate(&predicate, predicate_range, IONIZE(-5, int), IONIZE(9, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+
+	for (expected = 0; cs_cursor_active == cursor->next(cursor, &record); expected++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, expected, key);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 10, expected);
+	cursor->destroy(&cursor);
+
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(42, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, ((ion_sharded_cursor_t *) cursor)->num_sources);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_cursor_active, cursor->next(cursor, &record));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 42, key);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_end_of_results, cursor->next(cursor, &record));
+	cursor->destroy(&cursor);
+
+	dictionary_build_predicate(&predicate, predicate_range, IONIZE(SHARDTEST_NUM_KEYS, int), IONIZE(2 * SHARDTEST_NUM_KEYS, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_end_of_results, cursor->next(cursor, &record));
+	cursor->destroy(&cursor);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests running a batch, in which operations on the same key keep
+			their order.
+*/
+void
+test_sharded_batch(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_sharded_op_t			ops[3 * SHARDTEST_NUM_KEYS];
+	int							keys[SHARDTEST_NUM_KEYS];
+	int							values[SHARDTEST_NUM_KEYS];
+	int							read[SHARDTEST_NUM_KEYS];
+	int							value;
+	int							i;
+
+	shardtest_build_dictionary(tc, &handler, &dictionary, dictionary_type_skip_list_t, 7);
+
+	/* Update every key, delete the even ones, then read every key back. */
+	for (i = 0; i < SHARDTEST_NUM_KEYS; i++) {
+		keys[i]										= i;
+		values[i]									= -i;
+		read[i]										= 0;
+
+		ops[i].type									= ion_sharded_op_update;
+		ops[i].key									= &keys[i];
+		ops[i].value								= &values[i];
+
+		ops[SHARDTEST_NUM_KEYS + i].type			= 0 == i % 2 ? ion_sharded_op_delete : ion_sharded_op_insert;
+		ops[SHARDTEST_NUM_KEYS + i].key				= &keys[i];
+		ops[SHARDTEST_NUM_KEYS + i].value			= &values[i];
+
+		ops[2 * SHARDTEST_NUM_KEYS + i].type		= ion_sharded_op_get;
+		ops[2 * SHARDTEST_NUM_KEYS + i].key			= &keys[i];
+		ops[2 * SHARDTEST_NUM_KEYS + i].value		= &read[i];
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, sharddict_execute(&dictionary, ops, 3 * SHARDTEST_NUM_KEYS));
+
+	for (i = 0; i < SHARDTEST_NUM_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, sharded_shard_of((ion_sharded_t *) dictionary.instance, &i), ops[i].shard);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ops[i].status.error);
+
+		if (0 == i % 2) {
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ops[SHARDTEST_NUM_KEYS + i].status.error);
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, ops[2 * SHARDTEST_NUM_KEYS + i].status.error);
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, dictionary_get(&dictionary, &i, &value).error);
+		}
+		else {
+			/* Skip lists take duplicates, and the get finds either copy. */
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ops[2 * SHARDTEST_NUM_KEYS + i].status.error);
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, -i, read[i]);
+		}
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, sharddict_execute(&dictionary, ops, 0));
+
+	/* A batch would slip past the filter. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_enable_bloom_filter(&dictionary, 1024, 3));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_not_implemented, sharddict_execute(&dictionary, ops, SHARDTEST_NUM_KEYS));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests that a closed dictionary reopens with the shards it was
+			created with, whatever the configuration is by then.
+*/
+void
+test_sharded_reopen(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_sharded_t				*sharded;
+	int							value;
+	int							i;
+
+	ion_dictionary_config_info_t config = {
+		1, 0, key_type_numeric_signed, sizeof(int), sizeof(int), 15, dictionary_type_sharded_t, ion_dictionary_status_ok
+	};
+
+	shardtest_build_dictionary(tc, &handler, &dictionary, dictionary_type_flat_file_t, 15);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_close(&dictionary));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_open(&handler, &dictionary, &config));
+	sharded = (ion_sharded_t *) dictionary.instance;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, SHARDTEST_NUM_SHARDS, sharded->num_shards);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, dictionary_type_flat_file_t, sharded->shard_type);
+
+	for (i = 0; i < SHARDTEST_NUM_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get(&dictionary, &i, &value).error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i, value);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_close(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_destroy_dictionary(&handler, 1));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_file_open_error, dictionary_open(&handler, &dictionary, &config));
+}
+
+/**
+@brief		Tests that shard configurations that cannot work are refused.
+*/
+void
+test_sharded_configure(
+	planck_unit_test_t *tc
+) {
+	ion_sharded_t sharded;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_invalid_initial_size, sharddict_configure(dictionary_type_skip_list_t, 0));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_invalid_initial_size, sharddict_configure(dictionary_type_skip_list_t, ION_SHARDED_MAX_SHARDS + 1));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_uninitialized, sharddict_configure(dictionary_type_sharded_t, 2));
+
+	sharded.super.compare = dictionary_compare_signed_value;
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_uninitialized, sharded_initialize(&sharded, 3, dictionary_type_sharded_t, 2, key_type_numeric_signed, sizeof(int), sizeof(int), 7));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_invalid_initial_size, sharded_initialize(&sharded, 3, dictionary_type_skip_list_t, 0, key_type_numeric_signed, sizeof(int), sizeof(int), 7));
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		How many threads the concurrency test runs.
+*/
+#define SHARDTEST_NUM_THREADS	4
+
+/**
+@brief		What each thread of the concurrency test works on.
+*/
+typedef struct {
+	/**> The dictionary shared by every thread. */
+	ion_dictionary_t	*dictionary;
+	/**> Which thread this is. */
+	int					id;
+	/**> How many checks failed in the thread. */
+	int					failures;
+} shardtest_thread_t;
+
+/**
+@brief		Writes the keys of one thread, half one at a time and half in
+			batches, while running cursors over the whole dictionary.
+*/
+static void *
+shardtest_thread_run(
+	void *argument
+) {
+	shardtest_thread_t	*thread = argument;
+	ion_sharded_op_t	ops[SHARDTEST_NUM_KEYS];
+	int					keys[SHARDTEST_NUM_KEYS];
+	ion_predicate_t		predicate;
+	ion_dict_cursor_t	*cursor;
+	ion_record_t		record;
+	int					key;
+	int					value;
+	int					previous;
+	int					round;
+	int					i;
+
+	record.key		= &key;
+	record.value	= &value;
+
+	for (round = 0; round < 10; round++) {
+		int first = SHARDTEST_NUM_KEYS * (1 + round * SHARDTEST_NUM_THREADS + thread->id);
+
+		for (i = 0; i < SHARDTEST_NUM_KEYS; i++) {
+			keys[i] = first + i;
+
+			if (0 == round % 2) {
+				if (err_ok != dictionary_insert(thread->dictionary, &keys[i], &keys[i]).error) {
+					thread->failures++;
+				}
+
+				continue;
+			}
+
+			ops[i].type		= ion_sharded_op_insert;
+			ops[i].key		= &keys[i];
+			ops[i].value	= &keys[i];
+		}
+
+		if (0 != round % 2) {
+			if (err_ok != sharddict_execute(thread->dictionary, ops, SHARDTEST_NUM_KEYS)) {
+				thread->failures++;
+			}
+
+			for (i = 0; i < SHARDTEST_NUM_KEYS; i++) {
+				if (err_ok != ops[i].status.error) {
+					thread->failures++;
+				}
+			}
+		}
+
+		dictionary_build_predicate(&predicate, predicate_all_records);
+
+		if (err_ok != dictionary_find(thread->dictionary, &predicate, &cursor)) {
+			thread->failures++;
+			continue;
+		}
+
+		previous = -1;
+
+		while (cs_cursor_active == cursor->next(cursor, &record)) {
+			if ((key <= previous) || (key != value)) {
+				thread->failures++;
+			}
+
+			previous = key;
+		}
+
+		cursor->destroy(&cursor);
+	}
+
+	return NULL;
+}
+
+/**
+@brief		Tests writers, batches and cursors running on the same sharded
+			dictionary at once.
+*/
+void
+test_sharded_threads(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	shardtest_thread_t			threads[SHARDTEST_NUM_THREADS];
+	pthread_t					ids[SHARDTEST_NUM_THREADS];
+	int							value;
+	int							i;
+
+	shardtest_build_dictionary(tc, &handler, &dictionary, dictionary_type_skip_list_t, 7);
+
+	for (i = 0; i < SHARDTEST_NUM_THREADS; i++) {
+		threads[i].dictionary	= &dictionary;
+		threads[i].id			= i;
+		threads[i].failures		= 0;
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, pthread_create(&ids[i], NULL, shardtest_thread_run, &threads[i]));
+	}
+
+	for (i = 0; i < SHARDTEST_NUM_THREADS; i++) {
+		pthread_join(ids[i], NULL);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, threads[i].failures);
+	}
+
+	for (i = 0; i < SHARDTEST_NUM_KEYS * (1 + 10 * SHARDTEST_NUM_THREADS); i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get(&dictionary, &i, &value).error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i, value);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+#endif /* Clause ION_THREAD_SAFE */
+
+planck_unit_suite_t *
+sharded_getsuite(
+) {
+	planck_unit_suite_t *suite = planck_unit_new_suite();
+
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_sharded_routing);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_sharded_string_keys);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_sharded_cursors);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_sharded_batch);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_sharded_reopen);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_sharded_configure);
+#if ION_THREAD_SAFE
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_sharded_threads);
+#endif
+
+	return suite;
+}
+
+void
+runalltests_sharded(
+) {
+	planck_unit_suite_t *suite = sharded_getsuite();
+
+	planck_unit_run_suite(suite);
+	planck_unit_destroy_suite(suite);
+}
@@ -483,6 +483,105 @@ test_slhandler_cursor_range_exact_results(
 	dictionary_delete_dictionary(&dict);
 }
 
+/**
+@brief		Drains a cursor through the batched interface and checks that every
+			record satisfies the query and that the expected number of records is
+			produced.
+
+@param	  tc
+				Test case.
+@param	  dictionary
+				Dictionary to query.
+@param	  predicate
+				Predicate to query with.
+@param	  batch_size
+				How many records to ask for per call.
+@param	  expected_count
+				How many records the query should produce in total.
+*/
+void
+test_slhandler_cursor_batch(
+	planck_unit_test_t	*tc,
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	int					batch_size,
+	int					expected_count
+) {
+	ion_dict_cursor_t	*cursor = NULL;
+	ion_record_t		records[batch_size];
+	int					keys[batch_size];
+	int					values[batch_size];
+	ion_result_count_t	num_records;
+	ion_cursor_status_t cursor_status;
+	int					count = 0;
+	int					i;
+
+	for (i = 0; i < batch_size; i++) {
+		records[i].key		= &keys[i];
+		records[i].value	= &values[i];
+	}
+
+	PLANCK_UNIT_ASSERT_TRUE(tc, err_ok == dictionary_find(dictionary, predicate, &cursor));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL != cursor->next_batch);
+
+	while (cs_cursor_active == (cursor_status = dictionary_cursor_next_batch(cursor, records, batch_size, &num_records))) {
+		PLANCK_UNIT_ASSERT_TRUE(tc, 0 < num_records && batch_size >= num_records);
+
+		for (i = 0; i < num_records; i++) {
+			PLANCK_UNIT_ASSERT_TRUE(tc, test_predicate(cursor, &keys[i]));
+			PLANCK_UNIT_ASSERT_TRUE(tc, keys[i] * 2 == values[i]);
+			PLANCK_UNIT_ASSERT_TRUE(tc, 0 == i || keys[i - 1] <= keys[i]);
+		}
+
+		count += num_records;
+	}
+
+	PLANCK_UNIT_ASSERT_TRUE(tc, cs_end_of_results == cursor_status);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 == num_records);
+	PLANCK_UNIT_ASSERT_TRUE(tc, expected_count == count);
+
+	cursor->destroy(&cursor);
+}
+
+/**
+@brief	  Tests that batched cursors produce every matching record exactly
+			once, for batch sizes smaller and larger than the result set.
+
+@param	  tc
+				Test case.
+*/
+void
+test_slhandler_next_batch(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	int							i;
+	int							value;
+
+	sldict_init(&handler);
+	dictionary_create(&handler, &dictionary, 1, key_type_numeric_signed, sizeof(int), sizeof(int), 7);
+
+	for (i = 0; i < 40; i++) {
+		value = i * 2;
+		dictionary_insert(&dictionary, &i, &value);
+	}
+
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	test_slhandler_cursor_batch(tc, &dictionary, &predicate, 1, 40);
+	test_slhandler_cursor_batch(tc, &dictionary, &predicate, 3, 40);
+	test_slhandler_cursor_batch(tc, &dictionary, &predicate, 64, 40);
+
+	dictionary_build_predicate(&predicate, predicate_range, IONIZE(10, int), IONIZE(29, int));
+	test_slhandler_cursor_batch(tc, &dictionary, &predicate, 6, 20);
+
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(7, int));
+	test_slhandler_cursor_batch(tc, &dictionary, &predicate, 3, 1);
+
+	dictionary_delete_dictionary(&dictionary);
+}
+
 /**
 @brief	  Creates the suite to test using PlanckUnit test cases.
 @return	 Pointer to a PlanckUnit test suite.
@@ -506,6 +605,9 @@ skiplist_handler_getsuite(
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_slhandler_cursor_range_lower_missing);
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_slhandler_cursor_range_exact_results);
 
+	/* Batched cursor test */
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_slhandler_next_batch);
+
 	return suite;
 }
 
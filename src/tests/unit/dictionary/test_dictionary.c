@@ -326,6 +326,1381 @@ test_dictionary_master_table(
 	/**************/
 }
 
+/**
+@brief		Checks that the master table use-type index finds the first and
+			last dictionary of each use, tracks deletes, and is rebuilt
+			when the master table is reopened.
+*/
+void
+test_dictionary_master_table_use_index(
+	planck_unit_test_t *tc
+) {
+	ion_err_t						err;
+	ion_dictionary_id_t				id;
+	ion_dictionary_config_info_t	config;
+	int								i;
+
+	err = ion_close_master_table();
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	fremove(ION_MASTER_TABLE_FILENAME);
+
+	err = ion_init_master_table();
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+
+	/* Ids 1..40, alternating between use types 3 and 7. */
+	for (i = 0; i < 40; i++) {
+		err = ion_master_table_get_next_id(&id);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+
+		ion_dictionary_config_info_t row = {
+			.id = id, .use_type = (0 == i % 2) ? 3 : 7, .type = key_type_numeric_signed, .key_size = sizeof(int), .value_size = i, .dictionary_size = 10, .dictionary_type = dictionary_type_bpp_tree_t, .dictionary_status = ion_dictionary_status_closed
+		};
+
+		err = ion_master_table_write(&row, ION_MASTER_TABLE_WRITE_FROM_END);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	}
+
+	err = ion_find_by_use_master_table(&config, 3, ION_MASTER_TABLE_FIND_FIRST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, config.id);
+
+	err = ion_find_by_use_master_table(&config, 7, ION_MASTER_TABLE_FIND_LAST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 40, config.id);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 39, config.value_size);
+
+	err = ion_find_by_use_master_table(&config, 5, ION_MASTER_TABLE_FIND_FIRST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, err);
+
+	/* Deleting the ends of a use chain moves them inward. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_delete_from_master_table(1));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_delete_from_master_table(40));
+
+	err = ion_find_by_use_master_table(&config, 3, ION_MASTER_TABLE_FIND_FIRST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 3, config.id);
+
+	err = ion_find_by_use_master_table(&config, 7, ION_MASTER_TABLE_FIND_LAST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 38, config.id);
+
+	/* Rewriting a row with a new use moves it between chains. */
+	ion_dictionary_config_info_t moved = {
+		.id = 2, .use_type = 3, .type = key_type_numeric_signed, .key_size = sizeof(int), .value_size = 1, .dictionary_size = 10, .dictionary_type = dictionary_type_bpp_tree_t, .dictionary_status = ion_dictionary_status_closed
+	};
+
+	err = ion_master_table_write(&moved, ION_MASTER_TABLE_CALCULATE_POS);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+
+	err = ion_find_by_use_master_table(&config, 3, ION_MASTER_TABLE_FIND_FIRST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, config.id);
+
+	err = ion_find_by_use_master_table(&config, 7, ION_MASTER_TABLE_FIND_FIRST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 4, config.id);
+
+	/* Everything above must have been written through to the file. */
+	err = ion_close_master_table();
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+
+	err = ion_init_master_table();
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 41, ion_master_table_next_id);
+
+	err = ion_lookup_in_master_table(1, &config);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, err);
+
+	err = ion_lookup_in_master_table(21, &config);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 21, config.id);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 3, config.use_type);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 20, config.value_size);
+
+	err = ion_find_by_use_master_table(&config, 3, ION_MASTER_TABLE_FIND_FIRST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, config.id);
+
+	err = ion_find_by_use_master_table(&config, 3, ION_MASTER_TABLE_FIND_LAST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 39, config.id);
+
+	err = ion_find_by_use_master_table(&config, 7, ION_MASTER_TABLE_FIND_LAST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 38, config.id);
+
+	/* Ids 41..48, each of a use type of its own, so the index has to grow. */
+	for (i = 0; i < 8; i++) {
+		err = ion_master_table_get_next_id(&id);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+
+		ion_dictionary_config_info_t row = {
+			.id = id, .use_type = 100 + i, .type = key_type_numeric_signed, .key_size = sizeof(int), .value_size = i, .dictionary_size = 10, .dictionary_type = dictionary_type_bpp_tree_t, .dictionary_status = ion_dictionary_status_closed
+		};
+
+		err = ion_master_table_write(&row, ION_MASTER_TABLE_WRITE_FROM_END);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	}
+
+	for (i = 0; i < 8; i++) {
+		err = ion_find_by_use_master_table(&config, 100 + i, ION_MASTER_TABLE_FIND_FIRST);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 41 + i, config.id);
+	}
+
+	/* A use type whose only row is deleted is dropped from the index. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_delete_from_master_table(41));
+
+	err = ion_find_by_use_master_table(&config, 100, ION_MASTER_TABLE_FIND_LAST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, err);
+
+	err = ion_find_by_use_master_table(&config, 107, ION_MASTER_TABLE_FIND_LAST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 48, config.id);
+
+	err = ion_find_by_use_master_table(&config, 3, ION_MASTER_TABLE_FIND_LAST);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 39, config.id);
+
+	err = ion_close_master_table();
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+
+	err = ion_delete_master_table();
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, err);
+}
+
+/**
+@brief		Checks whether the Bloom filter file of a dictionary exists.
+*/
+ion_boolean_t
+test_dictionary_bloom_filter_file_exists(
+	ion_dictionary_id_t id
+) {
+	char	filename[ION_MAX_FILENAME_LENGTH];
+	FILE	*file;
+
+	dictionary_get_filename(id, ION_BLOOM_FILTER_FILE_EXTENSION, filename);
+
+	if (NULL == (file = fopen(filename, "rb"))) {
+		return boolean_false;
+	}
+
+	fclose(file);
+	return boolean_true;
+}
+
+/**
+@brief		Tests that a Bloom filter enabled on a populated dictionary
+			answers misses, and keeps up with later inserts and updates.
+*/
+void
+test_dictionary_bloom_filter_get_delete(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_status_t				status;
+	int							i;
+	int							value;
+	int							false_positives = 0;
+
+	ffdict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 60, key_type_numeric_signed, sizeof(int), sizeof(int), 8));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == dictionary.bloom_filter);
+
+	for (i = 0; i < 100; i++) {
+		dictionary_insert(&dictionary, &i, &i);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_enable_bloom_filter(&dictionary, 100 * ION_BLOOM_FILTER_BITS_PER_KEY, ION_BLOOM_FILTER_DEFAULT_NUM_HASHES));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL != dictionary.bloom_filter);
+	PLANCK_UNIT_ASSERT_TRUE(tc, test_dictionary_bloom_filter_file_exists(60));
+
+	/* Every key already in the dictionary must pass the filter. */
+	for (i = 0; i < 100; i++) {
+		status = dictionary_get(&dictionary, &i, &value);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i, value);
+	}
+
+	for (i = 1000; i < 2000; i++) {
+		if (bloom_filter_might_contain(dictionary.bloom_filter, &i)) {
+			false_positives++;
+		}
+
+		status = dictionary_get(&dictionary, &i, &value);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, status.count);
+	}
+
+	PLANCK_UNIT_ASSERT_TRUE(tc, false_positives < 50);
+
+	status = dictionary_delete(&dictionary, IONIZE(5000, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, status.count);
+
+	status = dictionary_delete(&dictionary, IONIZE(5, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+
+	/* Keys written after the filter was enabled must be tracked. */
+	dictionary_insert(&dictionary, IONIZE(3000, int), IONIZE(1, int));
+	dictionary_update(&dictionary, IONIZE(4000, int), IONIZE(2, int));
+
+	status = dictionary_get(&dictionary, IONIZE(3000, int), &value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, value);
+
+	status = dictionary_get(&dictionary, IONIZE(4000, int), &value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, value);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+	PLANCK_UNIT_ASSERT_FALSE(tc, test_dictionary_bloom_filter_file_exists(60));
+}
+
+/**
+@brief		Tests that a Bloom filter is re-attached on open, and rebuilt
+			when the dictionary was not closed cleanly.
+*/
+void
+test_dictionary_bloom_filter_reopen(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t		handler;
+	ion_dictionary_t				dictionary;
+	ion_dictionary_config_info_t	config = {
+		61, 0, key_type_numeric_signed, sizeof(int), sizeof(int), 8
+	};
+	ion_status_t					status;
+	int								i;
+	int								value;
+
+	ffdict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 61, key_type_numeric_signed, sizeof(int), sizeof(int), 8));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_enable_bloom_filter(&dictionary, 512, 4));
+
+	for (i = 0; i < 20; i++) {
+		dictionary_insert(&dictionary, &i, &i);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ION_BLOOM_FILTER_STATE_STALE, dictionary.bloom_filter->state);
+
+	/* A clean close persists the filter and re-opening attaches it. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_close(&dictionary));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == dictionary.bloom_filter);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_open(&handler, &dictionary, &config));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL != dictionary.bloom_filter);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ION_BLOOM_FILTER_STATE_CLEAN, dictionary.bloom_filter->state);
+
+	for (i = 0; i < 20; i++) {
+		status = dictionary_get(&dictionary, &i, &value);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	/* Simulate a crash: the write reaches the data file but the filter is never persisted. */
+	dictionary_insert(&dictionary, IONIZE(500, int), IONIZE(7, int));
+	bloom_filter_free(&dictionary.bloom_filter);
+	dictionary.handler->close_dictionary(&dictionary);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_open(&handler, &dictionary, &config));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL != dictionary.bloom_filter);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, ION_BLOOM_FILTER_STATE_CLEAN, dictionary.bloom_filter->state);
+
+	status = dictionary_get(&dictionary, IONIZE(500, int), &value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 7, value);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_disable_bloom_filter(&dictionary));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == dictionary.bloom_filter);
+	PLANCK_UNIT_ASSERT_FALSE(tc, test_dictionary_bloom_filter_file_exists(61));
+
+	dictionary_delete_dictionary(&dictionary);
+}
+
+/**
+@brief		Tests the Bloom filter on implementations that are persisted
+			through the flat file fallback, and on ones without cursors.
+*/
+void
+test_dictionary_bloom_filter_other_implementations(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t		handler;
+	ion_dictionary_t				dictionary;
+	ion_dictionary_config_info_t	config = {
+		62, 0, key_type_numeric_signed, sizeof(int), sizeof(int), 7
+	};
+	ion_status_t					status;
+	int								i;
+	int								value;
+
+	sldict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 62, key_type_numeric_signed, sizeof(int), sizeof(int), 7));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_enable_bloom_filter(&dictionary, 256, 3));
+
+	for (i = 0; i < 10; i++) {
+		dictionary_insert(&dictionary, &i, &i);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_close(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_open(&handler, &dictionary, &config));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL != dictionary.bloom_filter);
+
+	status = dictionary_get(&dictionary, IONIZE(9, int), &value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 9, value);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+	PLANCK_UNIT_ASSERT_FALSE(tc, test_dictionary_bloom_filter_file_exists(62));
+
+	/* Without cursors, the filter is rebuilt from a scan of the records already there. */
+	linear_hash_dict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 63, key_type_numeric_signed, sizeof(int), sizeof(int), 4));
+
+	for (i = 0; i < 10; i++) {
+		dictionary_insert(&dictionary, &i, &i);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_enable_bloom_filter(&dictionary, 256, 3));
+
+	for (i = 0; i < 10; i++) {
+		status = dictionary_get(&dictionary, &i, &value);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i, value);
+	}
+
+	status = dictionary_get(&dictionary, IONIZE(-3, int), &value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, status.error);
+
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+	PLANCK_UNIT_ASSERT_FALSE(tc, test_dictionary_bloom_filter_file_exists(63));
+
+	/* A dictionary that can be neither iterated nor scanned gets no filter at all. */
+	handler.scan_extent = NULL;
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 63, key_type_numeric_signed, sizeof(int), sizeof(int), 4));
+	dictionary_insert(&dictionary, IONIZE(3, int), IONIZE(3, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_not_implemented, dictionary_enable_bloom_filter(&dictionary, 256, 3));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == dictionary.bloom_filter);
+	PLANCK_UNIT_ASSERT_FALSE(tc, test_dictionary_bloom_filter_file_exists(63));
+
+	status = dictionary_get(&dictionary, IONIZE(3, int), &value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests that latency statistics count each operation and cursor
+			step, report ordered percentiles and can be reset.
+*/
+void
+test_dictionary_stats(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	ion_dict_cursor_t			*cursor = NULL;
+	ion_record_t				record;
+	ion_stats_summary_t			summary;
+	int							i;
+	int							key;
+	int							value;
+
+	sldict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 64, key_type_numeric_signed, sizeof(int), sizeof(int), 7));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == dictionary.stats);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_uninitialized, dictionary_get_stats(&dictionary, ion_stats_insert, &summary));
+
+	dictionary_insert(&dictionary, IONIZE(-1, int), IONIZE(-1, int));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_enable_stats(&dictionary));
+
+	for (i = 0; i < 100; i++) {
+		dictionary_insert(&dictionary, &i, &i);
+	}
+
+	for (i = 0; i < 50; i++) {
+		dictionary_get(&dictionary, &i, &value);
+	}
+
+	dictionary_delete(&dictionary, IONIZE(7, int));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get_stats(&dictionary, ion_stats_insert, &summary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 100, summary.count);
+	PLANCK_UNIT_ASSERT_TRUE(tc, summary.p50_ns <= summary.p99_ns);
+	PLANCK_UNIT_ASSERT_TRUE(tc, summary.p99_ns <= summary.p999_ns);
+	PLANCK_UNIT_ASSERT_TRUE(tc, summary.p999_ns <= summary.max_ns);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 < summary.max_ns);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get_stats(&dictionary, ion_stats_get, &summary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 50, summary.count);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get_stats(&dictionary, ion_stats_delete, &summary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, summary.count);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get_stats(&dictionary, ion_stats_update, &summary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, summary.count);
+
+	/* 100 records, minus the deleted one, plus the one written before
+	   statistics were enabled, plus the call that reports the end. */
+	record.key		= &key;
+	record.value	= &value;
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+
+	while (cs_cursor_active == cursor->next(cursor, &record)) {}
+
+	cursor->destroy(&cursor);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get_stats(&dictionary, ion_stats_find, &summary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, summary.count);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get_stats(&dictionary, ion_stats_cursor_next, &summary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 101, summary.count);
+
+	dictionary_reset_stats(&dictionary);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get_stats(&dictionary, ion_stats_insert, &summary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, summary.count);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 == summary.p99_ns);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 == summary.max_ns);
+
+	/* A cursor opened before statistics are disabled keeps them alive until it is destroyed. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+	dictionary_disable_stats(&dictionary);
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == dictionary.stats);
+
+	for (i = 0; cs_cursor_active == cursor->next(cursor, &record); i++) {}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 100, i);
+	cursor->destroy(&cursor);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+#if ION_FILE_STATS
+
+/**
+@brief		Tests that file I/O is charged to the dictionary that did it,
+			both in total and per operation.
+*/
+void
+test_dictionary_io_stats(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	ff_handler;
+	ion_dictionary_handler_t	bpp_handler;
+	ion_dictionary_t			ff_dict;
+	ion_dictionary_t			bpp_dict;
+	ion_file_io_stats_t			io;
+	ion_file_io_stats_t			other_io;
+	ion_file_io_stats_t			op_io;
+	int							i;
+	int							value;
+
+	ffdict_init(&ff_handler);
+	bpptree_init(&bpp_handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&ff_handler, &ff_dict, 8, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&bpp_handler, &bpp_dict, 9, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	dictionary_reset_io_stats(&ff_dict);
+	dictionary_reset_io_stats(&bpp_dict);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_enable_stats(&ff_dict));
+
+	for (i = 0; i < 20; i++) {
+		dictionary_insert(&ff_dict, &i, &i);
+	}
+
+	for (i = 0; i < 20; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get(&ff_dict, &i, &value).error);
+	}
+
+	dictionary_get_io_stats(&ff_dict, &io);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 < io.writes);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 < io.reads);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 < io.seeks);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 20 * 2 * sizeof(int) <= io.bytes_written);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 < io.bytes_read);
+
+	/* Nothing was done to the B+ tree yet. */
+	dictionary_get_io_stats(&bpp_dict, &other_io);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 == other_io.reads);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 == other_io.writes);
+
+	/* Every byte the flat file wrote was written by an insert. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get_op_io_stats(&ff_dict, ion_stats_insert, &op_io));
+	PLANCK_UNIT_ASSERT_TRUE(tc, io.bytes_written == op_io.bytes_written);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get_op_io_stats(&ff_dict, ion_stats_get, &op_io));
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 < op_io.reads);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 == op_io.writes);
+
+	for (i = 0; i < 20; i++) {
+		dictionary_insert(&bpp_dict, &i, &i);
+	}
+
+	dictionary_get_io_stats(&bpp_dict, &other_io);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 < other_io.bytes_written);
+
+	/* The B+ tree's inserts are not charged to the flat file. */
+	dictionary_get_io_stats(&ff_dict, &op_io);
+	PLANCK_UNIT_ASSERT_TRUE(tc, io.bytes_written == op_io.bytes_written);
+
+	dictionary_reset_io_stats(&ff_dict);
+	dictionary_get_io_stats(&ff_dict, &io);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 == io.reads);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 0 == io.bytes_written);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&ff_dict));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&bpp_dict));
+}
+
+#endif /* Clause ION_FILE_STATS */
+
+/**
+@brief		Drops a log without checkpointing it, as if the process had died
+			right after its last commit.
+*/
+static void
+test_dictionary_wal_crash(
+	ion_wal_t *wal
+) {
+	uint32_t i;
+
+	for (i = 0; i < wal->num_owners; i++) {
+		if (NULL != wal->owners[i].dictionary) {
+			wal->owners[i].dictionary->wal = NULL;
+		}
+	}
+
+	ion_fclose(wal->file);
+	free(wal->buffer);
+	free(wal->owners);
+}
+
+/**
+@brief		Tests that writes are committed to the log in groups, and that
+			a checkpoint empties the log.
+*/
+void
+test_dictionary_wal_group_commit(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_wal_t					wal;
+	ion_wal_config_t			config = { 4, 0, 0 };
+	ion_file_offset_t			empty;
+	int							i;
+
+	ion_fremove("test.wal");
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &config));
+	empty = wal.end;
+
+	ffdict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 20, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+	PLANCK_UNIT_ASSERT_TRUE(tc, &wal == dictionary.wal);
+
+	for (i = 0; i < 3; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, &i, &i).error);
+	}
+
+	/* Nothing reaches the log until the group is full. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 3, wal.pending);
+	PLANCK_UNIT_ASSERT_TRUE(tc, empty == wal.end);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_update(&dictionary, IONIZE(1, int), IONIZE(10, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, wal.pending);
+	PLANCK_UNIT_ASSERT_TRUE(tc, empty < wal.end);
+	PLANCK_UNIT_ASSERT_TRUE(tc, wal.end == ion_fend(wal.file));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete(&dictionary, IONIZE(2, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, wal.pending);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_commit(&wal));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, wal.pending);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_checkpoint(&wal));
+	PLANCK_UNIT_ASSERT_TRUE(tc, empty == wal.end);
+	PLANCK_UNIT_ASSERT_TRUE(tc, empty == ion_fend(wal.file));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_close(&dictionary));
+	PLANCK_UNIT_ASSERT_TRUE(tc, NULL == dictionary.wal);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_close(&wal));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_destroy_dictionary(&handler, 20));
+	ion_fremove("test.wal");
+}
+
+/**
+@brief		Tests that attaching a dictionary replays the committed writes
+			it lost, ignoring a torn record at the end of the log.
+*/
+void
+test_dictionary_wal_recovery(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_handler_t	memory_handler;
+	ion_dictionary_t			dictionary;
+	ion_dictionary_t			memory_dictionary;
+	ion_wal_t					wal;
+	ion_wal_config_t			config = { 3, 0, 0 };
+	ion_file_handle_t			file;
+	ion_byte_t					torn[7];
+	ion_file_offset_t			empty;
+	int							i;
+	int							value;
+
+	ion_fremove("test.wal");
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &config));
+	empty = wal.end;
+
+	bpptree_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 21, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+
+	for (i = 0; i < 10; i++) {
+		dictionary_insert(&dictionary, &i, IONIZE(i * 2, int));
+	}
+
+	dictionary_delete(&dictionary, IONIZE(4, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_commit(&wal));
+
+	/* Crash, losing every write the dictionary made since it was created. */
+	test_dictionary_wal_crash(&wal);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, handler.delete_dictionary(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 21, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+
+	/* The crash also interrupted a commit. */
+	memset(torn, 0xab, sizeof(torn));
+	file = ion_fopen("test.wal");
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_fwrite_at(file, ion_fend(file), sizeof(torn), torn));
+	ion_fclose(file);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &config));
+	PLANCK_UNIT_ASSERT_TRUE(tc, wal.end < ion_fend(wal.file));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+
+	for (i = 0; i < 10; i++) {
+		if (4 == i) {
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, dictionary_get(&dictionary, &i, &value).error);
+			continue;
+		}
+
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get(&dictionary, &i, &value).error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i * 2, value);
+	}
+
+	/* Replayed writes are synced, so the log is no longer needed. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_checkpoint(&wal));
+	PLANCK_UNIT_ASSERT_TRUE(tc, empty == wal.end);
+	PLANCK_UNIT_ASSERT_TRUE(tc, empty == ion_fend(wal.file));
+
+	/* In-memory dictionaries cannot be synced. */
+	sldict_init(&memory_handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&memory_handler, &memory_dictionary, 22, key_type_numeric_signed, sizeof(int), sizeof(int), 7));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_not_implemented, dictionary_attach_wal(&memory_dictionary, &wal));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&memory_dictionary));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_close(&wal));
+	ion_fremove("test.wal");
+}
+
+/**
+@brief		Tests that replaying a log does not duplicate an insert that
+			reached the dictionary's file before the crash.
+*/
+void
+test_dictionary_wal_recovery_applied(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t		handler;
+	ion_dictionary_t				dictionary;
+	ion_dictionary_config_info_t	config		= { 23, 0, key_type_numeric_signed, sizeof(int), sizeof(int), 10 };
+	ion_wal_t						wal;
+	ion_wal_config_t				wal_config	= { 1, 0, 0 };
+	ion_predicate_t					predicate;
+	ion_dict_cursor_t				*cursor		= NULL;
+	ion_record_t					record;
+	int								key;
+	int								value;
+	int								num_records = 0;
+
+	ion_fremove("test.wal");
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &wal_config));
+
+	ffdict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 23, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(1, int), IONIZE(10, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_commit(&wal));
+
+	/* Crash after the insert has reached the dictionary's file, but before any checkpoint. */
+	test_dictionary_wal_crash(&wal);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_close(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_open(&handler, &dictionary, &config));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &wal_config));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+
+	record.key		= &key;
+	record.value	= &value;
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+
+	while (cs_cursor_active == cursor->next(cursor, &record)) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, key);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 10, value);
+		num_records++;
+	}
+
+	cursor->destroy(&cursor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, num_records);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_close(&wal));
+	ion_fremove("test.wal");
+}
+
+/**
+@brief		Tests that replaying a log does not bring back an insert that the
+			dictionary refused.
+*/
+void
+test_dictionary_wal_recovery_rejected(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t		handler;
+	ion_dictionary_t				dictionary;
+	ion_dictionary_config_info_t	config		= { 24, 0, key_type_numeric_signed, sizeof(int), sizeof(int), 10 };
+	ion_wal_t						wal;
+	ion_wal_config_t				wal_config	= { 1, 0, 0 };
+	int								value;
+
+	ion_fremove("test.wal");
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &wal_config));
+
+	oafdict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 24, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(5, int), IONIZE(100, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_duplicate_key, dictionary_insert(&dictionary, IONIZE(5, int), IONIZE(999, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_commit(&wal));
+
+	test_dictionary_wal_crash(&wal);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_close(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_open(&handler, &dictionary, &config));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &wal_config));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get(&dictionary, IONIZE(5, int), &value).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 100, value);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_close(&wal));
+	ion_fremove("test.wal");
+}
+
+/**
+@brief		Tests that replaying a logged insert keeps the records of its key
+			that were checkpointed before it.
+*/
+void
+test_dictionary_wal_recovery_checkpointed(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t		handler;
+	ion_dictionary_t				dictionary;
+	ion_dictionary_config_info_t	config		= { 25, 0, key_type_numeric_signed, sizeof(int), sizeof(int), 10 };
+	ion_wal_t						wal;
+	ion_wal_config_t				wal_config	= { 1, 0, 0 };
+	ion_predicate_t					predicate;
+	ion_dict_cursor_t				*cursor		= NULL;
+	ion_record_t					record;
+	int								key;
+	int								value;
+	int								sum			= 0;
+	int								num_records = 0;
+
+	ion_fremove("test.wal");
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &wal_config));
+
+	bpptree_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 25, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(5, int), IONIZE(100, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_checkpoint(&wal));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(5, int), IONIZE(200, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_commit(&wal));
+
+	test_dictionary_wal_crash(&wal);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_close(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_open(&handler, &dictionary, &config));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &wal_config));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+
+	record.key		= &key;
+	record.value	= &value;
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(5, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+
+	while (cs_cursor_active == cursor->next(cursor, &record)) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 5, key);
+		sum += value;
+		num_records++;
+	}
+
+	cursor->destroy(&cursor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, num_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 300, sum);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_close(&wal));
+	ion_fremove("test.wal");
+}
+
+/**
+@brief		Keys written before each parallel scan of
+			@ref test_dictionary_parallel_scan.
+*/
+#define TEST_DICTIONARY_SCAN_KEYS 500
+
+/**
+@brief		What the callback of @ref test_dictionary_parallel_scan counts.
+*/
+typedef struct {
+	int seen[TEST_DICTIONARY_SCAN_KEYS];		/**< Times each key was found. */
+	int per_worker[ION_SCAN_MAX_WORKERS];	/**< Records found by each worker. */
+	int calls;								/**< Records found in all. */
+	int stop_after;							/**< Stop the scan after this many
+												 records, or zero to never. */
+	int failures;							/**< Records that did not match. */
+} test_dictionary_scan_t;
+
+/**
+@brief		Counts a record found by a parallel scan.
+*/
+static ion_boolean_t
+test_dictionary_scan_callback(
+	ion_record_t	*record,
+	int				worker,
+	void			*context
+) {
+	test_dictionary_scan_t	*scan	= context;
+	int						key		= NEUTRALIZE(record->key, int);
+
+	if ((key < 0) || (key >= TEST_DICTIONARY_SCAN_KEYS) || (2 * key != NEUTRALIZE(record->value, int))) {
+		(void) ION_ATOMIC_FETCH_ADD(&scan->failures, 1);
+		return boolean_true;
+	}
+
+	(void) ION_ATOMIC_FETCH_ADD(&scan->seen[key], 1);
+	scan->per_worker[worker]++;
+
+	return 1 + ION_ATOMIC_FETCH_ADD(&scan->calls, 1) != scan->stop_after;
+}
+
+/**
+@brief		Runs parallel scans over one implementation, with every fifth key
+			deleted so that the scans have empty places to skip.
+*/
+static void
+test_dictionary_parallel_scan_implementation(
+	planck_unit_test_t			*tc,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_id_t			id,
+	ion_dictionary_size_t		dictionary_size
+) {
+	ion_dictionary_t		dictionary;
+	ion_predicate_t			predicate;
+	ion_dict_cursor_t		*cursor = NULL;
+	ion_record_t			record;
+	test_dictionary_scan_t	scan;
+	int						key;
+	int						value;
+	int						total;
+	int						i;
+
+	record.key		= &key;
+	record.value	= &value;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(handler, &dictionary, id, key_type_numeric_signed, sizeof(int), sizeof(int), dictionary_size));
+
+	for (i = 0; i < TEST_DICTIONARY_SCAN_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, &i, IONIZE(2 * i, int)).error);
+	}
+
+	for (i = 0; i < TEST_DICTIONARY_SCAN_KEYS; i += 5) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete(&dictionary, &i).error);
+	}
+
+	/* Every record, found once each. */
+	memset(&scan, 0, sizeof(scan));
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_parallel_scan(&dictionary, &predicate, 4, test_dictionary_scan_callback, &scan));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, scan.failures);
+
+	for (i = 0; i < TEST_DICTIONARY_SCAN_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0 == i % 5 ? 0 : 1, scan.seen[i]);
+	}
+
+	for (total = 0, i = 0; i < ION_SCAN_MAX_WORKERS; i++) {
+		total += scan.per_worker[i];
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, TEST_DICTIONARY_SCAN_KEYS * 4 / 5, total);
+
+	/* A range. */
+	memset(&scan, 0, sizeof(scan));
+	dictionary_build_predicate(&predicate, predicate_range, IONIZE(100, int), IONIZE(199, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_parallel_scan(&dictionary, &predicate, 3, test_dictionary_scan_callback, &scan));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 80, scan.calls);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, scan.seen[101]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, scan.seen[99]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, scan.seen[200]);
+
+	/* Stopped by the callback; workers already in a callback may finish it. */
+	memset(&scan, 0, sizeof(scan));
+	scan.stop_after = 1;
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_parallel_scan(&dictionary, &predicate, 4, test_dictionary_scan_callback, &scan));
+	PLANCK_UNIT_ASSERT_TRUE(tc, scan.calls >= 1 && scan.calls <= 4);
+
+	/* Merged into a cursor. */
+	memset(&scan, 0, sizeof(scan));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_parallel_find(&dictionary, &predicate, 4, &cursor));
+
+	while (cs_cursor_active == cursor->next(cursor, &record)) {
+		test_dictionary_scan_callback(&record, 0, &scan);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_end_of_results, cursor->status);
+	cursor->destroy(&cursor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, scan.failures);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, TEST_DICTIONARY_SCAN_KEYS * 4 / 5, scan.calls);
+
+	for (i = 0; i < TEST_DICTIONARY_SCAN_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0 == i % 5 ? 0 : 1, scan.seen[i]);
+	}
+
+	/* An equality cursor, destroyed before the workers are done. */
+	dictionary_build_predicate(&predicate, predicate_equality, IONIZE(42, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_parallel_find(&dictionary, &predicate, 2, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, cs_cursor_active, cursor->next(cursor, &record));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 42, key);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 84, value);
+	cursor->destroy(&cursor);
+
+	/* The scans released the dictionary. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(0, int), IONIZE(0, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests parallel scans over every implementation that supports them,
+			and that the others refuse them.
+*/
+void
+test_dictionary_parallel_scan(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_t			dictionary;
+	ion_predicate_t				predicate;
+	ion_dict_cursor_t			*cursor = NULL;
+
+	ffdict_init(&handler);
+	test_dictionary_parallel_scan_implementation(tc, &handler, 41, 20);
+	oafdict_init(&handler);
+	test_dictionary_parallel_scan_implementation(tc, &handler, 42, 2 * TEST_DICTIONARY_SCAN_KEYS);
+	oadict_init(&handler);
+	test_dictionary_parallel_scan_implementation(tc, &handler, 43, 2 * TEST_DICTIONARY_SCAN_KEYS);
+	linear_hash_dict_init(&handler);
+	test_dictionary_parallel_scan_implementation(tc, &handler, 44, 4);
+
+	sldict_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 45, key_type_numeric_signed, sizeof(int), sizeof(int), 7));
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_not_implemented, dictionary_parallel_scan(&dictionary, &predicate, 4, test_dictionary_scan_callback, NULL));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_not_implemented, dictionary_parallel_find(&dictionary, &predicate, 4, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(1, int), IONIZE(1, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Keys looked up by @ref test_dictionary_get_many, more than a file
+			queue holds at once. Only the lower two thirds are inserted.
+*/
+#define TEST_DICTIONARY_GET_MANY_KEYS 300
+
+/**
+@brief		Tests that reads queued on a file are all in flight before the
+			wait, and that a read past the end of the file fails on its own.
+*/
+void
+test_dictionary_file_queue(
+	planck_unit_test_t *tc
+) {
+	ion_file_handle_t	file = ion_fopen("fqueue.tst");
+	ion_file_queue_t	queue;
+	ion_file_queue_t	*local;
+	ion_file_queue_t	*again;
+	ion_file_read_t		reads[2 * ION_FILE_QUEUE_DEPTH];
+	int					values[2 * ION_FILE_QUEUE_DEPTH];
+	int					i;
+
+	PLANCK_UNIT_ASSERT_FALSE(tc, ION_FILE_IS_NULL(file));
+
+	for (i = 0; i < 2 * ION_FILE_QUEUE_DEPTH; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_fwrite(file, sizeof(int), (ion_byte_t *) IONIZE(7 * i, int)));
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_queue_init(&queue));
+
+	/* Backwards, and past a full queue. */
+	for (i = 0; i < 2 * ION_FILE_QUEUE_DEPTH; i++) {
+		reads[i].file		= file;
+		reads[i].offset		= (2 * ION_FILE_QUEUE_DEPTH - 1 - i) * sizeof(int);
+		reads[i].num_bytes	= sizeof(int);
+		reads[i].write_to	= (ion_byte_t *) &values[i];
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_queue_read(&queue, &reads[i]));
+
+		if (queue.async) {
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i % ION_FILE_QUEUE_DEPTH + 1, queue.num_queued);
+		}
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_queue_wait(&queue));
+
+	for (i = 0; i < 2 * ION_FILE_QUEUE_DEPTH; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, reads[i].error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 7 * (2 * ION_FILE_QUEUE_DEPTH - 1 - i), values[i]);
+	}
+
+	/* The second read runs off the end of the file. */
+	reads[1].offset = (2 * ION_FILE_QUEUE_DEPTH - 1) * sizeof(int) + 2;
+	ion_file_queue_read(&queue, &reads[0]);
+	ion_file_queue_read(&queue, &reads[1]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_file_read_error, ion_file_queue_wait(&queue));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, reads[0].error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_file_read_error, reads[1].error);
+
+	/* The error was only for that wait. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_queue_wait(&queue));
+
+	ion_file_queue_destroy(&queue);
+
+	/* The thread's own queue is set up once and handed out again. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_queue_local(&local));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_queue_read(local, &reads[0]));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_queue_wait(local));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 7 * (2 * ION_FILE_QUEUE_DEPTH - 1), values[0]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_file_queue_local(&again));
+	PLANCK_UNIT_ASSERT_TRUE(tc, local == again);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, again->num_queued);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_fclose(file));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_fremove("fqueue.tst"));
+}
+
+/**
+@brief		Looks up a batch of present, deleted and absent keys in one
+			dictionary.
+*/
+static void
+test_dictionary_get_many_implementation(
+	planck_unit_test_t			*tc,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_id_t			id,
+	ion_dictionary_size_t		dictionary_size
+) {
+	ion_dictionary_t	dictionary;
+	ion_key_t			keys[TEST_DICTIONARY_GET_MANY_KEYS];
+	ion_value_t			values[TEST_DICTIONARY_GET_MANY_KEYS];
+	ion_status_t		statuses[TEST_DICTIONARY_GET_MANY_KEYS];
+	int					key_buffers[TEST_DICTIONARY_GET_MANY_KEYS];
+	int					value_buffers[TEST_DICTIONARY_GET_MANY_KEYS];
+	ion_status_t		status;
+	int					found = 0;
+	int					i;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(handler, &dictionary, id, key_type_numeric_signed, sizeof(int), sizeof(int), dictionary_size));
+
+	for (i = 0; i < TEST_DICTIONARY_GET_MANY_KEYS * 2 / 3; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, &i, IONIZE(3 * i, int)).error);
+	}
+
+	for (i = 0; i < TEST_DICTIONARY_GET_MANY_KEYS * 2 / 3; i += 7) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete(&dictionary, &i).error);
+	}
+
+	/* Scattered, so that neighbouring lookups land in different buckets. */
+	for (i = 0; i < TEST_DICTIONARY_GET_MANY_KEYS; i++) {
+		key_buffers[i]		= (i * 37) % TEST_DICTIONARY_GET_MANY_KEYS;
+		value_buffers[i]	= -1;
+		keys[i]				= &key_buffers[i];
+		values[i]			= &value_buffers[i];
+
+		if ((key_buffers[i] < TEST_DICTIONARY_GET_MANY_KEYS * 2 / 3) && (0 != key_buffers[i] % 7)) {
+			found++;
+		}
+	}
+
+	status = dictionary_get_many(&dictionary, TEST_DICTIONARY_GET_MANY_KEYS, keys, values, statuses);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, found, status.count);
+
+	for (i = 0; i < TEST_DICTIONARY_GET_MANY_KEYS; i++) {
+		if ((key_buffers[i] < TEST_DICTIONARY_GET_MANY_KEYS * 2 / 3) && (0 != key_buffers[i] % 7)) {
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, statuses[i].error);
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, statuses[i].count);
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 3 * key_buffers[i], value_buffers[i]);
+		}
+		else {
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_item_not_found, statuses[i].error);
+			PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, -1, value_buffers[i]);
+		}
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests batched lookups in the implementations that overlap their
+			reads, and in one that falls back to looking keys up one by one.
+*/
+void
+test_dictionary_get_many(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t handler;
+
+	oafdict_init(&handler);
+	test_dictionary_get_many_implementation(tc, &handler, 46, TEST_DICTIONARY_GET_MANY_KEYS);
+	linear_hash_dict_init(&handler);
+	test_dictionary_get_many_implementation(tc, &handler, 47, 4);
+	sldict_init(&handler);
+	test_dictionary_get_many_implementation(tc, &handler, 48, 7);
+}
+
+#if ION_THREAD_SAFE
+
+/**
+@brief		Keys written before the threads of @ref test_dictionary_thread_safe
+			start, and again by its writer.
+*/
+#define TEST_DICTIONARY_THREAD_KEYS 200
+
+/**
+@brief		What one thread of @ref test_dictionary_thread_safe works on.
+*/
+typedef struct {
+	ion_dictionary_t	*dictionary;/**< The shared dictionary. */
+	ion_boolean_t		is_writer;	/**< Whether to write rather than read. */
+	int					failures;	/**< Results that did not match. */
+} test_dictionary_thread_t;
+
+/**
+@brief		Either reads back every preloaded key and scans the dictionary,
+			or inserts the keys after them.
+*/
+static void *
+test_dictionary_thread_run(
+	void *argument
+) {
+	test_dictionary_thread_t	*thread = argument;
+	ion_predicate_t				predicate;
+	ion_dict_cursor_t			*cursor = NULL;
+	ion_record_t				record;
+	int							key;
+	int							value;
+	int							seen;
+	int							round;
+	int							i;
+
+	record.key		= &key;
+	record.value	= &value;
+
+	for (round = 0; round < 5; round++) {
+		for (i = 0; i < TEST_DICTIONARY_THREAD_KEYS; i++) {
+			if (thread->is_writer) {
+				key = round * TEST_DICTIONARY_THREAD_KEYS + TEST_DICTIONARY_THREAD_KEYS + i;
+
+				if (err_ok != dictionary_insert(thread->dictionary, &key, &key).error) {
+					thread->failures++;
+				}
+			}
+			else if ((err_ok != dictionary_get(thread->dictionary, &i, &value).error) || (i * 3 != value)) {
+				thread->failures++;
+			}
+		}
+
+		/* Not every implementation supports cursors. */
+		if (thread->is_writer || (NULL == thread->dictionary->handler->find)) {
+			continue;
+		}
+
+		/* Other threads are inserting larger keys, so only the preloaded ones are certain. */
+		seen = 0;
+		dictionary_build_predicate(&predicate, predicate_range, IONIZE(0, int), IONIZE(TEST_DICTIONARY_THREAD_KEYS - 1, int));
+
+		if (err_ok != dictionary_find(thread->dictionary, &predicate, &cursor)) {
+			thread->failures++;
+			continue;
+		}
+
+		while (cs_cursor_active == cursor->next(cursor, &record)) {
+			if (key * 3 != value) {
+				thread->failures++;
+			}
+
+			seen++;
+		}
+
+		cursor->destroy(&cursor);
+
+		if (TEST_DICTIONARY_THREAD_KEYS != seen) {
+			thread->failures++;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+@brief		Runs readers, cursors and a writer against one dictionary at the
+			same time.
+*/
+static void
+test_dictionary_thread_safe_implementation(
+	planck_unit_test_t			*tc,
+	ion_dictionary_handler_t	*handler,
+	ion_dictionary_id_t			id
+) {
+	ion_dictionary_t			dictionary;
+	pthread_t					threads[4];
+	test_dictionary_thread_t	workers[4];
+	int							i;
+	int							value;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(handler, &dictionary, id, key_type_numeric_signed, sizeof(int), sizeof(int), 20));
+
+	for (i = 0; i < TEST_DICTIONARY_THREAD_KEYS; i++) {
+		dictionary_insert(&dictionary, &i, IONIZE(i * 3, int));
+	}
+
+	for (i = 0; i < 4; i++) {
+		workers[i].dictionary	= &dictionary;
+		workers[i].is_writer	= 0 == i;
+		workers[i].failures		= 0;
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, pthread_create(&threads[i], NULL, test_dictionary_thread_run, &workers[i]));
+	}
+
+	for (i = 0; i < 4; i++) {
+		pthread_join(threads[i], NULL);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, workers[i].failures);
+	}
+
+	for (i = TEST_DICTIONARY_THREAD_KEYS; i < 6 * TEST_DICTIONARY_THREAD_KEYS; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get(&dictionary, &i, &value).error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i, value);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+}
+
+/**
+@brief		Tests that implementations with shared read state can be used by
+			several threads at once.
+*/
+void
+test_dictionary_thread_safe(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t handler;
+
+	bpptree_init(&handler);
+	test_dictionary_thread_safe_implementation(tc, &handler, 31);
+	ffdict_init(&handler);
+	test_dictionary_thread_safe_implementation(tc, &handler, 32);
+	linear_hash_dict_init(&handler);
+	test_dictionary_thread_safe_implementation(tc, &handler, 33);
+	lsmdict_init(&handler);
+	test_dictionary_thread_safe_implementation(tc, &handler, 34);
+}
+
+/**
+@brief		Tests that a thread holding a cursor has the writes that would
+			wait on it refused rather than deadlocking.
+*/
+void
+test_dictionary_thread_safe_held_cursor(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_handler_t	handler;
+	ion_dictionary_handler_t	concurrent_handler;
+	ion_dictionary_t			dictionary;
+	ion_dictionary_t			logged;
+	ion_dictionary_t			concurrent;
+	ion_predicate_t				predicate;
+	ion_dict_cursor_t			*cursor			= NULL;
+	ion_dict_cursor_t			*other_cursor	= NULL;
+	ion_wal_t					wal;
+	ion_wal_config_t			config			= { 4, 0, 0 };
+	int							value;
+
+	bpptree_init(&handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &dictionary, 35, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(1, int), IONIZE(1, int)).error);
+
+	/* Writers take the B+ tree exclusively, so its own cursors would block them. */
+	dictionary_build_predicate(&predicate, predicate_all_records);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &other_cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_would_deadlock, dictionary_insert(&dictionary, IONIZE(2, int), IONIZE(2, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_would_deadlock, dictionary_update(&dictionary, IONIZE(1, int), IONIZE(2, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_would_deadlock, dictionary_delete(&dictionary, IONIZE(1, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_get(&dictionary, IONIZE(1, int), &value).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, value);
+
+	/* Either cursor alone still blocks writers, whichever order they are destroyed in. */
+	cursor->destroy(&cursor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_would_deadlock, dictionary_insert(&dictionary, IONIZE(2, int), IONIZE(2, int)).error);
+	other_cursor->destroy(&other_cursor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&dictionary, IONIZE(2, int), IONIZE(2, int)).error);
+
+	/* A concurrent handler shares the dictionary with its writers, as long as it has no log. */
+	csldict_init(&concurrent_handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&concurrent_handler, &concurrent, 36, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&concurrent, &predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&concurrent, IONIZE(1, int), IONIZE(1, int)).error);
+	cursor->destroy(&cursor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&concurrent));
+
+	/* A checkpoint holding a log waits on cursors of every dictionary attached to it. */
+	ion_fremove("test.wal");
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_open(&wal, "test.wal", &config));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_create(&handler, &logged, 37, key_type_numeric_signed, sizeof(int), sizeof(int), 10));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&dictionary, &wal));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_attach_wal(&logged, &wal));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_find(&dictionary, &predicate, &cursor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_would_deadlock, dictionary_insert(&logged, IONIZE(1, int), IONIZE(1, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_would_deadlock, ion_wal_checkpoint(&wal));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_would_deadlock, ion_wal_commit(&wal));
+	cursor->destroy(&cursor);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_insert(&logged, IONIZE(1, int), IONIZE(1, int)).error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_checkpoint(&wal));
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&logged));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, dictionary_delete_dictionary(&dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, ion_wal_close(&wal));
+	ion_fremove("test.wal");
+}
+
+#endif
+
 planck_unit_suite_t *
 dictionary_getsuite(
 ) {
@@ -333,6 +1708,26 @@ dictionary_getsuite(
 
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_compare_numerics);
 	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_master_table);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_master_table_use_index);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_bloom_filter_get_delete);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_bloom_filter_reopen);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_bloom_filter_other_implementations);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_stats);
+#if ION_FILE_STATS
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_io_stats);
+#endif
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_wal_group_commit);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_wal_recovery);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_wal_recovery_applied);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_wal_recovery_rejected);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_wal_recovery_checkpointed);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_parallel_scan);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_file_queue);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_get_many);
+#if ION_THREAD_SAFE
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_thread_safe);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, test_dictionary_thread_safe_held_cursor);
+#endif
 
 	return suite;
 }
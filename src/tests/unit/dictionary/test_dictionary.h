@@ -44,6 +44,7 @@
 #include "../../../dictionary/dictionary_types.h"
 #include "./../../../dictionary/dictionary.h"
 #include "./../../../dictionary/ion_master_table.h"
+#include "./../../../file/ion_file_queue.h"
 
 #ifdef  __cplusplus
 extern "C" {
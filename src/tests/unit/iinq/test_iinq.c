@@ -264,6 +264,874 @@ iinq_test_create_query_select_all_from_where_two_dictionaries(
 	DROP(test2);
 }
 
+IINQ_NEW_PROCESSOR_FUNC(count_results) {
+	UNUSED(result);
+	(*(int *) state)++;
+}
+
+int
+iinq_test_count_cached_sources(
+) {
+	int							count	= 0;
+	ion_iinq_cached_source_t	*source = iinq_source_cache;
+
+	while (NULL != source) {
+		count++;
+		source = source->next;
+	}
+
+	return count;
+}
+
+void
+iinq_test_source_cache_reuse(
+	planck_unit_test_t *tc
+) {
+	ion_err_t					error;
+	ion_status_t				status;
+	ion_dictionary_t			*first_dictionary;
+	ion_dictionary_t			*second_dictionary;
+	ion_iinq_query_processor_t	processor;
+	int							num_results = 0;
+	int							i;
+
+	processor	= IINQ_QUERY_PROCESSOR(count_results, &num_results);
+
+	error		= CREATE_DICTIONARY(test, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	for (i = 0; i < 50; i++) {
+		status = INSERT(test, IONIZE(i, int), IONIZE(i * 2, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	/* Every operation goes through the same open dictionary. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, iinq_test_count_cached_sources());
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_acquire_source("test.inq", &first_dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_acquire_source("test.inq", &second_dictionary));
+	PLANCK_UNIT_ASSERT_TRUE(tc, first_dictionary == second_dictionary);
+	iinq_release_source(first_dictionary);
+	iinq_release_source(second_dictionary);
+
+	status = UPDATE(test, IONIZE(7, int), IONIZE(-7, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, status.count);
+
+	/* Queries see the writes made through the cached source. */
+	QUERY(SELECT_ALL, FROM(test), WHERE(1), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 50, num_results);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_close_sources());
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, iinq_test_count_cached_sources());
+
+	/* Everything written through the cache must be on disk once it is closed. */
+	ion_dictionary_t			dictionary;
+	ion_dictionary_handler_t	handler;
+	int							value;
+
+	dictionary.handler	= &handler;
+	error				= iinq_open_source("test.inq", &dictionary, &handler);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+	status				= dictionary_get(&dictionary, IONIZE(7, int), &value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, -7, value);
+	status				= dictionary_get(&dictionary, IONIZE(49, int), &value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 98, value);
+	ion_close_dictionary(&dictionary);
+
+	error = DROP(test);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+}
+
+void
+iinq_test_source_cache_flush(
+	planck_unit_test_t *tc
+) {
+	ion_dictionary_t	*dictionary;
+	ion_status_t		status;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, CREATE_DICTIONARY(test, key_type_numeric_signed, sizeof(int), sizeof(int)));
+	status = INSERT(test, IONIZE(1, int), IONIZE(2, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+
+	/* Flushing syncs the source and keeps it open. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_flush_source("test.inq"));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, iinq_test_count_cached_sources());
+
+	/* A held source can be neither flushed nor dropped. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_acquire_source("test.inq", &dictionary));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_would_deadlock, iinq_flush_source("test.inq"));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_would_deadlock, DROP(test));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, iinq_test_count_cached_sources());
+
+	int value;
+
+	status = dictionary_get(dictionary, IONIZE(1, int), &value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, value);
+	iinq_release_source(dictionary);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, DROP(test));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, iinq_test_count_cached_sources());
+}
+
+void
+iinq_test_source_cache_eviction(
+	planck_unit_test_t *tc
+) {
+	char				schema_file_names[IINQ_SOURCE_CACHE_SIZE + 1][ION_MAX_FILENAME_LENGTH];
+	ion_dictionary_t	*dictionaries[IINQ_SOURCE_CACHE_SIZE + 1];
+	ion_status_t		status;
+	int					i;
+
+	for (i = 0; i < IINQ_SOURCE_CACHE_SIZE + 1; i++) {
+		sprintf(schema_file_names[i], "cache%d.inq", i);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_create_source(schema_file_names[i], key_type_numeric_signed, sizeof(int), sizeof(int)));
+
+		status = iinq_insert(schema_file_names[i], IONIZE(i, int), IONIZE(i, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	/* Only so many released sources are kept open. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, IINQ_SOURCE_CACHE_SIZE, iinq_test_count_cached_sources());
+
+	/* Held sources are never closed, even past the cache size. */
+	for (i = 0; i < IINQ_SOURCE_CACHE_SIZE + 1; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_acquire_source(schema_file_names[i], &dictionaries[i]));
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, IINQ_SOURCE_CACHE_SIZE + 1, iinq_test_count_cached_sources());
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_close_sources());
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, IINQ_SOURCE_CACHE_SIZE + 1, iinq_test_count_cached_sources());
+
+	for (i = 0; i < IINQ_SOURCE_CACHE_SIZE + 1; i++) {
+		int value;
+
+		status = dictionary_get(dictionaries[i], IONIZE(i, int), &value);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, i, value);
+		iinq_release_source(dictionaries[i]);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_close_sources());
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, iinq_test_count_cached_sources());
+
+	for (i = 0; i < IINQ_SOURCE_CACHE_SIZE + 1; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_drop(schema_file_names[i]));
+	}
+}
+
+/**
+@brief		Collects what a join produced. Each result is laid out as left key, left value,
+			right key and right value, all of them @c int.
+*/
+typedef struct {
+	int						num_results;
+	int						num_bad_results;
+	ion_boolean_t			on_left_value;
+} iinq_test_join_state_t;
+
+IINQ_NEW_PROCESSOR_FUNC(check_join_result) {
+	iinq_test_join_state_t	*join_state = state;
+	int						*fields		= (int *) result->data;
+
+	join_state->num_results++;
+
+	/* Either left.value == right.key or left.key == right.key must hold. */
+	if ((4 * sizeof(int) != result->num_bytes) || (fields[join_state->on_left_value ? 1 : 0] != fields[2]) || (fields[3] != fields[2] * 100)) {
+		join_state->num_bad_results++;
+	}
+}
+
+/**
+@brief		Creates a fact source with keys 0 to 29 whose values point at keys 0 to 4
+			of a dimension source. The dimension source holds key 2 twice.
+*/
+void
+iinq_test_join_setup(
+	planck_unit_test_t *tc
+) {
+	ion_status_t	status;
+	int				i;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, CREATE_DICTIONARY(fact, key_type_numeric_signed, sizeof(int), sizeof(int)));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, CREATE_DICTIONARY(dim, key_type_numeric_signed, sizeof(int), sizeof(int)));
+
+	for (i = 0; i < 30; i++) {
+		status = INSERT(fact, IONIZE(i, int), IONIZE(i % 5, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	for (i = 0; i < 5; i++) {
+		status = INSERT(dim, IONIZE(i, int), IONIZE(i * 100, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	status = INSERT(dim, IONIZE(2, int), IONIZE(200, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+}
+
+void
+iinq_test_join_takedown(
+	planck_unit_test_t *tc
+) {
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, DROP(fact));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, DROP(dim));
+}
+
+void
+iinq_test_hash_join_on_value(
+	planck_unit_test_t *tc
+) {
+	iinq_test_join_state_t		join_state	= { 0, 0, boolean_true };
+	ion_iinq_query_processor_t	processor	= IINQ_QUERY_PROCESSOR(check_join_result, &join_state);
+
+	iinq_test_join_setup(tc);
+
+	/* 30 facts, of which the 6 pointing at key 2 match twice. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_hash_join(IINQ_JOIN_ON_VALUE_FIELD(fact, 0, sizeof(int)), IINQ_JOIN_ON_KEY(dim), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 36, join_state.num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, join_state.num_bad_results);
+
+	/* Same result when the larger side is on the right, and via the operator chooser. */
+	join_state.num_results = 0;
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_join(IINQ_JOIN_ON_VALUE_FIELD(fact, 0, 0), IINQ_JOIN_ON_KEY(dim), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 36, join_state.num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, join_state.num_bad_results);
+
+	/* A value field that does not fit is rejected, as is a merge on values. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_invalid_predicate, iinq_hash_join(IINQ_JOIN_ON_VALUE_FIELD(fact, 2, sizeof(int)), IINQ_JOIN_ON_KEY(dim), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_invalid_predicate, iinq_sort_merge_join(IINQ_JOIN_ON_VALUE_FIELD(fact, 0, 0), IINQ_JOIN_ON_KEY(dim), &processor));
+
+	iinq_test_join_takedown(tc);
+}
+
+void
+iinq_test_join_on_key(
+	planck_unit_test_t *tc
+) {
+	iinq_test_join_state_t		join_state	= { 0, 0, boolean_false };
+	ion_iinq_query_processor_t	processor	= IINQ_QUERY_PROCESSOR(check_join_result, &join_state);
+
+	iinq_test_join_setup(tc);
+
+	/* Fact keys 0 to 4 match, and key 2 matches twice. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_sort_merge_join(IINQ_JOIN_ON_KEY(fact), IINQ_JOIN_ON_KEY(dim), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 6, join_state.num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, join_state.num_bad_results);
+
+	/* With the sides swapped the values no longer line up with the check, so only count. */
+	join_state.num_results = 0;
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_sort_merge_join(IINQ_JOIN_ON_KEY(dim), IINQ_JOIN_ON_KEY(fact), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 6, join_state.num_results);
+
+	join_state.num_results		= 0;
+	join_state.num_bad_results	= 0;
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_hash_join(IINQ_JOIN_ON_KEY(fact), IINQ_JOIN_ON_KEY(dim), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 6, join_state.num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, join_state.num_bad_results);
+
+	iinq_test_join_takedown(tc);
+}
+
+/**
+@brief		The handler the join failure test wraps.
+*/
+static ion_dictionary_handler_t *iinq_test_real_handler;
+
+/**
+@brief		A cursor step that fails as if the source were corrupt.
+*/
+static ion_cursor_status_t
+iinq_test_failing_next(
+	ion_dict_cursor_t	*cursor,
+	ion_record_t		*record
+) {
+	UNUSED(record);
+	cursor->status = cs_possible_data_inconsistency;
+
+	return cursor->status;
+}
+
+/**
+@brief		Opens a cursor whose every step fails.
+*/
+static ion_err_t
+iinq_test_failing_find(
+	ion_dictionary_t	*dictionary,
+	ion_predicate_t		*predicate,
+	ion_dict_cursor_t	**cursor
+) {
+	ion_err_t error = iinq_test_real_handler->find(dictionary, predicate, cursor);
+
+	if (err_ok == error) {
+		(*cursor)->next			= iinq_test_failing_next;
+		(*cursor)->next_batch	= NULL;
+	}
+
+	return error;
+}
+
+/**
+@brief		Tests that a source whose cursor fails makes a join fail, rather than
+			pass for an empty source.
+*/
+void
+iinq_test_join_cursor_failure(
+	planck_unit_test_t *tc
+) {
+	iinq_test_join_state_t		join_state	= { 0, 0, boolean_false };
+	ion_iinq_query_processor_t	processor	= IINQ_QUERY_PROCESSOR(check_join_result, &join_state);
+	ion_dictionary_handler_t	failing_handler;
+	ion_dictionary_t			*dictionary;
+
+	iinq_test_join_setup(tc);
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, iinq_acquire_source("fact.inq", &dictionary));
+	iinq_test_real_handler	= dictionary->handler;
+	failing_handler			= *dictionary->handler;
+	failing_handler.find	= iinq_test_failing_find;
+	dictionary->handler		= &failing_handler;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_uninitialized, iinq_sort_merge_join(IINQ_JOIN_ON_KEY(fact), IINQ_JOIN_ON_KEY(dim), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_uninitialized, iinq_sort_merge_join(IINQ_JOIN_ON_KEY(dim), IINQ_JOIN_ON_KEY(fact), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_uninitialized, iinq_hash_join(IINQ_JOIN_ON_KEY(fact), IINQ_JOIN_ON_KEY(dim), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_uninitialized, iinq_hash_join(IINQ_JOIN_ON_KEY(dim), IINQ_JOIN_ON_KEY(fact), &processor));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, join_state.num_results);
+
+	dictionary->handler = iinq_test_real_handler;
+	iinq_release_source(dictionary);
+
+	iinq_test_join_takedown(tc);
+}
+
+/**
+@brief		A residual condition that counts how many records it is checked against.
+*/
+int
+iinq_test_count_checked(
+	int *num_checked
+) {
+	(*num_checked)++;
+	return 1;
+}
+
+/**
+@brief		A residual condition of type @ref ion_boolean_t that counts how many
+			records it is checked against, and fails unless the source holds
+			a record read by its cursor.
+*/
+ion_boolean_t
+iinq_test_check_bound(
+	int					*num_checked,
+	ion_iinq_source_t	*source
+) {
+	(*num_checked)++;
+	return NULL != source->cursor && cs_cursor_active == source->cursor_status;
+}
+
+void
+iinq_test_where_key_pushdown(
+	planck_unit_test_t *tc
+) {
+	ion_err_t					error;
+	ion_status_t				status;
+	ion_iinq_query_processor_t	processor;
+	int							num_results = 0;
+	int							num_checked = 0;
+	int							i;
+
+	processor	= IINQ_QUERY_PROCESSOR(count_results, &num_results);
+
+	error		= CREATE_DICTIONARY(test, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	for (i = 0; i < 50; i++) {
+		status = INSERT(test, IONIZE(i, int), IONIZE(i * 2, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	/* An equality on the key is a single lookup. */
+	QUERY(SELECT_ALL, FROM(test), WHERE_KEYS((KEY_EQUAL(test, IONIZE(7, int))), iinq_test_count_checked(&num_checked)), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, num_checked);
+
+	num_results = 0;
+	num_checked = 0;
+	QUERY(SELECT_ALL, FROM(test), WHERE_KEYS((KEY_EQUAL(test, IONIZE(100, int))), iinq_test_count_checked(&num_checked)), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 0, num_checked);
+
+	/* A range only reads the keys in range, the residual condition is checked on each of them. */
+	num_results = 0;
+	num_checked = 0;
+	QUERY(SELECT_ALL, FROM(test), WHERE_KEYS((KEY_RANGE(test, IONIZE(10, int), IONIZE(19, int))), iinq_test_count_checked(&num_checked), 0 == NEUTRALIZE(test.value, int) % 4), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 5, num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 10, num_checked);
+
+	/* Only the first key condition of a source is pushed down, the next one is still applied. */
+	num_results = 0;
+	num_checked = 0;
+	QUERY(SELECT_ALL, FROM(test), WHERE_KEYS((KEY_RANGE(test, IONIZE(10, int), IONIZE(19, int)), KEY_EQUAL(test, IONIZE(15, int))), 1), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, num_results);
+
+	/* A key condition given as an ordinary condition is checked on each record read through the pushed down one. */
+	num_results = 0;
+	QUERY(SELECT_ALL, FROM(test), WHERE_KEYS((KEY_RANGE(test, IONIZE(10, int), IONIZE(19, int))), iinq_test_count_checked(&num_checked), KEY_EQUAL(test, IONIZE(15, int))), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1, num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 10, num_checked);
+
+	/* A key condition given as an ordinary condition is only checked, never pushed down. */
+	num_results = 0;
+	num_checked = 0;
+	QUERY(SELECT_ALL, FROM(test), WHERE(iinq_test_count_checked(&num_checked), KEY_EQUAL(test, IONIZE(7, int)) || 8 == NEUTRALIZE(test.key, int)), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 2, num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 50, num_checked);
+
+	/* Conditions of the repo's own boolean type are not evaluated before the records are bound either. */
+	num_results = 0;
+	num_checked = 0;
+	QUERY(SELECT_ALL, FROM(test), WHERE(iinq_test_check_bound(&num_checked, &test)), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 50, num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 50, num_checked);
+
+	num_results = 0;
+	num_checked = 0;
+	QUERY(SELECT_ALL, FROM(test), WHERE_KEYS((KEY_RANGE(test, IONIZE(10, int), IONIZE(19, int))), iinq_test_check_bound(&num_checked, &test)), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 10, num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 10, num_checked);
+
+	error = DROP(test);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+}
+
+void
+iinq_test_where_key_pushdown_two_sources(
+	planck_unit_test_t *tc
+) {
+	ion_err_t					error;
+	ion_status_t				status;
+	ion_iinq_query_processor_t	processor;
+	int							num_results = 0;
+	int							num_checked = 0;
+	int							i;
+
+	processor	= IINQ_QUERY_PROCESSOR(count_results, &num_results);
+
+	error		= CREATE_DICTIONARY(test1, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+	error		= CREATE_DICTIONARY(test2, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	for (i = 0; i < 20; i++) {
+		status = INSERT(test1, IONIZE(i, int), IONIZE(i, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+		status = INSERT(test2, IONIZE(i, int), IONIZE(i, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	/* The inner source is rescanned with its pushed down predicate for every outer record. */
+	QUERY(SELECT_ALL, FROM(test1, test2), WHERE_KEYS((KEY_RANGE(test1, IONIZE(3, int), IONIZE(4, int)), KEY_RANGE(test2, IONIZE(5, int), IONIZE(7, int))), iinq_test_count_checked(&num_checked)), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 6, num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 6, num_checked);
+
+	error = DROP(test1);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+	error = DROP(test2);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+}
+
+/**
+@brief		State for checking the results of an operator test.
+*/
+typedef struct {
+	planck_unit_test_t	*tc;
+	int					num_results;
+	int					previous_key;
+	int					previous_value;
+	int					num_batches;
+	ion_boolean_t		groups_seen[40];
+} iinq_test_operator_state_t;
+
+/**
+@brief		Checks a group of keys 0 to 299 grouped on key % 40, with COUNT,
+			SUM, MIN, MAX and AVG of the key.
+*/
+IINQ_NEW_PROCESSOR_FUNC(check_group) {
+	iinq_test_operator_state_t	*test_state = state;
+	ion_iinq_aggregate_value_t	aggregates[5];
+	int							group;
+
+	memcpy(&group, result->data, sizeof(int));
+	memcpy(aggregates, result->data + sizeof(int), sizeof(aggregates));
+
+	int count = group < 20 ? 8 : 7;
+	int sum	= count * group + 40 * count * (count - 1) / 2;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, sizeof(int) + sizeof(aggregates), result->num_bytes);
+	PLANCK_UNIT_ASSERT_FALSE(test_state->tc, test_state->groups_seen[group]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, count, aggregates[0].integer);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, sum, aggregates[1].integer);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, group, aggregates[2].integer);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, group + 40 * (count - 1), aggregates[3].integer);
+	PLANCK_UNIT_ASSERT_TRUE(test_state->tc, (double) sum / count == aggregates[4].real);
+
+	test_state->groups_seen[group] = boolean_true;
+	test_state->num_results++;
+}
+
+ion_boolean_t
+iinq_test_having_full_group(
+	ion_iinq_result_t	*result,
+	void				*state
+) {
+	ion_iinq_aggregate_value_t count;
+
+	UNUSED(state);
+	memcpy(&count, result->data + sizeof(int), sizeof(count));
+
+	return 8 == count.integer;
+}
+
+void
+iinq_test_group_by(
+	planck_unit_test_t *tc
+) {
+	ion_err_t					error;
+	ion_status_t				status;
+	iinq_test_operator_state_t	state;
+	ion_iinq_query_processor_t	processor;
+	int							i;
+
+	memset(&state, 0, sizeof(state));
+	state.tc	= tc;
+	processor	= IINQ_QUERY_PROCESSOR(check_group, &state);
+
+	error		= CREATE_DICTIONARY(test, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	for (i = 0; i < 300; i++) {
+		status = INSERT(test, IONIZE(i, int), IONIZE(i % 40, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	/* There are more groups than fit in memory, so some are combined from disk. */
+	QUERY(SELECT_ALL, FROM(test), WHERE(1), GROUP_BY(IINQ_FIELD(IINQ_ALIGN(sizeof(int)), sizeof(int), key_type_numeric_signed), IINQ_COUNT(), IINQ_SUM(0, sizeof(int), key_type_numeric_signed), IINQ_MIN(0, sizeof(int), key_type_numeric_signed), IINQ_MAX(0, sizeof(int), key_type_numeric_signed), IINQ_AVG(0, sizeof(int), key_type_numeric_signed)), , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 40, state.num_results);
+
+	memset(&state, 0, sizeof(state));
+	state.tc = tc;
+	QUERY(SELECT_ALL, FROM(test), WHERE(1), GROUP_BY(IINQ_FIELD(IINQ_ALIGN(sizeof(int)), sizeof(int), key_type_numeric_signed), IINQ_COUNT(), IINQ_SUM(0, sizeof(int), key_type_numeric_signed), IINQ_MIN(0, sizeof(int), key_type_numeric_signed), IINQ_MAX(0, sizeof(int), key_type_numeric_signed), IINQ_AVG(0, sizeof(int), key_type_numeric_signed)), HAVING(iinq_test_having_full_group, NULL), , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 20, state.num_results);
+
+	for (i = 0; i < 40; i++) {
+		PLANCK_UNIT_ASSERT_TRUE(tc, (i < 20) == state.groups_seen[i]);
+	}
+
+	error = DROP(test);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+}
+
+/**
+@brief		Keeps the aggregates of the only group of a query.
+*/
+IINQ_NEW_PROCESSOR_FUNC(keep_aggregates) {
+	memcpy(state, result->data, result->num_bytes);
+}
+
+void
+iinq_test_group_by_int64(
+	planck_unit_test_t *tc
+) {
+	ion_err_t					error;
+	ion_status_t				status;
+	ion_iinq_aggregate_value_t	aggregates[3];
+	ion_iinq_query_processor_t	processor;
+	int64_t						base = (int64_t) 1 << 58;
+	int64_t						value;
+	int							i;
+
+	processor	= IINQ_QUERY_PROCESSOR(keep_aggregates, aggregates);
+
+	error		= CREATE_DICTIONARY(test, key_type_numeric_signed, sizeof(int), sizeof(int64_t));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	for (i = 0; i < 10; i++) {
+		value	= base + i;
+		status	= INSERT(test, IONIZE(i, int), &value);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	/* Past 2^53 a double cannot tell these values apart, the aggregates must stay exact. */
+	QUERY(SELECT_ALL, FROM(test), WHERE(1), GROUP_BY(IINQ_FIELD(0, 0, key_type_numeric_signed), IINQ_SUM(IINQ_ALIGN(sizeof(int)), sizeof(int64_t), key_type_numeric_signed), IINQ_MIN(IINQ_ALIGN(sizeof(int)), sizeof(int64_t), key_type_numeric_signed), IINQ_MAX(IINQ_ALIGN(sizeof(int)), sizeof(int64_t), key_type_numeric_signed)), , , , , &processor);
+	PLANCK_UNIT_ASSERT_TRUE(tc, 10 * base + 45 == aggregates[0].integer);
+	PLANCK_UNIT_ASSERT_TRUE(tc, base == aggregates[1].integer);
+	PLANCK_UNIT_ASSERT_TRUE(tc, base + 9 == aggregates[2].integer);
+
+	error = DROP(test);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+}
+
+/**
+@brief		Records that a query has finished.
+*/
+void
+iinq_test_mark_finished(
+	void *state
+) {
+	*(ion_boolean_t *) state = boolean_true;
+}
+
+void
+iinq_test_missing_source_finishes(
+	planck_unit_test_t *tc
+) {
+	ion_err_t					error;
+	ion_status_t				status;
+	ion_iinq_query_processor_t	processor;
+	ion_boolean_t				finished = boolean_false;
+
+	processor			= IINQ_QUERY_PROCESSOR(print_hello, &finished);
+	processor.finish	= iinq_test_mark_finished;
+
+	error				= CREATE_DICTIONARY(test, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+	status				= INSERT(test, IONIZE(1, int), IONIZE(1, int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+
+	/* The second source does not exist, yet the operators and the processor are still finished. */
+	QUERY(SELECT_ALL, FROM(test, missing), WHERE(1), , , ORDER_BY(IINQ_ASC(0, sizeof(int), key_type_numeric_signed)), , , &processor);
+	PLANCK_UNIT_ASSERT_TRUE(tc, finished);
+
+	/* The source that was acquired has been released again. */
+	error = DROP(test);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+}
+
+/**
+@brief		Checks that results come in descending order of value, then
+			ascending order of key.
+*/
+IINQ_NEW_PROCESSOR_FUNC(check_order) {
+	iinq_test_operator_state_t	*test_state = state;
+	int							key;
+	int							value;
+
+	memcpy(&key, result->data, sizeof(int));
+	memcpy(&value, result->data + IINQ_ALIGN(sizeof(int)), sizeof(int));
+
+	if (0 != test_state->num_results) {
+		PLANCK_UNIT_ASSERT_TRUE(test_state->tc, value < test_state->previous_value || (value == test_state->previous_value && key > test_state->previous_key));
+	}
+
+	test_state->previous_key	= key;
+	test_state->previous_value	= value;
+	test_state->num_results++;
+}
+
+void
+iinq_test_order_by(
+	planck_unit_test_t *tc
+) {
+	ion_err_t					error;
+	ion_status_t				status;
+	iinq_test_operator_state_t	state;
+	ion_iinq_query_processor_t	processor;
+	int							num_checked = 0;
+	int							i;
+
+	memset(&state, 0, sizeof(state));
+	state.tc	= tc;
+	processor	= IINQ_QUERY_PROCESSOR(check_order, &state);
+
+	error		= CREATE_DICTIONARY(test, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	for (i = 0; i < 1200; i++) {
+		status = INSERT(test, IONIZE(i, int), IONIZE(i % 50, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	/* More runs than are merged at once, so the sort takes more than one pass. */
+	QUERY(SELECT_ALL, FROM(test), WHERE(1), , , ORDER_BY(IINQ_DESC(IINQ_ALIGN(sizeof(int)), sizeof(int), key_type_numeric_signed), IINQ_ASC(0, sizeof(int), key_type_numeric_signed)), , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 1200, state.num_results);
+
+	/* With a limit, only the first results in order are kept. */
+	memset(&state, 0, sizeof(state));
+	state.tc = tc;
+	QUERY(SELECT_ALL, FROM(test), WHERE(1), , , ORDER_BY(IINQ_DESC(IINQ_ALIGN(sizeof(int)), sizeof(int), key_type_numeric_signed), IINQ_ASC(0, sizeof(int), key_type_numeric_signed)), LIMIT(5), , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 5, state.num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 49, state.previous_value);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 249, state.previous_key);
+
+	/* A limit on its own stops the scan as soon as it is reached. */
+	memset(&state, 0, sizeof(state));
+	state.tc	= tc;
+	processor	= IINQ_QUERY_PROCESSOR(count_results, &state.num_results);
+	QUERY(SELECT_ALL, FROM(test), WHERE(iinq_test_count_checked(&num_checked)), , , , LIMIT(10), , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 10, state.num_results);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 10, num_checked);
+
+	error = DROP(test);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+}
+
+/**
+@brief		Checks a projection of the key and the third int of the value,
+			which is 100 times the key.
+*/
+IINQ_NEW_PROCESSOR_FUNC(check_projection) {
+	iinq_test_operator_state_t	*test_state = state;
+	int							columns[2];
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, sizeof(columns), result->num_bytes);
+	memcpy(columns, result->data, sizeof(columns));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, columns[0] * 100, columns[1]);
+	test_state->num_results++;
+}
+
+/**
+@brief		Checks a record of two sources, whose values are twice and three
+			times their keys.
+*/
+IINQ_NEW_PROCESSOR_FUNC(check_two_sources) {
+	iinq_test_operator_state_t	*test_state = state;
+	int							record[4];
+	int							i;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, 4 * IINQ_ALIGN(sizeof(int)), result->num_bytes);
+
+	/* Every field is aligned, so it is read in place. */
+	for (i = 0; i < 4; i++) {
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, 0, ((size_t) (result->data + i * IINQ_ALIGN(sizeof(int)))) % IINQ_ALIGNMENT);
+		record[i] = NEUTRALIZE(result->data + i * IINQ_ALIGN(sizeof(int)), int);
+	}
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, record[0] * 2, record[1]);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, record[2] * 3, record[3]);
+	test_state->num_results++;
+}
+
+void
+iinq_test_select_projection(
+	planck_unit_test_t *tc
+) {
+	ion_err_t					error;
+	ion_status_t				status;
+	iinq_test_operator_state_t	state;
+	ion_iinq_query_processor_t	processor;
+	int							value[3];
+	int							i;
+
+	memset(&state, 0, sizeof(state));
+	state.tc	= tc;
+	processor	= IINQ_QUERY_PROCESSOR(check_projection, &state);
+
+	error		= CREATE_DICTIONARY(test, key_type_numeric_signed, sizeof(int), sizeof(value));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	for (i = 0; i < 20; i++) {
+		value[0]	= i;
+		value[1]	= i * 10;
+		value[2]	= i * 100;
+		status		= INSERT(test, IONIZE(i, int), value);
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	QUERY(SELECT(KEY_OF(test), VALUE_FIELD(test, 2 * sizeof(int), sizeof(int))), FROM(test), WHERE_KEYS((KEY_RANGE(test, IONIZE(5, int), IONIZE(9, int))), 1), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 5, state.num_results);
+
+	error = DROP(test);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	/* Without a projection, each source's record is read straight into the result. */
+	memset(&state, 0, sizeof(state));
+	state.tc	= tc;
+	processor	= IINQ_QUERY_PROCESSOR(check_two_sources, &state);
+
+	error		= CREATE_DICTIONARY(test1, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+	error		= CREATE_DICTIONARY(test2, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	for (i = 0; i < 3; i++) {
+		status = INSERT(test1, IONIZE(i, int), IONIZE(i * 2, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	for (i = 0; i < 2; i++) {
+		status = INSERT(test2, IONIZE(i, int), IONIZE(i * 3, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	QUERY(SELECT_ALL, FROM(test1, test2), WHERE(1), , , , , , &processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 6, state.num_results);
+
+	error = DROP(test1);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+	error = DROP(test2);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+}
+
+/**
+@brief		Checks that batches hold consecutive keys, and counts them.
+*/
+void
+check_batch(
+	ion_iinq_result_t	*batch,
+	unsigned int		num_rows,
+	void				*state
+) {
+	iinq_test_operator_state_t	*test_state = state;
+	unsigned int				i;
+
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, num_rows * sizeof(int), batch->num_bytes);
+	PLANCK_UNIT_ASSERT_TRUE(test_state->tc, num_rows == 16 || test_state->num_results + num_rows == 50);
+
+	for (i = 0; i < num_rows; i++) {
+		int key;
+
+		memcpy(&key, batch->data + i * sizeof(int), sizeof(int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(test_state->tc, test_state->num_results, key);
+		test_state->num_results++;
+	}
+
+	test_state->num_batches++;
+}
+
+void
+iinq_test_batch(
+	planck_unit_test_t *tc
+) {
+	ion_err_t					error;
+	ion_status_t				status;
+	iinq_test_operator_state_t	state;
+	ion_iinq_batch_t			batch;
+	int							i;
+
+	memset(&state, 0, sizeof(state));
+	state.tc = tc;
+	iinq_batch_init(&batch, 16, check_batch, &state);
+
+	error = CREATE_DICTIONARY(test, key_type_numeric_signed, sizeof(int), sizeof(int));
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+
+	for (i = 0; i < 50; i++) {
+		status = INSERT(test, IONIZE(i, int), IONIZE(i, int));
+		PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, status.error);
+	}
+
+	QUERY(SELECT(KEY_OF(test)), FROM(test), WHERE(1), , , , , , &batch.processor);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, batch.error);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 50, state.num_results);
+	/* Three full batches and one partial one. */
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, 4, state.num_batches);
+
+	error = DROP(test);
+	PLANCK_UNIT_ASSERT_INT_ARE_EQUAL(tc, err_ok, error);
+}
+
 planck_unit_suite_t *
 iinq_get_suite(
 ) {
@@ -274,6 +1142,20 @@ iinq_get_suite(
 	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_create_insert_update_delete_drop_dictionary_intint);
 	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_create_query_select_all_from_where_single_dictionary);
 	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_create_query_select_all_from_where_two_dictionaries);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_source_cache_reuse);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_source_cache_flush);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_source_cache_eviction);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_hash_join_on_value);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_join_on_key);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_join_cursor_failure);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_where_key_pushdown);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_where_key_pushdown_two_sources);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_group_by);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_group_by_int64);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_missing_source_finishes);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_order_by);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_select_projection);
+	PLANCK_UNIT_ADD_TO_SUITE(suite, iinq_test_batch);
 
 	return suite;
 }
@@ -287,6 +1169,7 @@ run_all_tests_iinq(
 
 	planck_unit_destroy_suite(suite);
 
+	iinq_close_sources();
 	fremove(ION_MASTER_TABLE_FILENAME);
 	fremove("1.bpt");
 	fremove("1.val");
@@ -46,6 +46,8 @@ extern "C" {
 #include <limits.h>
 #include "../../planck-unit/src/planck_unit.h"
 #include "../../../iinq/iinq.h"
+#include "../../../iinq/iinq_join.h"
+#include "../../../iinq/iinq_operators.h"
 
 void
 run_all_tests_iinq(